@@ -116,6 +116,12 @@ LCUI_API size_t LCUIDisplay_Render(void);
 /** 呈现渲染后的内容 */
 LCUI_API void LCUIDisplay_Present(void);
 
+/**
+ * 检测是否有需要在下一帧更新的部件或重绘的区域
+ * 主循环在没有这些内容时才会进入空闲等待
+ */
+LCUI_API LCUI_BOOL LCUIDisplay_NeedUpdate(void);
+
 LCUI_API void LCUIDisplay_EnablePaintFlashing(LCUI_BOOL enable);
 
 /** 设置显示区域的尺寸，仅在窗口化、全屏模式下有效 */
@@ -130,6 +136,9 @@ LCUI_API int LCUIDisplay_GetHeight(void);
 /** 添加无效区域 */
 LCUI_API void LCUIDisplay_InvalidateArea(LCUI_Rect *rect);
 
+/** 获取最近一次 LCUIDisplay_Render() 绘制的脏矩形区域的统计数据 */
+LCUI_API void LCUIDisplay_GetRegionStats(LCUI_RegionStats stats);
+
 /** 获取当前部件所属的 surface */
 LCUI_API LCUI_Surface LCUIDisplay_GetSurfaceOwner(LCUI_Widget w);
 
@@ -41,4 +41,35 @@ LCUI_API int BoxShadow_Paint(const LCUI_BoxShadow *shadow, const LCUI_Rect *box,
 			     int centent_width, int content_height,
 			     LCUI_PaintContext paint);
 
+typedef struct LCUI_BoxShadowCacheStatsRec_ {
+	/** number of paints served by a cached shadow bitmap */
+	size_t hits;
+
+	/** number of shadow bitmaps rendered */
+	size_t misses;
+
+	/** number of shadow bitmaps evicted to stay within the budget */
+	size_t evictions;
+
+	/** number of shadow bitmaps currently cached */
+	size_t bitmaps;
+
+	/** bytes of shadow bitmaps currently cached */
+	size_t bytes;
+} LCUI_BoxShadowCacheStatsRec, *LCUI_BoxShadowCacheStats;
+
+/**
+ * 设置阴影位图缓存的最大字节数
+ * 阴影会按模糊、扩展、圆角和颜色渲染成九宫格位图并在所有部件间共享，超出预算
+ * 时淘汰最久未使用的位图
+ */
+LCUI_API void BoxShadow_SetCacheSize(size_t max_bytes);
+
+/** 获取阴影位图缓存的统计数据 */
+LCUI_API void BoxShadow_GetCacheStats(LCUI_BoxShadowCacheStats stats);
+
+LCUI_API void LCUI_InitBoxShadow(void);
+
+LCUI_API void LCUI_FreeBoxShadow(void);
+
 #endif
@@ -67,6 +67,24 @@ typedef struct LCUI_FontBitmap_ {
 	LCUI_Pos advance;	/**< XY轴的跨距 */
 } LCUI_FontBitmap;
 
+/** 字体位图缓存的统计信息 */
+typedef struct LCUI_FontBitmapCacheStatsRec_ {
+	size_t hits;		/**< 命中次数 */
+	size_t misses;		/**< 未命中次数 */
+	size_t evictions;	/**< 因超出内存预算而被移除的字体位图数量 */
+	size_t glyphs;		/**< 缓存中的字体位图数量 */
+	size_t pages;		/**< 位图页数量 */
+	size_t resident_bytes;	/**< 位图页占用的内存大小 */
+	size_t max_bytes;	/**< 内存预算 */
+} LCUI_FontBitmapCacheStatsRec, *LCUI_FontBitmapCacheStats;
+
+/** 字体位图的载入请求 */
+typedef struct LCUI_FontBitmapRequestRec_ {
+	wchar_t ch;		/**< 字符码 */
+	int size;		/**< 字体大小（单位为像素） */
+	const int *font_ids;	/**< 候选的字体ID列表，以 0 结尾 */
+} LCUI_FontBitmapRequestRec, *LCUI_FontBitmapRequest;
+
 typedef struct LCUI_FontEngine LCUI_FontEngine;
 
 typedef struct LCUI_FontRec_ {
@@ -202,25 +220,63 @@ LCUI_API void LCUIFont_SetDefault(int id);
  * @param[in] ch 字符码
  * @param[in] font_id 使用的字体ID
  * @param[in] size 字体大小（单位为像素）
- * @param[out] bmp 要添加的字体位图
- * @warning 此函数仅仅是将 bmp 复制进缓存中，并未重新分配新的空间储存位图数
- * 据，因此，请勿在调用此函数后手动释放 bmp。
+ * @param[in] bmp 要添加的字体位图
+ * @warning 位图数据会被拷贝至缓存的位图页中，然后 bmp->buffer 会被释放，因
+ * 此，请勿在调用此函数后再使用或手动释放 bmp。
  */
 LCUI_API LCUI_FontBitmap* LCUIFont_AddBitmap(wchar_t ch, int font_id,
 					     int size, const LCUI_FontBitmap *bmp);
 
 /**
- * 从缓存中获取字体位图
+ * 从缓存中获取字体位图，并增加它的引用计数
+ * 其它线程可能会在任何时候移除缓存中未被引用的字体位图，因此获取和引用是在
+ * 同一次加锁中完成的。
  * @param[in] ch 字符码
  * @param[in] font_id 使用的字体ID
  * @param[in] size 字体大小（单位为像素）
  * @param[out] bmp 输出的字体位图的引用
- * @warning 请勿释放 bmp，bmp 仅仅是引用缓存中的字体位图，并未建分配新
- * 空间存储字体位图的拷贝。
+ * @warning bmp 是缓存中的字体位图，而不是它的拷贝，请勿释放它。只要 bmp 不为
+ * NULL，在不再需要时都应调用 LCUIFont_ReleaseBitmap() 减少它的引用计数。
  */
 LCUI_API int LCUIFont_GetBitmap(wchar_t ch, int font_id, int size,
 				const LCUI_FontBitmap **bmp);
 
+/**
+ * 从缓存中获取字体位图，并增加它的引用计数
+ * 会按顺序尝试 font_ids 中的字体，如果这些字体都没有该字符的字形，则使用默认
+ * 字体。获取和引用是一起完成的，因此在多线程环境中也能安全地长期持有 bmp，不
+ * 再需要时请调用 LCUIFont_ReleaseBitmap() 释放它。
+ * @param[in] font_ids 候选的字体ID列表，以 0 结尾，可以为 NULL
+ * @returns 与 LCUIFont_GetBitmap() 相同
+ */
+LCUI_API int LCUIFont_AcquireBitmap(wchar_t ch, const int *font_ids, int size,
+				    const LCUI_FontBitmap **bmp);
+
+/**
+ * 批量载入字体位图
+ * 缓存中没有的字体位图会被分批交给 LCUI 的工作线程并行渲染，当前线程也参与
+ * 渲染，函数会在全部渲染完后返回。适合在绘制大量文本前预先载入字体位图。
+ * @returns 渲染的字体位图数量
+ */
+LCUI_API size_t LCUIFont_LoadBitmaps(LCUI_FontBitmapRequest reqs, size_t n);
+
+/** 增加字体位图的引用计数，被引用的字体位图不会被移出缓存 */
+LCUI_API void LCUIFont_RetainBitmap(const LCUI_FontBitmap *bmp);
+
+/** 减少字体位图的引用计数 */
+LCUI_API void LCUIFont_ReleaseBitmap(const LCUI_FontBitmap *bmp);
+
+/**
+ * 设置字体位图缓存的内存预算
+ * 超出预算时会移除最久未使用且未被引用的字体位图，默认为 8MB。被引用的字体
+ * 位图不会被移除，因此在它们占满预算后，缓存占用的内存会超出预算，超出的部分
+ * 不多于被引用的字体位图的大小，在它们被释放后立即归还。
+ */
+LCUI_API void LCUIFont_SetBitmapCacheSize(size_t max_bytes);
+
+/** 获取字体位图缓存的统计信息 */
+LCUI_API void LCUIFont_GetBitmapCacheStats(LCUI_FontBitmapCacheStats stats);
+
 /** 载入字体至数据库中 */
 LCUI_API int LCUIFont_LoadFile(const char *filepath);
 
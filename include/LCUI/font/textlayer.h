@@ -47,20 +47,44 @@ typedef enum LCUI_EOLChar {
 	LCUI_EOL_CR_LF /**< Windows 格式换行： \r\n */
 } LCUI_EOLChar;
 
-/* 文本行 */
-typedef struct TextRowRec_ {
-	int width;             /**< 宽度 */
-	int height;            /**< 高度 */
-	int text_height;       /**< 当前行中最大字体的高度 */
-	int length;            /**< 该行文本长度 */
-	LCUI_TextChar *string; /**< 该行文本的数据 */
-	LCUI_EOLChar eol;      /**< 行尾结束类型 */
-} LCUI_TextRowRec, *LCUI_TextRow;
-
-/* 文本行列表 */
+/**
+ * 文本行
+ * 字符数据以间隙缓冲区的方式连续存放，在同一位置附近连续插入和删除字符时
+ * 无需移动该行的其它字符。
+ */
+typedef struct TextRowRec_ LCUI_TextRowRec, *LCUI_TextRow;
+struct TextRowRec_ {
+	int width;                /**< 宽度 */
+	int height;               /**< 高度 */
+	int text_width;           /**< 有字形的字符的总宽度，不含空格等字符 */
+	int text_height;          /**< 当前行中最大字体的高度 */
+	int length;               /**< 该行文本长度 */
+	int capacity;             /**< 字符缓冲区的容量 */
+	int gap_start;            /**< 字符缓冲区中的间隙的起始位置 */
+	LCUI_TextCharRec *string; /**< 字符缓冲区 */
+	LCUI_EOLChar eol;         /**< 行尾结束类型 */
+	LCUI_BOOL need_typeset;   /**< 内容有变化，需要重新排版 */
+
+	/* 该文本行在行索引树中的节点信息 */
+	int count;                  /**< 以该行为根的子树中的行数 */
+	int total_height;           /**< 以该行为根的子树中的行的总高度 */
+	int max_text_width;         /**< 以该行为根的子树中的行的最大文本宽度 */
+	LCUI_BOOL has_typeset_rows; /**< 子树中是否有需要重新排版的行 */
+	unsigned priority;          /**< 优先级，用于保持树的平衡 */
+	LCUI_TextRow parent;        /**< 父节点 */
+	LCUI_TextRow left;          /**< 左子树，存放在该行前面的行 */
+	LCUI_TextRow right;         /**< 右子树，存放在该行后面的行 */
+};
+
+/**
+ * 文本行列表
+ * 文本行以平衡树（treap）的方式索引，按行号查找、插入和删除文本行，以及
+ * 在行号与Y轴坐标之间相互转换都只需要对数时间。
+ */
 typedef struct LCUI_TextRowListRec_ {
-	int length;         /**< 当前总行数 */
-	LCUI_TextRow *rows; /**< 每一行文本的数据 */
+	int length;        /**< 当前总行数 */
+	unsigned seed;     /**< 用于生成文本行优先级的随机数种子 */
+	LCUI_TextRow root; /**< 行索引树的根节点 */
 } LCUI_TextRowListRec, *LCUI_TextRowList;
 
 /**
@@ -109,6 +133,7 @@ typedef struct LCUI_TextLayerRec_ {
 	struct {
 		LCUI_BOOL update_bitmap;  /**< 更新文本的字体位图 */
 		LCUI_BOOL update_typeset; /**< 重新对文本进行排版 */
+		LCUI_BOOL typeset_all;    /**< 对起始行后面的所有行重新排版 */
 		int typeset_start_row;    /**< 排版处理的起始行 */
 		LCUI_BOOL redraw_all;     /**< 重绘所有字体位图 */
 	} task;                           /**< 待处理的任务 */
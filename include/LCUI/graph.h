@@ -91,6 +91,14 @@ LCUI_BEGIN_HEADER
 		pixel = (r << 16) | (g << 8) | b; \
 	}
 
+/** Implementations of the alpha blending used by Graph_Mix() */
+typedef enum LCUI_GraphMixerType_ {
+	LCUI_GRAPH_MIXER_AUTO,
+	LCUI_GRAPH_MIXER_SCALAR,
+	LCUI_GRAPH_MIXER_SSE2,
+	LCUI_GRAPH_MIXER_AVX2
+} LCUI_GraphMixerType;
+
 #define Graph_GetQuote(g) ((g)->quote.is_valid ? (g)->quote.source : (g))
 
 #define Graph_SetPixel(G, X, Y, C)                                        \
@@ -277,6 +285,66 @@ LCUI_API int Graph_Mix(LCUI_Graph *back, const LCUI_Graph *fore, int left,
 LCUI_API int Graph_Replace(LCUI_Graph *back, const LCUI_Graph *fore, int left,
 			   int top);
 
+/**
+ * 设置图层混合所用的实现
+ * 默认会在首次混合时根据 CPU 支持的指令集自动选择最快的实现
+ * @param[in] type 实现类型，若为 LCUI_GRAPH_MIXER_AUTO 则自动选择
+ * @returns 设置成功返回 0，当前 CPU 不支持该实现时返回 -ENOTSUP
+ */
+LCUI_API int Graph_SetMixerType(LCUI_GraphMixerType type);
+
+LCUI_API LCUI_GraphMixerType Graph_GetMixerType(void);
+
+typedef struct LCUI_GraphPoolRec_ *LCUI_GraphPool;
+
+typedef struct LCUI_GraphPoolStatsRec_ {
+	/** number of allocations served by a cached buffer */
+	size_t hits;
+
+	/** number of allocations that needed a new buffer */
+	size_t misses;
+
+	/** bytes of buffers currently allocated from the pool */
+	size_t used_bytes;
+
+	/** bytes of free buffers kept by the pool */
+	size_t cached_bytes;
+} LCUI_GraphPoolStatsRec, *LCUI_GraphPoolStats;
+
+/**
+ * 创建一个图像缓存池
+ * 缓存池按尺寸等级缓存已释放的像素缓存区，供后续创建图像时复用，适用于需要
+ * 频繁创建和释放临时图像的场景。缓存池不是线程安全的，每个线程应使用各自的
+ * 缓存池。
+ * @param[in] max_cached_bytes 最多可缓存的空闲缓存区的字节数
+ */
+LCUI_API LCUI_GraphPool GraphPool_Create(size_t max_cached_bytes);
+
+LCUI_API void GraphPool_Destroy(LCUI_GraphPool pool);
+
+/**
+ * 从缓存池中为图像分配像素缓存区
+ * 与 Graph_Create() 相同，图像的色彩类型需要预先设置好，分配到的像素数据会
+ * 被清零。若 pool 为 NULL，则直接调用 Graph_Create()。
+ */
+LCUI_API int GraphPool_Alloc(LCUI_GraphPool pool, LCUI_Graph *graph,
+			     unsigned width, unsigned height);
+
+/**
+ * 将图像的像素缓存区归还到缓存池中
+ * 只有从该缓存池分配的缓存区才会被回收，其它图像会被直接释放
+ */
+LCUI_API void GraphPool_Release(LCUI_GraphPool pool, LCUI_Graph *graph);
+
+/**
+ * 裁剪缓存池
+ * 只保留自上次裁剪以来的使用高峰所需的空闲缓存区，其余的将被释放
+ */
+LCUI_API void GraphPool_Trim(LCUI_GraphPool pool);
+
+LCUI_API void GraphPool_GetStats(LCUI_GraphPool pool,
+				 LCUI_GraphPoolStats stats);
+
 LCUI_END_HEADER
 
 #include <LCUI/draw.h>
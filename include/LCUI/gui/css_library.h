@@ -189,6 +189,13 @@ typedef struct LCUI_SelectorRec_ {
 	LCUI_SelectorNode *nodes;	/**< 选择器结点列表 */
 } LCUI_SelectorRec, *LCUI_Selector;
 
+/** 样式表缓存的统计数据 */
+typedef struct LCUI_StyleCacheStatsRec_ {
+	size_t hits;			/**< 命中次数 */
+	size_t misses;			/**< 未命中次数 */
+	size_t invalidations;		/**< 因添加样式规则而失效的缓存数量 */
+} LCUI_StyleCacheStatsRec, *LCUI_StyleCacheStats;
+
 /* clang-format on */
 
 #define CheckStyleType(S, K, T) \
@@ -274,6 +281,15 @@ LCUI_API int LCUI_FindStyleSheetFromGroup(int group, const char *name,
 
 LCUI_API LCUI_CachedStyleSheet LCUI_GetCachedStyleSheet(LCUI_Selector s);
 
+/**
+ * 根据选择器的哈希值查找已缓存的样式表
+ * @returns 如果样式表未被缓存则返回 NULL
+ */
+LCUI_API LCUI_CachedStyleSheet LCUI_FindCachedStyleSheet(unsigned hash);
+
+/** 获取样式表缓存的统计数据 */
+LCUI_API void LCUI_GetStyleCacheStats(LCUI_StyleCacheStats stats);
+
 LCUI_API void LCUI_GetStyleSheet(LCUI_Selector s, LCUI_StyleSheet out_ss);
 
 LCUI_API void LCUI_PrintStyleSheetsBySelector(LCUI_Selector s);
@@ -37,6 +37,7 @@
 #include <LCUI/gui/widget_attribute.h>
 #include <LCUI/gui/widget_id.h>
 #include <LCUI/gui/widget_hash.h>
+#include <LCUI/gui/widget_index.h>
 #include <LCUI/gui/widget_class.h>
 #include <LCUI/gui/widget_status.h>
 #include <LCUI/gui/widget_helper.h>
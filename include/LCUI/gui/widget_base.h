@@ -31,6 +31,7 @@
 #ifndef LCUI_WIDGET_BASE_H
 #define LCUI_WIDGET_BASE_H
 
+#include <LCUI/thread.h>
 #include <LCUI/util/strlist.h>
 #include <LCUI/gui/css_library.h>
 
@@ -123,6 +124,25 @@ typedef struct LCUI_WidgetTaskRec_ {
 	LCUI_BOOL states[LCUI_WTASK_TOTAL_NUM];
 } LCUI_WidgetTaskRec;
 
+/**
+ * Constraints and result of the last layout
+ * If a widget is reflowed again with the same constraints and nothing in it
+ * has changed, the result can be reused without reflowing its children.
+ */
+typedef struct LCUI_WidgetLayoutCacheRec_ {
+	LCUI_BOOL is_valid;
+	LCUI_LayoutRule rule;
+	LCUI_SizingRule width_sizing;
+	LCUI_SizingRule height_sizing;
+	LCUI_SizingRule parent_width_sizing;
+	LCUI_SizingRule parent_height_sizing;
+	float content_width, content_height;
+	float parent_content_width, parent_content_height;
+
+	/** Size of the border box after layout */
+	float width, height;
+} LCUI_WidgetLayoutCacheRec, *LCUI_WidgetLayoutCache;
+
 /** 部件状态 */
 typedef enum LCUI_WidgetState {
 	LCUI_WSTATE_CREATED = 0,
@@ -219,6 +239,24 @@ typedef struct LCUI_WidgetRulesRec_ {
 
 	/** A callback function on update progress */
 	void (*on_update_progress)(LCUI_Widget, size_t);
+
+	/**
+	 * Retain the rendered content of the widget in a layer
+	 * If the widget is only moved or its opacity is changed, the cached
+	 * layer will be composited directly instead of repainting the widget
+	 * and its children. it is suitable for scrolling content and fade
+	 * animations.
+	 */
+	LCUI_BOOL retain_layer;
+
+	/**
+	 * Index the border boxes of children in a uniform grid
+	 * Widget_At() and pointer events only test the children in the grid
+	 * cell under the pointer instead of scanning all children. It is
+	 * suitable for widgets with a large number of children, such as
+	 * grids and lists.
+	 */
+	LCUI_BOOL index_children;
 } LCUI_WidgetRulesRec, *LCUI_WidgetRules;
 
 /* clang-format off */
@@ -228,6 +266,14 @@ typedef struct LCUI_WidgetRulesDataRec_ {
 	Dict *style_cache;
 	size_t default_max_update_count;
 	size_t progress;
+
+	/** the retained layer, only used when rules.retain_layer is TRUE */
+	LCUI_Graph layer;
+	LCUI_BOOL layer_valid;
+	LCUI_Mutex layer_mutex;
+
+	/** the grid of children, only used when rules.index_children is TRUE */
+	struct LCUI_WidgetIndexRec_ *children_index;
 } LCUI_WidgetRulesDataRec, *LCUI_WidgetRulesData;
 
 typedef struct LCUI_WidgetAttributeRec_ {
@@ -250,6 +296,14 @@ typedef enum LCUI_InvalidAreaType_ {
 	LCUI_INVALID_AREA_TYPE_CANVAS_BOX
 } LCUI_InvalidAreaType;
 
+typedef struct LCUI_WidgetScrollRec_ {
+	/** scroll offset of the children */
+	float x, y;
+
+	/** scroll offset of the children in the last rendered frame */
+	float painted_x, painted_y;
+} LCUI_WidgetScrollRec;
+
 typedef struct LCUI_WidgetRec_ {
 	unsigned hash;
 	LCUI_WidgetState state;
@@ -258,6 +312,14 @@ typedef struct LCUI_WidgetRec_ {
 	char *type;
 	strlist_t classes;
 	strlist_t status;
+
+	/**
+	 * Hash of the selector node of this widget, and 33 to the power of the
+	 * length of the node name. See Widget_GetSelectorHash()
+	 */
+	unsigned selector_hash;
+	unsigned selector_factor;
+
 	wchar_t *title;
 	Dict *attributes;
 	LCUI_BOOL disabled;
@@ -285,6 +347,20 @@ typedef struct LCUI_WidgetRec_ {
 	LCUI_Rect2F margin;
 	LCUI_WidgetBoxModelRec box;
 
+	/**
+	 * Scroll offset of the children
+	 * It is applied when compositing, the layout of children is not
+	 * changed. See Widget_SetScroll()
+	 */
+	LCUI_WidgetScrollRec scroll;
+
+	/**
+	 * Grid of the children canvas boxes, it is built when a tile first
+	 * enters the widget and freed at the end of the frame.
+	 * See LCUIWidget_BeginFrame()
+	 */
+	struct LCUI_WidgetRenderIndexRec_ *render_index;
+
 	LCUI_StyleSheet style;
 	LCUI_StyleList custom_style;
 	LCUI_CachedStyleSheet inherited_style;
@@ -302,6 +378,7 @@ typedef struct LCUI_WidgetRec_ {
 
 	/** Update task context */
 	LCUI_WidgetTaskRec task;
+	LCUI_WidgetLayoutCacheRec layout_cache;
 	LCUI_WidgetRules rules;
 	LCUI_EventTrigger trigger;
 
@@ -96,6 +96,13 @@ typedef struct LCUI_WidgetEventRec_ {
 
 typedef void(*LCUI_WidgetEventFunc)(LCUI_Widget, LCUI_WidgetEvent, void*);
 
+/** 部件事件队列的统计数据 */
+typedef struct LCUI_WidgetEventQueueStatsRec_ {
+	size_t posted;		/**< 已投递的事件数量 */
+	size_t allocated;	/**< 缓冲区已满时从堆中分配的事件数量 */
+	size_t remote_posted;	/**< 在主线程以外的线程中投递的事件数量 */
+} LCUI_WidgetEventQueueStatsRec, *LCUI_WidgetEventQueueStats;
+
 /** 设置阻止部件及其子级部件的事件 */
 #define Widget_BlockEvent(WIDGET, FLAG) (WIDGET)->event_blocked = FLAG
 
@@ -103,6 +110,17 @@ typedef void(*LCUI_WidgetEventFunc)(LCUI_Widget, LCUI_WidgetEvent, void*);
 LCUI_API LCUI_BOOL Widget_PostEvent(LCUI_Widget widget, LCUI_WidgetEvent ev,
 				    void *data, void(*destroy_data)(void*));
 
+/**
+ * 处理已投递的部件事件
+ * 在主线程中投递的事件只会在主线程中处理。其它线程投递的事件在单独的队列中，
+ * 会先于主线程投递的事件处理，因此只有来自同一方的事件之间保留投递顺序
+ * @returns 处理的事件数量
+ */
+LCUI_API size_t LCUIWidget_ProcessEvents(void);
+
+/** 获取部件事件队列的统计数据 */
+LCUI_API void LCUIWidget_GetEventQueueStats(LCUI_WidgetEventQueueStats stats);
+
 /** 触发事件，直接调用事件处理器 */
 LCUI_API int Widget_TriggerEvent(LCUI_Widget widget,
 				 LCUI_WidgetEvent e, void *data);
@@ -36,6 +36,19 @@ LCUI_BEGIN_HEADER
 /** Generate a hash for a widget to identify it and siblings */
 LCUI_API void Widget_GenerateSelfHash(LCUI_Widget w);
 
+/**
+ * Update the hash of the selector node of a widget
+ * It should be called after the type, id, classes or status is changed.
+ */
+LCUI_API void Widget_UpdateSelectorHash(LCUI_Widget w);
+
+/**
+ * Get the hash of the selector of a widget without creating the selector
+ * The result is the same as Widget_GetSelector(w)->hash
+ * @returns 0 on success, -1 if the selector is too long
+ */
+LCUI_API int Widget_GetSelectorHash(LCUI_Widget w, unsigned *hash);
+
 /** Generate hash values for a widget and its children */
 LCUI_API void Widget_GenerateHash(LCUI_Widget w);
 
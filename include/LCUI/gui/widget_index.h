@@ -0,0 +1,81 @@
+﻿/*
+ * widget_index.c -- Spatial index of children for hit testing
+ *
+ * Copyright (c) 2020, Liu chao <lc-soft@live.cn> All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of LCUI nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LCUI_WIDGET_INDEX_H
+#define LCUI_WIDGET_INDEX_H
+
+LCUI_BEGIN_HEADER
+
+/**
+ * Create a spatial index of the border boxes of children
+ * It is called by Widget_SetRules() when rules.index_children is TRUE.
+ */
+LCUI_API int Widget_CreateChildrenIndex(LCUI_Widget w);
+
+LCUI_API void Widget_DestroyChildrenIndex(LCUI_Widget w);
+
+/** Remove all children from the spatial index */
+LCUI_API void Widget_ClearChildrenIndex(LCUI_Widget w);
+
+LCUI_API LCUI_BOOL Widget_HasChildrenIndex(LCUI_Widget w);
+
+/** Add a widget to the spatial index of its parent */
+LCUI_API void Widget_AddToParentIndex(LCUI_Widget w);
+
+/** Remove a widget from the spatial index of its parent */
+LCUI_API void Widget_RemoveFromParentIndex(LCUI_Widget w);
+
+/**
+ * Update the cells of a widget in the spatial index of its parent
+ * It should be called after the border box of the widget is changed.
+ * @param[in] old_box the border box before the change
+ */
+LCUI_API void Widget_UpdateParentIndex(LCUI_Widget w,
+				     const LCUI_RectF *old_box);
+
+/**
+ * Find the topmost visible child at the point by the spatial index
+ * The stacking order is the same as Widget_SortChildrenShow().
+ * @param[in] below only find the children below this child, NULL means
+ *  no limit. it is used to iterate all children at the point.
+ */
+LCUI_API LCUI_Widget Widget_QueryChildAt(LCUI_Widget w, float x, float y,
+					 LCUI_Widget below);
+
+/**
+ * Find the first visible next sibling at the point by the spatial index of
+ * the parent, siblings that ignore pointer events are skipped.
+ */
+LCUI_API LCUI_Widget Widget_QueryNextSiblingAt(LCUI_Widget w, float x,
+					       float y);
+
+LCUI_END_HEADER
+
+#endif
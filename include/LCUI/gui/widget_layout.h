@@ -33,4 +33,10 @@
 
 LCUI_API void Widget_Reflow(LCUI_Widget w, LCUI_LayoutRule rule);
 
+/** Get the number of layouts that have been performed */
+LCUI_API size_t LCUIWidget_GetLayoutCount(void);
+
+/** Get the number of layouts skipped by reusing the last layout result */
+LCUI_API size_t LCUIWidget_GetLayoutCacheHits(void);
+
 #endif
@@ -33,6 +33,16 @@
 
 LCUI_BEGIN_HEADER
 
+/**
+ * 滚动区域
+ * 视口中已绘制的内容需要平移 (dx, dy) 个像素，平移后露出的部分需要重绘
+ */
+typedef struct LCUI_ScrollAreaRec_ {
+	/** 视口，即滚动内容的可见区域 */
+	LCUI_Rect viewport;
+	int dx, dy;
+} LCUI_ScrollAreaRec, *LCUI_ScrollArea;
+
 /**
  * 标记部件中的无效区域
  * @param[in] w		区域所在的部件
@@ -43,6 +53,22 @@ LCUI_BEGIN_HEADER
 LCUI_API LCUI_BOOL Widget_InvalidateArea(LCUI_Widget widget,
 					 LCUI_RectF *in_rect, int box_type);
 
+/**
+ * 标记部件及其祖先部件的图层缓存为无效
+ * 仅对启用了 retain_layer 规则的部件有效，在部件内容有变化时调用
+ */
+LCUI_API void Widget_InvalidateLayer(LCUI_Widget w);
+
+/**
+ * 设置部件内容的滚动偏移量
+ * 偏移量在合成时应用于子部件，不会改变子部件的样式和布局。如果视口的背景
+ * 不随滚动而变化，已绘制的内容会被平移，只有新露出的部分需要重绘
+ * @param[in] w		部件
+ * @param[in] x		水平方向的偏移量
+ * @param[in] y		垂直方向的偏移量
+ */
+LCUI_API void Widget_SetScroll(LCUI_Widget w, float x, float y);
+
 /**
  * 取出部件中的无效区域
  * @param[in] w		部件
@@ -51,6 +77,29 @@ LCUI_API LCUI_BOOL Widget_InvalidateArea(LCUI_Widget widget,
  */
 LCUI_API size_t Widget_GetInvalidArea(LCUI_Widget w, LinkedList *rects);
 
+/**
+ * 取出部件中的无效区域，并合并到区域中
+ * 与 Widget_GetInvalidArea() 不同，矩形会按照 LCUIRegion_AddRect() 的规则
+ * 进行合并，适用于屏幕刷新
+ * @param[in] w		部件
+ * @param[out] region	输出的区域
+ * @return 区域中的矩形数量
+ */
+LCUI_API size_t Widget_GetInvalidRegion(LCUI_Widget w, LCUI_Region region);
+
+/**
+ * 取出部件中的无效区域和滚动区域
+ * 与 Widget_GetInvalidRegion() 不同，可以通过平移已绘制内容完成的滚动会
+ * 输出到滚动区域列表中，而不是将整个视口添加到区域中
+ * @param[in] w		部件
+ * @param[out] region	输出的区域
+ * @param[out] scrolls	输出的滚动区域列表，元素类型为 LCUI_ScrollArea
+ * @return 区域中的矩形数量
+ */
+LCUI_API size_t Widget_GetInvalidRegionWithScrolls(LCUI_Widget w,
+						   LCUI_Region region,
+						   LinkedList *scrolls);
+
 /**
  * 将部件中的矩形区域转换成指定范围框内有效的矩形区域
  * @param[in]	w		目标部件
@@ -75,6 +124,55 @@ LCUI_API void RectToInvalidArea(const LCUI_Rect *rect, LCUI_Rect *area);
  */
 LCUI_API size_t Widget_Render(LCUI_Widget w, LCUI_PaintContext paint);
 
+/**
+ * 开始绘制一帧
+ * 在帧内，分块第一次进入子部件较多的部件时会为它建立子部件的空间索引，之后的
+ * 分块只需要检查与它相交的子部件，而不用遍历所有子部件。索引只在部件树没有变化
+ * 时有效，绘制完后应调用 LCUIWidget_EndFrame() 释放它们
+ */
+LCUI_API void LCUIWidget_BeginFrame(void);
+
+/** 结束绘制一帧，释放本帧建立的子部件空间索引 */
+LCUI_API void LCUIWidget_EndFrame(void);
+
+/** 释放部件的子部件空间索引 */
+LCUI_API void Widget_FreeRenderIndex(LCUI_Widget w);
+
+/**
+ * 裁剪各个渲染线程的画布缓存池
+ * 应在每一帧渲染完后调用，释放超出本帧使用高峰的空闲画布
+ */
+LCUI_API void LCUIWidget_TrimRenderer(void);
+
+/** 获取所有渲染线程的画布缓存池的统计数据 */
+LCUI_API void LCUIWidget_GetRendererStats(LCUI_GraphPoolStats stats);
+
+typedef struct LCUI_BackgroundCacheStatsRec_ {
+	/** number of paints served by a cached scaled image */
+	size_t hits;
+
+	/** number of scaled images created */
+	size_t misses;
+
+	/** number of scaled images evicted to stay within the budget */
+	size_t evictions;
+
+	/** number of scaled images currently cached */
+	size_t images;
+
+	/** bytes of scaled images currently cached */
+	size_t bytes;
+} LCUI_BackgroundCacheStatsRec, *LCUI_BackgroundCacheStats;
+
+/**
+ * 设置背景图缩放缓存的最大字节数
+ * 缩放后的背景图会按图像和尺寸缓存，超出预算时淘汰最久未使用的图像
+ */
+LCUI_API void LCUIWidget_SetBackgroundCacheSize(size_t max_bytes);
+
+/** 获取背景图缩放缓存的统计数据 */
+LCUI_API void LCUIWidget_GetBackgroundStats(LCUI_BackgroundCacheStats stats);
+
 LCUI_API void LCUIWidget_InitRenderer(void);
 
 LCUI_API void LCUIWidget_FreeRenderer(void);
@@ -96,6 +96,12 @@ LCUI_SelectorNode Widget_GetSelectorNode(LCUI_Widget w);
 /** 获取选择器 */
 LCUI_API LCUI_Selector Widget_GetSelector(LCUI_Widget w);
 
+/**
+ * 获取部件匹配的样式表
+ * 优先用部件的选择器哈希值查找缓存，仅在缓存未命中时才创建选择器
+ */
+LCUI_API LCUI_CachedStyleSheet Widget_GetCachedStyleSheet(LCUI_Widget w);
+
 /** 获取样式受到影响的子级部件数量 */
 LCUI_API size_t Widget_GetChildrenStyleChanges(LCUI_Widget w, int type,
 					       const char *name);
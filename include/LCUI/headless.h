@@ -0,0 +1,98 @@
+﻿/*
+ * headless.h -- headless display driver and input simulation
+ *
+ * Copyright (c) 2018, Liu chao <lc-soft@live.cn> All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of LCUI nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LCUI_HEADLESS_H
+#define LCUI_HEADLESS_H
+
+LCUI_BEGIN_HEADER
+
+/**
+ * 启用无头模式
+ * 需要在 LCUI_Init() 前调用，启用后 LCUI 不再使用 X11、framebuffer 等平台驱动，
+ * 而是将画面绘制到内存中，适用于自动化测试和性能测试。设置环境变量
+ * LCUI_DISPLAY_DRIVER=headless 也能启用无头模式。
+ */
+LCUI_API void LCUIHeadless_Enable(LCUI_BOOL enable);
+
+LCUI_API LCUI_BOOL LCUIHeadless_IsEnabled(void);
+
+/** 设置虚拟屏幕的尺寸，默认为 1920x1080 */
+LCUI_API void LCUIHeadless_SetScreenSize(int width, int height);
+
+/**
+ * 启用虚拟时钟
+ * 启用后时间只在调用 LCUIHeadless_AdvanceTime() 时前进，定时器和动画的进度完全
+ * 由调用者决定。虚拟时间从启用时的系统时间开始计算。
+ */
+LCUI_API void LCUIHeadless_EnableVirtualClock(LCUI_BOOL enable);
+
+/** 让虚拟时钟前进指定的毫秒数 */
+LCUI_API void LCUIHeadless_AdvanceTime(int64_t ms);
+
+/**
+ * 模拟鼠标移动
+ * 与其它平台驱动一样，模拟的输入事件都会投递到输入队列中，在下一帧中处理
+ */
+LCUI_API void LCUIHeadless_MouseMove(int x, int y);
+
+LCUI_API void LCUIHeadless_MouseDown(int button);
+
+LCUI_API void LCUIHeadless_MouseUp(int button);
+
+LCUI_API void LCUIHeadless_MouseWheel(int delta);
+
+LCUI_API void LCUIHeadless_KeyDown(int code);
+
+LCUI_API void LCUIHeadless_KeyUp(int code);
+
+/** 获取已呈现的帧数 */
+LCUI_API size_t LCUIHeadless_GetFrameCount(void);
+
+/** 复制根 surface 当前的画面 */
+LCUI_API int LCUIHeadless_GetFrame(LCUI_Graph *buf);
+
+/**
+ * 将当前画面写入文件
+ * 文件扩展名为 .png 时写入 PNG 图片，否则逐行写入 32 位 BGRA 格式的原始像素
+ * 数据。
+ */
+LCUI_API int LCUIHeadless_WriteFrame(const char *filename);
+
+LCUI_AppDriver LCUI_CreateHeadlessAppDriver(void);
+
+void LCUI_DestroyHeadlessAppDriver(LCUI_AppDriver driver);
+
+LCUI_DisplayDriver LCUI_CreateHeadlessDisplayDriver(void);
+
+void LCUI_DestroyHeadlessDisplayDriver(LCUI_DisplayDriver driver);
+
+LCUI_END_HEADER
+
+#endif
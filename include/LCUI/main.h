@@ -127,13 +127,21 @@ typedef enum LCUI_AppDriverId_ {
 	LCUI_APP_LINUX,
 	LCUI_APP_LINUX_X11,
 	LCUI_APP_WINDOWS,
-	LCUI_APP_UWP
+	LCUI_APP_UWP,
+	LCUI_APP_HEADLESS
 } LCUI_AppDriverId;
 
 /** LCUI 应用程序驱动接口，封装了各个平台下的应用程序相关功能支持接口 */
 typedef struct LCUI_AppDriverRec_ {
 	LCUI_AppDriverId id;
 	void (*ProcessEvents)(void);
+
+	/**
+	 * 检查是否有已读取但还未处理的事件，主循环只在没有这类事件时才会进入
+	 * 空闲等待，可以为 NULL
+	 */
+	LCUI_BOOL (*HasPendingEvents)(void);
+
 	int (*BindSysEvent)(int, LCUI_EventFunc, void *, void (*)(void *));
 	int (*UnbindSysEvent)(int, LCUI_EventFunc);
 	int (*UnbindSysEvent2)(int);
@@ -153,6 +161,23 @@ LCUI_API int LCUI_UnbindEvent(int handler_id);
 
 LCUI_API int LCUI_TriggerEvent(LCUI_SysEvent e, void *arg);
 
+/**
+ * 投递输入事件
+ * 事件会被复制到输入队列中，在下一帧中统一处理，可以在任意线程中调用。连续的
+ * 鼠标移动事件和触点都在移动的触控事件会合并成一个事件，只保留最新的位置。
+ * 在处理输入事件时投递的事件会被立即处理。
+ */
+LCUI_API int LCUI_PostEvent(LCUI_SysEvent e);
+
+/**
+ * 获取当前正在处理的输入事件合并前的所有样本
+ * 只能在输入事件的处理器中调用，适用于绘图等需要每个采样点的场景，样本按投递
+ * 顺序排列，最后一个样本即为当前事件的位置。
+ * @param[out] events 样本数组，在事件处理完后失效
+ * @returns 样本数量，事件未被合并时返回 1，不在处理输入事件时返回 0
+ */
+LCUI_API size_t LCUI_GetCoalescedEvents(LCUI_SysEvent *events);
+
 LCUI_API int LCUI_CreateTouchEvent(LCUI_SysEvent e, LCUI_TouchPoint points,
 				   int n_points);
 
@@ -167,18 +192,26 @@ LCUI_API void *LCUI_GetAppData(void);
 
 LCUI_AppDriverId LCUI_GetAppId(void);
 
-/** 处理当前所有事件 */
+/**
+ * 处理当前所有事件
+ * 先处理系统事件和输入事件，然后交替处理部件事件和主线程任务，直到两者都处理
+ * 完。部件事件和任务不在同一个队列中，所以它们之间不保留投递顺序：每一轮都先
+ * 处理完所有部件事件，再执行所有任务
+ * @see LCUIWidget_ProcessEvents()
+ */
 LCUI_API size_t LCUI_ProcessEvents(void);
 
 /**
  * 添加任务
- * 该任务将会添加至主线程中执行
+ * 该任务将会添加至主线程中执行。任务之间按投递顺序执行，但会在同一轮中已投递的
+ * 部件事件之后执行，参见 LCUI_ProcessEvents()
  */
 LCUI_API LCUI_BOOL LCUI_PostTask(LCUI_Task task);
 
 /**
  * 添加异步任务
- * 该任务将会添加至指定 id 的工作线程中执行
+ * 该任务将会添加至指定 id 的工作线程中执行，添加到同一工作线程的任务会按顺序
+ * 逐个执行
  * @param[in] task 任务数据
  * @param[in] target_worker_id 目标工作线程的编号
  */
@@ -186,10 +219,25 @@ LCUI_API void LCUI_PostAsyncTaskTo(LCUI_Task task, int target_worker_id);
 
 /**
  * 添加异步任务
- * 该任务将会添加至工作线程中执行
+ * 该任务将会添加至工作线程中执行，空闲的工作线程可能会窃取它来执行
+ * @returns 接收该任务的工作线程的编号
  */
 LCUI_API int LCUI_PostAsyncTask(LCUI_Task task);
 
+/**
+ * 添加可取消的异步任务
+ * @param[in] task 任务数据
+ * @param[in] priority 任务的优先级
+ * @param[in] callback 任务完成或被取消后在主线程中调用的函数，可以为 NULL
+ * @param[in] callback_arg 传给回调函数的参数
+ * @returns 任务句柄，在不需要时调用 LCUIAsyncTask_Release() 释放；如果 LCUI
+ * 还未初始化，则不会执行该任务并返回 NULL
+ */
+LCUI_API LCUI_AsyncTask LCUI_PostAsyncTaskEx(LCUI_Task task,
+					     LCUI_TaskPriority priority,
+					     LCUI_AsyncTaskCallback callback,
+					     void *callback_arg);
+
 /** LCUI_PostTask 的简化版本 */
 #define LCUI_PostSimpleTask(FUNC, ARG1, ARG2)         \
 	do {                                          \
@@ -221,6 +269,27 @@ LCUI_API LCUI_BOOL LCUI_IsActive(void);
 /** 获取当前帧数 */
 LCUI_API int LCUI_GetFrameCount(void);
 
+/**
+ * 唤醒主循环
+ * 主循环在空闲时会阻塞等待输入、新任务和定时器到期，在其它线程中改变了需要
+ * 由主循环处理的状态后，可调用该函数让主循环运行下一帧
+ */
+LCUI_API void LCUI_WakeUp(void);
+
+/** 获取主循环被唤醒的次数，主循环每运行一帧计为一次 */
+LCUI_API size_t LCUI_GetWakeupCount(void);
+
+/**
+ * 添加需要在主循环空闲时等待的文件描述符
+ * 当它可读时主循环会被唤醒，通常用于与显示服务器的连接和输入设备，需要在
+ * 主线程中调用
+ * @returns 成功返回 0，失败返回 -1
+ */
+LCUI_API int LCUI_WatchFd(int fd);
+
+/** 移除由 LCUI_WatchFd() 添加的文件描述符 */
+LCUI_API int LCUI_UnwatchFd(int fd);
+
 LCUI_API void LCUI_InitBase(void);
 
 LCUI_API void LCUI_InitApp(LCUI_AppDriver app);
@@ -247,7 +316,10 @@ LCUI_API void LCUI_Quit(void);
 /** 退出 LCUI，并设置退出码 */
 LCUI_API void LCUI_Exit(int code);
 
-/** 检测当前是否在主线程上 */
+/**
+ * 检测当前是否在主线程上
+ * 主循环未运行时，初始化 LCUI 的线程即为主线程
+ */
 LCUI_API LCUI_BOOL LCUI_IsOnMainLoop(void);
 
 LCUI_END_HEADER
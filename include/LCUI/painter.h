@@ -35,4 +35,45 @@ LCUI_API LCUI_PaintContext LCUIPainter_Begin(LCUI_Graph *canvas, LCUI_Rect *rect
 
 LCUI_API void LCUIPainter_End(LCUI_PaintContext paint);
 
+/** 分块的尺寸（像素） */
+#define LCUI_TILE_SIZE 128
+
+typedef struct LCUI_TileRendererRec_ *LCUI_TileRenderer;
+
+/**
+ * 分块绘制函数
+ * 会在多个渲染线程中同时调用，各个绘制上下文的区域互不重叠
+ * @returns 已绘制的部件数量
+ */
+typedef size_t (*LCUI_TilePainter)(LCUI_PaintContext, void *);
+
+/**
+ * 创建分块渲染器
+ * 如果有渲染线程启动失败，则只使用已经启动的线程
+ * @param[in] num_threads 参与渲染的线程数量，包括调用渲染函数的线程
+ * @returns 内存不足时返回 NULL
+ */
+LCUI_API LCUI_TileRenderer TileRenderer_Create(int num_threads);
+
+LCUI_API void TileRenderer_Destroy(LCUI_TileRenderer renderer);
+
+LCUI_API int TileRenderer_GetThreads(LCUI_TileRenderer renderer);
+
+/**
+ * 渲染画布中的脏矩形
+ * 脏矩形会被划分到固定尺寸的分块中，由各个渲染线程并行绘制，空闲的线程会
+ * 从其它线程的任务队列中窃取分块。分块之间互不重叠，因此绘制时无需加锁。
+ * @param[in] canvas 目标画布
+ * @param[in] region 脏矩形区域
+ * @param[in] painter 分块绘制函数
+ * @param[in] arg 传给绘制函数的参数
+ * @param[out] tiles 用于保存已绘制的分块区域的列表，可以为 NULL
+ * @returns 已绘制的部件数量
+ */
+LCUI_API size_t TileRenderer_Render(LCUI_TileRenderer renderer,
+				    LCUI_Graph *canvas,
+				    const LCUI_Region region,
+				    LCUI_TilePainter painter, void *arg,
+				    LinkedList *tiles);
+
 #endif
@@ -0,0 +1,54 @@
+/*
+ * linux_input.h -- Linux evdev input support.
+ *
+ * Copyright (c) 2018, Liu chao <lc-soft@live.cn> All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of LCUI nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LCUI_LINUX_INPUT_H
+#define LCUI_LINUX_INPUT_H
+
+/**
+ * 初始化 evdev 输入驱动
+ * 驱动使用一个线程通过 epoll 监听所有 /dev/input/event* 设备，支持键盘、鼠标、
+ * 绝对坐标指针和多点触控（协议 B）。每个 SYN_REPORT 报告会被转换成一组输入事件
+ * 投递到主循环的输入队列中。设置环境变量 LCUI_INPUT_DEVICES 可以指定设备列表，
+ * 多个设备路径之间用冒号分隔。
+ * 驱动有引用计数，每次调用都需要对应一次 LCUI_FreeLinuxInput()。
+ * @returns 已打开的设备数量，初始化失败时返回 -1
+ */
+LCUI_API int LCUI_InitLinuxInput(void);
+
+LCUI_API void LCUI_FreeLinuxInput(void);
+
+/**
+ * 添加输入设备
+ * 设备可以是 evdev 设备文件，也可以是管道等能读出 struct input_event 数据的
+ * 文件，例如回放录制的输入事件。文件描述符由驱动接管，读到文件末尾时会被关闭。
+ */
+LCUI_API int LCUI_AddLinuxInputDevice(int fd);
+
+#endif
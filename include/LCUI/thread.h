@@ -103,6 +103,13 @@ LCUI_API void LCUIThread_Cancel(LCUI_Thread thread);
 /* 记录指针作为返回值，并退出线程 */
 LCUI_API void LCUIThread_Exit(void* retval);
 
+/**
+ * 注册一个在当前线程退出时调用的函数
+ * 只对 LCUIThread_Create() 创建的线程有效，后注册的函数先被调用
+ * @returns 注册成功返回 0，当前线程不是由 LCUIThread_Create() 创建的则返回 -1
+ */
+LCUI_API int LCUIThread_AtExit(void (*func)(void *), void *arg);
+
 /*------------------------------ Thread <END> -------------------------------*/
 
 LCUI_END_HEADER
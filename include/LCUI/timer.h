@@ -103,6 +103,14 @@ LCUI_API int LCUITimer_Reset(int timer_id, long int n_ms);
 /* Process all active timers */
 LCUI_API size_t LCUI_ProcessTimers(void);
 
+/**
+ * 获取距离最早到期的定时器还剩多少时间
+ * 主循环在空闲时用它计算需要等待的时长
+ * @return
+ *	剩余的时间，单位为毫秒，已经到期时返回 0，没有定时器时返回 -1
+ */
+LCUI_API int64_t LCUI_GetNextTimerDelay(void);
+
 /* Init the timer module */
 LCUI_API void LCUI_InitTimer(void);
 
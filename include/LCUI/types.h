@@ -285,6 +285,8 @@ struct LCUI_Graph_ {
 	float opacity;
 	size_t mem_size;
 	uchar_t *palette;
+	/** the pool that allocated the pixel buffer, see GraphPool_Alloc() */
+	struct LCUI_GraphPoolRec_ *pool;
 };
 
 typedef struct LCUI_StyleRec_ {
@@ -443,6 +445,7 @@ typedef struct LCUI_WidgetTasksRec_ {
 	size_t update_count;
 	size_t refresh_count;
 	size_t layout_count;
+	size_t layout_cache_hits;
 	size_t user_task_count;
 	size_t destroy_count;
 	size_t destroy_time;
@@ -459,12 +462,22 @@ typedef struct LCUI_FrameProfileRec_ {
 	clock_t render_time;
 	clock_t present_time;
 
+	/** number of render canvases reused from / missed in the pools */
+	size_t render_pool_hits;
+	size_t render_pool_misses;
+
+	/** number and area of dirty rectangles before and after merging */
+	size_t dirty_rects;
+	size_t dirty_area;
+	size_t painted_rects;
+	size_t painted_area;
+
 	LCUI_WidgetTasksProfileRec widget_tasks;
 } LCUI_FrameProfileRec, *LCUI_FrameProfile;
 
 typedef struct LCUI_ProfileRec_ {
-	clock_t start_time;
-	clock_t end_time;
+	int64_t start_time;
+	int64_t end_time;
 	unsigned frames_count;
 	LCUI_FrameProfileRec frames[LCUI_MAX_FRAMES_PER_SEC];
 } LCUI_ProfileRec, *LCUI_Profile;
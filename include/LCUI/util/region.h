@@ -0,0 +1,103 @@
+﻿/*
+ * region.h -- Dirty region with cost-based rectangle merging
+ *
+ * Copyright (c) 2020, Liu chao <lc-soft@live.cn> All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of LCUI nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LCUI_UTIL_REGION_H
+#define LCUI_UTIL_REGION_H
+
+LCUI_BEGIN_HEADER
+
+/** 区域中的最大矩形数量，超出时会强制合并代价最小的矩形 */
+#define LCUI_REGION_MAX_RECTS 32
+
+/**
+ * 每个矩形的额外开销，以像素数量计
+ * 绘制一个矩形需要遍历部件树并提交到 surface，合并两个矩形时如果多出的
+ * 绘制面积小于这个开销，则合并它们
+ */
+#define LCUI_REGION_RECT_COST 4096
+
+typedef struct LCUI_RegionStatsRec_ {
+	/** number and total area of rectangles added into the region */
+	size_t added_rects;
+	size_t added_area;
+
+	/** number of merges */
+	size_t merged_rects;
+
+	/** number and total area of rectangles in the region */
+	size_t rects;
+	size_t area;
+} LCUI_RegionStatsRec, *LCUI_RegionStats;
+
+/**
+ * 脏矩形区域
+ * 矩形保存在定长数组中，添加矩形时不需要分配内存。
+ *
+ * 这里没有使用按 y-x 分带的区域或 R 树：每帧的脏矩形通常只有几个到几十个，
+ * 线性扫描 LCUI_REGION_MAX_RECTS 个矩形比维护这些结构更便宜，而且渲染器也
+ * 只需要一组矩形。这样做有以下限制：
+ * - 矩形之间可能重叠，重叠部分会被绘制多次，LCUIRegion_GetArea() 也会重复
+ *   计算这部分面积
+ * - 区域满了之后会强制合并代价最小的两个矩形，此时区域会比实际的脏区域大，
+ *   大量分散的小矩形最终可能合并成接近全屏的矩形
+ * - 添加一个矩形需要扫描所有矩形，每次合并后还要重新扫描，最坏情况下需要
+ *   O(n^2) 次比较，n 不超过 LCUI_REGION_MAX_RECTS
+ */
+typedef struct LCUI_RegionRec_ {
+	int length;
+	int rect_cost;
+	LCUI_Rect rects[LCUI_REGION_MAX_RECTS];
+	LCUI_RegionStatsRec stats;
+} LCUI_RegionRec, *LCUI_Region;
+
+LCUI_API void LCUIRegion_Init(LCUI_Region region);
+
+/** 清空区域中的矩形和统计数据 */
+LCUI_API void LCUIRegion_Clear(LCUI_Region region);
+
+/**
+ * 添加矩形
+ * 如果与现有矩形合并后多出的绘制面积小于矩形的额外开销，则合并它们
+ * @returns 新增矩形时返回 0，矩形被合并时返回 1，矩形无效时返回 -1
+ */
+LCUI_API int LCUIRegion_AddRect(LCUI_Region region, const LCUI_Rect *rect);
+
+/** 将区域 src 中的矩形添加到区域 dst 中 */
+LCUI_API void LCUIRegion_Union(LCUI_Region dst, const LCUI_Region src);
+
+/** 获取区域中的矩形的总面积，即需要绘制的像素数量 */
+LCUI_API size_t LCUIRegion_GetArea(const LCUI_Region region);
+
+LCUI_API void LCUIRegion_GetStats(const LCUI_Region region,
+				  LCUI_RegionStats stats);
+
+LCUI_END_HEADER
+
+#endif
@@ -39,8 +39,44 @@ typedef struct LCUI_TaskRec_ {
 	void(*destroy_arg[2])(void*);	/**< 参数的销毁函数 */
 } LCUI_TaskRec, *LCUI_Task;
 
+/** 异步任务的优先级，工作线程总是先执行优先级更高的任务 */
+typedef enum LCUI_TaskPriority {
+	/** 用户正在等待结果的任务，例如加载当前可见的图片 */
+	LCUI_TASK_PRIORITY_USER_BLOCKING,
+	LCUI_TASK_PRIORITY_DEFAULT,
+	/** 不急于完成的任务，例如预加载和清理 */
+	LCUI_TASK_PRIORITY_BACKGROUND,
+	LCUI_TASK_PRIORITY_TOTAL_NUM
+} LCUI_TaskPriority;
+
+typedef enum LCUI_AsyncTaskState {
+	LCUI_ASYNC_TASK_PENDING,
+	LCUI_ASYNC_TASK_RUNNING,
+	LCUI_ASYNC_TASK_DONE,
+	LCUI_ASYNC_TASK_CANCELED
+} LCUI_AsyncTaskState;
+
+/** 异步任务句柄 */
+typedef struct LCUI_AsyncTaskRec_ *LCUI_AsyncTask;
+
+/** 异步任务完成或被取消后的回调 */
+typedef void (*LCUI_AsyncTaskCallback)(LCUI_AsyncTask, void *);
+
 LCUI_API void LCUITask_Destroy(LCUI_Task task);
 
 LCUI_API int LCUITask_Run(LCUI_Task task);
 
+/**
+ * 取消异步任务
+ * 只有还未开始执行的任务才能被取消，被取消的任务不会执行，但它的参数依然会被销
+ * 毁，完成回调也依然会被调用
+ * @returns 取消成功则返回 TRUE
+ */
+LCUI_API LCUI_BOOL LCUIAsyncTask_Cancel(LCUI_AsyncTask task);
+
+LCUI_API LCUI_AsyncTaskState LCUIAsyncTask_GetState(LCUI_AsyncTask task);
+
+/** 释放异步任务句柄 */
+LCUI_API void LCUIAsyncTask_Release(LCUI_AsyncTask task);
+
 #endif
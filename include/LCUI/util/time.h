@@ -35,10 +35,24 @@ LCUI_BEGIN_HEADER
 
 LCUI_API void LCUITime_Init(void);
 
+/**
+ * 设置自定义的时钟
+ * 设置后 LCUI_GetTime() 将返回该时钟的时间，定时器和动画都会以它为准，
+ * 传入 NULL 则恢复使用系统时间。
+ */
+LCUI_API void LCUITime_SetClock(int64_t (*func)(void));
+
+/** 获取当前时间，单位为毫秒，受自定义时钟的影响 */
 LCUI_API int64_t LCUI_GetTime(void);
 
+/** 获取系统时间，单位为毫秒，不受自定义时钟的影响 */
+LCUI_API int64_t LCUI_GetSystemTime(void);
+
 LCUI_API int64_t LCUI_GetTimeDelta(int64_t start);
 
+/** 获取单调递增的高精度时间，单位为纳秒，只用于计算时间间隔 */
+LCUI_API int64_t LCUI_GetNanoTime(void);
+
 LCUI_API void LCUI_Sleep(unsigned int s);
 
 LCUI_API void LCUI_MSleep(unsigned int ms);
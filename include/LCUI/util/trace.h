@@ -0,0 +1,75 @@
+﻿/*
+ * trace.h -- Frame tracer, records the time spent in each phase of the frames
+ * and exports it in Chrome trace event format.
+ *
+ * Copyright (c) 2018, Liu chao <lc-soft@live.cn> All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of LCUI nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LCUI_UTIL_TRACE_H
+#define LCUI_UTIL_TRACE_H
+
+LCUI_BEGIN_HEADER
+
+/** 启用或停用记录，停用后已记录的数据仍然保留 */
+LCUI_API void LCUITrace_Enable(LCUI_BOOL enable);
+
+LCUI_API LCUI_BOOL LCUITrace_IsEnabled(void);
+
+/**
+ * 开始记录一个时间段
+ * 时间段可以嵌套，需与 LCUITrace_End() 成对调用
+ * @param[in] name 时间段名称，在导出记录之前需要一直有效，通常用字符串常量
+ */
+LCUI_API void LCUITrace_Begin(const char *name);
+
+/** 结束最近开始的时间段 */
+LCUI_API void LCUITrace_End(void);
+
+/** 设置当前线程在记录中显示的名称 */
+LCUI_API void LCUITrace_SetThreadName(const char *name);
+
+/** 清空所有线程已记录的数据 */
+LCUI_API void LCUITrace_Clear(void);
+
+/**
+ * 停用记录并释放所有线程的缓冲区
+ * LCUI_Destroy() 会调用它，需要导出的记录应在这之前写入文件。调用时其它线程
+ * 不能正在记录
+ */
+LCUI_API void LCUITrace_Free(void);
+
+/**
+ * 将记录写入文件
+ * 文件内容为 Chrome trace event 格式的 JSON，可在 chrome://tracing 或
+ * Perfetto 中打开
+ * @returns 成功返回 0，失败返回负数
+ */
+LCUI_API int LCUITrace_WriteFile(const char *path);
+
+LCUI_END_HEADER
+
+#endif
@@ -33,12 +33,21 @@
 
 #ifdef LCUI_WORKER_C
 typedef struct LCUI_WorkerRec_ *LCUI_Worker;
+typedef struct LCUI_WorkerPoolRec_ *LCUI_WorkerPool;
 #else
 typedef void* LCUI_Worker;
+typedef void* LCUI_WorkerPool;
 #endif
 
 LCUI_API LCUI_Worker LCUIWorker_New(void);
 
+/**
+ * 设置通知函数
+ * 在有任务添加到工作线程后调用，用于唤醒在其它地方等待任务的线程，例如不
+ * 以 LCUIWorker_RunAsync() 运行，而是由主循环执行任务的工作线程
+ */
+LCUI_API void LCUIWorker_SetNotifier(LCUI_Worker worker, void (*notify)(void));
+
 LCUI_API void LCUIWorker_PostTask(LCUI_Worker worker, LCUI_Task task);
 
 LCUI_API LCUI_Task LCUIWorker_GetTask(LCUI_Worker worker);
@@ -49,4 +58,52 @@ LCUI_API int LCUIWorker_RunAsync(LCUI_Worker worker);
 
 LCUI_API void LCUIWorker_Destroy(LCUI_Worker worker);
 
+/**
+ * 创建工作线程池
+ * 每个工作线程都有自己的任务队列，空闲的工作线程会从其它工作线程的队列中窃取
+ * 任务来执行
+ * @param[in] num_workers 工作线程数量，为 0 时按 CPU 核心数量决定
+ * @returns 如果有工作线程启动失败，则只使用已经启动的线程；一个都没有启动时返回
+ * NULL
+ */
+LCUI_API LCUI_WorkerPool LCUIWorkerPool_New(int num_workers);
+
+LCUI_API int LCUIWorkerPool_GetSize(LCUI_WorkerPool pool);
+
+/**
+ * 设置用于执行任务完成回调的工作线程
+ * 未设置时，回调会在执行任务的工作线程中调用
+ */
+LCUI_API void LCUIWorkerPool_SetCallbackWorker(LCUI_WorkerPool pool,
+					       LCUI_Worker worker);
+
+/**
+ * 添加任务
+ * @returns 接收该任务的工作线程的编号
+ */
+LCUI_API int LCUIWorkerPool_PostTask(LCUI_WorkerPool pool, LCUI_Task task,
+				     LCUI_TaskPriority priority);
+
+/**
+ * 添加任务到指定的工作线程
+ * 这些任务不会被其它工作线程窃取，会按添加顺序逐个执行
+ */
+LCUI_API void LCUIWorkerPool_PostTaskTo(LCUI_WorkerPool pool, LCUI_Task task,
+					int worker_id);
+
+/**
+ * 添加可取消的任务
+ * @param[in] callback 任务完成或被取消后调用的函数，可以为 NULL
+ * @returns 任务句柄，在不需要时调用 LCUIAsyncTask_Release() 释放
+ */
+LCUI_API LCUI_AsyncTask LCUIWorkerPool_PostAsyncTask(
+    LCUI_WorkerPool pool, LCUI_Task task, LCUI_TaskPriority priority,
+    LCUI_AsyncTaskCallback callback, void *callback_arg);
+
+/**
+ * 销毁工作线程池
+ * 等待正在执行的任务结束，未执行的任务会被取消，而不会再被执行
+ */
+LCUI_API void LCUIWorkerPool_Destroy(LCUI_WorkerPool pool);
+
 #endif
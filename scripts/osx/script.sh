@@ -1,4 +1,4 @@
 set -e
-./configure --with-openmp=no
+./configure
 make
 make test
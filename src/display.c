@@ -29,9 +29,6 @@
 
 #include "config.h"
 
-#ifdef USE_OPENMP
-#include <omp.h>
-#endif
 #include <time.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -43,9 +40,11 @@
 #include <LCUI/cursor.h>
 #include <LCUI/thread.h>
 #include <LCUI/display.h>
+#include <LCUI/painter.h>
 #include <LCUI/platform.h>
 #include <LCUI/settings.h>
 #include <LCUI/main.h>
+#include <LCUI/headless.h>
 #ifdef LCUI_DISPLAY_H
 #include LCUI_DISPLAY_H
 #endif
@@ -65,11 +64,20 @@ typedef struct SurfaceRecordRec_ {
 	LCUI_BOOL rendered;
 
 	/** dirty rectangles for rendering */
-	LinkedList rects;
+	LCUI_RegionRec rects;
 
 	/** flashing rect list */
 	LinkedList flash_rects;
 
+	/** scroll areas, the pixels in them are moved before rendering */
+	LinkedList scrolls;
+
+	/**
+	 * back buffer, tiles are rendered into it without locking surface
+	 * it keeps the content of the last frame for scrolling
+	 */
+	LCUI_Graph canvas;
+
 	LCUI_Surface surface;
 	LCUI_Widget widget;
 } SurfaceRecordRec, *SurfaceRecord;
@@ -79,8 +87,10 @@ static struct LCUI_DisplayModule {
 	LCUI_BOOL active;
 	LCUI_DisplayMode mode;
 	LinkedList surfaces;
-	LinkedList rects;
+	LCUI_RegionRec rects;
+	LCUI_RegionStatsRec stats;
 	LCUI_DisplayDriver driver;
+	LCUI_TileRenderer renderer;
 	LCUI_SettingsRec settings;
 	int settings_change_handler_id;
 } display;
@@ -96,19 +106,32 @@ INLINE int is_rect_equals(const LCUI_Rect *a, const LCUI_Rect *b)
 	       a->height == b->height;
 }
 
+static void SurfaceRecord_Delete(SurfaceRecord record)
+{
+	LinkedList_Clear(&record->flash_rects, free);
+	LinkedList_Clear(&record->scrolls, free);
+	Graph_Free(&record->canvas);
+	free(record);
+}
+
 static void OnDestroySurfaceRecord(void *data)
 {
 	SurfaceRecord record = data;
 
 	Surface_Close(record->surface);
-	LinkedList_Clear(&record->rects, free);
-	LinkedList_Clear(&record->flash_rects, free);
-	free(record);
+	SurfaceRecord_Delete(record);
 }
 
 static void OnSettingsChangeEvent(LCUI_SysEvent e, void *arg)
 {
 	Settings_Init(&display.settings);
+	if (display.renderer &&
+	    TileRenderer_GetThreads(display.renderer) !=
+		display.settings.parallel_rendering_threads) {
+		TileRenderer_Destroy(display.renderer);
+		display.renderer = TileRenderer_Create(
+		    display.settings.parallel_rendering_threads);
+	}
 }
 
 static size_t LCUIDisplay_RenderFlashRect(SurfaceRecord record,
@@ -194,163 +217,227 @@ static void LCUIDisplay_AppendFlashRects(SurfaceRecord record, LCUI_Rect *rect)
 	LinkedList_Append(&record->flash_rects, flash_rect);
 }
 
-static void GetRenderingLayerSize(int *width, int *height)
+/** 绘制一个分块，会在多个渲染线程中调用 */
+static size_t LCUIDisplay_PaintTile(LCUI_PaintContext paint, void *arg)
 {
-	float scale = LCUIMetrics_GetScale();
+	size_t count;
+	SurfaceRecord record = arg;
 
-	*width = (int)(LCUIDisplay_GetWidth() * scale);
-	*height = (int)(LCUIDisplay_GetHeight() * scale);
-	*height =
-	    max(200, *height / display.settings.parallel_rendering_threads + 1);
+	Graph_FillRect(&paint->canvas, RGB(255, 255, 255), NULL, TRUE);
+	count = Widget_Render(record->widget, paint);
+	if (display.mode != LCUI_DMODE_SEAMLESS) {
+		LCUICursor_Paint(paint);
+	}
+	return count;
 }
 
-static void SurfaceRecord_DumpRects(SurfaceRecord record, LinkedList *rects)
+/** 将后台缓冲中已绘制的分块呈现到 surface 中 */
+static void LCUIDisplay_PresentTile(SurfaceRecord record, LCUI_Rect *rect)
 {
-	typedef struct DirtyLayerRec {
-		LinkedList rects;
-		LCUI_Rect rect;
-		int diry;
-	} DirtyLayerRec, *DirtyLayer;
+	LCUI_Graph tile;
+	LCUI_PaintContext paint;
 
-	int i;
-	int max_dirty;
-	int layer_width;
-	int layer_height;
+	paint = Surface_BeginPaint(record->surface, rect);
+	if (!paint) {
+		return;
+	}
+	Graph_QuoteReadOnly(&tile, &record->canvas, &paint->rect);
+	Graph_Replace(&paint->canvas, &tile, 0, 0);
+	if (display.settings.paint_flashing) {
+		LCUIDisplay_AppendFlashRects(record, &paint->rect);
+	}
+	Surface_EndPaint(record->surface, paint);
+}
 
-	LCUI_Rect rect;
-	LCUI_Rect *sub_rect;
-	DirtyLayer layer;
-	DirtyLayerRec *layers;
-	LinkedListNode *node;
+/** 将画布中的像素平移到目标区域，源区域为目标区域减去 (dx, dy) */
+static void LCUIDisplay_MovePixels(LCUI_Graph *canvas, const LCUI_Rect *dst,
+				   int dx, int dy)
+{
+	int i, y;
+	uchar_t *src_row, *dst_row;
+	size_t size = dst->width * canvas->bytes_per_pixel;
+
+	for (i = 0; i < dst->height; ++i) {
+		/* copy from bottom to top when moving down, rows overlap */
+		y = dy > 0 ? dst->y + dst->height - 1 - i : dst->y + i;
+		dst_row = canvas->bytes + canvas->bytes_per_row * y;
+		dst_row += canvas->bytes_per_pixel * dst->x;
+		src_row = canvas->bytes + canvas->bytes_per_row * (y - dy);
+		src_row += canvas->bytes_per_pixel * (dst->x - dx);
+		memmove(dst_row, src_row, size);
+	}
+}
 
-	GetRenderingLayerSize(&layer_width, &layer_height);
-	max_dirty = (int)(0.8 * layer_width * layer_height);
-	layers = malloc(sizeof(DirtyLayerRec) *
-			display.settings.parallel_rendering_threads);
-	for (i = 0; i < display.settings.parallel_rendering_threads; ++i) {
-		layer = &layers[i];
-		layer->diry = 0;
-		layer->rect.y = i * layer_height;
-		layer->rect.x = 0;
-		layer->rect.width = layer_width;
-		layer->rect.height = layer_height;
-		LinkedList_Init(&layer->rects);
-	}
-	sub_rect = malloc(sizeof(LCUI_Rect));
-	for (LinkedList_Each(node, &record->rects)) {
-		rect = *(LCUI_Rect *)node->data;
-		for (i = 0; i < display.settings.parallel_rendering_threads;
-		     ++i) {
-			layer = &layers[i];
-			if (layer->diry >= max_dirty) {
-				continue;
-			}
-			if (!LCUIRect_GetOverlayRect(&layer->rect, &rect,
-						     sub_rect)) {
-				continue;
-			}
-			LinkedList_Append(&layer->rects, sub_rect);
-			rect.y += sub_rect->height;
-			rect.height -= sub_rect->height;
-			layer->diry += sub_rect->width * sub_rect->height;
-			sub_rect = malloc(sizeof(LCUI_Rect));
-			if (rect.height < 1) {
-				break;
-			}
-		}
+/** 将矩形平移 (dx, dy) 后裁剪到视口内，然后添加到区域中 */
+static void LCUIDisplay_AddMovedRect(LCUI_Region region, LCUI_Rect rect,
+				     const LCUI_Rect *viewport, int dx, int dy)
+{
+	if (!LCUIRect_GetOverlayRect(&rect, viewport, &rect)) {
+		return;
 	}
-	for (i = 0; i < display.settings.parallel_rendering_threads; ++i) {
-		layer = &layers[i];
-		if (layer->diry >= max_dirty) {
-			RectList_AddEx(rects, &layer->rect, FALSE);
-			RectList_Clear(&layer->rects);
-		} else {
-			LinkedList_Concat(rects, &layer->rects);
-		}
+	rect.x += dx;
+	rect.y += dy;
+	if (LCUIRect_GetOverlayRect(&rect, viewport, &rect)) {
+		LCUIRegion_AddRect(region, &rect);
 	}
-	RectList_Clear(&record->rects);
-	free(sub_rect);
-	free(layers);
 }
 
-static size_t LCUIDisplay_RenderSurfaceRect(SurfaceRecord record,
-					    LCUI_Rect *rect)
+/**
+ * 平移后台缓冲中的视口内容
+ * 新露出的部分会被添加到待绘制的区域中，平移后的内容直接呈现到 surface
+ */
+static void LCUIDisplay_ScrollSurface(SurfaceRecord record,
+				      LCUI_ScrollArea scroll)
 {
-	size_t count;
+	int i, n;
+	LCUI_Rect rect, viewport, dst;
+	LCUI_Rect rects[LCUI_REGION_MAX_RECTS];
+	LCUI_Graph tile;
 	LCUI_PaintContext paint;
 
-	if (!record->widget || !record->surface ||
-	    !Surface_IsReady(record->surface)) {
-		return 0;
+	rect.x = rect.y = 0;
+	rect.width = record->canvas.width;
+	rect.height = record->canvas.height;
+	if (!LCUIRect_GetOverlayRect(&scroll->viewport, &rect, &viewport)) {
+		return;
 	}
-	paint = Surface_BeginPaint(record->surface, rect);
-	if (!paint) {
-		return 0;
+	dst = viewport;
+	dst.x += scroll->dx;
+	dst.y += scroll->dy;
+	if (!LCUIRect_GetOverlayRect(&viewport, &dst, &dst)) {
+		LCUIRegion_AddRect(&record->rects, &viewport);
+		return;
 	}
-	DEBUG_MSG("[thread %d/%d] rect: (%d,%d,%d,%d)\n", omp_get_thread_num(),
-		  omp_get_num_threads(), paint->rect.x, paint->rect.y,
-		  paint->rect.width, paint->rect.height);
-	count = Widget_Render(record->widget, paint);
-	if (display.settings.paint_flashing) {
-		LCUIDisplay_AppendFlashRects(record, &paint->rect);
+	/*
+	 * The dirty rectangles may be computed before the scroll offset is
+	 * changed, the stale pixels in them will be moved too.
+	 */
+	n = record->rects.length;
+	memcpy(rects, record->rects.rects, sizeof(LCUI_Rect) * n);
+	for (i = 0; i < n; ++i) {
+		LCUIDisplay_AddMovedRect(&record->rects, rects[i], &viewport,
+					 scroll->dx, scroll->dy);
+	}
+	if (display.mode != LCUI_DMODE_SEAMLESS && LCUICursor_IsVisible()) {
+		LCUICursor_GetRect(&rect);
+		RectToInvalidArea(&rect, &rect);
+		if (LCUIRect_GetOverlayRect(&rect, &viewport, &rect)) {
+			LCUIRegion_AddRect(&record->rects, &rect);
+			LCUIDisplay_AddMovedRect(&record->rects, rect,
+						 &viewport, scroll->dx,
+						 scroll->dy);
+		}
 	}
-	if (display.mode != LCUI_DMODE_SEAMLESS) {
-		LCUICursor_Paint(paint);
+	LCUIDisplay_MovePixels(&record->canvas, &dst, scroll->dx, scroll->dy);
+	/* add the newly exposed strips */
+	rect = viewport;
+	if (scroll->dy > 0) {
+		rect.height = scroll->dy;
+	} else if (scroll->dy < 0) {
+		rect.y += rect.height + scroll->dy;
+		rect.height = -scroll->dy;
+	}
+	if (scroll->dy != 0) {
+		LCUIRegion_AddRect(&record->rects, &rect);
+	}
+	rect = viewport;
+	if (scroll->dx > 0) {
+		rect.width = scroll->dx;
+	} else if (scroll->dx < 0) {
+		rect.x += rect.width + scroll->dx;
+		rect.width = -scroll->dx;
+	}
+	if (scroll->dx != 0) {
+		LCUIRegion_AddRect(&record->rects, &rect);
+	}
+	paint = Surface_BeginPaint(record->surface, &dst);
+	if (!paint) {
+		return;
 	}
+	Graph_QuoteReadOnly(&tile, &record->canvas, &paint->rect);
+	Graph_Replace(&paint->canvas, &tile, 0, 0);
 	Surface_EndPaint(record->surface, paint);
-	return count;
+}
+
+/** 将区域的统计数据累加到本帧的统计数据中 */
+static void LCUIDisplay_AddRegionStats(LCUI_Region region)
+{
+	LCUI_RegionStatsRec stats;
+
+	LCUIRegion_GetStats(region, &stats);
+	display.stats.added_rects += stats.added_rects;
+	display.stats.added_area += stats.added_area;
+	display.stats.merged_rects += stats.merged_rects;
+	display.stats.rects += stats.rects;
+	display.stats.area += stats.area;
 }
 
 static size_t LCUIDisplay_RenderSurface(SurfaceRecord record)
 {
-	int i = 0;
-	int dirty = 0;
-	int layer_width;
-	int layer_height;
+	int i, width, height;
 	size_t count = 0;
-	LCUI_Rect **rect_array;
-	LinkedList rects;
+	LinkedList tiles;
 	LinkedListNode *node;
 
-	LinkedList_Init(&rects);
-	GetRenderingLayerSize(&layer_width, &layer_height);
-	SurfaceRecord_DumpRects(record, &rects);
-	if (rects.length < 1) {
+	if (!record->widget || !record->surface ||
+	    !Surface_IsReady(record->surface)) {
+		LCUIRegion_Clear(&record->rects);
+		LinkedList_Clear(&record->scrolls, free);
+		/* the canvas is out of date and can not be scrolled */
+		Graph_Free(&record->canvas);
+		return 0;
+	}
+	if (record->rects.length < 1 && record->scrolls.length < 1) {
 		return 0;
 	}
-	rect_array = (LCUI_Rect **)malloc(sizeof(LCUI_Rect *) * rects.length);
-	for (LinkedList_Each(node, &rects)) {
+	/* keep the dirty rects and retry in the next frame */
+	if (!display.renderer) {
+		display.renderer = TileRenderer_Create(
+		    display.settings.parallel_rendering_threads);
+		if (!display.renderer) {
+			return 0;
+		}
+	}
+	width = Surface_GetWidth(record->surface);
+	height = Surface_GetHeight(record->surface);
+	if (record->canvas.width != width || record->canvas.height != height) {
+		LCUI_Rect rect = { 0, 0, width, height };
+
+		/* the old content can not be scrolled into the new canvas */
+		LinkedList_Clear(&record->scrolls, free);
+		LCUIRegion_AddRect(&record->rects, &rect);
+		record->canvas.color_type = LCUI_COLOR_TYPE_ARGB;
+		if (Graph_Create(&record->canvas, width, height) != 0) {
+			/* keep the dirty rects and retry in the next frame */
+			Graph_Free(&record->canvas);
+			return 0;
+		}
+	}
+	for (LinkedList_Each(node, &record->scrolls)) {
+		LCUIDisplay_ScrollSurface(record, node->data);
+	}
+	LinkedList_Clear(&record->scrolls, free);
+	LCUIDisplay_AddRegionStats(&record->rects);
+	for (i = 0; i < record->rects.length; ++i) {
 		LCUI_SysEventRec ev;
 
-		rect_array[i] = node->data;
 		ev.type = LCUI_PAINT;
-		ev.paint.rect = *rect_array[i];
+		ev.paint.rect = record->rects.rects[i];
 		LCUI_TriggerEvent(&ev, NULL);
-		dirty += rect_array[i]->width * rect_array[i]->height;
-		i++;
-	}
-	// Use OPENMP if the render area is larger than two render layers
-	if (dirty >= layer_width * layer_height * 2) {
-#ifdef USE_OPENMP
-#pragma omp parallel for \
-	default(none) \
-	shared(display, rects, rect_array) \
-	firstprivate(record) \
-	reduction(+:count)
-#endif
-		for (i = 0; i < (int)rects.length; ++i) {
-			count += LCUIDisplay_RenderSurfaceRect(record,
-							       rect_array[i]);
-		}
-	} else {
-		for (i = 0; i < (int)rects.length; ++i) {
-			count += LCUIDisplay_RenderSurfaceRect(record,
-							       rect_array[i]);
-		}
 	}
-	free(rect_array);
-	RectList_Clear(&rects);
-	record->rendered = count > 0;
+	LinkedList_Init(&tiles);
+	/* let each tile only visit the children overlapping it */
+	LCUIWidget_BeginFrame();
+	count = TileRenderer_Render(display.renderer, &record->canvas,
+				    &record->rects, LCUIDisplay_PaintTile,
+				    record, &tiles);
+	LCUIWidget_EndFrame();
+	LCUIRegion_Clear(&record->rects);
+	for (LinkedList_Each(node, &tiles)) {
+		LCUIDisplay_PresentTile(record, node->data);
+	}
+	record->rendered = tiles.length > 0;
+	RectList_Clear(&tiles);
 	count += LCUIDisplay_UpdateFlashRects(record);
 	return count;
 }
@@ -370,12 +457,14 @@ void LCUIDisplay_Update(void)
 		if (record->widget && surface && Surface_IsReady(surface)) {
 			Surface_Update(surface);
 		}
-		Widget_GetInvalidArea(record->widget, &record->rects);
+		Widget_GetInvalidRegionWithScrolls(
+		    record->widget, &record->rects, &record->scrolls);
 	}
 	if (display.mode == LCUI_DMODE_SEAMLESS || !record) {
 		return;
 	}
-	LinkedList_Concat(&record->rects, &display.rects);
+	LCUIRegion_Union(&record->rects, &display.rects);
+	LCUIRegion_Clear(&display.rects);
 }
 
 size_t LCUIDisplay_Render(void)
@@ -386,10 +475,12 @@ size_t LCUIDisplay_Render(void)
 	if (!display.active) {
 		return 0;
 	}
+	memset(&display.stats, 0, sizeof(display.stats));
 	for (LinkedList_Each(node, &display.surfaces)) {
 		count += LCUIDisplay_RenderSurface(node->data);
 		count += LCUIDisplay_UpdateFlashRects(node->data);
 	}
+	LCUIWidget_TrimRenderer();
 	return count;
 }
 
@@ -412,6 +503,38 @@ void LCUIDisplay_Present(void)
 	}
 }
 
+LCUI_BOOL LCUIDisplay_NeedUpdate(void)
+{
+	LCUI_Widget root;
+	LinkedListNode *node;
+	SurfaceRecord record;
+
+	root = LCUIWidget_GetRoot();
+	if (root && (root->task.for_self || root->task.for_children)) {
+		return TRUE;
+	}
+	if (!display.active) {
+		return FALSE;
+	}
+	if (display.rects.length > 0) {
+		return TRUE;
+	}
+	/* 部件的无效区域会在下一帧中被收集和重绘 */
+	if (root && (root->has_child_invalid_area ||
+		     root->invalid_area_type > LCUI_INVALID_AREA_TYPE_NONE)) {
+		return TRUE;
+	}
+	for (LinkedList_Each(node, &display.surfaces)) {
+		record = node->data;
+		/* 闪烁的矩形需要在之后的几帧中逐渐淡出 */
+		if (record->rects.length > 0 ||
+		    record->flash_rects.length > 0) {
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
 void LCUIDisplay_InvalidateArea(LCUI_Rect *rect)
 {
 	LCUI_Rect area;
@@ -427,7 +550,12 @@ void LCUIDisplay_InvalidateArea(LCUI_Rect *rect)
 		rect = &area;
 	}
 	RectToInvalidArea(rect, &area);
-	RectList_Add(&display.rects, &area);
+	LCUIRegion_AddRect(&display.rects, &area);
+}
+
+void LCUIDisplay_GetRegionStats(LCUI_RegionStats stats)
+{
+	*stats = display.stats;
 }
 
 static LCUI_Widget LCUIDisplay_GetBindWidget(LCUI_Surface surface)
@@ -496,7 +624,10 @@ static void LCUIDisplay_BindSurface(LCUI_Widget widget)
 	record->surface = Surface_New();
 	record->widget = widget;
 	record->rendered = FALSE;
+	Graph_Init(&record->canvas);
+	LCUIRegion_Init(&record->rects);
 	LinkedList_Init(&record->flash_rects);
+	LinkedList_Init(&record->scrolls);
 	LCUIMetrics_ComputeRectActual(&rect, &widget->box.canvas);
 	if (Widget_CheckStyleValid(widget, key_top) &&
 	    Widget_CheckStyleValid(widget, key_left)) {
@@ -522,8 +653,8 @@ static void LCUIDisplay_UnbindSurface(LCUI_Widget widget)
 	for (LinkedList_Each(node, &display.surfaces)) {
 		record = node->data;
 		if (record && record->widget == widget) {
-			Surface_Close(record->surface);
 			LinkedList_DeleteNode(&display.surfaces, node);
+			OnDestroySurfaceRecord(record);
 			break;
 		}
 	}
@@ -693,7 +824,7 @@ void Surface_Destroy(LCUI_Surface surface)
 		if (record && record->surface == surface) {
 			LinkedList_DeleteNode(&display.surfaces, node);
 			display.driver->destroy(surface);
-			free(record);
+			SurfaceRecord_Delete(record);
 			break;
 		}
 	}
@@ -958,10 +1089,16 @@ int LCUI_InitDisplay(LCUI_DisplayDriver driver)
 	display.settings_change_handler_id = LCUI_BindEvent(
 	    LCUI_SETTINGS_CHANGE, OnSettingsChangeEvent, NULL, NULL);
 
-	LinkedList_Init(&display.rects);
+	LCUIRegion_Init(&display.rects);
 	LinkedList_Init(&display.surfaces);
+	display.renderer =
+	    TileRenderer_Create(display.settings.parallel_rendering_threads);
 	if (!display.driver) {
-		display.driver = LCUI_CreateDisplayDriver();
+		if (LCUI_GetAppId() == LCUI_APP_HEADLESS) {
+			display.driver = LCUI_CreateHeadlessDisplayDriver();
+		} else {
+			display.driver = LCUI_CreateDisplayDriver();
+		}
 	}
 	if (!display.driver) {
 		Logger_Warning("[display] init failed\n");
@@ -989,10 +1126,16 @@ int LCUI_FreeDisplay(void)
 		return -1;
 	}
 	display.active = FALSE;
-	RectList_Clear(&display.rects);
+	LCUIRegion_Clear(&display.rects);
 	LCUIDisplay_CleanSurfaces();
+	TileRenderer_Destroy(display.renderer);
+	display.renderer = NULL;
 	if (display.driver) {
-		LCUI_DestroyDisplayDriver(display.driver);
+		if (LCUI_GetAppId() == LCUI_APP_HEADLESS) {
+			LCUI_DestroyHeadlessDisplayDriver(display.driver);
+		} else {
+			LCUI_DestroyDisplayDriver(display.driver);
+		}
 	}
 	LCUI_UnbindEvent(display.settings_change_handler_id);
 	display.settings_change_handler_id = -1;
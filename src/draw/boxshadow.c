@@ -35,9 +35,14 @@
 
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 #include <LCUI_Build.h>
 #include <LCUI/LCUI.h>
 #include <LCUI/graph.h>
+#include <LCUI/thread.h>
+
+#define BOXSHADOW_CACHE_SIZE (4 * 1024 * 1024)
+#define BOXSHADOW_SLICE_SIZE 32
 
 #define BLUR_N 1.5
 #define BLUR_WIDTH(sd) (int)(sd->blur * BLUR_N)
@@ -66,6 +71,57 @@ typedef struct BoxShadowRenderingContextRec {
 	LCUI_PaintContext paint;
 } BoxShadowRenderingContextRec, *BoxShadowRenderingContext;
 
+/**
+ * 阴影位图的键，由决定阴影外观的参数组成
+ * 圆角区域尺寸受内容框尺寸的限制，因此除了圆角半径外还需要记录它
+ */
+typedef struct BoxShadowKeyRec_ {
+	int x, y;
+	int blur;
+	int spread;
+	int top_left_radius;
+	int top_right_radius;
+	int bottom_left_radius;
+	int bottom_right_radius;
+	int top_left;     /**< 左上角的阴影圆角区域尺寸 */
+	int top_right;    /**< 右上角的阴影圆角区域尺寸 */
+	int bottom_left;  /**< 左下角的阴影圆角区域尺寸 */
+	int bottom_right; /**< 右下角的阴影圆角区域尺寸 */
+	LCUI_Color color;
+} BoxShadowKeyRec, *BoxShadowKey;
+
+/**
+ * 阴影位图
+ * 阴影框按九宫格切分，四个角包含了所有随阴影框尺寸变化而移动的部分，四条边和
+ * 中间区域在各个方向上都是相同的像素，位图中只保留 BOXSHADOW_SLICE_SIZE 个像素，
+ * 绘制时再将它们平铺到阴影框的实际尺寸
+ */
+typedef struct BoxShadowBitmapRec_ {
+	BoxShadowKeyRec key;
+	LCUI_Graph image;
+	int left, top, right, bottom; /**< 四周切片的宽度 */
+	LCUI_BOOL has_center;         /**< 中间区域是否有可见的像素 */
+	size_t size;                  /**< 位图占用的字节数 */
+	unsigned refs;                /**< 正在使用它进行绘制的线程数量 */
+	LCUI_BOOL cached;             /**< 是否还在缓存中 */
+	LinkedListNode node;          /**< 在最近使用列表中的结点 */
+} BoxShadowBitmapRec, *BoxShadowBitmap;
+
+static struct LCUI_BoxShadowModule {
+	LCUI_BOOL active;
+	DictType dtype;
+	Dict *bitmaps;
+
+	/** 阴影位图，按最近使用的时间排序，最久未使用的在前面 */
+	LinkedList lru;
+	size_t size;
+	size_t max_size;
+	LCUI_BoxShadowCacheStatsRec stats;
+
+	/** 多个渲染线程会同时绘制阴影，需要加锁保护缓存 */
+	LCUI_Mutex mutex;
+} self;
+
 typedef struct gradient {
 	int s;
 	double v;
@@ -599,12 +655,316 @@ static void BoxShadow_ClearContentRect(BoxShadowRenderingContext ctx)
 	RectList_Clear(&rects);
 }
 
+/** 逐个像素地计算并绘制整个阴影框 */
+static void BoxShadow_PaintShadowBox(BoxShadowRenderingContext ctx)
+{
+	BoxShadow_FillRect(ctx);
+	BoxShadow_PaintLeftBlur(ctx);
+	BoxShadow_PaintRightBlur(ctx);
+	BoxShadow_PaintTopBlur(ctx);
+	BoxShadow_PaintBottomBlur(ctx);
+	BoxShadow_PaintTopLeftBlur(ctx);
+	BoxShadow_PaintTopRightBlur(ctx);
+	BoxShadow_PaintBottomLeftBlur(ctx);
+	BoxShadow_PaintBottomRightBlur(ctx);
+}
+
+static int BoxShadow_GetCornerSize(BoxShadowRenderingContext ctx, int radius)
+{
+	return min(ctx->max_radius, FULL_SHADOW_WIDTH(ctx) + radius);
+}
+
+static unsigned int BoxShadowKey_Hash(const void *key)
+{
+	return Dict_GenHashFunction(key, sizeof(BoxShadowKeyRec));
+}
+
+static int BoxShadowKey_Compare(void *privdata, const void *key1,
+				const void *key2)
+{
+	return memcmp(key1, key2, sizeof(BoxShadowKeyRec)) == 0;
+}
+
+static void BoxShadowBitmap_Destroy(BoxShadowBitmap bmp)
+{
+	Graph_Free(&bmp->image);
+	free(bmp);
+}
+
+/** 将阴影位图移出缓存，正在使用的位图会在使用完后销毁 */
+static void BoxShadowBitmap_Remove(BoxShadowBitmap bmp)
+{
+	Dict_Delete(self.bitmaps, &bmp->key);
+	LinkedList_Unlink(&self.lru, &bmp->node);
+	self.size -= bmp->size;
+	bmp->cached = FALSE;
+	if (bmp->refs < 1) {
+		BoxShadowBitmap_Destroy(bmp);
+	}
+}
+
+static void BoxShadowBitmap_Release(BoxShadowBitmap bmp)
+{
+	LCUIMutex_Lock(&self.mutex);
+	bmp->refs -= 1;
+	if (bmp->refs < 1 && !bmp->cached) {
+		BoxShadowBitmap_Destroy(bmp);
+	}
+	LCUIMutex_Unlock(&self.mutex);
+}
+
+/** 淘汰最久未使用的阴影位图，直到缓存的总大小不超过预算 */
+static void BoxShadow_TrimCache(size_t max_size)
+{
+	BoxShadowBitmap bmp;
+	LinkedListNode *node, *next;
+
+	node = self.lru.head.next;
+	while (node && self.size > max_size) {
+		next = node->next;
+		bmp = node->data;
+		if (bmp->refs < 1) {
+			BoxShadowBitmap_Remove(bmp);
+			self.stats.evictions += 1;
+		}
+		node = next;
+	}
+}
+
+/** 按键中的参数，以逐个像素计算的方式绘制阴影位图 */
+static void BoxShadowBitmap_Render(BoxShadowBitmap bmp)
+{
+	int full_width;
+	LCUI_BoxShadow shadow;
+	LCUI_PaintContextRec paint;
+	BoxShadowRenderingContextRec ctx;
+	const BoxShadowKeyRec *key = &bmp->key;
+
+	shadow.x = key->x;
+	shadow.y = key->y;
+	shadow.blur = key->blur;
+	shadow.spread = key->spread;
+	shadow.color = key->color;
+	shadow.top_left_radius = key->top_left_radius;
+	shadow.top_right_radius = key->top_right_radius;
+	shadow.bottom_left_radius = key->bottom_left_radius;
+	shadow.bottom_right_radius = key->bottom_right_radius;
+	ctx.shadow = &shadow;
+	/* 找出被内容框尺寸限制的圆角区域尺寸，让各个角与键中的一致 */
+	full_width = FULL_SHADOW_WIDTH(&ctx);
+	ctx.max_radius = bmp->image.width + bmp->image.height;
+	if (key->top_left < full_width + key->top_left_radius) {
+		ctx.max_radius = key->top_left;
+	} else if (key->top_right < full_width + key->top_right_radius) {
+		ctx.max_radius = key->top_right;
+	} else if (key->bottom_left < full_width + key->bottom_left_radius) {
+		ctx.max_radius = key->bottom_left;
+	} else if (key->bottom_right <
+		   full_width + key->bottom_right_radius) {
+		ctx.max_radius = key->bottom_right;
+	}
+	ctx.box = NULL;
+	ctx.shadow_box.x = 0;
+	ctx.shadow_box.y = 0;
+	ctx.shadow_box.width = bmp->image.width;
+	ctx.shadow_box.height = bmp->image.height;
+	ctx.content_box.x = SHADOW_WIDTH(ctx.shadow) - shadow.x;
+	ctx.content_box.y = SHADOW_WIDTH(ctx.shadow) - shadow.y;
+	ctx.content_box.width = bmp->image.width - SHADOW_WIDTH(ctx.shadow) * 2;
+	ctx.content_box.height =
+	    bmp->image.height - SHADOW_WIDTH(ctx.shadow) * 2;
+	ctx.paint = &paint;
+	paint.with_alpha = TRUE;
+	paint.rect = ctx.shadow_box;
+	paint.canvas = bmp->image;
+	BoxShadow_PaintShadowBox(&ctx);
+	BoxShadow_ClearContentRect(&ctx);
+	bmp->has_center =
+	    Graph_GetPixelPointer(&bmp->image, bmp->left, bmp->top)->alpha > 0;
+}
+
+/**
+ * 获取阴影框的位图
+ * 返回的位图在使用完后需要调用 BoxShadowBitmap_Release() 释放
+ * @returns 如果阴影框过小而无法切分，或者位图大小超出了缓存预算，则返回 NULL
+ */
+static BoxShadowBitmap BoxShadow_GetBitmap(BoxShadowRenderingContext ctx)
+{
+	int left, right, top, bottom;
+	int width, height;
+	int blur_width = BLUR_WIDTH(ctx->shadow);
+	int shadow_width = SHADOW_WIDTH(ctx->shadow);
+	const LCUI_BoxShadow *shadow = ctx->shadow;
+	BoxShadowKeyRec key;
+	BoxShadowBitmap bmp;
+	size_t size;
+
+	if (!self.active) {
+		return NULL;
+	}
+	memset(&key, 0, sizeof(key));
+	key.x = shadow->x;
+	key.y = shadow->y;
+	key.blur = shadow->blur;
+	key.spread = shadow->spread;
+	key.color = shadow->color;
+	key.top_left_radius = shadow->top_left_radius;
+	key.top_right_radius = shadow->top_right_radius;
+	key.bottom_left_radius = shadow->bottom_left_radius;
+	key.bottom_right_radius = shadow->bottom_right_radius;
+	key.top_left = BoxShadow_GetCornerSize(ctx, shadow->top_left_radius);
+	key.top_right = BoxShadow_GetCornerSize(ctx, shadow->top_right_radius);
+	key.bottom_left =
+	    BoxShadow_GetCornerSize(ctx, shadow->bottom_left_radius);
+	key.bottom_right =
+	    BoxShadow_GetCornerSize(ctx, shadow->bottom_right_radius);
+	/* 切片需要包含模糊边缘、阴影圆角以及内容框的边和圆角 */
+	left = max(max(blur_width, max(key.top_left, key.bottom_left)),
+		   shadow_width - shadow->x +
+		       max(key.top_left_radius, key.bottom_left_radius));
+	right = max(max(blur_width, max(key.top_right, key.bottom_right)),
+		    shadow_width + shadow->x +
+			max(key.top_right_radius, key.bottom_right_radius));
+	top = max(max(blur_width, max(key.top_left, key.top_right)),
+		  shadow_width - shadow->y +
+		      max(key.top_left_radius, key.top_right_radius));
+	bottom = max(max(blur_width, max(key.bottom_left, key.bottom_right)),
+		     shadow_width + shadow->y +
+			 max(key.bottom_left_radius, key.bottom_right_radius));
+	/* 阴影框容纳不下四周的切片时，各个切片会相互覆盖，不能平铺绘制 */
+	if (ctx->shadow_box.width < left + right ||
+	    ctx->shadow_box.height < top + bottom) {
+		return NULL;
+	}
+	width = left + right + BOXSHADOW_SLICE_SIZE;
+	height = top + bottom + BOXSHADOW_SLICE_SIZE;
+	size = sizeof(LCUI_ARGB) * width * height;
+	LCUIMutex_Lock(&self.mutex);
+	bmp = Dict_FetchValue(self.bitmaps, &key);
+	if (bmp) {
+		LinkedList_Unlink(&self.lru, &bmp->node);
+		LinkedList_AppendNode(&self.lru, &bmp->node);
+		bmp->refs += 1;
+		self.stats.hits += 1;
+		LCUIMutex_Unlock(&self.mutex);
+		return bmp;
+	}
+	if (size > self.max_size) {
+		LCUIMutex_Unlock(&self.mutex);
+		return NULL;
+	}
+	bmp = NEW(BoxShadowBitmapRec, 1);
+	bmp->key = key;
+	bmp->left = left;
+	bmp->right = right;
+	bmp->top = top;
+	bmp->bottom = bottom;
+	bmp->size = size;
+	Graph_Init(&bmp->image);
+	bmp->image.color_type = LCUI_COLOR_TYPE_ARGB;
+	if (Graph_Create(&bmp->image, width, height) != 0) {
+		LCUIMutex_Unlock(&self.mutex);
+		free(bmp);
+		return NULL;
+	}
+	BoxShadowBitmap_Render(bmp);
+	bmp->refs = 1;
+	bmp->cached = TRUE;
+	bmp->node.data = bmp;
+	Dict_Add(self.bitmaps, &bmp->key, bmp);
+	LinkedList_AppendNode(&self.lru, &bmp->node);
+	self.size += bmp->size;
+	self.stats.misses += 1;
+	BoxShadow_TrimCache(self.max_size);
+	LCUIMutex_Unlock(&self.mutex);
+	return bmp;
+}
+
+/**
+ * 将阴影位图中的一个切片平铺绘制到阴影框中
+ * @param[in] src 切片在位图中的区域
+ * @param[in] dst 切片在阴影框中的区域
+ */
+static void BoxShadow_MixSlice(BoxShadowRenderingContext ctx,
+			       BoxShadowBitmap bmp, const LCUI_Rect *src,
+			       const LCUI_Rect *dst)
+{
+	int x, y;
+	LCUI_Graph slice;
+	LCUI_Rect tile, rect, slice_rect;
+
+	if (dst->width < 1 || dst->height < 1) {
+		return;
+	}
+	for (y = 0; y < dst->height; y += src->height) {
+		tile.y = ctx->shadow_box.y + dst->y + y;
+		tile.height = min(src->height, dst->height - y);
+		for (x = 0; x < dst->width; x += src->width) {
+			tile.x = ctx->shadow_box.x + dst->x + x;
+			tile.width = min(src->width, dst->width - x);
+			if (!LCUIRect_GetOverlayRect(&ctx->paint->rect, &tile,
+						     &rect)) {
+				continue;
+			}
+			slice_rect.x = src->x + rect.x - tile.x;
+			slice_rect.y = src->y + rect.y - tile.y;
+			slice_rect.width = rect.width;
+			slice_rect.height = rect.height;
+			Graph_Quote(&slice, &bmp->image, &slice_rect);
+			Graph_Mix(&ctx->paint->canvas, &slice,
+				  rect.x - ctx->paint->rect.x,
+				  rect.y - ctx->paint->rect.y,
+				  ctx->paint->with_alpha);
+		}
+	}
+}
+
+/** 将阴影位图的九个切片绘制到阴影框中 */
+static void BoxShadow_PaintBitmap(BoxShadowRenderingContext ctx,
+				  BoxShadowBitmap bmp)
+{
+	int i, j;
+	LCUI_Rect src, dst;
+	int src_x[4], src_y[4], dst_x[4], dst_y[4];
+
+	src_x[0] = dst_x[0] = 0;
+	src_x[1] = dst_x[1] = bmp->left;
+	src_x[2] = bmp->image.width - bmp->right;
+	src_x[3] = bmp->image.width;
+	dst_x[2] = ctx->shadow_box.width - bmp->right;
+	dst_x[3] = ctx->shadow_box.width;
+	src_y[0] = dst_y[0] = 0;
+	src_y[1] = dst_y[1] = bmp->top;
+	src_y[2] = bmp->image.height - bmp->bottom;
+	src_y[3] = bmp->image.height;
+	dst_y[2] = ctx->shadow_box.height - bmp->bottom;
+	dst_y[3] = ctx->shadow_box.height;
+	for (i = 0; i < 3; ++i) {
+		for (j = 0; j < 3; ++j) {
+			/* 中间区域通常被内容框完全挡住，无需绘制 */
+			if (i == 1 && j == 1 && !bmp->has_center) {
+				continue;
+			}
+			src.x = src_x[j];
+			src.y = src_y[i];
+			src.width = src_x[j + 1] - src_x[j];
+			src.height = src_y[i + 1] - src_y[i];
+			dst.x = dst_x[j];
+			dst.y = dst_y[i];
+			dst.width = dst_x[j + 1] - dst_x[j];
+			dst.height = dst_y[i + 1] - dst_y[i];
+			BoxShadow_MixSlice(ctx, bmp, &src, &dst);
+		}
+	}
+}
+
 int BoxShadow_Paint(const LCUI_BoxShadow *shadow, const LCUI_Rect *box,
 		    int content_width, int content_height,
 		    LCUI_PaintContext paint)
 {
 	LCUI_PaintContextRec shadow_paint;
 	BoxShadowRenderingContextRec ctx;
+	BoxShadowBitmap bmp;
 
 	/* 判断容器尺寸是否低于阴影占用的最小尺寸 */
 	if (box->width < BoxShadow_GetWidth(shadow, 0) ||
@@ -629,6 +989,15 @@ int BoxShadow_Paint(const LCUI_BoxShadow *shadow, const LCUI_Rect *box,
 	ctx.content_box.width = content_width;
 	ctx.content_box.height = content_height;
 
+	/* Paint the cached shadow bitmap directly to the canvas */
+	bmp = BoxShadow_GetBitmap(&ctx);
+	if (bmp) {
+		ctx.paint = paint;
+		BoxShadow_PaintBitmap(&ctx, bmp);
+		BoxShadowBitmap_Release(bmp);
+		return 0;
+	}
+
 	/* Create a paint context for render shadow */
 	ctx.paint = &shadow_paint;
 	Graph_Init(&shadow_paint.canvas);
@@ -638,15 +1007,7 @@ int BoxShadow_Paint(const LCUI_BoxShadow *shadow, const LCUI_Rect *box,
 	Graph_Create(&ctx.paint->canvas, paint->rect.width, paint->rect.height);
 
 	/* Render box shadow */
-	BoxShadow_FillRect(&ctx);
-	BoxShadow_PaintLeftBlur(&ctx);
-	BoxShadow_PaintRightBlur(&ctx);
-	BoxShadow_PaintTopBlur(&ctx);
-	BoxShadow_PaintBottomBlur(&ctx);
-	BoxShadow_PaintTopLeftBlur(&ctx);
-	BoxShadow_PaintTopRightBlur(&ctx);
-	BoxShadow_PaintBottomLeftBlur(&ctx);
-	BoxShadow_PaintBottomRightBlur(&ctx);
+	BoxShadow_PaintShadowBox(&ctx);
 	/* Clear pixels that overlap the content area */
 	BoxShadow_ClearContentRect(&ctx);
 
@@ -655,3 +1016,58 @@ int BoxShadow_Paint(const LCUI_BoxShadow *shadow, const LCUI_Rect *box,
 	Graph_Free(&ctx.paint->canvas);
 	return 0;
 }
+
+void BoxShadow_SetCacheSize(size_t max_bytes)
+{
+	if (!self.active) {
+		self.max_size = max_bytes;
+		return;
+	}
+	LCUIMutex_Lock(&self.mutex);
+	self.max_size = max_bytes;
+	BoxShadow_TrimCache(max_bytes);
+	LCUIMutex_Unlock(&self.mutex);
+}
+
+void BoxShadow_GetCacheStats(LCUI_BoxShadowCacheStats stats)
+{
+	if (!self.active) {
+		memset(stats, 0, sizeof(LCUI_BoxShadowCacheStatsRec));
+		return;
+	}
+	LCUIMutex_Lock(&self.mutex);
+	*stats = self.stats;
+	stats->bitmaps = self.lru.length;
+	stats->bytes = self.size;
+	LCUIMutex_Unlock(&self.mutex);
+}
+
+void LCUI_InitBoxShadow(void)
+{
+	memset(&self.dtype, 0, sizeof(DictType));
+	self.dtype.hashFunction = BoxShadowKey_Hash;
+	self.dtype.keyCompare = BoxShadowKey_Compare;
+	self.bitmaps = Dict_Create(&self.dtype, NULL);
+	LinkedList_Init(&self.lru);
+	LCUIMutex_Init(&self.mutex);
+	self.size = 0;
+	if (self.max_size == 0) {
+		self.max_size = BOXSHADOW_CACHE_SIZE;
+	}
+	memset(&self.stats, 0, sizeof(self.stats));
+	self.active = TRUE;
+}
+
+void LCUI_FreeBoxShadow(void)
+{
+	if (!self.active) {
+		return;
+	}
+	LCUIMutex_Lock(&self.mutex);
+	self.active = FALSE;
+	BoxShadow_TrimCache(0);
+	LCUIMutex_Unlock(&self.mutex);
+	Dict_Release(self.bitmaps);
+	LCUIMutex_Destroy(&self.mutex);
+	self.bitmaps = NULL;
+}
@@ -36,22 +36,54 @@
 #include <LCUI_Build.h>
 #include <LCUI/types.h>
 #include <LCUI/util.h>
+#include <LCUI/thread.h>
 #include <LCUI/graph.h>
 #include <LCUI/font.h>
+#include <LCUI/main.h>
 
 /* clang-format off */
 
 #define FONT_CACHE_SIZE		32
 #define FONT_CACHE_MAX_SIZE	1024
+#define FONT_BITMAP_PAGE_SIZE	65536
+#define FONT_BITMAP_CACHE_SIZE	(8 * 1024 * 1024)
+#define FONT_RENDER_MAX_THREADS	4
+#define FONT_RENDER_BATCH_SIZE	32
 
 /**
- * 库中缓存的字体位图是分组存放的，共有三级分组，分别为：
- * 字符->字体信息->字体大小
- * 获取字体位图时的搜索顺序为：先找到字符的记录，然后在记录中的字体数据库里找
- * 到指定字体样式标识号的字体位图库，之后在字体位图库中找到指定像素大小的字体
- * 位图。
+ * 库中缓存的字体位图以（字符码，字体ID，像素大小）为键存放在哈希表中，位图的
+ * 像素数据则按顺序紧凑地存放在容量较大的位图页中。位图页按最近使用的时间排序，
+ * 当位图页占用的内存超出预算时，会释放最久未使用的位图页以及存放在其中的字体
+ * 位图。被引用的字体位图所在的位图页不会被释放，因此内存预算并不是硬性限制：
+ * 剩下的都是被引用的位图页时，新的位图页只分配位图所需的空间，超出预算的部分
+ * 不会多于正在使用的位图，并且在这些位图页不再被引用时立即释放。
  */
 
+/** 字体位图页 */
+typedef struct LCUI_FontBitmapPageRec_ {
+	size_t size;		/**< 容量 */
+	size_t used;		/**< 已使用的空间 */
+	size_t refs;		/**< 页中各个字体位图的引用计数之和 */
+	uchar_t *data;		/**< 像素数据 */
+	LinkedList glyphs;	/**< 存放在该页中的字形 */
+	LinkedListNode node;	/**< 在位图页列表中的结点 */
+} LCUI_FontBitmapPageRec, *LCUI_FontBitmapPage;
+
+typedef struct LCUI_FontGlyphKeyRec_ {
+	int ch;
+	int font_id;
+	int size;
+} LCUI_FontGlyphKeyRec, *LCUI_FontGlyphKey;
+
+/** 字形，即缓存中的字体位图 */
+typedef struct LCUI_FontGlyphRec_ {
+	LCUI_FontBitmap bitmap;		/**< 位图，必须是第一个成员 */
+	LCUI_FontGlyphKeyRec key;	/**< 在字形表中的键 */
+	size_t refs;			/**< 引用计数 */
+	LCUI_FontBitmapPage page;	/**< 所在的位图页 */
+	LinkedListNode node;		/**< 在位图页的字形列表中的结点 */
+} LCUI_FontGlyphRec, *LCUI_FontGlyph;
+
 typedef struct LCUI_FontStyleNodeRec_ {
 	/* 字体列表，按粗细程度存放 */
 	LCUI_Font weights[FONT_WEIGHT_TOTAL_NUM];
@@ -81,7 +113,14 @@ static struct LCUI_FontLibraryModule {
 	LCUI_BOOL active;		/**< 标记，指示数据库是否初始化 */
 	Dict *font_families;		/**< 字族信息库，以字族名称索引字体信息 */
 	DictType font_families_type;	/**< 字族信息库的字典类型数据 */
-	RBTree bitmap_cache;		/**< 字体位图缓存区 */
+	struct {
+		Dict *glyphs;		/**< 字形表 */
+		DictType glyphs_type;	/**< 字形表的字典类型数据 */
+		LinkedList pages;	/**< 位图页列表，按最近使用的时间排序 */
+		LCUI_FontBitmapPage page;	/**< 当前用于存放位图的页 */
+		LCUI_FontBitmapCacheStatsRec stats;	/**< 统计信息 */
+		LCUI_Mutex mutex;
+	} bitmap_cache;			/**< 字体位图缓存区 */
 	LCUI_FontCache *font_cache;	/**< 字体信息缓存区 */
 	LCUI_Font default_font;		/**< 默认字体的信息 */
 	LCUI_Font incore_font;		/**< 内置字体的信息 */
@@ -93,9 +132,6 @@ static struct LCUI_FontLibraryModule {
 
 #define FontBitmap_IsValid(fbmp) \
 	((fbmp) && (fbmp)->width > 0 && (fbmp)->rows > 0)
-#define SelectChar(ch) (RBTree *)RBTree_GetData(&fontlib.bitmap_cache, ch)
-#define SelectFont(ch, font_id) (RBTree *)RBTree_GetData(ch, font_id)
-#define SelectBitmap(font, size) (LCUI_FontBitmap *)RBTree_GetData(font, size)
 #define SelectFontFamliy(family_name) \
 	(LCUI_FontFamilyNode)         \
 	    Dict_FetchValue(fontlib.font_families, family_name);
@@ -249,16 +285,128 @@ static void DestroyFontFamilyNode(void *privdata, void *data)
 	free(node);
 }
 
-static void DestroyFontBitmap(void *arg)
+static unsigned int FontGlyphKey_Hash(const void *key)
+{
+	return Dict_GenHashFunction(key, sizeof(LCUI_FontGlyphKeyRec));
+}
+
+static int FontGlyphKey_Compare(void *privdata, const void *key1,
+				const void *key2)
+{
+	const LCUI_FontGlyphKeyRec *a = key1, *b = key2;
+	return a->ch == b->ch && a->font_id == b->font_id &&
+	       a->size == b->size;
+}
+
+static void DestroyFontGlyph(void *privdata, void *data)
+{
+	free(data);
+}
+
+static void FontBitmapPage_Destroy(LCUI_FontBitmapPage page)
 {
-	FontBitmap_Free(arg);
-	free(arg);
+	LCUI_FontGlyph glyph;
+	LinkedListNode *node;
+
+	while (page->glyphs.length > 0) {
+		node = page->glyphs.head.next;
+		glyph = node->data;
+		LinkedList_Unlink(&page->glyphs, node);
+		Dict_Delete(fontlib.bitmap_cache.glyphs, &glyph->key);
+		fontlib.bitmap_cache.stats.evictions += 1;
+	}
+	if (fontlib.bitmap_cache.page == page) {
+		fontlib.bitmap_cache.page = NULL;
+	}
+	LinkedList_Unlink(&fontlib.bitmap_cache.pages, &page->node);
+	fontlib.bitmap_cache.stats.resident_bytes -= page->size;
+	fontlib.bitmap_cache.stats.pages -= 1;
+	free(page->data);
+	free(page);
 }
 
-static void DestroyTreeNode(void *arg)
+/** 释放最久未使用的位图页，直到有足够的空间存放新的位图页 */
+static void FontBitmapCache_Shrink(size_t size)
 {
-	RBTree_Destroy(arg);
-	free(arg);
+	LCUI_FontBitmapPage page;
+	LinkedListNode *node, *next;
+
+	node = fontlib.bitmap_cache.pages.head.next;
+	while (node && fontlib.bitmap_cache.stats.resident_bytes + size >
+			   fontlib.bitmap_cache.stats.max_bytes) {
+		next = node->next;
+		page = node->data;
+		if (page->refs == 0) {
+			FontBitmapPage_Destroy(page);
+		}
+		node = next;
+	}
+}
+
+/** 在位图页中为位图分配空间 */
+static uchar_t *FontBitmapCache_Alloc(size_t size, LCUI_FontBitmapPage *out)
+{
+	uchar_t *data;
+	LCUI_FontBitmapPage page = fontlib.bitmap_cache.page;
+
+	if (page && page->size - page->used >= size) {
+		data = page->data + page->used;
+		page->used += size;
+		*out = page;
+		return data;
+	}
+	page = malloc(sizeof(LCUI_FontBitmapPageRec));
+	if (!page) {
+		return NULL;
+	}
+	page->size = max(size, FONT_BITMAP_PAGE_SIZE);
+	FontBitmapCache_Shrink(page->size);
+	if (fontlib.bitmap_cache.stats.resident_bytes + page->size >
+	    fontlib.bitmap_cache.stats.max_bytes) {
+		page->size = size;
+	}
+	page->data = malloc(page->size);
+	if (!page->data) {
+		free(page);
+		return NULL;
+	}
+	page->refs = 0;
+	page->used = size;
+	page->node.data = page;
+	LinkedList_Init(&page->glyphs);
+	LinkedList_AppendNode(&fontlib.bitmap_cache.pages, &page->node);
+	fontlib.bitmap_cache.stats.resident_bytes += page->size;
+	fontlib.bitmap_cache.stats.pages += 1;
+	/* 仅在新页的剩余空间更多时才切换当前页，以减少空间浪费 */
+	if (!fontlib.bitmap_cache.page ||
+	    page->size - page->used > fontlib.bitmap_cache.page->size -
+					  fontlib.bitmap_cache.page->used) {
+		fontlib.bitmap_cache.page = page;
+	}
+	*out = page;
+	return page->data;
+}
+
+/** 将位图页标记为最近使用的 */
+static void FontBitmapCache_Touch(LCUI_FontBitmapPage page)
+{
+	if (page->node.next) {
+		LinkedList_Unlink(&fontlib.bitmap_cache.pages, &page->node);
+		LinkedList_AppendNode(&fontlib.bitmap_cache.pages, &page->node);
+	}
+}
+
+static void FontGlyph_SetPage(LCUI_FontGlyph glyph, LCUI_FontBitmapPage page)
+{
+	if (glyph->page) {
+		glyph->page->refs -= glyph->refs;
+		LinkedList_Unlink(&glyph->page->glyphs, &glyph->node);
+	}
+	glyph->page = page;
+	if (page) {
+		page->refs += glyph->refs;
+		LinkedList_AppendNode(&page->glyphs, &glyph->node);
+	}
 }
 
 int LCUIFont_Add(LCUI_Font font)
@@ -522,101 +670,403 @@ void LCUIFont_SetDefault(int id)
 	}
 }
 
-LCUI_FontBitmap *LCUIFont_AddBitmap(wchar_t ch, int font_id, int size,
-				    const LCUI_FontBitmap *bmp)
+static int FontBitmapCache_GetFontId(int font_id)
 {
-	LCUI_FontBitmap *bmp_cache;
-	RBTree *tree_font, *tree_bmp;
-
-	if (!fontlib.active) {
-		return NULL;
+	if (font_id > 0) {
+		return font_id;
+	}
+	if (fontlib.default_font) {
+		return fontlib.default_font->id;
 	}
-	/* 获取字符的字体信息集 */
-	tree_font = SelectChar(ch);
-	if (!tree_font) {
-		tree_font = NEW(RBTree, 1);
-		if (!tree_font) {
+	return fontlib.incore_font->id;
+}
+
+static LCUI_FontGlyph FontBitmapCache_Find(wchar_t ch, int font_id, int size)
+{
+	LCUI_FontGlyphKeyRec key;
+
+	key.ch = (int)ch;
+	key.font_id = font_id;
+	key.size = size;
+	return Dict_FetchValue(fontlib.bitmap_cache.glyphs, &key);
+}
+
+/**
+ * 向缓存中添加字体位图
+ * @param[in] replace 当缓存中已有该字体位图时，是否用 bmp 替换它
+ */
+static LCUI_FontGlyph FontBitmapCache_Add(wchar_t ch, int font_id, int size,
+					  const LCUI_FontBitmap *bmp,
+					  LCUI_BOOL replace)
+{
+	uchar_t *data = NULL;
+	size_t data_size = 0;
+	LCUI_FontGlyph glyph;
+	LCUI_FontBitmapPage page = NULL;
+
+	glyph = FontBitmapCache_Find(ch, font_id, size);
+	if (!glyph) {
+		glyph = malloc(sizeof(LCUI_FontGlyphRec));
+		if (!glyph) {
 			return NULL;
 		}
-		RBTree_Init(tree_font);
-		RBTree_OnDestroy(tree_font, DestroyTreeNode);
-		RBTree_Insert(&fontlib.bitmap_cache, ch, tree_font);
+		glyph->key.ch = (int)ch;
+		glyph->key.font_id = font_id;
+		glyph->key.size = size;
+		glyph->refs = 0;
+		glyph->page = NULL;
+		glyph->node.data = glyph;
+		Dict_Add(fontlib.bitmap_cache.glyphs, &glyph->key, glyph);
+	} else if (!replace) {
+		/* 其它线程已经添加了该字体位图 */
+		if (bmp->buffer) {
+			free(bmp->buffer);
+		}
+		return glyph;
+	} else {
+		/* 先移出原来的位图页，以免在分配空间时被当成无用数据释放 */
+		FontGlyph_SetPage(glyph, NULL);
+	}
+	/* 将像素数据拷贝至位图页内，然后释放原来的像素数据 */
+	if (FontBitmap_IsValid(bmp) && bmp->buffer) {
+		data_size = (size_t)bmp->width * bmp->rows;
+		data = FontBitmapCache_Alloc(data_size, &page);
+		if (data) {
+			memcpy(data, bmp->buffer, data_size);
+		}
 	}
-	/* 当字体ID不大于0时，使用内置字体 */
-	if (font_id <= 0) {
-		font_id = fontlib.incore_font->id;
+	glyph->bitmap = *bmp;
+	glyph->bitmap.buffer = data;
+	if (bmp->buffer) {
+		free(bmp->buffer);
 	}
-	/* 获取相应字体样式标识号的字体位图库 */
-	tree_bmp = SelectFont(tree_font, font_id);
-	if (!tree_bmp) {
-		tree_bmp = NEW(RBTree, 1);
-		if (!tree_bmp) {
-			return NULL;
-		}
-		RBTree_Init(tree_bmp);
-		RBTree_OnDestroy(tree_bmp, DestroyFontBitmap);
-		RBTree_Insert(tree_font, font_id, tree_bmp);
+	if (!data) {
+		glyph->bitmap.width = 0;
+		glyph->bitmap.rows = 0;
 	}
-	/* 在字体位图库中获取指定像素大小的字体位图 */
-	bmp_cache = SelectBitmap(tree_bmp, size);
-	if (!bmp_cache) {
-		bmp_cache = NEW(LCUI_FontBitmap, 1);
-		if (!bmp_cache) {
-			return NULL;
-		}
-		RBTree_Insert(tree_bmp, size, bmp_cache);
+	FontGlyph_SetPage(glyph, page);
+	return glyph;
+}
+
+static void FontGlyph_Retain(LCUI_FontGlyph glyph)
+{
+	glyph->refs += 1;
+	if (glyph->page) {
+		glyph->page->refs += 1;
 	}
-	/* 拷贝数据至该空间内 */
-	memcpy(bmp_cache, bmp, sizeof(LCUI_FontBitmap));
-	return bmp_cache;
 }
 
-int LCUIFont_GetBitmap(wchar_t ch, int font_id, int size,
-		       const LCUI_FontBitmap **bmp)
+static void FontGlyph_Release(LCUI_FontGlyph glyph)
+{
+	LCUI_FontBitmapCacheStats stats = &fontlib.bitmap_cache.stats;
+
+	if (glyph->refs < 1) {
+		return;
+	}
+	glyph->refs -= 1;
+	if (!glyph->page) {
+		return;
+	}
+	glyph->page->refs -= 1;
+	/* 超出预算的位图页不再被引用时，立即释放它们 */
+	if (glyph->page->refs == 0 &&
+	    stats->resident_bytes > stats->max_bytes) {
+		FontBitmapCache_Shrink(0);
+	}
+}
+
+/**
+ * 从缓存中获取字体位图，如果没有则渲染它
+ * 字形的渲染不在锁内进行，因此多个线程可以同时渲染不同的字形
+ */
+static int FontBitmapCache_Get(wchar_t ch, int font_id, int size,
+			       LCUI_BOOL retain, const LCUI_FontBitmap **bmp)
 {
 	int ret;
-	RBTree *ctx;
+	LCUI_FontGlyph glyph;
 	LCUI_FontBitmap bmp_cache;
 
 	*bmp = NULL;
 	if (!fontlib.active) {
 		return -2;
 	}
-	if (font_id <= 0) {
-		if (fontlib.default_font) {
-			font_id = fontlib.default_font->id;
-		} else {
-			font_id = fontlib.incore_font->id;
-		}
-	}
-	do {
-		if (!(ctx = SelectChar(ch))) {
-			break;
+	font_id = FontBitmapCache_GetFontId(font_id);
+	LCUIMutex_Lock(&fontlib.bitmap_cache.mutex);
+	glyph = FontBitmapCache_Find(ch, font_id, size);
+	if (glyph) {
+		if (glyph->page) {
+			FontBitmapCache_Touch(glyph->page);
 		}
-		ctx = SelectFont(ctx, font_id);
-		if (!ctx) {
-			break;
-		}
-		*bmp = SelectBitmap(ctx, size);
-		if (*bmp) {
-			return 0;
+		if (retain) {
+			FontGlyph_Retain(glyph);
 		}
-		break;
-	} while (0);
+		fontlib.bitmap_cache.stats.hits += 1;
+		LCUIMutex_Unlock(&fontlib.bitmap_cache.mutex);
+		*bmp = &glyph->bitmap;
+		return 0;
+	}
 	if (ch == 0) {
+		LCUIMutex_Unlock(&fontlib.bitmap_cache.mutex);
 		return -1;
 	}
+	fontlib.bitmap_cache.stats.misses += 1;
+	LCUIMutex_Unlock(&fontlib.bitmap_cache.mutex);
+
 	FontBitmap_Init(&bmp_cache);
 	ret = LCUIFont_RenderBitmap(&bmp_cache, ch, font_id, size);
+
+	LCUIMutex_Lock(&fontlib.bitmap_cache.mutex);
 	if (ret == 0) {
-		*bmp = LCUIFont_AddBitmap(ch, font_id, size, &bmp_cache);
+		glyph = FontBitmapCache_Add(ch, font_id, size, &bmp_cache,
+					    FALSE);
+	} else {
+		/* 用空字符的字体位图表示该字符 */
+		glyph = FontBitmapCache_Add(0, font_id, size, &bmp_cache,
+					    FALSE);
+		ret = -1;
+	}
+	if (glyph) {
+		if (retain) {
+			FontGlyph_Retain(glyph);
+		}
+		*bmp = &glyph->bitmap;
+	}
+	LCUIMutex_Unlock(&fontlib.bitmap_cache.mutex);
+	return ret;
+}
+
+static int FontBitmapCache_GetWithFallback(wchar_t ch, const int *font_ids,
+					   int size, LCUI_BOOL retain,
+					   const LCUI_FontBitmap **bmp)
+{
+	int i;
+
+	for (i = 0; font_ids && font_ids[i] > 0; ++i) {
+		if (FontBitmapCache_Get(ch, font_ids[i], size, retain,
+					bmp) == 0) {
+			return 0;
+		}
+		if (retain) {
+			LCUIFont_ReleaseBitmap(*bmp);
+		}
+	}
+	return FontBitmapCache_Get(ch, -1, size, retain, bmp);
+}
+
+LCUI_FontBitmap *LCUIFont_AddBitmap(wchar_t ch, int font_id, int size,
+				    const LCUI_FontBitmap *bmp)
+{
+	LCUI_FontGlyph glyph;
+
+	if (!fontlib.active) {
+		return NULL;
+	}
+	/* 当字体ID不大于0时，使用内置字体 */
+	if (font_id <= 0) {
+		font_id = fontlib.incore_font->id;
+	}
+	LCUIMutex_Lock(&fontlib.bitmap_cache.mutex);
+	glyph = FontBitmapCache_Add(ch, font_id, size, bmp, TRUE);
+	LCUIMutex_Unlock(&fontlib.bitmap_cache.mutex);
+	return glyph ? &glyph->bitmap : NULL;
+}
+
+int LCUIFont_GetBitmap(wchar_t ch, int font_id, int size,
+		       const LCUI_FontBitmap **bmp)
+{
+	return FontBitmapCache_Get(ch, font_id, size, TRUE, bmp);
+}
+
+int LCUIFont_AcquireBitmap(wchar_t ch, const int *font_ids, int size,
+			   const LCUI_FontBitmap **bmp)
+{
+	return FontBitmapCache_GetWithFallback(ch, font_ids, size, TRUE, bmp);
+}
+
+void LCUIFont_RetainBitmap(const LCUI_FontBitmap *bmp)
+{
+	if (!bmp || !fontlib.active) {
+		return;
+	}
+	LCUIMutex_Lock(&fontlib.bitmap_cache.mutex);
+	FontGlyph_Retain((LCUI_FontGlyph)bmp);
+	LCUIMutex_Unlock(&fontlib.bitmap_cache.mutex);
+}
+
+void LCUIFont_ReleaseBitmap(const LCUI_FontBitmap *bmp)
+{
+	if (!bmp || !fontlib.active) {
+		return;
+	}
+	LCUIMutex_Lock(&fontlib.bitmap_cache.mutex);
+	FontGlyph_Release((LCUI_FontGlyph)bmp);
+	LCUIMutex_Unlock(&fontlib.bitmap_cache.mutex);
+}
+
+/**
+ * 字体位图的批量载入器，多个线程从同一个请求列表中领取任务
+ * 载入器由调用者和工作线程中的任务共同引用，工作线程可能在全部请求完成后才
+ * 开始执行任务，此时它不会再访问请求列表
+ */
+typedef struct LCUI_FontBitmapLoaderRec_ {
+	size_t next;
+	size_t done;
+	size_t length;
+	int refs;
+	LCUI_FontBitmapRequest *requests;
+	LCUI_Mutex mutex;
+	LCUI_Cond cond;
+} LCUI_FontBitmapLoaderRec, *LCUI_FontBitmapLoader;
+
+static void FontBitmapLoader_Run(LCUI_FontBitmapLoader loader)
+{
+	LCUI_FontBitmapRequest req;
+	const LCUI_FontBitmap *bmp;
+
+	LCUIMutex_Lock(&loader->mutex);
+	while (loader->next < loader->length) {
+		req = loader->requests[loader->next++];
+		LCUIMutex_Unlock(&loader->mutex);
+		FontBitmapCache_GetWithFallback(req->ch, req->font_ids,
+						req->size, FALSE, &bmp);
+		LCUIMutex_Lock(&loader->mutex);
+		loader->done += 1;
+		if (loader->done == loader->length) {
+			LCUICond_Broadcast(&loader->cond);
+		}
+	}
+	LCUIMutex_Unlock(&loader->mutex);
+}
+
+static void FontBitmapLoader_Unref(void *arg)
+{
+	int refs;
+	LCUI_FontBitmapLoader loader = arg;
+
+	LCUIMutex_Lock(&loader->mutex);
+	refs = --loader->refs;
+	LCUIMutex_Unlock(&loader->mutex);
+	if (refs > 0) {
+		return;
+	}
+	LCUICond_Destroy(&loader->cond);
+	LCUIMutex_Destroy(&loader->mutex);
+	free(loader->requests);
+	free(loader);
+}
+
+static void FontBitmapLoader_OnTask(void *arg1, void *arg2)
+{
+	FontBitmapLoader_Run(arg1);
+}
+
+/** 筛选出缓存中没有的字体位图，重复的请求只保留一个 */
+static size_t FontBitmapLoader_Filter(LCUI_FontBitmapLoader loader,
+				      LCUI_FontBitmapRequest reqs, size_t n)
+{
+	size_t i;
+	Dict *keys_dict;
+	DictType keys_type = { 0 };
+	LCUI_FontGlyphKey keys;
+
+	keys = malloc(sizeof(LCUI_FontGlyphKeyRec) * n);
+	loader->requests = malloc(sizeof(LCUI_FontBitmapRequest) * n);
+	if (!keys || !loader->requests) {
+		free(keys);
+		free(loader->requests);
+		loader->requests = NULL;
+		return 0;
+	}
+	keys_type.hashFunction = FontGlyphKey_Hash;
+	keys_type.keyCompare = FontGlyphKey_Compare;
+	keys_dict = Dict_Create(&keys_type, NULL);
+	LCUIMutex_Lock(&fontlib.bitmap_cache.mutex);
+	for (i = 0; i < n; ++i) {
+		keys[i].ch = (int)reqs[i].ch;
+		keys[i].size = reqs[i].size;
+		if (reqs[i].font_ids && reqs[i].font_ids[0] > 0) {
+			keys[i].font_id = reqs[i].font_ids[0];
+		} else {
+			keys[i].font_id = FontBitmapCache_GetFontId(-1);
+		}
+		if (Dict_FetchValue(fontlib.bitmap_cache.glyphs, &keys[i]) ||
+		    Dict_FetchValue(keys_dict, &keys[i])) {
+			continue;
+		}
+		Dict_Add(keys_dict, &keys[i], &reqs[i]);
+		loader->requests[loader->length++] = &reqs[i];
+	}
+	LCUIMutex_Unlock(&fontlib.bitmap_cache.mutex);
+	Dict_Release(keys_dict);
+	free(keys);
+	return loader->length;
+}
+
+size_t LCUIFont_LoadBitmaps(LCUI_FontBitmapRequest reqs, size_t n)
+{
+	int i, num_tasks;
+	size_t length;
+	LCUI_TaskRec task = { 0 };
+	LCUI_FontBitmapLoader loader;
+
+	if (!fontlib.active || n < 1) {
 		return 0;
 	}
-	ret = LCUIFont_GetBitmap(0, font_id, size, bmp);
-	if (ret != 0) {
-		*bmp = LCUIFont_AddBitmap(0, font_id, size, &bmp_cache);
+	loader = NEW(LCUI_FontBitmapLoaderRec, 1);
+	if (!loader) {
+		return 0;
+	}
+	if (FontBitmapLoader_Filter(loader, reqs, n) < 1) {
+		free(loader->requests);
+		free(loader);
+		return 0;
+	}
+	length = loader->length;
+	num_tasks = (int)(length / FONT_RENDER_BATCH_SIZE);
+	num_tasks = max(1, min(num_tasks, FONT_RENDER_MAX_THREADS)) - 1;
+	LCUIMutex_Init(&loader->mutex);
+	LCUICond_Init(&loader->cond);
+	loader->refs = num_tasks + 1;
+	/* 当前线程也参与渲染，其余的批次交给工作线程 */
+	task.func = FontBitmapLoader_OnTask;
+	task.arg[0] = loader;
+	task.destroy_arg[0] = FontBitmapLoader_Unref;
+	for (i = 0; i < num_tasks; ++i) {
+		LCUI_PostAsyncTask(&task);
+	}
+	FontBitmapLoader_Run(loader);
+	LCUIMutex_Lock(&loader->mutex);
+	while (loader->done < loader->length) {
+		LCUICond_Wait(&loader->cond, &loader->mutex);
+	}
+	LCUIMutex_Unlock(&loader->mutex);
+	FontBitmapLoader_Unref(loader);
+	return length;
+}
+
+void LCUIFont_SetBitmapCacheSize(size_t max_bytes)
+{
+	if (!fontlib.active) {
+		fontlib.bitmap_cache.stats.max_bytes = max_bytes;
+		return;
+	}
+	LCUIMutex_Lock(&fontlib.bitmap_cache.mutex);
+	fontlib.bitmap_cache.stats.max_bytes = max_bytes;
+	FontBitmapCache_Shrink(0);
+	LCUIMutex_Unlock(&fontlib.bitmap_cache.mutex);
+}
+
+void LCUIFont_GetBitmapCacheStats(LCUI_FontBitmapCacheStats stats)
+{
+	if (!fontlib.active) {
+		*stats = fontlib.bitmap_cache.stats;
+		stats->glyphs = 0;
+		return;
 	}
-	return -1;
+	LCUIMutex_Lock(&fontlib.bitmap_cache.mutex);
+	*stats = fontlib.bitmap_cache.stats;
+	stats->glyphs = Dict_Size(fontlib.bitmap_cache.glyphs);
+	LCUIMutex_Unlock(&fontlib.bitmap_cache.mutex);
 }
 
 static int LCUIFont_LoadFileEx(LCUI_FontEngine *engine, const char *file)
@@ -831,15 +1281,31 @@ int LCUIFont_RenderBitmap(LCUI_FontBitmap *buff, wchar_t ch, int font_id,
 
 static void LCUIFont_InitBase(void)
 {
+	size_t max_bytes;
+
 	fontlib.count = 0;
 	fontlib.font_cache_num = 1;
 	fontlib.font_cache = NEW(LCUI_FontCache, 1);
 	fontlib.font_cache[0] = FontCache();
-	RBTree_Init(&fontlib.bitmap_cache);
 	Dict_InitStringKeyType(&fontlib.font_families_type);
 	fontlib.font_families_type.valDestructor = DestroyFontFamilyNode;
 	fontlib.font_families = Dict_Create(&fontlib.font_families_type, NULL);
-	RBTree_OnDestroy(&fontlib.bitmap_cache, DestroyTreeNode);
+	memset(&fontlib.bitmap_cache.glyphs_type, 0, sizeof(DictType));
+	fontlib.bitmap_cache.glyphs_type.hashFunction = FontGlyphKey_Hash;
+	fontlib.bitmap_cache.glyphs_type.keyCompare = FontGlyphKey_Compare;
+	fontlib.bitmap_cache.glyphs_type.valDestructor = DestroyFontGlyph;
+	fontlib.bitmap_cache.glyphs =
+	    Dict_Create(&fontlib.bitmap_cache.glyphs_type, NULL);
+	fontlib.bitmap_cache.page = NULL;
+	LinkedList_Init(&fontlib.bitmap_cache.pages);
+	LCUIMutex_Init(&fontlib.bitmap_cache.mutex);
+	max_bytes = fontlib.bitmap_cache.stats.max_bytes;
+	memset(&fontlib.bitmap_cache.stats, 0,
+	       sizeof(fontlib.bitmap_cache.stats));
+	if (max_bytes == 0) {
+		max_bytes = FONT_BITMAP_CACHE_SIZE;
+	}
+	fontlib.bitmap_cache.stats.max_bytes = max_bytes;
 	fontlib.active = TRUE;
 }
 
@@ -878,7 +1344,12 @@ static void LCUIFont_FreeBase(void)
 		DeleteFontCache(fontlib.font_cache[fontlib.font_cache_num]);
 	}
 	Dict_Release(fontlib.font_families);
-	RBTree_Destroy(&fontlib.bitmap_cache);
+	while (fontlib.bitmap_cache.pages.length > 0) {
+		FontBitmapPage_Destroy(
+		    fontlib.bitmap_cache.pages.head.next->data);
+	}
+	Dict_Release(fontlib.bitmap_cache.glyphs);
+	LCUIMutex_Destroy(&fontlib.bitmap_cache.mutex);
 	free(fontlib.font_cache);
 	fontlib.font_cache = NULL;
 }
@@ -32,9 +32,11 @@
 #include <LCUI_Build.h>
 #ifdef LCUI_FONT_ENGINE_FREETYPE
 #include <LCUI/types.h>
-#include <LCUI/util/linkedlist.h>
+#include <LCUI/util.h>
+#include <LCUI/thread.h>
 #include <LCUI/font.h>
 #include <stdlib.h>
+#include <string.h>
 #include <errno.h>
 
 #include <ft2build.h>
@@ -46,23 +48,129 @@
 #define LCUI_FONT_RENDER_MODE	FT_RENDER_MODE_NORMAL
 #define LCUI_FONT_LOAD_FALGS	(FT_LOAD_RENDER | FT_LOAD_FORCE_AUTOHINT)
 
+/** 每个字体最多能打开的 FT_Face 对象的数量 */
+#define FREETYPE_MAX_FACES	4
+
+/**
+ * FreeType 字体数据
+ * 一个 FT_Face 对象同一时间只能在一个线程中使用，为了能在多个线程中并行渲染
+ * 同一字体的字形，在需要时会为该字体打开多个 FT_Face 对象。
+ */
+typedef struct FreeTypeFontRec_ {
+	char *path;				/**< 字体文件路径 */
+	FT_Long index;				/**< 字体在文件中的索引 */
+	size_t length;				/**< 已打开的 FT_Face 对象数量 */
+	FT_Face faces[FREETYPE_MAX_FACES];	/**< FT_Face 对象列表 */
+	LCUI_BOOL busy[FREETYPE_MAX_FACES];	/**< 标记 FT_Face 对象是否正在使用 */
+	LCUI_Mutex mutex;
+	LCUI_Cond cond;
+} FreeTypeFontRec, *FreeTypeFont;
+
 static struct {
 	FT_Library library;
+	LCUI_Mutex mutex;	/**< 用于保护 FT_New_Face() 和 FT_Done_Face() */
 } freetype;
 
+static FT_Face FreeType_OpenFace(const char *filepath, FT_Long index)
+{
+	FT_Face face;
+
+	LCUIMutex_Lock(&freetype.mutex);
+	if (FT_New_Face(freetype.library, filepath, index, &face)) {
+		face = NULL;
+	} else {
+		FT_Select_Charmap(face, FT_ENCODING_UNICODE);
+	}
+	LCUIMutex_Unlock(&freetype.mutex);
+	return face;
+}
+
+static void FreeType_CloseFace(FT_Face face)
+{
+	LCUIMutex_Lock(&freetype.mutex);
+	FT_Done_Face(face);
+	LCUIMutex_Unlock(&freetype.mutex);
+}
+
+/** 获取一个空闲的 FT_Face 对象，如果都在使用中则打开一个新的 */
+static FT_Face FreeTypeFont_AcquireFace(FreeTypeFont font)
+{
+	size_t i;
+	FT_Face face = NULL;
+
+	LCUIMutex_Lock(&font->mutex);
+	while (font->length > 0) {
+		for (i = 0; i < font->length; ++i) {
+			if (!font->busy[i]) {
+				face = font->faces[i];
+				break;
+			}
+		}
+		if (!face && font->length < FREETYPE_MAX_FACES) {
+			face = FreeType_OpenFace(font->path, font->index);
+			if (face) {
+				i = font->length++;
+				font->faces[i] = face;
+			}
+		}
+		if (face) {
+			font->busy[i] = TRUE;
+			break;
+		}
+		LCUICond_Wait(&font->cond, &font->mutex);
+	}
+	LCUIMutex_Unlock(&font->mutex);
+	return face;
+}
+
+static void FreeTypeFont_ReleaseFace(FreeTypeFont font, FT_Face face)
+{
+	size_t i;
+
+	LCUIMutex_Lock(&font->mutex);
+	for (i = 0; i < font->length; ++i) {
+		if (font->faces[i] == face) {
+			font->busy[i] = FALSE;
+			break;
+		}
+	}
+	LCUICond_Signal(&font->cond);
+	LCUIMutex_Unlock(&font->mutex);
+}
+
+static FreeTypeFont FreeTypeFont_New(const char *filepath, FT_Long index,
+				     FT_Face face)
+{
+	FreeTypeFont font;
+
+	font = malloc(sizeof(FreeTypeFontRec));
+	if (!font) {
+		return NULL;
+	}
+	font->path = strdup2(filepath);
+	font->index = index;
+	font->length = 1;
+	font->faces[0] = face;
+	font->busy[0] = FALSE;
+	LCUIMutex_Init(&font->mutex);
+	LCUICond_Init(&font->cond);
+	return font;
+}
+
 static int FreeType_Open(const char *filepath, LCUI_Font **outfonts)
 {
 	FT_Face face;
+	FreeTypeFont data;
 	LCUI_Font font, *fonts;
-	int i, err, num_faces;
+	int i, num_faces;
 
-	err = FT_New_Face(freetype.library, filepath, -1, &face);
-	if (err) {
+	face = FreeType_OpenFace(filepath, -1);
+	if (!face) {
 		*outfonts = NULL;
 		return -1;
 	}
 	num_faces = face->num_faces;
-	FT_Done_Face(face);
+	FreeType_CloseFace(face);
 	if (num_faces < 1) {
 		return 0;
 	}
@@ -71,23 +179,37 @@ static int FreeType_Open(const char *filepath, LCUI_Font **outfonts)
 		return -ENOMEM;
 	}
 	for (i = 0; i < num_faces; ++i) {
-		err = FT_New_Face(freetype.library, filepath, i, &face);
-		if (err) {
+		face = FreeType_OpenFace(filepath, i);
+		if (!face) {
+			fonts[i] = NULL;
+			continue;
+		}
+		data = FreeTypeFont_New(filepath, i, face);
+		if (!data) {
+			FreeType_CloseFace(face);
 			fonts[i] = NULL;
 			continue;
 		}
-		FT_Select_Charmap(face, FT_ENCODING_UNICODE);
 		font = Font(face->family_name, face->style_name);
-		font->data = face;
+		font->data = data;
 		fonts[i] = font;
 	}
 	*outfonts = fonts;
 	return num_faces;
 }
 
-static void FreeType_Close(void *face)
+static void FreeType_Close(void *data)
 {
-	FT_Done_Face(face);
+	size_t i;
+	FreeTypeFont font = data;
+
+	for (i = 0; i < font->length; ++i) {
+		FreeType_CloseFace(font->faces[i]);
+	}
+	LCUICond_Destroy(&font->cond);
+	LCUIMutex_Destroy(&font->mutex);
+	free(font->path);
+	free(font);
 }
 
 /** 转换 FT_GlyphSlot 类型数据为 LCUI_FontBitmap */
@@ -181,8 +303,12 @@ static int FreeType_Render(LCUI_FontBitmap *bmp, wchar_t ch,
 {
 	int ret = 0;
 	FT_UInt index;
-	FT_Face ft_face = (FT_Face)font->data;
+	FT_Face ft_face;
 
+	ft_face = FreeTypeFont_AcquireFace(font->data);
+	if (!ft_face) {
+		return -2;
+	}
 	/* 设定字体尺寸 */
 	FT_Set_Pixel_Sizes(ft_face, 0, pixel_size);
 	index = FT_Get_Char_Index(ft_face, ch);
@@ -191,9 +317,11 @@ static int FreeType_Render(LCUI_FontBitmap *bmp, wchar_t ch,
 	}
 	/* 载入该字的字形数据 */
 	if (FT_Load_Glyph(ft_face, index, LCUI_FONT_LOAD_FALGS) != 0) {
-		return -2;
+		ret = -2;
+	} else {
+		Convert_FTGlyph(bmp, ft_face->glyph, LCUI_FONT_RENDER_MODE);
 	}
-	Convert_FTGlyph(bmp, ft_face->glyph, LCUI_FONT_RENDER_MODE);
+	FreeTypeFont_ReleaseFace(font->data, ft_face);
 	return ret;
 }
 
@@ -202,6 +330,7 @@ int LCUIFont_InitFreeType(LCUI_FontEngine *engine)
 	if (FT_Init_FreeType(&freetype.library)) {
 		return -1;
 	}
+	LCUIMutex_Init(&freetype.mutex);
 	strcpy(engine->name, "FreeType");
 	engine->render = FreeType_Render;
 	engine->open = FreeType_Open;
@@ -212,6 +341,7 @@ int LCUIFont_InitFreeType(LCUI_FontEngine *engine)
 int LCUIFont_ExitFreeType(void)
 {
 	FT_Done_FreeType(freetype.library);
+	LCUIMutex_Destroy(&freetype.mutex);
 	return 0;
 }
 
@@ -29,6 +29,8 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
+#include <errno.h>
 #include <wctype.h>
 #include <LCUI_Build.h>
 #include <LCUI/types.h>
@@ -40,155 +42,522 @@
 
 typedef enum { TEXT_ACTION_INSERT, TEXT_ACTION_APPEND } TextAction;
 
+/** 文本行的字符缓冲区的最小容量 */
+#define TEXT_ROW_MIN_CAPACITY 16
+
 #define TextRowList_AddNewRow(ROWLIST) \
 	TextRowList_InsertNewRow(ROWLIST, (ROWLIST)->length)
-#define TextLayer_GetRow(layer, n) \
-	(n >= layer->text_rows.length) ? NULL : layer->text_rows.rows[n]
+#define TextLayer_GetRow(layer, n) TextRowList_Get(&(layer)->text_rows, n)
+#define TextRow_Count(ROW) ((ROW) ? (ROW)->count : 0)
+#define TextRow_TotalHeight(ROW) ((ROW) ? (ROW)->total_height : 0)
+#define TextRow_MaxTextWidth(ROW) ((ROW) ? (ROW)->max_text_width : 0)
+#define TextRow_HasTypesetRows(ROW) ((ROW) ? (ROW)->has_typeset_rows : FALSE)
+/** 获取文本行中的字符，位于间隙后面的字符需要跳过间隙 */
+#define TextRow_GetChar(ROW, I)                 \
+	((ROW)->string + ((I) < (ROW)->gap_start \
+			      ? (I)              \
+			      : (I) + (ROW)->capacity - (ROW)->length))
 #define GetDefaultLineHeight(H) iround(H * 1.42857143)
 #define ISALPHA(CH) (CH >= 'a' && CH <= 'z') || (CH >= 'A' && CH <= 'Z')
 
-/* 根据对齐方式，计算文本行的起始X轴位置 */
-static int TextLayer_GetRowStartX(LCUI_TextLayer layer, LCUI_TextRow txtrow)
+static void TextRow_Init(LCUI_TextRow txtrow)
 {
-	int width;
-	if (layer->fixed_width > 0) {
-		width = layer->fixed_width;
-	} else {
-		width = layer->width;
+	txtrow->width = 0;
+	txtrow->height = 0;
+	txtrow->length = 0;
+	txtrow->capacity = 0;
+	txtrow->gap_start = 0;
+	txtrow->string = NULL;
+	txtrow->eol = LCUI_EOL_NONE;
+	txtrow->need_typeset = TRUE;
+	txtrow->text_width = 0;
+	txtrow->text_height = 0;
+	txtrow->count = 1;
+	txtrow->total_height = 0;
+	txtrow->max_text_width = 0;
+	txtrow->has_typeset_rows = TRUE;
+	txtrow->priority = 0;
+	txtrow->parent = NULL;
+	txtrow->left = NULL;
+	txtrow->right = NULL;
+}
+
+static void TextRow_Destroy(LCUI_TextRow txtrow)
+{
+	int i;
+	for (i = 0; i < txtrow->length; ++i) {
+		LCUIFont_ReleaseBitmap(TextRow_GetChar(txtrow, i)->bitmap);
 	}
-	switch (layer->text_align) {
-	case SV_CENTER:
-		return (width - txtrow->width) / 2;
-	case SV_RIGHT:
-		return width - txtrow->width;
-	case SV_LEFT:
-	default:
-		break;
+	txtrow->width = 0;
+	txtrow->height = 0;
+	txtrow->length = 0;
+	txtrow->capacity = 0;
+	txtrow->gap_start = 0;
+	txtrow->text_width = 0;
+	txtrow->text_height = 0;
+	if (txtrow->string) {
+		free(txtrow->string);
+	}
+	txtrow->string = NULL;
+}
+
+/** 设置文本行是否需要重新排版，并同步更新行索引树中的标记 */
+static void TextRow_SetNeedTypeset(LCUI_TextRow txtrow, LCUI_BOOL need)
+{
+	if (txtrow->need_typeset == need) {
+		return;
+	}
+	txtrow->need_typeset = need;
+	for (; txtrow; txtrow = txtrow->parent) {
+		txtrow->has_typeset_rows = txtrow->need_typeset ||
+					   TextRow_HasTypesetRows(txtrow->left) ||
+					   TextRow_HasTypesetRows(txtrow->right);
+	}
+}
+
+/** 将字符缓冲区中的间隙移动到指定位置 */
+static void TextRow_MoveGap(LCUI_TextRow txtrow, int pos)
+{
+	int gap = txtrow->capacity - txtrow->length;
+	LCUI_TextCharRec *str = txtrow->string;
+
+	if (pos < txtrow->gap_start) {
+		memmove(str + pos + gap, str + pos,
+			sizeof(LCUI_TextCharRec) * (txtrow->gap_start - pos));
+	} else if (pos > txtrow->gap_start) {
+		memmove(str + txtrow->gap_start, str + txtrow->gap_start + gap,
+			sizeof(LCUI_TextCharRec) * (pos - txtrow->gap_start));
 	}
+	txtrow->gap_start = pos;
+}
+
+/** 确保字符缓冲区能够存放指定数量的字符 */
+static int TextRow_Reserve(LCUI_TextRow txtrow, int len)
+{
+	int capacity, tail;
+	LCUI_TextCharRec *str;
+
+	if (len <= txtrow->capacity) {
+		return 0;
+	}
+	capacity = max(txtrow->capacity * 2, TEXT_ROW_MIN_CAPACITY);
+	capacity = max(capacity, len);
+	str = realloc(txtrow->string, sizeof(LCUI_TextCharRec) * capacity);
+	if (!str) {
+		return -ENOMEM;
+	}
+	/* 间隙后面的字符需要移动到新缓冲区的末尾 */
+	tail = txtrow->length - txtrow->gap_start;
+	memmove(str + capacity - tail, str + txtrow->capacity - tail,
+		sizeof(LCUI_TextCharRec) * tail);
+	txtrow->string = str;
+	txtrow->capacity = capacity;
 	return 0;
 }
 
-/** 获取文本行总数 */
-int TextLayer_GetRowTotal(LCUI_TextLayer layer)
+/** 将字符数据插入至文本行 */
+static int TextRow_InsertChars(LCUI_TextRow txtrow, int ins_pos,
+			       const LCUI_TextCharRec *chars, int n)
 {
-	return layer->text_rows.length;
+	if (ins_pos < 0) {
+		ins_pos = 0;
+	} else if (ins_pos > txtrow->length) {
+		ins_pos = txtrow->length;
+	}
+	if (TextRow_Reserve(txtrow, txtrow->length + n) != 0) {
+		return -ENOMEM;
+	}
+	TextRow_MoveGap(txtrow, ins_pos);
+	memcpy(txtrow->string + ins_pos, chars, sizeof(LCUI_TextCharRec) * n);
+	txtrow->gap_start += n;
+	txtrow->length += n;
+	TextRow_SetNeedTypeset(txtrow, TRUE);
+	return 0;
 }
 
-/** 获取指定文本行的高度 */
-int TextLayer_GetRowHeight(LCUI_TextLayer layer, int row)
+/** 删除文本行中从指定位置开始的若干个字符 */
+static void TextRow_RemoveChars(LCUI_TextRow txtrow, int pos, int n)
+{
+	int i;
+	LCUI_TextCharRec *str;
+
+	n = min(n, txtrow->length - pos);
+	if (n <= 0) {
+		return;
+	}
+	TextRow_MoveGap(txtrow, pos);
+	/* 紧跟在间隙后面的就是要删除的字符，删除后它们会成为间隙的一部分 */
+	str = txtrow->string + pos + txtrow->capacity - txtrow->length;
+	for (i = 0; i < n; ++i) {
+		LCUIFont_ReleaseBitmap(str[i].bitmap);
+	}
+	txtrow->length -= n;
+	TextRow_SetNeedTypeset(txtrow, TRUE);
+}
+
+/** 将文本行中从指定位置开始的字符转移至另一文本行 */
+static int TextRow_MoveChars(LCUI_TextRow txtrow, int pos, LCUI_TextRow dest,
+			     int dest_pos)
 {
-	if (row >= layer->text_rows.length) {
+	int n = txtrow->length - pos;
+	LCUI_TextCharRec *str;
+
+	if (n <= 0) {
 		return 0;
 	}
-	return layer->text_rows.rows[row]->height;
+	TextRow_MoveGap(txtrow, pos);
+	str = txtrow->string + txtrow->capacity - n;
+	if (TextRow_InsertChars(dest, dest_pos, str, n) != 0) {
+		return -ENOMEM;
+	}
+	txtrow->length = pos;
+	TextRow_SetNeedTypeset(txtrow, TRUE);
+	return 0;
 }
 
-/** 获取指定文本行的文本长度 */
-int TextLayer_GetRowTextLength(LCUI_TextLayer layer, int row)
+/** 更新行索引树节点中记录的子树信息，并关联子节点 */
+static void TextRow_UpdateNode(LCUI_TextRow txtrow)
 {
-	if (row >= layer->text_rows.length) {
-		return -1;
+	txtrow->count = 1 + TextRow_Count(txtrow->left);
+	txtrow->count += TextRow_Count(txtrow->right);
+	txtrow->total_height = txtrow->height;
+	txtrow->total_height += TextRow_TotalHeight(txtrow->left);
+	txtrow->total_height += TextRow_TotalHeight(txtrow->right);
+	txtrow->max_text_width = max(txtrow->text_width,
+				     TextRow_MaxTextWidth(txtrow->left));
+	txtrow->max_text_width = max(txtrow->max_text_width,
+				     TextRow_MaxTextWidth(txtrow->right));
+	txtrow->has_typeset_rows = txtrow->need_typeset ||
+				   TextRow_HasTypesetRows(txtrow->left) ||
+				   TextRow_HasTypesetRows(txtrow->right);
+	if (txtrow->left) {
+		txtrow->left->parent = txtrow;
+	}
+	if (txtrow->right) {
+		txtrow->right->parent = txtrow;
 	}
-	return layer->text_rows.rows[row]->length;
 }
 
-/** 添加 更新文本排版 的任务 */
-void TextLayer_AddUpdateTypeset(LCUI_TextLayer layer, int start_row)
+/** 将行索引树拆分成两棵树，左边的树包含前 n 行，右边的树包含其余的行 */
+static void TextRowTree_Split(LCUI_TextRow root, int n, LCUI_TextRow *left,
+			      LCUI_TextRow *right)
 {
-	if (start_row < layer->task.typeset_start_row) {
-		layer->task.typeset_start_row = start_row;
+	int count;
+
+	if (!root) {
+		*left = NULL;
+		*right = NULL;
+		return;
 	}
-	layer->task.update_typeset = TRUE;
+	count = TextRow_Count(root->left);
+	if (count < n) {
+		TextRowTree_Split(root->right, n - count - 1, &root->right,
+				  right);
+		*left = root;
+	} else {
+		TextRowTree_Split(root->left, n, left, &root->left);
+		*right = root;
+	}
+	TextRow_UpdateNode(root);
+	root->parent = NULL;
 }
 
-static void TextRow_Init(LCUI_TextRow txtrow)
+/** 合并两棵行索引树，左边的树中的行会排在右边的树中的行的前面 */
+static LCUI_TextRow TextRowTree_Merge(LCUI_TextRow left, LCUI_TextRow right)
 {
-	txtrow->width = 0;
-	txtrow->height = 0;
-	txtrow->length = 0;
-	txtrow->string = NULL;
-	txtrow->eol = LCUI_EOL_NONE;
-	txtrow->text_height = 0;
+	if (!left) {
+		return right;
+	}
+	if (!right) {
+		return left;
+	}
+	if (left->priority > right->priority) {
+		left->right = TextRowTree_Merge(left->right, right);
+		TextRow_UpdateNode(left);
+		return left;
+	}
+	right->left = TextRowTree_Merge(left, right->left);
+	TextRow_UpdateNode(right);
+	return right;
 }
 
-static void TextRow_Destroy(LCUI_TextRow txtrow)
+static void TextRowTree_Destroy(LCUI_TextRow root)
 {
-	int i;
-	for (i = 0; i < txtrow->length; ++i) {
-		if (txtrow->string[i]) {
-			free(txtrow->string[i]);
+	if (!root) {
+		return;
+	}
+	TextRowTree_Destroy(root->left);
+	TextRowTree_Destroy(root->right);
+	TextRow_Destroy(root);
+	free(root);
+}
+
+static void TextRowList_Init(LCUI_TextRowList rowlist)
+{
+	rowlist->length = 0;
+	rowlist->seed = 2463534242u;
+	rowlist->root = NULL;
+}
+
+static void TextRowList_Destroy(LCUI_TextRowList rowlist)
+{
+	TextRowTree_Destroy(rowlist->root);
+	rowlist->root = NULL;
+	rowlist->length = 0;
+}
+
+/** 获取指定行号的文本行 */
+static LCUI_TextRow TextRowList_Get(LCUI_TextRowList rowlist, int i_row)
+{
+	int count;
+	LCUI_TextRow txtrow = rowlist->root;
+
+	if (i_row < 0 || i_row >= rowlist->length) {
+		return NULL;
+	}
+	while (txtrow) {
+		count = TextRow_Count(txtrow->left);
+		if (i_row < count) {
+			txtrow = txtrow->left;
+		} else if (i_row > count) {
+			i_row -= count + 1;
+			txtrow = txtrow->right;
+		} else {
+			break;
 		}
 	}
-	txtrow->width = 0;
-	txtrow->height = 0;
-	txtrow->length = 0;
-	txtrow->text_height = 0;
-	if (txtrow->string) {
-		free(txtrow->string);
+	return txtrow;
+}
+
+/** 获取指定文本行的Y轴坐标，即它前面的所有文本行的总高度 */
+static int TextRowList_GetRowY(LCUI_TextRowList rowlist, int i_row)
+{
+	int y = 0, count;
+	LCUI_TextRow txtrow = rowlist->root;
+
+	while (txtrow) {
+		count = TextRow_Count(txtrow->left);
+		if (i_row < count) {
+			txtrow = txtrow->left;
+			continue;
+		}
+		y += TextRow_TotalHeight(txtrow->left);
+		if (i_row == count) {
+			break;
+		}
+		y += txtrow->height;
+		i_row -= count + 1;
+		txtrow = txtrow->right;
 	}
-	txtrow->string = NULL;
+	return y;
+}
+
+/**
+ * 获取包含指定Y轴坐标的文本行
+ * @param[in] y 相对于第一行顶部的Y轴坐标，小于 0 时按 0 处理
+ * @param[out] i_row 文本行的行号
+ * @param[out] row_y 文本行的Y轴坐标
+ * @returns 若Y轴坐标超出了所有文本行的范围，则返回 NULL
+ */
+static LCUI_TextRow TextRowList_GetRowByY(LCUI_TextRowList rowlist, int y,
+					  int *i_row, int *row_y)
+{
+	int height;
+	LCUI_TextRow txtrow = rowlist->root;
+
+	*i_row = 0;
+	*row_y = 0;
+	y = max(y, 0);
+	while (txtrow) {
+		height = TextRow_TotalHeight(txtrow->left);
+		if (y < height) {
+			txtrow = txtrow->left;
+			continue;
+		}
+		y -= height;
+		*i_row += TextRow_Count(txtrow->left);
+		*row_y += height;
+		if (y < txtrow->height) {
+			break;
+		}
+		y -= txtrow->height;
+		*i_row += 1;
+		*row_y += txtrow->height;
+		txtrow = txtrow->right;
+	}
+	return txtrow;
+}
+
+/** 在行索引树中查找从指定行开始的第一个需要重新排版的行，返回其行号 */
+static int TextRowTree_FindTypesetRow(LCUI_TextRow root, int start_row)
+{
+	int i, count;
+
+	if (!TextRow_HasTypesetRows(root)) {
+		return -1;
+	}
+	count = TextRow_Count(root->left);
+	if (start_row < count) {
+		i = TextRowTree_FindTypesetRow(root->left, start_row);
+		if (i >= 0) {
+			return i;
+		}
+	}
+	if (start_row <= count && root->need_typeset) {
+		return count;
+	}
+	i = TextRowTree_FindTypesetRow(root->right,
+				       max(start_row - count - 1, 0));
+	return i < 0 ? -1 : i + count + 1;
+}
+
+/** 获取下一个文本行 */
+static LCUI_TextRow TextRow_Next(LCUI_TextRow txtrow)
+{
+	if (txtrow->right) {
+		txtrow = txtrow->right;
+		while (txtrow->left) {
+			txtrow = txtrow->left;
+		}
+		return txtrow;
+	}
+	while (txtrow->parent && txtrow->parent->right == txtrow) {
+		txtrow = txtrow->parent;
+	}
+	return txtrow->parent;
 }
 
 /** 向文本行列表中插入新的文本行 */
 static LCUI_TextRow TextRowList_InsertNewRow(LCUI_TextRowList rowlist,
 					     int i_row)
 {
-	int i, size;
-	LCUI_TextRow txtrow, *txtrows;
+	LCUI_TextRow txtrow, left, right;
+
 	if (i_row > rowlist->length) {
 		i_row = rowlist->length;
 	}
-	++rowlist->length;
-	size = sizeof(LCUI_TextRow) * (rowlist->length + 1);
-	txtrows = realloc(rowlist->rows, size);
-	if (!txtrows) {
-		--rowlist->length;
-		return NULL;
-	}
-	txtrows[rowlist->length] = NULL;
 	txtrow = malloc(sizeof(LCUI_TextRowRec));
 	if (!txtrow) {
-		--rowlist->length;
 		return NULL;
 	}
 	TextRow_Init(txtrow);
-	for (i = rowlist->length - 1; i > i_row; --i) {
-		txtrows[i] = txtrows[i - 1];
-	}
-	txtrows[i_row] = txtrow;
-	rowlist->rows = txtrows;
+	/* 用 xorshift 算法生成随机的优先级，使树的期望高度为对数级 */
+	rowlist->seed ^= rowlist->seed << 13;
+	rowlist->seed ^= rowlist->seed >> 17;
+	rowlist->seed ^= rowlist->seed << 5;
+	txtrow->priority = rowlist->seed;
+	TextRowTree_Split(rowlist->root, i_row, &left, &right);
+	left = TextRowTree_Merge(left, txtrow);
+	rowlist->root = TextRowTree_Merge(left, right);
+	rowlist->root->parent = NULL;
+	++rowlist->length;
 	return txtrow;
 }
 
 /** 从文本行列表中删除指定文本行 */
 static int TextRowList_RemoveRow(LCUI_TextRowList rowlist, int i_row)
 {
+	LCUI_TextRow txtrow, left, right;
+
 	if (i_row < 0 || i_row >= rowlist->length) {
 		return -1;
 	}
-	TextRow_Destroy(rowlist->rows[i_row]);
-	free(rowlist->rows[i_row]);
-	for (; i_row < rowlist->length - 1; ++i_row) {
-		rowlist->rows[i_row] = rowlist->rows[i_row + 1];
+	TextRowTree_Split(rowlist->root, i_row, &left, &right);
+	TextRowTree_Split(right, 1, &txtrow, &right);
+	rowlist->root = TextRowTree_Merge(left, right);
+	if (rowlist->root) {
+		rowlist->root->parent = NULL;
 	}
-	rowlist->rows[i_row] = NULL;
+	TextRow_Destroy(txtrow);
+	free(txtrow);
 	--rowlist->length;
 	return 0;
 }
 
+/* 根据对齐方式，计算文本行的起始X轴位置 */
+static int TextLayer_GetRowStartX(LCUI_TextLayer layer, LCUI_TextRow txtrow)
+{
+	int width;
+	if (layer->fixed_width > 0) {
+		width = layer->fixed_width;
+	} else {
+		width = layer->width;
+	}
+	switch (layer->text_align) {
+	case SV_CENTER:
+		return (width - txtrow->width) / 2;
+	case SV_RIGHT:
+		return width - txtrow->width;
+	case SV_LEFT:
+	default:
+		break;
+	}
+	return 0;
+}
+
+/** 获取文本行总数 */
+int TextLayer_GetRowTotal(LCUI_TextLayer layer)
+{
+	return layer->text_rows.length;
+}
+
+/** 获取指定文本行的高度 */
+int TextLayer_GetRowHeight(LCUI_TextLayer layer, int row)
+{
+	LCUI_TextRow txtrow = TextLayer_GetRow(layer, row);
+
+	if (!txtrow) {
+		return 0;
+	}
+	return txtrow->height;
+}
+
+/** 获取指定文本行的文本长度 */
+int TextLayer_GetRowTextLength(LCUI_TextLayer layer, int row)
+{
+	LCUI_TextRow txtrow = TextLayer_GetRow(layer, row);
+
+	if (!txtrow) {
+		return -1;
+	}
+	return txtrow->length;
+}
+
+/** 添加 更新文本排版 的任务 */
+void TextLayer_AddUpdateTypeset(LCUI_TextLayer layer, int start_row)
+{
+	if (!layer->task.update_typeset ||
+	    start_row < layer->task.typeset_start_row) {
+		layer->task.typeset_start_row = start_row;
+	}
+	layer->task.update_typeset = TRUE;
+}
+
+/** 添加 对所有文本重新排版 的任务，用于排版相关的属性有变化时 */
+static void TextLayer_AddUpdateTypesetAll(LCUI_TextLayer layer)
+{
+	layer->task.update_typeset = TRUE;
+	layer->task.typeset_all = TRUE;
+	layer->task.typeset_start_row = 0;
+}
+
 /** 更新文本行的尺寸 */
 static void TextLayer_UpdateRowSize(LCUI_TextLayer layer, LCUI_TextRow txtrow)
 {
 	int i;
 	LCUI_TextChar txtchar;
 	txtrow->width = 0;
+	txtrow->text_width = 0;
 	txtrow->text_height = layer->text_default_style.pixel_size;
 	for (i = 0; i < txtrow->length; ++i) {
-		txtchar = txtrow->string[i];
+		txtchar = TextRow_GetChar(txtrow, i);
 		if (!txtchar->bitmap) {
 			continue;
 		}
 		txtrow->width += txtchar->bitmap->advance.x;
+		if (txtchar->bitmap->buffer) {
+			txtrow->text_width += txtchar->bitmap->advance.x;
+		}
 		if (txtrow->text_height < txtchar->bitmap->advance.y) {
 			txtrow->text_height = txtchar->bitmap->advance.y;
 		}
@@ -198,79 +567,96 @@ static void TextLayer_UpdateRowSize(LCUI_TextLayer layer, LCUI_TextRow txtrow)
 	} else {
 		txtrow->height = GetDefaultLineHeight(txtrow->text_height);
 	}
-}
-
-/** 设置文本行的字符串长度 */
-static int TextRow_SetLength(LCUI_TextRow txtrow, int len)
-{
-	LCUI_TextChar *txtstr;
-	if (len < 0) {
-		len = 0;
-	}
-	txtstr = realloc(txtrow->string, sizeof(LCUI_TextChar) * (len + 1));
-	if (!txtstr) {
-		return -1;
+	/* 更新行索引树中记录的总高度和最大宽度 */
+	for (; txtrow; txtrow = txtrow->parent) {
+		TextRow_UpdateNode(txtrow);
 	}
-	txtstr[len] = NULL;
-	txtrow->string = txtstr;
-	txtrow->length = len;
-	return 0;
 }
 
-/** 将字符数据直接插入至文本行 */
-static int TextRow_Insert(LCUI_TextRow txtrow, int ins_pos,
-			  LCUI_TextChar txtchar)
+/** 获取字符使用的字体和字体大小 */
+static void TextChar_GetFont(LCUI_TextChar ch, LCUI_TextStyle style,
+			     LCUI_FontBitmapRequest req)
 {
-	int i;
-	if (ins_pos < 0) {
-		ins_pos = txtrow->length + 1 + ins_pos;
-		if (ins_pos < 0) {
-			ins_pos = 0;
+	req->ch = ch->code;
+	req->size = style->pixel_size;
+	req->font_ids = style->font_ids;
+	if (ch->style) {
+		if (ch->style->has_family) {
+			req->font_ids = ch->style->font_ids;
+		}
+		if (ch->style->has_pixel_size) {
+			req->size = ch->style->pixel_size;
 		}
-	} else if (ins_pos > txtrow->length) {
-		ins_pos = txtrow->length;
-	}
-	TextRow_SetLength(txtrow, txtrow->length + 1);
-	for (i = txtrow->length - 1; i > ins_pos; --i) {
-		txtrow->string[i] = txtrow->string[i - 1];
 	}
-	txtrow->string[ins_pos] = txtchar;
-	return 0;
 }
 
-/** 向文本行插入一个字符数据副本 */
-static int TextRow_InsertCopy(LCUI_TextRow txtrow, int ins_pos,
-			      LCUI_TextChar txtchar)
+/** 更新字体位图 */
+static void TextChar_UpdateBitmap(LCUI_TextChar ch, LCUI_TextStyle style)
 {
-	LCUI_TextChar txtchar2;
-	txtchar2 = malloc(sizeof(LCUI_TextCharRec));
-	*txtchar2 = *txtchar;
-	return TextRow_Insert(txtrow, ins_pos, txtchar2);
+	LCUI_FontBitmapRequestRec req;
+	const LCUI_FontBitmap *bitmap = ch->bitmap;
+
+	TextChar_GetFont(ch, style, &req);
+	/* 字符会长期持有字体位图，需要避免它被移出缓存 */
+	LCUIFont_AcquireBitmap(req.ch, req.font_ids, req.size, &ch->bitmap);
+	LCUIFont_ReleaseBitmap(bitmap);
 }
 
-/** 更新字体位图 */
-static void TextChar_UpdateBitmap(LCUI_TextChar ch, LCUI_TextStyle style)
+/**
+ * 载入文本行中各个字符的字体位图
+ * 先批量载入缓存中没有的字体位图，让它们在多个线程中并行渲染，然后再逐个更新
+ * 字符的字体位图，以免大段文本的字形都在当前线程中逐个渲染。
+ * @param[in] reload 是否重新载入已有字体位图的字符
+ */
+static void TextLayer_LoadCharBitmaps(LCUI_TextLayer layer, int start_row,
+				      int end_row, LCUI_BOOL reload)
 {
-	int i = 0;
-	int size = style->pixel_size;
-	int *font_ids = style->font_ids;
-	if (ch->style) {
-		if (ch->style->has_family) {
-			font_ids = ch->style->font_ids;
+	int row, col;
+	size_t n = 0;
+	LCUI_TextRow txtrow, first_row;
+	LCUI_TextChar txtchar;
+	LCUI_FontBitmapRequest reqs;
+	LCUI_TextStyle style = &layer->text_default_style;
+
+	first_row = TextLayer_GetRow(layer, start_row);
+	end_row = min(end_row, layer->text_rows.length - 1);
+	for (row = start_row, txtrow = first_row; row <= end_row;
+	     ++row, txtrow = TextRow_Next(txtrow)) {
+		for (col = 0; col < txtrow->length; ++col) {
+			if (reload || !TextRow_GetChar(txtrow, col)->bitmap) {
+				++n;
+			}
 		}
-		if (ch->style->has_pixel_size) {
-			size = ch->style->pixel_size;
+	}
+	if (n < 1) {
+		return;
+	}
+	reqs = malloc(sizeof(LCUI_FontBitmapRequestRec) * n);
+	if (reqs) {
+		n = 0;
+		for (row = start_row, txtrow = first_row; row <= end_row;
+		     ++row, txtrow = TextRow_Next(txtrow)) {
+			for (col = 0; col < txtrow->length; ++col) {
+				txtchar = TextRow_GetChar(txtrow, col);
+				if (reload || !txtchar->bitmap) {
+					TextChar_GetFont(txtchar, style,
+							 &reqs[n++]);
+				}
+			}
 		}
+		LCUIFont_LoadBitmaps(reqs, n);
+		free(reqs);
 	}
-	while (font_ids && font_ids[i] > 0) {
-		int ret = LCUIFont_GetBitmap(ch->code, font_ids[i], size,
-					     &ch->bitmap);
-		if (ret == 0) {
-			return;
+	for (row = start_row, txtrow = first_row; row <= end_row;
+	     ++row, txtrow = TextRow_Next(txtrow)) {
+		for (col = 0; col < txtrow->length; ++col) {
+			txtchar = TextRow_GetChar(txtrow, col);
+			if (reload || !txtchar->bitmap) {
+				TextChar_UpdateBitmap(txtchar, style);
+			}
 		}
-		++i;
+		TextLayer_UpdateRowSize(layer, txtrow);
 	}
-	LCUIFont_GetBitmap(ch->code, -1, size, &ch->bitmap);
 }
 
 /** 新建文本图层 */
@@ -291,8 +677,7 @@ LCUI_TextLayer TextLayer_New(void)
 	layer->new_offset_x = 0;
 	layer->new_offset_y = 0;
 	layer->line_height = -1;
-	layer->text_rows.length = 0;
-	layer->text_rows.rows = NULL;
+	TextRowList_Init(&layer->text_rows);
 	layer->text_align = SV_LEFT;
 	layer->enable_autowrap = FALSE;
 	layer->enable_mulitiline = FALSE;
@@ -302,6 +687,7 @@ LCUI_TextLayer TextLayer_New(void)
 	LinkedList_Init(&layer->text_styles);
 	layer->task.typeset_start_row = 0;
 	layer->task.update_typeset = 0;
+	layer->task.typeset_all = 0;
 	layer->task.update_bitmap = 0;
 	layer->task.redraw_all = 0;
 	LinkedList_Init(&layer->dirty_rects);
@@ -309,21 +695,6 @@ LCUI_TextLayer TextLayer_New(void)
 	return layer;
 }
 
-static void TextRowList_Destroy(LCUI_TextRowList list)
-{
-	int row;
-	for (row = 0; row < list->length; ++row) {
-		TextRow_Destroy(list->rows[row]);
-		free(list->rows[row]);
-		list->rows[row] = NULL;
-	}
-	list->length = 0;
-	if (list->rows) {
-		free(list->rows);
-	}
-	list->rows = NULL;
-}
-
 static void OnDestroyTextStyle(void *data)
 {
 	TextStyle_Destroy(data);
@@ -351,17 +722,16 @@ static int TextLayer_GetRowRect(LCUI_TextLayer layer, int i_row, int start_col,
 {
 	int i;
 	LCUI_TextRow txtrow;
+	LCUI_TextChar txtchar;
 
-	if (i_row >= layer->text_rows.length) {
+	if (i_row < 0 || i_row >= layer->text_rows.length) {
 		return -1;
 	}
 	/* 先计算在有效区域内的起始行的Y轴坐标 */
 	rect->y = layer->offset_y;
+	rect->y += TextRowList_GetRowY(&layer->text_rows, i_row);
 	rect->x = layer->offset_x;
-	for (i = 0; i < i_row; ++i) {
-		rect->y += layer->text_rows.rows[i]->height;
-	}
-	txtrow = layer->text_rows.rows[i_row];
+	txtrow = TextLayer_GetRow(layer, i_row);
 	if (end_col < 0 || end_col >= txtrow->length) {
 		end_col = txtrow->length - 1;
 	}
@@ -371,17 +741,19 @@ static int TextLayer_GetRowRect(LCUI_TextLayer layer, int i_row, int start_col,
 		rect->width = txtrow->width;
 	} else {
 		for (i = 0; i < start_col; ++i) {
-			if (!txtrow->string[i]->bitmap) {
+			txtchar = TextRow_GetChar(txtrow, i);
+			if (!txtchar->bitmap) {
 				continue;
 			}
-			rect->x += txtrow->string[i]->bitmap->advance.x;
+			rect->x += txtchar->bitmap->advance.x;
 		}
 		rect->width = 0;
 		for (i = start_col; i <= end_col && i < txtrow->length; ++i) {
-			if (!txtrow->string[i]->bitmap) {
+			txtchar = TextRow_GetChar(txtrow, i);
+			if (!txtchar->bitmap) {
 				continue;
 			}
-			rect->width += txtrow->string[i]->bitmap->advance.x;
+			rect->width += txtchar->bitmap->advance.x;
 		}
 	}
 	if (rect->width <= 0 || rect->height <= 0) {
@@ -406,23 +778,28 @@ void TextLayer_InvalidateRowsRect(LCUI_TextLayer layer, int start_row,
 {
 	int i, y;
 	LCUI_Rect rect;
+	LCUI_TextRow txtrow;
 
 	if (end_row < 0 || end_row >= layer->text_rows.length) {
 		end_row = layer->text_rows.length - 1;
 	}
 
-	y = layer->offset_y;
-	for (i = 0; i < layer->text_rows.length; ++i) {
-		y += layer->text_rows.rows[i]->height;
-		if (i >= start_row && y >= 0) {
-			y -= layer->text_rows.rows[i]->height;
-			break;
-		}
+	/* 跳过在可见区域上方的文本行 */
+	txtrow = TextRowList_GetRowByY(&layer->text_rows, -layer->offset_y - 1,
+				       &i, &y);
+	if (!txtrow) {
+		return;
+	}
+	if (i < start_row) {
+		i = start_row;
+		y = TextRowList_GetRowY(&layer->text_rows, i);
+		txtrow = TextLayer_GetRow(layer, i);
 	}
-	for (; i <= end_row; ++i) {
+	y += layer->offset_y;
+	for (; txtrow && i <= end_row; ++i, txtrow = TextRow_Next(txtrow)) {
 		TextLayer_GetRowRect(layer, i, 0, -1, &rect);
 		RectList_Add(&layer->dirty_rects, &rect);
-		y += layer->text_rows.rows[i]->height;
+		y += txtrow->height;
 		if (y >= layer->max_height) {
 			break;
 		}
@@ -444,9 +821,7 @@ void TextLayer_SetCaretPos(LCUI_TextLayer layer, int row, int col)
 	if (col < 0) {
 		col = 0;
 	} else if (layer->text_rows.length > 0) {
-		if (col >= layer->text_rows.rows[row]->length) {
-			col = layer->text_rows.rows[row]->length;
-		}
+		col = min(col, TextLayer_GetRow(layer, row)->length);
 	} else {
 		col = 0;
 	}
@@ -459,30 +834,25 @@ int TextLayer_SetCaretPosByPixelPos(LCUI_TextLayer layer, int x, int y)
 {
 	LCUI_TextRow txtrow;
 	int i, pixel_pos, ins_x, ins_y;
-	pixel_pos = layer->offset_y;
-	for (i = 0; i < layer->text_rows.length; ++i) {
-		pixel_pos += layer->text_rows.rows[i]->height;
-		if (pixel_pos >= y) {
-			ins_y = i;
-			break;
-		}
-	}
-	if (i >= layer->text_rows.length) {
+	txtrow = TextRowList_GetRowByY(&layer->text_rows,
+				       y - layer->offset_y - 1, &ins_y,
+				       &pixel_pos);
+	if (!txtrow) {
 		if (layer->text_rows.length > 0) {
 			ins_y = layer->text_rows.length - 1;
+			txtrow = TextLayer_GetRow(layer, ins_y);
 		} else {
 			layer->insert_x = 0;
 			layer->insert_y = 0;
 			return -1;
 		}
 	}
-	txtrow = layer->text_rows.rows[ins_y];
 	ins_x = txtrow->length;
 	pixel_pos = layer->offset_x;
 	pixel_pos += TextLayer_GetRowStartX(layer, txtrow);
 	for (i = 0; i < txtrow->length; ++i) {
 		LCUI_TextChar txtchar;
-		txtchar = txtrow->string[i];
+		txtchar = TextRow_GetChar(txtrow, i);
 		if (!txtchar->bitmap) {
 			continue;
 		}
@@ -508,17 +878,16 @@ int TextLayer_GetCharPixelPos(LCUI_TextLayer layer, int row, int col,
 	}
 	if (col < 0) {
 		return -2;
-	} else if (col > layer->text_rows.rows[row]->length) {
-		return -3;
 	}
 	/* 累加前几行的高度 */
-	for (i = 0; i < row; ++i) {
-		pixel_y += layer->text_rows.rows[i]->height;
+	pixel_y = TextRowList_GetRowY(&layer->text_rows, row);
+	txtrow = TextLayer_GetRow(layer, row);
+	if (col > txtrow->length) {
+		return -3;
 	}
-	txtrow = layer->text_rows.rows[row];
 	pixel_x = TextLayer_GetRowStartX(layer, txtrow);
 	for (i = 0; i < col; ++i) {
-		LCUI_TextChar txtchar = txtrow->string[i];
+		LCUI_TextChar txtchar = TextRow_GetChar(txtrow, i);
 		if (!txtchar || !txtchar->bitmap) {
 			continue;
 		}
@@ -554,18 +923,13 @@ void TextLayer_ClearText(LCUI_TextLayer layer)
 static void TextLayer_BreakTextRow(LCUI_TextLayer layer, int row, int col,
 				   LCUI_EOLChar eol)
 {
-	int n;
 	LCUI_TextRow txtrow, next;
 	txtrow = TextLayer_GetRow(layer, row);
 	next = TextRowList_InsertNewRow(&layer->text_rows, row + 1);
 	/* 将本行原有的行尾符转移至下一行 */
 	next->eol = txtrow->eol;
 	txtrow->eol = eol;
-	for (n = txtrow->length - 1; n >= col; --n) {
-		TextRow_Insert(next, 0, txtrow->string[n]);
-		txtrow->string[n] = NULL;
-	}
-	txtrow->length = col;
+	TextRow_MoveChars(txtrow, col, next, 0);
 	TextLayer_UpdateRowSize(layer, txtrow);
 	TextLayer_UpdateRowSize(layer, next);
 }
@@ -573,7 +937,6 @@ static void TextLayer_BreakTextRow(LCUI_TextLayer layer, int row, int col,
 /** 将指定行与下一行合并 */
 static void TextLayer_MergeRow(LCUI_TextLayer layer, int row)
 {
-	int i, j;
 	LCUI_TextRow txtrow = TextLayer_GetRow(layer, row);
 	LCUI_TextRow next = TextLayer_GetRow(layer, row + 1);
 
@@ -586,12 +949,7 @@ static void TextLayer_MergeRow(LCUI_TextLayer layer, int row)
 			layer->insert_x += txtrow->length;
 		}
 	}
-	i = txtrow->length;
-	TextRow_SetLength(txtrow, txtrow->length + next->length);
-	for (j = 0; j < next->length; ++i, ++j) {
-		txtrow->string[i] = next->string[j];
-		next->string[j] = NULL;
-	}
+	TextRow_MoveChars(next, 0, txtrow, txtrow->length);
 	txtrow->eol = next->eol;
 	TextLayer_UpdateRowSize(layer, txtrow);
 	TextRowList_RemoveRow(&layer->text_rows, row + 1);
@@ -616,9 +974,9 @@ static void TextLayer_TextRowTypeset(LCUI_TextLayer layer, int row)
 	} else {
 		not_autowrap = FALSE;
 	}
-	txtrow = layer->text_rows.rows[row];
+	txtrow = TextLayer_GetRow(layer, row);
 	for (col = 0; col < txtrow->length; ++col) {
-		txtchar = txtrow->string[col];
+		txtchar = TextRow_GetChar(txtrow, col);
 		if (!txtchar->bitmap) {
 			continue;
 		}
@@ -661,10 +1019,29 @@ static void TextLayer_TextRowTypeset(LCUI_TextLayer layer, int row)
 static void TextLayer_TextTypeset(LCUI_TextLayer layer, int start_row)
 {
 	int row;
+	LCUI_TextRow txtrow;
+	LCUI_EOLChar eol = LCUI_EOL_NONE;
+
 	/* 记录排版前各个文本行的矩形区域 */
 	TextLayer_InvalidateRowsRect(layer, start_row, -1);
 	for (row = start_row; row < layer->text_rows.length; ++row) {
+		txtrow = TextLayer_GetRow(layer, row);
+		/*
+		 * 如果上一行是段落的结尾，且当前行的内容没有变化，那么后面的
+		 * 文本行的排版结果都不会受到影响，直接跳到下一个有变化的行
+		 */
+		if (!layer->task.typeset_all && row > start_row &&
+		    eol != LCUI_EOL_NONE && !txtrow->need_typeset) {
+			row = TextRowTree_FindTypesetRow(layer->text_rows.root,
+							 row);
+			if (row < 0) {
+				break;
+			}
+		}
 		TextLayer_TextRowTypeset(layer, row);
+		txtrow = TextLayer_GetRow(layer, row);
+		TextRow_SetNeedTypeset(txtrow, FALSE);
+		eol = txtrow->eol;
 	}
 	/* 记录排版后各个文本行的矩形区域 */
 	TextLayer_InvalidateRowsRect(layer, start_row, -1);
@@ -783,11 +1160,12 @@ static int TextLayer_ProcessText(LCUI_TextLayer layer, const wchar_t *wstr,
 		}
 		txtchar.style = style;
 		txtchar.code = *p;
-		TextChar_UpdateBitmap(&txtchar, &layer->text_default_style);
-		TextRow_InsertCopy(txtrow, ins_x, &txtchar);
+		txtchar.bitmap = NULL;
+		TextRow_InsertChars(txtrow, ins_x, &txtchar, 1);
 		++layer->length;
 		++ins_x;
 	}
+	TextLayer_LoadCharBitmaps(layer, cur_row, ins_y, FALSE);
 	/* 更新当前行的尺寸 */
 	TextLayer_UpdateRowSize(layer, txtrow);
 	layer->width = max(layer->width, txtrow->width);
@@ -882,18 +1260,20 @@ size_t TextLayer_GetTextW(LCUI_TextLayer layer, size_t start_pos,
 		return 0;
 	}
 	/* 先根据一维坐标计算行列坐标 */
-	for (i = 0, row = 0, col = 0; row < layer->text_rows.length; ++row) {
-		if (i >= start_pos) {
+	row_ptr = TextLayer_GetRow(layer, 0);
+	for (i = 0, row = 0, col = 0; row_ptr; ++row) {
+		if (i + row_ptr->length > start_pos) {
 			col = (int)(start_pos - i);
 			break;
 		}
-		i += layer->text_rows.rows[row]->length;
+		i += row_ptr->length;
+		row_ptr = TextRow_Next(row_ptr);
 	}
-	for (i = 0; row < layer->text_rows.length && i < max_len; ++row) {
-		row_ptr = layer->text_rows.rows[row];
+	for (i = 0; row_ptr && i < max_len; row_ptr = TextRow_Next(row_ptr)) {
 		for (; col < row_ptr->length && i < max_len; ++col, ++i) {
-			wstr_buff[i] = row_ptr->string[col]->code;
+			wstr_buff[i] = TextRow_GetChar(row_ptr, col)->code;
 		}
+		col = 0;
 	}
 	wstr_buff[i] = 0;
 	return i;
@@ -901,38 +1281,12 @@ size_t TextLayer_GetTextW(LCUI_TextLayer layer, size_t start_pos,
 
 int TextLayer_GetWidth(LCUI_TextLayer layer)
 {
-	int i, row, w, max_w;
-	LCUI_TextRow txtrow;
-
-	DEBUG_MSG("rows: %d, font-size: %d\n", layer->text_rows.length,
-		  layer->text_default_style.pixel_size);
-	for (row = 0, max_w = 0; row < layer->text_rows.length; ++row) {
-		txtrow = layer->text_rows.rows[row];
-		for (i = 0, w = 0; i < txtrow->length; ++i) {
-			if (!txtrow->string[i]->bitmap ||
-			    !txtrow->string[i]->bitmap->buffer) {
-				continue;
-			}
-			w += txtrow->string[i]->bitmap->advance.x;
-			DEBUG_MSG("[%d/%d] %d %c, width: %d/%d\n", i,
-				  txtrow->length, txtrow->string[i]->code,
-				  txtrow->string[i]->code,
-				  txtrow->string[i]->bitmap->advance.x, w);
-		}
-		if (w > max_w) {
-			max_w = w;
-		}
-	}
-	return max_w;
+	return TextRow_MaxTextWidth(layer->text_rows.root);
 }
 
 int TextLayer_GetHeight(LCUI_TextLayer layer)
 {
-	int i, h;
-	for (i = 0, h = 0; i < layer->text_rows.length; ++i) {
-		h += layer->text_rows.rows[i]->height;
-	}
-	return h;
+	return TextRow_TotalHeight(layer->text_rows.root);
 }
 
 int TextLayer_SetFixedSize(LCUI_TextLayer layer, int width, int height)
@@ -941,8 +1295,7 @@ int TextLayer_SetFixedSize(LCUI_TextLayer layer, int width, int height)
 	layer->fixed_height = height;
 	layer->task.redraw_all = TRUE;
 	if (layer->enable_autowrap) {
-		layer->task.typeset_start_row = 0;
-		layer->task.update_typeset = TRUE;
+		TextLayer_AddUpdateTypesetAll(layer);
 	}
 	return 0;
 }
@@ -953,8 +1306,7 @@ int TextLayer_SetMaxSize(LCUI_TextLayer layer, int width, int height)
 	layer->max_height = height;
 	layer->task.redraw_all = TRUE;
 	if (layer->enable_autowrap) {
-		layer->task.typeset_start_row = 0;
-		layer->task.update_typeset = TRUE;
+		TextLayer_AddUpdateTypesetAll(layer);
 	}
 	return 0;
 }
@@ -965,7 +1317,7 @@ void TextLayer_SetMultiline(LCUI_TextLayer layer, int is_true)
 	if ((layer->enable_mulitiline && !is_true) ||
 	    (!layer->enable_mulitiline && is_true)) {
 		layer->enable_mulitiline = is_true;
-		TextLayer_AddUpdateTypeset(layer, 0);
+		TextLayer_AddUpdateTypesetAll(layer);
 	}
 }
 
@@ -973,8 +1325,8 @@ void TextLayer_SetMultiline(LCUI_TextLayer layer, int is_true)
 static int TextLayer_TextDeleteEx(LCUI_TextLayer layer, int char_y, int char_x,
 				  int n_char)
 {
-	int end_x, end_y, i, j, len;
-	LCUI_TextRow txtrow, end_txtrow, prev_txtrow;
+	int n;
+	LCUI_TextRow txtrow, next;
 
 	if (char_x < 0) {
 		char_x = 0;
@@ -985,114 +1337,48 @@ static int TextLayer_TextDeleteEx(LCUI_TextLayer layer, int char_y, int char_x,
 	if (n_char <= 0) {
 		return -1;
 	}
-	if (char_y >= layer->text_rows.length) {
+	txtrow = TextLayer_GetRow(layer, char_y);
+	if (!txtrow) {
 		return -2;
 	}
-	txtrow = layer->text_rows.rows[char_y];
 	if (char_x > txtrow->length) {
 		char_x = txtrow->length;
 	}
-	i = n_char;
-	end_x = char_x;
-	end_y = char_y;
-	/* 计算结束点的位置 */
-	for (; end_y < layer->text_rows.length && n_char > 0; ++end_y) {
-		txtrow = layer->text_rows.rows[end_y];
-		if (end_x + n_char <= txtrow->length) {
-			end_x += n_char;
-			n_char = 0;
-			break;
-		}
-		n_char -= (txtrow->length - end_x);
-		if (txtrow->eol == LCUI_EOL_NONE) {
-			end_x = 0;
-		} else {
-			n_char -= 1;
-			end_x = 0;
-		}
-	}
-	if (n_char >= 0) {
-		layer->length -= i - n_char;
-	} else {
+	/* 如果要删除的文本都在同一行 */
+	if (char_x + n_char <= txtrow->length) {
+		TextLayer_InvalidateRowRect(layer, char_y, char_x, -1);
+		TextRow_RemoveChars(txtrow, char_x, n_char);
 		layer->length -= n_char;
-	}
-	if (end_y >= layer->text_rows.length) {
-		end_y = layer->text_rows.length - 1;
-		end_txtrow = layer->text_rows.rows[end_y];
-		end_x = end_txtrow->length;
-	} else {
-		end_txtrow = layer->text_rows.rows[end_y];
-	}
-	if (end_x > end_txtrow->length) {
-		end_x = end_txtrow->length;
-	}
-	if (end_x == char_x && end_y == char_y) {
+		TextLayer_UpdateRowSize(layer, txtrow);
+		TextLayer_AddUpdateTypeset(layer, char_y);
 		return 0;
 	}
-	/* 获取上一行文本 */
-	prev_txtrow = layer->text_rows.rows[char_y - 1];
-	// 计算起始行与结束行拼接后的长度
-	// 起始行：0 1 2 3 4 5，起点位置：2
-	// 结束行：0 1 2 3 4 5，终点位置：4
-	// 拼接后的长度：2 + 6 - 4 = 4
-	len = char_x + end_txtrow->length - end_x;
-	if (len < 0) {
-		return -3;
+	next = TextRow_Next(txtrow);
+	if (!next && char_x == txtrow->length) {
+		return 0;
 	}
-	/* 如果是同一行 */
-	if (txtrow == end_txtrow) {
-		if (end_x > end_txtrow->length) {
-			return -4;
-		}
-		TextLayer_InvalidateRowRect(layer, char_y, char_x, -1);
-		TextLayer_AddUpdateTypeset(layer, char_y);
-		for (i = char_x, j = end_x; j < txtrow->length; ++i, ++j) {
-			txtrow->string[i] = txtrow->string[j];
+	/* 标记当前行及后面的所有行的矩形区域需要刷新 */
+	TextLayer_InvalidateRowsRect(layer, char_y, -1);
+	while (n_char > 0) {
+		n = min(n_char, txtrow->length - char_x);
+		TextRow_RemoveChars(txtrow, char_x, n);
+		layer->length -= n;
+		n_char -= n;
+		next = TextRow_Next(txtrow);
+		if (n_char < 1 || !next) {
+			break;
 		}
-		/* 如果当前行为空，也不是第一行，并且上一行没有结束符 */
-		if (len <= 0 && end_y > 0 &&
-		    prev_txtrow->eol != LCUI_EOL_NONE) {
-			TextRowList_RemoveRow(&layer->text_rows, end_y);
+		/* 行尾的换行符也算一个字符，自动换行产生的行尾则不算 */
+		if (txtrow->eol != LCUI_EOL_NONE) {
+			--layer->length;
+			--n_char;
 		}
-		/* 调整起始行的容量 */
-		TextRow_SetLength(txtrow, len);
-		/* 更新文本行的尺寸 */
-		TextLayer_UpdateRowSize(layer, txtrow);
-		return 0;
-	}
-	/* 如果结束点在行尾，并且该行不是最后一行 */
-	if (end_x == end_txtrow->length &&
-	    end_y < layer->text_rows.length - 1) {
-		++end_y;
-		end_txtrow = TextLayer_GetRow(layer, end_y);
-		end_x = -1;
-		len = char_x + end_txtrow->length;
-	}
-	TextRow_SetLength(txtrow, len);
-	/* 标记当前行后面的所有行的矩形需区域需要刷新 */
-	TextLayer_InvalidateRowsRect(layer, char_y + 1, -1);
-	/* 移除起始行与结束行之间的文本行 */
-	for (i = char_y + 1, j = i; j < end_y; ++j) {
-		TextLayer_InvalidateRowRect(layer, i, 0, -1);
-		TextRowList_RemoveRow(&layer->text_rows, i);
-	}
-	i = char_x;
-	j = end_x + 1;
-	end_y = char_y + 1;
-	/* 将结束行的内容拼接至起始行 */
-	for (; i < len && j < end_txtrow->length; ++i, ++j) {
-		txtrow->string[i] = end_txtrow->string[j];
+		/* 将下一行的文本拼接至当前行 */
+		TextRow_MoveChars(next, 0, txtrow, txtrow->length);
+		txtrow->eol = next->eol;
+		TextRowList_RemoveRow(&layer->text_rows, char_y + 1);
 	}
 	TextLayer_UpdateRowSize(layer, txtrow);
-	TextLayer_InvalidateRowRect(layer, end_y, 0, -1);
-	/* 移除结束行 */
-	TextRowList_RemoveRow(&layer->text_rows, end_y);
-	/* 如果起始行无内容，并且上一行没有结束符（换行符），则
-	 * 说明需要删除起始行 */
-	if (len <= 0 && char_y > 0 && prev_txtrow->eol != LCUI_EOL_NONE) {
-		TextLayer_InvalidateRowRect(layer, char_y, 0, -1);
-		TextRowList_RemoveRow(&layer->text_rows, char_y);
-	}
 	TextLayer_AddUpdateTypeset(layer, char_y);
 	return 0;
 }
@@ -1116,7 +1402,7 @@ int TextLayer_TextBackspace(LCUI_TextLayer layer, int n_char)
 	char_y = layer->insert_y;
 	/* 再计算删除 n_char 个字后的位置 */
 	for (n_del = n_char; char_y >= 0; --char_y) {
-		txtrow = layer->text_rows.rows[char_y];
+		txtrow = TextLayer_GetRow(layer, char_y);
 		/* 如果不是当前行，则重定位至行尾 */
 		if (char_y < layer->insert_y) {
 			char_x = txtrow->length;
@@ -1144,7 +1430,7 @@ int TextLayer_TextBackspace(LCUI_TextLayer layer, int n_char)
 	if (char_x == 0 && layer->text_rows.length > 0 &&
 	    char_y >= layer->text_rows.length) {
 		char_y = layer->text_rows.length - 1;
-		char_x = layer->text_rows.rows[char_y]->length;
+		char_x = TextLayer_GetRow(layer, char_y)->length;
 	}
 	/* 更新文本光标的位置 */
 	TextLayer_SetCaretPos(layer, char_y, char_x);
@@ -1155,7 +1441,7 @@ void TextLayer_SetAutoWrap(LCUI_TextLayer layer, LCUI_BOOL autowrap)
 {
 	if (layer->enable_autowrap != autowrap) {
 		layer->enable_autowrap = autowrap;
-		TextLayer_AddUpdateTypeset(layer, 0);
+		TextLayer_AddUpdateTypesetAll(layer);
 	}
 }
 
@@ -1163,7 +1449,7 @@ void TextLayer_SetWordBreak(LCUI_TextLayer layer, LCUI_WordBreakMode mode)
 {
 	if (layer->word_break != mode) {
 		layer->word_break = mode;
-		TextLayer_AddUpdateTypeset(layer, 0);
+		TextLayer_AddUpdateTypesetAll(layer);
 	}
 }
 
@@ -1188,17 +1474,8 @@ static void TextLayer_UpdateTextStyleCache(LCUI_TextLayer layer)
 /** 重新载入各个文字的字体位图 */
 void TextLayer_ReloadCharBitmap(LCUI_TextLayer layer)
 {
-	int row, col;
 	TextLayer_UpdateTextStyleCache(layer);
-	for (row = 0; row < layer->text_rows.length; ++row) {
-		LCUI_TextRow txtrow = layer->text_rows.rows[row];
-		for (col = 0; col < txtrow->length; ++col) {
-			LCUI_TextChar txtchar = txtrow->string[col];
-			TextChar_UpdateBitmap(txtchar,
-					      &layer->text_default_style);
-		}
-		TextLayer_UpdateRowSize(layer, txtrow);
-	}
+	TextLayer_LoadCharBitmaps(layer, 0, layer->text_rows.length - 1, TRUE);
 }
 
 void TextLayer_Update(LCUI_TextLayer layer, LinkedList *rects)
@@ -1209,10 +1486,13 @@ void TextLayer_Update(LCUI_TextLayer layer, LinkedList *rects)
 		TextLayer_InvalidateRowsRect(layer, 0, -1);
 		layer->task.update_bitmap = FALSE;
 		layer->task.redraw_all = TRUE;
+		/* 字体位图有变化，文本行宽度也会随之改变 */
+		TextLayer_AddUpdateTypesetAll(layer);
 	}
 	if (layer->task.update_typeset) {
 		TextLayer_TextTypeset(layer, layer->task.typeset_start_row);
 		layer->task.update_typeset = FALSE;
+		layer->task.typeset_all = FALSE;
 		layer->task.typeset_start_row = 0;
 	}
 	layer->width = TextLayer_GetWidth(layer);
@@ -1272,7 +1552,7 @@ static void TextLayer_DrawTextRow(LCUI_TextLayer layer, LCUI_Rect *area,
 	x = TextLayer_GetRowStartX(layer, txtrow) + layer->offset_x;
 	/* 确定从哪个文字开始绘制 */
 	for (col = 0; col < txtrow->length; ++col) {
-		txtchar = txtrow->string[col];
+		txtchar = TextRow_GetChar(txtrow, col);
 		/* 忽略无字体位图的文字 */
 		if (!txtchar->bitmap) {
 			continue;
@@ -1290,7 +1570,7 @@ static void TextLayer_DrawTextRow(LCUI_TextLayer layer, LCUI_Rect *area,
 	}
 	/* 遍历该行的文字 */
 	for (; col < txtrow->length; ++col) {
-		txtchar = txtrow->string[col];
+		txtchar = TextRow_GetChar(txtrow, col);
 		if (!txtchar->bitmap) {
 			continue;
 		}
@@ -1322,26 +1602,19 @@ static void TextLayer_DrawTextRow(LCUI_TextLayer layer, LCUI_Rect *area,
 int TextLayer_RenderTo(LCUI_TextLayer layer, LCUI_Rect area, LCUI_Pos layer_pos,
 		       LCUI_Graph *canvas)
 {
-	int y, row;
+	int i, y;
 	LCUI_TextRow txtrow;
 
-	y = layer->offset_y;
 	/* 确定可绘制的最大区域范围 */
 	TextLayer_ValidateArea(layer, &area);
-	for (row = 0; row < layer->text_rows.length; ++row) {
-		txtrow = TextLayer_GetRow(layer, row);
-		y += txtrow->height;
-		if (y > area.y) {
-			y -= txtrow->height;
-			break;
-		}
-	}
+	txtrow = TextRowList_GetRowByY(&layer->text_rows,
+				       area.y - layer->offset_y, &i, &y);
+	y += layer->offset_y;
 	/* 如果没有可绘制的文本行 */
-	if (row >= layer->text_rows.length) {
+	if (!txtrow) {
 		return -1;
 	}
-	for (; row < layer->text_rows.length; ++row) {
-		txtrow = TextLayer_GetRow(layer, row);
+	for (; txtrow; txtrow = TextRow_Next(txtrow)) {
 		TextLayer_DrawTextRow(layer, &area, canvas, layer_pos, txtrow,
 				      y);
 		y += txtrow->height;
@@ -1371,16 +1644,14 @@ void TextLayer_SetTextStyle(LCUI_TextLayer layer, LCUI_TextStyle style)
 void TextLayer_SetTextAlign(LCUI_TextLayer layer, int align)
 {
 	layer->text_align = align;
-	layer->task.update_typeset = TRUE;
-	layer->task.typeset_start_row = 0;
+	TextLayer_AddUpdateTypesetAll(layer);
 }
 
 /** 设置文本行的高度 */
 void TextLayer_SetLineHeight(LCUI_TextLayer layer, int height)
 {
 	layer->line_height = height;
-	layer->task.update_typeset = TRUE;
-	layer->task.typeset_start_row = 0;
+	TextLayer_AddUpdateTypesetAll(layer);
 }
 
 LCUI_BOOL TextLayer_SetOffset(LCUI_TextLayer layer, int offset_x, int offset_y)
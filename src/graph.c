@@ -37,6 +37,19 @@
 #include <LCUI/util.h>
 #include <LCUI/graph.h>
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LCUI_GRAPH_X86_SIMD
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define LCUI_GRAPH_X86_SIMD
+#define TARGET_SSE2
+#define TARGET_AVX2
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
 void Graph_PrintInfo(LCUI_Graph *graph)
 {
 	printf("address:%p\n", graph);
@@ -70,6 +83,7 @@ void Graph_Init(LCUI_Graph *graph)
 	graph->height = 0;
 	graph->bytes_per_pixel = 3;
 	graph->bytes_per_row = 0;
+	graph->pool = NULL;
 }
 
 LCUI_Color RGB(uchar_t r, uchar_t g, uchar_t b)
@@ -205,6 +219,7 @@ static int Graph_RGBToARGB(LCUI_Graph *graph)
 	}
 	free(graph->argb);
 	graph->argb = buffer;
+	graph->pool = NULL;
 	graph->color_type = LCUI_COLOR_TYPE_ARGB8888;
 	return 0;
 }
@@ -388,6 +403,7 @@ static int Graph_ARGBToRGB(LCUI_Graph *graph)
 	}
 	free(graph->argb);
 	graph->bytes = buffer;
+	graph->pool = NULL;
 	graph->color_type = LCUI_COLOR_TYPE_RGB888;
 	graph->bytes_per_pixel = 3;
 	return 0;
@@ -416,72 +432,290 @@ static int Graph_CutARGB(const LCUI_Graph *graph, LCUI_Rect rect,
 	return 0;
 }
 
-/* FIXME: improve alpha blending method
- * Existing alpha blending methods are inefficient and need to be optimized
+/*
+ * ARGB over ARGB blending kernels
+ *
+ * All kernels blend a single row and compute the same result as the
+ * original double-precision formula:
+ *
+ *   ai = ab * (1 - aa)
+ *   Co = (Ca * aa + Cb * ai) / (aa + ai)
+ *   ao = aa + ai
+ *
+ * The colors are multiplied by their weights (premultiplied) before being
+ * summed, and divided by the output alpha only once at the end. The SIMD
+ * kernels do the math for all four channels of a pixel at once, and the
+ * best available kernel is chosen at runtime.
  */
 
+typedef void (*LCUI_ARGBRowMixer)(LCUI_ARGB *, const LCUI_ARGB *, int, float);
+
+#define DIV255(V) (((V) + 128 + (((V) + 128) >> 8)) >> 8)
+
+static void Graph_MixARGBRowWithAlpha(LCUI_ARGB *dst, const LCUI_ARGB *src,
+				      int width, float opacity)
+{
+	unsigned sa, ia, oa;
+	unsigned k = (unsigned)(opacity * 256.0f + 0.5f);
+
+	for (; width > 0; --width, ++src, ++dst) {
+		sa = (src->a * k + 128) >> 8;
+		if (sa == 0) {
+			continue;
+		}
+		if (sa == 255 || dst->a == 0) {
+			dst->value = src->value;
+			dst->a = (uchar_t)sa;
+			continue;
+		}
+		if (dst->a == 255) {
+			ia = 255 - sa;
+			dst->r = (uchar_t)DIV255(src->r * sa + dst->r * ia);
+			dst->g = (uchar_t)DIV255(src->g * sa + dst->g * ia);
+			dst->b = (uchar_t)DIV255(src->b * sa + dst->b * ia);
+			continue;
+		}
+		/* the weights are in 1/(255 * 255) units */
+		ia = dst->a * (255 - sa);
+		oa = sa * 255 + ia;
+		sa *= 255;
+		dst->r = (uchar_t)((src->r * sa + dst->r * ia + oa / 2) / oa);
+		dst->g = (uchar_t)((src->g * sa + dst->g * ia + oa / 2) / oa);
+		dst->b = (uchar_t)((src->b * sa + dst->b * ia + oa / 2) / oa);
+		dst->a = (uchar_t)DIV255(oa);
+	}
+}
+
+#ifdef LCUI_GRAPH_X86_SIMD
+
+/* Blend four channels of one pixel, the alpha lane is the last lane */
+TARGET_SSE2 static __m128i MixPixelSSE2(__m128i s, __m128i d, __m128 k)
+{
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 amask = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+	__m128 fs = _mm_cvtepi32_ps(s);
+	__m128 fd = _mm_cvtepi32_ps(d);
+	__m128 sa = _mm_mul_ps(_mm_shuffle_ps(fs, fs, 0xff), k);
+	__m128 da = _mm_mul_ps(_mm_shuffle_ps(fd, fd, 0xff),
+			       _mm_set1_ps(1.0f / 255.0f));
+	__m128 ia = _mm_mul_ps(_mm_sub_ps(one, sa), da);
+	__m128 oa = _mm_add_ps(sa, ia);
+	__m128 c = _mm_add_ps(_mm_mul_ps(fs, sa), _mm_mul_ps(fd, ia));
+
+	c = _mm_div_ps(c, _mm_max_ps(oa, _mm_set1_ps(1e-6f)));
+	oa = _mm_mul_ps(oa, _mm_set1_ps(255.0f));
+	c = _mm_or_ps(_mm_and_ps(amask, oa), _mm_andnot_ps(amask, c));
+	return _mm_cvttps_epi32(_mm_add_ps(c, _mm_set1_ps(0.5f)));
+}
+
+TARGET_SSE2 static void Graph_MixARGBRowWithAlphaSSE2(LCUI_ARGB *dst,
+						      const LCUI_ARGB *src,
+						      int width, float opacity)
+{
+	__m128i s, d, s16, d16, lo, hi;
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i amask = _mm_set1_epi32((int)0xff000000);
+	const __m128 k = _mm_set1_ps(opacity / 255.0f);
+
+	for (; width >= 4; width -= 4, src += 4, dst += 4) {
+		s = _mm_loadu_si128((const __m128i *)src);
+		/* skip fully transparent pixels */
+		if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(s, amask),
+						      zero)) == 0xffff) {
+			continue;
+		}
+		d = _mm_loadu_si128((const __m128i *)dst);
+		s16 = _mm_unpacklo_epi8(s, zero);
+		d16 = _mm_unpacklo_epi8(d, zero);
+		lo = _mm_packs_epi32(
+		    MixPixelSSE2(_mm_unpacklo_epi16(s16, zero),
+				 _mm_unpacklo_epi16(d16, zero), k),
+		    MixPixelSSE2(_mm_unpackhi_epi16(s16, zero),
+				 _mm_unpackhi_epi16(d16, zero), k));
+		s16 = _mm_unpackhi_epi8(s, zero);
+		d16 = _mm_unpackhi_epi8(d, zero);
+		hi = _mm_packs_epi32(
+		    MixPixelSSE2(_mm_unpacklo_epi16(s16, zero),
+				 _mm_unpacklo_epi16(d16, zero), k),
+		    MixPixelSSE2(_mm_unpackhi_epi16(s16, zero),
+				 _mm_unpackhi_epi16(d16, zero), k));
+		_mm_storeu_si128((__m128i *)dst, _mm_packus_epi16(lo, hi));
+	}
+	for (; width > 0; --width, ++src, ++dst) {
+		if (src->a == 0) {
+			continue;
+		}
+		s = _mm_unpacklo_epi16(
+		    _mm_unpacklo_epi8(_mm_cvtsi32_si128(src->value), zero),
+		    zero);
+		d = _mm_unpacklo_epi16(
+		    _mm_unpacklo_epi8(_mm_cvtsi32_si128(dst->value), zero),
+		    zero);
+		s = MixPixelSSE2(s, d, k);
+		s = _mm_packus_epi16(_mm_packs_epi32(s, s), zero);
+		dst->value = _mm_cvtsi128_si32(s);
+	}
+}
+
+/* Blend two pixels, one pixel per 128-bit lane */
+TARGET_AVX2 static __m256i MixPixelsAVX2(__m256i s, __m256i d, __m256 k)
+{
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 amask =
+	    _mm256_castsi256_ps(_mm256_set_epi32(-1, 0, 0, 0, -1, 0, 0, 0));
+	__m256 fs = _mm256_cvtepi32_ps(s);
+	__m256 fd = _mm256_cvtepi32_ps(d);
+	__m256 sa = _mm256_mul_ps(_mm256_permute_ps(fs, 0xff), k);
+	__m256 da = _mm256_mul_ps(_mm256_permute_ps(fd, 0xff),
+				  _mm256_set1_ps(1.0f / 255.0f));
+	__m256 ia = _mm256_mul_ps(_mm256_sub_ps(one, sa), da);
+	__m256 oa = _mm256_add_ps(sa, ia);
+	__m256 c = _mm256_add_ps(_mm256_mul_ps(fs, sa), _mm256_mul_ps(fd, ia));
+
+	c = _mm256_div_ps(c, _mm256_max_ps(oa, _mm256_set1_ps(1e-6f)));
+	oa = _mm256_mul_ps(oa, _mm256_set1_ps(255.0f));
+	c = _mm256_blendv_ps(c, oa, amask);
+	return _mm256_cvttps_epi32(_mm256_add_ps(c, _mm256_set1_ps(0.5f)));
+}
+
+TARGET_AVX2 static void Graph_MixARGBRowWithAlphaAVX2(LCUI_ARGB *dst,
+						      const LCUI_ARGB *src,
+						      int width, float opacity)
+{
+	__m256i s, d, s16, d16, lo, hi;
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i amask = _mm256_set1_epi32((int)0xff000000);
+	const __m256 k = _mm256_set1_ps(opacity / 255.0f);
+
+	/* The unpack and pack instructions work within 128-bit lanes, so
+	 * pixels are processed in the order (0, 4), (1, 5), (2, 6), (3, 7)
+	 * and are restored to their original order when packed back. */
+	for (; width >= 8; width -= 8, src += 8, dst += 8) {
+		s = _mm256_loadu_si256((const __m256i *)src);
+		if (_mm256_testz_si256(s, amask)) {
+			continue;
+		}
+		d = _mm256_loadu_si256((const __m256i *)dst);
+		s16 = _mm256_unpacklo_epi8(s, zero);
+		d16 = _mm256_unpacklo_epi8(d, zero);
+		lo = _mm256_packs_epi32(
+		    MixPixelsAVX2(_mm256_unpacklo_epi16(s16, zero),
+				  _mm256_unpacklo_epi16(d16, zero), k),
+		    MixPixelsAVX2(_mm256_unpackhi_epi16(s16, zero),
+				  _mm256_unpackhi_epi16(d16, zero), k));
+		s16 = _mm256_unpackhi_epi8(s, zero);
+		d16 = _mm256_unpackhi_epi8(d, zero);
+		hi = _mm256_packs_epi32(
+		    MixPixelsAVX2(_mm256_unpacklo_epi16(s16, zero),
+				  _mm256_unpacklo_epi16(d16, zero), k),
+		    MixPixelsAVX2(_mm256_unpackhi_epi16(s16, zero),
+				  _mm256_unpackhi_epi16(d16, zero), k));
+		_mm256_storeu_si256((__m256i *)dst,
+				    _mm256_packus_epi16(lo, hi));
+	}
+	Graph_MixARGBRowWithAlphaSSE2(dst, src, width, opacity);
+}
+
+static LCUI_BOOL Graph_IsMixerTypeSupported(LCUI_GraphMixerType type)
+{
+#ifdef _MSC_VER
+	int info[4];
+#endif
+
+	switch (type) {
+	case LCUI_GRAPH_MIXER_SCALAR:
+		return TRUE;
+	case LCUI_GRAPH_MIXER_SSE2:
+#ifdef _MSC_VER
+		__cpuid(info, 1);
+		return (info[3] & (1 << 26)) != 0;
+#else
+		return __builtin_cpu_supports("sse2") != 0;
+#endif
+	case LCUI_GRAPH_MIXER_AVX2:
+#ifdef _MSC_VER
+		__cpuid(info, 1);
+		/* check if the OS saves the YMM registers */
+		if (!(info[2] & (1 << 27)) || (_xgetbv(0) & 6) != 6) {
+			return FALSE;
+		}
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+#else
+		return __builtin_cpu_supports("avx2") != 0;
+#endif
+	default:
+		break;
+	}
+	return FALSE;
+}
+
+#else
+
+static LCUI_BOOL Graph_IsMixerTypeSupported(LCUI_GraphMixerType type)
+{
+	return type == LCUI_GRAPH_MIXER_SCALAR;
+}
+
+#endif
+
+static struct LCUI_GraphMixerModule {
+	LCUI_GraphMixerType type;
+	LCUI_ARGBRowMixer mix_row_with_alpha;
+} mixer = { LCUI_GRAPH_MIXER_AUTO, NULL };
+
+int Graph_SetMixerType(LCUI_GraphMixerType type)
+{
+	if (type == LCUI_GRAPH_MIXER_AUTO) {
+		if (Graph_IsMixerTypeSupported(LCUI_GRAPH_MIXER_AVX2)) {
+			type = LCUI_GRAPH_MIXER_AVX2;
+		} else if (Graph_IsMixerTypeSupported(LCUI_GRAPH_MIXER_SSE2)) {
+			type = LCUI_GRAPH_MIXER_SSE2;
+		} else {
+			type = LCUI_GRAPH_MIXER_SCALAR;
+		}
+	} else if (!Graph_IsMixerTypeSupported(type)) {
+		return -ENOTSUP;
+	}
+	switch (type) {
+#ifdef LCUI_GRAPH_X86_SIMD
+	case LCUI_GRAPH_MIXER_AVX2:
+		mixer.mix_row_with_alpha = Graph_MixARGBRowWithAlphaAVX2;
+		break;
+	case LCUI_GRAPH_MIXER_SSE2:
+		mixer.mix_row_with_alpha = Graph_MixARGBRowWithAlphaSSE2;
+		break;
+#endif
+	default:
+		mixer.mix_row_with_alpha = Graph_MixARGBRowWithAlpha;
+		break;
+	}
+	mixer.type = type;
+	return 0;
+}
+
+LCUI_GraphMixerType Graph_GetMixerType(void)
+{
+	if (mixer.type == LCUI_GRAPH_MIXER_AUTO) {
+		Graph_SetMixerType(LCUI_GRAPH_MIXER_AUTO);
+	}
+	return mixer.type;
+}
+
 static void Graph_MixARGBWithAlpha(LCUI_Graph *dst, LCUI_Rect des_rect,
 				   const LCUI_Graph *src, int src_x, int src_y)
 {
-	int x, y;
-	LCUI_ARGB *px_src, *px_dst;
+	int y;
 	LCUI_ARGB *px_row_src, *px_row_des;
-	double a, out_a, out_r, out_g, out_b, src_a;
+
+	if (!mixer.mix_row_with_alpha) {
+		Graph_SetMixerType(LCUI_GRAPH_MIXER_AUTO);
+	}
 	px_row_src = src->argb + src_y * src->width + src_x;
 	px_row_des = dst->argb + des_rect.y * dst->width + des_rect.x;
-	if (src->opacity < 1.0) {
-		goto mix_with_opacity;
-	}
 	for (y = 0; y < des_rect.height; ++y) {
-		px_src = px_row_src;
-		px_dst = px_row_des;
-		for (x = 0; x < des_rect.width; ++x) {
-			src_a = px_src->a / 255.0;
-			a = (1.0 - src_a) * px_dst->a / 255.0;
-			out_r = px_dst->r * a + px_src->r * src_a;
-			out_g = px_dst->g * a + px_src->g * src_a;
-			out_b = px_dst->b * a + px_src->b * src_a;
-			out_a = src_a + a;
-			if (out_a > 0) {
-				out_r /= out_a;
-				out_g /= out_a;
-				out_b /= out_a;
-			}
-			px_dst->r = (uchar_t)(out_r + 0.5);
-			px_dst->g = (uchar_t)(out_g + 0.5);
-			px_dst->b = (uchar_t)(out_b + 0.5);
-			px_dst->a = (uchar_t)(255.0 * out_a + 0.5);
-			++px_src;
-			++px_dst;
-		}
-		px_row_des += dst->width;
-		px_row_src += src->width;
-	}
-	return;
-
-mix_with_opacity:
-	for (y = 0; y < des_rect.height; ++y) {
-		px_src = px_row_src;
-		px_dst = px_row_des;
-		for (x = 0; x < des_rect.width; ++x) {
-			src_a = px_src->a / 255.0 * src->opacity;
-			a = (1.0 - src_a) * px_dst->a / 255.0;
-			out_r = px_dst->r * a + px_src->r * src_a;
-			out_g = px_dst->g * a + px_src->g * src_a;
-			out_b = px_dst->b * a + px_src->b * src_a;
-			out_a = src_a + a;
-			if (out_a > 0) {
-				out_r /= out_a;
-				out_g /= out_a;
-				out_b /= out_a;
-			}
-			px_dst->r = (uchar_t)(out_r + 0.5);
-			px_dst->g = (uchar_t)(out_g + 0.5);
-			px_dst->b = (uchar_t)(out_b + 0.5);
-			px_dst->a = (uchar_t)(255.0 * out_a + 0.5);
-			++px_src;
-			++px_dst;
-		}
+		mixer.mix_row_with_alpha(px_row_des, px_row_src,
+					 des_rect.width, src->opacity);
 		px_row_des += dst->width;
 		px_row_src += src->width;
 	}
@@ -583,7 +817,7 @@ static int Graph_ReplaceARGB(LCUI_Graph *des, LCUI_Rect des_rect,
 	LCUI_ARGB *px_row_src, *px_row_des, *px_src, *px_des;
 	px_row_src = src->argb + src_y * src->width + src_x;
 	px_row_des = des->argb + des_rect.y * des->width + des_rect.x;
-	if (src->opacity - 1.0f < 0.01f) {
+	if (1.0f - src->opacity < 0.01f) {
 		row_size = sizeof(LCUI_ARGB) * des_rect.width;
 		for (y = 0; y < des_rect.height; ++y) {
 			memcpy(px_row_des, px_row_src, row_size);
@@ -600,6 +834,8 @@ static int Graph_ReplaceARGB(LCUI_Graph *des, LCUI_Rect des_rect,
 			px_des->g = px_src->g;
 			px_des->r = px_src->r;
 			px_des->a = (uchar_t)(src->opacity * px_src->a);
+			++px_src;
+			++px_des;
 		}
 		px_row_src += src->width;
 		px_row_des += des->width;
@@ -760,6 +996,7 @@ int Graph_Create(LCUI_Graph *graph, unsigned width, unsigned height)
 		Graph_Free(graph);
 	}
 	graph->mem_size = size;
+	graph->pool = NULL;
 	graph->bytes = calloc(1, size);
 	if (!graph->bytes) {
 		graph->width = 0;
@@ -809,6 +1046,7 @@ void Graph_Free(LCUI_Graph *graph)
 	graph->width = 0;
 	graph->height = 0;
 	graph->mem_size = 0;
+	graph->pool = NULL;
 }
 
 int Graph_QuoteReadOnly(LCUI_Graph *self, const LCUI_Graph *source,
@@ -0,0 +1,207 @@
+/*
+ * graphpool.c -- The pool of reusable graph buffers.
+ *
+ * Copyright (c) 2018, Liu chao <lc-soft@live.cn> All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of LCUI nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/types.h>
+#include <LCUI/util.h>
+#include <LCUI/graph.h>
+
+/* buffers are grouped into power-of-two size classes, from 4KB to 128MB */
+#define MIN_CLASS_SHIFT 12
+#define MAX_CLASS_SHIFT 27
+#define CLASSES_COUNT (MAX_CLASS_SHIFT - MIN_CLASS_SHIFT + 1)
+
+/** A free buffer, the link is stored in the buffer itself */
+typedef struct GraphPoolBlockRec_ {
+	struct GraphPoolBlockRec_ *next;
+} GraphPoolBlockRec, *GraphPoolBlock;
+
+struct LCUI_GraphPoolRec_ {
+	/** LIFO stacks of free buffers, one per size class */
+	GraphPoolBlock classes[CLASSES_COUNT];
+
+	/** the maximum number of bytes of free buffers that can be cached */
+	size_t max_cached_bytes;
+
+	/** the maximum number of bytes in use since the last trim */
+	size_t high_water_bytes;
+
+	LCUI_GraphPoolStatsRec stats;
+};
+
+static int GraphPool_GetClass(size_t size, size_t *class_size)
+{
+	int i;
+
+	for (i = 0; i < CLASSES_COUNT; ++i) {
+		*class_size = (size_t)1 << (i + MIN_CLASS_SHIFT);
+		if (*class_size >= size) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+static void GraphPool_FreeClass(LCUI_GraphPool pool, int i, size_t limit)
+{
+	GraphPoolBlock block;
+
+	while (pool->classes[i] && pool->stats.cached_bytes > limit) {
+		block = pool->classes[i];
+		pool->classes[i] = block->next;
+		pool->stats.cached_bytes -= (size_t)1 << (i + MIN_CLASS_SHIFT);
+		free(block);
+	}
+}
+
+LCUI_GraphPool GraphPool_Create(size_t max_cached_bytes)
+{
+	LCUI_GraphPool pool;
+
+	pool = calloc(1, sizeof(struct LCUI_GraphPoolRec_));
+	if (!pool) {
+		return NULL;
+	}
+	pool->max_cached_bytes = max_cached_bytes;
+	return pool;
+}
+
+void GraphPool_Destroy(LCUI_GraphPool pool)
+{
+	int i;
+
+	for (i = 0; i < CLASSES_COUNT; ++i) {
+		GraphPool_FreeClass(pool, i, 0);
+	}
+	free(pool);
+}
+
+int GraphPool_Alloc(LCUI_GraphPool pool, LCUI_Graph *graph, unsigned width,
+		    unsigned height)
+{
+	int i;
+	size_t size, class_size;
+	GraphPoolBlock block;
+
+	if (!pool) {
+		return Graph_Create(graph, width, height);
+	}
+	GraphPool_Release(pool, graph);
+	if (width < 1 || height < 1 || width > 10000 || height > 10000) {
+		return Graph_Create(graph, width, height);
+	}
+	if (graph->color_type == LCUI_COLOR_TYPE_RGB888) {
+		graph->bytes_per_pixel = 3;
+	} else {
+		graph->bytes_per_pixel = 4;
+	}
+	graph->bytes_per_row = graph->bytes_per_pixel * width;
+	size = graph->bytes_per_row * height;
+	i = GraphPool_GetClass(size, &class_size);
+	if (i < 0) {
+		return Graph_Create(graph, width, height);
+	}
+	block = pool->classes[i];
+	if (block) {
+		pool->classes[i] = block->next;
+		pool->stats.cached_bytes -= class_size;
+		pool->stats.hits += 1;
+		memset(block, 0, size);
+		graph->bytes = (uchar_t *)block;
+	} else {
+		pool->stats.misses += 1;
+		graph->bytes = calloc(1, class_size);
+		if (!graph->bytes) {
+			graph->width = 0;
+			graph->height = 0;
+			return -2;
+		}
+	}
+	graph->mem_size = class_size;
+	graph->width = width;
+	graph->height = height;
+	graph->pool = pool;
+	pool->stats.used_bytes += class_size;
+	if (pool->stats.used_bytes > pool->high_water_bytes) {
+		pool->high_water_bytes = pool->stats.used_bytes;
+	}
+	return 0;
+}
+
+void GraphPool_Release(LCUI_GraphPool pool, LCUI_Graph *graph)
+{
+	int i;
+	size_t class_size;
+	GraphPoolBlock block;
+
+	/* buffers allocated by Graph_Create() or other pools are not counted
+	 * in the used bytes of this pool */
+	if (!pool || graph->quote.is_valid || !graph->bytes ||
+	    graph->pool != pool) {
+		Graph_Free(graph);
+		return;
+	}
+	i = GraphPool_GetClass(graph->mem_size, &class_size);
+	pool->stats.used_bytes -= class_size;
+	if (pool->stats.cached_bytes + class_size > pool->max_cached_bytes) {
+		Graph_Free(graph);
+		return;
+	}
+	block = (GraphPoolBlock)graph->bytes;
+	block->next = pool->classes[i];
+	pool->classes[i] = block;
+	pool->stats.cached_bytes += class_size;
+	graph->bytes = NULL;
+	graph->width = 0;
+	graph->height = 0;
+	graph->mem_size = 0;
+	graph->pool = NULL;
+}
+
+void GraphPool_Trim(LCUI_GraphPool pool)
+{
+	int i;
+	size_t limit;
+
+	/* Keep only as many free buffers as were needed at the peak since the
+	 * last trim, release the larger ones first */
+	limit = pool->high_water_bytes - pool->stats.used_bytes;
+	for (i = CLASSES_COUNT - 1; i >= 0; --i) {
+		GraphPool_FreeClass(pool, i, limit);
+	}
+	pool->high_water_bytes = pool->stats.used_bytes;
+}
+
+void GraphPool_GetStats(LCUI_GraphPool pool, LCUI_GraphPoolStats stats)
+{
+	*stats = pool->stats;
+}
@@ -103,6 +103,7 @@ static struct {
 	LCUI_Mutex mutex;		/**< 互斥锁 */
 	LinkedList groups;		/**< 样式组列表 */
 	Dict *cache;			/**< 样式表缓存，以选择器的 hash 值索引 */
+	Dict *cache_deps;		/**< 样式表缓存的依赖表，以选择器结点名称索引 */
 	Dict *names;			/**< 样式属性名称表，以值的名称索引 */
 	Dict *value_keys;		/**< 样式属性值表，以值的名称索引 */
 	Dict *value_names;		/**< 样式属性值名称表，以值索引 */
@@ -112,6 +113,9 @@ static struct {
 	DictType style_link_dict;	/**< 样式链接表的类型 */
 	DictType style_group_dict;	/**< 样式组的类型 */
 	DictType cache_dict;		/**< 样式表缓存的类型 */
+	DictType cache_deps_dict;	/**< 样式表缓存的依赖表的类型 */
+	DictType cache_set_dict;	/**< 样式表缓存的 hash 值集合的类型 */
+	LCUI_StyleCacheStatsRec stats;	/**< 样式表缓存的统计数据 */
 	strpool_t *strpool;		/**< 字符串池 */
 	int count;			/**< 当前记录的属性数量 */
 } library;
@@ -1300,12 +1304,63 @@ static LCUI_StyleList LCUI_SelectStyleList(LCUI_Selector selector,
 	return snode->list;
 }
 
+/**
+ * 使受新样式规则影响的样式表缓存失效
+ * 样式表只会在最右侧的选择器结点名称相同的样式组中查找，因此只需要删除
+ * 依赖该名称的缓存
+ */
+static void LCUI_InvalidateCachedStyleSheets(LCUI_Selector selector)
+{
+	Dict *set;
+	DictEntry *entry;
+	DictIterator *iter;
+	const char *name;
+
+	if (selector->length < 1) {
+		return;
+	}
+	name = selector->nodes[selector->length - 1]->fullname;
+	set = Dict_FetchValue(library.cache_deps, name);
+	if (!set) {
+		return;
+	}
+	iter = Dict_GetIterator(set);
+	while ((entry = Dict_Next(iter))) {
+		if (Dict_Delete(library.cache, DictEntry_GetKey(entry)) == 0) {
+			library.stats.invalidations += 1;
+		}
+	}
+	Dict_ReleaseIterator(iter);
+	Dict_Delete(library.cache_deps, name);
+}
+
+/** 记录样式表缓存依赖的样式组名称 */
+static void LCUI_AddCachedStyleSheetDeps(LCUI_Selector s)
+{
+	Dict *set;
+	LinkedList names;
+	LinkedListNode *node;
+
+	LinkedList_Init(&names);
+	SelectorNode_GetNames(s->nodes[s->length - 1], &names);
+	LinkedList_Append(&names, strdup2("*"));
+	for (LinkedList_Each(node, &names)) {
+		set = Dict_FetchValue(library.cache_deps, node->data);
+		if (!set) {
+			set = Dict_Create(&library.cache_set_dict, NULL);
+			Dict_Add(library.cache_deps, node->data, set);
+		}
+		Dict_Add(set, &s->hash, NULL);
+	}
+	LinkedList_Clear(&names, free);
+}
+
 int LCUI_PutStyleSheet(LCUI_Selector selector, LCUI_StyleSheet in_ss,
 		       const char *space)
 {
 	LCUI_StyleList list;
 	LCUIMutex_Lock(&library.mutex);
-	Dict_Empty(library.cache);
+	LCUI_InvalidateCachedStyleSheets(selector);
 	list = LCUI_SelectStyleList(selector, space);
 	if (list) {
 		StyleList_Merge(list, in_ss);
@@ -1591,8 +1646,10 @@ LCUI_CachedStyleSheet LCUI_GetCachedStyleSheet(LCUI_Selector s)
 	LinkedList_Init(&list);
 	ss = Dict_FetchValue(library.cache, &s->hash);
 	if (ss) {
+		library.stats.hits += 1;
 		return ss;
 	}
+	library.stats.misses += 1;
 	ss = StyleSheet();
 	LCUI_FindStyleSheet(s, &list);
 	for (LinkedList_Each(node, &list)) {
@@ -1601,9 +1658,28 @@ LCUI_CachedStyleSheet LCUI_GetCachedStyleSheet(LCUI_Selector s)
 	}
 	LinkedList_Clear(&list, NULL);
 	Dict_Add(library.cache, &s->hash, ss);
+	if (s->length > 0) {
+		LCUI_AddCachedStyleSheetDeps(s);
+	}
+	return ss;
+}
+
+LCUI_CachedStyleSheet LCUI_FindCachedStyleSheet(unsigned hash)
+{
+	LCUI_CachedStyleSheet ss;
+
+	ss = Dict_FetchValue(library.cache, &hash);
+	if (ss) {
+		library.stats.hits += 1;
+	}
 	return ss;
 }
 
+void LCUI_GetStyleCacheStats(LCUI_StyleCacheStats stats)
+{
+	*stats = library.stats;
+}
+
 void LCUI_GetStyleSheet(LCUI_Selector s, LCUI_StyleSheet out_ss)
 {
 	const LCUI_StyleSheetRec *ss;
@@ -1643,6 +1719,11 @@ static void StyleSheetCacheDestructor(void *privdata, void *val)
 	StyleSheet_Delete(val);
 }
 
+static void StyleSheetCacheDepsDestructor(void *privdata, void *val)
+{
+	Dict_Release(val);
+}
+
 static void *DupStyleName(void *privdata, const void *val)
 {
 	return strdup2(val);
@@ -1688,11 +1769,27 @@ static void InitStylesheetCache(void)
 	dt->valDestructor = StyleSheetCacheDestructor;
 	dt->keyDestructor = IntKeyDict_KeyDestructor;
 	library.cache = Dict_Create(dt, NULL);
+
+	dt = &library.cache_set_dict;
+	dt->valDup = NULL;
+	dt->keyDup = IntKeyDict_KeyDup;
+	dt->keyCompare = IntKeyDict_KeyCompare;
+	dt->hashFunction = IntKeyDict_HashFunction;
+	dt->keyDestructor = IntKeyDict_KeyDestructor;
+	dt->valDestructor = NULL;
+
+	dt = &library.cache_deps_dict;
+	Dict_InitStringCopyKeyType(dt);
+	dt->valDestructor = StyleSheetCacheDepsDestructor;
+	library.cache_deps = Dict_Create(dt, NULL);
+	memset(&library.stats, 0, sizeof(library.stats));
 }
 
 static void DestroyStylesheetCache(void)
 {
+	Dict_Release(library.cache_deps);
 	Dict_Release(library.cache);
+	library.cache_deps = NULL;
 	library.cache = NULL;
 }
 
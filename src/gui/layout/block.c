@@ -128,14 +128,11 @@ static void BlockLayout_NextRow(LCUI_BlockLayoutContext ctx)
 	LinkedList_Append(&ctx->rows, ctx->row);
 }
 
-static LCUI_BlockLayoutContext BlockLayout_Begin(LCUI_Widget w,
-						 LCUI_LayoutRule rule)
+LCUI_LayoutRule LCUIBlockLayout_GetRule(LCUI_Widget w, LCUI_LayoutRule rule)
 {
 	LCUI_WidgetStyle *style = &w->computed_style;
-	ASSIGN(ctx, LCUI_BlockLayoutContext);
 
 	if (rule == LCUI_LAYOUT_RULE_AUTO) {
-		ctx->is_initiative = TRUE;
 		if (style->width_sizing == LCUI_SIZING_RULE_FIXED) {
 			if (style->height_sizing == LCUI_SIZING_RULE_FIXED) {
 				rule = LCUI_LAYOUT_RULE_FIXED;
@@ -147,8 +144,6 @@ static LCUI_BlockLayoutContext BlockLayout_Begin(LCUI_Widget w,
 		} else {
 			rule = LCUI_LAYOUT_RULE_MAX_CONTENT;
 		}
-	} else {
-		ctx->is_initiative = FALSE;
 	}
 	if (style->position == SV_ABSOLUTE) {
 		if (rule == LCUI_LAYOUT_RULE_FIXED_HEIGHT &&
@@ -173,7 +168,16 @@ static LCUI_BlockLayoutContext BlockLayout_Begin(LCUI_Widget w,
 			rule = LCUI_LAYOUT_RULE_FIXED;
 		}
 	}
-	ctx->rule = rule;
+	return rule;
+}
+
+static LCUI_BlockLayoutContext BlockLayout_Begin(LCUI_Widget w,
+						 LCUI_LayoutRule rule)
+{
+	ASSIGN(ctx, LCUI_BlockLayoutContext);
+
+	ctx->is_initiative = rule == LCUI_LAYOUT_RULE_AUTO;
+	ctx->rule = LCUIBlockLayout_GetRule(w, rule);
 	ctx->row = NULL;
 	ctx->widget = w;
 	ctx->x = w->padding.left;
@@ -31,6 +31,8 @@
 #ifndef LCUI_BLOCK_LAYOUT_H
 #define LCUI_BLOCK_LAYOUT_H
 
+LCUI_LayoutRule LCUIBlockLayout_GetRule(LCUI_Widget w, LCUI_LayoutRule rule);
+
 void LCUIBlockLayout_Reflow(LCUI_Widget w, LCUI_LayoutRule rule);
 
 #endif
@@ -119,14 +119,11 @@ static void FlexBoxLayout_NextLine(LCUI_FlexBoxLayoutContext ctx)
 	LinkedList_Append(&ctx->lines, ctx->line);
 }
 
-static LCUI_FlexBoxLayoutContext FlexBoxLayout_Begin(LCUI_Widget w,
-						     LCUI_LayoutRule rule)
+LCUI_LayoutRule LCUIFlexBoxLayout_GetRule(LCUI_Widget w, LCUI_LayoutRule rule)
 {
 	LCUI_WidgetStyle *style = &w->computed_style;
-	ASSIGN(ctx, LCUI_FlexBoxLayoutContext);
 
 	if (rule == LCUI_LAYOUT_RULE_AUTO) {
-		ctx->is_initiative = TRUE;
 		if (style->flex.direction == SV_COLUMN) {
 			if (style->height_sizing == LCUI_SIZING_RULE_FIXED) {
 				rule = LCUI_LAYOUT_RULE_FIXED_HEIGHT;
@@ -140,8 +137,6 @@ static LCUI_FlexBoxLayoutContext FlexBoxLayout_Begin(LCUI_Widget w,
 				rule = LCUI_LAYOUT_RULE_MAX_CONTENT;
 			}
 		}
-	} else {
-		ctx->is_initiative = FALSE;
 	}
 	if (style->position == SV_ABSOLUTE) {
 		if (rule == LCUI_LAYOUT_RULE_FIXED_HEIGHT &&
@@ -161,9 +156,19 @@ static LCUI_FlexBoxLayoutContext FlexBoxLayout_Begin(LCUI_Widget w,
 			rule = LCUI_LAYOUT_RULE_FIXED;
 		}
 	}
-	DEBUG_MSG("%s, rule: %d, is_initiative: %d\n", w->id, rule,
+	return rule;
+}
+
+static LCUI_FlexBoxLayoutContext FlexBoxLayout_Begin(LCUI_Widget w,
+						     LCUI_LayoutRule rule)
+{
+	LCUI_WidgetStyle *style = &w->computed_style;
+	ASSIGN(ctx, LCUI_FlexBoxLayoutContext);
+
+	ctx->is_initiative = rule == LCUI_LAYOUT_RULE_AUTO;
+	ctx->rule = LCUIFlexBoxLayout_GetRule(w, rule);
+	DEBUG_MSG("%s, rule: %d, is_initiative: %d\n", w->id, ctx->rule,
 		  ctx->is_initiative);
-	ctx->rule = rule;
 	ctx->line = NULL;
 	ctx->widget = w;
 	if (style->flex.direction == SV_COLUMN) {
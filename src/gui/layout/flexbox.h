@@ -31,6 +31,8 @@
 #ifndef LCUI_FLEXBOX_LAYOUT_H
 #define LCUI_FLEXBOX_LAYOUT_H
 
+LCUI_LayoutRule LCUIFlexBoxLayout_GetRule(LCUI_Widget w, LCUI_LayoutRule rule);
+
 void LCUIFlexBoxLayout_Reflow(LCUI_Widget w, LCUI_LayoutRule rule);
 
 #endif
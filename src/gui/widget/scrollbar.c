@@ -35,21 +35,16 @@
 #include <LCUI/LCUI.h>
 #include <LCUI/font.h>
 #include <LCUI/cursor.h>
-#include <LCUI/timer.h>
 #include <LCUI/gui/widget.h>
 #include <LCUI/gui/widget/scrollbar.h>
 #include <LCUI/gui/css_parser.h>
 
 /* clang-format off */
 
-#define EFFECT_FRAMES 80
-
-/** 惯性滚动效果的相关数据 */
+/** 惯性滚动效果的相关数据，效果在每一帧的部件更新中推进 */
 typedef struct InertialScrollingRec_ {
 	int start_pos;			/**< 开始移动时的位置 */
 	int end_pos;			/**< 结束移动时的位置 */
-	int timer;			/**< 定时器 */
-	int interval;			/**< 定时器的间隔时间 */
 	double speed;			/**< 滚动速度 */
 	double speed_delta;		/**< 速度差（加速度） */
 	int64_t timestamp;		/**< 开始时间 */
@@ -130,13 +125,13 @@ scrollbar {
 
 /* clang-format on */
 
-static void OnInertialScrolling(void *arg)
+/** 根据当前帧的时间计算惯性滚动的位置 */
+static void OnInertialScrolling(LCUI_Widget w)
 {
 	int pos;
 	double distance, time;
 	LCUI_ScrollBar scrollbar;
 	InertialScrolling effect;
-	LCUI_Widget w = arg;
 
 	scrollbar = Widget_GetData(w, self.prototype);
 	effect = &scrollbar->effect;
@@ -153,23 +148,21 @@ static void OnInertialScrolling(void *arg)
 			break;
 		}
 		ScrollBar_SetPosition(w, pos);
+		/* continue in the next frame */
+		Widget_AddTask(w, LCUI_WTASK_USER);
 		return;
 	}
-	LCUITimer_Free(effect->timer);
 	effect->is_running = FALSE;
-	effect->timer = -1;
 }
 
 static void InitInertialScrolling(InertialScrolling effect)
 {
-	effect->timer = -1;
 	effect->end_pos = 0;
 	effect->start_pos = 0;
 	effect->timestamp = 0;
 	effect->speed = 0;
 	effect->speed_delta = 320;
 	effect->is_running = FALSE;
-	effect->interval = 1000 / EFFECT_FRAMES;
 }
 
 static void UpdateInertialScrolling(InertialScrolling effect, int pos)
@@ -206,11 +199,7 @@ static void StartInertialScrolling(LCUI_Widget w)
 		return;
 	}
 	effect->is_running = TRUE;
-	if (effect->timer > 0) {
-		LCUITimer_Free(effect->timer);
-	}
-	effect->timer =
-	    LCUITimer_Set(effect->interval, OnInertialScrolling, w, TRUE);
+	Widget_AddTask(w, LCUI_WTASK_USER);
 	DEBUG_MSG("start_pos: %d, end_pos: %d\n", effect->start_pos,
 		  effect->end_pos);
 	DEBUG_MSG("effect->speed: %g, distance: %d, time: %d\n", effect->speed,
@@ -254,7 +243,7 @@ static void Slider_OnMouseMove(LCUI_Widget slider, LCUI_WidgetEvent e,
 			}
 		}
 		layer_pos = layer_pos * n;
-		Widget_SetStyle(target, key_left, -layer_pos, px);
+		Widget_SetScroll(target, layer_pos, target->scroll.y);
 	} else {
 		x = 0;
 		y = scrollbar->slider_y;
@@ -279,7 +268,7 @@ static void Slider_OnMouseMove(LCUI_Widget slider, LCUI_WidgetEvent e,
 			}
 		}
 		layer_pos = layer_pos * n;
-		Widget_SetStyle(target, key_top, -layer_pos, px);
+		Widget_SetScroll(target, target->scroll.x, layer_pos);
 	}
 	if (scrollbar->pos != iround(layer_pos)) {
 		LCUI_WidgetEventRec e = { 0 };
@@ -288,7 +277,6 @@ static void Slider_OnMouseMove(LCUI_Widget slider, LCUI_WidgetEvent e,
 		Widget_TriggerEvent(target, &e, &layer_pos);
 	}
 	scrollbar->pos = iround(layer_pos);
-	Widget_UpdateStyle(target, FALSE);
 	Widget_Move(slider, x, y);
 }
 
@@ -632,7 +620,7 @@ int ScrollBar_SetPosition(LCUI_Widget w, int pos)
 		slider_pos = w->box.content.width - slider->width;
 		slider_pos = slider_pos * new_pos / (size - box_size);
 		Widget_SetStyle(slider, key_left, slider_pos, px);
-		Widget_SetStyle(target, key_left, -new_pos, px);
+		Widget_SetScroll(target, new_pos, target->scroll.y);
 	} else {
 		size = scrollbar->target->box.outer.height;
 		if (scrollbar->box) {
@@ -653,7 +641,7 @@ int ScrollBar_SetPosition(LCUI_Widget w, int pos)
 			slider_pos = slider_pos * new_pos / (size - box_size);
 		}
 		Widget_SetStyle(slider, key_top, slider_pos, px);
-		Widget_SetStyle(target, key_top, -new_pos, px);
+		Widget_SetScroll(target, target->scroll.x, new_pos);
 	}
 	pos = iround(new_pos);
 	if (scrollbar->pos != pos) {
@@ -664,7 +652,6 @@ int ScrollBar_SetPosition(LCUI_Widget w, int pos)
 	}
 	scrollbar->pos = pos;
 	Widget_UpdateStyle(slider, FALSE);
-	Widget_UpdateStyle(target, FALSE);
 	return pos;
 }
 
@@ -680,6 +667,15 @@ void ScrollBar_SetDirection(LCUI_Widget w, int direction)
 	scrollbar->direction = direction;
 }
 
+static void ScrollBar_OnTask(LCUI_Widget w, int task)
+{
+	LCUI_ScrollBar scrollbar = Widget_GetData(w, self.prototype);
+
+	if (task == LCUI_WTASK_USER && scrollbar->effect.is_running) {
+		OnInertialScrolling(w);
+	}
+}
+
 static void ScrollBar_OnSetAttr(LCUI_Widget w, const char *name,
 				const char *value)
 {
@@ -705,6 +701,7 @@ void LCUIWidget_AddTScrollBar(void)
 	self.prototype = LCUIWidget_NewPrototype("scrollbar", NULL);
 	self.prototype->init = ScrollBar_OnInit;
 	self.prototype->setattr = ScrollBar_OnSetAttr;
+	self.prototype->runtask = ScrollBar_OnTask;
 	self.event_id = LCUIWidget_AllocEventId();
 	setscroll_event_id = LCUIWidget_AllocEventId();
 	LCUIWidget_SetEventName(self.event_id, "scroll");
@@ -36,16 +36,29 @@
 #include <LCUI/image.h>
 #include <LCUI/gui/metrics.h>
 #include <LCUI/gui/widget.h>
+#include <LCUI/thread.h>
 #include "widget_background.h"
 
 #define ComputeActual LCUIMetrics_ComputeActual
+#define BACKGROUND_CACHE_SIZE (32 * 1024 * 1024)
 
 typedef struct ImageCacheRec_ {
 	char *path;
 	LCUI_Graph image;
 	LinkedList refs;
+	LinkedList scaled_images; /**< 缩放后的图像 */
 } ImageCacheRec, *ImageCache;
 
+/** 缩放后的背景图 */
+typedef struct ScaledImageRec_ {
+	LCUI_Graph image;
+	size_t size;             /**< 图像占用的字节数 */
+	unsigned refs;           /**< 正在使用它进行绘制的线程数量 */
+	ImageCache owner;        /**< 原图像，为 NULL 时表示已被移出缓存 */
+	LinkedListNode node;     /**< 在原图像的缩放图列表中的结点 */
+	LinkedListNode lru_node; /**< 在最近使用列表中的结点 */
+} ScaledImageRec, *ScaledImage;
+
 typedef struct ImageRefRec_ {
 	LCUI_Widget widget;
 	ImageCache cache;
@@ -56,11 +69,131 @@ static struct LCUI_WidgetBackgroundModule {
 	DictType dtype;
 	Dict *images;
 	RBTree refs;
+
+	/**
+	 * 互斥锁
+	 * 图像加载任务和渲染线程都会访问图像缓存，需要加锁保护
+	 */
+	LCUI_Mutex mutex;
+
+	/** 缩放后的背景图，按最近使用的时间排序，最久未使用的在前面 */
+	LinkedList scaled_images;
+	size_t scaled_size;
+	size_t max_scaled_size;
+	LCUI_BackgroundCacheStatsRec stats;
 } self;
 
+static void ScaledImage_Destroy(ScaledImage scaled)
+{
+	Graph_Free(&scaled->image);
+	free(scaled);
+}
+
+/** 将缩放后的图像移出缓存，正在使用的图像会在使用完后销毁 */
+static void ScaledImage_Remove(ScaledImage scaled)
+{
+	LinkedList_Unlink(&scaled->owner->scaled_images, &scaled->node);
+	LinkedList_Unlink(&self.scaled_images, &scaled->lru_node);
+	self.scaled_size -= scaled->size;
+	scaled->owner = NULL;
+	if (scaled->refs < 1) {
+		ScaledImage_Destroy(scaled);
+	}
+}
+
+static void ScaledImage_Release(ScaledImage scaled)
+{
+	LCUIMutex_Lock(&self.mutex);
+	scaled->refs -= 1;
+	if (scaled->refs < 1 && !scaled->owner) {
+		ScaledImage_Destroy(scaled);
+	}
+	LCUIMutex_Unlock(&self.mutex);
+}
+
+/** 淘汰最久未使用的缩放图，直到缓存的总大小不超过预算 */
+static void TrimScaledImages(size_t max_size)
+{
+	ScaledImage scaled;
+	LinkedListNode *node, *next;
+
+	node = self.scaled_images.head.next;
+	while (node && self.scaled_size > max_size) {
+		next = node->next;
+		scaled = node->data;
+		if (scaled->refs < 1) {
+			ScaledImage_Remove(scaled);
+			self.stats.evictions += 1;
+		}
+		node = next;
+	}
+}
+
+/**
+ * 获取缩放到指定尺寸的图像
+ * 返回的图像在使用完后需要调用 ScaledImage_Release() 释放
+ * @returns 如果图像大小超出了缓存预算，则返回 NULL
+ */
+static ScaledImage ImageCache_GetScaledImage(ImageCache cache, int width,
+					     int height)
+{
+	size_t size;
+	LinkedListNode *node;
+	ScaledImage scaled = NULL;
+
+	size = (size_t)width * height * cache->image.bytes_per_pixel;
+	LCUIMutex_Lock(&self.mutex);
+	for (LinkedList_Each(node, &cache->scaled_images)) {
+		scaled = node->data;
+		if (scaled->image.width == width &&
+		    scaled->image.height == height) {
+			break;
+		}
+		scaled = NULL;
+	}
+	if (scaled) {
+		LinkedList_Unlink(&self.scaled_images, &scaled->lru_node);
+		LinkedList_AppendNode(&self.scaled_images, &scaled->lru_node);
+		scaled->refs += 1;
+		self.stats.hits += 1;
+		LCUIMutex_Unlock(&self.mutex);
+		return scaled;
+	}
+	if (size > self.max_scaled_size) {
+		LCUIMutex_Unlock(&self.mutex);
+		return NULL;
+	}
+	scaled = NEW(ScaledImageRec, 1);
+	Graph_Init(&scaled->image);
+	if (Graph_Zoom(&cache->image, &scaled->image, FALSE, width,
+		       height) != 0) {
+		LCUIMutex_Unlock(&self.mutex);
+		ScaledImage_Destroy(scaled);
+		return NULL;
+	}
+	TrimScaledImages(self.max_scaled_size - size);
+	scaled->size = size;
+	scaled->refs = 1;
+	scaled->owner = cache;
+	scaled->node.data = scaled;
+	scaled->lru_node.data = scaled;
+	LinkedList_AppendNode(&cache->scaled_images, &scaled->node);
+	LinkedList_AppendNode(&self.scaled_images, &scaled->lru_node);
+	self.scaled_size += size;
+	self.stats.misses += 1;
+	LCUIMutex_Unlock(&self.mutex);
+	return scaled;
+}
+
 static void DestroyImageCache(ImageCache cache)
 {
 	LinkedListNode *node;
+
+	LCUIMutex_Lock(&self.mutex);
+	while ((node = LinkedList_GetNode(&cache->scaled_images, 0))) {
+		ScaledImage_Remove(node->data);
+	}
+	LCUIMutex_Unlock(&self.mutex);
 	while ((node = LinkedList_GetNode(&cache->refs, 0))) {
 		LCUI_Widget w = node->data;
 		RBTree_CustomErase(&self.refs, node->data);
@@ -98,8 +231,11 @@ static void DeleteImageRef(LCUI_Widget widget)
 	ImageRef ref;
 	ImageCache cache;
 	LinkedListNode *node;
+
+	LCUIMutex_Lock(&self.mutex);
 	ref = GetImageRef(widget);
 	if (!ref) {
+		LCUIMutex_Unlock(&self.mutex);
 		return;
 	}
 	cache = ref->cache;
@@ -118,6 +254,7 @@ static void DeleteImageRef(LCUI_Widget widget)
 	if (cache->refs.length < 1) {
 		Dict_Delete(self.images, cache->path);
 	}
+	LCUIMutex_Unlock(&self.mutex);
 }
 
 static void ExecLoadImage(void *arg1, void *arg2)
@@ -135,11 +272,14 @@ static void ExecLoadImage(void *arg1, void *arg2)
 	cache->image = image;
 	cache->path = strdup2(path);
 	LinkedList_Init(&cache->refs);
-	if (Dict_Add(self.images, cache->path, cache) == 0) {
-		AddImageRef(w, cache);
-	} else {
+	LinkedList_Init(&cache->scaled_images);
+	LCUIMutex_Lock(&self.mutex);
+	if (Dict_Add(self.images, cache->path, cache) != 0) {
 		DestroyImageCache(cache);
+		cache = Dict_FetchValue(self.images, path);
 	}
+	AddImageRef(w, cache);
+	LCUIMutex_Unlock(&self.mutex);
 	Graph_Quote(&w->computed_style.background.image, &cache->image, NULL);
 	Widget_InvalidateArea(w, NULL, SV_BORDER_BOX);
 }
@@ -175,14 +315,17 @@ static void AsyncLoadImage(LCUI_Widget widget, const char *path)
 			DeleteImageRef(widget);
 		}
 	}
+	LCUIMutex_Lock(&self.mutex);
 	cache = Dict_FetchValue(self.images, path);
 	if (cache) {
 		AddImageRef(widget, cache);
+		LCUIMutex_Unlock(&self.mutex);
 		Graph_Quote(&widget->computed_style.background.image,
 			    &cache->image, NULL);
 		Widget_InvalidateArea(widget, NULL, SV_BORDER_BOX);
 		return;
 	}
+	LCUIMutex_Unlock(&self.mutex);
 	task.func = ExecLoadImage;
 	task.arg[0] = widget;
 	task.arg[1] = strdup2(path);
@@ -198,6 +341,13 @@ void LCUIWidget_InitImageLoader(void)
 	self.images = Dict_Create(&self.dtype, NULL);
 	RBTree_OnCompare(&self.refs, OnCompareWidget);
 	RBTree_OnDestroy(&self.refs, free);
+	LCUIMutex_Init(&self.mutex);
+	LinkedList_Init(&self.scaled_images);
+	self.scaled_size = 0;
+	if (self.max_scaled_size == 0) {
+		self.max_scaled_size = BACKGROUND_CACHE_SIZE;
+	}
+	memset(&self.stats, 0, sizeof(self.stats));
 	self.active = TRUE;
 }
 
@@ -205,10 +355,36 @@ void LCUIWidget_FreeImageLoader(void)
 {
 	Dict_Release(self.images);
 	RBTree_Destroy(&self.refs);
+	LCUIMutex_Destroy(&self.mutex);
 	self.images = NULL;
 	self.active = FALSE;
 }
 
+void LCUIWidget_SetBackgroundCacheSize(size_t max_bytes)
+{
+	if (!self.active) {
+		self.max_scaled_size = max_bytes;
+		return;
+	}
+	LCUIMutex_Lock(&self.mutex);
+	self.max_scaled_size = max_bytes;
+	TrimScaledImages(max_bytes);
+	LCUIMutex_Unlock(&self.mutex);
+}
+
+void LCUIWidget_GetBackgroundStats(LCUI_BackgroundCacheStats stats)
+{
+	if (!self.active) {
+		memset(stats, 0, sizeof(LCUI_BackgroundCacheStatsRec));
+		return;
+	}
+	LCUIMutex_Lock(&self.mutex);
+	*stats = self.stats;
+	stats->images = self.scaled_images.length;
+	stats->bytes = self.scaled_size;
+	LCUIMutex_Unlock(&self.mutex);
+}
+
 void Widget_InitBackground(LCUI_Widget w)
 {
 	LCUI_BackgroundStyle *bg;
@@ -473,9 +649,35 @@ void Widget_PaintBakcground(LCUI_Widget w, LCUI_PaintContext paint,
 			    LCUI_WidgetActualStyle style)
 {
 	LCUI_Rect box;
+	ImageRef ref;
+	ScaledImage scaled = NULL;
+	LCUI_Background bg = style->background;
+
 	box.x = style->padding_box.x - style->canvas_box.x;
 	box.y = style->padding_box.y - style->canvas_box.y;
 	box.width = style->padding_box.width;
 	box.height = style->padding_box.height;
-	Background_Paint(&style->background, &box, paint);
+	/*
+	 * 如果背景图需要缩放，则改用缓存中已缩放好的图像，这样绘制时只需要
+	 * 复制绘制区域内的像素，不用在每次绘制时都缩放一次图像
+	 */
+	if (Graph_IsValid(bg.image) && bg.size.width > 0 &&
+	    bg.size.height > 0 && (bg.size.width != bg.image->width ||
+				   bg.size.height != bg.image->height)) {
+		LCUIMutex_Lock(&self.mutex);
+		ref = GetImageRef(w);
+		if (ref) {
+			scaled = ImageCache_GetScaledImage(ref->cache,
+							   bg.size.width,
+							   bg.size.height);
+		}
+		LCUIMutex_Unlock(&self.mutex);
+		if (scaled) {
+			bg.image = &scaled->image;
+		}
+	}
+	Background_Paint(&bg, &box, paint);
+	if (scaled) {
+		ScaledImage_Release(scaled);
+	}
 }
@@ -106,6 +106,7 @@ LCUI_Widget LCUIWidget_NewWithPrototype(LCUI_WidgetPrototypeC proto)
 	Widget_Init(widget);
 	widget->proto = proto;
 	widget->type = widget->proto->name;
+	Widget_UpdateSelectorHash(widget);
 	widget->proto->init(widget);
 	Widget_AddTask(widget, LCUI_WTASK_REFRESH_STYLE);
 	return widget;
@@ -122,6 +123,7 @@ LCUI_Widget LCUIWidget_New(const char *type)
 	} else if (type) {
 		widget->type = strdup2(type);
 	}
+	Widget_UpdateSelectorHash(widget);
 	widget->proto->init(widget);
 	Widget_AddTask(widget, LCUI_WTASK_REFRESH_STYLE);
 	return widget;
@@ -136,6 +138,7 @@ void Widget_ExecDestroy(LCUI_Widget w)
 	Widget_DestroyBackground(w);
 	Widget_DestroyEventTrigger(w);
 	Widget_DestroyChildren(w);
+	Widget_FreeRenderIndex(w);
 	Widget_ClearPrototype(w);
 	if (w->title) {
 		free(w->title);
@@ -165,6 +168,7 @@ void Widget_Destroy(LCUI_Widget w)
 		return;
 	}
 	if (w->parent) {
+		LCUI_RectF rect;
 		LCUI_Widget child;
 		LinkedListNode *node;
 
@@ -178,8 +182,10 @@ void Widget_Destroy(LCUI_Widget w)
 		if (w->computed_style.position != SV_ABSOLUTE) {
 			Widget_AddTask(w->parent, LCUI_WTASK_REFLOW);
 		}
-		Widget_InvalidateArea(w->parent, &w->box.canvas,
-				      SV_CONTENT_BOX);
+		rect = w->box.canvas;
+		rect.x -= w->parent->scroll.x;
+		rect.y -= w->parent->scroll.y;
+		Widget_InvalidateArea(w->parent, &rect, SV_CONTENT_BOX);
 		Widget_AddToTrash(w);
 	}
 }
@@ -209,6 +215,7 @@ void Widget_Empty(LCUI_Widget w)
 		child->state = LCUI_WSTATE_DELETED;
 		child->parent = NULL;
 	}
+	Widget_ClearChildrenIndex(w);
 	LinkedList_ClearData(&w->children_show, NULL);
 	LinkedList_Concat(&LCUIWidget.trash, &w->children);
 	Widget_InvalidateArea(w, NULL, SV_GRAPH_BOX);
@@ -224,8 +231,8 @@ void Widget_GetOffset(LCUI_Widget w, LCUI_Widget parent, float *offset_x,
 		y += w->box.border.y;
 		w = w->parent;
 		if (w) {
-			x += w->box.padding.x - w->box.border.x;
-			y += w->box.padding.y - w->box.border.y;
+			x += w->box.padding.x - w->box.border.x - w->scroll.x;
+			y += w->box.padding.y - w->box.border.y - w->scroll.y;
 		} else {
 			break;
 		}
@@ -304,8 +311,8 @@ LCUI_BOOL Widget_InVisibleArea(LCUI_Widget w)
 				return FALSE;
 			}
 		}
-		rect.x += parent->box.padding.x;
-		rect.y += parent->box.padding.y;
+		rect.x += parent->box.padding.x - parent->scroll.x;
+		rect.y += parent->box.padding.y - parent->scroll.y;
 		LCUIRectF_ValidateArea(&rect, parent->box.padding.width,
 				       parent->box.padding.height);
 		if (rect.width < 1 || rect.height < 1) {
@@ -321,7 +328,12 @@ int Widget_SetRules(LCUI_Widget w, const LCUI_WidgetRulesRec *rules)
 
 	data = (LCUI_WidgetRulesData)w->rules;
 	if (data) {
-		Dict_Release(data->style_cache);
+		Widget_DestroyChildrenIndex(w);
+		if (data->style_cache) {
+			Dict_Release(data->style_cache);
+		}
+		Graph_Free(&data->layer);
+		LCUIMutex_Destroy(&data->layer_mutex);
 		free(data);
 		w->rules = NULL;
 	}
@@ -336,7 +348,14 @@ int Widget_SetRules(LCUI_Widget w, const LCUI_WidgetRulesRec *rules)
 	data->progress = 0;
 	data->style_cache = NULL;
 	data->default_max_update_count = 2048;
+	data->layer_valid = FALSE;
+	Graph_Init(&data->layer);
+	LCUIMutex_Init(&data->layer_mutex);
+	data->children_index = NULL;
 	w->rules = (LCUI_WidgetRules)data;
+	if (rules->index_children) {
+		return Widget_CreateChildrenIndex(w);
+	}
 	return 0;
 }
 
@@ -468,6 +487,7 @@ void Widget_UpdateBoxPosition(LCUI_Widget w)
 {
 	float x = w->layout_x;
 	float y = w->layout_y;
+	LCUI_RectF old_box = w->box.border;
 
 	switch (w->computed_style.position) {
 	case SV_ABSOLUTE:
@@ -526,6 +546,7 @@ void Widget_UpdateBoxPosition(LCUI_Widget w)
 	w->box.content.y = w->box.padding.y + w->padding.top;
 	w->box.canvas.x = w->x - Widget_GetBoxShadowOffsetX(w);
 	w->box.canvas.y = w->y - Widget_GetBoxShadowOffsetY(w);
+	Widget_UpdateParentIndex(w, &old_box);
 }
 
 void Widget_UpdateCanvasBox(LCUI_Widget w)
@@ -538,6 +559,8 @@ void Widget_UpdateCanvasBox(LCUI_Widget w)
 
 void Widget_UpdateBoxSize(LCUI_Widget w)
 {
+	LCUI_RectF old_box = w->box.border;
+
 	w->width = Widget_GetLimitedWidth(w, w->width);
 	w->height = Widget_GetLimitedHeight(w, w->height);
 	if (w->invalid_area_type == LCUI_INVALID_AREA_TYPE_NONE &&
@@ -562,6 +585,7 @@ void Widget_UpdateBoxSize(LCUI_Widget w)
 	w->box.outer.height = w->box.border.height + MarginY(w);
 	w->box.canvas.width = Widget_GetCanvasWidth(w);
 	w->box.canvas.height = Widget_GetCanvasHeight(w);
+	Widget_UpdateParentIndex(w, &old_box);
 }
 
 void LCUIWidget_InitBase(void)
@@ -34,6 +34,7 @@
 #include <LCUI/gui/widget_class.h>
 #include <LCUI/gui/widget_style.h>
 #include <LCUI/gui/widget_task.h>
+#include <LCUI/gui/widget_hash.h>
 
 static void Widget_MarkChildrenRefreshByClasses(LCUI_Widget w)
 {
@@ -74,6 +75,7 @@ int Widget_AddClass(LCUI_Widget w, const char *class_name)
 	if (strlist_add(&w->classes, class_name) <= 0) {
 		return 0;
 	}
+	Widget_UpdateSelectorHash(w);
 	return Widget_HandleClassesChange(w, class_name);
 }
 
@@ -90,6 +92,7 @@ int Widget_RemoveClass(LCUI_Widget w, const char *class_name)
 	if (strlist_has(w->classes, class_name)) {
 		Widget_HandleClassesChange(w, class_name);
 		strlist_remove(&w->classes, class_name);
+		Widget_UpdateSelectorHash(w);
 		return 1;
 	}
 	return 0;
@@ -101,4 +104,5 @@ void Widget_DestroyClasses(LCUI_Widget w)
 		strlist_free(w->classes);
 	}
 	w->classes = NULL;
+	Widget_UpdateSelectorHash(w);
 }
@@ -82,10 +82,21 @@ void Widget_BeginStyleDiff(LCUI_Widget w, LCUI_WidgetStyleDiff diff)
 	diff->flex = style->flex;
 }
 
+/**
+ * 宽高都固定的部件是重排的边界，它的内容变化不会影响自身尺寸，
+ * 也就不需要让父级部件重新计算弹性布局
+ */
+INLINE LCUI_BOOL Widget_IsLayoutBoundary(LCUI_Widget w)
+{
+	return w->computed_style.width_sizing == LCUI_SIZING_RULE_FIXED &&
+	       w->computed_style.height_sizing == LCUI_SIZING_RULE_FIXED;
+}
+
 INLINE void Widget_AddReflowTask(LCUI_Widget w)
 {
 	if (w) {
-		if (w->parent && Widget_IsFlexLayoutStyleWorks(w)) {
+		if (w->parent && Widget_IsFlexLayoutStyleWorks(w) &&
+		    !Widget_IsLayoutBoundary(w)) {
 			Widget_AddTask(w->parent, LCUI_WTASK_REFLOW);
 		}
 		Widget_AddTask(w, LCUI_WTASK_REFLOW);
@@ -161,6 +172,22 @@ int Widget_EndStyleDiff(LCUI_Widget w, LCUI_WidgetStyleDiff diff)
 		Widget_AddReflowTaskToParent(w);
 	}
 
+	/* check retained layer related property changes */
+
+	if (style->visible != diff->visible || diff->display != style->display ||
+	    diff->box.border.width != w->box.border.width ||
+	    diff->box.border.height != w->box.border.height ||
+	    MEMCMP(&diff->padding, &w->padding) ||
+	    MEMCMP(&diff->shadow, &style->shadow) ||
+	    MEMCMP(&diff->border, &style->border) ||
+	    MEMCMP(&diff->background, &style->background)) {
+		Widget_InvalidateLayer(w);
+	} else if (w->parent && (diff->opacity != style->opacity ||
+				 diff->z_index != style->z_index ||
+				 diff->position != style->position)) {
+		Widget_InvalidateLayer(w->parent);
+	}
+
 	/* check repaint related property changes */
 
 	if (!diff->should_add_invalid_area) {
@@ -215,6 +242,9 @@ int Widget_EndLayoutDiff(LCUI_Widget w, LCUI_WidgetLayoutDiff diff)
 	if (diff->box.outer.x != w->box.outer.x ||
 	    diff->box.outer.y != w->box.outer.y) {
 		w->invalid_area_type = LCUI_INVALID_AREA_TYPE_CANVAS_BOX;
+		if (w->parent) {
+			Widget_InvalidateLayer(w->parent);
+		}
 		Widget_PostSurfaceEvent(w, LCUI_WEVENT_MOVE,
 					!w->task.skip_surface_props_sync);
 		w->task.skip_surface_props_sync = TRUE;
@@ -223,6 +253,7 @@ int Widget_EndLayoutDiff(LCUI_Widget w, LCUI_WidgetLayoutDiff diff)
 	if (diff->box.outer.width != w->box.outer.width ||
 	    diff->box.outer.height != w->box.outer.height) {
 		w->invalid_area_type = LCUI_INVALID_AREA_TYPE_CANVAS_BOX;
+		Widget_InvalidateLayer(w);
 		e.target = w;
 		e.data = NULL;
 		e.type = LCUI_WEVENT_RESIZE;
@@ -44,6 +44,7 @@
 /* clang-format off */
 
 #define DBLCLICK_INTERVAL 500
+#define EVENT_QUEUE_SIZE 512
 
 typedef struct TouchCapturerRec_ {
 	LinkedList points;
@@ -62,18 +63,28 @@ typedef struct LCUI_WidgetEventPackRec_ {
 	void(*destroy_data)(void *); /**< 数据的销毁函数 */
 	LCUI_Widget widget;           /**< 当前处理该事件的部件 */
 	LCUI_WidgetEventRec event;    /**< 事件数据 */
+	LCUI_Widget origin;           /**< 投递该事件时指定的部件 */
+	LinkedListNode node;          /**< 在溢出列表或处理列表中的结点 */
 } LCUI_WidgetEventPackRec, *LCUI_WidgetEventPack;
 
+/**
+ * 部件事件队列
+ * 事件包优先存放在预先分配的环形缓冲区中，缓冲区满了才从堆中分配并追加到
+ * 溢出列表，溢出列表不为空时新的事件包也追加到溢出列表，以保证事件的顺序
+ */
+typedef struct WidgetEventQueueRec_ {
+	LCUI_WidgetEventPack packs; /**< 环形缓冲区 */
+	size_t head;                /**< 队头在缓冲区中的位置 */
+	size_t length;              /**< 缓冲区中的事件包数量 */
+	LinkedList overflow;        /**< 溢出的事件包 */
+	size_t posted;              /**< 已投递的事件数量 */
+	size_t allocated;           /**< 从堆中分配的事件包数量 */
+} WidgetEventQueueRec, *WidgetEventQueue;
+
 enum WidgetStatusType {
 	WST_HOVER, WST_ACTIVE, WST_FOCUS, WST_TOTAL
 };
 
-/** 部件事件记录结点 */
-typedef struct WidgetEventRecordRec_ {
-	LCUI_Widget widget; /**< 所属部件 */
-	LinkedList records; /**< 事件记录列表 */
-} WidgetEventRecordRec, *WidgetEventRecord;
-
 /** 事件标识号与名称的映射记录 */
 typedef struct EventMappingRec_ {
 	int id;
@@ -95,13 +106,16 @@ static struct LCUIWidgetEvnetModule {
 	LCUI_Widget targets[WST_TOTAL]; /**< 相关的部件 */
 	LinkedList events;              /**< 已绑定的事件 */
 	LinkedList event_mappings;	/**< 事件标识号和名称映射记录列表  */
-	RBTree event_records;		/**< 当前正执行的事件的记录 */
+	WidgetEventQueueRec queue;	/**< 主线程投递的事件，无需加锁 */
+	WidgetEventQueueRec remote_queue; /**< 其它线程投递的事件 */
+	LinkedList dispatching;		/**< 正在处理的事件 */
 	RBTree event_names;		/**< 事件名称表，以标识号作为索引 */
 	DictType event_ids_type;
 	Dict *event_ids;		/**< 事件标识号表，以事件名称作为索引 */
 	int base_event_id;		/**< 事件标识号计数器 */
 	ClickRecord click;		/**< 上次鼠标点击记录 */
 	LCUI_Mutex mutex;		/**< 互斥锁 */
+	LCUI_Mutex queue_mutex;		/**< 其它线程投递的事件的互斥锁 */
 } self;
 
 /* clang-format on */
@@ -133,36 +147,141 @@ static void DestroyWidgetEvent(LCUI_WidgetEvent e)
 	}
 }
 
-static void DirectDestroyWidgetEventPack(void *data)
+/** 销毁部件事件包 */
+static void DestroyWidgetEventPack(LCUI_WidgetEventPack pack)
 {
-	LCUI_WidgetEventPack pack = data;
 	if (pack->data && pack->destroy_data) {
 		pack->destroy_data(pack->data);
 	}
 	DestroyWidgetEvent(&pack->event);
 	pack->data = NULL;
-	free(pack);
 }
 
-static void DestoryWidgetEventRecord(void *data)
+static void DestroyOverflowWidgetEventPack(void *data)
 {
-	WidgetEventRecord record = data;
-	LinkedList_Clear(&record->records, DirectDestroyWidgetEventPack);
-	free(record);
+	DestroyWidgetEventPack(data);
+	free(data);
 }
 
-static int CompareWidgetEventRecord(void *data, const void *keydata)
+static void WidgetEventQueue_Init(WidgetEventQueue queue)
 {
-	WidgetEventRecord record = data;
-	if (record->widget == (LCUI_Widget)keydata) {
-		return 0;
-	} else if (record->widget < (LCUI_Widget)keydata) {
-		return -1;
-	} else {
-		return 1;
+	queue->head = 0;
+	queue->length = 0;
+	queue->posted = 0;
+	queue->allocated = 0;
+	queue->packs = NEW(LCUI_WidgetEventPackRec, EVENT_QUEUE_SIZE);
+	LinkedList_Init(&queue->overflow);
+}
+
+static void WidgetEventQueue_Destroy(WidgetEventQueue queue)
+{
+	LCUI_WidgetEventPack pack;
+
+	for (; queue->length > 0; --queue->length) {
+		pack = &queue->packs[queue->head];
+		queue->head = (queue->head + 1) % EVENT_QUEUE_SIZE;
+		DestroyWidgetEventPack(pack);
+	}
+	LinkedList_ClearEx(&queue->overflow, DestroyOverflowWidgetEventPack,
+			   FALSE);
+	free(queue->packs);
+	queue->packs = NULL;
+}
+
+/** 在队尾分配一个事件包，事件模块未初始化时返回 NULL */
+static LCUI_WidgetEventPack WidgetEventQueue_Push(WidgetEventQueue queue)
+{
+	size_t i;
+	LCUI_WidgetEventPack pack;
+
+	if (!queue->packs) {
+		return NULL;
+	}
+	if (queue->overflow.length == 0 && queue->length < EVENT_QUEUE_SIZE) {
+		i = (queue->head + queue->length) % EVENT_QUEUE_SIZE;
+		queue->length += 1;
+		queue->posted += 1;
+		return &queue->packs[i];
+	}
+	pack = malloc(sizeof(LCUI_WidgetEventPackRec));
+	if (!pack) {
+		return NULL;
+	}
+	pack->node.data = pack;
+	LinkedList_AppendNode(&queue->overflow, &pack->node);
+	queue->allocated += 1;
+	queue->posted += 1;
+	return pack;
+}
+
+/** 从队头取出一个事件包，并复制到 pack 中 */
+static LCUI_BOOL WidgetEventQueue_Pop(WidgetEventQueue queue,
+				      LCUI_WidgetEventPack pack)
+{
+	LinkedListNode *node;
+
+	if (queue->length > 0) {
+		*pack = queue->packs[queue->head];
+		queue->head = (queue->head + 1) % EVENT_QUEUE_SIZE;
+		queue->length -= 1;
+		return TRUE;
+	}
+	node = queue->overflow.head.next;
+	if (!node) {
+		return FALSE;
+	}
+	LinkedList_Unlink(&queue->overflow, node);
+	*pack = *(LCUI_WidgetEventPack)node->data;
+	free(node->data);
+	return TRUE;
+}
+
+static void WidgetEventPack_Cancel(LCUI_WidgetEventPack pack,
+				   LCUI_Widget widget, LCUI_BOOL clear_target)
+{
+	if (pack->origin == widget) {
+		pack->event.cancel_bubble = TRUE;
+		if (clear_target) {
+			pack->widget = NULL;
+		}
+	}
+}
+
+/**
+ * 阻止队列中投递给指定部件的事件继续传播
+ * @param[in] clear_target 是否清除事件的目标部件，清除后事件将不会被处理
+ */
+static void WidgetEventQueue_Cancel(WidgetEventQueue queue, LCUI_Widget widget,
+				    LCUI_BOOL clear_target)
+{
+	size_t i;
+	LinkedListNode *node;
+
+	for (i = 0; i < queue->length; ++i) {
+		WidgetEventPack_Cancel(
+		    &queue->packs[(queue->head + i) % EVENT_QUEUE_SIZE], widget,
+		    clear_target);
+	}
+	for (LinkedList_Each(node, &queue->overflow)) {
+		WidgetEventPack_Cancel(node->data, widget, clear_target);
 	}
 }
 
+/** 阻止所有待处理和正在处理的、投递给指定部件的事件继续传播 */
+static void Widget_CancelPostedEvents(LCUI_Widget widget,
+				      LCUI_BOOL clear_target)
+{
+	LinkedListNode *node;
+
+	WidgetEventQueue_Cancel(&self.queue, widget, clear_target);
+	for (LinkedList_Each(node, &self.dispatching)) {
+		WidgetEventPack_Cancel(node->data, widget, clear_target);
+	}
+	LCUIMutex_Lock(&self.queue_mutex);
+	WidgetEventQueue_Cancel(&self.remote_queue, widget, clear_target);
+	LCUIMutex_Unlock(&self.queue_mutex);
+}
+
 static void DestroyWidgetEventHandler(void *arg)
 {
 	WidgetEventHandler handler = arg;
@@ -191,52 +310,6 @@ void LCUI_InitWidgetEvent(LCUI_WidgetEvent e, const char *name)
 	e->data = NULL;
 }
 
-/**
- * 添加事件记录
- * 记录当前待处理的事件和目标部件，方便在部件被销毁时清除待处理的事件
- */
-static void Widget_AddEventRecord(LCUI_Widget widget, LCUI_WidgetEventPack pack)
-{
-	WidgetEventRecord record;
-
-	LCUIMutex_Lock(&self.mutex);
-	record = RBTree_CustomGetData(&self.event_records, widget);
-	if (!record) {
-		record = NEW(WidgetEventRecordRec, 1);
-		LinkedList_Init(&record->records);
-		record->widget = widget;
-		RBTree_CustomInsert(&self.event_records, widget, record);
-	}
-	LinkedList_Append(&record->records, pack);
-	LCUIMutex_Unlock(&self.mutex);
-}
-
-/** 删除事件记录 */
-static int Widget_DeleteEventRecord(LCUI_Widget widget,
-				    LCUI_WidgetEventPack pack)
-{
-	int ret = 0;
-	WidgetEventRecord record;
-	LinkedListNode *node, *prev;
-
-	LCUIMutex_Lock(&self.mutex);
-	record = RBTree_CustomGetData(&self.event_records, widget);
-	if (!record) {
-		LCUIMutex_Unlock(&self.mutex);
-		return -1;
-	}
-	for (LinkedList_Each(node, &record->records)) {
-		prev = node->prev;
-		if (node->data == pack) {
-			LinkedList_DeleteNode(&record->records, node);
-			node = prev;
-			ret = 1;
-		}
-	}
-	LCUIMutex_Unlock(&self.mutex);
-	return ret;
-}
-
 /** 将原始事件转换成部件事件 */
 static void WidgetEventTranslator(LCUI_Event e, LCUI_WidgetEventPack pack)
 {
@@ -294,16 +367,6 @@ static int CopyWidgetEvent(LCUI_WidgetEvent dst, const LCUI_WidgetEvent src)
 	return 0;
 }
 
-/** 销毁部件事件包 */
-static void DestroyWidgetEventPack(void *arg)
-{
-	LCUI_WidgetEventPack pack = arg;
-	/* 如果删除成功则说明有记录，需要销毁数据 */
-	if (Widget_DeleteEventRecord(pack->event.target, pack) == 1) {
-		DirectDestroyWidgetEventPack(pack);
-	}
-}
-
 static void DestroyTouchCapturer(void *arg)
 {
 	TouchCapturer tc = arg;
@@ -495,6 +558,9 @@ static LCUI_Widget Widget_GetNextAt(LCUI_Widget widget, int x, int y)
 	LCUI_Widget w;
 	LinkedListNode *node;
 
+	if (Widget_HasChildrenIndex(widget->parent)) {
+		return Widget_QueryNextSiblingAt(widget, 1.0f * x, 1.0f * y);
+	}
 	node = &widget->node;
 	for (node = node->next; node; node = node->next) {
 		w = node->data;
@@ -583,18 +649,64 @@ static int Widget_TriggerEventEx(LCUI_Widget widget, LCUI_WidgetEventPack pack)
 	return Widget_TriggerEventEx(widget->parent, pack);
 }
 
-static void OnWidgetEvent(LCUI_Event e, LCUI_WidgetEventPack pack)
+/**
+ * 处理事件包
+ * 事件包在处理期间会被记录在处理列表中，以便在部件被销毁时阻止事件的传播
+ */
+static void DispatchWidgetEvent(LCUI_WidgetEventPack pack)
 {
+	pack->node.data = pack;
+	LinkedList_AppendNode(&self.dispatching, &pack->node);
 	if (pack->widget) {
 		Widget_TriggerEventEx(pack->widget, pack);
 	}
+	LinkedList_Unlink(&self.dispatching, &pack->node);
+	DestroyWidgetEventPack(pack);
+}
+
+size_t LCUIWidget_ProcessEvents(void)
+{
+	size_t count = 0;
+	LCUI_BOOL found;
+	LCUI_WidgetEventPackRec pack;
+
+	if (!self.queue.packs) {
+		return 0;
+	}
+	while (1) {
+		LCUIMutex_Lock(&self.queue_mutex);
+		found = WidgetEventQueue_Pop(&self.remote_queue, &pack);
+		LCUIMutex_Unlock(&self.queue_mutex);
+		if (!found) {
+			break;
+		}
+		DispatchWidgetEvent(&pack);
+		++count;
+	}
+	/* 主线程投递的事件只能在主线程中处理 */
+	if (!LCUI_IsOnMainLoop()) {
+		return count;
+	}
+	while (WidgetEventQueue_Pop(&self.queue, &pack)) {
+		DispatchWidgetEvent(&pack);
+		++count;
+	}
+	return count;
+}
+
+void LCUIWidget_GetEventQueueStats(LCUI_WidgetEventQueueStats stats)
+{
+	LCUIMutex_Lock(&self.queue_mutex);
+	stats->posted = self.queue.posted + self.remote_queue.posted;
+	stats->allocated = self.queue.allocated + self.remote_queue.allocated;
+	stats->remote_posted = self.remote_queue.posted;
+	LCUIMutex_Unlock(&self.queue_mutex);
 }
 
 LCUI_BOOL Widget_PostEvent(LCUI_Widget widget, LCUI_WidgetEvent ev, void *data,
 			   void (*destroy_data)(void *))
 {
-	LCUI_Event sys_ev;
-	LCUI_TaskRec task;
+	LCUI_BOOL is_remote;
 	LCUI_WidgetEventPack pack;
 
 	if (widget->state == LCUI_WSTATE_DELETED) {
@@ -603,27 +715,28 @@ LCUI_BOOL Widget_PostEvent(LCUI_Widget widget, LCUI_WidgetEvent ev, void *data,
 	if (!ev->target) {
 		ev->target = widget;
 	}
-	/* 准备任务 */
-	task.func = (LCUI_TaskFunc)OnWidgetEvent;
-	task.arg[0] = malloc(sizeof(LCUI_EventRec));
-	task.arg[1] = malloc(sizeof(LCUI_WidgetEventPackRec));
-	/* 这两个参数都需要在任务执行完后释放 */
-	task.destroy_arg[1] = DestroyWidgetEventPack;
-	task.destroy_arg[0] = free;
-	sys_ev = task.arg[0];
-	pack = task.arg[1];
-	sys_ev->data = pack;
-	sys_ev->type = ev->type;
-	pack->data = data;
-	pack->widget = widget;
-	pack->destroy_data = destroy_data;
-	CopyWidgetEvent(&pack->event, ev);
-	Widget_AddEventRecord(widget, pack);
-	/* 把任务扔给当前跑主循环的线程 */
-	if (!LCUI_PostTask(&task)) {
-		LCUITask_Destroy(&task);
+	/* 主线程投递的事件由主线程自己处理，不需要加锁 */
+	is_remote = !LCUI_IsOnMainLoop();
+	if (is_remote) {
+		LCUIMutex_Lock(&self.queue_mutex);
+		pack = WidgetEventQueue_Push(&self.remote_queue);
+	} else {
+		pack = WidgetEventQueue_Push(&self.queue);
+	}
+	if (pack) {
+		pack->data = data;
+		pack->widget = widget;
+		pack->origin = widget;
+		pack->destroy_data = destroy_data;
+		CopyWidgetEvent(&pack->event, ev);
+	}
+	if (is_remote) {
+		LCUIMutex_Unlock(&self.queue_mutex);
+	}
+	if (!pack) {
 		return FALSE;
 	}
+	LCUI_WakeUp();
 	return TRUE;
 }
 
@@ -643,24 +756,7 @@ int Widget_TriggerEvent(LCUI_Widget widget, LCUI_WidgetEvent e, void *data)
 
 int Widget_StopEventPropagation(LCUI_Widget widget)
 {
-	LinkedListNode *node;
-	WidgetEventRecord record;
-	LCUI_WidgetEventPack pack;
-
-	if (self.event_records.total_node <= 1) {
-		return 0;
-	}
-	LCUIMutex_Lock(&self.mutex);
-	record = RBTree_CustomGetData(&self.event_records, widget);
-	if (!record) {
-		LCUIMutex_Unlock(&self.mutex);
-		return -1;
-	}
-	for (LinkedList_Each(node, &record->records)) {
-		pack = node->data;
-		pack->event.cancel_bubble = TRUE;
-	}
-	LCUIMutex_Unlock(&self.mutex);
+	Widget_CancelPostedEvents(widget, FALSE);
 	return 0;
 }
 
@@ -695,14 +791,53 @@ static LCUI_Widget GetSameParent(LCUI_Widget a, LCUI_Widget b)
 }
 
 static LCUI_Widget Widget_GetEventTarget(LCUI_Widget widget, float x, float y,
-					 int inherited_pointer_events)
+					 int inherited_pointer_events);
+
+/** 在命中的子部件中查找事件目标，如果都忽略指针事件则返回 NULL */
+static LCUI_Widget Widget_GetChildEventTarget(LCUI_Widget child, float x,
+					      float y,
+					      int inherited_pointer_events)
 {
 	int pointer_events;
+	LCUI_Widget target;
 
+	pointer_events = child->computed_style.pointer_events;
+	if (pointer_events == SV_INHERIT) {
+		pointer_events = inherited_pointer_events;
+	}
+	x -= child->box.padding.x - child->scroll.x;
+	y -= child->box.padding.y - child->scroll.y;
+	target = Widget_GetEventTarget(child, x, y, pointer_events);
+	if (target) {
+		return target;
+	}
+	if (pointer_events == SV_AUTO) {
+		return child;
+	}
+	return NULL;
+}
+
+static LCUI_Widget Widget_GetEventTarget(LCUI_Widget widget, float x, float y,
+					 int inherited_pointer_events)
+{
 	LCUI_Widget child;
-	LCUI_Widget target = NULL;
+	LCUI_Widget target;
 	LinkedListNode *node;
 
+	if (Widget_HasChildrenIndex(widget)) {
+		child = Widget_QueryChildAt(widget, x, y, NULL);
+		while (child) {
+			if (child->state == LCUI_WSTATE_NORMAL) {
+				target = Widget_GetChildEventTarget(
+				    child, x, y, inherited_pointer_events);
+				if (target) {
+					return target;
+				}
+			}
+			child = Widget_QueryChildAt(widget, x, y, child);
+		}
+		return NULL;
+	}
 	for (LinkedList_Each(node, &widget->children_show)) {
 		child = node->data;
 		if (!child->computed_style.visible ||
@@ -710,21 +845,13 @@ static LCUI_Widget Widget_GetEventTarget(LCUI_Widget widget, float x, float y,
 		    !LCUIRect_HasPoint(&child->box.border, x, y)) {
 			continue;
 		}
-		pointer_events = child->computed_style.pointer_events;
-		if (pointer_events == SV_INHERIT) {
-			pointer_events = inherited_pointer_events;
-		}
-		target = Widget_GetEventTarget(child, x - child->box.padding.x,
-					       y - child->box.padding.y,
-					       pointer_events);
+		target = Widget_GetChildEventTarget(child, x, y,
+						    inherited_pointer_events);
 		if (target) {
 			return target;
 		}
-		if (pointer_events == SV_AUTO) {
-			return child;
-		}
 	}
-	return target;
+	return NULL;
 }
 
 static void Widget_TriggerMouseOverEvent(LCUI_Widget widget, LCUI_Widget parent)
@@ -840,23 +967,7 @@ static void ClearFocusTarget(LCUI_Widget target)
 
 void LCUIWidget_ClearEventTarget(LCUI_Widget widget)
 {
-	LinkedListNode *node;
-	WidgetEventRecord record;
-	LCUI_WidgetEventPack pack;
-
-	if (self.event_records.total_node <= 1) {
-		return;
-	}
-	LCUIMutex_Lock(&self.mutex);
-	record = RBTree_CustomGetData(&self.event_records, widget);
-	if (record) {
-		for (LinkedList_Each(node, &record->records)) {
-			pack = node->data;
-			pack->widget = NULL;
-			pack->event.cancel_bubble = TRUE;
-		}
-	}
-	LCUIMutex_Unlock(&self.mutex);
+	Widget_CancelPostedEvents(widget, TRUE);
 	ClearMouseOverTarget(widget);
 	ClearMouseDownTarget(widget);
 	ClearFocusTarget(widget);
@@ -1292,8 +1403,11 @@ void LCUIWidget_InitEvent(void)
 			 { LCUI_WEVENT_TITLE, "title" } };
 
 	LCUIMutex_Init(&self.mutex);
+	LCUIMutex_Init(&self.queue_mutex);
 	RBTree_Init(&self.event_names);
-	RBTree_Init(&self.event_records);
+	WidgetEventQueue_Init(&self.queue);
+	WidgetEventQueue_Init(&self.remote_queue);
+	LinkedList_Init(&self.dispatching);
 	LinkedList_Init(&self.events);
 	LinkedList_Init(&self.event_mappings);
 	self.targets[WST_ACTIVE] = NULL;
@@ -1321,8 +1435,6 @@ void LCUIWidget_InitEvent(void)
 	BindSysEvent(LCUI_KEYUP, OnKeyboardEvent);
 	BindSysEvent(LCUI_TOUCH, OnTouch);
 	BindSysEvent(LCUI_TEXTINPUT, OnTextInput);
-	RBTree_OnCompare(&self.event_records, CompareWidgetEventRecord);
-	RBTree_OnDestroy(&self.event_records, DestoryWidgetEventRecord);
 	LinkedList_Init(&self.touch_capturers);
 }
 
@@ -1335,12 +1447,16 @@ void LCUIWidget_FreeEvent(void)
 		LCUI_UnbindEvent(*id);
 	}
 	RBTree_Destroy(&self.event_names);
-	RBTree_Destroy(&self.event_records);
+	WidgetEventQueue_Destroy(&self.queue);
+	LCUIMutex_Lock(&self.queue_mutex);
+	WidgetEventQueue_Destroy(&self.remote_queue);
+	LCUIMutex_Unlock(&self.queue_mutex);
 	Dict_Release(self.event_ids);
 	TouchCapturers_Clear(&self.touch_capturers);
 	LinkedList_Clear(&self.events, free);
 	LinkedList_Clear(&self.event_mappings, DestroyEventMapping);
 	LCUIMutex_Unlock(&self.mutex);
 	LCUIMutex_Destroy(&self.mutex);
+	LCUIMutex_Destroy(&self.queue_mutex);
 	self.event_ids = NULL;
 }
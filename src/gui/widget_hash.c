@@ -28,6 +28,7 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <string.h>
 #include <LCUI_Build.h>
 #include <LCUI/LCUI.h>
 #include <LCUI/gui/widget.h>
@@ -71,6 +72,99 @@ void Widget_GenerateSelfHash(LCUI_Widget widget)
 	widget->hash = hash;
 }
 
+#define HashChar(H, F, C)         \
+	do {                      \
+		H = H * 33 + (C); \
+		F *= 33;          \
+	} while (0)
+
+#define HashString(H, F, S)                                          \
+	do {                                                         \
+		const unsigned char *p = (const unsigned char *)(S); \
+		while (*p) {                                         \
+			HashChar(H, F, *p++);                        \
+		}                                                    \
+	} while (0)
+
+/**
+ * Hash the names in a string list in ascending order, as the selector node
+ * keeps them in a sorted list. The list is usually short, so we simply find
+ * the next name in each round instead of sorting a copy of the list.
+ */
+static void HashSortedNames(unsigned *hash, unsigned *factor, strlist_t list,
+			    char prefix)
+{
+	int i;
+	const char *prev = NULL, *next;
+
+	while (1) {
+		next = NULL;
+		for (i = 0; list[i]; ++i) {
+			if (prev && strcmp(list[i], prev) <= 0) {
+				continue;
+			}
+			if (!next || strcmp(list[i], next) < 0) {
+				next = list[i];
+			}
+		}
+		if (!next) {
+			break;
+		}
+		HashChar(*hash, *factor, prefix);
+		HashString(*hash, *factor, next);
+		prev = next;
+	}
+}
+
+void Widget_UpdateSelectorHash(LCUI_Widget w)
+{
+	unsigned hash = 0, factor = 1;
+
+	if (w->type) {
+		HashString(hash, factor, w->type);
+	}
+	if (w->id) {
+		HashChar(hash, factor, '#');
+		HashString(hash, factor, w->id);
+	}
+	if (w->classes) {
+		HashSortedNames(&hash, &factor, w->classes, '.');
+	}
+	if (w->status) {
+		HashSortedNames(&hash, &factor, w->status, ':');
+	}
+	w->selector_hash = hash;
+	w->selector_factor = factor;
+}
+
+int Widget_GetSelectorHash(LCUI_Widget w, unsigned *hash)
+{
+	int depth = 0;
+	unsigned factor = 1, value = 0;
+
+	/*
+	 * The selector hash is the djb2 hash of the full names of all nodes
+	 * from the root to the widget, so we can combine the hash of each
+	 * node from the widget to the root:
+	 *   hash(AB) = hash(A) * 33^len(B) + hash_0(B)
+	 */
+	for (; w; w = w->parent) {
+		if (w->selector_factor == 0) {
+			Widget_UpdateSelectorHash(w);
+		}
+		if (w->selector_factor == 1) {
+			continue;
+		}
+		value += w->selector_hash * factor;
+		factor *= w->selector_factor;
+		if (++depth >= MAX_SELECTOR_DEPTH) {
+			return -1;
+		}
+	}
+	*hash = 5381 * factor + value;
+	return 0;
+}
+
 void Widget_GenerateHash(LCUI_Widget w)
 {
 	LinkedListNode *node;
@@ -139,12 +139,8 @@ int Widget_UnsetStyle(LCUI_Widget w, int key)
 
 LCUI_Style Widget_GetInheritedStyle(LCUI_Widget w, int key)
 {
-	LCUI_Selector selector;
-
 	if (!w->inherited_style) {
-		selector = Widget_GetSelector(w);
-		w->inherited_style = LCUI_GetCachedStyleSheet(selector);
-		Selector_Delete(selector);
+		w->inherited_style = Widget_GetCachedStyleSheet(w);
 	}
 	assert(key >= 0 && key < w->inherited_style->length);
 	return &w->inherited_style->sheet[key];
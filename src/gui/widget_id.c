@@ -34,6 +34,7 @@
 #include <LCUI/thread.h>
 #include <LCUI/gui/widget_base.h>
 #include <LCUI/gui/widget_id.h>
+#include <LCUI/gui/widget_hash.h>
 
 static struct LCUI_WidgetIdLibraryModule {
 	Dict *ids;
@@ -71,6 +72,7 @@ int Widget_DestroyId(LCUI_Widget w)
 	LCUIMutex_Lock(&self.mutex);
 	ret = Widget_FreeId(w);
 	LCUIMutex_Unlock(&self.mutex);
+	Widget_UpdateSelectorHash(w);
 	return ret;
 }
 
@@ -103,6 +105,7 @@ int Widget_SetId(LCUI_Widget w, const char *idstr)
 		goto error_exit;
 	}
 	LCUIMutex_Unlock(&self.mutex);
+	Widget_UpdateSelectorHash(w);
 	return 0;
 
 error_exit:
@@ -111,6 +114,7 @@ error_exit:
 		free(w->id);
 		w->id = NULL;
 	}
+	Widget_UpdateSelectorHash(w);
 	return -2;
 }
 
@@ -0,0 +1,470 @@
+﻿/*
+ * widget_index.c -- Spatial index of children for hit testing
+ *
+ * Copyright (c) 2020, Liu chao <lc-soft@live.cn> All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of LCUI nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <math.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/gui/widget.h>
+
+/** 网格单元格的尺寸 */
+#define CELL_SIZE 64.0f
+
+/** 单元格坐标的范围，避免超大的坐标值溢出 */
+#define MAX_CELL_POS (1 << 20)
+
+/**
+ * 边框盒覆盖的单元格数量超过该值时不放入网格，而是存放在单独的列表中，
+ * 避免大尺寸的部件（例如：滚动容器的内容层）占用大量单元格
+ */
+#define MAX_CELLS 256
+
+#define MIN_BUCKETS 64
+
+typedef struct WidgetIndexEntryRec_ {
+	int x, y;
+	LCUI_Widget widget;
+} WidgetIndexEntryRec, *WidgetIndexEntry;
+
+typedef struct WidgetIndexBucketRec_ {
+	size_t length;
+	size_t capacity;
+	WidgetIndexEntry entries;
+} WidgetIndexBucketRec, *WidgetIndexBucket;
+
+typedef struct WidgetIndexCellsRec_ {
+	int left, top, right, bottom;
+	size_t count;
+} WidgetIndexCellsRec, *WidgetIndexCells;
+
+/** 以哈希表存储的均匀网格 */
+typedef struct LCUI_WidgetIndexRec_ {
+	size_t length;
+	size_t n_buckets;
+	WidgetIndexBucket buckets;
+	WidgetIndexBucketRec large;
+} LCUI_WidgetIndexRec, *LCUI_WidgetIndex;
+
+static LCUI_WidgetIndex Widget_GetChildrenIndex(LCUI_Widget w)
+{
+	if (!w || !w->rules) {
+		return NULL;
+	}
+	return ((LCUI_WidgetRulesData)w->rules)->children_index;
+}
+
+static int WidgetIndex_GetCell(float v)
+{
+	double cell = floor(v / CELL_SIZE);
+
+	if (cell < -MAX_CELL_POS) {
+		return -MAX_CELL_POS;
+	}
+	if (cell > MAX_CELL_POS) {
+		return MAX_CELL_POS;
+	}
+	return (int)cell;
+}
+
+static void WidgetIndex_GetCells(const LCUI_RectF *box, WidgetIndexCells cells)
+{
+	/* 用取反的条件判断，让 NaN 也被视为空区域 */
+	if (!(box->width > 0 && box->height > 0)) {
+		cells->left = cells->top = 0;
+		cells->right = cells->bottom = -1;
+		cells->count = 0;
+		return;
+	}
+	cells->left = WidgetIndex_GetCell(box->x);
+	cells->top = WidgetIndex_GetCell(box->y);
+	cells->right = WidgetIndex_GetCell(box->x + box->width);
+	cells->bottom = WidgetIndex_GetCell(box->y + box->height);
+	cells->count = (size_t)(cells->right - cells->left + 1) *
+		       (size_t)(cells->bottom - cells->top + 1);
+}
+
+static LCUI_BOOL WidgetIndex_IsSameCells(WidgetIndexCells a,
+					 WidgetIndexCells b)
+{
+	if (a->count > MAX_CELLS && b->count > MAX_CELLS) {
+		return TRUE;
+	}
+	return a->left == b->left && a->top == b->top &&
+	       a->right == b->right && a->bottom == b->bottom;
+}
+
+static WidgetIndexBucket WidgetIndex_GetBucket(LCUI_WidgetIndex index, int x,
+					       int y)
+{
+	unsigned hash = (unsigned)x * 73856093u ^ (unsigned)y * 19349663u;
+	return &index->buckets[hash & (index->n_buckets - 1)];
+}
+
+static int WidgetIndexBucket_Add(WidgetIndexBucket bucket, int x, int y,
+				 LCUI_Widget w)
+{
+	size_t capacity;
+	WidgetIndexEntry entries;
+
+	if (bucket->length >= bucket->capacity) {
+		capacity = bucket->capacity > 0 ? bucket->capacity * 2 : 4;
+		entries = realloc(bucket->entries,
+				  sizeof(WidgetIndexEntryRec) * capacity);
+		if (!entries) {
+			return -ENOMEM;
+		}
+		bucket->entries = entries;
+		bucket->capacity = capacity;
+	}
+	bucket->entries[bucket->length].x = x;
+	bucket->entries[bucket->length].y = y;
+	bucket->entries[bucket->length].widget = w;
+	bucket->length += 1;
+	return 0;
+}
+
+static LCUI_BOOL WidgetIndexBucket_Remove(WidgetIndexBucket bucket, int x,
+					  int y, LCUI_Widget w)
+{
+	size_t i;
+	WidgetIndexEntry e;
+
+	for (i = 0; i < bucket->length; ++i) {
+		e = &bucket->entries[i];
+		if (e->widget == w && e->x == x && e->y == y) {
+			bucket->length -= 1;
+			*e = bucket->entries[bucket->length];
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+static void WidgetIndex_FreeBuckets(WidgetIndexBucket buckets, size_t n)
+{
+	size_t i;
+
+	for (i = 0; i < n; ++i) {
+		free(buckets[i].entries);
+	}
+	free(buckets);
+}
+
+/** 在条目过多时扩充哈希表，让每个桶中的条目保持在较少的数量 */
+static void WidgetIndex_Grow(LCUI_WidgetIndex index)
+{
+	size_t i, j;
+	WidgetIndexEntry e;
+	WidgetIndexBucket bucket;
+	LCUI_WidgetIndexRec tmp = { 0 };
+
+	tmp.n_buckets = index->n_buckets * 2;
+	tmp.buckets = calloc(tmp.n_buckets, sizeof(WidgetIndexBucketRec));
+	if (!tmp.buckets) {
+		return;
+	}
+	for (i = 0; i < index->n_buckets; ++i) {
+		bucket = &index->buckets[i];
+		for (j = 0; j < bucket->length; ++j) {
+			e = &bucket->entries[j];
+			if (WidgetIndexBucket_Add(
+				WidgetIndex_GetBucket(&tmp, e->x, e->y), e->x,
+				e->y, e->widget) != 0) {
+				WidgetIndex_FreeBuckets(tmp.buckets,
+							tmp.n_buckets);
+				return;
+			}
+		}
+	}
+	WidgetIndex_FreeBuckets(index->buckets, index->n_buckets);
+	index->buckets = tmp.buckets;
+	index->n_buckets = tmp.n_buckets;
+}
+
+static void WidgetIndex_Add(LCUI_WidgetIndex index, LCUI_Widget w,
+			    WidgetIndexCells cells)
+{
+	int x, y;
+
+	if (cells->count < 1) {
+		return;
+	}
+	if (cells->count > MAX_CELLS) {
+		WidgetIndexBucket_Add(&index->large, 0, 0, w);
+		return;
+	}
+	for (y = cells->top; y <= cells->bottom; ++y) {
+		for (x = cells->left; x <= cells->right; ++x) {
+			if (WidgetIndexBucket_Add(
+				WidgetIndex_GetBucket(index, x, y), x, y,
+				w) == 0) {
+				index->length += 1;
+			}
+		}
+	}
+	if (index->length > index->n_buckets * 2) {
+		WidgetIndex_Grow(index);
+	}
+}
+
+static void WidgetIndex_Remove(LCUI_WidgetIndex index, LCUI_Widget w,
+			       WidgetIndexCells cells)
+{
+	int x, y;
+
+	if (cells->count < 1) {
+		return;
+	}
+	if (cells->count > MAX_CELLS) {
+		WidgetIndexBucket_Remove(&index->large, 0, 0, w);
+		return;
+	}
+	for (y = cells->top; y <= cells->bottom; ++y) {
+		for (x = cells->left; x <= cells->right; ++x) {
+			if (WidgetIndexBucket_Remove(
+				WidgetIndex_GetBucket(index, x, y), x, y,
+				w)) {
+				index->length -= 1;
+			}
+		}
+	}
+}
+
+int Widget_CreateChildrenIndex(LCUI_Widget w)
+{
+	LinkedListNode *node;
+	LCUI_WidgetIndex index;
+	LCUI_WidgetRulesData data;
+	WidgetIndexCellsRec cells;
+
+	data = (LCUI_WidgetRulesData)w->rules;
+	if (!data) {
+		return -1;
+	}
+	if (data->children_index) {
+		return 0;
+	}
+	index = calloc(1, sizeof(LCUI_WidgetIndexRec));
+	if (!index) {
+		return -ENOMEM;
+	}
+	index->n_buckets = MIN_BUCKETS;
+	index->buckets = calloc(index->n_buckets, sizeof(WidgetIndexBucketRec));
+	if (!index->buckets) {
+		free(index);
+		return -ENOMEM;
+	}
+	data->children_index = index;
+	for (LinkedList_Each(node, &w->children)) {
+		WidgetIndex_GetCells(&((LCUI_Widget)node->data)->box.border,
+				     &cells);
+		WidgetIndex_Add(index, node->data, &cells);
+	}
+	return 0;
+}
+
+void Widget_DestroyChildrenIndex(LCUI_Widget w)
+{
+	LCUI_WidgetIndex index = Widget_GetChildrenIndex(w);
+
+	if (!index) {
+		return;
+	}
+	WidgetIndex_FreeBuckets(index->buckets, index->n_buckets);
+	free(index->large.entries);
+	free(index);
+	((LCUI_WidgetRulesData)w->rules)->children_index = NULL;
+}
+
+void Widget_ClearChildrenIndex(LCUI_Widget w)
+{
+	size_t i;
+	LCUI_WidgetIndex index = Widget_GetChildrenIndex(w);
+
+	if (!index) {
+		return;
+	}
+	for (i = 0; i < index->n_buckets; ++i) {
+		index->buckets[i].length = 0;
+	}
+	index->large.length = 0;
+	index->length = 0;
+}
+
+LCUI_BOOL Widget_HasChildrenIndex(LCUI_Widget w)
+{
+	return Widget_GetChildrenIndex(w) != NULL;
+}
+
+void Widget_AddToParentIndex(LCUI_Widget w)
+{
+	WidgetIndexCellsRec cells;
+	LCUI_WidgetIndex index = Widget_GetChildrenIndex(w->parent);
+
+	if (index) {
+		WidgetIndex_GetCells(&w->box.border, &cells);
+		WidgetIndex_Add(index, w, &cells);
+	}
+}
+
+void Widget_RemoveFromParentIndex(LCUI_Widget w)
+{
+	WidgetIndexCellsRec cells;
+	LCUI_WidgetIndex index = Widget_GetChildrenIndex(w->parent);
+
+	if (index) {
+		WidgetIndex_GetCells(&w->box.border, &cells);
+		WidgetIndex_Remove(index, w, &cells);
+	}
+}
+
+void Widget_UpdateParentIndex(LCUI_Widget w, const LCUI_RectF *old_box)
+{
+	WidgetIndexCellsRec old_cells, cells;
+	LCUI_WidgetIndex index = Widget_GetChildrenIndex(w->parent);
+
+	if (!index) {
+		return;
+	}
+	WidgetIndex_GetCells(old_box, &old_cells);
+	WidgetIndex_GetCells(&w->box.border, &cells);
+	if (WidgetIndex_IsSameCells(&old_cells, &cells)) {
+		return;
+	}
+	WidgetIndex_Remove(index, w, &old_cells);
+	WidgetIndex_Add(index, w, &cells);
+}
+
+/** 比较两个兄弟部件的堆叠顺序，规则与 Widget_SortChildrenShow() 一致 */
+static int Widget_CompareStackOrder(LCUI_Widget a, LCUI_Widget b)
+{
+	LCUI_WidgetStyle *as = &a->computed_style;
+	LCUI_WidgetStyle *bs = &b->computed_style;
+
+	if (as->z_index != bs->z_index) {
+		return as->z_index < bs->z_index ? -1 : 1;
+	}
+	if (as->position != bs->position) {
+		return as->position < bs->position ? -1 : 1;
+	}
+	if (a->index != b->index) {
+		return a->index < b->index ? -1 : 1;
+	}
+	return 0;
+}
+
+static LCUI_Widget Widget_PickTopmost(LCUI_Widget target, LCUI_Widget child,
+				      void *arg)
+{
+	LCUI_Widget below = arg;
+
+	/* 与 children_show 一样忽略未准备完毕的部件 */
+	if (child->state < LCUI_WSTATE_READY ||
+	    child->state == LCUI_WSTATE_DELETED) {
+		return target;
+	}
+	if (target && Widget_CompareStackOrder(child, target) <= 0) {
+		return target;
+	}
+	if (below && Widget_CompareStackOrder(child, below) >= 0) {
+		return target;
+	}
+	return child;
+}
+
+static LCUI_Widget Widget_PickNextSibling(LCUI_Widget target,
+					  LCUI_Widget child, void *arg)
+{
+	LCUI_Widget w = arg;
+
+	if (child->index <= w->index ||
+	    (target && child->index >= target->index)) {
+		return target;
+	}
+	if (child->computed_style.pointer_events == SV_NONE) {
+		return target;
+	}
+	return child;
+}
+
+/** 遍历包含该点的子部件，由 pick 函数选出结果 */
+static LCUI_Widget WidgetIndex_Query(LCUI_WidgetIndex index, float x, float y,
+				     LCUI_Widget (*pick)(LCUI_Widget,
+							 LCUI_Widget, void *),
+				     void *arg)
+{
+	int cx, cy;
+	size_t i;
+	LCUI_Widget w, target = NULL;
+	WidgetIndexEntry e;
+	WidgetIndexBucket bucket;
+
+	cx = WidgetIndex_GetCell(x);
+	cy = WidgetIndex_GetCell(y);
+	bucket = WidgetIndex_GetBucket(index, cx, cy);
+	for (i = 0; i < bucket->length + index->large.length; ++i) {
+		if (i < bucket->length) {
+			e = &bucket->entries[i];
+			if (e->x != cx || e->y != cy) {
+				continue;
+			}
+		} else {
+			e = &index->large.entries[i - bucket->length];
+		}
+		w = e->widget;
+		if (w->computed_style.visible &&
+		    LCUIRect_HasPoint(&w->box.border, x, y)) {
+			target = pick(target, w, arg);
+		}
+	}
+	return target;
+}
+
+LCUI_Widget Widget_QueryChildAt(LCUI_Widget w, float x, float y,
+				LCUI_Widget below)
+{
+	LCUI_WidgetIndex index = Widget_GetChildrenIndex(w);
+
+	if (!index) {
+		return NULL;
+	}
+	return WidgetIndex_Query(index, x, y, Widget_PickTopmost, below);
+}
+
+LCUI_Widget Widget_QueryNextSiblingAt(LCUI_Widget w, float x, float y)
+{
+	LCUI_WidgetIndex index = Widget_GetChildrenIndex(w->parent);
+
+	if (!index) {
+		return NULL;
+	}
+	return WidgetIndex_Query(index, x, y, Widget_PickNextSibling, w);
+}
@@ -37,22 +37,115 @@
 #include "layout/block.h"
 #include "layout/flexbox.h"
 
-void Widget_Reflow(LCUI_Widget w, LCUI_LayoutRule rule)
+static struct LCUIWidgetLayoutModule {
+	size_t layout_count;
+	size_t cache_hits;
+} self;
+
+size_t LCUIWidget_GetLayoutCount(void)
 {
-	LCUI_WidgetEventRec ev = { 0 };
+	return self.layout_count;
+}
+
+size_t LCUIWidget_GetLayoutCacheHits(void)
+{
+	return self.cache_hits;
+}
 
+static LCUI_LayoutRule Widget_GetLayoutRule(LCUI_Widget w,
+					    LCUI_LayoutRule rule)
+{
 	switch (w->computed_style.display) {
 	case SV_BLOCK:
 	case SV_INLINE_BLOCK:
-		LCUIBlockLayout_Reflow(w, rule);
-		break;
+		return LCUIBlockLayout_GetRule(w, rule);
 	case SV_FLEX:
-		LCUIFlexBoxLayout_Reflow(w, rule);
-		break;
-	case SV_NONE:
+		return LCUIFlexBoxLayout_GetRule(w, rule);
 	default:
 		break;
 	}
+	return rule;
+}
+
+/** 记录本次布局的约束条件，子部件的尺寸计算只依赖这些条件 */
+static void Widget_GetLayoutConstraints(LCUI_Widget w, LCUI_LayoutRule rule,
+					LCUI_WidgetLayoutCache cache)
+{
+	cache->rule = Widget_GetLayoutRule(w, rule);
+	cache->width_sizing = w->computed_style.width_sizing;
+	cache->height_sizing = w->computed_style.height_sizing;
+	cache->content_width = w->box.content.width;
+	cache->content_height = w->box.content.height;
+	if (w->parent) {
+		cache->parent_width_sizing =
+		    w->parent->computed_style.width_sizing;
+		cache->parent_height_sizing =
+		    w->parent->computed_style.height_sizing;
+		cache->parent_content_width = w->parent->box.content.width;
+		cache->parent_content_height = w->parent->box.content.height;
+	} else {
+		cache->parent_width_sizing = LCUI_SIZING_RULE_NONE;
+		cache->parent_height_sizing = LCUI_SIZING_RULE_NONE;
+		cache->parent_content_width = 0;
+		cache->parent_content_height = 0;
+	}
+}
+
+static LCUI_BOOL Widget_MatchLayoutCache(LCUI_Widget w,
+					 LCUI_WidgetLayoutCache cache)
+{
+	LCUI_WidgetLayoutCache last = &w->layout_cache;
+
+	return last->is_valid && last->rule == cache->rule &&
+	       last->width_sizing == cache->width_sizing &&
+	       last->height_sizing == cache->height_sizing &&
+	       last->parent_width_sizing == cache->parent_width_sizing &&
+	       last->parent_height_sizing == cache->parent_height_sizing &&
+	       last->content_width == cache->content_width &&
+	       last->content_height == cache->content_height &&
+	       last->parent_content_width == cache->parent_content_width &&
+	       last->parent_content_height == cache->parent_content_height;
+}
+
+void Widget_Reflow(LCUI_Widget w, LCUI_LayoutRule rule)
+{
+	LCUI_WidgetEventRec ev = { 0 };
+	LCUI_WidgetLayoutCacheRec cache;
+
+	Widget_GetLayoutConstraints(w, rule, &cache);
+	/*
+	 * 自上次布局以来部件没有新的重排任务，说明它的子部件都没有变化，
+	 * 如果约束条件也相同，那么布局结果也一样，直接恢复上次的尺寸即可
+	 */
+	if (Widget_MatchLayoutCache(w, &cache)) {
+		w->width = w->layout_cache.width;
+		w->height = w->layout_cache.height;
+		Widget_UpdateBoxSize(w);
+		if (rule == LCUI_LAYOUT_RULE_AUTO) {
+			w->max_content_width = w->box.content.width;
+			w->max_content_height = w->box.content.height;
+		}
+		self.cache_hits += 1;
+	} else {
+		self.layout_count += 1;
+		switch (w->computed_style.display) {
+		case SV_BLOCK:
+		case SV_INLINE_BLOCK:
+			LCUIBlockLayout_Reflow(w, rule);
+			break;
+		case SV_FLEX:
+			LCUIFlexBoxLayout_Reflow(w, rule);
+			break;
+		case SV_NONE:
+		default:
+			break;
+		}
+		cache.is_valid = TRUE;
+		cache.width = w->width;
+		cache.height = w->height;
+		w->layout_cache = cache;
+	}
+	/* 布局结果来自缓存时也通知监听者，他们可能依赖每次重排后的回调 */
 	ev.cancel_bubble = TRUE;
 	ev.type = LCUI_WEVENT_AFTERLAYOUT;
 	Widget_TriggerEvent(w, &ev, NULL);
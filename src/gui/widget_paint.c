@@ -29,10 +29,15 @@
  */
 
 //#define DEBUG
+#include <math.h>
+#include <errno.h>
+#include <float.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <LCUI_Build.h>
 #include <LCUI/LCUI.h>
+#include <LCUI/thread.h>
 #include <LCUI/gui/widget.h>
 #include <LCUI/display.h>
 #include "widget_border.h"
@@ -45,6 +50,23 @@
 #define MAX_VISIBLE_WIDTH 20000
 #define MAX_VISIBLE_HEIGHT 20000
 
+/* the maximum number of bytes of free canvases kept by each render thread */
+#define MAX_CACHED_CANVAS_BYTES (16 * 1024 * 1024)
+
+/* the maximum size of retained layers, larger widgets are not cached */
+#define MAX_LAYER_WIDTH 4096
+#define MAX_LAYER_HEIGHT 4096
+
+/* the children of a widget are indexed for rendering if there are so many */
+#define RENDER_INDEX_MIN_CHILDREN 32
+
+/* the size of render index cells, the cells become larger if too many */
+#define RENDER_INDEX_CELL_SIZE 128.0f
+#define RENDER_INDEX_MAX_CELLS 4096
+
+/* children covering more cells are kept in a separate list */
+#define RENDER_INDEX_MAX_CHILD_CELLS 16
+
 #ifdef DEBUG_FRAME_RENDER
 #include <LCUI/image.h>
 #endif
@@ -54,14 +76,51 @@ typedef struct LCUI_RectGroupRec_ {
 	LinkedList rects;
 } LCUI_RectGroupRec, *LCUI_RectGroup;
 
+/**
+ * Uniform grid of the children canvas boxes
+ * It is built when a tile first enters the widget in a frame, so the other
+ * tiles only visit the children in the cells they overlap instead of
+ * scanning all children of the widget.
+ */
+typedef struct LCUI_WidgetRenderIndexRec_ {
+	/* the indexed widget, and the node in the list of built indexes */
+	LCUI_Widget widget;
+	LinkedListNode node;
+
+	/* visible children in render order, from bottom to top */
+	LCUI_Widget *children;
+	size_t length;
+
+	/* the grid, in the coordinates of the children boxes */
+	float x, y;
+	float cell_size;
+	int cols, rows;
+
+	/* child positions of each cell are items[cells[i]..cells[i + 1]] */
+	size_t *cells;
+	size_t *items;
+
+	/* positions of the children covering too many cells */
+	size_t *large;
+	size_t n_large;
+} LCUI_WidgetRenderIndexRec, *LCUI_WidgetRenderIndex;
+
+/** The scratch canvas pool of a render thread */
+typedef struct LCUI_RenderPoolRec_ {
+	LCUI_Thread tid;
+	LCUI_GraphPool pool;
+} LCUI_RenderPoolRec, *LCUI_RenderPool;
+
 typedef struct LCUI_WidgetRendererRec_ {
 	/* target widget position, it relative to root canvas */
 	float x, y;
 
-	/* content area top spacing, it relative to widget canvas */
+	/* content area top spacing minus the scroll offset, it relative to
+	 * widget canvas */
 	float content_top;
 
-	/* content area left spacing, it relative to widget canvas */
+	/* content area left spacing minus the scroll offset, it relative to
+	 * widget canvas */
 	float content_left;
 
 	/* target widget */
@@ -76,6 +135,12 @@ typedef struct LCUI_WidgetRendererRec_ {
 	/* root paint context */
 	LCUI_PaintContext root_paint;
 
+	/* the opacity used to mix the widget layer */
+	float opacity;
+
+	/* the pool of the current render thread, used to create canvases */
+	LCUI_GraphPool pool;
+
 	/* content canvas */
 	LCUI_Graph content_graph;
 
@@ -110,6 +175,15 @@ static struct LCUI_WidgetRenderModule {
 	LCUI_WidgetPrototype default_proto;
 	RBTree groups;
 	LinkedList rects;
+
+	/* scratch canvas pools of render threads */
+	LinkedList pools;
+	LCUI_Mutex pools_mutex;
+
+	/* children render indexes built in the current frame */
+	LCUI_BOOL in_frame;
+	LinkedList indexes;
+	LCUI_Mutex indexes_mutex;
 } self = { 0 };
 
 /** 判断部件是否有可绘制内容 */
@@ -126,6 +200,16 @@ static LCUI_BOOL Widget_IsPaintable(LCUI_Widget w)
 	return w->proto != self.default_proto;
 }
 
+static LCUI_WidgetRulesData Widget_GetLayerData(LCUI_Widget w)
+{
+	LCUI_WidgetRulesData data = (LCUI_WidgetRulesData)w->rules;
+
+	if (data && data->rules.retain_layer) {
+		return data;
+	}
+	return NULL;
+}
+
 static LCUI_BOOL Widget_HasRoundBorder(LCUI_Widget w)
 {
 	const LCUI_BorderStyle *s = &w->computed_style.border;
@@ -146,8 +230,38 @@ void RectToInvalidArea(const LCUI_Rect *rect, LCUI_Rect *area)
 	LCUIMetrics_ComputeRectActual(area, &rectf);
 }
 
-LCUI_BOOL Widget_InvalidateArea(LCUI_Widget w, LCUI_RectF *in_rect,
-				int box_type)
+void Widget_InvalidateLayer(LCUI_Widget w)
+{
+	LCUI_WidgetRulesData data;
+
+	for (; w; w = w->parent) {
+		data = Widget_GetLayerData(w);
+		if (data) {
+			data->layer_valid = FALSE;
+		}
+	}
+}
+
+void Widget_SetScroll(LCUI_Widget w, float x, float y)
+{
+	if (w->scroll.x == x && w->scroll.y == y) {
+		return;
+	}
+	w->scroll.x = x;
+	w->scroll.y = y;
+	/* the scrolled content is collected in Widget_CollectScroll() */
+	Widget_InvalidateLayer(w);
+	while (w->parent) {
+		w->parent->has_child_invalid_area = TRUE;
+		w = w->parent;
+	}
+	if (!LCUI_IsOnMainLoop()) {
+		LCUI_WakeUp();
+	}
+}
+
+static LCUI_BOOL Widget_MarkInvalidArea(LCUI_Widget w, LCUI_RectF *in_rect,
+					int box_type)
 {
 	LCUI_RectF rect;
 	LCUI_InvalidAreaType type;
@@ -155,6 +269,7 @@ LCUI_BOOL Widget_InvalidateArea(LCUI_Widget w, LCUI_RectF *in_rect,
 	if (!w->computed_style.visible) {
 		return FALSE;
 	}
+	Widget_InvalidateLayer(w);
 	if (!in_rect) {
 		switch (box_type) {
 		case SV_BORDER_BOX:
@@ -230,25 +345,207 @@ LCUI_BOOL Widget_InvalidateArea(LCUI_Widget w, LCUI_RectF *in_rect,
 	return TRUE;
 }
 
+LCUI_BOOL Widget_InvalidateArea(LCUI_Widget w, LCUI_RectF *in_rect,
+				int box_type)
+{
+	if (!Widget_MarkInvalidArea(w, in_rect, box_type)) {
+		return FALSE;
+	}
+	/* 在其它线程（例如异步加载图片的任务）中标记的无效区域需要唤醒主循环 */
+	if (!LCUI_IsOnMainLoop()) {
+		LCUI_WakeUp();
+	}
+	return TRUE;
+}
+
+/** 无效区域收集器，收集到的区域会输出到链表或区域中 */
+typedef struct InvalidAreaCollectorRec_ {
+	LinkedList *rects;
+	LCUI_Region region;
+	LinkedList *scrolls;
+	int offset_x;
+	int offset_y;
+} InvalidAreaCollectorRec, *InvalidAreaCollector;
+
+static void InvalidAreaCollector_Add(InvalidAreaCollector collector,
+				     LCUI_RectF *rect)
+{
+	LCUI_Rect *actual_rect;
+	LCUI_Rect area;
+
+	RectFToInvalidArea(rect, &area);
+	area.x -= collector->offset_x;
+	area.y -= collector->offset_y;
+	if (collector->region) {
+		LCUIRegion_AddRect(collector->region, &area);
+		return;
+	}
+	actual_rect = malloc(sizeof(LCUI_Rect));
+	*actual_rect = area;
+	LinkedList_Append(collector->rects, actual_rect);
+}
+
 #define AddInvalidArea()                                               \
 	do {                                                           \
 		rect.x += x;                                           \
 		rect.y += y;                                           \
 		LCUIRectF_GetOverlayRect(&rect, &visible_area, &rect); \
 		if (rect.width > 0 && rect.height > 0) {               \
-			actual_rect = malloc(sizeof(LCUI_Rect));       \
-			RectFToInvalidArea(&rect, actual_rect);        \
-			LinkedList_Append(rects, actual_rect);         \
+			InvalidAreaCollector_Add(collector, &rect);    \
 		}                                                      \
 	} while (0)
 
-static void Widget_CollectInvalidArea(LCUI_Widget w, LinkedList *rects, float x,
+/**
+ * 判断视口中的背景是否不随滚动而变化
+ * 视口中除了滚动的子部件外只能有纯色的背景，不能有在它下层的兄弟部件。不透明
+ * 的背景会遮住它下面的内容，但是如果它的祖先部件是半透明的，那么祖先部件下面
+ * 的内容也会被混合进视口中，需要继续检查。
+ * @param[in] x, y 部件的父部件中的子部件坐标原点
+ */
+static LCUI_BOOL Widget_HasStaticBackdrop(LCUI_Widget w,
+					  const LCUI_RectF *viewport, float x,
+					  float y)
+{
+	LCUI_RectF rect;
+	LCUI_Widget child;
+	LinkedListNode *node;
+	LCUI_BOOL covered = FALSE;
+	const LCUI_WidgetStyle *s;
+
+	for (; w; w = w->parent) {
+		s = &w->computed_style;
+		if (!covered) {
+			if (Graph_IsValid(&s->background.image) ||
+			    Widget_HasRoundBorder(w) ||
+			    w->proto->paint != self.default_proto->paint) {
+				return FALSE;
+			}
+			covered = s->background.color.alpha == 255;
+		}
+		/* the layer of the widget is mixed with what lies under it */
+		if (s->opacity < 1.0f) {
+			covered = FALSE;
+		}
+		if (!w->parent) {
+			break;
+		}
+		for (node = w->node_show.next; !covered && node;
+		     node = node->next) {
+			child = node->data;
+			if (!child->computed_style.visible ||
+			    child->state != LCUI_WSTATE_NORMAL) {
+				continue;
+			}
+			rect = child->box.canvas;
+			rect.x += x;
+			rect.y += y;
+			if (LCUIRectF_GetOverlayRect(viewport, &rect, &rect)) {
+				return FALSE;
+			}
+		}
+		x -= w->parent->box.padding.x - w->parent->scroll.x;
+		y -= w->parent->box.padding.y - w->parent->scroll.y;
+	}
+	/* the screen is filled with white before rendering */
+	return TRUE;
+}
+
+/** 收集视口上层的兄弟部件的区域，它们的像素也会随视口内容一起被平移 */
+static void Widget_CollectOverlays(LCUI_Widget w,
+				   InvalidAreaCollector collector,
+				   const LCUI_RectF *viewport, float x, float y)
+{
+	LCUI_RectF rect;
+	LCUI_Widget child;
+	LinkedListNode *node;
+
+	for (; w->parent; w = w->parent) {
+		for (node = w->node_show.prev; node && node->prev;
+		     node = node->prev) {
+			child = node->data;
+			if (!child->computed_style.visible ||
+			    child->state != LCUI_WSTATE_NORMAL) {
+				continue;
+			}
+			rect = child->box.canvas;
+			rect.x += x;
+			rect.y += y;
+			if (LCUIRectF_GetOverlayRect(viewport, &rect, &rect)) {
+				InvalidAreaCollector_Add(collector, &rect);
+			}
+		}
+		x -= w->parent->box.padding.x - w->parent->scroll.x;
+		y -= w->parent->box.padding.y - w->parent->scroll.y;
+	}
+}
+
+/**
+ * 收集部件内容的滚动
+ * 如果视口的背景不随滚动而变化，则输出滚动区域，让已绘制的内容被平移，
+ * 否则重绘整个视口
+ */
+static void Widget_CollectScroll(LCUI_Widget w, InvalidAreaCollector collector,
+				 float x, float y,
+				 const LCUI_RectF *visible_area)
+{
+	float dx, dy;
+	LCUI_Rect area;
+	LCUI_RectF rect;
+	LCUI_ScrollArea scroll;
+	float scale = LCUIMetrics_GetScale();
+
+	dx = (w->scroll.painted_x - w->scroll.x) * scale;
+	dy = (w->scroll.painted_y - w->scroll.y) * scale;
+	w->scroll.painted_x = w->scroll.x;
+	w->scroll.painted_y = w->scroll.y;
+	/* the whole padding box will be repainted */
+	if (w->invalid_area_type >= LCUI_INVALID_AREA_TYPE_PADDING_BOX ||
+	    !w->computed_style.visible) {
+		return;
+	}
+	rect = w->box.padding;
+	rect.x += x;
+	rect.y += y;
+	if (!LCUIRectF_GetOverlayRect(visible_area, &rect, &rect)) {
+		return;
+	}
+	RectFToInvalidArea(&rect, &area);
+	/* the pixels can only be moved by whole pixels */
+	if (!collector->scrolls || fabsf(dx - iround(dx)) > 0.01f ||
+	    fabsf(dy - iround(dy)) > 0.01f || abs(iround(dx)) >= area.width ||
+	    abs(iround(dy)) >= area.height ||
+	    !Widget_HasStaticBackdrop(w, &rect, x, y)) {
+		InvalidAreaCollector_Add(collector, &rect);
+		return;
+	}
+	scroll = malloc(sizeof(LCUI_ScrollAreaRec));
+	if (!scroll) {
+		InvalidAreaCollector_Add(collector, &rect);
+		return;
+	}
+	scroll->viewport = area;
+	scroll->viewport.x -= collector->offset_x;
+	scroll->viewport.y -= collector->offset_y;
+	scroll->dx = iround(dx);
+	scroll->dy = iround(dy);
+	LinkedList_Append(collector->scrolls, scroll);
+	Widget_CollectOverlays(w, collector, &rect, x, y);
+}
+
+static void Widget_CollectInvalidArea(LCUI_Widget w,
+				      InvalidAreaCollector collector, float x,
 				      float y, LCUI_RectF visible_area)
 {
 	LCUI_RectF rect;
-	LCUI_Rect *actual_rect;
 	LinkedListNode *node;
+	LCUI_WidgetRulesData data = Widget_GetLayerData(w);
 
+	/* the content of the retained layer is changed */
+	if (data && (w->has_child_invalid_area ||
+		     (w->invalid_area_type > LCUI_INVALID_AREA_TYPE_NONE &&
+		      w->invalid_area_type < LCUI_INVALID_AREA_TYPE_CANVAS_BOX))) {
+		data->layer_valid = FALSE;
+	}
 	if (w->parent && w->parent->invalid_area_type >=
 			     LCUI_INVALID_AREA_TYPE_PADDING_BOX) {
 		w->invalid_area_type = LCUI_INVALID_AREA_TYPE_CANVAS_BOX;
@@ -276,6 +573,10 @@ static void Widget_CollectInvalidArea(LCUI_Widget w, LinkedList *rects, float x,
 		rect = w->invalid_area;
 		AddInvalidArea();
 	}
+	if (w->scroll.x != w->scroll.painted_x ||
+	    w->scroll.y != w->scroll.painted_y) {
+		Widget_CollectScroll(w, collector, x, y, &visible_area);
+	}
 	if (w->has_child_invalid_area) {
 		visible_area.x -= x;
 		visible_area.y -= y;
@@ -285,32 +586,54 @@ static void Widget_CollectInvalidArea(LCUI_Widget w, LinkedList *rects, float x,
 		visible_area.y += y;
 		for (LinkedList_Each(node, &w->children_show)) {
 			Widget_CollectInvalidArea(
-			    node->data, rects, x + w->box.padding.x,
-			    y + w->box.padding.y, visible_area);
+			    node->data, collector,
+			    x + w->box.padding.x - w->scroll.x,
+			    y + w->box.padding.y - w->scroll.y, visible_area);
 		}
 	}
 	w->invalid_area_type = LCUI_INVALID_AREA_TYPE_NONE;
 	w->has_child_invalid_area = FALSE;
 }
 
-size_t Widget_GetInvalidArea(LCUI_Widget w, LinkedList *rects)
+static void InvalidAreaCollector_Init(InvalidAreaCollector collector,
+				      LCUI_Widget w)
 {
-	LCUI_Rect *rect;
-	LinkedListNode *node;
-
 	float scale = LCUIMetrics_GetScale();
-	int x = iround(w->box.padding.x * scale);
-	int y = iround(w->box.padding.y * scale);
 
-	Widget_CollectInvalidArea(w, rects, 0, 0, w->box.padding);
-	for (LinkedList_Each(node, rects)) {
-		rect = node->data;
-		rect->x -= x;
-		rect->y -= y;
-	}
+	collector->rects = NULL;
+	collector->region = NULL;
+	collector->scrolls = NULL;
+	collector->offset_x = iround(w->box.padding.x * scale);
+	collector->offset_y = iround(w->box.padding.y * scale);
+}
+
+size_t Widget_GetInvalidArea(LCUI_Widget w, LinkedList *rects)
+{
+	InvalidAreaCollectorRec collector;
+
+	InvalidAreaCollector_Init(&collector, w);
+	collector.rects = rects;
+	Widget_CollectInvalidArea(w, &collector, 0, 0, w->box.padding);
 	return rects->length;
 }
 
+size_t Widget_GetInvalidRegion(LCUI_Widget w, LCUI_Region region)
+{
+	return Widget_GetInvalidRegionWithScrolls(w, region, NULL);
+}
+
+size_t Widget_GetInvalidRegionWithScrolls(LCUI_Widget w, LCUI_Region region,
+					  LinkedList *scrolls)
+{
+	InvalidAreaCollectorRec collector;
+
+	InvalidAreaCollector_Init(&collector, w);
+	collector.region = region;
+	collector.scrolls = scrolls;
+	Widget_CollectInvalidArea(w, &collector, 0, 0, w->box.padding);
+	return region->length;
+}
+
 static int OnCompareGroup(void *data, const void *keydata)
 {
 	LCUI_RectGroup group = data;
@@ -324,12 +647,108 @@ static void OnDestroyGroup(void *data)
 	group->widget = NULL;
 }
 
+static void OnDestroyRenderPool(void *data)
+{
+	LCUI_RenderPool rp = data;
+
+	GraphPool_Destroy(rp->pool);
+	free(rp);
+}
+
+/** 在渲染线程退出时释放它的画布缓存池 */
+static void LCUIWidget_OnRenderThreadExit(void *arg)
+{
+	LinkedListNode *node;
+	LCUI_RenderPool rp = NULL;
+	LCUI_Thread tid = LCUIThread_SelfID();
+
+	if (!self.active) {
+		return;
+	}
+	LCUIMutex_Lock(&self.pools_mutex);
+	for (LinkedList_Each(node, &self.pools)) {
+		if (((LCUI_RenderPool)node->data)->tid == tid) {
+			rp = node->data;
+			LinkedList_DeleteNode(&self.pools, node);
+			break;
+		}
+	}
+	LCUIMutex_Unlock(&self.pools_mutex);
+	if (rp) {
+		OnDestroyRenderPool(rp);
+	}
+}
+
+/** 获取当前渲染线程的画布缓存池 */
+static LCUI_GraphPool LCUIWidget_GetRenderPool(void)
+{
+	LCUI_RenderPool rp;
+	LinkedListNode *node;
+	LCUI_Thread tid = LCUIThread_SelfID();
+
+	if (!self.active) {
+		return NULL;
+	}
+	LCUIMutex_Lock(&self.pools_mutex);
+	for (LinkedList_Each(node, &self.pools)) {
+		rp = node->data;
+		if (rp->tid == tid) {
+			LCUIMutex_Unlock(&self.pools_mutex);
+			return rp->pool;
+		}
+	}
+	rp = NEW(LCUI_RenderPoolRec, 1);
+	rp->tid = tid;
+	rp->pool = GraphPool_Create(MAX_CACHED_CANVAS_BYTES);
+	LinkedList_Append(&self.pools, rp);
+	LCUIMutex_Unlock(&self.pools_mutex);
+	/* the pool of the main thread is freed in LCUIWidget_FreeRenderer() */
+	LCUIThread_AtExit(LCUIWidget_OnRenderThreadExit, NULL);
+	return rp->pool;
+}
+
+void LCUIWidget_TrimRenderer(void)
+{
+	LinkedListNode *node;
+
+	LCUIMutex_Lock(&self.pools_mutex);
+	for (LinkedList_Each(node, &self.pools)) {
+		GraphPool_Trim(((LCUI_RenderPool)node->data)->pool);
+	}
+	LCUIMutex_Unlock(&self.pools_mutex);
+}
+
+void LCUIWidget_GetRendererStats(LCUI_GraphPoolStats stats)
+{
+	LinkedListNode *node;
+	LCUI_GraphPoolStatsRec pool_stats;
+
+	memset(stats, 0, sizeof(LCUI_GraphPoolStatsRec));
+	if (!self.active) {
+		return;
+	}
+	LCUIMutex_Lock(&self.pools_mutex);
+	for (LinkedList_Each(node, &self.pools)) {
+		GraphPool_GetStats(((LCUI_RenderPool)node->data)->pool,
+				   &pool_stats);
+		stats->hits += pool_stats.hits;
+		stats->misses += pool_stats.misses;
+		stats->used_bytes += pool_stats.used_bytes;
+		stats->cached_bytes += pool_stats.cached_bytes;
+	}
+	LCUIMutex_Unlock(&self.pools_mutex);
+}
+
 void LCUIWidget_InitRenderer(void)
 {
 	RBTree_Init(&self.groups);
 	RBTree_OnCompare(&self.groups, OnCompareGroup);
 	RBTree_OnDestroy(&self.groups, OnDestroyGroup);
 	LinkedList_Init(&self.rects);
+	LinkedList_Init(&self.pools);
+	LCUIMutex_Init(&self.pools_mutex);
+	LinkedList_Init(&self.indexes);
+	LCUIMutex_Init(&self.indexes_mutex);
 	self.default_proto = LCUIWidget_GetPrototype(NULL);
 	self.active = TRUE;
 }
@@ -339,6 +758,10 @@ void LCUIWidget_FreeRenderer(void)
 	self.active = FALSE;
 	RectList_Clear(&self.rects);
 	RBTree_Destroy(&self.groups);
+	LinkedList_Clear(&self.pools, OnDestroyRenderPool);
+	LCUIMutex_Destroy(&self.pools_mutex);
+	LCUIWidget_EndFrame();
+	LCUIMutex_Destroy(&self.indexes_mutex);
 }
 
 /** 当前部件的绘制函数 */
@@ -408,25 +831,29 @@ int Widget_ConvertArea(LCUI_Widget w, LCUI_Rect *in_rect, LCUI_Rect *out_rect,
 static LCUI_WidgetRenderer WidgetRenderer(LCUI_Widget w,
 					  LCUI_PaintContext paint,
 					  LCUI_WidgetActualStyle style,
-					  LCUI_WidgetRenderer parent)
+					  LCUI_WidgetRenderer parent,
+					  float opacity)
 {
 	ASSIGN(that, LCUI_WidgetRenderer);
 
 	that->target = w;
 	that->style = style;
 	that->paint = paint;
+	that->opacity = opacity;
 	that->has_self_graph = FALSE;
 	that->has_layer_graph = FALSE;
 	that->has_content_graph = FALSE;
 	if (parent) {
+		that->pool = parent->pool;
 		that->root_paint = parent->root_paint;
 		that->x = parent->x + parent->content_left + w->box.canvas.x;
 		that->y = parent->y + parent->content_top + w->box.canvas.y;
 	} else {
 		that->x = that->y = 0;
 		that->root_paint = that->paint;
+		that->pool = LCUIWidget_GetRenderPool();
 	}
-	if (w->computed_style.opacity < 1.0) {
+	if (opacity < 1.0) {
 		that->has_self_graph = TRUE;
 		that->has_content_graph = TRUE;
 		that->has_layer_graph = TRUE;
@@ -440,12 +867,13 @@ static LCUI_WidgetRenderer WidgetRenderer(LCUI_Widget w,
 	that->can_render_self = Widget_IsPaintable(w);
 	if (that->can_render_self) {
 		that->self_graph.color_type = LCUI_COLOR_TYPE_ARGB;
-		Graph_Create(&that->self_graph, that->paint->rect.width,
-			     that->paint->rect.height);
+		GraphPool_Alloc(that->pool, &that->self_graph,
+				that->paint->rect.width,
+				that->paint->rect.height);
 	}
 	/* get content rectangle left spacing and top */
-	that->content_left = w->box.padding.x - w->box.canvas.x;
-	that->content_top = w->box.padding.y - w->box.canvas.y;
+	that->content_left = w->box.padding.x - w->box.canvas.x - w->scroll.x;
+	that->content_top = w->box.padding.y - w->box.canvas.y - w->scroll.y;
 	/* convert position of paint rectangle to root canvas relative */
 	that->actual_paint_rect.x =
 	    that->style->canvas_box.x + that->paint->rect.x;
@@ -487,23 +915,26 @@ static LCUI_WidgetRenderer WidgetRenderer(LCUI_Widget w,
 	}
 	if (that->has_content_graph) {
 		that->content_graph.color_type = LCUI_COLOR_TYPE_ARGB;
-		Graph_Create(&that->content_graph,
-			     that->actual_content_rect.width,
-			     that->actual_content_rect.height);
+		GraphPool_Alloc(that->pool, &that->content_graph,
+				that->actual_content_rect.width,
+				that->actual_content_rect.height);
 	}
 	return that;
 }
 
 static void WidgetRenderer_Delete(LCUI_WidgetRenderer renderer)
 {
-	Graph_Free(&renderer->layer_graph);
-	Graph_Free(&renderer->self_graph);
-	Graph_Free(&renderer->content_graph);
+	GraphPool_Release(renderer->pool, &renderer->layer_graph);
+	GraphPool_Release(renderer->pool, &renderer->self_graph);
+	GraphPool_Release(renderer->pool, &renderer->content_graph);
 	free(renderer);
 }
 
 static size_t WidgetRenderer_Render(LCUI_WidgetRenderer renderer);
 
+static size_t Widget_RenderWithOpacity(LCUI_Widget w, LCUI_PaintContext paint,
+				       float opacity);
+
 static void Widget_ComputeActualBorderBox(LCUI_Widget w,
 					  LCUI_WidgetActualStyle s)
 {
@@ -546,84 +977,449 @@ static void Widget_ComputeActualContentBox(LCUI_Widget w,
 	LCUIMetrics_ComputeRectActual(&s->content_box, &rect);
 }
 
-static size_t WidgetRenderer_RenderChildren(LCUI_WidgetRenderer that)
+/**
+ * 更新部件的图层缓存
+ * 图层中保存的是不透明度为 1 时的部件及其子部件的渲染结果，在部件内容无变化
+ * 时，移动部件和修改不透明度都不需要重新绘制图层
+ * @returns 图层可用时返回 TRUE，部件尺寸超出图层的尺寸限制时返回 FALSE
+ */
+static LCUI_BOOL Widget_UpdateLayer(LCUI_Widget w, LCUI_WidgetRulesData data,
+				    LCUI_WidgetActualStyle style)
+{
+	LCUI_PaintContextRec paint;
+	int width = style->canvas_box.width;
+	int height = style->canvas_box.height;
+
+	if (width < 1 || height < 1 || width > MAX_LAYER_WIDTH ||
+	    height > MAX_LAYER_HEIGHT) {
+		return FALSE;
+	}
+	LCUIMutex_Lock(&data->layer_mutex);
+	if (!data->layer_valid || data->layer.width != width ||
+	    data->layer.height != height) {
+		data->layer.color_type = LCUI_COLOR_TYPE_ARGB;
+		if (Graph_Create(&data->layer, width, height) != 0) {
+			LCUIMutex_Unlock(&data->layer_mutex);
+			return FALSE;
+		}
+		paint.rect.x = paint.rect.y = 0;
+		paint.rect.width = width;
+		paint.rect.height = height;
+		paint.with_alpha = TRUE;
+		Graph_Quote(&paint.canvas, &data->layer, NULL);
+		Widget_RenderWithOpacity(w, &paint, 1.0f);
+		data->layer_valid = TRUE;
+	}
+	/* the opacity of the source graph is used when mixing a quote */
+	data->layer.opacity = w->computed_style.opacity;
+	LCUIMutex_Unlock(&data->layer_mutex);
+	return TRUE;
+}
+
+static int WidgetRenderIndex_GetCell(LCUI_WidgetRenderIndex index, float v,
+				     int n)
+{
+	double cell = floor(v / index->cell_size);
+
+	/* use the negated condition to treat NaN as out of the grid */
+	if (!(cell >= 0)) {
+		return -1;
+	}
+	return cell >= n ? n : (int)cell;
+}
+
+/** Get the range of cells overlapping the rect, in cell coordinates */
+static LCUI_BOOL WidgetRenderIndex_GetCells(LCUI_WidgetRenderIndex index,
+					    const LCUI_RectF *rect,
+					    LCUI_Rect *cells)
+{
+	int right, bottom;
+
+	cells->x = WidgetRenderIndex_GetCell(index, rect->x - index->x,
+					     index->cols);
+	cells->y = WidgetRenderIndex_GetCell(index, rect->y - index->y,
+					     index->rows);
+	right = WidgetRenderIndex_GetCell(
+	    index, rect->x + rect->width - index->x, index->cols);
+	bottom = WidgetRenderIndex_GetCell(
+	    index, rect->y + rect->height - index->y, index->rows);
+	if (right < 0 || bottom < 0 || cells->x >= index->cols ||
+	    cells->y >= index->rows) {
+		return FALSE;
+	}
+	cells->x = max(0, cells->x);
+	cells->y = max(0, cells->y);
+	cells->width = min(right, index->cols - 1) - cells->x + 1;
+	cells->height = min(bottom, index->rows - 1) - cells->y + 1;
+	return TRUE;
+}
+
+static void WidgetRenderIndex_Delete(LCUI_WidgetRenderIndex index)
+{
+	free(index->children);
+	free(index->cells);
+	free(index->items);
+	free(index->large);
+	free(index);
+}
+
+/** Fill the grid, the positions in each cell are in render order */
+static int WidgetRenderIndex_Fill(LCUI_WidgetRenderIndex index)
+{
+	int x, y;
+	size_t i, n_cells, *offsets;
+	LCUI_Rect cells;
+
+	n_cells = (size_t)index->cols * index->rows;
+	index->cells = calloc(n_cells + 1, sizeof(size_t));
+	offsets = malloc(sizeof(size_t) * n_cells);
+	index->large = malloc(sizeof(size_t) * index->length);
+	if (!index->cells || !offsets || !index->large) {
+		free(offsets);
+		return -ENOMEM;
+	}
+	/* count the children of each cell, then convert counts to offsets */
+	for (i = 0; i < index->length; ++i) {
+		if (!WidgetRenderIndex_GetCells(
+			index, &index->children[i]->box.canvas, &cells) ||
+		    cells.width * cells.height > RENDER_INDEX_MAX_CHILD_CELLS) {
+			continue;
+		}
+		for (y = cells.y; y < cells.y + cells.height; ++y) {
+			for (x = cells.x; x < cells.x + cells.width; ++x) {
+				index->cells[y * index->cols + x + 1] += 1;
+			}
+		}
+	}
+	for (i = 0; i < n_cells; ++i) {
+		index->cells[i + 1] += index->cells[i];
+		offsets[i] = index->cells[i];
+	}
+	index->items = malloc(sizeof(size_t) * max(1, index->cells[n_cells]));
+	if (!index->items) {
+		free(offsets);
+		return -ENOMEM;
+	}
+	for (i = 0; i < index->length; ++i) {
+		if (!WidgetRenderIndex_GetCells(
+			index, &index->children[i]->box.canvas, &cells)) {
+			continue;
+		}
+		if (cells.width * cells.height > RENDER_INDEX_MAX_CHILD_CELLS) {
+			index->large[index->n_large++] = i;
+			continue;
+		}
+		for (y = cells.y; y < cells.y + cells.height; ++y) {
+			for (x = cells.x; x < cells.x + cells.width; ++x) {
+				index->items[offsets[y * index->cols + x]++] =
+				    i;
+			}
+		}
+	}
+	free(offsets);
+	return 0;
+}
+
+static LCUI_WidgetRenderIndex WidgetRenderIndex_Create(LCUI_Widget w)
 {
-	size_t total = 0, count = 0;
+	float right = 0, bottom = 0, width, height;
 	LCUI_Widget child;
+	LCUI_RectF *box;
+	LinkedListNode *node;
+	LCUI_WidgetRenderIndex index;
+
+	index = calloc(1, sizeof(LCUI_WidgetRenderIndexRec));
+	if (!index) {
+		return NULL;
+	}
+	index->children = malloc(sizeof(LCUI_Widget) * w->children_show.length);
+	if (!index->children) {
+		free(index);
+		return NULL;
+	}
+	for (LinkedList_EachReverse(node, &w->children_show)) {
+		child = node->data;
+		box = &child->box.canvas;
+		/* the same children are skipped by the renderer */
+		if (!child->computed_style.visible ||
+		    child->state != LCUI_WSTATE_NORMAL ||
+		    !(box->width > 0 && box->height > 0)) {
+			continue;
+		}
+		if (index->length == 0) {
+			index->x = box->x;
+			index->y = box->y;
+			right = box->x + box->width;
+			bottom = box->y + box->height;
+		}
+		index->x = min(index->x, box->x);
+		index->y = min(index->y, box->y);
+		right = max(right, box->x + box->width);
+		bottom = max(bottom, box->y + box->height);
+		index->children[index->length++] = child;
+	}
+	width = right - index->x;
+	height = bottom - index->y;
+	/* scan all children if their boxes are not finite */
+	if (index->length < 1 ||
+	    !(width >= 0 && width <= FLT_MAX && height >= 0 &&
+	      height <= FLT_MAX)) {
+		WidgetRenderIndex_Delete(index);
+		return NULL;
+	}
+	index->cell_size = RENDER_INDEX_CELL_SIZE;
+	while ((floor(width / index->cell_size) + 1) *
+		   (floor(height / index->cell_size) + 1) >
+	       RENDER_INDEX_MAX_CELLS) {
+		index->cell_size *= 2;
+	}
+	index->cols = (int)(width / index->cell_size) + 1;
+	index->rows = (int)(height / index->cell_size) + 1;
+	if (WidgetRenderIndex_Fill(index) != 0) {
+		WidgetRenderIndex_Delete(index);
+		return NULL;
+	}
+	return index;
+}
+
+static int CompareRenderIndexItem(const void *a, const void *b)
+{
+	size_t x = *(const size_t *)a, y = *(const size_t *)b;
+
+	return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+/**
+ * Get the positions of the children which may overlap the rect
+ * @param[in] rect the rect in the coordinates of the children boxes
+ * @param[out] items positions of the children in render order
+ * @returns the number of positions, or -1 if it is better to scan all
+ *  children
+ */
+static int WidgetRenderIndex_Query(LCUI_WidgetRenderIndex index,
+				   const LCUI_RectF *rect, size_t **items)
+{
+	int y;
+	size_t i, n = 0, total;
+	size_t *cell;
+	LCUI_Rect cells;
+
+	*items = NULL;
+	if (!WidgetRenderIndex_GetCells(index, rect, &cells)) {
+		return 0;
+	}
+	total = index->n_large;
+	for (y = cells.y; y < cells.y + cells.height; ++y) {
+		cell = &index->cells[y * index->cols];
+		total += cell[cells.x + cells.width] - cell[cells.x];
+	}
+	if (total >= index->length) {
+		return -1;
+	}
+	if (total < 1) {
+		return 0;
+	}
+	*items = malloc(sizeof(size_t) * total);
+	if (!*items) {
+		return -1;
+	}
+	for (y = cells.y; y < cells.y + cells.height; ++y) {
+		cell = &index->cells[y * index->cols];
+		i = cell[cells.x + cells.width] - cell[cells.x];
+		memcpy(*items + n, index->items + cell[cells.x],
+		       sizeof(size_t) * i);
+		n += i;
+	}
+	memcpy(*items + n, index->large, sizeof(size_t) * index->n_large);
+	n += index->n_large;
+	/* a child covering several cells is collected more than once */
+	qsort(*items, n, sizeof(size_t), CompareRenderIndexItem);
+	for (i = 1, total = n, n = 1; i < total; ++i) {
+		if ((*items)[i] != (*items)[n - 1]) {
+			(*items)[n++] = (*items)[i];
+		}
+	}
+	return (int)n;
+}
+
+/**
+ * Get the render index of the children, build it if it is not built in the
+ * current frame
+ */
+static LCUI_WidgetRenderIndex Widget_GetRenderIndex(LCUI_Widget w)
+{
+	LCUI_WidgetRenderIndex index;
+
+	if (!self.in_frame ||
+	    w->children_show.length < RENDER_INDEX_MIN_CHILDREN) {
+		return NULL;
+	}
+	LCUIMutex_Lock(&self.indexes_mutex);
+	if (!w->render_index) {
+		w->render_index = WidgetRenderIndex_Create(w);
+		if (w->render_index) {
+			w->render_index->widget = w;
+			w->render_index->node.data = w->render_index;
+			LinkedList_AppendNode(&self.indexes,
+					      &w->render_index->node);
+		}
+	}
+	index = w->render_index;
+	LCUIMutex_Unlock(&self.indexes_mutex);
+	return index;
+}
+
+void Widget_FreeRenderIndex(LCUI_Widget w)
+{
+	if (w->render_index) {
+		LinkedList_Unlink(&self.indexes, &w->render_index->node);
+		WidgetRenderIndex_Delete(w->render_index);
+		w->render_index = NULL;
+	}
+}
+
+void LCUIWidget_BeginFrame(void)
+{
+	self.in_frame = TRUE;
+}
+
+void LCUIWidget_EndFrame(void)
+{
+	LCUI_WidgetRenderIndex index;
+
+	self.in_frame = FALSE;
+	while (self.indexes.length > 0) {
+		index = self.indexes.head.next->data;
+		Widget_FreeRenderIndex(index->widget);
+	}
+}
+
+/**
+ * Render a child widget
+ * @returns FALSE if the child is not in the paint rectangle
+ */
+static LCUI_BOOL WidgetRenderer_RenderChild(LCUI_WidgetRenderer that,
+					    LCUI_Widget child, size_t *total)
+{
 	LCUI_Rect paint_rect;
 	LCUI_RectF child_rect;
-	LinkedListNode *node;
+	LCUI_Graph layer;
+	LCUI_WidgetRulesData data;
 	LCUI_PaintContextRec child_paint;
 	LCUI_WidgetRenderer renderer;
 	LCUI_WidgetActualStyleRec style;
 
+	if (!child->computed_style.visible ||
+	    child->state != LCUI_WSTATE_NORMAL) {
+		return FALSE;
+	}
+	/*
+	 * The actual style calculation is time consuming, so here we
+	 * use the existing properties to determine whether we need to
+	 * render.
+	 */
+	style.x = that->x + that->content_left;
+	style.y = that->y + that->content_top;
+	child_rect.x = style.x + child->box.canvas.x;
+	child_rect.y = style.y + child->box.canvas.y;
+	child_rect.width = child->box.canvas.width;
+	child_rect.height = child->box.canvas.height;
+	if (!LCUIRectF_GetOverlayRect(&that->content_rect, &child_rect,
+				      &child_rect)) {
+		return FALSE;
+	}
+	Widget_ComputeActualBorderBox(child, &style);
+	Widget_ComputeActualCanvasBox(child, &style);
+	DEBUG_MSG("content: %g, %g\n", that->content_left,
+		  that->content_top);
+	DEBUG_MSG("content rect: (%d, %d, %d, %d)\n",
+		  that->actual_content_rect.x,
+		  that->actual_content_rect.y,
+		  that->actual_content_rect.width,
+		  that->actual_content_rect.height);
+	DEBUG_MSG("child canvas rect: (%d, %d, %d, %d)\n",
+		  style.canvas_box.x, style.canvas_box.y,
+		  style.canvas_box.width, style.canvas_box.height);
+	if (!LCUIRect_GetOverlayRect(&that->actual_content_rect,
+				     &style.canvas_box, &paint_rect)) {
+		return FALSE;
+	}
+	Widget_ComputeActualPaddingBox(child, &style);
+	Widget_ComputeActualContentBox(child, &style);
+	child_paint.rect = paint_rect;
+	child_paint.rect.x -= style.canvas_box.x;
+	child_paint.rect.y -= style.canvas_box.y;
+	if (that->has_content_graph) {
+		child_paint.with_alpha = TRUE;
+		paint_rect.x -= that->actual_content_rect.x;
+		paint_rect.y -= that->actual_content_rect.y;
+		Graph_Quote(&child_paint.canvas, &that->content_graph,
+			    &paint_rect);
+	} else {
+		child_paint.with_alpha = that->paint->with_alpha;
+		paint_rect.x -= that->actual_paint_rect.x;
+		paint_rect.y -= that->actual_paint_rect.y;
+		Graph_Quote(&child_paint.canvas, &that->paint->canvas,
+			    &paint_rect);
+	}
+	DEBUG_MSG("child paint rect: (%d, %d, %d, %d)\n", paint_rect.x,
+		  paint_rect.y, paint_rect.width, paint_rect.height);
+	/* composite the retained layer instead of repainting */
+	data = Widget_GetLayerData(child);
+	if (data && Widget_UpdateLayer(child, data, &style)) {
+		Graph_QuoteReadOnly(&layer, &data->layer, &child_paint.rect);
+		Graph_Mix(&child_paint.canvas, &layer, 0, 0,
+			  child_paint.with_alpha);
+		*total += 1;
+		return TRUE;
+	}
+	renderer = WidgetRenderer(child, &child_paint, &style, that,
+				  child->computed_style.opacity);
+	*total += WidgetRenderer_Render(renderer);
+	WidgetRenderer_Delete(renderer);
+	return TRUE;
+}
+
+static size_t WidgetRenderer_RenderChildren(LCUI_WidgetRenderer that)
+{
+	int i, n;
+	size_t total = 0, count = 0, *items;
+	unsigned max_count = 0;
+	LCUI_RectF rect;
+	LinkedListNode *node;
+	LCUI_WidgetRenderIndex index = Widget_GetRenderIndex(that->target);
+
+	if (that->target->rules) {
+		max_count = that->target->rules->max_render_children_count;
+	}
+	n = -1;
+	if (index) {
+		rect = that->content_rect;
+		rect.x -= that->x + that->content_left;
+		rect.y -= that->y + that->content_top;
+		n = WidgetRenderIndex_Query(index, &rect, &items);
+	}
+	if (n >= 0) {
+		for (i = 0; i < n; ++i) {
+			if (max_count && count > max_count) {
+				break;
+			}
+			if (WidgetRenderer_RenderChild(
+				that, index->children[items[i]], &total)) {
+				++count;
+			}
+		}
+		free(items);
+		return total;
+	}
 	/* Render the child widgets from bottom to top in stack order */
 	for (LinkedList_EachReverse(node, &that->target->children_show)) {
-		child = node->data;
-		if (!child->computed_style.visible ||
-		    child->state != LCUI_WSTATE_NORMAL) {
-			continue;
-		}
-		if (that->target->rules &&
-		    that->target->rules->max_render_children_count &&
-		    count > that->target->rules->max_render_children_count) {
+		if (max_count && count > max_count) {
 			break;
 		}
-		/*
-		 * The actual style calculation is time consuming, so here we
-		 * use the existing properties to determine whether we need to
-		 * render.
-		 */
-		style.x = that->x + that->content_left;
-		style.y = that->y + that->content_top;
-		child_rect.x = style.x + child->box.canvas.x;
-		child_rect.y = style.y + child->box.canvas.y;
-		child_rect.width = child->box.canvas.width;
-		child_rect.height = child->box.canvas.height;
-		if (!LCUIRectF_GetOverlayRect(&that->content_rect, &child_rect,
-					      &child_rect)) {
-			continue;
+		if (WidgetRenderer_RenderChild(that, node->data, &total)) {
+			++count;
 		}
-		Widget_ComputeActualBorderBox(child, &style);
-		Widget_ComputeActualCanvasBox(child, &style);
-		DEBUG_MSG("content: %g, %g\n", that->content_left,
-			  that->content_top);
-		DEBUG_MSG("content rect: (%d, %d, %d, %d)\n",
-			  that->actual_content_rect.x,
-			  that->actual_content_rect.y,
-			  that->actual_content_rect.width,
-			  that->actual_content_rect.height);
-		DEBUG_MSG("child canvas rect: (%d, %d, %d, %d)\n",
-			  style.canvas_box.x, style.canvas_box.y,
-			  style.canvas_box.width, style.canvas_box.height);
-		if (!LCUIRect_GetOverlayRect(&that->actual_content_rect,
-					     &style.canvas_box, &paint_rect)) {
-			continue;
-		}
-		++count;
-		Widget_ComputeActualPaddingBox(child, &style);
-		Widget_ComputeActualContentBox(child, &style);
-		child_paint.rect = paint_rect;
-		child_paint.rect.x -= style.canvas_box.x;
-		child_paint.rect.y -= style.canvas_box.y;
-		if (that->has_content_graph) {
-			child_paint.with_alpha = TRUE;
-			paint_rect.x -= that->actual_content_rect.x;
-			paint_rect.y -= that->actual_content_rect.y;
-			Graph_Quote(&child_paint.canvas, &that->content_graph,
-				    &paint_rect);
-		} else {
-			child_paint.with_alpha = that->paint->with_alpha;
-			paint_rect.x -= that->actual_paint_rect.x;
-			paint_rect.y -= that->actual_paint_rect.y;
-			Graph_Quote(&child_paint.canvas, &that->paint->canvas,
-				    &paint_rect);
-		}
-		DEBUG_MSG("child paint rect: (%d, %d, %d, %d)\n", paint_rect.x,
-			  paint_rect.y, paint_rect.width, paint_rect.height);
-		renderer = WidgetRenderer(child, &child_paint, &style, that);
-		total += WidgetRenderer_Render(renderer);
-		WidgetRenderer_Delete(renderer);
 	}
 	return total;
 }
@@ -700,8 +1496,10 @@ static size_t WidgetRenderer_Render(LCUI_WidgetRenderer renderer)
 	/* 若需要绘制的是当前部件图层，则先混合部件自身位图和内容位图，得出当
 	 * 前部件的图层，然后将该图层混合到输出的位图中
 	 */
+	GraphPool_Alloc(that->pool, &that->layer_graph, that->paint->rect.width,
+			that->paint->rect.height);
 	if (that->can_render_self) {
-		Graph_Copy(&that->layer_graph, &that->self_graph);
+		Graph_Replace(&that->layer_graph, &that->self_graph, 0, 0);
 		Graph_Mix(&that->layer_graph, &that->content_graph, content_x,
 			  content_y, TRUE);
 #ifdef DEBUG_FRAME_RENDER
@@ -714,12 +1512,10 @@ static size_t WidgetRenderer_Render(LCUI_WidgetRenderer renderer)
 		LCUI_WritePNGFile(filename, &that->layer_graph);
 #endif
 	} else {
-		Graph_Create(&that->layer_graph, that->paint->rect.width,
-			     that->paint->rect.height);
 		Graph_Replace(&that->layer_graph, &that->content_graph,
 			      content_x, content_y);
 	}
-	that->layer_graph.opacity = that->target->computed_style.opacity;
+	that->layer_graph.opacity = that->opacity;
 	Graph_Mix(&that->paint->canvas, &that->layer_graph, 0, 0,
 		  that->paint->with_alpha);
 #ifdef DEBUG_FRAME_RENDER
@@ -735,7 +1531,8 @@ static size_t WidgetRenderer_Render(LCUI_WidgetRenderer renderer)
 	return count;
 }
 
-size_t Widget_Render(LCUI_Widget w, LCUI_PaintContext paint)
+static size_t Widget_RenderWithOpacity(LCUI_Widget w, LCUI_PaintContext paint,
+				       float opacity)
 {
 	size_t count;
 	LCUI_WidgetRenderer renderer;
@@ -752,7 +1549,7 @@ size_t Widget_Render(LCUI_Widget w, LCUI_PaintContext paint)
 	Widget_ComputeActualCanvasBox(w, &style);
 	Widget_ComputeActualPaddingBox(w, &style);
 	Widget_ComputeActualContentBox(w, &style);
-	renderer = WidgetRenderer(w, paint, &style, NULL);
+	renderer = WidgetRenderer(w, paint, &style, NULL, opacity);
 	DEBUG_MSG("[%d] %s: start render\n", renderer->target->index,
 		  renderer->target->type);
 	count = WidgetRenderer_Render(renderer);
@@ -761,3 +1558,8 @@ size_t Widget_Render(LCUI_Widget w, LCUI_PaintContext paint)
 	WidgetRenderer_Delete(renderer);
 	return count;
 }
+
+size_t Widget_Render(LCUI_Widget w, LCUI_PaintContext paint)
+{
+	return Widget_RenderWithOpacity(w, paint, w->computed_style.opacity);
+}
@@ -231,6 +231,7 @@ void Widget_ClearPrototype(LCUI_Widget widget)
 	if (widget->type && !widget->proto->name) {
 		free(widget->type);
 		widget->type = NULL;
+		Widget_UpdateSelectorHash(widget);
 	}
 	widget->proto = NULL;
 }
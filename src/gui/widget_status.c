@@ -35,6 +35,7 @@
 #include <LCUI/gui/widget_style.h>
 #include <LCUI/gui/widget_task.h>
 #include <LCUI/gui/widget_tree.h>
+#include <LCUI/gui/widget_hash.h>
 
 static void Widget_MarkChildrenRefreshByStatus(LCUI_Widget w)
 {
@@ -73,6 +74,7 @@ int Widget_AddStatus(LCUI_Widget w, const char *status_name)
 	if (strlist_add(&w->status, status_name) <= 0) {
 		return 0;
 	}
+	Widget_UpdateSelectorHash(w);
 	return Widget_HandleStatusChange(w, status_name);
 }
 
@@ -89,6 +91,7 @@ int Widget_RemoveStatus(LCUI_Widget w, const char *status_name)
 	if (strlist_has(w->status, status_name)) {
 		Widget_HandleStatusChange(w, status_name);
 		strlist_remove(&w->status, status_name);
+		Widget_UpdateSelectorHash(w);
 		return 1;
 	}
 	return 0;
@@ -133,4 +136,5 @@ void Widget_DestroyStatus(LCUI_Widget w)
 		strlist_free(w->status);
 	}
 	w->status = NULL;
+	Widget_UpdateSelectorHash(w);
 }
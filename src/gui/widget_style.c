@@ -522,6 +522,24 @@ LCUI_Selector Widget_GetSelector(LCUI_Widget w)
 	return s;
 }
 
+LCUI_CachedStyleSheet Widget_GetCachedStyleSheet(LCUI_Widget w)
+{
+	unsigned hash;
+	LCUI_Selector selector;
+	LCUI_CachedStyleSheet style;
+
+	if (Widget_GetSelectorHash(w, &hash) == 0) {
+		style = LCUI_FindCachedStyleSheet(hash);
+		if (style) {
+			return style;
+		}
+	}
+	selector = Widget_GetSelector(w);
+	style = LCUI_GetCachedStyleSheet(selector);
+	Selector_Delete(selector);
+	return style;
+}
+
 size_t Widget_GetChildrenStyleChanges(LCUI_Widget w, int type, const char *name)
 {
 	LCUI_Selector s;
@@ -164,12 +164,18 @@ void Widget_AddTask(LCUI_Widget widget, int task)
 	DEBUG_MSG("[%lu] %s, %d\n", widget->index, widget->type, task);
 	widget->task.for_self = TRUE;
 	widget->task.states[task] = TRUE;
+	if (task == LCUI_WTASK_REFLOW) {
+		widget->layout_cache.is_valid = FALSE;
+	}
 	widget = widget->parent;
 	/* 向没有标记的父级部件添加标记 */
 	while (widget && !widget->task.for_children) {
 		widget->task.for_children = TRUE;
 		widget = widget->parent;
 	}
+	if (!LCUI_IsOnMainLoop()) {
+		LCUI_WakeUp();
+	}
 }
 
 void LCUIWidget_InitTasks(void)
@@ -258,9 +264,7 @@ LCUI_WidgetTaskContext Widget_BeginUpdate(LCUI_Widget w,
 		}
 		w->inherited_style = style;
 	} else {
-		selector = Widget_GetSelector(w);
-		w->inherited_style = LCUI_GetCachedStyleSheet(selector);
-		Selector_Delete(selector);
+		w->inherited_style = Widget_GetCachedStyleSheet(w);
 	}
 	if (w->inherited_style != inherited_style) {
 		Widget_AddTask(w, LCUI_WTASK_REFRESH_STYLE);
@@ -296,8 +300,8 @@ static size_t Widget_UpdateVisibleChildren(LCUI_Widget w,
 		if (child == w) {
 			continue;
 		}
-		rect.x += child->box.padding.x;
-		rect.y += child->box.padding.y;
+		rect.x += child->box.padding.x - child->scroll.x;
+		rect.y += child->box.padding.y - child->scroll.y;
 		LCUIRectF_ValidateArea(&rect, parent->box.padding.width,
 				       parent->box.padding.height);
 	}
@@ -307,8 +311,8 @@ static size_t Widget_UpdateVisibleChildren(LCUI_Widget w,
 	if (!LCUIRectF_GetOverlayRect(&visible_rect, &rect, &visible_rect)) {
 		return 0;
 	}
-	visible_rect.x -= w->box.padding.x;
-	visible_rect.y -= w->box.padding.y;
+	visible_rect.x -= w->box.padding.x - w->scroll.x;
+	visible_rect.y -= w->box.padding.y - w->scroll.y;
 	for (node = w->children.head.next; node; node = next) {
 		child = node->data;
 		next = node->next;
@@ -475,7 +479,9 @@ static size_t Widget_UpdateWithContext(LCUI_Widget w,
 		count += Widget_UpdateChildren(w, self_ctx);
 	}
 	if (w->task.states[LCUI_WTASK_REFLOW]) {
+		LCUITrace_Begin("layout");
 		Widget_Reflow(w, LCUI_LAYOUT_RULE_AUTO);
+		LCUITrace_End();
 		w->task.states[LCUI_WTASK_REFLOW] = FALSE;
 	}
 	Widget_EndLayoutDiff(w, &self_ctx->layout_diff);
@@ -529,10 +535,14 @@ void Widget_UpdateWithProfile(LCUI_Widget w, LCUI_WidgetTasksProfile profile)
 
 void LCUIWidget_UpdateWithProfile(LCUI_WidgetTasksProfile profile)
 {
+	int64_t time;
+	size_t layout_count, cache_hits;
 	LCUI_Widget root;
 	const LCUI_MetricsRec *metrics;
 
-	profile->time = clock();
+	time = LCUI_GetSystemTime();
+	layout_count = LCUIWidget_GetLayoutCount();
+	cache_hits = LCUIWidget_GetLayoutCacheHits();
 	metrics = LCUI_GetMetrics();
 	if (memcmp(metrics, &self.metrics, sizeof(LCUI_MetricsRec))) {
 		self.refresh_all = TRUE;
@@ -546,10 +556,13 @@ void LCUIWidget_UpdateWithProfile(LCUI_WidgetTasksProfile profile)
 	root = LCUIWidget_GetRoot();
 	Widget_UpdateWithProfile(root, profile);
 	root->state = LCUI_WSTATE_NORMAL;
-	profile->time = clock() - profile->time;
-	profile->destroy_time = clock();
+	profile->time = (clock_t)(LCUI_GetSystemTime() - time);
+	profile->layout_count = LCUIWidget_GetLayoutCount() - layout_count;
+	profile->layout_cache_hits =
+	    LCUIWidget_GetLayoutCacheHits() - cache_hits;
+	time = LCUI_GetSystemTime();
 	profile->destroy_count = LCUIWidget_ClearTrash();
-	profile->destroy_time = clock() - profile->destroy_time;
+	profile->destroy_time = (size_t)(LCUI_GetSystemTime() - time);
 }
 
 void LCUIWidget_RefreshStyle(void)
@@ -51,6 +51,7 @@ int Widget_Append(LCUI_Widget parent, LCUI_Widget widget)
 	widget->state = LCUI_WSTATE_CREATED;
 	widget->index = parent->children.length;
 	LinkedList_AppendNode(&parent->children, &widget->node);
+	Widget_AddToParentIndex(widget);
 	ev.cancel_bubble = TRUE;
 	ev.type = LCUI_WEVENT_LINK;
 	Widget_UpdateStyle(widget, TRUE);
@@ -82,6 +83,7 @@ int Widget_Prepend(LCUI_Widget parent, LCUI_Widget widget)
 	widget->state = LCUI_WSTATE_CREATED;
 	node = &widget->node;
 	LinkedList_InsertNode(&parent->children, 0, node);
+	Widget_AddToParentIndex(widget);
 	/** 修改它后面的部件的 index 值 */
 	node = node->next;
 	while (node) {
@@ -122,6 +124,7 @@ int Widget_Unwrap(LCUI_Widget widget)
 	node = &widget->node;
 	target = node->prev;
 	node = widget->children.tail.prev;
+	Widget_ClearChildrenIndex(widget);
 	ev.cancel_bubble = TRUE;
 	while (len > 0) {
 		assert(node != NULL);
@@ -133,6 +136,7 @@ int Widget_Unwrap(LCUI_Widget widget)
 		LinkedList_Unlink(&widget->children, node);
 		LinkedList_Link(children, target, node);
 		child->parent = widget->parent;
+		Widget_AddToParentIndex(child);
 		ev.type = LCUI_WEVENT_LINK;
 		Widget_TriggerEvent(child, &ev, NULL);
 		Widget_AddTaskForChildren(child, LCUI_WTASK_REFRESH_STYLE);
@@ -186,6 +190,7 @@ int Widget_Unlink(LCUI_Widget w)
 	ev.cancel_bubble = TRUE;
 	ev.type = LCUI_WEVENT_UNLINK;
 	Widget_TriggerEvent(w, &ev, NULL);
+	Widget_RemoveFromParentIndex(w);
 	LinkedList_Unlink(&w->parent->children, node);
 	LinkedList_Unlink(&w->parent->children_show, &w->node_show);
 	Widget_PostSurfaceEvent(w, LCUI_WEVENT_UNLINK, TRUE);
@@ -230,6 +235,7 @@ void Widget_DestroyChildren(LCUI_Widget w)
 {
 	/* 先释放显示列表，后销毁部件列表，因为部件在这两个链表中的节点是和它共用
 	 * 一块内存空间的，销毁部件列表会把部件释放掉，所以把这个操作放在后面 */
+	Widget_ClearChildrenIndex(w);
 	LinkedList_ClearData(&w->children_show, NULL);
 	LinkedList_ClearData(&w->children, Widget_OnDestroy);
 }
@@ -309,33 +315,40 @@ size_t Widget_Each(LCUI_Widget w, void (*callback)(LCUI_Widget, void *),
 	return count;
 }
 
+static LCUI_Widget Widget_GetChildAt(LCUI_Widget w, float x, float y)
+{
+	LCUI_Widget c;
+	LinkedListNode *node;
+
+	if (Widget_HasChildrenIndex(w)) {
+		return Widget_QueryChildAt(w, x, y, NULL);
+	}
+	for (LinkedList_Each(node, &w->children_show)) {
+		c = node->data;
+		if (!c->computed_style.visible) {
+			continue;
+		}
+		if (LCUIRect_HasPoint(&c->box.border, x, y)) {
+			return c;
+		}
+	}
+	return NULL;
+}
+
 LCUI_Widget Widget_At(LCUI_Widget widget, int ix, int iy)
 {
 	float x, y;
-	LCUI_BOOL is_hit;
-	LinkedListNode *node;
-	LCUI_Widget target = widget, c = NULL;
+	LCUI_Widget target = widget, c;
 
 	if (!widget) {
 		return NULL;
 	}
 	x = 1.0f * ix;
 	y = 1.0f * iy;
-	do {
-		is_hit = FALSE;
-		for (LinkedList_Each(node, &target->children_show)) {
-			c = node->data;
-			if (!c->computed_style.visible) {
-				continue;
-			}
-			if (LCUIRect_HasPoint(&c->box.border, x, y)) {
-				target = c;
-				x -= c->box.padding.x;
-				y -= c->box.padding.y;
-				is_hit = TRUE;
-				break;
-			}
-		}
-	} while (is_hit);
+	while ((c = Widget_GetChildAt(target, x, y))) {
+		target = c;
+		x -= c->box.padding.x - c->scroll.x;
+		y -= c->box.padding.y - c->scroll.y;
+	}
 	return target == widget ? NULL : target;
 }
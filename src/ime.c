@@ -240,7 +240,7 @@ int LCUIIME_Commit(const wchar_t *str, size_t len)
 		return -ENOMEM;
 	}
 	wcsncpy(sys_ev.text.text, str, len + 1);
-	LCUI_TriggerEvent(&sys_ev, NULL);
+	LCUI_PostEvent(&sys_ev);
 	free(sys_ev.text.text);
 	sys_ev.text.text = NULL;
 	sys_ev.text.length = 0;
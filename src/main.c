@@ -32,6 +32,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <errno.h>
+#include <limits.h>
 #include <string.h>
 #include <LCUI_Build.h>
 #include <LCUI/LCUI.h>
@@ -44,6 +45,7 @@
 #include <LCUI/platform.h>
 #include <LCUI/display.h>
 #include <LCUI/settings.h>
+#include <LCUI/headless.h>
 #ifdef LCUI_EVENTS_H
 #include LCUI_EVENTS_H
 #endif
@@ -57,10 +59,18 @@
 #include LCUI_DISPLAY_H
 #endif
 #include <LCUI/font.h>
+#ifdef LCUI_BUILD_IN_LINUX
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#endif
 
 #define STATE_ACTIVE 1
 #define STATE_KILLED 0
 
+/** 主循环空闲时最多可以等待的文件描述符数量 */
+#define MAX_WATCH_FDS 8
+
 typedef struct LCUI_MainLoopRec_ {
 	int state;       /**< 主循环的状态 */
 	LCUI_Thread tid; /**< 当前运行该主循环的线程的ID */
@@ -80,6 +90,23 @@ typedef struct SysEventPackRec_ {
 	void *arg;
 } SysEventPackRec, *SysEventPack;
 
+/** 输入事件 */
+typedef struct InputEventRec_ {
+	LCUI_SysEventRec event;
+	size_t sample;    /**< 被合并的事件在样本列表中的位置 */
+	size_t n_samples; /**< 被合并的事件数量，为 0 时表示没有合并过事件 */
+} InputEventRec, *InputEvent;
+
+/** 输入事件缓冲区，存放一帧内投递的输入事件 */
+typedef struct InputBufferRec_ {
+	InputEventRec *events;
+	size_t length;
+	size_t capacity;
+	LCUI_SysEventRec *samples; /**< 被合并的事件的样本 */
+	size_t n_samples;
+	size_t samples_capacity;
+} InputBufferRec, *InputBuffer;
+
 /* clang-format off */
 
 /** LCUI 系统相关数据 */
@@ -92,10 +119,15 @@ static struct LCUI_System {
 		LCUI_EventTrigger trigger;	/**< 系统事件容器 */
 		LCUI_Mutex mutex;		/**< 互斥锁 */
 	} event;
+	struct {
+		InputBufferRec pending;		/**< 等待处理的输入事件 */
+		InputBufferRec spare;		/**< 备用的缓冲区，以复用内存 */
+		InputBuffer buffer;		/**< 正在处理的缓冲区 */
+		InputEvent current;		/**< 正在处理的输入事件 */
+		LCUI_Mutex mutex;		/**< 互斥锁 */
+	} input;
 } System;
 
-#define LCUI_WORKER_NUM 4
-
 /** LCUI 应用程序数据 */
 static struct LCUI_App {
 	LCUI_BOOL active;			/**< 是否已经初始化并处于活动状态 */
@@ -107,19 +139,25 @@ static struct LCUI_App {
 	LCUI_AppDriver driver;			/**< 程序事件驱动支持 */
 	LCUI_BOOL driver_ready;			/**< 事件驱动支持是否已经准备就绪 */
 	LCUI_Worker main_worker;		/**< 主工作线程 */
-	LCUI_Worker workers[LCUI_WORKER_NUM];	/**< 普通工作线程 */
-	int worker_next;			/**< 下一个工作线程编号 */
+	LCUI_WorkerPool workers;		/**< 异步任务工作线程池 */
 	LCUI_SettingsRec settings;
 	LCUI_ProfileRec profile;
 	LCUI_FrameProfile frame;
 	int settings_change_handler_id;
+	struct {
+		int fd;				/**< 用于唤醒主循环的 eventfd */
+		int fds[MAX_WATCH_FDS];		/**< 空闲时等待的文件描述符 */
+		size_t n_fds;
+		size_t count;			/**< 主循环被唤醒的次数 */
+		LCUI_BOOL pending;		/**< 当前帧中是否有唤醒请求 */
+	} wakeup;
 } MainApp;
 
 /* clang-format on */
 static void LCUIProfile_Init(LCUI_Profile profile)
 {
 	memset(profile, 0, sizeof(LCUI_ProfileRec));
-	profile->start_time = clock();
+	profile->start_time = LCUI_GetSystemTime();
 }
 
 static void LCUIProfile_Print(LCUI_Profile profile)
@@ -127,8 +165,8 @@ static void LCUIProfile_Print(LCUI_Profile profile)
 	unsigned i;
 	LCUI_FrameProfile frame;
 
-	Logger_Debug("\nframes_count: %zu, time: %ld\n", profile->frames_count,
-		     profile->end_time - profile->start_time);
+	Logger_Debug("\nframes_count: %u, time: %ldms\n", profile->frames_count,
+		     (long)(profile->end_time - profile->start_time));
 	for (i = 0; i < profile->frames_count; ++i) {
 		frame = &profile->frames[i];
 		Logger_Debug("=== frame [%u/%u] ===\n", i + 1,
@@ -141,6 +179,7 @@ static void LCUIProfile_Print(LCUI_Profile profile)
 			     "widget_tasks.update_count: %u\n"
 			     "widget_tasks.refresh_count: %u\n"
 			     "widget_tasks.layout_count: %u\n"
+			     "widget_tasks.layout_cache_hits: %u\n"
 			     "widget_tasks.user_task_count: %u\n"
 			     "widget_tasks.destroy_count: %u\n"
 			     "widget_tasks.destroy_time: %ldms\n",
@@ -148,11 +187,20 @@ static void LCUIProfile_Print(LCUI_Profile profile)
 			     frame->widget_tasks.update_count,
 			     frame->widget_tasks.refresh_count,
 			     frame->widget_tasks.layout_count,
+			     frame->widget_tasks.layout_cache_hits,
 			     frame->widget_tasks.user_task_count,
 			     frame->widget_tasks.destroy_count,
 			     frame->widget_tasks.destroy_time);
 		Logger_Debug("render: %zu, %ldms, %ldms\n", frame->render_count,
 			     frame->render_time, frame->present_time);
+		Logger_Debug("render_pool.hits: %zu\n"
+			     "render_pool.misses: %zu\n",
+			     frame->render_pool_hits,
+			     frame->render_pool_misses);
+		Logger_Debug("dirty: %zu rects, %zu pixels\n"
+			     "painted: %zu rects, %zu pixels\n",
+			     frame->dirty_rects, frame->dirty_area,
+			     frame->painted_rects, frame->painted_area);
 	}
 }
 
@@ -172,8 +220,8 @@ static LCUI_FrameProfile LCUIProfile_BeginFrame(LCUI_Profile profile,
 static void LCUIProfile_EndFrame(LCUI_Profile profile, LCUI_Settings settings)
 {
 	profile->frames_count += 1;
-	profile->end_time = clock();
-	if (profile->end_time - profile->start_time >= CLOCKS_PER_SEC) {
+	profile->end_time = LCUI_GetSystemTime();
+	if (profile->end_time - profile->start_time >= 1000) {
 		if (profile->frames_count < (unsigned)settings->frame_rate_cap / 4) {
 			LCUIProfile_Print(profile);
 		}
@@ -190,46 +238,92 @@ static void OnSettingsChangeEvent(LCUI_SysEvent e, void *arg)
 
 void LCUI_RunFrameWithProfile(LCUI_FrameProfile profile)
 {
-	profile->timers_time = clock();
+	int64_t time;
+	LCUI_GraphPoolStatsRec pool_stats;
+	LCUI_RegionStatsRec region_stats;
+
+	LCUITrace_Begin("frame");
+	LCUITrace_Begin("timers");
+	time = LCUI_GetSystemTime();
 	profile->timers_count = LCUI_ProcessTimers();
-	profile->timers_time = clock() - profile->timers_time;
+	profile->timers_time = (clock_t)(LCUI_GetSystemTime() - time);
+	LCUITrace_End();
 
-	profile->events_time = clock();
+	LCUITrace_Begin("events");
+	time = LCUI_GetSystemTime();
 	profile->events_count = LCUI_ProcessEvents();
-	profile->events_time = clock() - profile->events_time;
+	profile->events_time = (clock_t)(LCUI_GetSystemTime() - time);
+	LCUITrace_End();
 
 	LCUICursor_Update();
+	LCUITrace_Begin("widgets");
 	LCUIWidget_UpdateWithProfile(&profile->widget_tasks);
+	LCUITrace_End();
 
-	profile->render_time = clock();
+	LCUITrace_Begin("render");
+	LCUIWidget_GetRendererStats(&pool_stats);
+	profile->render_pool_hits = pool_stats.hits;
+	profile->render_pool_misses = pool_stats.misses;
+	time = LCUI_GetSystemTime();
 	LCUIDisplay_Update();
 	profile->render_count = LCUIDisplay_Render();
-	profile->render_time = clock() - profile->render_time;
-
-	profile->present_time = clock();
+	profile->render_time = (clock_t)(LCUI_GetSystemTime() - time);
+	LCUIWidget_GetRendererStats(&pool_stats);
+	profile->render_pool_hits = pool_stats.hits - profile->render_pool_hits;
+	profile->render_pool_misses =
+	    pool_stats.misses - profile->render_pool_misses;
+	LCUIDisplay_GetRegionStats(&region_stats);
+	profile->dirty_rects = region_stats.added_rects;
+	profile->dirty_area = region_stats.added_area;
+	profile->painted_rects = region_stats.rects;
+	profile->painted_area = region_stats.area;
+	LCUITrace_End();
+
+	LCUITrace_Begin("present");
+	time = LCUI_GetSystemTime();
 	LCUIDisplay_Present();
-	profile->present_time = clock() - profile->present_time;
+	profile->present_time = (clock_t)(LCUI_GetSystemTime() - time);
+	LCUITrace_End();
+	LCUITrace_End();
 }
 
 void LCUI_RunFrame(void)
 {
+	LCUITrace_Begin("frame");
+	LCUITrace_Begin("timers");
 	LCUI_ProcessTimers();
+	LCUITrace_End();
+	LCUITrace_Begin("events");
 	LCUI_ProcessEvents();
+	LCUITrace_End();
 	LCUICursor_Update();
+	LCUITrace_Begin("widgets");
 	LCUIWidget_Update();
+	LCUITrace_End();
+	LCUITrace_Begin("render");
 	LCUIDisplay_Update();
 	LCUIDisplay_Render();
+	LCUITrace_End();
+	LCUITrace_Begin("present");
 	LCUIDisplay_Present();
+	LCUITrace_End();
+	LCUITrace_End();
 }
 
 static void LCUI_InitEvent(void)
 {
 	LCUIMutex_Init(&System.event.mutex);
+	LCUIMutex_Init(&System.input.mutex);
 	System.event.trigger = EventTrigger();
 }
 
+static void InputBuffer_Destroy(InputBuffer buf);
+
 static void LCUI_FreeEvent(void)
 {
+	InputBuffer_Destroy(&System.input.pending);
+	InputBuffer_Destroy(&System.input.spare);
+	LCUIMutex_Destroy(&System.input.mutex);
 	LCUIMutex_Destroy(&System.event.mutex);
 	EventTrigger_Destroy(System.event.trigger);
 	System.event.trigger = NULL;
@@ -335,16 +429,275 @@ void LCUI_DestroyEvent(LCUI_SysEvent e)
 	e->type = LCUI_NONE;
 }
 
+static int CopySysEvent(LCUI_SysEvent dst, const LCUI_SysEvent src)
+{
+	size_t size;
+
+	*dst = *src;
+	switch (src->type) {
+	case LCUI_TOUCH:
+		if (src->touch.n_points <= 0) {
+			dst->touch.points = NULL;
+			break;
+		}
+		size = sizeof(LCUI_TouchPointRec) * src->touch.n_points;
+		dst->touch.points = malloc(size);
+		if (!dst->touch.points) {
+			return -ENOMEM;
+		}
+		memcpy(dst->touch.points, src->touch.points, size);
+		break;
+	case LCUI_TEXTINPUT:
+		if (!src->text.text) {
+			break;
+		}
+		dst->text.text = NEW(wchar_t, src->text.length + 1);
+		if (!dst->text.text) {
+			return -ENOMEM;
+		}
+		wcsncpy(dst->text.text, src->text.text, src->text.length + 1);
+		break;
+	default:
+		break;
+	}
+	return 0;
+}
+
+static void InputBuffer_Clear(InputBuffer buf)
+{
+	size_t i;
+
+	for (i = 0; i < buf->length; ++i) {
+		LCUI_DestroyEvent(&buf->events[i].event);
+	}
+	for (i = 0; i < buf->n_samples; ++i) {
+		LCUI_DestroyEvent(&buf->samples[i]);
+	}
+	buf->length = 0;
+	buf->n_samples = 0;
+}
+
+static void InputBuffer_Destroy(InputBuffer buf)
+{
+	InputBuffer_Clear(buf);
+	free(buf->events);
+	free(buf->samples);
+	memset(buf, 0, sizeof(InputBufferRec));
+}
+
+static int InputBuffer_AddSample(InputBuffer buf, const LCUI_SysEvent e)
+{
+	size_t capacity;
+	LCUI_SysEventRec *samples;
+
+	if (buf->n_samples >= buf->samples_capacity) {
+		capacity = max(64, buf->samples_capacity * 2);
+		samples = realloc(buf->samples,
+				  sizeof(LCUI_SysEventRec) * capacity);
+		if (!samples) {
+			return -ENOMEM;
+		}
+		buf->samples = samples;
+		buf->samples_capacity = capacity;
+	}
+	if (CopySysEvent(&buf->samples[buf->n_samples], e) != 0) {
+		return -ENOMEM;
+	}
+	buf->n_samples += 1;
+	return 0;
+}
+
+static int InputBuffer_Add(InputBuffer buf, const LCUI_SysEvent e)
+{
+	size_t capacity;
+	InputEventRec *events;
+
+	if (buf->length >= buf->capacity) {
+		capacity = max(32, buf->capacity * 2);
+		events = realloc(buf->events, sizeof(InputEventRec) * capacity);
+		if (!events) {
+			return -ENOMEM;
+		}
+		buf->events = events;
+		buf->capacity = capacity;
+	}
+	if (CopySysEvent(&buf->events[buf->length].event, e) != 0) {
+		return -ENOMEM;
+	}
+	buf->events[buf->length].sample = 0;
+	buf->events[buf->length].n_samples = 0;
+	buf->length += 1;
+	return 0;
+}
+
+/**
+ * 判断事件能否合并到上一个事件中
+ * 只合并连续的鼠标移动事件，以及触点相同且都处于移动状态的触控事件
+ */
+static LCUI_BOOL CanCoalesceEvent(LCUI_SysEvent prev, LCUI_SysEvent e)
+{
+	int i;
+
+	if (prev->type != e->type) {
+		return FALSE;
+	}
+	switch (e->type) {
+	case LCUI_MOUSEMOVE:
+		return TRUE;
+	case LCUI_TOUCH:
+		if (prev->touch.n_points != e->touch.n_points) {
+			return FALSE;
+		}
+		for (i = 0; i < e->touch.n_points; ++i) {
+			if (prev->touch.points[i].id != e->touch.points[i].id ||
+			    prev->touch.points[i].state != LCUI_TOUCHMOVE ||
+			    e->touch.points[i].state != LCUI_TOUCHMOVE) {
+				return FALSE;
+			}
+		}
+		return TRUE;
+	default:
+		break;
+	}
+	return FALSE;
+}
+
+/** 将事件合并到最后一个输入事件中，被合并的事件都会作为样本保留 */
+static int InputBuffer_Coalesce(InputBuffer buf, const LCUI_SysEvent e)
+{
+	LCUI_SysEventRec ev;
+	InputEvent last = &buf->events[buf->length - 1];
+
+	if (last->n_samples == 0) {
+		last->sample = buf->n_samples;
+		if (InputBuffer_AddSample(buf, &last->event) != 0) {
+			return -ENOMEM;
+		}
+		last->n_samples = 1;
+	}
+	if (InputBuffer_AddSample(buf, e) != 0) {
+		return -ENOMEM;
+	}
+	last->n_samples += 1;
+	if (e->type == LCUI_MOUSEMOVE) {
+		last->event.motion.x = e->motion.x;
+		last->event.motion.y = e->motion.y;
+		last->event.motion.xrel += e->motion.xrel;
+		last->event.motion.yrel += e->motion.yrel;
+		return 0;
+	}
+	if (CopySysEvent(&ev, e) != 0) {
+		return -ENOMEM;
+	}
+	LCUI_DestroyEvent(&last->event);
+	last->event = ev;
+	return 0;
+}
+
+int LCUI_PostEvent(LCUI_SysEvent e)
+{
+	int ret;
+	InputEvent current;
+	InputBuffer buf = &System.input.pending;
+
+	if (System.state != STATE_ACTIVE) {
+		return -1;
+	}
+	/*
+	 * 在处理输入事件时产生的事件需要立即处理，例如输入法在处理按键事件时
+	 * 提交的文本，否则它会被排到后面的按键事件之后
+	 */
+	if (LCUI_IsOnMainLoop() && System.input.buffer) {
+		current = System.input.current;
+		System.input.current = NULL;
+		ret = LCUI_TriggerEvent(e, NULL);
+		System.input.current = current;
+		return ret < 0 ? ret : 0;
+	}
+	LCUIMutex_Lock(&System.input.mutex);
+	if (buf->length > 0 &&
+	    CanCoalesceEvent(&buf->events[buf->length - 1].event, e)) {
+		ret = InputBuffer_Coalesce(buf, e);
+	} else {
+		ret = InputBuffer_Add(buf, e);
+	}
+	LCUIMutex_Unlock(&System.input.mutex);
+	LCUI_WakeUp();
+	return ret;
+}
+
+size_t LCUI_GetCoalescedEvents(LCUI_SysEvent *events)
+{
+	InputEvent e = System.input.current;
+
+	if (!e) {
+		*events = NULL;
+		return 0;
+	}
+	if (e->n_samples == 0) {
+		*events = &e->event;
+		return 1;
+	}
+	*events = &System.input.buffer->samples[e->sample];
+	return e->n_samples;
+}
+
+/** 处理这一帧内投递的所有输入事件 */
+static size_t LCUI_DispatchInputEvents(void)
+{
+	size_t i;
+	InputEvent current;
+	InputBuffer buffer;
+	InputBufferRec buf;
+
+	LCUIMutex_Lock(&System.input.mutex);
+	if (System.input.pending.length == 0) {
+		LCUIMutex_Unlock(&System.input.mutex);
+		return 0;
+	}
+	buf = System.input.pending;
+	System.input.pending = System.input.spare;
+	memset(&System.input.spare, 0, sizeof(InputBufferRec));
+	LCUIMutex_Unlock(&System.input.mutex);
+
+	/* 事件处理器可能会运行嵌套的主循环，所以需要保存当前的状态 */
+	current = System.input.current;
+	buffer = System.input.buffer;
+	System.input.buffer = &buf;
+	for (i = 0; i < buf.length; ++i) {
+		System.input.current = &buf.events[i];
+		LCUI_TriggerEvent(&buf.events[i].event, NULL);
+	}
+	System.input.current = current;
+	System.input.buffer = buffer;
+	InputBuffer_Clear(&buf);
+
+	LCUIMutex_Lock(&System.input.mutex);
+	if (System.input.spare.capacity == 0) {
+		System.input.spare = buf;
+	} else {
+		InputBuffer_Destroy(&buf);
+	}
+	LCUIMutex_Unlock(&System.input.mutex);
+	return i;
+}
+
 size_t LCUI_ProcessEvents(void)
 {
-	size_t count = 0;
+	size_t n, count = 0;
 
 	if (MainApp.driver_ready) {
 		MainApp.driver->ProcessEvents();
 	}
-	while (LCUIWorker_RunTask(MainApp.main_worker)) {
-		++count;
-	}
+	count = LCUI_DispatchInputEvents();
+	/* 任务和部件事件可能会互相产生新的任务和事件，直到都处理完为止 */
+	do {
+		n = LCUIWidget_ProcessEvents();
+		while (LCUIWorker_RunTask(MainApp.main_worker)) {
+			++n;
+		}
+		count += n;
+	} while (n > 0);
 	return count;
 }
 
@@ -359,28 +712,142 @@ LCUI_BOOL LCUI_PostTask(LCUI_Task task)
 
 void LCUI_PostAsyncTaskTo(LCUI_Task task, int worker_id)
 {
-	int id = 0;
 	if (!MainApp.active) {
 		LCUITask_Run(task);
 		LCUITask_Destroy(task);
 		return;
 	}
-	if (id >= LCUI_WORKER_NUM) {
-		id = 0;
-	}
-	LCUIWorker_PostTask(MainApp.workers[id], task);
+	LCUIWorkerPool_PostTaskTo(MainApp.workers, task, worker_id);
 }
 
 int LCUI_PostAsyncTask(LCUI_Task task)
 {
-	int id;
-	if (MainApp.worker_next >= LCUI_WORKER_NUM) {
-		MainApp.worker_next = 0;
+	if (!MainApp.active) {
+		LCUITask_Run(task);
+		LCUITask_Destroy(task);
+		return 0;
+	}
+	return LCUIWorkerPool_PostTask(MainApp.workers, task,
+				       LCUI_TASK_PRIORITY_DEFAULT);
+}
+
+LCUI_AsyncTask LCUI_PostAsyncTaskEx(LCUI_Task task, LCUI_TaskPriority priority,
+				    LCUI_AsyncTaskCallback callback,
+				    void *callback_arg)
+{
+	if (!MainApp.active) {
+		LCUITask_Destroy(task);
+		return NULL;
 	}
-	id = MainApp.worker_next;
-	LCUI_PostAsyncTaskTo(task, id);
-	MainApp.worker_next += 1;
-	return id;
+	return LCUIWorkerPool_PostAsyncTask(MainApp.workers, task, priority,
+					    callback, callback_arg);
+}
+
+void LCUI_WakeUp(void)
+{
+#ifdef LCUI_BUILD_IN_LINUX
+	uint64_t value = 1;
+#endif
+
+	if (!MainApp.loop) {
+		return;
+	}
+	/* 主循环正在运行当前帧，只需要让它在这一帧结束后不进入等待 */
+	if (LCUI_IsOnMainLoop()) {
+		MainApp.wakeup.pending = TRUE;
+		return;
+	}
+#ifdef LCUI_BUILD_IN_LINUX
+	if (MainApp.wakeup.fd >= 0 &&
+	    write(MainApp.wakeup.fd, &value, sizeof(value)) < 0) {
+		DEBUG_MSG("wake up main loop failed, errno: %d\n", errno);
+	}
+#endif
+}
+
+size_t LCUI_GetWakeupCount(void)
+{
+	return MainApp.wakeup.count;
+}
+
+int LCUI_WatchFd(int fd)
+{
+	if (MainApp.wakeup.n_fds >= MAX_WATCH_FDS) {
+		return -1;
+	}
+	MainApp.wakeup.fds[MainApp.wakeup.n_fds++] = fd;
+	return 0;
+}
+
+int LCUI_UnwatchFd(int fd)
+{
+	size_t i;
+
+	for (i = 0; i < MainApp.wakeup.n_fds; ++i) {
+		if (MainApp.wakeup.fds[i] == fd) {
+			MainApp.wakeup.n_fds -= 1;
+			MainApp.wakeup.fds[i] =
+			    MainApp.wakeup.fds[MainApp.wakeup.n_fds];
+			return 0;
+		}
+	}
+	return -1;
+}
+
+/**
+ * 检测主循环是否空闲
+ * 空闲时没有待处理的事件和任务，也没有需要更新的部件和需要重绘的区域，在下次
+ * 被唤醒前运行的帧都不会有任何改变
+ */
+static LCUI_BOOL LCUIMainLoop_IsIdle(void)
+{
+	if (MainApp.wakeup.pending || LCUIDisplay_NeedUpdate()) {
+		return FALSE;
+	}
+	if (MainApp.driver->HasPendingEvents) {
+		return !MainApp.driver->HasPendingEvents();
+	}
+	return TRUE;
+}
+
+/** 在主循环空闲时阻塞等待，直到有输入、新任务或定时器到期 */
+static void LCUIMainLoop_Wait(LCUI_MainLoop loop)
+{
+#ifdef LCUI_BUILD_IN_LINUX
+	size_t i;
+	int timeout;
+	int64_t delay;
+	uint64_t value;
+	struct pollfd fds[MAX_WATCH_FDS + 1];
+
+	if (MainApp.wakeup.fd < 0 || !MainApp.driver_ready ||
+	    MainApp.loop != loop || loop->state == STATE_EXITED) {
+		return;
+	}
+	if (!LCUIMainLoop_IsIdle()) {
+		MainApp.wakeup.pending = FALSE;
+		return;
+	}
+	delay = LCUI_GetNextTimerDelay();
+	if (delay == 0) {
+		return;
+	}
+	timeout = delay < 0 ? -1 : (int)min(delay, INT_MAX);
+	fds[0].fd = MainApp.wakeup.fd;
+	fds[0].events = POLLIN;
+	for (i = 0; i < MainApp.wakeup.n_fds; ++i) {
+		fds[i + 1].fd = MainApp.wakeup.fds[i];
+		fds[i + 1].events = POLLIN;
+	}
+	LCUITrace_Begin("idle");
+	if (poll(fds, MainApp.wakeup.n_fds + 1, timeout) > 0 &&
+	    (fds[0].revents & POLLIN)) {
+		if (read(MainApp.wakeup.fd, &value, sizeof(value)) < 0) {
+			DEBUG_MSG("read eventfd failed, errno: %d\n", errno);
+		}
+	}
+	LCUITrace_End();
+#endif
 }
 
 /* 新建一个主循环 */
@@ -417,6 +884,7 @@ int LCUIMainLoop_Run(LCUI_MainLoop loop)
 	DEBUG_MSG("loop: %p, enter\n", loop);
 	MainApp.loop = loop;
 	while (loop->state != STATE_EXITED) {
+		MainApp.wakeup.count += 1;
 		if (MainApp.settings.record_profile) {
 			MainApp.frame = LCUIProfile_BeginFrame(
 			    &MainApp.profile, &MainApp.settings);
@@ -427,6 +895,11 @@ int LCUIMainLoop_Run(LCUI_MainLoop loop)
 			LCUI_RunFrame();
 		}
 
+		/*
+		 * 空闲时先等待事件，被唤醒后仍需遵守帧率限制，以免频繁的输入和
+		 * 定时器让帧率超出上限
+		 */
+		LCUIMainLoop_Wait(loop);
 		StepTimer_Remain(MainApp.timer);
 		/* 如果当前运行的主循环不是自己 */
 		while (MainApp.loop != loop) {
@@ -450,6 +923,7 @@ int LCUIMainLoop_Run(LCUI_MainLoop loop)
 void LCUIMainLoop_Quit(LCUI_MainLoop loop)
 {
 	loop->state = STATE_EXITED;
+	LCUI_WakeUp();
 }
 
 void LCUIMainLoop_Destroy(LCUI_MainLoop loop)
@@ -464,7 +938,6 @@ int LCUI_GetFrameCount(void)
 
 void LCUI_InitApp(LCUI_AppDriver app)
 {
-	int i;
 	if (MainApp.driver_ready) {
 		return;
 	}
@@ -479,13 +952,27 @@ void LCUI_InitApp(LCUI_AppDriver app)
 	    LCUI_SETTINGS_CHANGE, OnSettingsChangeEvent, NULL, NULL);
 	Settings_Init(&MainApp.settings);
 	MainApp.main_worker = LCUIWorker_New();
-	for (i = 0; i < LCUI_WORKER_NUM; ++i) {
-		MainApp.workers[i] = LCUIWorker_New();
-		LCUIWorker_RunAsync(MainApp.workers[i]);
+	LCUIWorker_SetNotifier(MainApp.main_worker, LCUI_WakeUp);
+	MainApp.wakeup.n_fds = 0;
+	MainApp.wakeup.pending = FALSE;
+#ifdef LCUI_BUILD_IN_LINUX
+	MainApp.wakeup.fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#else
+	MainApp.wakeup.fd = -1;
+#endif
+	MainApp.workers = LCUIWorkerPool_New(0);
+	if (!MainApp.workers) {
+		Logger_Error("[main] failed to start the worker pool\n");
+		return;
 	}
+	LCUIWorkerPool_SetCallbackWorker(MainApp.workers, MainApp.main_worker);
 	StepTimer_SetFrameLimit(MainApp.timer, MainApp.settings.frame_rate_cap);
 	if (!app) {
-		app = LCUI_CreateAppDriver();
+		if (LCUIHeadless_IsEnabled()) {
+			app = LCUI_CreateHeadlessAppDriver();
+		} else {
+			app = LCUI_CreateAppDriver();
+		}
 		if (!app) {
 			return;
 		}
@@ -510,7 +997,6 @@ static void OnDeleteMainLoop(void *arg)
 
 static void LCUI_FreeApp(void)
 {
-	int i;
 	LCUI_MainLoop loop;
 	LinkedListNode *node;
 	MainApp.active = FALSE;
@@ -526,15 +1012,24 @@ static void LCUI_FreeApp(void)
 	LCUICond_Destroy(&MainApp.loop_changed);
 	LinkedList_Clear(&MainApp.loops, OnDeleteMainLoop);
 	if (MainApp.driver_ready) {
-		LCUI_DestroyAppDriver(MainApp.driver);
+		if (MainApp.driver->id == LCUI_APP_HEADLESS) {
+			LCUI_DestroyHeadlessAppDriver(MainApp.driver);
+		} else {
+			LCUI_DestroyAppDriver(MainApp.driver);
+		}
 	}
 	MainApp.driver_ready = FALSE;
-	for (i = 0; i < LCUI_WORKER_NUM; ++i) {
-		LCUIWorker_Destroy(MainApp.workers[i]);
-		MainApp.workers[i] = NULL;
-	}
+	LCUIWorkerPool_Destroy(MainApp.workers);
+	MainApp.workers = NULL;
 	LCUIWorker_Destroy(MainApp.main_worker);
 	MainApp.main_worker = NULL;
+#ifdef LCUI_BUILD_IN_LINUX
+	if (MainApp.wakeup.fd >= 0) {
+		close(MainApp.wakeup.fd);
+	}
+#endif
+	MainApp.wakeup.fd = -1;
+	MainApp.wakeup.n_fds = 0;
 }
 
 int LCUI_BindSysEvent(int event_id, LCUI_EventFunc func, void *data,
@@ -573,6 +1068,7 @@ static void LCUIApp_QuitAllMainLoop(void)
 			loop->state = STATE_EXITED;
 		}
 	}
+	LCUI_WakeUp();
 }
 
 static void LCUI_ShowCopyrightText(void)
@@ -617,8 +1113,9 @@ LCUI_BOOL LCUI_IsActive(void)
 
 LCUI_BOOL LCUI_IsOnMainLoop(void)
 {
+	/* 主循环未运行时，以初始化 LCUI 的线程作为主线程 */
 	if (!MainApp.loop) {
-		return FALSE;
+		return System.thread == LCUIThread_SelfID();
 	}
 	return (MainApp.loop->tid == LCUIThread_SelfID());
 }
@@ -649,11 +1146,13 @@ void LCUI_InitBase(void)
 	System.exit_code = 0;
 	System.state = STATE_ACTIVE;
 	System.thread = LCUIThread_SelfID();
+	LCUITrace_SetThreadName("main");
 	LCUI_ShowCopyrightText();
 	LCUI_InitEvent();
 	LCUI_InitFontLibrary();
 	LCUI_InitTimer();
 	LCUI_InitCursor();
+	LCUI_InitBoxShadow();
 	LCUI_InitWidget();
 	LCUI_InitMetrics();
 }
@@ -663,8 +1162,10 @@ void LCUI_Init(void)
 	LCUI_InitBase();
 	LCUI_InitApp(NULL);
 	LCUI_InitDisplay(NULL);
-	LCUI_InitMouseDriver();
-	LCUI_InitKeyboardDriver();
+	if (LCUI_GetAppId() != LCUI_APP_HEADLESS) {
+		LCUI_InitMouseDriver();
+		LCUI_InitKeyboardDriver();
+	}
 	LCUI_InitKeyboard();
 	LCUI_InitIME();
 
@@ -672,6 +1173,7 @@ void LCUI_Init(void)
 	case LCUI_APP_LINUX_X11:
 	case LCUI_APP_UWP:
 	case LCUI_APP_WINDOWS:
+	case LCUI_APP_HEADLESS:
 		LCUICursor_Hide();
 		break;
 	default:
@@ -691,17 +1193,21 @@ int LCUI_Destroy(void)
 	LCUI_TriggerEvent(&e, NULL);
 	System.state = STATE_KILLED;
 	LCUI_FreeDisplay();
-	LCUI_FreeMouseDriver();
-	LCUI_FreeKeyboardDriver();
+	if (LCUI_GetAppId() != LCUI_APP_HEADLESS) {
+		LCUI_FreeMouseDriver();
+		LCUI_FreeKeyboardDriver();
+	}
 	LCUI_FreeApp();
 	LCUI_FreeIME();
 	LCUI_FreeKeyboard();
 	LCUI_FreeWidget();
+	LCUI_FreeBoxShadow();
 	LCUI_FreeCursor();
 	LCUI_FreeFontLibrary();
 	LCUI_FreeTimer();
 	LCUI_FreeEvent();
 	LCUI_FreeMetrics();
+	LCUITrace_Free();
 	return System.exit_code;
 }
 
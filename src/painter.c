@@ -27,13 +27,78 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <errno.h>
 #include <stdlib.h>
+#include <string.h>
 #include <LCUI_Build.h>
 #include <LCUI/types.h>
+#include <LCUI/util.h>
 #include <LCUI/graph.h>
+#include <LCUI/thread.h>
 #include <LCUI/gui/metrics.h>
 #include <LCUI/painter.h>
 
+#ifdef _MSC_VER
+#include <windows.h>
+#define AtomicLoad(PTR) InterlockedCompareExchange64((volatile LONG64 *)PTR, 0, 0)
+#define AtomicCompareExchange(PTR, OLD, NEW)                                  \
+	(InterlockedCompareExchange64((volatile LONG64 *)PTR, (LONG64)NEW, \
+				      (LONG64)OLD) == (LONG64)OLD)
+#else
+#define AtomicLoad(PTR) __atomic_load_n(PTR, __ATOMIC_ACQUIRE)
+#define AtomicCompareExchange(PTR, OLD, NEW) \
+	__sync_bool_compare_and_swap(PTR, OLD, NEW)
+#endif
+
+/* pack the range [begin, end) of a tile queue into an integer, so that the
+ * owner and the thieves can update it with a single atomic operation */
+#define TileRange(BEGIN, END) (((uint64_t)(BEGIN) << 32) | (uint32_t)(END))
+#define TileRangeBegin(RANGE) ((int)((RANGE) >> 32))
+#define TileRangeEnd(RANGE) ((int)((RANGE)&0xffffffff))
+
+/** 渲染线程的分块队列 */
+typedef struct LCUI_TileQueueRec_ {
+	volatile uint64_t range;
+	/* avoid false sharing between the queues of different threads */
+	char padding[56];
+} LCUI_TileQueueRec, *LCUI_TileQueue;
+
+typedef struct LCUI_TileWorkerRec_ {
+	int index;
+	LCUI_Thread thread;
+	LCUI_TileRenderer renderer;
+} LCUI_TileWorkerRec, *LCUI_TileWorker;
+
+typedef struct LCUI_TileRendererRec_ {
+	LCUI_BOOL active;
+	int num_threads;
+	LCUI_TileQueue queues;
+	LCUI_TileWorker workers;
+
+	/** the number of the started frames, used to wake up workers */
+	unsigned frame;
+
+	/** the number of workers still rendering the current frame */
+	int running;
+	size_t count;
+	LCUI_Cond cond;
+	LCUI_Cond done;
+	LCUI_Mutex mutex;
+
+	/* context of the current frame */
+	LCUI_Graph *canvas;
+	LCUI_TilePainter painter;
+	void *arg;
+
+	/** the dirty rectangle of each tile */
+	LCUI_Rect *grid;
+	size_t grid_size;
+
+	/** dirty tiles to be rendered */
+	LCUI_Rect *jobs;
+	int num_jobs;
+} LCUI_TileRendererRec;
+
 LCUI_PaintContext LCUIPainter_Begin(LCUI_Graph *canvas, LCUI_Rect *rect)
 {
 	ASSIGN(paint, LCUI_PaintContext);
@@ -48,3 +113,290 @@ void LCUIPainter_End(LCUI_PaintContext paint)
 {
 	free(paint);
 }
+
+/** 从队列头部取出一个分块，仅由队列所属的线程调用 */
+static int TileQueue_Pop(LCUI_TileQueue queue)
+{
+	int begin, end;
+	uint64_t range;
+
+	do {
+		range = AtomicLoad(&queue->range);
+		begin = TileRangeBegin(range);
+		end = TileRangeEnd(range);
+		if (begin >= end) {
+			return -1;
+		}
+	} while (!AtomicCompareExchange(&queue->range, range,
+					TileRange(begin + 1, end)));
+	return begin;
+}
+
+/** 从队列尾部窃取一个分块 */
+static int TileQueue_Steal(LCUI_TileQueue queue)
+{
+	int begin, end;
+	uint64_t range;
+
+	do {
+		range = AtomicLoad(&queue->range);
+		begin = TileRangeBegin(range);
+		end = TileRangeEnd(range);
+		if (begin >= end) {
+			return -1;
+		}
+	} while (!AtomicCompareExchange(&queue->range, range,
+					TileRange(begin, end - 1)));
+	return end - 1;
+}
+
+static size_t TileRenderer_RenderTile(LCUI_TileRenderer renderer, int job)
+{
+	LCUI_PaintContextRec paint;
+
+	paint.rect = renderer->jobs[job];
+	paint.with_alpha = FALSE;
+	Graph_Init(&paint.canvas);
+	Graph_Quote(&paint.canvas, renderer->canvas, &paint.rect);
+	return renderer->painter(&paint, renderer->arg);
+}
+
+static size_t TileRenderer_RunJobs(LCUI_TileRenderer renderer, int index)
+{
+	int i, job;
+	size_t count = 0;
+	LCUI_TileQueue queue;
+
+	LCUITrace_Begin("render tiles");
+	queue = &renderer->queues[index];
+	while ((job = TileQueue_Pop(queue)) >= 0) {
+		count += TileRenderer_RenderTile(renderer, job);
+	}
+	for (i = 1; i < renderer->num_threads; ++i) {
+		queue = &renderer->queues[(index + i) % renderer->num_threads];
+		while ((job = TileQueue_Steal(queue)) >= 0) {
+			count += TileRenderer_RenderTile(renderer, job);
+		}
+	}
+	LCUITrace_End();
+	return count;
+}
+
+static void TileRenderer_Thread(void *arg)
+{
+	size_t count;
+	unsigned frame = 0;
+	LCUI_TileWorker worker = arg;
+	LCUI_TileRenderer renderer = worker->renderer;
+
+	LCUITrace_SetThreadName("renderer");
+	LCUIMutex_Lock(&renderer->mutex);
+	while (renderer->active) {
+		if (renderer->frame == frame) {
+			LCUICond_Wait(&renderer->cond, &renderer->mutex);
+			continue;
+		}
+		frame = renderer->frame;
+		LCUIMutex_Unlock(&renderer->mutex);
+		count = TileRenderer_RunJobs(renderer, worker->index);
+		LCUIMutex_Lock(&renderer->mutex);
+		renderer->count += count;
+		renderer->running -= 1;
+		if (renderer->running == 0) {
+			LCUICond_Signal(&renderer->done);
+		}
+	}
+	LCUIMutex_Unlock(&renderer->mutex);
+	LCUIThread_Exit(NULL);
+}
+
+LCUI_TileRenderer TileRenderer_Create(int num_threads)
+{
+	int i;
+	LCUI_TileRenderer renderer;
+
+	renderer = malloc(sizeof(LCUI_TileRendererRec));
+	if (!renderer) {
+		return NULL;
+	}
+	num_threads = max(1, num_threads);
+	renderer->active = TRUE;
+	renderer->frame = 0;
+	renderer->running = 0;
+	renderer->count = 0;
+	renderer->grid = NULL;
+	renderer->grid_size = 0;
+	renderer->jobs = NULL;
+	renderer->num_jobs = 0;
+	renderer->num_threads = num_threads;
+	renderer->queues = calloc(num_threads, sizeof(LCUI_TileQueueRec));
+	renderer->workers = calloc(num_threads, sizeof(LCUI_TileWorkerRec));
+	if (!renderer->queues || !renderer->workers) {
+		free(renderer->queues);
+		free(renderer->workers);
+		free(renderer);
+		return NULL;
+	}
+	LCUICond_Init(&renderer->cond);
+	LCUICond_Init(&renderer->done);
+	LCUIMutex_Init(&renderer->mutex);
+	/* the first worker is the thread calling TileRenderer_Render() */
+	for (i = 0; i < num_threads; ++i) {
+		renderer->workers[i].index = i;
+		renderer->workers[i].renderer = renderer;
+		if (i > 0 && LCUIThread_Create(&renderer->workers[i].thread,
+					       TileRenderer_Thread,
+					       &renderer->workers[i]) != 0) {
+			/* render with the threads that have been started */
+			Logger_Warning("[renderer] started %d/%d threads\n",
+				       i, num_threads);
+			renderer->num_threads = i;
+			break;
+		}
+	}
+	return renderer;
+}
+
+void TileRenderer_Destroy(LCUI_TileRenderer renderer)
+{
+	int i;
+
+	if (!renderer) {
+		return;
+	}
+	LCUIMutex_Lock(&renderer->mutex);
+	renderer->active = FALSE;
+	LCUICond_Broadcast(&renderer->cond);
+	LCUIMutex_Unlock(&renderer->mutex);
+	for (i = 1; i < renderer->num_threads; ++i) {
+		LCUIThread_Join(renderer->workers[i].thread, NULL);
+	}
+	LCUICond_Destroy(&renderer->cond);
+	LCUICond_Destroy(&renderer->done);
+	LCUIMutex_Destroy(&renderer->mutex);
+	free(renderer->workers);
+	free(renderer->queues);
+	free(renderer->grid);
+	free(renderer->jobs);
+	free(renderer);
+}
+
+int TileRenderer_GetThreads(LCUI_TileRenderer renderer)
+{
+	return renderer->num_threads;
+}
+
+/** 将脏矩形划分到各个分块中，得出需要绘制的分块 */
+static int TileRenderer_CollectJobs(LCUI_TileRenderer renderer,
+				    const LCUI_Region region)
+{
+	int x, y, i;
+	int cols, rows;
+	size_t size;
+
+	LCUI_Rect rect, tile, *dirty;
+
+	cols = (renderer->canvas->width + LCUI_TILE_SIZE - 1) / LCUI_TILE_SIZE;
+	rows = (renderer->canvas->height + LCUI_TILE_SIZE - 1) / LCUI_TILE_SIZE;
+	size = (size_t)cols * rows;
+	if (size > renderer->grid_size) {
+		free(renderer->grid);
+		free(renderer->jobs);
+		renderer->grid = malloc(sizeof(LCUI_Rect) * size);
+		renderer->jobs = malloc(sizeof(LCUI_Rect) * size);
+		if (!renderer->grid || !renderer->jobs) {
+			renderer->grid_size = 0;
+			return -ENOMEM;
+		}
+		renderer->grid_size = size;
+	}
+	memset(renderer->grid, 0, sizeof(LCUI_Rect) * size);
+	for (i = 0; i < region->length; ++i) {
+		rect = region->rects[i];
+		LCUIRect_ValidateArea(&rect, renderer->canvas->width,
+				      renderer->canvas->height);
+		if (rect.width < 1 || rect.height < 1) {
+			continue;
+		}
+		for (y = rect.y / LCUI_TILE_SIZE;
+		     y <= (rect.y + rect.height - 1) / LCUI_TILE_SIZE; ++y) {
+			for (x = rect.x / LCUI_TILE_SIZE;
+			     x <= (rect.x + rect.width - 1) / LCUI_TILE_SIZE;
+			     ++x) {
+				tile.x = x * LCUI_TILE_SIZE;
+				tile.y = y * LCUI_TILE_SIZE;
+				tile.width = LCUI_TILE_SIZE;
+				tile.height = LCUI_TILE_SIZE;
+				LCUIRect_GetOverlayRect(&tile, &rect, &tile);
+				dirty = &renderer->grid[y * cols + x];
+				if (dirty->width > 0) {
+					LCUIRect_MergeRect(dirty, dirty, &tile);
+				} else {
+					*dirty = tile;
+				}
+			}
+		}
+	}
+	renderer->num_jobs = 0;
+	for (i = 0; i < (int)size; ++i) {
+		if (renderer->grid[i].width > 0) {
+			renderer->jobs[renderer->num_jobs++] =
+			    renderer->grid[i];
+		}
+	}
+	return renderer->num_jobs;
+}
+
+size_t TileRenderer_Render(LCUI_TileRenderer renderer, LCUI_Graph *canvas,
+			   const LCUI_Region region, LCUI_TilePainter painter,
+			   void *arg, LinkedList *tiles)
+{
+	int i, n, begin;
+	size_t count;
+	LCUI_Rect *rect;
+
+	renderer->arg = arg;
+	renderer->canvas = canvas;
+	renderer->painter = painter;
+	if (!Graph_IsValid(canvas) ||
+	    TileRenderer_CollectJobs(renderer, region) < 1) {
+		return 0;
+	}
+	/* assign adjacent tiles to the same thread for better locality */
+	n = min(renderer->num_threads, renderer->num_jobs);
+	for (i = 0, begin = 0; i < renderer->num_threads; ++i) {
+		if (i < n) {
+			renderer->queues[i].range =
+			    TileRange(begin, begin + (renderer->num_jobs - begin) /
+							 (n - i));
+			begin = TileRangeEnd(renderer->queues[i].range);
+		} else {
+			renderer->queues[i].range = TileRange(0, 0);
+		}
+	}
+	if (n > 1) {
+		LCUIMutex_Lock(&renderer->mutex);
+		renderer->count = 0;
+		renderer->running = renderer->num_threads - 1;
+		renderer->frame += 1;
+		LCUICond_Broadcast(&renderer->cond);
+		LCUIMutex_Unlock(&renderer->mutex);
+	}
+	count = TileRenderer_RunJobs(renderer, 0);
+	if (n > 1) {
+		LCUIMutex_Lock(&renderer->mutex);
+		while (renderer->running > 0) {
+			LCUICond_Wait(&renderer->done, &renderer->mutex);
+		}
+		count += renderer->count;
+		LCUIMutex_Unlock(&renderer->mutex);
+	}
+	if (tiles) {
+		for (i = 0; i < renderer->num_jobs; ++i) {
+			rect = malloc(sizeof(LCUI_Rect));
+			*rect = renderer->jobs[i];
+			LinkedList_Append(tiles, rect);
+		}
+	}
+	return count;
+}
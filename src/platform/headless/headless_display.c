@@ -0,0 +1,326 @@
+﻿/*
+ * headless_display.c -- headless display driver, renders to memory
+ *
+ * Copyright (c) 2018, Liu chao <lc-soft@live.cn> All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of LCUI nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#define LCUI_SURFACE_C
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/display.h>
+#include <LCUI/image.h>
+#include <LCUI/painter.h>
+#include <LCUI/headless.h>
+
+#define DEFAULT_WIDTH 1920
+#define DEFAULT_HEIGHT 1080
+
+typedef struct LCUI_SurfaceRec_ {
+	int x;
+	int y;
+	int width;
+	int height;
+	LCUI_BOOL visible;
+	LCUI_Graph canvas;
+	LinkedListNode node;
+} LCUI_SurfaceRec;
+
+static struct LCUI_HeadlessDisplay {
+	LCUI_BOOL enabled;
+	LCUI_BOOL active;
+	int width;
+	int height;
+	size_t frame_count;
+	LinkedList surfaces;
+	LCUI_EventTrigger trigger;
+} display = { FALSE, FALSE, DEFAULT_WIDTH, DEFAULT_HEIGHT };
+
+void LCUIHeadless_Enable(LCUI_BOOL enable)
+{
+	display.enabled = enable;
+}
+
+LCUI_BOOL LCUIHeadless_IsEnabled(void)
+{
+	const char *name;
+
+	if (display.enabled) {
+		return TRUE;
+	}
+	name = getenv("LCUI_DISPLAY_DRIVER");
+	return name && strcmp(name, "headless") == 0;
+}
+
+void LCUIHeadless_SetScreenSize(int width, int height)
+{
+	display.width = width;
+	display.height = height;
+}
+
+static LCUI_Surface HeadlessSurface_New(void)
+{
+	LCUI_Surface surface;
+
+	surface = NEW(LCUI_SurfaceRec, 1);
+	surface->x = 0;
+	surface->y = 0;
+	surface->width = 0;
+	surface->height = 0;
+	surface->visible = FALSE;
+	surface->node.data = surface;
+	Graph_Init(&surface->canvas);
+	surface->canvas.color_type = LCUI_COLOR_TYPE_ARGB;
+	LinkedList_AppendNode(&display.surfaces, &surface->node);
+	return surface;
+}
+
+static void HeadlessSurface_Delete(LCUI_Surface surface)
+{
+	LinkedList_Unlink(&display.surfaces, &surface->node);
+	Graph_Free(&surface->canvas);
+	free(surface);
+}
+
+static LCUI_BOOL HeadlessSurface_IsReady(LCUI_Surface surface)
+{
+	return TRUE;
+}
+
+static void HeadlessSurface_Show(LCUI_Surface surface)
+{
+	surface->visible = TRUE;
+}
+
+static void HeadlessSurface_Hide(LCUI_Surface surface)
+{
+	surface->visible = FALSE;
+}
+
+static void HeadlessSurface_Move(LCUI_Surface surface, int x, int y)
+{
+	surface->x = x;
+	surface->y = y;
+}
+
+/** 内存中的 surface 没有窗口管理器的限制，可以直接调整尺寸 */
+static void HeadlessSurface_Resize(LCUI_Surface surface, int width,
+				   int height)
+{
+	if (surface->width == width && surface->height == height) {
+		return;
+	}
+	surface->width = width;
+	surface->height = height;
+	Graph_Create(&surface->canvas, width, height);
+	Graph_FillRect(&surface->canvas, RGB(255, 255, 255), NULL, TRUE);
+}
+
+static int HeadlessSurface_GetWidth(LCUI_Surface surface)
+{
+	return surface->width;
+}
+
+static int HeadlessSurface_GetHeight(LCUI_Surface surface)
+{
+	return surface->height;
+}
+
+static void HeadlessSurface_SetCaptionW(LCUI_Surface surface,
+					const wchar_t *wstr)
+{
+}
+
+static void HeadlessSurface_SetOpacity(LCUI_Surface surface, float opacity)
+{
+}
+
+static void HeadlessSurface_SetRenderMode(LCUI_Surface surface, int mode)
+{
+}
+
+static void *HeadlessSurface_GetHandle(LCUI_Surface surface)
+{
+	return NULL;
+}
+
+static void HeadlessSurface_Update(LCUI_Surface surface)
+{
+}
+
+static LCUI_PaintContext HeadlessSurface_BeginPaint(LCUI_Surface surface,
+						    LCUI_Rect *rect)
+{
+	LCUI_Rect actual_rect = *rect;
+	LCUI_PaintContext paint;
+
+	LCUIRect_ValidateArea(&actual_rect, surface->width, surface->height);
+	if (actual_rect.width < 1 || actual_rect.height < 1) {
+		return NULL;
+	}
+	paint = LCUIPainter_Begin(&surface->canvas, &actual_rect);
+	Graph_FillRect(&paint->canvas, RGB(255, 255, 255), NULL, TRUE);
+	return paint;
+}
+
+static void HeadlessSurface_EndPaint(LCUI_Surface surface,
+				     LCUI_PaintContext paint)
+{
+	LCUIPainter_End(paint);
+}
+
+/** 画面已经在内存中，呈现时只需记录帧数 */
+static void HeadlessSurface_Present(LCUI_Surface surface)
+{
+	display.frame_count += 1;
+}
+
+static int HeadlessDisplay_GetWidth(void)
+{
+	return display.width;
+}
+
+static int HeadlessDisplay_GetHeight(void)
+{
+	return display.height;
+}
+
+static int HeadlessDisplay_BindEvent(int event_id, LCUI_EventFunc func,
+				     void *data, void (*destroy_data)(void *))
+{
+	return EventTrigger_Bind(display.trigger, event_id, func, data,
+				 destroy_data);
+}
+
+size_t LCUIHeadless_GetFrameCount(void)
+{
+	return display.frame_count;
+}
+
+int LCUIHeadless_GetFrame(LCUI_Graph *buf)
+{
+	LCUI_Surface surface;
+
+	if (!display.active || display.surfaces.length < 1) {
+		return -1;
+	}
+	surface = display.surfaces.head.next->data;
+	if (!Graph_IsValid(&surface->canvas)) {
+		return -1;
+	}
+	Graph_Copy(buf, &surface->canvas);
+	return 0;
+}
+
+static int HeadlessDisplay_WriteRawFile(const char *filename,
+					const LCUI_Graph *graph)
+{
+	int y;
+	FILE *fp;
+	size_t row_size = graph->width * sizeof(LCUI_ARGB);
+
+	fp = fopen(filename, "wb");
+	if (!fp) {
+		Logger_Error("[headless] cannot open file: %s\n", filename);
+		return -1;
+	}
+	for (y = 0; y < (int)graph->height; ++y) {
+		if (fwrite(graph->argb + y * graph->width, 1, row_size, fp) !=
+		    row_size) {
+			fclose(fp);
+			return -1;
+		}
+	}
+	fclose(fp);
+	return 0;
+}
+
+int LCUIHeadless_WriteFrame(const char *filename)
+{
+	int ret;
+	const char *ext;
+	LCUI_Graph frame;
+
+	Graph_Init(&frame);
+	if (LCUIHeadless_GetFrame(&frame) != 0) {
+		return -1;
+	}
+	ext = strrchr(filename, '.');
+	if (ext && strcmp(ext, ".png") == 0) {
+		ret = LCUI_WritePNGFile(filename, &frame);
+	} else {
+		ret = HeadlessDisplay_WriteRawFile(filename, &frame);
+	}
+	Graph_Free(&frame);
+	return ret;
+}
+
+LCUI_DisplayDriver LCUI_CreateHeadlessDisplayDriver(void)
+{
+	ASSIGN(driver, LCUI_DisplayDriver);
+	memset(driver, 0, sizeof(LCUI_DisplayDriverRec));
+	strcpy(driver->name, "headless");
+	driver->getWidth = HeadlessDisplay_GetWidth;
+	driver->getHeight = HeadlessDisplay_GetHeight;
+	driver->create = HeadlessSurface_New;
+	driver->destroy = HeadlessSurface_Delete;
+	driver->close = HeadlessSurface_Delete;
+	driver->isReady = HeadlessSurface_IsReady;
+	driver->show = HeadlessSurface_Show;
+	driver->hide = HeadlessSurface_Hide;
+	driver->move = HeadlessSurface_Move;
+	driver->resize = HeadlessSurface_Resize;
+	driver->getSurfaceWidth = HeadlessSurface_GetWidth;
+	driver->getSurfaceHeight = HeadlessSurface_GetHeight;
+	driver->update = HeadlessSurface_Update;
+	driver->present = HeadlessSurface_Present;
+	driver->setCaptionW = HeadlessSurface_SetCaptionW;
+	driver->setRenderMode = HeadlessSurface_SetRenderMode;
+	driver->setOpacity = HeadlessSurface_SetOpacity;
+	driver->getHandle = HeadlessSurface_GetHandle;
+	driver->beginPaint = HeadlessSurface_BeginPaint;
+	driver->endPaint = HeadlessSurface_EndPaint;
+	driver->bindEvent = HeadlessDisplay_BindEvent;
+	LinkedList_Init(&display.surfaces);
+	display.trigger = EventTrigger();
+	display.frame_count = 0;
+	display.active = TRUE;
+	return driver;
+}
+
+void LCUI_DestroyHeadlessDisplayDriver(LCUI_DisplayDriver driver)
+{
+	while (display.surfaces.length > 0) {
+		HeadlessSurface_Delete(display.surfaces.head.next->data);
+	}
+	EventTrigger_Destroy(display.trigger);
+	display.trigger = NULL;
+	display.active = FALSE;
+	free(driver);
+}
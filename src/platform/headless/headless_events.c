@@ -0,0 +1,202 @@
+﻿/*
+ * headless_events.c -- headless app driver, virtual clock and input
+ *
+ * Copyright (c) 2018, Liu chao <lc-soft@live.cn> All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of LCUI nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/input.h>
+#include <LCUI/display.h>
+#include <LCUI/headless.h>
+
+#define MOUSE_WHEEL_DELTA 20
+
+static struct LCUI_HeadlessApp {
+	int64_t time;
+	LCUI_Pos mouse;
+	LCUI_BOOL shift_key;
+	LCUI_BOOL ctrl_key;
+} app;
+
+static void HeadlessApp_ProcessEvents(void)
+{
+}
+
+static int HeadlessApp_BindSysEvent(int event_id, LCUI_EventFunc func,
+				    void *data, void (*destroy_data)(void *))
+{
+	return -1;
+}
+
+static int HeadlessApp_UnbindSysEvent(int event_id, LCUI_EventFunc func)
+{
+	return -1;
+}
+
+static int HeadlessApp_UnbindSysEvent2(int handler_id)
+{
+	return -1;
+}
+
+static void *HeadlessApp_GetData(void)
+{
+	return NULL;
+}
+
+LCUI_AppDriver LCUI_CreateHeadlessAppDriver(void)
+{
+	static LCUI_AppDriverRec driver = {
+		.id = LCUI_APP_HEADLESS,
+		.ProcessEvents = HeadlessApp_ProcessEvents,
+		.BindSysEvent = HeadlessApp_BindSysEvent,
+		.UnbindSysEvent = HeadlessApp_UnbindSysEvent,
+		.UnbindSysEvent2 = HeadlessApp_UnbindSysEvent2,
+		.GetData = HeadlessApp_GetData
+	};
+
+	app.mouse.x = 0;
+	app.mouse.y = 0;
+	app.shift_key = FALSE;
+	app.ctrl_key = FALSE;
+	return &driver;
+}
+
+void LCUI_DestroyHeadlessAppDriver(LCUI_AppDriver driver)
+{
+	LCUITime_SetClock(NULL);
+}
+
+static int64_t HeadlessApp_GetTime(void)
+{
+	return app.time;
+}
+
+void LCUIHeadless_EnableVirtualClock(LCUI_BOOL enable)
+{
+	if (enable) {
+		app.time = LCUI_GetSystemTime();
+		LCUITime_SetClock(HeadlessApp_GetTime);
+	} else {
+		LCUITime_SetClock(NULL);
+	}
+}
+
+void LCUIHeadless_AdvanceTime(int64_t ms)
+{
+	app.time += ms;
+	/* 让等待定时器的主循环按新的时间重新计算等待时长 */
+	LCUI_WakeUp();
+}
+
+void LCUIHeadless_MouseMove(int x, int y)
+{
+	LCUI_SysEventRec ev = { 0 };
+
+	ev.type = LCUI_MOUSEMOVE;
+	ev.motion.x = x;
+	ev.motion.y = y;
+	ev.motion.xrel = x - app.mouse.x;
+	ev.motion.yrel = y - app.mouse.y;
+	app.mouse.x = x;
+	app.mouse.y = y;
+	LCUI_PostEvent(&ev);
+	LCUI_DestroyEvent(&ev);
+}
+
+static void HeadlessApp_DispatchButtonEvent(int type, int button)
+{
+	LCUI_SysEventRec ev = { 0 };
+
+	ev.type = type;
+	ev.button.x = app.mouse.x;
+	ev.button.y = app.mouse.y;
+	ev.button.button = button;
+	LCUI_PostEvent(&ev);
+	LCUI_DestroyEvent(&ev);
+}
+
+void LCUIHeadless_MouseDown(int button)
+{
+	HeadlessApp_DispatchButtonEvent(LCUI_MOUSEDOWN, button);
+}
+
+void LCUIHeadless_MouseUp(int button)
+{
+	HeadlessApp_DispatchButtonEvent(LCUI_MOUSEUP, button);
+}
+
+void LCUIHeadless_MouseWheel(int delta)
+{
+	LCUI_SysEventRec ev = { 0 };
+
+	ev.type = LCUI_MOUSEWHEEL;
+	ev.wheel.x = app.mouse.x;
+	ev.wheel.y = app.mouse.y;
+	ev.wheel.delta = delta * MOUSE_WHEEL_DELTA;
+	LCUI_PostEvent(&ev);
+	LCUI_DestroyEvent(&ev);
+}
+
+static void HeadlessApp_DispatchKeyEvent(int type, int code)
+{
+	LCUI_SysEventRec ev = { 0 };
+
+	ev.type = type;
+	ev.key.code = code;
+	ev.key.shift_key = app.shift_key;
+	ev.key.ctrl_key = app.ctrl_key;
+	LCUI_PostEvent(&ev);
+	LCUI_DestroyEvent(&ev);
+}
+
+void LCUIHeadless_KeyDown(int code)
+{
+	if (code == LCUI_KEY_SHIFT) {
+		app.shift_key = TRUE;
+	} else if (code == LCUI_KEY_CONTROL) {
+		app.ctrl_key = TRUE;
+	}
+	HeadlessApp_DispatchKeyEvent(LCUI_KEYDOWN, code);
+	/* 与 X11 驱动一致，可打印的字符还会产生一个 keypress 事件 */
+	if (code >= 'A' && code <= 'Z' && !app.shift_key) {
+		HeadlessApp_DispatchKeyEvent(LCUI_KEYPRESS, code - 'A' + 'a');
+	} else if (code >= ' ' && code <= '~') {
+		HeadlessApp_DispatchKeyEvent(LCUI_KEYPRESS, code);
+	}
+}
+
+void LCUIHeadless_KeyUp(int code)
+{
+	if (code == LCUI_KEY_SHIFT) {
+		app.shift_key = FALSE;
+	} else if (code == LCUI_KEY_CONTROL) {
+		app.ctrl_key = FALSE;
+	}
+	HeadlessApp_DispatchKeyEvent(LCUI_KEYUP, code);
+}
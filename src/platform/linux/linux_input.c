@@ -0,0 +1,961 @@
+﻿/*
+ * linux_input.c -- Linux evdev input support.
+ *
+ * Copyright (c) 2018, Liu chao <lc-soft@live.cn> All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of LCUI nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include <LCUI_Build.h>
+#ifdef LCUI_BUILD_IN_LINUX
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <linux/input.h>
+
+#include <LCUI/LCUI.h>
+#include <LCUI/thread.h>
+#include <LCUI/input.h>
+#include <LCUI/display.h>
+#include <LCUI/platform/linux/linux_input.h>
+
+#define DEVICES_DIR "/dev/input"
+#define MOUSE_WHEEL_DELTA 20
+#define MAX_SLOTS 10
+#define MAX_BUTTONS 8
+#define MAX_EPOLL_EVENTS 8
+/* 每次读取的事件数量，足够容纳一个完整的多点触控报告 */
+#define EVENTS_BATCH 64
+
+#define BITS_PER_LONG (sizeof(unsigned long) * 8)
+#define NBITS(n) ((n) / BITS_PER_LONG + 1)
+#define TestBit(bits, n) \
+	((bits[(n) / BITS_PER_LONG] >> ((n) % BITS_PER_LONG)) & 1)
+#define SetBit(bits, n) \
+	(bits[(n) / BITS_PER_LONG] |= 1UL << ((n) % BITS_PER_LONG))
+#define ClearBit(bits, n) \
+	(bits[(n) / BITS_PER_LONG] &= ~(1UL << ((n) % BITS_PER_LONG)))
+
+/** 多点触控协议 B 中的触点槽 */
+typedef struct InputSlotRec_ {
+	/** 跟踪 id，-1 表示槽内没有触点 */
+	int id;
+	int x;
+	int y;
+
+	/** 触点在当前报告中的状态，0 表示没有变化 */
+	int state;
+} InputSlotRec, *InputSlot;
+
+typedef struct InputAxisRec_ {
+	int min;
+	int max;
+} InputAxisRec, *InputAxis;
+
+typedef struct InputButtonRec_ {
+	int button;
+	int value;
+} InputButtonRec;
+
+typedef struct InputDeviceRec_ {
+	int fd;
+	LCUI_BOOL is_touch;
+	LCUI_BOOL is_touchpad;
+	LCUI_BOOL has_mt;
+
+	/**
+	 * 内核的事件缓冲区已溢出，需要丢弃事件直到下一个 SYN_REPORT，
+	 * 然后重新同步设备状态
+	 */
+	LCUI_BOOL dropped;
+
+	/** 已按下的按键，用于在丢弃事件后补发按键释放事件 */
+	unsigned long keys[NBITS(KEY_MAX)];
+
+	/* 当前报告中累积的状态，在收到 SYN_REPORT 时转换成输入事件 */
+	int rel_x;
+	int rel_y;
+	int wheel;
+	int abs_x;
+	int abs_y;
+	LCUI_BOOL abs_moved;
+	int n_buttons;
+	InputButtonRec buttons[MAX_BUTTONS];
+
+	InputAxisRec axis_x;
+	InputAxisRec axis_y;
+	int slot;
+	int primary;
+	InputSlotRec slots[MAX_SLOTS];
+
+	/** 未读完的事件数据，管道等文件可能只读到半个事件 */
+	size_t buffer_size;
+	struct input_event buffer[EVENTS_BATCH];
+	LinkedListNode node;
+} InputDeviceRec, *InputDevice;
+
+typedef struct KeyMapRec_ {
+	unsigned short code;
+	int key;
+	char ch;
+	char shift_ch;
+} KeyMapRec;
+
+static struct LCUI_LinuxInputDriver {
+	int refs;
+	int epoll_fd;
+	int wakeup_fd;
+
+	/* 所有指针设备共用一个鼠标光标 */
+	int x;
+	int y;
+
+	int shift_keys;
+	int ctrl_keys;
+	LCUI_BOOL caps_lock;
+
+	LCUI_Thread tid;
+	LCUI_BOOL active;
+	LCUI_Mutex mutex;
+	LinkedList devices;
+} input;
+
+static const KeyMapRec keymap[] = {
+	{ KEY_ESC, LCUI_KEY_ESCAPE, 0, 0 },
+	{ KEY_1, LCUI_KEY_1, '1', '!' },
+	{ KEY_2, LCUI_KEY_2, '2', '@' },
+	{ KEY_3, LCUI_KEY_3, '3', '#' },
+	{ KEY_4, LCUI_KEY_4, '4', '$' },
+	{ KEY_5, LCUI_KEY_5, '5', '%' },
+	{ KEY_6, LCUI_KEY_6, '6', '^' },
+	{ KEY_7, LCUI_KEY_7, '7', '&' },
+	{ KEY_8, LCUI_KEY_8, '8', '*' },
+	{ KEY_9, LCUI_KEY_9, '9', '(' },
+	{ KEY_0, LCUI_KEY_0, '0', ')' },
+	{ KEY_MINUS, LCUI_KEY_MINUS, '-', '_' },
+	{ KEY_EQUAL, LCUI_KEY_EQUAL, '=', '+' },
+	{ KEY_BACKSPACE, LCUI_KEY_BACKSPACE, 0, 0 },
+	{ KEY_TAB, LCUI_KEY_TAB, 0, 0 },
+	{ KEY_Q, LCUI_KEY_Q, 'q', 'Q' },
+	{ KEY_W, LCUI_KEY_W, 'w', 'W' },
+	{ KEY_E, LCUI_KEY_E, 'e', 'E' },
+	{ KEY_R, LCUI_KEY_R, 'r', 'R' },
+	{ KEY_T, LCUI_KEY_T, 't', 'T' },
+	{ KEY_Y, LCUI_KEY_Y, 'y', 'Y' },
+	{ KEY_U, LCUI_KEY_U, 'u', 'U' },
+	{ KEY_I, LCUI_KEY_I, 'i', 'I' },
+	{ KEY_O, LCUI_KEY_O, 'o', 'O' },
+	{ KEY_P, LCUI_KEY_P, 'p', 'P' },
+	{ KEY_LEFTBRACE, LCUI_KEY_BRACKETLEFT, '[', '{' },
+	{ KEY_RIGHTBRACE, LCUI_KEY_BRACKETRIGHT, ']', '}' },
+	{ KEY_ENTER, LCUI_KEY_ENTER, 0, 0 },
+	{ KEY_LEFTCTRL, LCUI_KEY_CONTROL, 0, 0 },
+	{ KEY_A, LCUI_KEY_A, 'a', 'A' },
+	{ KEY_S, LCUI_KEY_S, 's', 'S' },
+	{ KEY_D, LCUI_KEY_D, 'd', 'D' },
+	{ KEY_F, LCUI_KEY_F, 'f', 'F' },
+	{ KEY_G, LCUI_KEY_G, 'g', 'G' },
+	{ KEY_H, LCUI_KEY_H, 'h', 'H' },
+	{ KEY_J, LCUI_KEY_J, 'j', 'J' },
+	{ KEY_K, LCUI_KEY_K, 'k', 'K' },
+	{ KEY_L, LCUI_KEY_L, 'l', 'L' },
+	{ KEY_SEMICOLON, LCUI_KEY_SEMICOLON, ';', ':' },
+	{ KEY_APOSTROPHE, LCUI_KEY_APOSTROPHE, '\'', '"' },
+	{ KEY_GRAVE, LCUI_KEY_GRAVE, '`', '~' },
+	{ KEY_LEFTSHIFT, LCUI_KEY_SHIFT, 0, 0 },
+	{ KEY_BACKSLASH, LCUI_KEY_BACKSLASH, '\\', '|' },
+	{ KEY_Z, LCUI_KEY_Z, 'z', 'Z' },
+	{ KEY_X, LCUI_KEY_X, 'x', 'X' },
+	{ KEY_C, LCUI_KEY_C, 'c', 'C' },
+	{ KEY_V, LCUI_KEY_V, 'v', 'V' },
+	{ KEY_B, LCUI_KEY_B, 'b', 'B' },
+	{ KEY_N, LCUI_KEY_N, 'n', 'N' },
+	{ KEY_M, LCUI_KEY_M, 'm', 'M' },
+	{ KEY_COMMA, LCUI_KEY_COMMA, ',', '<' },
+	{ KEY_DOT, LCUI_KEY_PERIOD, '.', '>' },
+	{ KEY_SLASH, LCUI_KEY_SLASH, '/', '?' },
+	{ KEY_RIGHTSHIFT, LCUI_KEY_SHIFT, 0, 0 },
+	{ KEY_LEFTALT, LCUI_KEY_ALT, 0, 0 },
+	{ KEY_SPACE, LCUI_KEY_SPACE, ' ', ' ' },
+	{ KEY_CAPSLOCK, LCUI_KEY_CAPITAL, 0, 0 },
+	{ KEY_RIGHTCTRL, LCUI_KEY_CONTROL, 0, 0 },
+	{ KEY_RIGHTALT, LCUI_KEY_ALT, 0, 0 },
+	{ KEY_HOME, LCUI_KEY_HOME, 0, 0 },
+	{ KEY_UP, LCUI_KEY_UP, 0, 0 },
+	{ KEY_PAGEUP, LCUI_KEY_PAGEUP, 0, 0 },
+	{ KEY_LEFT, LCUI_KEY_LEFT, 0, 0 },
+	{ KEY_RIGHT, LCUI_KEY_RIGHT, 0, 0 },
+	{ KEY_END, LCUI_KEY_END, 0, 0 },
+	{ KEY_DOWN, LCUI_KEY_DOWN, 0, 0 },
+	{ KEY_PAGEDOWN, LCUI_KEY_PAGEDOWN, 0, 0 },
+	{ KEY_INSERT, LCUI_KEY_INSERT, 0, 0 },
+	{ KEY_DELETE, LCUI_KEY_DELETE, 0, 0 }
+};
+
+static const KeyMapRec *FindKey(int code)
+{
+	size_t i;
+
+	for (i = 0; i < sizeof(keymap) / sizeof(keymap[0]); ++i) {
+		if (keymap[i].code == code) {
+			return &keymap[i];
+		}
+	}
+	return NULL;
+}
+
+/** 将设备的绝对坐标映射到屏幕坐标，范围未知时（例如管道）直接使用原坐标 */
+static int ScaleAxis(InputAxis axis, int value, int size)
+{
+	if (axis->max <= axis->min) {
+		return value;
+	}
+	return (value - axis->min) * size / (axis->max - axis->min + 1);
+}
+
+static void PostMouseMove(int x, int y)
+{
+	LCUI_SysEventRec ev = { 0 };
+	int width = LCUIDisplay_GetWidth();
+	int height = LCUIDisplay_GetHeight();
+
+	/* 屏幕尺寸在第一帧之前是未知的 */
+	if (width > 0 && height > 0) {
+		x = min(width - 1, x);
+		y = min(height - 1, y);
+	}
+	x = max(0, x);
+	y = max(0, y);
+	if (x == input.x && y == input.y) {
+		return;
+	}
+	ev.type = LCUI_MOUSEMOVE;
+	ev.motion.x = x;
+	ev.motion.y = y;
+	ev.motion.xrel = x - input.x;
+	ev.motion.yrel = y - input.y;
+	input.x = x;
+	input.y = y;
+	LCUI_PostEvent(&ev);
+}
+
+static void PostMouseButton(int button, int value)
+{
+	LCUI_SysEventRec ev = { 0 };
+
+	ev.type = value ? LCUI_MOUSEDOWN : LCUI_MOUSEUP;
+	ev.button.x = input.x;
+	ev.button.y = input.y;
+	ev.button.button = button;
+	LCUI_PostEvent(&ev);
+}
+
+static void PostMouseWheel(int delta)
+{
+	LCUI_SysEventRec ev = { 0 };
+
+	ev.type = LCUI_MOUSEWHEEL;
+	ev.wheel.x = input.x;
+	ev.wheel.y = input.y;
+	ev.wheel.delta = delta;
+	LCUI_PostEvent(&ev);
+}
+
+/** 按键的值为 1 表示按下，2 表示自动重复，0 表示释放 */
+static void PostKey(int code, int value)
+{
+	LCUI_SysEventRec ev = { 0 };
+	const KeyMapRec *map = FindKey(code);
+
+	if (!map) {
+		return;
+	}
+	if (map->key == LCUI_KEY_SHIFT && value != 2) {
+		input.shift_keys = max(0, input.shift_keys + (value ? 1 : -1));
+	} else if (map->key == LCUI_KEY_CONTROL && value != 2) {
+		input.ctrl_keys = max(0, input.ctrl_keys + (value ? 1 : -1));
+	} else if (map->key == LCUI_KEY_CAPITAL && value == 1) {
+		input.caps_lock = !input.caps_lock;
+	}
+	ev.type = value ? LCUI_KEYDOWN : LCUI_KEYUP;
+	ev.key.code = map->key;
+	ev.key.shift_key = input.shift_keys > 0;
+	ev.key.ctrl_key = input.ctrl_keys > 0;
+	LCUI_PostEvent(&ev);
+	if (!value || !map->ch || ev.key.ctrl_key) {
+		return;
+	}
+	ev.type = LCUI_KEYPRESS;
+	ev.key.code = ev.key.shift_key ? map->shift_ch : map->ch;
+	if (input.caps_lock && map->ch >= 'a' && map->ch <= 'z') {
+		ev.key.code = ev.key.shift_key ? map->ch : map->shift_ch;
+	}
+	LCUI_PostEvent(&ev);
+}
+
+static void InputDevice_Probe(InputDevice dev)
+{
+	struct input_absinfo info;
+	int code_x = ABS_X, code_y = ABS_Y;
+	unsigned long key_bits[NBITS(KEY_MAX)] = { 0 };
+	unsigned long abs_bits[NBITS(ABS_MAX)] = { 0 };
+	unsigned long prop_bits[NBITS(INPUT_PROP_MAX)] = { 0 };
+
+	/* 管道等普通文件不支持这些请求，只能在读到事件时再判断设备类型 */
+	if (ioctl(dev->fd, EVIOCGBIT(EV_KEY, sizeof(key_bits)), key_bits) < 0) {
+		return;
+	}
+	dev->is_touch = TestBit(key_bits, BTN_TOUCH);
+	ioctl(dev->fd, EVIOCGBIT(EV_ABS, sizeof(abs_bits)), abs_bits);
+	if (TestBit(abs_bits, ABS_MT_SLOT)) {
+		dev->has_mt = TRUE;
+		dev->is_touch = TRUE;
+		code_x = ABS_MT_POSITION_X;
+		code_y = ABS_MT_POSITION_Y;
+	}
+	/* 触摸板的坐标是相对于触摸板的，不能当作触摸屏使用 */
+	if (ioctl(dev->fd, EVIOCGPROP(sizeof(prop_bits)), prop_bits) >= 0 &&
+	    TestBit(prop_bits, INPUT_PROP_POINTER) && dev->is_touch) {
+		dev->is_touchpad = TRUE;
+	}
+	if (ioctl(dev->fd, EVIOCGABS(code_x), &info) >= 0) {
+		dev->axis_x.min = info.minimum;
+		dev->axis_x.max = info.maximum;
+	}
+	if (ioctl(dev->fd, EVIOCGABS(code_y), &info) >= 0) {
+		dev->axis_y.min = info.minimum;
+		dev->axis_y.max = info.maximum;
+	}
+}
+
+static void InputDevice_AddButton(InputDevice dev, int button, int value)
+{
+	if (dev->n_buttons < MAX_BUTTONS) {
+		dev->buttons[dev->n_buttons].button = button;
+		dev->buttons[dev->n_buttons].value = value;
+		dev->n_buttons += 1;
+	}
+}
+
+static InputSlot InputDevice_GetSlot(InputDevice dev)
+{
+	if (dev->slot < 0 || dev->slot >= MAX_SLOTS) {
+		return NULL;
+	}
+	return &dev->slots[dev->slot];
+}
+
+static void InputSlot_Move(InputSlot slot)
+{
+	if (slot->id >= 0 && slot->state == 0) {
+		slot->state = LCUI_TOUCHMOVE;
+	}
+}
+
+static void InputDevice_ProcessKey(InputDevice dev, struct input_event *e)
+{
+	if (e->code <= KEY_MAX) {
+		if (e->value) {
+			SetBit(dev->keys, e->code);
+		} else {
+			ClearBit(dev->keys, e->code);
+		}
+	}
+	switch (e->code) {
+	case BTN_LEFT:
+		InputDevice_AddButton(dev, LCUI_KEY_LEFTBUTTON, e->value);
+		break;
+	case BTN_RIGHT:
+		InputDevice_AddButton(dev, LCUI_KEY_RIGHTBUTTON, e->value);
+		break;
+	case BTN_TOUCH:
+		if (dev->is_touchpad) {
+			break;
+		}
+		dev->is_touch = TRUE;
+		/* 单点触控设备没有触点槽，用第一个槽记录触点 */
+		if (dev->has_mt || e->value == 2) {
+			break;
+		}
+		if (e->value) {
+			dev->slots[0].id = 0;
+			dev->slots[0].state = LCUI_TOUCHDOWN;
+		} else if (dev->slots[0].id >= 0) {
+			dev->slots[0].state = LCUI_TOUCHUP;
+		}
+		break;
+	default:
+		if (e->code < BTN_MISC) {
+			PostKey(e->code, e->value);
+		}
+		break;
+	}
+}
+
+static void InputDevice_ProcessAbs(InputDevice dev, struct input_event *e)
+{
+	InputSlot slot;
+
+	if (dev->is_touchpad) {
+		return;
+	}
+	switch (e->code) {
+	case ABS_X:
+		dev->abs_x = e->value;
+		dev->abs_moved = TRUE;
+		break;
+	case ABS_Y:
+		dev->abs_y = e->value;
+		dev->abs_moved = TRUE;
+		break;
+	case ABS_MT_SLOT:
+		dev->has_mt = TRUE;
+		dev->is_touch = TRUE;
+		dev->slot = e->value;
+		break;
+	case ABS_MT_TRACKING_ID:
+		dev->has_mt = TRUE;
+		dev->is_touch = TRUE;
+		slot = InputDevice_GetSlot(dev);
+		if (!slot) {
+			break;
+		}
+		if (e->value >= 0) {
+			slot->id = e->value;
+			slot->state = LCUI_TOUCHDOWN;
+		} else if (slot->id >= 0) {
+			slot->state = LCUI_TOUCHUP;
+		}
+		break;
+	case ABS_MT_POSITION_X:
+		slot = InputDevice_GetSlot(dev);
+		if (slot) {
+			slot->x = e->value;
+			InputSlot_Move(slot);
+		}
+		break;
+	case ABS_MT_POSITION_Y:
+		slot = InputDevice_GetSlot(dev);
+		if (slot) {
+			slot->y = e->value;
+			InputSlot_Move(slot);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ * 将触点槽的变化转换成一个触控事件
+ * 与其它平台驱动一样，事件中包含所有按下的触点，主触点还会产生鼠标事件
+ */
+static void InputDevice_FlushTouch(InputDevice dev)
+{
+	int i, n = 0, width, height;
+	LCUI_BOOL changed = FALSE;
+	LCUI_BOOL pressed = FALSE;
+	LCUI_SysEventRec ev = { 0 };
+	LCUI_TouchPointRec points[MAX_SLOTS];
+	LCUI_TouchPoint primary = NULL;
+	InputSlot slot;
+
+	width = LCUIDisplay_GetWidth();
+	height = LCUIDisplay_GetHeight();
+	for (i = 0; i < MAX_SLOTS; ++i) {
+		slot = &dev->slots[i];
+		if (slot->id >= 0 && slot->state != LCUI_TOUCHDOWN) {
+			pressed = TRUE;
+		}
+	}
+	for (i = 0; i < MAX_SLOTS; ++i) {
+		slot = &dev->slots[i];
+		if (slot->id < 0) {
+			continue;
+		}
+		if (slot->state) {
+			changed = TRUE;
+		}
+		/* 只有在没有其它触点时按下的触点才是主触点 */
+		if (!pressed && dev->primary < 0 &&
+		    slot->state == LCUI_TOUCHDOWN) {
+			dev->primary = i;
+		}
+		points[n].x = ScaleAxis(&dev->axis_x, slot->x, width);
+		points[n].y = ScaleAxis(&dev->axis_y, slot->y, height);
+		points[n].id = slot->id;
+		points[n].state = slot->state ? slot->state : LCUI_TOUCHMOVE;
+		points[n].is_primary = dev->primary == i;
+		if (points[n].is_primary && slot->state) {
+			primary = &points[n];
+		}
+		n += 1;
+	}
+	if (!changed) {
+		return;
+	}
+	ev.type = LCUI_TOUCH;
+	ev.touch.n_points = n;
+	ev.touch.points = points;
+	LCUI_PostEvent(&ev);
+	if (primary) {
+		PostMouseMove(primary->x, primary->y);
+		if (primary->state == LCUI_TOUCHDOWN) {
+			PostMouseButton(LCUI_KEY_LEFTBUTTON, 1);
+		} else if (primary->state == LCUI_TOUCHUP) {
+			PostMouseButton(LCUI_KEY_LEFTBUTTON, 0);
+			dev->primary = -1;
+		}
+	}
+	for (i = 0; i < MAX_SLOTS; ++i) {
+		if (dev->slots[i].state == LCUI_TOUCHUP) {
+			dev->slots[i].id = -1;
+		}
+		dev->slots[i].state = 0;
+	}
+}
+
+/** 一个 SYN_REPORT 报告结束，将累积的状态转换成输入事件 */
+static void InputDevice_Flush(InputDevice dev)
+{
+	int i;
+
+	if (dev->rel_x || dev->rel_y) {
+		PostMouseMove(input.x + dev->rel_x, input.y + dev->rel_y);
+	}
+	if (dev->abs_moved) {
+		if (dev->is_touch && !dev->has_mt) {
+			dev->slots[0].x = dev->abs_x;
+			dev->slots[0].y = dev->abs_y;
+			InputSlot_Move(&dev->slots[0]);
+		} else if (!dev->is_touch) {
+			PostMouseMove(ScaleAxis(&dev->axis_x, dev->abs_x,
+						LCUIDisplay_GetWidth()),
+				      ScaleAxis(&dev->axis_y, dev->abs_y,
+						LCUIDisplay_GetHeight()));
+		}
+	}
+	if (dev->is_touch) {
+		InputDevice_FlushTouch(dev);
+	}
+	for (i = 0; i < dev->n_buttons; ++i) {
+		PostMouseButton(dev->buttons[i].button, dev->buttons[i].value);
+	}
+	if (dev->wheel) {
+		PostMouseWheel(dev->wheel * MOUSE_WHEEL_DELTA);
+	}
+	dev->rel_x = 0;
+	dev->rel_y = 0;
+	dev->wheel = 0;
+	dev->abs_moved = FALSE;
+	dev->n_buttons = 0;
+}
+
+/**
+ * 按照设备当前的触点重新同步触点槽
+ * 先抬起已经不存在的触点，再按下新出现的触点，无法读取触点状态时抬起所有触点
+ */
+static void InputDevice_ResyncSlots(InputDevice dev)
+{
+	int i;
+	LCUI_BOOL ok;
+	InputSlot slot;
+	struct input_absinfo info;
+	struct {
+		__u32 code;
+		__s32 values[MAX_SLOTS];
+	} ids, xs, ys;
+
+	if (!dev->has_mt || dev->is_touchpad) {
+		return;
+	}
+	for (i = 0; i < MAX_SLOTS; ++i) {
+		ids.values[i] = -1;
+		xs.values[i] = dev->slots[i].x;
+		ys.values[i] = dev->slots[i].y;
+	}
+	ids.code = ABS_MT_TRACKING_ID;
+	xs.code = ABS_MT_POSITION_X;
+	ys.code = ABS_MT_POSITION_Y;
+	ok = ioctl(dev->fd, EVIOCGMTSLOTS(sizeof(ids)), &ids) >= 0 &&
+	     ioctl(dev->fd, EVIOCGMTSLOTS(sizeof(xs)), &xs) >= 0 &&
+	     ioctl(dev->fd, EVIOCGMTSLOTS(sizeof(ys)), &ys) >= 0;
+	for (i = 0; i < MAX_SLOTS; ++i) {
+		slot = &dev->slots[i];
+		if (slot->id >= 0 && (!ok || ids.values[i] != slot->id)) {
+			slot->state = LCUI_TOUCHUP;
+		}
+	}
+	InputDevice_FlushTouch(dev);
+	if (!ok) {
+		return;
+	}
+	for (i = 0; i < MAX_SLOTS; ++i) {
+		slot = &dev->slots[i];
+		if (ids.values[i] < 0) {
+			continue;
+		}
+		if (slot->id < 0) {
+			slot->id = ids.values[i];
+			slot->state = LCUI_TOUCHDOWN;
+		}
+		if (slot->x != xs.values[i] || slot->y != ys.values[i]) {
+			slot->x = xs.values[i];
+			slot->y = ys.values[i];
+			InputSlot_Move(slot);
+		}
+	}
+	if (ioctl(dev->fd, EVIOCGABS(ABS_MT_SLOT), &info) >= 0) {
+		dev->slot = info.value;
+	}
+}
+
+/**
+ * 在丢弃事件后重新同步设备状态
+ * 被丢弃的事件中可能有按键释放和触点抬起，不处理的话它们会一直保持按下的状态，
+ * 所以要丢掉不完整的报告，然后按照设备的实际状态补发事件。管道等普通文件不支持
+ * 读取设备状态，此时当作所有按键和触点都已释放。
+ */
+static void InputDevice_Resync(InputDevice dev)
+{
+	int code;
+	struct input_absinfo info;
+	struct input_event e = { 0 };
+	unsigned long key_bits[NBITS(KEY_MAX)] = { 0 };
+
+	dev->rel_x = 0;
+	dev->rel_y = 0;
+	dev->wheel = 0;
+	dev->abs_moved = FALSE;
+	dev->n_buttons = 0;
+	ioctl(dev->fd, EVIOCGKEY(sizeof(key_bits)), key_bits);
+	e.type = EV_KEY;
+	for (code = 0; code <= KEY_MAX; ++code) {
+		if (TestBit(dev->keys, code) != TestBit(key_bits, code)) {
+			e.code = code;
+			e.value = (int)TestBit(key_bits, code);
+			InputDevice_ProcessKey(dev, &e);
+		}
+	}
+	InputDevice_ResyncSlots(dev);
+	if (!dev->has_mt && !dev->is_touchpad &&
+	    ioctl(dev->fd, EVIOCGABS(ABS_X), &info) >= 0) {
+		dev->abs_x = info.value;
+		if (ioctl(dev->fd, EVIOCGABS(ABS_Y), &info) >= 0) {
+			dev->abs_y = info.value;
+		}
+		dev->abs_moved = TRUE;
+	}
+	InputDevice_Flush(dev);
+}
+
+static void InputDevice_ProcessEvent(InputDevice dev, struct input_event *e)
+{
+	if (e->type == EV_SYN) {
+		if (e->code == SYN_DROPPED) {
+			dev->dropped = TRUE;
+		} else if (e->code == SYN_REPORT) {
+			if (dev->dropped) {
+				dev->dropped = FALSE;
+				InputDevice_Resync(dev);
+				return;
+			}
+			InputDevice_Flush(dev);
+		}
+		return;
+	}
+	if (dev->dropped) {
+		return;
+	}
+	switch (e->type) {
+	case EV_KEY:
+		InputDevice_ProcessKey(dev, e);
+		break;
+	case EV_REL:
+		if (e->code == REL_X) {
+			dev->rel_x += e->value;
+		} else if (e->code == REL_Y) {
+			dev->rel_y += e->value;
+		} else if (e->code == REL_WHEEL) {
+			dev->wheel += e->value;
+		}
+		break;
+	case EV_ABS:
+		InputDevice_ProcessAbs(dev, e);
+		break;
+	default:
+		break;
+	}
+}
+
+static void LinuxInput_RemoveDevice(InputDevice dev)
+{
+	epoll_ctl(input.epoll_fd, EPOLL_CTL_DEL, dev->fd, NULL);
+	LCUIMutex_Lock(&input.mutex);
+	LinkedList_Unlink(&input.devices, &dev->node);
+	LCUIMutex_Unlock(&input.mutex);
+	close(dev->fd);
+	free(dev);
+}
+
+/** 读取一批事件，返回 FALSE 表示设备已经不可用 */
+static LCUI_BOOL InputDevice_Read(InputDevice dev)
+{
+	ssize_t size;
+	size_t i, n;
+	char *buffer = (char *)dev->buffer;
+
+	size = read(dev->fd, buffer + dev->buffer_size,
+		    sizeof(dev->buffer) - dev->buffer_size);
+	if (size < 0) {
+		return errno == EAGAIN || errno == EINTR;
+	}
+	if (size == 0) {
+		return FALSE;
+	}
+	dev->buffer_size += size;
+	n = dev->buffer_size / sizeof(struct input_event);
+	for (i = 0; i < n; ++i) {
+		InputDevice_ProcessEvent(dev, &dev->buffer[i]);
+	}
+	dev->buffer_size -= n * sizeof(struct input_event);
+	if (dev->buffer_size > 0) {
+		memmove(buffer, dev->buffer + n, dev->buffer_size);
+	}
+	return TRUE;
+}
+
+static void LinuxInputThread(void *arg)
+{
+	int i, n;
+	InputDevice dev;
+	struct epoll_event events[MAX_EPOLL_EVENTS];
+
+	Logger_Debug("[input] evdev driver thread: %lld\n", input.tid);
+	while (input.active) {
+		n = epoll_wait(input.epoll_fd, events, MAX_EPOLL_EVENTS, -1);
+		if (n < 0 && errno != EINTR) {
+			Logger_Error("[input] epoll_wait failed: %s\n",
+				     strerror(errno));
+			break;
+		}
+		for (i = 0; i < n && input.active; ++i) {
+			dev = events[i].data.ptr;
+			if (dev && !InputDevice_Read(dev)) {
+				Logger_Debug("[input] device %d closed\n",
+					     dev->fd);
+				LinuxInput_RemoveDevice(dev);
+			}
+		}
+	}
+}
+
+int LCUI_AddLinuxInputDevice(int fd)
+{
+	int i, flags;
+	InputDevice dev;
+	struct epoll_event ev = { 0 };
+
+	if (input.refs < 1) {
+		close(fd);
+		return -1;
+	}
+	dev = calloc(1, sizeof(InputDeviceRec));
+	if (!dev) {
+		close(fd);
+		return -ENOMEM;
+	}
+	dev->fd = fd;
+	dev->primary = -1;
+	dev->node.data = dev;
+	for (i = 0; i < MAX_SLOTS; ++i) {
+		dev->slots[i].id = -1;
+	}
+	InputDevice_Probe(dev);
+	flags = fcntl(fd, F_GETFL, 0);
+	fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+	ev.events = EPOLLIN;
+	ev.data.ptr = dev;
+	LCUIMutex_Lock(&input.mutex);
+	LinkedList_AppendNode(&input.devices, &dev->node);
+	LCUIMutex_Unlock(&input.mutex);
+	if (epoll_ctl(input.epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+		Logger_Error("[input] cannot watch device: %s\n",
+			     strerror(errno));
+		LCUIMutex_Lock(&input.mutex);
+		LinkedList_Unlink(&input.devices, &dev->node);
+		LCUIMutex_Unlock(&input.mutex);
+		close(fd);
+		free(dev);
+		return -1;
+	}
+	return 0;
+}
+
+static int LinuxInput_OpenDevice(const char *path)
+{
+	int fd = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+
+	if (fd < 0) {
+		Logger_Debug("[input] cannot open %s: %s\n", path,
+			     strerror(errno));
+		return -1;
+	}
+	Logger_Debug("[input] open device: %s\n", path);
+	return LCUI_AddLinuxInputDevice(fd);
+}
+
+static int LinuxInput_OpenDevices(void)
+{
+	DIR *dir;
+	size_t len;
+	int count = 0;
+	char path[512];
+	const char *p;
+	struct dirent *entry;
+	const char *devices = getenv("LCUI_INPUT_DEVICES");
+
+	if (devices) {
+		while (*devices) {
+			p = strchr(devices, ':');
+			len = p ? (size_t)(p - devices) : strlen(devices);
+			if (len > 0 && len < sizeof(path)) {
+				memcpy(path, devices, len);
+				path[len] = 0;
+				count += LinuxInput_OpenDevice(path) == 0;
+			}
+			devices += p ? len + 1 : len;
+		}
+		return count;
+	}
+	dir = opendir(DEVICES_DIR);
+	if (!dir) {
+		return 0;
+	}
+	while ((entry = readdir(dir))) {
+		if (strncmp(entry->d_name, "event", 5) != 0) {
+			continue;
+		}
+		snprintf(path, sizeof(path), DEVICES_DIR "/%s", entry->d_name);
+		count += LinuxInput_OpenDevice(path) == 0;
+	}
+	closedir(dir);
+	return count;
+}
+
+/** 关闭所有设备和事件描述符 */
+static void LinuxInput_Close(void)
+{
+	InputDevice dev;
+	LinkedListNode *node;
+
+	while (input.devices.head.next) {
+		node = input.devices.head.next;
+		dev = node->data;
+		LinkedList_Unlink(&input.devices, node);
+		close(dev->fd);
+		free(dev);
+	}
+	LCUIMutex_Destroy(&input.mutex);
+	close(input.wakeup_fd);
+	close(input.epoll_fd);
+}
+
+int LCUI_InitLinuxInput(void)
+{
+	int count;
+	struct epoll_event ev = { 0 };
+
+	if (input.refs > 0) {
+		input.refs += 1;
+		LCUIMutex_Lock(&input.mutex);
+		count = (int)input.devices.length;
+		LCUIMutex_Unlock(&input.mutex);
+		return count;
+	}
+	input.epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	if (input.epoll_fd < 0) {
+		Logger_Error("[input] epoll_create1 failed: %s\n",
+			     strerror(errno));
+		return -1;
+	}
+	input.wakeup_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	ev.events = EPOLLIN;
+	ev.data.ptr = NULL;
+	if (input.wakeup_fd < 0 ||
+	    epoll_ctl(input.epoll_fd, EPOLL_CTL_ADD, input.wakeup_fd, &ev) <
+		0) {
+		Logger_Error("[input] cannot create wakeup event: %s\n",
+			     strerror(errno));
+		if (input.wakeup_fd >= 0) {
+			close(input.wakeup_fd);
+		}
+		close(input.epoll_fd);
+		return -1;
+	}
+	input.x = LCUIDisplay_GetWidth() / 2;
+	input.y = LCUIDisplay_GetHeight() / 2;
+	input.shift_keys = 0;
+	input.ctrl_keys = 0;
+	input.caps_lock = FALSE;
+	input.refs = 1;
+	input.active = TRUE;
+	LinkedList_Init(&input.devices);
+	LCUIMutex_Init(&input.mutex);
+	count = LinuxInput_OpenDevices();
+	if (LCUIThread_Create(&input.tid, LinuxInputThread, NULL) != 0) {
+		Logger_Error("[input] cannot create the driver thread\n");
+		input.refs = 0;
+		input.active = FALSE;
+		LinuxInput_Close();
+		return -1;
+	}
+	return count;
+}
+
+void LCUI_FreeLinuxInput(void)
+{
+	uint64_t value = 1;
+
+	if (input.refs < 1 || --input.refs > 0) {
+		return;
+	}
+	input.active = FALSE;
+	if (write(input.wakeup_fd, &value, sizeof(value)) != sizeof(value)) {
+		Logger_Error("[input] cannot wake up the driver thread\n");
+	}
+	LCUIThread_Join(input.tid, NULL);
+	LinuxInput_Close();
+}
+
+#endif
@@ -36,12 +36,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <fcntl.h>
-#ifdef USE_LINUX_INPUT_EVENT
-#include <linux/input.h>
-#else
 #include <signal.h>
 #include <termios.h>
-#endif
 #include <LCUI/LCUI.h>
 #include <LCUI/thread.h>
 #include <LCUI/platform.h>
@@ -49,65 +45,17 @@
 #include <LCUI/ime.h>
 #include LCUI_EVENTS_H
 #include LCUI_KEYBOARD_H
+#include <LCUI/platform/linux/linux_input.h>
 
 static struct LCUI_LinuxKeyboardDriver {
-#ifdef USE_LINUX_INPUT_EVENT
-	int dev_fd;
-	char *dev_path;
-#else
 	int fd;
 	struct termios tm;
-#endif
 	LCUI_Thread tid;
 	LCUI_BOOL active;
+	LCUI_BOOL evdev;
+	int handler_id;
 } keyboard;
 
-/* FIXME: this driver does not working, so we won't use it for now */
-#ifdef USE_LINUX_INPUT_EVENT
-static void LinuxKeybnoardThread(void *arg)
-{
-	size_t bytes;
-	struct input_event data;
-
-	keyboard.active = TRUE;
-	Logger_Debug("[input] keyboard driver thread: %lld\n", keyboard.tid);
-	while (keyboard.active) {
-		bytes = read(keyboard.dev_fd, &data, sizeof(data));
-		if (bytes > 0 && data.type == EV_KEY) {
-			_DEBUG_MSG("Keypress value=%x, type=%x, code=%x\n",
-				   data.value, data.type, data.code);
-		}
-	}
-}
-
-static int InitLinuxKeybord(void)
-{
-	keyboard.dev_path = getenv("LCUI_KEYBOARD_DEVICE");
-	if (!keyboard.dev_path) {
-		keyboard.dev_path = "/dev/input/event0";
-	}
-	if ((keyboard.dev_fd = open(keyboard.dev_path, O_RDONLY | O_NONBLOCK)) <
-	    0) {
-		Logger_Error("[input] open keyboard device failed");
-		return -1;
-	}
-	LCUIThread_Create(&keyboard.tid, LinuxKeybnoardThread, NULL);
-	return 0;
-}
-
-static int FreeLinuxKeyboard(void)
-{
-	if (!keyboard.active) {
-		return -1;
-	}
-	keyboard.active = FALSE;
-	LCUIThread_Join(keyboard.tid, NULL);
-	close(keyboard.dev_fd);
-	return 0;
-}
-
-#else
-
 static void DispatchKeyboardEvent(void *arg1, void *arg2)
 {
 	wchar_t str[2];
@@ -149,18 +97,18 @@ static void DispatchKeyboardEvent(void *arg1, void *arg2)
 	}
 	DEBUG_MSG("%c, %d\n", ev.key.code, ev.key.code);
 	ev.type = LCUI_KEYDOWN;
-	LCUI_TriggerEvent(&ev, NULL);
+	LCUI_PostEvent(&ev);
 	LCUI_DestroyEvent(&ev);
 	/* FIXME: this driver is not yet possible to get the key state directly,
 	 * the following is a temporary solution.
 	 */
 	ev.type = LCUI_KEYUP;
-	LCUI_TriggerEvent(&ev, NULL);
+	LCUI_PostEvent(&ev);
 	LCUI_DestroyEvent(&ev);
 	if (ev.key.code >= ' ' && ev.key.code <= '~') {
 		str[0] = ev.key.code;
 		ev.type = LCUI_KEYPRESS;
-		LCUI_TriggerEvent(&ev, NULL);
+		LCUI_PostEvent(&ev);
 		LCUI_DestroyEvent(&ev);
 		LCUIIME_Commit(str, 1);
 	}
@@ -266,7 +214,13 @@ static int FreeLinuxKeyboard(void)
 	return 0;
 }
 
-#endif
+/** evdev 驱动在输入线程中产生字符，需要在主线程中提交给输入法 */
+static void OnKeyPress(LCUI_SysEvent e, void *arg)
+{
+	wchar_t text[2] = { e->key.code, 0 };
+
+	LCUIIME_Commit(text, 1);
+}
 
 void LCUI_InitLinuxKeyboard(void)
 {
@@ -276,6 +230,13 @@ void LCUI_InitLinuxKeyboard(void)
 		return;
 	}
 #endif
+	if (LCUI_InitLinuxInput() > 0) {
+		keyboard.evdev = TRUE;
+		keyboard.handler_id =
+		    LCUI_BindEvent(LCUI_KEYPRESS, OnKeyPress, NULL, NULL);
+		return;
+	}
+	LCUI_FreeLinuxInput();
 	InitLinuxKeybord();
 }
 
@@ -287,6 +248,12 @@ void LCUI_FreeLinuxKeyboard(void)
 		return;
 	}
 #endif
+	if (keyboard.evdev) {
+		keyboard.evdev = FALSE;
+		LCUI_UnbindEvent(keyboard.handler_id);
+		LCUI_FreeLinuxInput();
+		return;
+	}
 	FreeLinuxKeyboard();
 }
 
@@ -47,6 +47,7 @@
 #include <LCUI/display.h>
 #include LCUI_EVENTS_H
 #include LCUI_MOUSE_H
+#include <LCUI/platform/linux/linux_input.h>
 
 enum MouseButtonId { MOUSE_BUTTON_LEFT = 1, MOUSE_BUTTON_RIGHT = 1 << 1 };
 
@@ -60,6 +61,7 @@ static struct LCUI_LinuxMouseDriver {
 
 	LCUI_Thread tid;
 	LCUI_BOOL active;
+	LCUI_BOOL evdev;
 } mouse;
 
 static void DispathMouseButtonEvent(int button, int state)
@@ -72,7 +74,7 @@ static void DispathMouseButtonEvent(int button, int state)
 			ev.button.y = mouse.y;
 			ev.button.button = button;
 			mouse.button_state[button - 1] = 0;
-			LCUI_TriggerEvent(&ev, NULL);
+			LCUI_PostEvent(&ev);
 			LCUI_DestroyEvent(&ev);
 		}
 	} else if (state & button) {
@@ -81,14 +83,14 @@ static void DispathMouseButtonEvent(int button, int state)
 		ev.button.y = mouse.y;
 		ev.button.button = button;
 		mouse.button_state[button - 1] = 1;
-		LCUI_TriggerEvent(&ev, NULL);
+		LCUI_PostEvent(&ev);
 		LCUI_DestroyEvent(&ev);
 	}
 }
 
-static void DispatchMouseEvent(void *arg1, void *arg2)
+/** 将数据包转换成输入事件，投递给主循环，连续的移动事件会在队列中合并 */
+static void DispatchMouseEvent(const char *buf)
 {
-	char *buf = arg1;
 	int state = buf[0] & 0x07;
 	LCUI_SysEventRec ev = { 0 };
 
@@ -103,7 +105,7 @@ static void DispatchMouseEvent(void *arg1, void *arg2)
 	ev.motion.y = mouse.y;
 	ev.motion.xrel = buf[1];
 	ev.motion.yrel = -buf[2];
-	LCUI_TriggerEvent(&ev, NULL);
+	LCUI_PostEvent(&ev);
 	LCUI_DestroyEvent(&ev);
 	DispathMouseButtonEvent(MOUSE_BUTTON_LEFT, state);
 	DispathMouseButtonEvent(MOUSE_BUTTON_RIGHT, state);
@@ -114,11 +116,8 @@ static void LinuxMouseThread(void *arg)
 	char buf[6];
 	fd_set readfds;
 	struct timeval tv;
-	LCUI_TaskRec task = { 0 };
 
 	mouse.active = TRUE;
-	task.func = DispatchMouseEvent;
-	task.destroy_arg[0] = free;
 	while (mouse.active) {
 		tv.tv_sec = 0;
 		tv.tv_usec = 500000;
@@ -130,13 +129,7 @@ static void LinuxMouseThread(void *arg)
 			if (read(mouse.dev_fd, buf, 6) <= 0) {
 				continue;
 			}
-			task.arg[0] = malloc(sizeof(char) * 6);
-			if (!task.arg[0]) {
-				perror("[input] mouse driver");
-				continue;
-			}
-			memcpy(task.arg[0], buf, sizeof(char) * 6);
-			LCUI_PostTask(&task);
+			DispatchMouseEvent(buf);
 		}
 	}
 }
@@ -176,6 +169,12 @@ void LCUI_InitLinuxMouse(void)
 		return;
 	}
 #endif
+	/* 优先使用 evdev 驱动，没有可用的设备时再读取 /dev/input/mice */
+	if (LCUI_InitLinuxInput() > 0) {
+		mouse.evdev = TRUE;
+		return;
+	}
+	LCUI_FreeLinuxInput();
 	InitLinuxMouse();
 }
 
@@ -187,6 +186,11 @@ void LCUI_FreeLinuxMouse(void)
 		return;
 	}
 #endif
+	if (mouse.evdev) {
+		mouse.evdev = FALSE;
+		LCUI_FreeLinuxInput();
+		return;
+	}
 	FreeLinuxMouse();
 }
 
@@ -40,6 +40,12 @@
 #include LCUI_DISPLAY_H
 #include LCUI_EVENTS_H
 
+#ifdef USE_X11_SHM
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <X11/extensions/XShm.h>
+#endif
+
 #define MIN_WIDTH 320
 #define MIN_HEIGHT 240
 
@@ -83,6 +89,10 @@ typedef struct LCUI_SurfaceRec_ {
 	LCUI_SurfaceTasks tasks;
 	LinkedList rects;    /**< 列表，记录当前需要重绘的区域 */
 	LinkedListNode node; /**< 在表面列表中的结点 */
+#ifdef USE_X11_SHM
+	XShmSegmentInfo shminfo; /**< 帧缓存所在的共享内存段 */
+	LCUI_BOOL shm_pending; /**< 标志，标识 X 服务器是否还在读取帧缓存 */
+#endif
 } LCUI_SurfaceRec;
 
 static struct X11_Display {
@@ -90,6 +100,11 @@ static struct X11_Display {
 	LinkedList surfaces;       /**< 表面列表 */
 	LCUI_X11AppDriver app;     /**< X11 应用驱动 */
 	LCUI_EventTrigger trigger; /**< 事件触发器 */
+#ifdef USE_X11_SHM
+	LCUI_BOOL shm_enabled; /**< 是否通过 MIT-SHM 扩展呈现帧缓存 */
+	LCUI_BOOL shm_error;   /**< 标志，标识关联共享内存段时是否出错 */
+	int shm_completion;    /**< ShmCompletion 事件的类型 */
+#endif
 } x11 = { 0 };
 
 static void X11Surface_ReleaseTask(LCUI_Surface surface, int type)
@@ -120,6 +135,138 @@ static LCUI_Surface GetSurfaceByWindow(Window win)
 	return NULL;
 }
 
+#ifdef USE_X11_SHM
+static Bool X11Surface_IsShmCompletion(Display *dpy, XEvent *ev, XPointer arg)
+{
+	LCUI_Surface s = (LCUI_Surface)arg;
+	XShmCompletionEvent *sce = (XShmCompletionEvent *)ev;
+	return ev->type == x11.shm_completion && sce->drawable == s->window;
+}
+
+/** 等待 X 服务器读取完帧缓存，在此之前不能修改帧缓存中的数据 */
+static void X11Surface_WaitShmCompletion(LCUI_Surface s)
+{
+	XEvent ev;
+	if (s->shm_pending) {
+		XIfEvent(x11.app->display, &ev, X11Surface_IsShmCompletion,
+			 (XPointer)s);
+		s->shm_pending = FALSE;
+	}
+}
+
+static int X11Display_OnShmError(Display *dpy, XErrorEvent *ev)
+{
+	x11.shm_error = TRUE;
+	return 0;
+}
+
+/** 在共享内存中创建帧缓存，X 服务器可以直接读取其中的数据 */
+static LCUI_BOOL X11Surface_CreateShmImage(LCUI_Surface s, Visual *visual,
+					   int depth)
+{
+	XErrorHandler handler;
+	XShmSegmentInfo *info = &s->shminfo;
+	Display *dpy = x11.app->display;
+
+	if (!x11.shm_enabled) {
+		return FALSE;
+	}
+	s->ximage = XShmCreateImage(dpy, visual, depth, ZPixmap, NULL, info,
+				    s->width, s->height);
+	if (!s->ximage) {
+		return FALSE;
+	}
+	info->shmid = shmget(IPC_PRIVATE,
+			     s->ximage->bytes_per_line * s->ximage->height,
+			     IPC_CREAT | 0600);
+	if (info->shmid < 0) {
+		XDestroyImage(s->ximage);
+		s->ximage = NULL;
+		return FALSE;
+	}
+	info->shmaddr = shmat(info->shmid, NULL, 0);
+	info->readOnly = False;
+	if (info->shmaddr == (char *)-1) {
+		shmctl(info->shmid, IPC_RMID, NULL);
+		info->shmaddr = NULL;
+		XDestroyImage(s->ximage);
+		s->ximage = NULL;
+		return FALSE;
+	}
+	/* 如果 X 服务器不在本机上，关联共享内存段会失败 */
+	XSync(dpy, False);
+	x11.shm_error = FALSE;
+	handler = XSetErrorHandler(X11Display_OnShmError);
+	XShmAttach(dpy, info);
+	XSync(dpy, False);
+	XSetErrorHandler(handler);
+	/* 标记为删除，等到双方都分离后，共享内存段会被自动销毁 */
+	shmctl(info->shmid, IPC_RMID, NULL);
+	if (x11.shm_error) {
+		Logger_Warning("[x11display] MIT-SHM is not available, "
+			       "fall back to XPutImage.\n");
+		x11.shm_enabled = FALSE;
+		shmdt(info->shmaddr);
+		info->shmaddr = NULL;
+		XDestroyImage(s->ximage);
+		s->ximage = NULL;
+		return FALSE;
+	}
+	s->ximage->data = info->shmaddr;
+	s->fb.width = s->width;
+	s->fb.height = s->height;
+	s->fb.bytes = (uchar_t *)info->shmaddr;
+	s->fb.bytes_per_pixel = s->ximage->bits_per_pixel / 8;
+	s->fb.bytes_per_row = s->ximage->bytes_per_line;
+	s->fb.mem_size = s->fb.bytes_per_row * s->fb.height;
+	return TRUE;
+}
+#else
+static LCUI_BOOL X11Surface_CreateShmImage(LCUI_Surface s, Visual *visual,
+					   int depth)
+{
+	return FALSE;
+}
+#endif
+
+static LCUI_BOOL X11Surface_CreateImage(LCUI_Surface s, Visual *visual,
+					int depth)
+{
+	Graph_Create(&s->fb, s->width, s->height);
+	s->ximage = XCreateImage(x11.app->display, visual, depth, ZPixmap, 0,
+				 (char *)(s->fb.bytes), s->width, s->height,
+				 32, 0);
+	if (!s->ximage) {
+		Graph_Free(&s->fb);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+static void X11Surface_DestroyImage(LCUI_Surface s)
+{
+	if (!s->ximage) {
+		return;
+	}
+#ifdef USE_X11_SHM
+	if (s->shminfo.shmaddr) {
+		X11Surface_WaitShmCompletion(s);
+		XShmDetach(x11.app->display, &s->shminfo);
+		XDestroyImage(s->ximage);
+		shmdt(s->shminfo.shmaddr);
+		s->shminfo.shmaddr = NULL;
+		s->ximage = NULL;
+		/* 帧缓冲指向已分离的共享内存段，不能再被释放或复用 */
+		Graph_Init(&s->fb);
+		return;
+	}
+#endif
+	/* XDestroyImage() 会一同释放帧缓冲的像素数据 */
+	XDestroyImage(s->ximage);
+	s->ximage = NULL;
+	Graph_Init(&s->fb);
+}
+
 static void X11Surface_OnResize(LCUI_Surface s, int width, int height)
 {
 	int depth;
@@ -128,10 +275,7 @@ static void X11Surface_OnResize(LCUI_Surface s, int width, int height)
 	if (width == s->width && height == s->height && s->ximage && s->gc) {
 		return;
 	}
-	if (s->ximage) {
-		XDestroyImage(s->ximage);
-		s->ximage = NULL;
-	}
+	X11Surface_DestroyImage(s);
 	if (s->gc) {
 		XFreeGC(x11.app->display, s->gc);
 		s->gc = NULL;
@@ -149,12 +293,9 @@ static void X11Surface_OnResize(LCUI_Surface s, int width, int height)
 		Logger_Error("[x11display] unsupport depth: %d.\n", depth);
 		break;
 	}
-	Graph_Create(&s->fb, width, height);
 	visual = DefaultVisual(x11.app->display, x11.app->screen);
-	s->ximage = XCreateImage(x11.app->display, visual, depth, ZPixmap, 0,
-				 (char *)(s->fb.bytes), width, height, 32, 0);
-	if (!s->ximage) {
-		Graph_Free(&s->fb);
+	if (!X11Surface_CreateShmImage(s, visual, depth) &&
+	    !X11Surface_CreateImage(s, visual, depth)) {
 		Logger_Error("[x11display] create XImage faild.\n");
 		return;
 	}
@@ -239,9 +380,7 @@ static void OnDestroySurface(void *data)
 {
 	LCUI_Surface s = data;
 	X11Surface_ClearTasks(s);
-	if (s->ximage) {
-		XDestroyImage(s->ximage);
-	}
+	X11Surface_DestroyImage(s);
 	if (s->gc) {
 		XFreeGC(x11.app->display, s->gc);
 	}
@@ -267,6 +406,10 @@ static LCUI_Surface X11Surface_New(void)
 	surface = NEW(LCUI_SurfaceRec, 1);
 	surface->gc = NULL;
 	surface->ximage = NULL;
+#ifdef USE_X11_SHM
+	surface->shminfo.shmaddr = NULL;
+	surface->shm_pending = FALSE;
+#endif
 	surface->is_ready = FALSE;
 	surface->node.data = surface;
 	surface->width = MIN_WIDTH;
@@ -344,6 +487,9 @@ static LCUI_PaintContext X11Surface_BeginPaint(LCUI_Surface surface,
 	paint->with_alpha = FALSE;
 	Graph_Init(&paint->canvas);
 	LCUIMutex_Lock(&surface->mutex);
+#ifdef USE_X11_SHM
+	X11Surface_WaitShmCompletion(surface);
+#endif
 	LCUIRect_ValidateArea(&paint->rect, surface->width, surface->height);
 	Graph_Quote(&paint->canvas, &surface->fb, &paint->rect);
 	Graph_FillRect(&paint->canvas, RGB(255, 255, 255), NULL, TRUE);
@@ -363,14 +509,38 @@ static void X11Surface_EndPaint(LCUI_Surface surface, LCUI_PaintContext paint)
 /** 将帧缓存中的数据呈现至Surface的窗口内 */
 static void X11Surface_Present(LCUI_Surface surface)
 {
+	LCUI_Rect *rect;
 	LinkedListNode *node;
+	Display *dpy = x11.app->display;
+
 	LCUIMutex_Lock(&surface->mutex);
+#ifdef USE_X11_SHM
+	/*
+	 * 共享内存中的图像数据不需要经过套接字传输，所有区域的请求都只是一些
+	 * 坐标，等到最后一个区域呈现完后，再让 X 服务器发送 ShmCompletion 事件
+	 */
+	if (surface->shminfo.shmaddr && surface->rects.length > 0) {
+		for (LinkedList_Each(node, &surface->rects)) {
+			rect = node->data;
+			XShmPutImage(dpy, surface->window, surface->gc,
+				     surface->ximage, rect->x, rect->y,
+				     rect->x, rect->y, rect->width,
+				     rect->height, node->next == NULL);
+		}
+		surface->shm_pending = TRUE;
+		XSync(dpy, False);
+		LinkedList_Clear(&surface->rects, free);
+		LCUIMutex_Unlock(&surface->mutex);
+		return;
+	}
+#endif
 	for (LinkedList_Each(node, &surface->rects)) {
-		LCUI_Rect *rect = node->data;
-		XPutImage(x11.app->display, surface->window, surface->gc,
-			  surface->ximage, rect->x, rect->y, rect->x, rect->y,
-			  rect->width, rect->height);
+		rect = node->data;
+		XPutImage(dpy, surface->window, surface->gc, surface->ximage,
+			  rect->x, rect->y, rect->x, rect->y, rect->width,
+			  rect->height);
 	}
+	XFlush(dpy);
 	LinkedList_Clear(&surface->rects, free);
 	LCUIMutex_Unlock(&surface->mutex);
 }
@@ -421,6 +591,33 @@ static int X11Display_GetHeight(void)
 	return XHeightOfScreen(s);
 }
 
+#ifdef USE_X11_SHM
+/** 响应 ShmCompletion 事件，它在 X 服务器读取完共享内存中的数据后触发 */
+static void OnShmCompletion(LCUI_Event e, void *arg)
+{
+	XShmCompletionEvent *ev = arg;
+	LCUI_Surface s = GetSurfaceByWindow(ev->drawable);
+	if (s) {
+		s->shm_pending = FALSE;
+	}
+}
+
+static LCUI_BOOL X11Display_InitShm(void)
+{
+	Display *dpy = x11.app->display;
+
+	if (getenv("LCUI_X11_DISABLE_SHM")) {
+		return FALSE;
+	}
+	if (!XShmQueryExtension(dpy)) {
+		return FALSE;
+	}
+	x11.shm_completion = XShmGetEventBase(dpy) + ShmCompletion;
+	LCUI_BindSysEvent(x11.shm_completion, OnShmCompletion, NULL, NULL);
+	return TRUE;
+}
+#endif
+
 static void OnExpose(LCUI_Event e, void *arg)
 {
 	LCUI_Rect rect;
@@ -491,6 +688,9 @@ LCUI_DisplayDriver LCUI_CreateLinuxX11DisplayDriver(void)
 	LinkedList_Init(&x11.surfaces);
 	LCUI_BindSysEvent(Expose, OnExpose, NULL, NULL);
 	LCUI_BindSysEvent(ConfigureNotify, OnConfigureNotify, NULL, NULL);
+#ifdef USE_X11_SHM
+	x11.shm_enabled = X11Display_InitShm();
+#endif
 	x11.trigger = EventTrigger();
 	x11.is_inited = TRUE;
 	return driver;
@@ -502,6 +702,12 @@ void LCUI_DestroyLinuxX11DisplayDriver(LCUI_DisplayDriver driver)
 	LinkedList_ClearData(&x11.surfaces, OnDestroySurface);
 	LCUI_UnbindSysEvent(ConfigureNotify, OnConfigureNotify);
 	LCUI_UnbindSysEvent(Expose, OnExpose);
+#ifdef USE_X11_SHM
+	if (x11.shm_enabled) {
+		LCUI_UnbindSysEvent(x11.shm_completion, OnShmCompletion);
+		x11.shm_enabled = FALSE;
+	}
+#endif
 	x11.trigger = NULL;
 	x11.is_inited = FALSE;
 	free(driver);
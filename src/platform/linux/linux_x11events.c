@@ -53,26 +53,6 @@ void LCUI_SetLinuxX11MainWindow(Window win)
 	XFlush(x11.display);
 }
 
-static LCUI_BOOL X11_WaitEvent(void)
-{
-	int fd;
-	fd_set fdset;
-	struct timeval tv;
-	XFlush(x11.display);
-	fd = ConnectionNumber(x11.display);
-	if (XEventsQueued(x11.display, QueuedAlready)) {
-		return TRUE;
-	}
-	FD_ZERO(&fdset);
-	FD_SET(fd, &fdset);
-	tv.tv_sec = 0;
-	tv.tv_usec = 10000;
-	if (select(fd + 1, &fdset, NULL, NULL, &tv) == 1) {
-		return XPending(x11.display);
-	}
-	return FALSE;
-}
-
 static LCUI_BOOL X11_DispatchEvent(void)
 {
 	XEvent xevent;
@@ -92,12 +72,25 @@ static LCUI_BOOL X11_DispatchEvent(void)
 static void X11_ProcessEvents(void)
 {
 	int i;
-	if (!X11_WaitEvent()) {
+	/*
+	 * 这里不再等待事件，主循环会在空闲时等待与 X 服务器的连接可读，
+	 * XPending() 只会读取已经到达的事件
+	 */
+	if (!XPending(x11.display)) {
 		return;
 	}
 	for (i = 0; X11_DispatchEvent() && i < 100; ++i);
 }
 
+static LCUI_BOOL X11_HasPendingEvents(void)
+{
+	/*
+	 * 其它 Xlib 调用可能已经把事件读取到了队列中，连接不会再变为可读，
+	 * 所以在主循环进入等待前需要检查队列
+	 */
+	return XEventsQueued(x11.display, QueuedAfterFlush) > 0;
+}
+
 static int X11_BindSysEvent(int event_id, LCUI_EventFunc func, void *data,
 			    void (*destroy_data)(void *))
 {
@@ -138,18 +131,21 @@ LCUI_AppDriver LCUI_CreateLinuxX11AppDriver(void)
 	x11.cmap = DefaultColormap(x11.display, x11.screen);
 	x11.wm_delete = XInternAtom(x11.display, "WM_DELETE_WINDOW", FALSE);
 	app->ProcessEvents = X11_ProcessEvents;
+	app->HasPendingEvents = X11_HasPendingEvents;
 	app->BindSysEvent = X11_BindSysEvent;
 	app->UnbindSysEvent = X11_UnbindSysEvent;
 	app->UnbindSysEvent2 = X11_UnbindSysEvent2;
 	app->GetData = X11_GetData;
 	app->id = LCUI_APP_LINUX_X11;
 	x11.trigger = EventTrigger();
+	LCUI_WatchFd(ConnectionNumber(x11.display));
 	return app;
 }
 
 void LCUI_DestroyLinuxX11AppDriver(LCUI_AppDriver app)
 {
 	EventTrigger_Destroy(x11.trigger);
+	LCUI_UnwatchFd(ConnectionNumber(x11.display));
 	XCloseDisplay(x11.display);
 	x11.trigger = NULL;
 	free(app);
@@ -140,13 +140,13 @@ static void OnKeyboardMessage(LCUI_Event ev, void *arg)
 	sys_ev.key.ctrl_key = x_ev->xkey.state & ControlMask ? TRUE : FALSE;
 	_DEBUG_MSG("shift: %d, ctrl: %d\n", sys_ev.key.shift_key,
 		   sys_ev.key.ctrl_key);
-	LCUI_TriggerEvent(&sys_ev, NULL);
+	LCUI_PostEvent(&sys_ev);
 	if (keysym >= XK_space && keysym <= XK_asciitilde &&
 	    sys_ev.type == LCUI_KEYDOWN) {
 		sys_ev.type = LCUI_KEYPRESS;
 		sys_ev.key.code = ConvertKeyCodeToChar(x11, x_ev);
 		_DEBUG_MSG("char: %c\n", sys_ev.key.code);
-		LCUI_TriggerEvent(&sys_ev, NULL);
+		LCUI_PostEvent(&sys_ev);
 	}
 }
 
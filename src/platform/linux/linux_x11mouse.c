@@ -52,7 +52,7 @@ static void OnMotionNotify(LCUI_Event e, void *arg)
 	sys_ev.motion.yrel = ev->xmotion.y - mouse_pos.y;
 	mouse_pos.x = ev->xmotion.x;
 	mouse_pos.y = ev->xmotion.y;
-	LCUI_TriggerEvent(&sys_ev, NULL);
+	LCUI_PostEvent(&sys_ev);
 	LCUI_DestroyEvent(&sys_ev);
 }
 
@@ -77,7 +77,7 @@ static void OnButtonPress(LCUI_Event e, void *arg)
 		sys_ev.button.y = ev->xbutton.y;
 		sys_ev.button.button = ev->xbutton.button;
 	}
-	LCUI_TriggerEvent(&sys_ev, NULL);
+	LCUI_PostEvent(&sys_ev);
 	LCUI_DestroyEvent(&sys_ev);
 }
 
@@ -89,7 +89,7 @@ static void OnButtonRelease(LCUI_Event e, void *arg)
 	sys_ev.button.x = ev->xbutton.x;
 	sys_ev.button.y = ev->xbutton.y;
 	sys_ev.button.button = ev->xbutton.button;
-	LCUI_TriggerEvent(&sys_ev, NULL);
+	LCUI_PostEvent(&sys_ev);
 	LCUI_DestroyEvent(&sys_ev);
 }
 
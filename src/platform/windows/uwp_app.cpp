@@ -89,6 +89,7 @@ static LCUI_AppDriver LCUI_CreateUWPAppDriver(App^ app)
 	driver->UnbindSysEvent = UWPApp_UnbindSysEvent;
 	driver->UnbindSysEvent2 = UWPApp_UnbindSysEvent2;
 	driver->ProcessEvents = UWPApp_ProcessEvents;
+	driver->HasPendingEvents = NULL;
 	driver->GetData = UWPApp_GetData;
 	UWPApp.core = app;
 	return driver;
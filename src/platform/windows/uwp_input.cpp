@@ -125,7 +125,7 @@ void InputDriver::OnPointerPressed(CoreWindow^ sender,
 		ev.type = LCUI_TOUCH;
 		tp = AddTouchPoint(&m_touch.points, point, LCUI_TOUCHDOWN);
 		CreateTouchEvent(&ev, &m_touch.points);
-		LCUI_TriggerEvent(&ev, NULL);
+		LCUI_PostEvent(&ev);
 		LCUI_DestroyEvent(&ev);
 		ClearInvalidTouchPoints(&m_touch.points);
 		/* 如果该触点是主触点，则顺便触发鼠标事件 */
@@ -146,7 +146,7 @@ void InputDriver::OnPointerPressed(CoreWindow^ sender,
 	ev.button.x = pos.x;
 	ev.button.y = pos.y;
 	LCUICursor_SetPos(pos);
-	LCUI_TriggerEvent(&ev, NULL);
+	LCUI_PostEvent(&ev);
 }
 
 void InputDriver::OnPointerMoved(CoreWindow^ sender, PointerEventArgs^ args)
@@ -165,7 +165,7 @@ void InputDriver::OnPointerMoved(CoreWindow^ sender, PointerEventArgs^ args)
 		tp = AddTouchPoint(&m_touch.points, point, LCUI_TOUCHMOVE);
 		CreateTouchEvent(&ev, &m_touch.points);
 		ClearInvalidTouchPoints(&m_touch.points);
-		LCUI_TriggerEvent(&ev, NULL);
+		LCUI_PostEvent(&ev);
 		LCUI_DestroyEvent(&ev);
 		if (tp->is_primary) {
 			break;
@@ -184,7 +184,7 @@ void InputDriver::OnPointerMoved(CoreWindow^ sender, PointerEventArgs^ args)
 	ev.motion.xrel = iround(position.X - m_mouse.position.Y);
 	ev.motion.yrel = iround(position.Y - m_mouse.position.Y);
 	m_mouse.position = position;
-	LCUI_TriggerEvent(&ev, NULL);
+	LCUI_PostEvent(&ev);
 	LCUI_DestroyEvent(&ev);
 	LCUICursor_SetPos(pos);
 }
@@ -215,7 +215,7 @@ void InputDriver::OnPointerReleased(CoreWindow^ sender, PointerEventArgs^ args)
 		tp = AddTouchPoint(&m_touch.points, point, LCUI_TOUCHUP);
 		CreateTouchEvent(&ev, &m_touch.points);
 		ClearInvalidTouchPoints(&m_touch.points);
-		LCUI_TriggerEvent(&ev, NULL);
+		LCUI_PostEvent(&ev);
 		LCUI_DestroyEvent(&ev);
 		if (tp->is_primary) {
 			m_mouse.leftButtonPressed = false;
@@ -229,7 +229,7 @@ void InputDriver::OnPointerReleased(CoreWindow^ sender, PointerEventArgs^ args)
 	pos.y = iround(position.Y);
 	ev.button.x = pos.x;
 	ev.button.y = pos.y;
-	LCUI_TriggerEvent(&ev, NULL);
+	LCUI_PostEvent(&ev);
 	LCUI_DestroyEvent(&ev);
 	LCUICursor_SetPos(pos);
 }
@@ -245,7 +245,7 @@ void InputDriver::OnPointerWheelChanged(CoreWindow^ sender, PointerEventArgs^ ar
 	ev.wheel.x = (int)(position.X + 0.5);
 	ev.wheel.y = (int)(position.Y + 0.5);
 	ev.wheel.delta = pointProps->MouseWheelDelta;;
-	LCUI_TriggerEvent(&ev, NULL);
+	LCUI_PostEvent(&ev);
 	LCUI_DestroyEvent(&ev);
 }
 
@@ -256,7 +256,7 @@ void InputDriver::OnKeyDown(CoreWindow^ sender, KeyEventArgs^ args)
 	ev.key.ctrl_key = FALSE;
 	ev.key.shift_key = FALSE;
 	ev.key.code = static_cast<int>(args->VirtualKey);
-	LCUI_TriggerEvent(&ev, NULL);
+	LCUI_PostEvent(&ev);
 	LCUI_DestroyEvent(&ev);
 }
 
@@ -267,7 +267,7 @@ void InputDriver::OnKeyUp(CoreWindow^ sender, KeyEventArgs^ args)
 	ev.key.ctrl_key = FALSE;
 	ev.key.shift_key = FALSE;
 	ev.key.code = static_cast<int>(args->VirtualKey);
-	LCUI_TriggerEvent(&ev, NULL);
+	LCUI_PostEvent(&ev);
 	LCUI_DestroyEvent(&ev);
 }
 
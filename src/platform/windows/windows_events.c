@@ -163,6 +163,7 @@ LCUI_AppDriver LCUI_CreateWinAppDriver(void)
 	app->id = LCUI_APP_WINDOWS;
 	app->GetData = WIN_GetData;
 	app->ProcessEvents = WIN_ProcessEvents;
+	app->HasPendingEvents = NULL;
 	app->BindSysEvent = WIN_BindSysEvent;
 	app->UnbindSysEvent = WIN_UnbindSysEvent;
 	app->UnbindSysEvent2 = WIN_UnbindSysEvent2;
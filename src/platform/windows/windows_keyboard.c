@@ -52,7 +52,7 @@ static void OnKeyboardMessage(LCUI_Event ev, void *arg)
 	sys_ev.key.code = msg->wParam;
 	sys_ev.key.shift_key = (GetKeyState(VK_SHIFT) & 0x8000) ? TRUE : FALSE;
 	sys_ev.key.ctrl_key = (GetKeyState(VK_CONTROL) & 0x8000) ? TRUE : FALSE;
-	LCUI_TriggerEvent(&sys_ev, NULL);
+	LCUI_PostEvent(&sys_ev);
 }
 
 void LCUI_InitWinKeyboard(void)
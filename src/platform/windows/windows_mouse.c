@@ -144,7 +144,7 @@ static void OnMouseMessage(LCUI_Event ev, void *arg)
 	default: break;
 	}
 	if (sys_ev.type != LCUI_NONE) {
-		LCUI_TriggerEvent(&sys_ev, NULL);
+		LCUI_PostEvent(&sys_ev);
 		LCUI_DestroyEvent(&sys_ev);
 	}
 }
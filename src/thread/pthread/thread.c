@@ -36,11 +36,18 @@
 
 #ifdef LCUI_THREAD_PTHREAD
 
+typedef struct LCUI_ThreadExitFuncRec_ {
+	void (*func)(void *);
+	void *arg;
+	struct LCUI_ThreadExitFuncRec_ *next;
+} LCUI_ThreadExitFuncRec, *LCUI_ThreadExitFunc;
+
 typedef struct LCUI_ThreadContextRec {
 	void (*func)(void *);
 	void *arg;
 	LCUI_Thread tid;
 	LinkedListNode node;
+	LCUI_ThreadExitFunc exit_funcs;
 } LCUI_ThreadContextRec, *LCUI_ThreadContext;
 
 static struct LCUIThreadModule {
@@ -49,10 +56,24 @@ static struct LCUIThreadModule {
 	LinkedList threads;
 } self;
 
+/** 按照与注册时相反的顺序调用线程退出时的回调函数 */
+static void LCUIThread_RunExitFuncs(LCUI_ThreadContext ctx)
+{
+	LCUI_ThreadExitFunc f;
+
+	while (ctx->exit_funcs) {
+		f = ctx->exit_funcs;
+		ctx->exit_funcs = f->next;
+		f->func(f->arg);
+		free(f);
+	}
+}
+
 static void *LCUIThread_Run(void *arg)
 {
 	LCUI_ThreadContext ctx = arg;
 	ctx->func(ctx->arg);
+	LCUIThread_RunExitFuncs(ctx);
 	LCUIMutex_Lock(&self.mutex);
 	LinkedList_Unlink(&self.threads, &ctx->node);
 	LCUIMutex_Unlock(&self.mutex);
@@ -101,15 +122,17 @@ int LCUIThread_Create(LCUI_Thread *thread, void (*func)(void *), void *arg)
 	ctx->arg = arg;
 	ctx->func = func;
 	ctx->node.data = ctx;
+	/* 在线程被记录到列表之前，阻止它退出并移除自己 */
+	LCUIMutex_Lock(&self.mutex);
 	ret = pthread_create(&ctx->tid, NULL, LCUIThread_Run, ctx);
 	if (ret != 0) {
+		LCUIMutex_Unlock(&self.mutex);
 		free(ctx);
 		return ret;
 	}
-	LCUIMutex_Lock(&self.mutex);
 	LinkedList_AppendNode(&self.threads, &ctx->node);
-	LCUIMutex_Unlock(&self.mutex);
 	*thread = ctx->tid;
+	LCUIMutex_Unlock(&self.mutex);
 	return ret;
 }
 
@@ -125,11 +148,36 @@ void LCUIThread_Exit(void *retval)
 	tid = LCUIThread_SelfID();
 	ctx = LCUIThread_Get(tid);
 	if (ctx) {
+		LCUIThread_RunExitFuncs(ctx);
 		free(ctx);
 	}
 	pthread_exit(retval);
 }
 
+int LCUIThread_AtExit(void (*func)(void *), void *arg)
+{
+	LCUI_ThreadExitFunc f;
+	LCUI_ThreadContext ctx = NULL;
+
+	if (self.is_inited) {
+		LCUIMutex_Lock(&self.mutex);
+		ctx = LCUIThread_Find(LCUIThread_SelfID());
+		LCUIMutex_Unlock(&self.mutex);
+	}
+	if (!ctx) {
+		return -1;
+	}
+	f = malloc(sizeof(LCUI_ThreadExitFuncRec));
+	if (!f) {
+		return -ENOMEM;
+	}
+	f->func = func;
+	f->arg = arg;
+	f->next = ctx->exit_funcs;
+	ctx->exit_funcs = f;
+	return 0;
+}
+
 void LCUIThread_Cancel(LCUI_Thread thread)
 {
 #ifdef PTHREAD_CANCEL_ASYNCHRONOUS
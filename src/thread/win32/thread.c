@@ -36,6 +36,12 @@
 #include <process.h>
 #include <windows.h>
 
+typedef struct LCUI_ThreadExitFuncRec_ {
+	void (*func)(void *);
+	void *arg;
+	struct LCUI_ThreadExitFuncRec_ *next;
+} LCUI_ThreadExitFuncRec, *LCUI_ThreadExitFunc;
+
 typedef struct _LCUI_ThreadContextRec_ {
 	HANDLE handle;
 	unsigned int tid;
@@ -44,6 +50,7 @@ typedef struct _LCUI_ThreadContextRec_ {
 	void *retval;
 	LCUI_BOOL has_waiter;
 	LinkedListNode node;
+	LCUI_ThreadExitFunc exit_funcs;
 } LCUI_ThreadContextRec, *LCUI_ThreadContext;
 
 static struct LCUIThreadModule {
@@ -52,12 +59,26 @@ static struct LCUIThreadModule {
 	LinkedList threads;
 } self;
 
+/** 按照与注册时相反的顺序调用线程退出时的回调函数 */
+static void LCUIThread_RunExitFuncs(LCUI_ThreadContext ctx)
+{
+	LCUI_ThreadExitFunc f;
+
+	while (ctx->exit_funcs) {
+		f = ctx->exit_funcs;
+		ctx->exit_funcs = f->next;
+		f->func(f->arg);
+		free(f);
+	}
+}
+
 static unsigned __stdcall run_thread(void *arg)
 {
 	LCUI_ThreadContext thread;
 
 	thread = (LCUI_ThreadContext)arg;
 	thread->func(thread->arg);
+	LCUIThread_RunExitFuncs(thread);
 	return 0;
 }
 
@@ -78,13 +99,16 @@ int LCUIThread_Create(LCUI_Thread *tid, void(*func)(void*), void *arg)
 	ctx->arg = arg;
 	ctx->retval = NULL;
 	ctx->node.data = ctx;
+	/* 在线程被记录到列表之前，阻止它查找自己的上下文 */
+	LCUIMutex_Lock(&self.mutex);
 	ctx->handle = (HANDLE)_beginthreadex(NULL, 0, run_thread,
 					     ctx, 0, &ctx->tid);
 	if (ctx->handle == 0) {
+		LCUIMutex_Unlock(&self.mutex);
+		free(ctx);
 		*tid = 0;
 		return -1;
 	}
-	LCUIMutex_Lock(&self.mutex);
 	LinkedList_AppendNode(&self.threads, &ctx->node);
 	LCUIMutex_Unlock(&self.mutex);
 	*tid = ctx->tid;
@@ -140,6 +164,7 @@ void LCUIThread_Exit(void *retval)
 	if (!ctx) {
 		return;
 	}
+	LCUIThread_RunExitFuncs(ctx);
 	ctx->retval = retval;
 	if (!ctx->has_waiter) {
 		LCUIThread_Destroy(ctx);
@@ -197,4 +222,28 @@ int LCUIThread_Join(LCUI_Thread thread, void **retval)
 	return -1;
 }
 
+int LCUIThread_AtExit(void(*func)(void*), void *arg)
+{
+	LCUI_ThreadExitFunc f;
+	LCUI_ThreadContext ctx = NULL;
+
+	if (self.active) {
+		LCUIMutex_Lock(&self.mutex);
+		ctx = LCUIThread_Find(LCUIThread_SelfID());
+		LCUIMutex_Unlock(&self.mutex);
+	}
+	if (!ctx) {
+		return -1;
+	}
+	f = malloc(sizeof(LCUI_ThreadExitFuncRec));
+	if (!f) {
+		return -ENOMEM;
+	}
+	f->func = func;
+	f->arg = arg;
+	f->next = ctx->exit_funcs;
+	ctx->exit_funcs = f;
+	return 0;
+}
+
 #endif
@@ -29,6 +29,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <errno.h>
 #include <LCUI_Build.h>
 #include <LCUI/LCUI.h>
 #include <LCUI/thread.h>
@@ -36,6 +37,22 @@
 
 #define STATE_RUN 1
 #define STATE_PAUSE 0
+#define STATE_FREE -1
+
+/**
+ * 定时器按到期时间存放在分层的时间轮中，每层有 256 个槽，第 0 层的每个槽对应
+ * 1 毫秒，上一层的每个槽对应下一层转一圈的时长，四层共可覆盖 2^32 毫秒。时间
+ * 轮转到上一层的槽时，该槽中的定时器会按到期时间重新分配到下层的槽中，因此，
+ * 添加和移除定时器都只需要常数时间。
+ */
+#define TIMER_WHEEL_BITS 8
+#define TIMER_WHEEL_SIZE (1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_MASK (TIMER_WHEEL_SIZE - 1)
+#define TIMER_WHEEL_LEVELS 4
+#define TIMER_WHEEL_MAX_DELAY 0xffffffffLL
+
+/** 定时器池每次扩充的定时器数量 */
+#define TIMER_POOL_BLOCK_SIZE 256
 
 /*----------------------------- Timer --------------------------------*/
 
@@ -44,59 +61,271 @@ typedef struct TimerRec_ {
 	long int id;			/**< 定时器ID */
 	LCUI_BOOL reuse;		/**< 是否重复使用该定时器 */
 
-	int64_t start_time;		/**< 定时器启动时的时间 */
-	int64_t pause_time;		/**< 定时器暂停时的时间 */
+	int64_t due_time;		/**< 到期时间 */
 	long int total_ms;		/**< 定时时间（单位：毫秒） */
-	long int pause_ms;		/**< 定时器处于暂停状态的时长（单位：毫秒） */
+	long int remain_ms;		/**< 暂停时剩余的定时时间（单位：毫秒） */
 
 	void (*callback)(void *);	/**< 回调函数 */
 	void *arg;			/**< 函数的参数 */
 
-	LinkedListNode node;		/**< 位于定时器列表中的节点 */
+	LinkedList *list;		/**< 所在的时间轮槽 */
+	LinkedListNode node;		/**< 位于时间轮槽或空闲列表中的节点 */
 } TimerRec, *Timer;
 
+/** 定时器表，以开放寻址的方式用定时器ID索引定时器 */
+typedef struct TimerTableRec_ {
+	size_t size;
+	size_t length;
+	Timer *timers;
+} TimerTableRec, *TimerTable;
+
 static struct TimerModule {
 	int id_count;         /**< 定时器ID计数 */
 	LCUI_BOOL active;     /**< 定时器线程是否正在运行 */
 	LCUI_Mutex mutex;     /**< 定时器记录操作互斥锁 */
-	LinkedList timers;    /**< 定时器数据记录 */
+	int64_t current_time; /**< 时间轮当前指向的时间 */
+	Timer firing;         /**< 正在执行回调函数的定时器 */
+	TimerTableRec table;  /**< 定时器表 */
+	LinkedList blocks;    /**< 定时器池中的内存块 */
+	LinkedList free_timers;	/**< 定时器池中空闲的定时器 */
+	LinkedList wheels[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SIZE];
 } self;
 
 /*----------------------------- Private ------------------------------*/
 
-/** 更新定时器在定时器列表中的位置 */
-static void TimerList_AddNode(LinkedListNode *node)
+static size_t TimerTable_Index(TimerTable table, long int id)
 {
-	Timer timer;
-	int64_t t, tt;
-	LinkedListNode *cur;
-	/* 计算该定时器的剩余定时时长 */
-	timer = node->data;
-	t = LCUI_GetTimeDelta(timer->start_time);
-	t = timer->total_ms - t + timer->pause_ms;
-	for (LinkedList_Each(cur, &self.timers)) {
-		timer = cur->data;
-		tt = LCUI_GetTimeDelta(timer->start_time);
-		tt = timer->total_ms - tt + timer->pause_ms;
-		if (t <= tt) {
-			LinkedList_Link(&self.timers, cur->prev, node);
+	return ((unsigned)id * 2654435761u) & (table->size - 1);
+}
+
+static Timer TimerTable_Get(TimerTable table, long int id)
+{
+	size_t i;
+
+	if (table->length < 1) {
+		return NULL;
+	}
+	i = TimerTable_Index(table, id);
+	while (table->timers[i]) {
+		if (table->timers[i]->id == id) {
+			return table->timers[i];
+		}
+		i = (i + 1) & (table->size - 1);
+	}
+	return NULL;
+}
+
+static void TimerTable_Put(TimerTable table, Timer timer)
+{
+	size_t i;
+
+	i = TimerTable_Index(table, timer->id);
+	while (table->timers[i]) {
+		i = (i + 1) & (table->size - 1);
+	}
+	table->timers[i] = timer;
+	table->length += 1;
+}
+
+static int TimerTable_Add(TimerTable table, Timer timer)
+{
+	size_t i;
+	TimerTableRec old = *table;
+
+	/* 保持负载因子不超过 0.5，以免查找时探测的次数过多 */
+	if ((table->length + 1) * 2 > table->size) {
+		table->size = old.size < 1 ? 64 : old.size * 2;
+		table->timers = calloc(table->size, sizeof(Timer));
+		if (!table->timers) {
+			*table = old;
+			return -ENOMEM;
+		}
+		table->length = 0;
+		for (i = 0; i < old.size; ++i) {
+			if (old.timers[i]) {
+				TimerTable_Put(table, old.timers[i]);
+			}
+		}
+		free(old.timers);
+	}
+	TimerTable_Put(table, timer);
+	return 0;
+}
+
+static void TimerTable_Delete(TimerTable table, Timer timer)
+{
+	size_t i, j, k;
+	size_t mask = table->size - 1;
+
+	i = TimerTable_Index(table, timer->id);
+	while (table->timers[i] != timer) {
+		if (!table->timers[i]) {
 			return;
 		}
+		i = (i + 1) & mask;
+	}
+	table->timers[i] = NULL;
+	table->length -= 1;
+	/* 将后面的元素前移，以免查找时在空位上中断 */
+	for (j = (i + 1) & mask; table->timers[j]; j = (j + 1) & mask) {
+		k = TimerTable_Index(table, table->timers[j]->id);
+		if ((j > i && (k <= i || k > j)) ||
+		    (j < i && (k <= i && k > j))) {
+			table->timers[i] = table->timers[j];
+			table->timers[j] = NULL;
+			i = j;
+		}
 	}
-	LinkedList_AppendNode(&self.timers, node);
 }
 
-static Timer FindTimer(int timer_id)
+static void TimerTable_Destroy(TimerTable table)
 {
-	Timer timer;
+	free(table->timers);
+	table->timers = NULL;
+	table->length = 0;
+	table->size = 0;
+}
+
+/** 从定时器池中取出一个定时器 */
+static Timer TimerPool_Alloc(void)
+{
+	size_t i;
+	Timer timers;
 	LinkedListNode *node;
-	for (LinkedList_Each(node, &self.timers)) {
-		timer = node->data;
-		if (timer && timer->id == timer_id) {
-			return timer;
+
+	if (self.free_timers.length < 1) {
+		timers = malloc(sizeof(TimerRec) * TIMER_POOL_BLOCK_SIZE);
+		if (!timers) {
+			return NULL;
+		}
+		LinkedList_Append(&self.blocks, timers);
+		for (i = 0; i < TIMER_POOL_BLOCK_SIZE; ++i) {
+			timers[i].node.data = &timers[i];
+			LinkedList_AppendNode(&self.free_timers,
+					      &timers[i].node);
 		}
 	}
-	return NULL;
+	node = self.free_timers.tail.prev;
+	LinkedList_Unlink(&self.free_timers, node);
+	return node->data;
+}
+
+static void TimerPool_Free(Timer timer)
+{
+	timer->state = STATE_FREE;
+	LinkedList_AppendNode(&self.free_timers, &timer->node);
+}
+
+/** 将定时器添加至时间轮中 */
+static void TimerWheel_Add(Timer timer)
+{
+	int level;
+	int64_t t, delay;
+
+	t = max(timer->due_time, self.current_time);
+	delay = min(t - self.current_time, TIMER_WHEEL_MAX_DELAY);
+	t = self.current_time + delay;
+	for (level = 0; level < TIMER_WHEEL_LEVELS - 1; ++level) {
+		if (delay < 1LL << (TIMER_WHEEL_BITS * (level + 1))) {
+			break;
+		}
+	}
+	t = (t >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK;
+	timer->list = &self.wheels[level][t];
+	LinkedList_AppendNode(timer->list, &timer->node);
+}
+
+static void TimerWheel_Remove(Timer timer)
+{
+	if (timer->list) {
+		LinkedList_Unlink(timer->list, &timer->node);
+		timer->list = NULL;
+	}
+}
+
+/** 将上层时间轮的当前槽中的定时器重新分配到下层 */
+static void TimerWheel_Cascade(int level)
+{
+	size_t i;
+	LinkedList *slot;
+	LinkedListNode *node;
+
+	i = (self.current_time >> (TIMER_WHEEL_BITS * level)) &
+	    TIMER_WHEEL_MASK;
+	if (i == 0 && level + 1 < TIMER_WHEEL_LEVELS) {
+		TimerWheel_Cascade(level + 1);
+	}
+	slot = &self.wheels[level][i];
+	while (slot->length > 0) {
+		node = slot->head.next;
+		LinkedList_Unlink(slot, node);
+		TimerWheel_Add(node->data);
+	}
+}
+
+/** 获取指定层时间轮中最早到期的定时器的到期时间，没有定时器时返回 -1 */
+static int64_t TimerWheel_GetDueTime(int level)
+{
+	size_t i, k;
+	int64_t due_time = -1;
+	LinkedList *slot;
+	LinkedListNode *node;
+	Timer timer;
+
+	i = (size_t)(self.current_time >> (TIMER_WHEEL_BITS * level));
+	/*
+	 * 当前槽中的定时器可能是刚转到这一圈还没重新分配的，也可能是要再转一圈
+	 * 才到期的，所以除了当前槽，还需要查找之后第一个非空的槽
+	 */
+	for (k = 0; k < TIMER_WHEEL_SIZE; ++k) {
+		slot = &self.wheels[level][(i + k) & TIMER_WHEEL_MASK];
+		for (LinkedList_Each(node, slot)) {
+			timer = node->data;
+			if (due_time < 0 || timer->due_time < due_time) {
+				due_time = timer->due_time;
+			}
+		}
+		if (k > 0 && slot->length > 0) {
+			break;
+		}
+	}
+	return due_time;
+}
+
+/** 唤醒主循环，让它按最早到期的定时器重新计算等待时长 */
+static void TimerModule_WakeUp(void)
+{
+	/* 主循环会在等待前计算等待时长，在主循环中设置的定时器不需要唤醒它 */
+	if (!LCUI_IsOnMainLoop()) {
+		LCUI_WakeUp();
+	}
+}
+
+static void Timer_Start(Timer timer, long int n_ms)
+{
+	timer->due_time = LCUI_GetTime() + n_ms;
+	TimerWheel_Add(timer);
+}
+
+static void Timer_Fire(Timer timer)
+{
+	Timer firing = self.firing;
+
+	/* 一次性的定时器在回调前就已移除，与之前的行为保持一致 */
+	if (!timer->reuse) {
+		TimerTable_Delete(&self.table, timer);
+	}
+	self.firing = timer;
+	timer->callback(timer->arg);
+	self.firing = firing;
+	if (!timer->reuse || timer->state == STATE_FREE) {
+		TimerPool_Free(timer);
+		return;
+	}
+	/* 若需要重复使用，则重置剩余等待时间 */
+	if (timer->state == STATE_RUN) {
+		Timer_Start(timer, timer->total_ms);
+	}
 }
 
 int LCUITimer_Set(long int n_ms, void(*func)(void *), void *arg,
@@ -107,20 +336,27 @@ int LCUITimer_Set(long int n_ms, void(*func)(void *), void *arg,
 		return -1;
 	}
 	LCUIMutex_Lock(&self.mutex);
-	timer = malloc(sizeof(TimerRec));
+	timer = TimerPool_Alloc();
+	if (!timer) {
+		LCUIMutex_Unlock(&self.mutex);
+		return -ENOMEM;
+	}
 	timer->arg = arg;
 	timer->callback = func;
 	timer->reuse = reuse;
-	timer->pause_ms = 0;
 	timer->total_ms = n_ms;
+	timer->remain_ms = 0;
 	timer->state = STATE_RUN;
 	timer->id = ++self.id_count;
-	timer->start_time = LCUI_GetTime();
-	timer->node.next = NULL;
-	timer->node.prev = NULL;
-	timer->node.data = timer;
-	TimerList_AddNode(&timer->node);
+	timer->list = NULL;
+	if (TimerTable_Add(&self.table, timer) != 0) {
+		TimerPool_Free(timer);
+		LCUIMutex_Unlock(&self.mutex);
+		return -ENOMEM;
+	}
+	Timer_Start(timer, n_ms);
 	LCUIMutex_Unlock(&self.mutex);
+	TimerModule_WakeUp();
 	DEBUG_MSG("set timer, id: %ld, total_ms: %ld\n", timer->id,
 		  timer->total_ms);
 	return timer->id;
@@ -133,13 +369,19 @@ int LCUITimer_Free(int timer_id)
 		return -2;
 	}
 	LCUIMutex_Lock(&self.mutex);
-	timer = FindTimer(timer_id);
+	timer = TimerTable_Get(&self.table, timer_id);
 	if (!timer) {
 		LCUIMutex_Unlock(&self.mutex);
 		return -1;
 	}
-	LinkedList_Unlink(&self.timers, &timer->node);
-	free(timer);
+	TimerTable_Delete(&self.table, timer);
+	TimerWheel_Remove(timer);
+	/* 正在执行回调的定时器会在回调返回后释放 */
+	if (timer == self.firing) {
+		timer->state = STATE_FREE;
+	} else {
+		TimerPool_Free(timer);
+	}
 	LCUIMutex_Unlock(&self.mutex);
 	return 0;
 }
@@ -151,10 +393,16 @@ int LCUITimer_Pause(int timer_id)
 		return -2;
 	}
 	LCUIMutex_Lock(&self.mutex);
-	timer = FindTimer(timer_id);
-	if (timer) {
-		/* 记录暂停时的时间 */
-		timer->pause_time = LCUI_GetTime();
+	timer = TimerTable_Get(&self.table, timer_id);
+	if (timer && timer->state == STATE_RUN) {
+		/* 记录剩余的定时时间 */
+		if (timer->list) {
+			timer->remain_ms =
+			    (long int)max(0, timer->due_time - LCUI_GetTime());
+			TimerWheel_Remove(timer);
+		} else {
+			timer->remain_ms = timer->total_ms;
+		}
 		timer->state = STATE_PAUSE;
 	}
 	LCUIMutex_Unlock(&self.mutex);
@@ -168,14 +416,15 @@ int LCUITimer_Continue(int timer_id)
 		return -2;
 	}
 	LCUIMutex_Lock(&self.mutex);
-	timer = FindTimer(timer_id);
-	if (timer) {
-		/* 计算处于暂停状态的时长 */
-		timer->pause_ms +=
-		    (long int)LCUI_GetTimeDelta(timer->pause_time);
+	timer = TimerTable_Get(&self.table, timer_id);
+	if (timer && timer->state == STATE_PAUSE) {
 		timer->state = STATE_RUN;
+		if (timer != self.firing) {
+			Timer_Start(timer, timer->remain_ms);
+		}
 	}
 	LCUIMutex_Unlock(&self.mutex);
+	TimerModule_WakeUp();
 	return timer ? 0 : -1;
 }
 
@@ -186,13 +435,17 @@ int LCUITimer_Reset(int timer_id, long int n_ms)
 		return -2;
 	}
 	LCUIMutex_Lock(&self.mutex);
-	timer = FindTimer(timer_id);
+	timer = TimerTable_Get(&self.table, timer_id);
 	if (timer) {
-		timer->pause_ms = 0;
 		timer->total_ms = n_ms;
-		timer->start_time = LCUI_GetTime();
+		timer->remain_ms = n_ms;
+		if (timer->state == STATE_RUN && timer != self.firing) {
+			TimerWheel_Remove(timer);
+			Timer_Start(timer, n_ms);
+		}
 	}
 	LCUIMutex_Unlock(&self.mutex);
+	TimerModule_WakeUp();
 	return timer ? 0 : -1;
 }
 
@@ -208,60 +461,107 @@ int LCUI_SetInterval(long int n_ms, void(*callback)(void *), void *arg)
 
 size_t LCUI_ProcessTimers(void)
 {
-	size_t count = 0;
-	long lost_ms;
-
-	Timer timer = NULL;
+	size_t i, count = 0;
+	int64_t now;
+	Timer timer;
+	LinkedList *slot, timers;
 	LinkedListNode *node;
 
 	LCUIMutex_Lock(&self.mutex);
-	while(self.active) {
-		for (LinkedList_Each(node, &self.timers)) {
-			timer = node->data;
-			if (timer && timer->state == STATE_RUN) {
-				break;
-			}
-		}
-		if (!node) {
-			break;
+	now = LCUI_GetTime();
+	LinkedList_Init(&timers);
+	/* 没有定时器时，直接将时间轮转到当前时间 */
+	if (self.table.length < 1) {
+		self.current_time = now + 1;
+	}
+	while (self.active && self.current_time <= now) {
+		i = self.current_time & TIMER_WHEEL_MASK;
+		if (i == 0) {
+			TimerWheel_Cascade(1);
 		}
-		count += 1;
-		lost_ms = (long)LCUI_GetTimeDelta(timer->start_time);
-		/* 若流失的时间未达到总定时时长 */
-		if (lost_ms - timer->pause_ms < timer->total_ms) {
-			break;
+		/*
+		 * 先将到期的定时器移出时间轮再执行回调，回调中添加的已到期的
+		 * 定时器会被放到下一个槽中，不会被遗漏
+		 */
+		slot = &self.wheels[0][i];
+		for (LinkedList_Each(node, slot)) {
+			timer = node->data;
+			timer->list = &timers;
 		}
-		/* 若需要重复使用，则重置剩余等待时间 */
-		LinkedList_Unlink(&self.timers, node);
-		timer->callback(timer->arg);
-		if (timer->reuse) {
-			timer->pause_ms = 0;
-			timer->start_time = LCUI_GetTime();
-			TimerList_AddNode(node);
-		} else {
-			free(timer);
+		LinkedList_Concat(&timers, slot);
+		self.current_time += 1;
+		while (timers.length > 0) {
+			node = timers.head.next;
+			timer = node->data;
+			LinkedList_Unlink(&timers, node);
+			timer->list = NULL;
+			Timer_Fire(timer);
+			count += 1;
 		}
 	}
 	LCUIMutex_Unlock(&self.mutex);
 	return count;
 }
 
+int64_t LCUI_GetNextTimerDelay(void)
+{
+	int level;
+	int64_t t, due_time = -1;
+
+	if (!self.active) {
+		return -1;
+	}
+	LCUIMutex_Lock(&self.mutex);
+	if (self.table.length > 0) {
+		for (level = 0; level < TIMER_WHEEL_LEVELS; ++level) {
+			t = TimerWheel_GetDueTime(level);
+			if (t >= 0 && (due_time < 0 || t < due_time)) {
+				due_time = t;
+			}
+		}
+	}
+	LCUIMutex_Unlock(&self.mutex);
+	if (due_time < 0) {
+		return -1;
+	}
+	return max(0, due_time - LCUI_GetTime());
+}
+
 void LCUI_InitTimer(void)
 {
+	int i, j;
+
 	self.active = TRUE;
 	LCUITime_Init();
 	LCUIMutex_Init(&self.mutex);
-	LinkedList_Init(&self.timers);
+	LinkedList_Init(&self.blocks);
+	LinkedList_Init(&self.free_timers);
+	for (i = 0; i < TIMER_WHEEL_LEVELS; ++i) {
+		for (j = 0; j < TIMER_WHEEL_SIZE; ++j) {
+			LinkedList_Init(&self.wheels[i][j]);
+		}
+	}
+	self.firing = NULL;
+	self.current_time = LCUI_GetTime();
 }
 
 void LCUI_FreeTimer(void)
 {
+	int i, j;
+
 	if (!self.active) {
 		return;
 	}
 	self.active = FALSE;
 	LCUIMutex_Lock(&self.mutex);
 	LCUIMutex_Unlock(&self.mutex);
-	LinkedList_ClearData(&self.timers, free);
+	for (i = 0; i < TIMER_WHEEL_LEVELS; ++i) {
+		for (j = 0; j < TIMER_WHEEL_SIZE; ++j) {
+			LinkedList_Init(&self.wheels[i][j]);
+		}
+	}
+	LinkedList_Init(&self.free_timers);
+	LinkedList_ClearData(&self.blocks, free);
+	TimerTable_Destroy(&self.table);
 	LCUIMutex_Destroy(&self.mutex);
 }
@@ -0,0 +1,148 @@
+﻿/* region.c -- Dirty region with cost-based rectangle merging
+ *
+ *
+ * Copyright (c) 2020, Liu chao <lc-soft@live.cn> All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of LCUI nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+
+#define RectArea(R) ((int64_t)(R)->width * (R)->height)
+
+void LCUIRegion_Init(LCUI_Region region)
+{
+	region->rect_cost = LCUI_REGION_RECT_COST;
+	LCUIRegion_Clear(region);
+}
+
+void LCUIRegion_Clear(LCUI_Region region)
+{
+	region->length = 0;
+	memset(&region->stats, 0, sizeof(LCUI_RegionStatsRec));
+}
+
+/** 计算合并两个矩形后多出的绘制面积 */
+static int64_t LCUIRegion_GetMergeCost(const LCUI_Rect *a, const LCUI_Rect *b)
+{
+	int64_t area;
+	LCUI_Rect rect;
+
+	LCUIRect_MergeRect(&rect, a, b);
+	area = RectArea(&rect) - RectArea(a) - RectArea(b);
+	if (LCUIRect_GetOverlayRect(a, b, &rect)) {
+		area += RectArea(&rect);
+	}
+	return area;
+}
+
+static void LCUIRegion_RemoveRect(LCUI_Region region, int i)
+{
+	region->length -= 1;
+	region->rects[i] = region->rects[region->length];
+}
+
+int LCUIRegion_AddRect(LCUI_Region region, const LCUI_Rect *rect)
+{
+	int i, best;
+	int64_t cost, best_cost;
+	LCUI_Rect r = *rect;
+	LCUI_Rect *p;
+
+	if (r.width <= 0 || r.height <= 0) {
+		return -1;
+	}
+	region->stats.added_rects += 1;
+	region->stats.added_area += (size_t)RectArea(&r);
+	/*
+	 * Merge the rectangle with its cheapest neighbor until no merge is
+	 * worth it. When the region is full, a merge is forced.
+	 */
+	while (1) {
+		best = -1;
+		if (region->length >= LCUI_REGION_MAX_RECTS) {
+			best_cost = INT64_MAX;
+		} else {
+			best_cost = region->rect_cost;
+		}
+		for (i = 0; i < region->length; ++i) {
+			p = &region->rects[i];
+			if (LCUIRect_IsIncludeRect(p, &r)) {
+				return 1;
+			}
+			if (LCUIRect_IsIncludeRect(&r, p)) {
+				LCUIRegion_RemoveRect(region, i--);
+				region->stats.merged_rects += 1;
+				continue;
+			}
+			cost = LCUIRegion_GetMergeCost(p, &r);
+			if (cost <= best_cost) {
+				best = i;
+				best_cost = cost;
+			}
+		}
+		if (best < 0) {
+			break;
+		}
+		LCUIRect_MergeRect(&r, &region->rects[best], &r);
+		LCUIRegion_RemoveRect(region, best);
+		region->stats.merged_rects += 1;
+	}
+	region->rects[region->length++] = r;
+	if (r.width == rect->width && r.height == rect->height) {
+		return 0;
+	}
+	return 1;
+}
+
+void LCUIRegion_Union(LCUI_Region dst, const LCUI_Region src)
+{
+	int i;
+
+	for (i = 0; i < src->length; ++i) {
+		LCUIRegion_AddRect(dst, &src->rects[i]);
+	}
+}
+
+size_t LCUIRegion_GetArea(const LCUI_Region region)
+{
+	int i;
+	size_t area = 0;
+
+	for (i = 0; i < region->length; ++i) {
+		area += (size_t)RectArea(&region->rects[i]);
+	}
+	return area;
+}
+
+void LCUIRegion_GetStats(const LCUI_Region region, LCUI_RegionStats stats)
+{
+	*stats = region->stats;
+	stats->rects = region->length;
+	stats->area = LCUIRegion_GetArea(region);
+}
@@ -61,8 +61,8 @@ StepTimer StepTimer_Create(void)
 	timer->current_fps = 0;
 	timer->pause_time = 0;
 	timer->one_frame_remain_time = 10;
-	timer->prev_frame_start_time = LCUI_GetTime();
-	timer->prev_fps_update_time = LCUI_GetTime();
+	timer->prev_frame_start_time = LCUI_GetSystemTime();
+	timer->prev_fps_update_time = LCUI_GetSystemTime();
 	LCUICond_Init(&timer->cond);
 	LCUIMutex_Init(&timer->mutex);
 	return timer;
@@ -94,7 +94,7 @@ void StepTimer_Remain(StepTimer timer)
 		return;
 	}
 	lost_ms = 0;
-	current_time = LCUI_GetTime();
+	current_time = LCUI_GetSystemTime();
 	LCUIMutex_Lock(&timer->mutex);
 	n_ms = (unsigned int)(current_time - timer->prev_frame_start_time);
 	if (n_ms > timer->one_frame_remain_time) {
@@ -107,16 +107,16 @@ void StepTimer_Remain(StepTimer timer)
 	/* 睡眠一段时间 */
 	while (lost_ms < n_ms && timer->state == STATE_RUN) {
 		LCUICond_TimedWait(&timer->cond, &timer->mutex, n_ms - lost_ms);
-		lost_ms = (unsigned int)LCUI_GetTimeDelta(current_time);
+		lost_ms = (unsigned int)(LCUI_GetSystemTime() - current_time);
 	}
 	/* 睡眠结束后，如果当前状态为 PAUSE，则说明睡眠是因为要暂停而终止的 */
 	if (timer->state == STATE_PAUSE) {
-		current_time = LCUI_GetTime();
+		current_time = LCUI_GetSystemTime();
 		/* 等待状态改为“继续” */
 		while (timer->state == STATE_PAUSE) {
 			LCUICond_Wait(&timer->cond, &timer->mutex);
 		}
-		lost_ms = (unsigned int)LCUI_GetTimeDelta(current_time);
+		lost_ms = (unsigned int)(LCUI_GetSystemTime() - current_time);
 		timer->pause_time = lost_ms;
 		timer->prev_frame_start_time += lost_ms;
 		LCUIMutex_Unlock(&timer->mutex);
@@ -124,7 +124,7 @@ void StepTimer_Remain(StepTimer timer)
 	}
 
 normal_exit:;
-	current_time = LCUI_GetTime();
+	current_time = LCUI_GetSystemTime();
 	if (current_time - timer->prev_fps_update_time >= 1000) {
 		timer->current_fps = timer->temp_fps;
 		timer->prev_fps_update_time = current_time;
@@ -35,6 +35,9 @@
 
 #define TIME_WRAP_VALUE (~(int64_t)0)
 
+/** 自定义的时钟，为 NULL 时使用系统时间 */
+static int64_t (*time_clock)(void) = NULL;
+
 #ifdef LCUI_BUILD_IN_WIN32
 #include <Windows.h>
 
@@ -50,7 +53,7 @@ void LCUITime_Init(void)
 	}
 }
 
-int64_t LCUI_GetTime(void)
+int64_t LCUI_GetSystemTime(void)
 {
 	int64_t time;
 	LARGE_INTEGER hires_now;
@@ -64,6 +67,19 @@ int64_t LCUI_GetTime(void)
 	return time / 1000 - 11644473600000;
 }
 
+int64_t LCUI_GetNanoTime(void)
+{
+	LARGE_INTEGER freq, now;
+
+	if (!QueryPerformanceFrequency(&freq) ||
+	    !QueryPerformanceCounter(&now)) {
+		return (int64_t)GetTickCount64() * 1000000;
+	}
+	/* 分开计算整数秒和余数，避免乘法溢出 */
+	return now.QuadPart / freq.QuadPart * 1000000000 +
+	       now.QuadPart % freq.QuadPart * 1000000000 / freq.QuadPart;
+}
+
 #elif defined LCUI_BUILD_IN_LINUX
 #include <unistd.h>
 #include <sys/time.h>
@@ -74,7 +90,7 @@ void LCUITime_Init(void)
 	return;
 }
 
-int64_t LCUI_GetTime(void)
+int64_t LCUI_GetSystemTime(void)
 {
 	int64_t t;
 	struct timeval tv;
@@ -84,8 +100,29 @@ int64_t LCUI_GetTime(void)
 	return t;
 }
 
+int64_t LCUI_GetNanoTime(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
 #endif
 
+void LCUITime_SetClock(int64_t (*func)(void))
+{
+	time_clock = func;
+}
+
+int64_t LCUI_GetTime(void)
+{
+	if (time_clock) {
+		return time_clock();
+	}
+	return LCUI_GetSystemTime();
+}
+
 int64_t LCUI_GetTimeDelta(int64_t start)
 {
 	int64_t now = LCUI_GetTime();
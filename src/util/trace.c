@@ -0,0 +1,336 @@
+﻿/*
+ * trace.c -- Frame tracer, records the time spent in each phase of the frames
+ * and exports it in Chrome trace event format.
+ *
+ * Copyright (c) 2018, Liu chao <lc-soft@live.cn> All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of LCUI nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/thread.h>
+
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+
+#define TRACE_BUFFER_SIZE 8192
+#define TRACE_MAX_DEPTH 32
+#define TRACE_THREAD_NAME_LEN 32
+
+typedef struct TraceEventRec_ {
+	const char *name;
+	int64_t start;
+	int64_t duration;
+} TraceEventRec, *TraceEvent;
+
+/**
+ * 线程的记录缓冲区
+ * 缓冲区是环形的，写满后覆盖最早的记录。线程退出后缓冲区仍然保留，以便导出
+ * 它记录的数据，直到 LCUITrace_Free() 释放所有缓冲区
+ */
+typedef struct TraceBufferRec_ {
+	int tid;
+	char name[TRACE_THREAD_NAME_LEN];
+	LCUI_Mutex mutex;
+	size_t head;
+	size_t length;
+	TraceEventRec events[TRACE_BUFFER_SIZE];
+	LinkedListNode node;
+} TraceBufferRec, *TraceBuffer;
+
+typedef struct TraceScopeRec_ {
+	const char *name;
+	int64_t start; /**< 开始时间，为 -1 时表示开始时未启用记录 */
+} TraceScopeRec, *TraceScope;
+
+/** 线程的记录状态 */
+typedef struct TraceThreadRec_ {
+	int depth;
+	TraceScopeRec scopes[TRACE_MAX_DEPTH];
+	char name[TRACE_THREAD_NAME_LEN];
+	TraceBuffer buffer;
+
+	/** 缓冲区所属的模块生命周期，与模块不一致时说明缓冲区已被释放 */
+	unsigned generation;
+} TraceThreadRec;
+
+static struct TraceModule {
+	LCUI_BOOL ready;
+	volatile LCUI_BOOL enabled;
+
+	/** 首次启用记录的时间，导出的时间戳以它为起点 */
+	int64_t start_time;
+
+	int next_tid;
+	LinkedList buffers;
+	LCUI_Mutex mutex;
+
+	/** 每次释放模块后加一，让各线程丢弃已释放的缓冲区 */
+	unsigned generation;
+} self;
+
+static THREAD_LOCAL TraceThreadRec current;
+
+static TraceBuffer TraceBuffer_Create(void)
+{
+	TraceBuffer buffer;
+
+	buffer = malloc(sizeof(TraceBufferRec));
+	if (!buffer) {
+		return NULL;
+	}
+	buffer->head = 0;
+	buffer->length = 0;
+	buffer->node.data = buffer;
+	strcpy(buffer->name, current.name);
+	LCUIMutex_Init(&buffer->mutex);
+	LCUIMutex_Lock(&self.mutex);
+	buffer->tid = ++self.next_tid;
+	LinkedList_AppendNode(&self.buffers, &buffer->node);
+	LCUIMutex_Unlock(&self.mutex);
+	return buffer;
+}
+
+static void TraceBuffer_Push(TraceBuffer buffer, const char *name,
+			     int64_t start, int64_t duration)
+{
+	TraceEvent e;
+
+	LCUIMutex_Lock(&buffer->mutex);
+	if (buffer->length < TRACE_BUFFER_SIZE) {
+		e = &buffer->events[(buffer->head + buffer->length) %
+				    TRACE_BUFFER_SIZE];
+		buffer->length += 1;
+	} else {
+		e = &buffer->events[buffer->head];
+		buffer->head = (buffer->head + 1) % TRACE_BUFFER_SIZE;
+	}
+	e->name = name;
+	e->start = start;
+	e->duration = duration;
+	LCUIMutex_Unlock(&buffer->mutex);
+}
+
+void LCUITrace_Enable(LCUI_BOOL enable)
+{
+	if (!self.ready) {
+		LCUIMutex_Init(&self.mutex);
+		LinkedList_Init(&self.buffers);
+		self.start_time = LCUI_GetNanoTime();
+		self.ready = TRUE;
+	}
+	self.enabled = enable;
+}
+
+LCUI_BOOL LCUITrace_IsEnabled(void)
+{
+	return self.enabled;
+}
+
+void LCUITrace_Begin(const char *name)
+{
+	TraceScope scope;
+
+	if (current.depth < TRACE_MAX_DEPTH) {
+		scope = &current.scopes[current.depth];
+		scope->name = name;
+		scope->start = self.enabled ? LCUI_GetNanoTime() : -1;
+	}
+	current.depth += 1;
+}
+
+void LCUITrace_End(void)
+{
+	TraceScope scope;
+
+	if (current.depth < 1) {
+		return;
+	}
+	current.depth -= 1;
+	if (current.depth >= TRACE_MAX_DEPTH) {
+		return;
+	}
+	scope = &current.scopes[current.depth];
+	if (scope->start < 0 || !self.enabled) {
+		return;
+	}
+	if (!current.buffer || current.generation != self.generation) {
+		current.generation = self.generation;
+		current.buffer = TraceBuffer_Create();
+		if (!current.buffer) {
+			return;
+		}
+	}
+	TraceBuffer_Push(current.buffer, scope->name, scope->start,
+			 LCUI_GetNanoTime() - scope->start);
+}
+
+void LCUITrace_SetThreadName(const char *name)
+{
+	TraceBuffer buffer = current.buffer;
+
+	strncpy(current.name, name, TRACE_THREAD_NAME_LEN - 1);
+	current.name[TRACE_THREAD_NAME_LEN - 1] = 0;
+	if (buffer && current.generation == self.generation) {
+		LCUIMutex_Lock(&buffer->mutex);
+		strcpy(buffer->name, current.name);
+		LCUIMutex_Unlock(&buffer->mutex);
+	}
+}
+
+void LCUITrace_Clear(void)
+{
+	TraceBuffer buffer;
+	LinkedListNode *node;
+
+	if (!self.ready) {
+		return;
+	}
+	LCUIMutex_Lock(&self.mutex);
+	for (LinkedList_Each(node, &self.buffers)) {
+		buffer = node->data;
+		LCUIMutex_Lock(&buffer->mutex);
+		buffer->head = 0;
+		buffer->length = 0;
+		LCUIMutex_Unlock(&buffer->mutex);
+	}
+	LCUIMutex_Unlock(&self.mutex);
+}
+
+void LCUITrace_Free(void)
+{
+	TraceBuffer buffer;
+	LinkedListNode *node;
+
+	if (!self.ready) {
+		return;
+	}
+	self.enabled = FALSE;
+	LCUIMutex_Lock(&self.mutex);
+	while (self.buffers.head.next) {
+		node = self.buffers.head.next;
+		buffer = node->data;
+		LinkedList_Unlink(&self.buffers, node);
+		LCUIMutex_Destroy(&buffer->mutex);
+		free(buffer);
+	}
+	self.generation += 1;
+	LCUIMutex_Unlock(&self.mutex);
+	LCUIMutex_Destroy(&self.mutex);
+	self.ready = FALSE;
+}
+
+static void WriteString(FILE *fp, const char *str)
+{
+	fputc('"', fp);
+	for (; *str; ++str) {
+		if (*str == '"' || *str == '\\') {
+			fputc('\\', fp);
+			fputc(*str, fp);
+		} else if ((unsigned char)*str < 0x20) {
+			fprintf(fp, "\\u%04x", *str);
+		} else {
+			fputc(*str, fp);
+		}
+	}
+	fputc('"', fp);
+}
+
+/** 以微秒为单位写入时间，保留纳秒级的小数部分 */
+static void WriteTime(FILE *fp, int64_t ns)
+{
+	fprintf(fp, "%lld.%03d", (long long)(ns / 1000), (int)(ns % 1000));
+}
+
+static void TraceBuffer_Write(TraceBuffer buffer, FILE *fp,
+			      LCUI_BOOL *first)
+{
+	size_t i;
+	TraceEvent e;
+
+	if (buffer->name[0]) {
+		fputs(*first ? "\n" : ",\n", fp);
+		fprintf(fp,
+			"{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+			"\"tid\":%d,\"args\":{\"name\":",
+			buffer->tid);
+		WriteString(fp, buffer->name);
+		fputs("}}", fp);
+		*first = FALSE;
+	}
+	for (i = 0; i < buffer->length; ++i) {
+		e = &buffer->events[(buffer->head + i) % TRACE_BUFFER_SIZE];
+		fputs(*first ? "\n" : ",\n", fp);
+		fputs("{\"name\":", fp);
+		WriteString(fp, e->name);
+		fprintf(fp,
+			",\"cat\":\"LCUI\",\"ph\":\"X\",\"pid\":1,"
+			"\"tid\":%d,\"ts\":",
+			buffer->tid);
+		WriteTime(fp, max(0, e->start - self.start_time));
+		fputs(",\"dur\":", fp);
+		WriteTime(fp, e->duration);
+		fputc('}', fp);
+		*first = FALSE;
+	}
+}
+
+int LCUITrace_WriteFile(const char *path)
+{
+	FILE *fp;
+	LCUI_BOOL first = TRUE;
+	LinkedListNode *node;
+	TraceBuffer buffer;
+
+	fp = fopen(path, "w");
+	if (!fp) {
+		Logger_Error("[trace] file %s could not be opened for "
+			     "writing\n",
+			     path);
+		return -ENOENT;
+	}
+	fputs("{\"traceEvents\":[", fp);
+	if (self.ready) {
+		LCUIMutex_Lock(&self.mutex);
+		for (LinkedList_Each(node, &self.buffers)) {
+			buffer = node->data;
+			LCUIMutex_Lock(&buffer->mutex);
+			TraceBuffer_Write(buffer, fp, &first);
+			LCUIMutex_Unlock(&buffer->mutex);
+		}
+		LCUIMutex_Unlock(&self.mutex);
+	}
+	fputs("\n],\"displayTimeUnit\":\"ms\"}\n", fp);
+	fclose(fp);
+	return 0;
+}
@@ -31,11 +31,16 @@
 
 #include <errno.h>
 #include <stdlib.h>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
 #include <LCUI_Build.h>
 #include <LCUI/types.h>
+#include <LCUI/util/math.h>
 #include <LCUI/util/task.h>
 #include <LCUI/util/logger.h>
 #include <LCUI/util/linkedlist.h>
+#include <LCUI/util/trace.h>
 #include <LCUI/thread.h>
 #include <LCUI/worker.h>
 
@@ -45,6 +50,7 @@ typedef struct LCUI_WorkerRec_ {
 	LCUI_Mutex mutex;		/**< 互斥锁 */
 	LCUI_Cond cond;			/**< 条件变量 */
 	LCUI_Thread thread;		/**< 所在的线程 */
+	void (*notify)(void);		/**< 添加任务后调用的通知函数 */
 } LCUI_WorkerRec;
 
 LCUI_Worker LCUIWorker_New(void)
@@ -55,9 +61,15 @@ LCUI_Worker LCUIWorker_New(void)
 	LinkedList_Init(&worker->tasks);
 	worker->active = FALSE;
 	worker->thread = 0;
+	worker->notify = NULL;
 	return worker;
 }
 
+void LCUIWorker_SetNotifier(LCUI_Worker worker, void (*notify)(void))
+{
+	worker->notify = notify;
+}
+
 void LCUIWorker_PostTask(LCUI_Worker worker, LCUI_Task task)
 {
 	LCUI_Task newtask;
@@ -67,6 +79,9 @@ void LCUIWorker_PostTask(LCUI_Worker worker, LCUI_Task task)
 	LinkedList_Append(&worker->tasks, newtask);
 	LCUICond_Signal(&worker->cond);
 	LCUIMutex_Unlock(&worker->mutex);
+	if (worker->notify) {
+		worker->notify();
+	}
 }
 
 LCUI_Task LCUIWorker_GetTask(LCUI_Worker worker)
@@ -166,3 +181,636 @@ void LCUIWorker_Destroy(LCUI_Worker worker)
 	}
 	LCUIWorker_ExecDestroy(worker);
 }
+
+/*------------------------- Worker Pool <START> -----------------------------*/
+
+#ifdef _WIN32
+#define AtomicLoad(PTR) InterlockedCompareExchange(PTR, 0, 0)
+#define AtomicIncrement(PTR) InterlockedIncrement(PTR)
+#define AtomicDecrement(PTR) InterlockedDecrement(PTR)
+#define AtomicCompareExchange(PTR, OLD, NEW) \
+	(InterlockedCompareExchange(PTR, NEW, OLD) == (OLD))
+#else
+#define AtomicLoad(PTR) __atomic_load_n(PTR, __ATOMIC_ACQUIRE)
+#define AtomicIncrement(PTR) __sync_add_and_fetch(PTR, 1)
+#define AtomicDecrement(PTR) __sync_sub_and_fetch(PTR, 1)
+#define AtomicCompareExchange(PTR, OLD, NEW) \
+	__sync_bool_compare_and_swap(PTR, OLD, NEW)
+#endif
+
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+
+#define WORKER_POOL_MAX_SIZE 16
+#define WORKER_POOL_MAX_FREE_TASKS 256
+
+typedef struct LCUI_AsyncTaskRec_ {
+	LCUI_TaskRec task;
+	volatile long state;  /**< 任务状态，取值为 LCUI_AsyncTaskState */
+	volatile long refs;   /**< 引用计数，线程池和句柄各持有一个引用 */
+	LCUI_AsyncTaskCallback callback;
+	void *callback_arg;
+	LCUI_WorkerPool pool;
+	struct LCUI_AsyncTaskRec_ *next; /**< 在空闲记录列表中的下一个记录 */
+} LCUI_AsyncTaskRec;
+
+/** 任务双端队列，用环形缓冲区存储 */
+typedef struct LCUI_TaskDequeRec_ {
+	LCUI_AsyncTask *tasks;
+	size_t head;
+	size_t length;
+	size_t capacity;
+} LCUI_TaskDequeRec, *LCUI_TaskDeque;
+
+typedef struct LCUI_PoolWorkerRec_ {
+	int index;
+	LCUI_Thread thread;
+	LCUI_WorkerPool pool;
+	LCUI_Mutex mutex;
+
+	/**
+	 * 队列中的任务数量
+	 * 查找任务时先检查它们，以免为空的队列加锁
+	 */
+	volatile long lengths[LCUI_TASK_PRIORITY_TOTAL_NUM];
+	volatile long pinned_lengths[LCUI_TASK_PRIORITY_TOTAL_NUM];
+
+	/** 各个优先级的任务队列，其它工作线程可以从队尾窃取任务 */
+	LCUI_TaskDequeRec lanes[LCUI_TASK_PRIORITY_TOTAL_NUM];
+
+	/** 指定由该工作线程执行的任务，不能被窃取 */
+	LCUI_TaskDequeRec pinned_lanes[LCUI_TASK_PRIORITY_TOTAL_NUM];
+
+	/**
+	 * 空闲的任务记录
+	 * 在该工作线程上执行完的任务记录会回收到这里，添加任务时在入队的同时
+	 * 从这里取出记录，避免每添加一个任务就分配一次内存
+	 */
+	LCUI_AsyncTask free_records;
+	size_t free_records_count;
+} LCUI_PoolWorkerRec, *LCUI_PoolWorker;
+
+typedef struct LCUI_WorkerPoolRec_ {
+	/** 是否处于活动状态，工作线程在执行每个任务前都会检查它 */
+	volatile long active;
+	int num_workers;
+	LCUI_PoolWorker workers;
+	LCUI_Worker callback_worker;
+
+	/** 下一个接收外部任务的工作线程编号 */
+	volatile long next_worker;
+
+	/** 互斥锁和条件变量，用于让空闲的工作线程休眠和唤醒它们 */
+	LCUI_Mutex mutex;
+	LCUI_Cond cond;
+	volatile long sleepers;
+
+	/** 引用计数，线程池本身和未释放的任务记录各持有一个引用 */
+	volatile long refs;
+} LCUI_WorkerPoolRec;
+
+/** 当前线程所属的工作线程 */
+static THREAD_LOCAL LCUI_PoolWorker current_worker;
+
+static int GetProcessorCount(void)
+{
+#ifdef _WIN32
+	SYSTEM_INFO info;
+
+	GetSystemInfo(&info);
+	return (int)info.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+	return (int)sysconf(_SC_NPROCESSORS_ONLN);
+#else
+	return 4;
+#endif
+}
+
+static void TaskDeque_Init(LCUI_TaskDeque deque)
+{
+	deque->tasks = NULL;
+	deque->head = 0;
+	deque->length = 0;
+	deque->capacity = 0;
+}
+
+static void TaskDeque_Destroy(LCUI_TaskDeque deque)
+{
+	free(deque->tasks);
+	TaskDeque_Init(deque);
+}
+
+static int TaskDeque_Push(LCUI_TaskDeque deque, LCUI_AsyncTask task)
+{
+	size_t i, capacity;
+	LCUI_AsyncTask *tasks;
+
+	if (deque->length >= deque->capacity) {
+		capacity = max(deque->capacity * 2, 32);
+		tasks = malloc(sizeof(LCUI_AsyncTask) * capacity);
+		if (!tasks) {
+			return -ENOMEM;
+		}
+		for (i = 0; i < deque->length; ++i) {
+			tasks[i] = deque->tasks[(deque->head + i) %
+						deque->capacity];
+		}
+		free(deque->tasks);
+		deque->tasks = tasks;
+		deque->capacity = capacity;
+		deque->head = 0;
+	}
+	deque->tasks[(deque->head + deque->length) % deque->capacity] = task;
+	deque->length += 1;
+	return 0;
+}
+
+/** 从队头取出最早添加的任务 */
+static LCUI_AsyncTask TaskDeque_PopFront(LCUI_TaskDeque deque)
+{
+	LCUI_AsyncTask task;
+
+	if (deque->length < 1) {
+		return NULL;
+	}
+	task = deque->tasks[deque->head];
+	deque->head = (deque->head + 1) % deque->capacity;
+	deque->length -= 1;
+	return task;
+}
+
+/** 从队尾取出最近添加的任务 */
+static LCUI_AsyncTask TaskDeque_PopBack(LCUI_TaskDeque deque)
+{
+	if (deque->length < 1) {
+		return NULL;
+	}
+	deque->length -= 1;
+	return deque->tasks[(deque->head + deque->length) % deque->capacity];
+}
+
+static void LCUIWorkerPool_Unref(LCUI_WorkerPool pool)
+{
+	if (AtomicDecrement(&pool->refs) == 0) {
+		free(pool);
+	}
+}
+
+/** 取出一个空闲的任务记录，调用前需锁定工作线程 */
+static LCUI_AsyncTask LCUIPoolWorker_AllocTask(LCUI_PoolWorker worker)
+{
+	LCUI_AsyncTask task;
+
+	task = worker->free_records;
+	if (!task) {
+		return malloc(sizeof(LCUI_AsyncTaskRec));
+	}
+	worker->free_records = task->next;
+	worker->free_records_count -= 1;
+	return task;
+}
+
+/**
+ * 回收任务记录
+ * 如果当前线程是该线程池的工作线程，则回收到它的空闲记录中，否则直接释放
+ */
+static void LCUIWorkerPool_FreeTask(LCUI_WorkerPool pool, LCUI_AsyncTask task)
+{
+	LCUI_PoolWorker worker = current_worker;
+
+	if (worker && worker->pool == pool) {
+		LCUIMutex_Lock(&worker->mutex);
+		if (worker->free_records_count < WORKER_POOL_MAX_FREE_TASKS) {
+			task->next = worker->free_records;
+			worker->free_records = task;
+			worker->free_records_count += 1;
+			task = NULL;
+		}
+		LCUIMutex_Unlock(&worker->mutex);
+	}
+	free(task);
+	LCUIWorkerPool_Unref(pool);
+}
+
+LCUI_BOOL LCUIAsyncTask_Cancel(LCUI_AsyncTask task)
+{
+	return AtomicCompareExchange(&task->state, LCUI_ASYNC_TASK_PENDING,
+				     LCUI_ASYNC_TASK_CANCELED);
+}
+
+LCUI_AsyncTaskState LCUIAsyncTask_GetState(LCUI_AsyncTask task)
+{
+	return (LCUI_AsyncTaskState)AtomicLoad(&task->state);
+}
+
+void LCUIAsyncTask_Release(LCUI_AsyncTask task)
+{
+	if (AtomicDecrement(&task->refs) == 0) {
+		LCUIWorkerPool_FreeTask(task->pool, task);
+	}
+}
+
+static void OnAsyncTaskDone(void *arg1, void *arg2)
+{
+	LCUI_AsyncTask task = arg1;
+
+	task->callback(task, task->callback_arg);
+}
+
+static void OnDestroyAsyncTaskDone(void *arg)
+{
+	LCUIAsyncTask_Release(arg);
+}
+
+/** 结束任务，调用完成回调并释放线程池持有的引用 */
+static void LCUIAsyncTask_Finish(LCUI_AsyncTask task)
+{
+	LCUI_TaskRec callback = { 0 };
+	LCUI_WorkerPool pool = task->pool;
+
+	LCUITask_Destroy(&task->task);
+	if (!task->callback) {
+		LCUIAsyncTask_Release(task);
+		return;
+	}
+	if (!pool->callback_worker) {
+		task->callback(task, task->callback_arg);
+		LCUIAsyncTask_Release(task);
+		return;
+	}
+	callback.func = OnAsyncTaskDone;
+	callback.arg[0] = task;
+	callback.destroy_arg[0] = OnDestroyAsyncTaskDone;
+	LCUIWorker_PostTask(pool->callback_worker, &callback);
+}
+
+static void LCUIAsyncTask_Run(LCUI_AsyncTask task)
+{
+	if (AtomicCompareExchange(&task->state, LCUI_ASYNC_TASK_PENDING,
+				  LCUI_ASYNC_TASK_RUNNING)) {
+		LCUITrace_Begin("async task");
+		LCUITask_Run(&task->task);
+		LCUITrace_End();
+		AtomicCompareExchange(&task->state, LCUI_ASYNC_TASK_RUNNING,
+				      LCUI_ASYNC_TASK_DONE);
+	}
+	LCUIAsyncTask_Finish(task);
+}
+
+/**
+ * 查找下一个要执行的任务
+ * 按优先级从高到低，依次查找指定给自己的任务、自己队列中的任务和其它工作线程
+ * 队列中的任务
+ */
+static LCUI_AsyncTask LCUIPoolWorker_FindTask(LCUI_PoolWorker worker)
+{
+	int i, p;
+	LCUI_AsyncTask task = NULL;
+	LCUI_PoolWorker victim;
+	LCUI_WorkerPool pool = worker->pool;
+
+	for (p = 0; p < LCUI_TASK_PRIORITY_TOTAL_NUM; ++p) {
+		if (AtomicLoad(&worker->lengths[p]) > 0 ||
+		    AtomicLoad(&worker->pinned_lengths[p]) > 0) {
+			LCUIMutex_Lock(&worker->mutex);
+			task = TaskDeque_PopFront(&worker->pinned_lanes[p]);
+			if (task) {
+				AtomicDecrement(&worker->pinned_lengths[p]);
+			} else {
+				task = TaskDeque_PopFront(&worker->lanes[p]);
+				if (task) {
+					AtomicDecrement(&worker->lengths[p]);
+				}
+			}
+			LCUIMutex_Unlock(&worker->mutex);
+			if (task) {
+				return task;
+			}
+		}
+		for (i = 1; i < pool->num_workers; ++i) {
+			victim = &pool->workers[(worker->index + i) %
+						pool->num_workers];
+			if (AtomicLoad(&victim->lengths[p]) < 1) {
+				continue;
+			}
+			LCUIMutex_Lock(&victim->mutex);
+			task = TaskDeque_PopBack(&victim->lanes[p]);
+			if (task) {
+				AtomicDecrement(&victim->lengths[p]);
+			}
+			LCUIMutex_Unlock(&victim->mutex);
+			if (task) {
+				return task;
+			}
+		}
+	}
+	return NULL;
+}
+
+static void LCUIPoolWorker_Thread(void *arg)
+{
+	LCUI_AsyncTask task;
+	LCUI_PoolWorker worker = arg;
+	LCUI_WorkerPool pool = worker->pool;
+
+	current_worker = worker;
+	LCUITrace_SetThreadName("worker");
+	/* 线程池被销毁后不再取出新任务，剩余的任务由 Destroy() 取消 */
+	while (AtomicLoad(&pool->active)) {
+		task = LCUIPoolWorker_FindTask(worker);
+		if (task) {
+			LCUIAsyncTask_Run(task);
+			continue;
+		}
+		LCUIMutex_Lock(&pool->mutex);
+		if (!pool->active) {
+			LCUIMutex_Unlock(&pool->mutex);
+			break;
+		}
+		/*
+		 * 先登记为休眠状态再检查一遍任务队列，添加任务的线程在增加
+		 * 任务数量后才检查休眠数量，两者都用原子操作修改，这样至少有
+		 * 一方能发现对方
+		 */
+		AtomicIncrement(&pool->sleepers);
+		task = LCUIPoolWorker_FindTask(worker);
+		if (!task) {
+			LCUICond_Wait(&pool->cond, &pool->mutex);
+		}
+		AtomicDecrement(&pool->sleepers);
+		LCUIMutex_Unlock(&pool->mutex);
+		if (task) {
+			LCUIAsyncTask_Run(task);
+		}
+	}
+	LCUIThread_Exit(NULL);
+}
+
+static void LCUIWorkerPool_WakeUp(LCUI_WorkerPool pool)
+{
+	if (AtomicLoad(&pool->sleepers) > 0) {
+		LCUIMutex_Lock(&pool->mutex);
+		LCUICond_Signal(&pool->cond);
+		LCUIMutex_Unlock(&pool->mutex);
+	}
+}
+
+static void LCUIAsyncTask_Init(LCUI_AsyncTask t, LCUI_WorkerPool pool,
+			       LCUI_Task task, long refs)
+{
+	t->task = *task;
+	t->state = LCUI_ASYNC_TASK_PENDING;
+	t->refs = refs;
+	t->callback = NULL;
+	t->callback_arg = NULL;
+	t->pool = pool;
+	t->next = NULL;
+}
+
+/**
+ * 选择接收任务的工作线程
+ * 工作线程添加的任务放入自己的队列，其它线程添加的任务轮流分给各个工作线程
+ */
+static LCUI_PoolWorker LCUIWorkerPool_SelectWorker(LCUI_WorkerPool pool)
+{
+	LCUI_PoolWorker worker = current_worker;
+
+	if (worker && worker->pool == pool) {
+		return worker;
+	}
+	return &pool->workers[(unsigned long)AtomicIncrement(
+				  &pool->next_worker) %
+			      pool->num_workers];
+}
+
+/**
+ * 将任务放入工作线程的队列
+ * 任务记录在同一次加锁中从该工作线程的空闲记录里取出，队列无法扩容时直接
+ * 执行任务
+ */
+static LCUI_AsyncTask LCUIPoolWorker_Push(LCUI_PoolWorker worker,
+					  LCUI_AsyncTask data,
+					  LCUI_TaskPriority priority,
+					  LCUI_BOOL pinned)
+{
+	int ret = -ENOMEM;
+	volatile long *length;
+	LCUI_TaskDeque deque;
+	LCUI_AsyncTask task;
+
+	if (pinned) {
+		deque = &worker->pinned_lanes[priority];
+		length = &worker->pinned_lengths[priority];
+	} else {
+		deque = &worker->lanes[priority];
+		length = &worker->lengths[priority];
+	}
+	LCUIMutex_Lock(&worker->mutex);
+	task = LCUIPoolWorker_AllocTask(worker);
+	if (task) {
+		*task = *data;
+		AtomicIncrement(&worker->pool->refs);
+		ret = TaskDeque_Push(deque, task);
+		if (ret == 0) {
+			AtomicIncrement(length);
+		}
+	}
+	LCUIMutex_Unlock(&worker->mutex);
+	if (!task) {
+		LCUITask_Destroy(&data->task);
+		return NULL;
+	}
+	if (ret != 0) {
+		LCUIAsyncTask_Run(task);
+	}
+	return task;
+}
+
+LCUI_WorkerPool LCUIWorkerPool_New(int num_workers)
+{
+	int i, p;
+	LCUI_PoolWorker worker;
+	LCUI_WorkerPool pool;
+
+	if (num_workers < 1) {
+		num_workers = GetProcessorCount();
+		num_workers = max(2, min(num_workers, WORKER_POOL_MAX_SIZE));
+	}
+	pool = NEW(LCUI_WorkerPoolRec, 1);
+	if (!pool) {
+		return NULL;
+	}
+	pool->workers = NEW(LCUI_PoolWorkerRec, num_workers);
+	if (!pool->workers) {
+		free(pool);
+		return NULL;
+	}
+	pool->active = TRUE;
+	pool->num_workers = num_workers;
+	pool->refs = 1;
+	LCUIMutex_Init(&pool->mutex);
+	LCUICond_Init(&pool->cond);
+	for (i = 0; i < num_workers; ++i) {
+		worker = &pool->workers[i];
+		worker->index = i;
+		worker->pool = pool;
+		LCUIMutex_Init(&worker->mutex);
+		for (p = 0; p < LCUI_TASK_PRIORITY_TOTAL_NUM; ++p) {
+			TaskDeque_Init(&worker->lanes[p]);
+			TaskDeque_Init(&worker->pinned_lanes[p]);
+		}
+	}
+	/* 先初始化所有队列再启动线程，因为工作线程会访问其它线程的队列 */
+	for (i = 0; i < num_workers; ++i) {
+		worker = &pool->workers[i];
+		if (LCUIThread_Create(&worker->thread, LCUIPoolWorker_Thread,
+				      worker) != 0) {
+			break;
+		}
+	}
+	if (i < num_workers) {
+		Logger_Warning("[worker] started %d/%d pool workers\n", i,
+			       num_workers);
+		/* 只保留已经启动的工作线程，它们不会访问编号更大的队列 */
+		pool->num_workers = i;
+		for (; i < num_workers; ++i) {
+			LCUIMutex_Destroy(&pool->workers[i].mutex);
+		}
+		if (pool->num_workers < 1) {
+			LCUIMutex_Destroy(&pool->mutex);
+			LCUICond_Destroy(&pool->cond);
+			free(pool->workers);
+			free(pool);
+			return NULL;
+		}
+	}
+	Logger_Debug("[worker] %d pool workers are running\n",
+		     pool->num_workers);
+	return pool;
+}
+
+int LCUIWorkerPool_GetSize(LCUI_WorkerPool pool)
+{
+	return pool->num_workers;
+}
+
+void LCUIWorkerPool_SetCallbackWorker(LCUI_WorkerPool pool,
+				      LCUI_Worker worker)
+{
+	pool->callback_worker = worker;
+}
+
+static LCUI_TaskPriority CheckPriority(LCUI_TaskPriority priority)
+{
+	if ((int)priority < 0 || priority >= LCUI_TASK_PRIORITY_TOTAL_NUM) {
+		return LCUI_TASK_PRIORITY_DEFAULT;
+	}
+	return priority;
+}
+
+int LCUIWorkerPool_PostTask(LCUI_WorkerPool pool, LCUI_Task task,
+			    LCUI_TaskPriority priority)
+{
+	LCUI_AsyncTaskRec data;
+	LCUI_PoolWorker worker;
+
+	worker = LCUIWorkerPool_SelectWorker(pool);
+	LCUIAsyncTask_Init(&data, pool, task, 1);
+	if (!LCUIPoolWorker_Push(worker, &data, CheckPriority(priority),
+				 FALSE)) {
+		return -ENOMEM;
+	}
+	LCUIWorkerPool_WakeUp(pool);
+	return worker->index;
+}
+
+void LCUIWorkerPool_PostTaskTo(LCUI_WorkerPool pool, LCUI_Task task,
+			       int worker_id)
+{
+	LCUI_AsyncTaskRec data;
+	LCUI_PoolWorker worker;
+
+	if (worker_id < 0) {
+		worker_id = 0;
+	}
+	worker = &pool->workers[worker_id % pool->num_workers];
+	LCUIAsyncTask_Init(&data, pool, task, 1);
+	if (!LCUIPoolWorker_Push(worker, &data, LCUI_TASK_PRIORITY_DEFAULT,
+				 TRUE)) {
+		return;
+	}
+	/* 只有目标工作线程能执行该任务，需要唤醒所有线程 */
+	if (AtomicLoad(&pool->sleepers) > 0) {
+		LCUIMutex_Lock(&pool->mutex);
+		LCUICond_Broadcast(&pool->cond);
+		LCUIMutex_Unlock(&pool->mutex);
+	}
+}
+
+LCUI_AsyncTask LCUIWorkerPool_PostAsyncTask(LCUI_WorkerPool pool,
+					    LCUI_Task task,
+					    LCUI_TaskPriority priority,
+					    LCUI_AsyncTaskCallback callback,
+					    void *callback_arg)
+{
+	LCUI_AsyncTask t;
+	LCUI_AsyncTaskRec data;
+
+	LCUIAsyncTask_Init(&data, pool, task, 2);
+	data.callback = callback;
+	data.callback_arg = callback_arg;
+	t = LCUIPoolWorker_Push(LCUIWorkerPool_SelectWorker(pool), &data,
+				CheckPriority(priority), FALSE);
+	if (t) {
+		LCUIWorkerPool_WakeUp(pool);
+	}
+	return t;
+}
+
+void LCUIWorkerPool_Destroy(LCUI_WorkerPool pool)
+{
+	int i, p;
+	LCUI_AsyncTask task;
+	LCUI_PoolWorker worker;
+
+	if (!pool) {
+		return;
+	}
+	LCUIMutex_Lock(&pool->mutex);
+	AtomicCompareExchange(&pool->active, TRUE, FALSE);
+	LCUICond_Broadcast(&pool->cond);
+	LCUIMutex_Unlock(&pool->mutex);
+	for (i = 0; i < pool->num_workers; ++i) {
+		LCUIThread_Join(pool->workers[i].thread, NULL);
+	}
+	/* 取消剩余的任务 */
+	for (i = 0; i < pool->num_workers; ++i) {
+		worker = &pool->workers[i];
+		for (p = 0; p < LCUI_TASK_PRIORITY_TOTAL_NUM; ++p) {
+			while ((task = TaskDeque_PopFront(&worker->lanes[p])) ||
+			       (task = TaskDeque_PopFront(
+				    &worker->pinned_lanes[p]))) {
+				LCUIAsyncTask_Cancel(task);
+				LCUIAsyncTask_Finish(task);
+			}
+			TaskDeque_Destroy(&worker->lanes[p]);
+			TaskDeque_Destroy(&worker->pinned_lanes[p]);
+		}
+		while (worker->free_records) {
+			task = worker->free_records;
+			worker->free_records = task->next;
+			free(task);
+		}
+		LCUIMutex_Destroy(&worker->mutex);
+	}
+	LCUIMutex_Destroy(&pool->mutex);
+	LCUICond_Destroy(&pool->cond);
+	free(pool->workers);
+	pool->workers = NULL;
+	LCUIWorkerPool_Unref(pool);
+}
+
+/*-------------------------- Worker Pool <END> ------------------------------*/
@@ -18,17 +18,38 @@ int main(void)
 	describe("test settings", test_settings);
 	describe("test object", test_object);
 	describe("test thread", test_thread);
+	describe("test worker", test_worker);
+	describe("test timer", test_timer);
+	describe("test trace", test_trace);
 	describe("test font load", test_font_load);
+	describe("test font cache", test_font_cache);
+	describe("test textlayer", test_textlayer);
 	describe("test image reader", test_image_reader);
+	describe("test graph mix", test_graph_mix);
+	describe("test graphpool", test_graphpool);
 	describe("test xml parser", test_xml_parser);
 	describe("test widget event", test_widget_event);
 	describe("test widget opacity", test_widget_opacity);
+	describe("test background", test_background);
+	describe("test box shadow cache", test_box_shadow_cache);
+	describe("test widget layer", test_widget_layer);
+	describe("test widget hash", test_widget_hash);
+	describe("test widget index", test_widget_index);
+	describe("test style cache", test_style_cache);
+	describe("test region", test_region);
+	describe("test tile renderer", test_tile_renderer);
 	describe("test textview resize", test_textview_resize);
 	describe("test textedit", test_textedit);
 	describe("test mainloop", test_mainloop);
+	describe("test mainloop idle", test_mainloop_idle);
+	describe("test input queue", test_input_queue);
+	describe("test linux input", test_linux_input);
+	describe("test scroll", test_scroll);
+	describe("test headless", test_headless);
 	describe("test css parser", test_css_parser);
 	describe("test block layout", test_block_layout);
 	describe("test flex layout", test_flex_layout);
+	describe("test layout cache", test_layout_cache);
 	describe("test widget rect", test_widget_rect);
 	return ret - print_test_result();
 }
@@ -7,18 +7,39 @@ void test_string(void);
 void test_object(void);
 void test_settings(void);
 void test_thread(void);
+void test_worker(void);
 void test_font_load(void);
+void test_font_cache(void);
+void test_textlayer(void);
+void test_timer(void);
+void test_trace(void);
 void test_xml_parser(void);
 void test_strpool(void);
 void test_linkedlist(void);
 void test_widget_opacity(void);
+void test_background(void);
+void test_box_shadow_cache(void);
+void test_widget_layer(void);
+void test_region(void);
+void test_widget_hash(void);
+void test_widget_index(void);
+void test_style_cache(void);
+void test_tile_renderer(void);
 void test_widget_event(void);
 void test_textview_resize(void);
 void test_textedit(void);
 void test_image_reader(void);
+void test_graph_mix(void);
+void test_graphpool(void);
 
 void test_css_parser(void);
 void test_mainloop(void);
+void test_mainloop_idle(void);
+void test_input_queue(void);
+void test_linux_input(void);
+void test_scroll(void);
+void test_headless(void);
 void test_block_layout(void);
 void test_flex_layout(void);
+void test_layout_cache(void);
 void test_widget_rect(void);
@@ -0,0 +1,153 @@
+#include <stdio.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/image.h>
+#include <LCUI/painter.h>
+#include <LCUI/draw/background.h>
+#include <LCUI/gui/widget.h>
+#include <LCUI/gui/css_parser.h>
+#include "test.h"
+#include "libtest.h"
+
+#define WIDTH 200
+#define HEIGHT 150
+#define IMAGE_WIDTH 183
+#define IMAGE_HEIGHT 139
+
+static const char *css = "\
+.test-background {\
+  width: 200px;\
+  height: 150px;\
+  background-color: #fff;\
+  background-image: url(test_image_reader.png);\
+  background-size: 183px 139px;\
+}";
+
+/** 比较两个图像的颜色，部件渲染结果的透明度与直接绘制的不同，不参与比较 */
+static LCUI_BOOL CompareGraph(LCUI_Graph *a, LCUI_Graph *b)
+{
+	int x, y;
+	LCUI_Color ca, cb;
+
+	if (a->width != b->width || a->height != b->height) {
+		return FALSE;
+	}
+	for (y = 0; y < a->height; ++y) {
+		for (x = 0; x < a->width; ++x) {
+			Graph_GetPixel(a, x, y, ca);
+			Graph_GetPixel(b, x, y, cb);
+			if (ca.r != cb.r || ca.g != cb.g || ca.b != cb.b) {
+				return FALSE;
+			}
+		}
+	}
+	return TRUE;
+}
+
+static void CreateCanvas(LCUI_Graph *canvas)
+{
+	Graph_Init(canvas);
+	canvas->color_type = LCUI_COLOR_TYPE_ARGB;
+	Graph_Create(canvas, WIDTH, HEIGHT);
+	Graph_FillRect(canvas, RGB(255, 255, 255), NULL, FALSE);
+}
+
+/** 按照缩放缓存引入前的方式，用原图绘制整个背景 */
+static void PaintExpectedBackground(LCUI_Graph *canvas)
+{
+	LCUI_Graph image;
+	LCUI_Background bg;
+	LCUI_PaintContextRec paint;
+	LCUI_Rect box = { 0, 0, WIDTH, HEIGHT };
+
+	Graph_Init(&image);
+	LCUI_ReadImageFile("test_image_reader.png", &image);
+	memset(&bg, 0, sizeof(bg));
+	bg.image = &image;
+	bg.color = RGB(255, 255, 255);
+	bg.size.width = IMAGE_WIDTH;
+	bg.size.height = IMAGE_HEIGHT;
+	paint.rect = box;
+	paint.with_alpha = FALSE;
+	Graph_Quote(&paint.canvas, canvas, &box);
+	Background_Paint(&bg, &box, &paint);
+	Graph_Free(&image);
+}
+
+/** 将部件按分块绘制到画布上 */
+static void RenderWidget(LCUI_Widget w, LCUI_Graph *canvas, int tile_size)
+{
+	LCUI_PaintContextRec paint;
+
+	paint.with_alpha = FALSE;
+	paint.rect.width = tile_size;
+	paint.rect.height = tile_size;
+	for (paint.rect.y = 0; paint.rect.y < HEIGHT;
+	     paint.rect.y += tile_size) {
+		for (paint.rect.x = 0; paint.rect.x < WIDTH;
+		     paint.rect.x += tile_size) {
+			Graph_Quote(&paint.canvas, canvas, &paint.rect);
+			Widget_Render(w, &paint);
+		}
+	}
+}
+
+static void test_background_cache(void)
+{
+	int i;
+	LCUI_Widget w;
+	LCUI_Graph expected, canvas;
+	LCUI_BackgroundCacheStatsRec stats;
+
+	LCUI_LoadCSSString(css, NULL);
+	w = LCUIWidget_New(NULL);
+	Widget_AddClass(w, "test-background");
+	Widget_Append(LCUIWidget_GetRoot(), w);
+	for (i = 0; i < 100; ++i) {
+		LCUI_RunFrame();
+		if (Graph_IsValid(&w->computed_style.background.image)) {
+			break;
+		}
+		LCUI_MSleep(10);
+	}
+	LCUIWidget_Update();
+	it_b("check the background image is loaded",
+	     Graph_IsValid(&w->computed_style.background.image), TRUE);
+
+	CreateCanvas(&expected);
+	PaintExpectedBackground(&expected);
+	CreateCanvas(&canvas);
+	RenderWidget(w, &canvas, WIDTH);
+	it_b("check painting with the scaled image cache",
+	     CompareGraph(&canvas, &expected), TRUE);
+	Graph_FillRect(&canvas, RGB(255, 255, 255), NULL, FALSE);
+	RenderWidget(w, &canvas, 32);
+	it_b("check painting in tiles with the scaled image cache",
+	     CompareGraph(&canvas, &expected), TRUE);
+
+	LCUIWidget_GetBackgroundStats(&stats);
+	it_i("check the number of cached images", (int)stats.images, 1);
+	it_i("check the number of scaled images created", (int)stats.misses,
+	     1);
+	it_b("check the scaled image is reused", stats.hits > 0, TRUE);
+
+	LCUIWidget_SetBackgroundCacheSize(0);
+	LCUIWidget_GetBackgroundStats(&stats);
+	it_i("check evicting the scaled images", (int)stats.images, 0);
+	Graph_FillRect(&canvas, RGB(255, 255, 255), NULL, FALSE);
+	RenderWidget(w, &canvas, WIDTH);
+	it_b("check painting without the scaled image cache",
+	     CompareGraph(&canvas, &expected), TRUE);
+	LCUIWidget_SetBackgroundCacheSize(32 * 1024 * 1024);
+
+	Graph_Free(&canvas);
+	Graph_Free(&expected);
+}
+
+void test_background(void)
+{
+	LCUI_Init();
+	describe("check background image cache", test_background_cache);
+	LCUI_Destroy();
+}
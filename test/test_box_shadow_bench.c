@@ -0,0 +1,93 @@
+#include <stdio.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/graph.h>
+
+#define CARD_WIDTH 360
+#define CARD_HEIGHT 72
+#define CARD_SPACING 16
+#define VIEWPORT_HEIGHT 720
+#define FRAMES 120
+#define SCROLL_STEP 8
+
+typedef struct ShadowStyleRec_ {
+	const char *name;
+	int y, blur, spread, radius;
+} ShadowStyleRec;
+
+static ShadowStyleRec styles[] = { { "0 1px 3px", 1, 3, 0, 2 },
+				   { "0 4px 12px", 4, 12, 0, 4 },
+				   { "0 8px 24px 2px", 8, 24, 2, 8 } };
+
+/** 模拟滚动一个卡片列表，每一帧重绘视口内所有卡片的阴影 */
+static int64_t PaintCardList(LCUI_BoxShadow *shadow)
+{
+	int i, y, scroll_y;
+	int64_t t;
+	LCUI_Rect box, content;
+	LCUI_PaintContextRec paint;
+
+	content.x = content.y = 0;
+	content.width = CARD_WIDTH;
+	content.height = CARD_HEIGHT;
+	BoxShadow_GetCanvasRect(shadow, &content, &box);
+	box.x = box.y = 0;
+	Graph_Init(&paint.canvas);
+	paint.canvas.color_type = LCUI_COLOR_TYPE_ARGB;
+	Graph_Create(&paint.canvas, box.width, box.height);
+	paint.rect = box;
+	paint.with_alpha = TRUE;
+	t = LCUI_GetTime();
+	for (i = 0, scroll_y = 0; i < FRAMES; ++i, scroll_y += SCROLL_STEP) {
+		y = -(scroll_y % (CARD_HEIGHT + CARD_SPACING));
+		for (; y < VIEWPORT_HEIGHT; y += CARD_HEIGHT + CARD_SPACING) {
+			BoxShadow_Paint(shadow, &box, CARD_WIDTH, CARD_HEIGHT,
+					&paint);
+		}
+	}
+	t = LCUI_GetTimeDelta(t);
+	Graph_Free(&paint.canvas);
+	return t;
+}
+
+int main(int argc, char **argv)
+{
+	size_t i;
+	int64_t t0, t1;
+	char s_t0[32], s_t1[32], s_ratio[32];
+	LCUI_BoxShadow shadow;
+	LCUI_BoxShadowCacheStatsRec stats;
+
+	LCUI_InitBoxShadow();
+	Logger_Info("painting the shadows of %dx%d cards in a %dpx viewport, "
+		    "%d frames\n",
+		    CARD_WIDTH, CARD_HEIGHT, VIEWPORT_HEIGHT, FRAMES);
+	Logger_Info("%-20s%-16s%-16s%s\n", "box-shadow", "uncached", "cached",
+		    "speedup");
+	for (i = 0; i < sizeof(styles) / sizeof(styles[0]); ++i) {
+		shadow.x = 0;
+		shadow.y = styles[i].y;
+		shadow.blur = styles[i].blur;
+		shadow.spread = styles[i].spread;
+		shadow.color = ARGB(76, 0, 0, 0);
+		shadow.top_left_radius = styles[i].radius;
+		shadow.top_right_radius = styles[i].radius;
+		shadow.bottom_left_radius = styles[i].radius;
+		shadow.bottom_right_radius = styles[i].radius;
+		BoxShadow_SetCacheSize(0);
+		t0 = PaintCardList(&shadow);
+		BoxShadow_SetCacheSize(4 * 1024 * 1024);
+		t1 = PaintCardList(&shadow);
+		sprintf(s_t0, "%ldms", (long)t0);
+		sprintf(s_t1, "%ldms", (long)t1);
+		sprintf(s_ratio, "%.1fx", t1 > 0 ? 1.0 * t0 / t1 : 0.0);
+		Logger_Info("%-20s%-16s%-16s%s\n", styles[i].name, s_t0, s_t1,
+			    s_ratio);
+	}
+	BoxShadow_GetCacheStats(&stats);
+	Logger_Info("cache: %lu bitmaps, %lu bytes, %lu hits, %lu misses\n",
+		    (unsigned long)stats.bitmaps, (unsigned long)stats.bytes,
+		    (unsigned long)stats.hits, (unsigned long)stats.misses);
+	LCUI_FreeBoxShadow();
+	return 0;
+}
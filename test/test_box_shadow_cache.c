@@ -0,0 +1,158 @@
+#include <stdio.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/graph.h>
+#include "test.h"
+#include "libtest.h"
+
+#define CACHE_SIZE (4 * 1024 * 1024)
+
+typedef struct ShadowCaseRec_ {
+	const char *name;
+	int x, y, blur, spread, radius;
+	int content_width, content_height;
+} ShadowCaseRec, *ShadowCase;
+
+static ShadowCaseRec cases[] = {
+	{ "small blur", 0, 2, 6, 0, 0, 200, 120 },
+	{ "offset, spread and radius", 4, 4, 10, 2, 8, 160, 90 },
+	{ "negative offset", -6, -3, 12, 4, 4, 120, 200 },
+	{ "radius larger than box", 0, 0, 20, 0, 60, 80, 60 },
+	{ "box smaller than blur", 2, 2, 16, 0, 0, 8, 6 },
+	{ "spread only", 3, 3, 0, 5, 6, 100, 50 }
+};
+
+static void InitShadow(LCUI_BoxShadow *shadow, ShadowCase c)
+{
+	shadow->x = c->x;
+	shadow->y = c->y;
+	shadow->blur = c->blur;
+	shadow->spread = c->spread;
+	shadow->color = ARGB(120, 20, 40, 60);
+	shadow->top_left_radius = c->radius;
+	shadow->top_right_radius = c->radius;
+	shadow->bottom_left_radius = c->radius;
+	shadow->bottom_right_radius = c->radius / 2;
+}
+
+/** 按分块绘制阴影，tile_size 为 0 时一次绘制整个画布 */
+static void PaintShadow(LCUI_BoxShadow *shadow, ShadowCase c,
+			LCUI_Graph *canvas, int tile_size)
+{
+	LCUI_Rect box, content;
+	LCUI_PaintContextRec paint;
+
+	content.x = content.y = 0;
+	content.width = c->content_width;
+	content.height = c->content_height;
+	BoxShadow_GetCanvasRect(shadow, &content, &box);
+	box.x = box.y = 0;
+	Graph_Init(canvas);
+	canvas->color_type = LCUI_COLOR_TYPE_ARGB;
+	Graph_Create(canvas, box.width, box.height);
+	if (tile_size == 0) {
+		tile_size = max(box.width, box.height);
+	}
+	paint.with_alpha = TRUE;
+	paint.rect.width = tile_size;
+	paint.rect.height = tile_size;
+	for (paint.rect.y = 0; paint.rect.y < box.height;
+	     paint.rect.y += tile_size) {
+		for (paint.rect.x = 0; paint.rect.x < box.width;
+		     paint.rect.x += tile_size) {
+			Graph_Quote(&paint.canvas, canvas, &paint.rect);
+			BoxShadow_Paint(shadow, &box, content.width,
+					content.height, &paint);
+		}
+	}
+}
+
+static LCUI_BOOL CompareGraph(LCUI_Graph *a, LCUI_Graph *b)
+{
+	size_t size;
+
+	if (a->width != b->width || a->height != b->height) {
+		return FALSE;
+	}
+	size = sizeof(LCUI_ARGB) * a->width * a->height;
+	return memcmp(a->bytes, b->bytes, size) == 0;
+}
+
+static void test_box_shadow_paint(void)
+{
+	size_t i;
+	char str[256];
+	LCUI_BoxShadow shadow;
+	LCUI_Graph expected, actual;
+
+	for (i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+		InitShadow(&shadow, &cases[i]);
+
+		BoxShadow_SetCacheSize(0);
+		PaintShadow(&shadow, &cases[i], &expected, 0);
+		BoxShadow_SetCacheSize(CACHE_SIZE);
+		PaintShadow(&shadow, &cases[i], &actual, 0);
+		sprintf(str, "check %s", cases[i].name);
+		it_b(str, CompareGraph(&actual, &expected), TRUE);
+		Graph_Free(&actual);
+		Graph_Free(&expected);
+
+		BoxShadow_SetCacheSize(0);
+		PaintShadow(&shadow, &cases[i], &expected, 32);
+		BoxShadow_SetCacheSize(CACHE_SIZE);
+		PaintShadow(&shadow, &cases[i], &actual, 32);
+		sprintf(str, "check %s in tiles", cases[i].name);
+		it_b(str, CompareGraph(&actual, &expected), TRUE);
+		Graph_Free(&actual);
+		Graph_Free(&expected);
+	}
+}
+
+static void test_box_shadow_cache_stats(void)
+{
+	LCUI_Graph canvas;
+	LCUI_BoxShadow shadow;
+	ShadowCaseRec wider = cases[1];
+	LCUI_BoxShadowCacheStatsRec stats;
+
+	BoxShadow_SetCacheSize(0);
+	BoxShadow_GetCacheStats(&stats);
+	it_i("check the cache is empty", (int)stats.bitmaps, 0);
+
+	BoxShadow_SetCacheSize(CACHE_SIZE);
+	InitShadow(&shadow, &cases[1]);
+	PaintShadow(&shadow, &cases[1], &canvas, 32);
+	Graph_Free(&canvas);
+	BoxShadow_GetCacheStats(&stats);
+	it_i("check the number of cached bitmaps", (int)stats.bitmaps, 1);
+	it_b("check the bitmap is reused", stats.hits > 0, TRUE);
+
+	/* 阴影参数相同而尺寸不同的部件共享同一个阴影位图 */
+	wider.content_width += 100;
+	PaintShadow(&shadow, &wider, &canvas, 0);
+	Graph_Free(&canvas);
+	BoxShadow_GetCacheStats(&stats);
+	it_i("check boxes of different sizes share the bitmap",
+	     (int)stats.bitmaps, 1);
+
+	shadow.color = ARGB(255, 255, 0, 0);
+	PaintShadow(&shadow, &cases[1], &canvas, 0);
+	Graph_Free(&canvas);
+	BoxShadow_GetCacheStats(&stats);
+	it_i("check a different color adds a bitmap", (int)stats.bitmaps, 2);
+
+	BoxShadow_SetCacheSize(stats.bytes / 2);
+	BoxShadow_GetCacheStats(&stats);
+	it_i("check evicting the least recently used bitmap",
+	     (int)stats.bitmaps, 1);
+	BoxShadow_SetCacheSize(CACHE_SIZE);
+}
+
+void test_box_shadow_cache(void)
+{
+	LCUI_Init();
+	describe("check box shadow painting", test_box_shadow_paint);
+	describe("check box shadow cache", test_box_shadow_cache_stats);
+	LCUI_Destroy();
+}
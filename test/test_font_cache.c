@@ -0,0 +1,230 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/thread.h>
+#include <LCUI/font.h>
+#include "test.h"
+#include "libtest.h"
+
+#define CACHE_SIZE (256 * 1024)
+#define NUM_THREADS 4
+#define NUM_CHARS ('~' - '!' + 1)
+#define MIN_SIZE 12
+#define MAX_SIZE 15
+#define NUM_GLYPHS (NUM_CHARS * (MAX_SIZE - MIN_SIZE + 1))
+
+typedef struct ThreadContextRec_ {
+	LCUI_Thread tid;
+	const LCUI_FontBitmap *bitmaps[NUM_GLYPHS];
+} ThreadContextRec, *ThreadContext;
+
+static void test_font_bitmap_cache_lookup(void)
+{
+	const LCUI_FontBitmap *a, *b;
+	LCUI_FontBitmapCacheStatsRec stats, prev_stats;
+
+	LCUIFont_GetBitmapCacheStats(&prev_stats);
+	LCUIFont_GetBitmap('A', -1, 16, &a);
+	LCUIFont_GetBitmapCacheStats(&stats);
+	it_i("check the first lookup is a miss",
+	     (int)(stats.misses - prev_stats.misses), 1);
+	it_b("check the bitmap is rendered", a && a->buffer != NULL, TRUE);
+	it_b("check the bitmap is stored in a page", stats.pages > 0, TRUE);
+
+	LCUIFont_GetBitmap('A', -1, 16, &b);
+	LCUIFont_GetBitmapCacheStats(&prev_stats);
+	it_i("check the second lookup is a hit",
+	     (int)(prev_stats.hits - stats.hits), 1);
+	it_b("check the cached bitmap is reused", a == b, TRUE);
+	LCUIFont_ReleaseBitmap(b);
+	LCUIFont_GetBitmap('A', -1, 17, &b);
+	it_b("check bitmaps of different sizes", a != b, TRUE);
+	LCUIFont_ReleaseBitmap(b);
+	LCUIFont_ReleaseBitmap(a);
+}
+
+static void test_font_bitmap_cache_eviction(void)
+{
+	int size;
+	size_t hits;
+	LCUI_BOOL bounded = TRUE;
+	const LCUI_FontBitmap *a, *b;
+	LCUI_FontBitmapCacheStatsRec stats;
+
+	LCUIFont_SetBitmapCacheSize(CACHE_SIZE);
+	LCUIFont_GetBitmap('A', -1, 16, &a);
+	for (size = 100; size < 300; ++size) {
+		LCUIFont_GetBitmap('B', -1, size, &b);
+		LCUIFont_ReleaseBitmap(b);
+		LCUIFont_GetBitmapCacheStats(&stats);
+		if (stats.resident_bytes > stats.max_bytes) {
+			bounded = FALSE;
+		}
+	}
+	it_b("check glyphs are evicted", stats.evictions > 0, TRUE);
+	it_b("check resident bytes are bounded", bounded, TRUE);
+
+	hits = stats.hits;
+	LCUIFont_GetBitmap('A', -1, 16, &b);
+	LCUIFont_GetBitmapCacheStats(&stats);
+	it_b("check the retained glyph is kept",
+	     a == b && stats.hits == hits + 1, TRUE);
+	LCUIFont_ReleaseBitmap(b);
+
+	LCUIFont_SetBitmapCacheSize(0);
+	LCUIFont_GetBitmapCacheStats(&stats);
+	it_b("check the page of the retained glyph is kept",
+	     stats.pages == 1 && a->buffer != NULL, TRUE);
+	LCUIFont_ReleaseBitmap(a);
+	LCUIFont_SetBitmapCacheSize(0);
+	LCUIFont_GetBitmapCacheStats(&stats);
+	it_b("check all pages are released",
+	     stats.pages == 0 && stats.resident_bytes == 0, TRUE);
+
+	LCUIFont_SetBitmapCacheSize(CACHE_SIZE);
+	LCUIFont_GetBitmap('A', -1, 16, &b);
+	LCUIFont_GetBitmapCacheStats(&stats);
+	it_b("check the evicted glyph is rendered again",
+	     b && b->buffer != NULL && stats.pages == 1, TRUE);
+	LCUIFont_ReleaseBitmap(b);
+}
+
+static void test_font_bitmap_cache_pinned(void)
+{
+	int i;
+	size_t bytes = 0;
+	const LCUI_FontBitmap *bitmaps[20];
+	LCUI_FontBitmapCacheStatsRec stats;
+
+	/* 所有位图都被引用时，超出预算的部分不多于被引用的位图 */
+	LCUIFont_SetBitmapCacheSize(0);
+	for (i = 0; i < 20; ++i) {
+		LCUIFont_GetBitmap('C', -1, 100 + i, &bitmaps[i]);
+		bytes += (size_t)bitmaps[i]->width * bitmaps[i]->rows;
+	}
+	LCUIFont_GetBitmapCacheStats(&stats);
+	it_b("check the budget is exceeded by the pinned glyphs",
+	     stats.resident_bytes > stats.max_bytes, TRUE);
+	it_b("check the excess is limited to the pinned glyphs",
+	     stats.resident_bytes <= bytes, TRUE);
+	for (i = 0; i < 20; ++i) {
+		LCUIFont_ReleaseBitmap(bitmaps[i]);
+	}
+	LCUIFont_GetBitmapCacheStats(&stats);
+	it_b("check the excess is released with the glyphs",
+	     stats.pages == 0 && stats.resident_bytes == 0, TRUE);
+	LCUIFont_SetBitmapCacheSize(CACHE_SIZE);
+}
+
+static void test_font_bitmap_batch_loading(void)
+{
+	size_t i, n = 0;
+	const LCUI_FontBitmap *bmp;
+	LCUI_FontBitmapCacheStatsRec stats, prev_stats;
+	LCUI_FontBitmapRequestRec reqs[NUM_CHARS * 2];
+
+	for (i = 0; i < NUM_CHARS * 2; ++i) {
+		reqs[i].ch = '!' + i % NUM_CHARS;
+		reqs[i].size = 18;
+		reqs[i].font_ids = NULL;
+	}
+	it_i("check the number of loaded glyphs",
+	     (int)LCUIFont_LoadBitmaps(reqs, NUM_CHARS * 2), NUM_CHARS);
+	it_i("check cached glyphs are skipped",
+	     (int)LCUIFont_LoadBitmaps(reqs, NUM_CHARS * 2), 0);
+	LCUIFont_GetBitmapCacheStats(&prev_stats);
+	for (i = 0; i < NUM_CHARS; ++i) {
+		if (LCUIFont_GetBitmap(reqs[i].ch, -1, 18, &bmp) == 0 && bmp) {
+			++n;
+		}
+		LCUIFont_ReleaseBitmap(bmp);
+	}
+	LCUIFont_GetBitmapCacheStats(&stats);
+	it_i("check loaded glyphs are available", (int)n, NUM_CHARS);
+	it_i("check loaded glyphs are cached",
+	     (int)(stats.hits - prev_stats.hits), NUM_CHARS);
+}
+
+static void AcquireGlyphs(void *arg)
+{
+	int i, size;
+	wchar_t ch;
+	ThreadContext ctx = arg;
+
+	for (size = MIN_SIZE, i = 0; size <= MAX_SIZE; ++size) {
+		for (ch = '!'; ch <= '~'; ++ch, ++i) {
+			LCUIFont_AcquireBitmap(ch, NULL, size,
+					       &ctx->bitmaps[i]);
+		}
+	}
+}
+
+static void test_font_bitmap_cache_concurrency(void)
+{
+	int i, j;
+	LCUI_BOOL same = TRUE;
+	ThreadContextRec ctxs[NUM_THREADS];
+
+	for (i = 0; i < NUM_THREADS; ++i) {
+		LCUIThread_Create(&ctxs[i].tid, AcquireGlyphs, &ctxs[i]);
+	}
+	for (i = 0; i < NUM_THREADS; ++i) {
+		LCUIThread_Join(ctxs[i].tid, NULL);
+	}
+	for (i = 0; i < NUM_GLYPHS; ++i) {
+		for (j = 1; j < NUM_THREADS; ++j) {
+			if (!ctxs[j].bitmaps[i] ||
+			    ctxs[j].bitmaps[i] != ctxs[0].bitmaps[i]) {
+				same = FALSE;
+			}
+		}
+	}
+	it_b("check all threads get the same glyphs", same, TRUE);
+	for (i = 0; i < NUM_THREADS; ++i) {
+		for (j = 0; j < NUM_GLYPHS; ++j) {
+			LCUIFont_ReleaseBitmap(ctxs[i].bitmaps[j]);
+		}
+	}
+}
+
+/** 在 LCUI 运行时批量载入，字体位图会交给工作线程渲染 */
+static void test_font_bitmap_async_loading(void)
+{
+	size_t i, n = 0;
+	const LCUI_FontBitmap *bmp;
+	LCUI_FontBitmapRequestRec reqs[NUM_GLYPHS];
+
+	for (i = 0; i < NUM_GLYPHS; ++i) {
+		reqs[i].ch = '!' + i % NUM_CHARS;
+		reqs[i].size = MIN_SIZE + (int)(i / NUM_CHARS);
+		reqs[i].font_ids = NULL;
+	}
+	LCUI_Init();
+	it_i("check the number of glyphs loaded by workers",
+	     (int)LCUIFont_LoadBitmaps(reqs, NUM_GLYPHS), NUM_GLYPHS);
+	for (i = 0; i < NUM_GLYPHS; ++i) {
+		if (LCUIFont_GetBitmap(reqs[i].ch, -1, reqs[i].size, &bmp) ==
+			0 &&
+		    bmp) {
+			++n;
+		}
+		LCUIFont_ReleaseBitmap(bmp);
+	}
+	it_i("check glyphs loaded by workers are available", (int)n,
+	     NUM_GLYPHS);
+	LCUI_Destroy();
+}
+
+void test_font_cache(void)
+{
+	LCUI_InitFontLibrary();
+	describe("check lookup", test_font_bitmap_cache_lookup);
+	describe("check eviction", test_font_bitmap_cache_eviction);
+	describe("check the budget with pinned glyphs",
+		 test_font_bitmap_cache_pinned);
+	describe("check batch loading", test_font_bitmap_batch_loading);
+	describe("check concurrency", test_font_bitmap_cache_concurrency);
+	LCUI_FreeFontLibrary();
+	describe("check loading on workers", test_font_bitmap_async_loading);
+}
@@ -0,0 +1,154 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/graph.h>
+#include "test.h"
+#include "libtest.h"
+
+#define TEST_IMAGE_WIDTH 67
+#define TEST_IMAGE_HEIGHT 61
+
+static unsigned rand_seed;
+
+static uchar_t test_rand(void)
+{
+	rand_seed = rand_seed * 1103515245 + 12345;
+	return (uchar_t)((rand_seed >> 16) & 0xff);
+}
+
+/* Generates a pixel, biased toward the edge values of alpha */
+static void test_rand_pixel(LCUI_ARGB *px)
+{
+	px->r = test_rand();
+	px->g = test_rand();
+	px->b = test_rand();
+	switch (test_rand() % 4) {
+	case 0:
+		px->a = 0;
+		break;
+	case 1:
+		px->a = 255;
+		break;
+	default:
+		px->a = test_rand();
+		break;
+	}
+}
+
+static void test_create_image(LCUI_Graph *graph, unsigned seed)
+{
+	size_t i, n;
+
+	rand_seed = seed;
+	Graph_Init(graph);
+	graph->color_type = LCUI_COLOR_TYPE_ARGB;
+	Graph_Create(graph, TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT);
+	n = graph->width * graph->height;
+	for (i = 0; i < n; ++i) {
+		test_rand_pixel(&graph->argb[i]);
+	}
+}
+
+static int test_compare_pixel(const LCUI_ARGB *a, const LCUI_ARGB *b,
+			      LCUI_BOOL premultiplied)
+{
+	int d, max = abs(a->a - b->a);
+
+	/* color of the fully transparent pixel is meaningless */
+	if (a->a == 0 && b->a == 0) {
+		return 0;
+	}
+	/* The color of an almost transparent pixel is very sensitive to the
+	 * precision of alpha, so we compare the visible part of the color */
+	if (premultiplied) {
+		d = abs(a->r * a->a - b->r * b->a) / 255;
+		max = d > max ? d : max;
+		d = abs(a->g * a->a - b->g * b->a) / 255;
+		max = d > max ? d : max;
+		d = abs(a->b * a->a - b->b * b->a) / 255;
+		return d > max ? d : max;
+	}
+	d = abs(a->r - b->r);
+	max = d > max ? d : max;
+	d = abs(a->g - b->g);
+	max = d > max ? d : max;
+	d = abs(a->b - b->b);
+	return d > max ? d : max;
+}
+
+static int test_compare_image(const LCUI_Graph *a, const LCUI_Graph *b,
+			      LCUI_BOOL premultiplied)
+{
+	int d, max = 0;
+	size_t i, n = a->width * a->height;
+
+	for (i = 0; i < n; ++i) {
+		d = test_compare_pixel(&a->argb[i], &b->argb[i],
+				       premultiplied);
+		max = d > max ? d : max;
+	}
+	return max;
+}
+
+static void test_mix_with_mixer(LCUI_GraphMixerType type, const char *name)
+{
+	size_t i, n;
+	char str[256];
+	LCUI_Graph back, fore, golden, result;
+
+	if (Graph_SetMixerType(type) != 0) {
+		return;
+	}
+	test_create_image(&back, 1);
+	test_create_image(&fore, 2);
+	Graph_Init(&golden);
+	Graph_Init(&result);
+	Graph_Copy(&golden, &back);
+	Graph_Copy(&result, &back);
+	n = golden.width * golden.height;
+	for (i = 0; i < n; ++i) {
+		LCUI_OverPixel(&golden.argb[i], &fore.argb[i]);
+	}
+	Graph_Mix(&result, &fore, 0, 0, TRUE);
+	snprintf(str, 255, "[%s] Graph_Mix() output matches LCUI_OverPixel()",
+		 name);
+	it_b(str, test_compare_image(&golden, &result, FALSE) <= 1, TRUE);
+
+	/* mix into the unaligned area to test the remaining pixels */
+	Graph_Copy(&golden, &back);
+	Graph_Copy(&result, &back);
+	Graph_Mix(&result, &fore, 3, 5, TRUE);
+	Graph_SetMixerType(LCUI_GRAPH_MIXER_SCALAR);
+	Graph_Mix(&golden, &fore, 3, 5, TRUE);
+	snprintf(str, 255, "[%s] Graph_Mix() at offset matches scalar mixer",
+		 name);
+	it_b(str, test_compare_image(&golden, &result, FALSE) <= 1, TRUE);
+
+	Graph_Copy(&golden, &back);
+	Graph_Copy(&result, &back);
+	fore.opacity = 0.6f;
+	Graph_Mix(&golden, &fore, 0, 0, TRUE);
+	Graph_SetMixerType(type);
+	Graph_Mix(&result, &fore, 0, 0, TRUE);
+	snprintf(str, 255,
+		 "[%s] Graph_Mix() with opacity matches scalar mixer", name);
+	it_b(str, test_compare_image(&golden, &result, TRUE) <= 1, TRUE);
+
+	Graph_Free(&back);
+	Graph_Free(&fore);
+	Graph_Free(&golden);
+	Graph_Free(&result);
+}
+
+void test_graph_mix(void)
+{
+	LCUI_GraphMixerType type = Graph_GetMixerType();
+
+	it_b("check Graph_GetMixerType()", type != LCUI_GRAPH_MIXER_AUTO,
+	     TRUE);
+	test_mix_with_mixer(LCUI_GRAPH_MIXER_SCALAR, "scalar");
+	test_mix_with_mixer(LCUI_GRAPH_MIXER_SSE2, "sse2");
+	test_mix_with_mixer(LCUI_GRAPH_MIXER_AVX2, "avx2");
+	Graph_SetMixerType(type);
+}
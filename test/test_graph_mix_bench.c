@@ -0,0 +1,86 @@
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/graph.h>
+
+#define MIX_TIMES 10
+
+static void FillTestImage(LCUI_Graph *graph)
+{
+	size_t i, n = graph->width * graph->height;
+
+	srand(0);
+	for (i = 0; i < n; ++i) {
+		graph->argb[i].value = rand();
+		graph->argb[i].a = (uchar_t)(rand() & 0xff);
+	}
+}
+
+static int64_t MixTestImage(LCUI_GraphMixerType type, const LCUI_Graph *back,
+			    const LCUI_Graph *fore)
+{
+	int i;
+	int64_t t;
+	LCUI_Graph g_dst;
+
+	if (Graph_SetMixerType(type) != 0) {
+		return -1;
+	}
+	Graph_Init(&g_dst);
+	Graph_Copy(&g_dst, back);
+	t = LCUI_GetTime();
+	for (i = 0; i < MIX_TIMES; ++i) {
+		Graph_Mix(&g_dst, fore, 0, 0, TRUE);
+	}
+	t = LCUI_GetTime() - t;
+	Graph_Free(&g_dst);
+	return t;
+}
+
+static void FormatTime(char *str, int64_t t)
+{
+	if (t < 0) {
+		sprintf(str, "unsupported");
+	} else {
+		sprintf(str, "%ldms", (long)t);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	int i;
+	int resx[] = { 480, 960, 1280, 1366, 1920, 2560, 3840 }, resy;
+	char s_res[32], s_t0[32], s_t1[32], s_t2[32];
+
+	LCUI_Graph g_back, g_fore;
+
+	Logger_Info("mixing an ARGB image with alpha %d times\n", MIX_TIMES);
+	Logger_Info("%-20s%-20s%-20s%s\n", "image size\\mixer", "scalar",
+		    "sse2", "avx2");
+	for (i = 0; i < sizeof(resx) / sizeof(int); i++) {
+		resy = resx[i] * 9 / 16;
+		Graph_Init(&g_back);
+		Graph_Init(&g_fore);
+		g_back.color_type = LCUI_COLOR_TYPE_ARGB;
+		g_fore.color_type = LCUI_COLOR_TYPE_ARGB;
+		if (Graph_Create(&g_back, resx[i], resy) < 0 ||
+		    Graph_Create(&g_fore, resx[i], resy) < 0) {
+			return -2;
+		}
+		FillTestImage(&g_back);
+		FillTestImage(&g_fore);
+		FormatTime(s_t0, MixTestImage(LCUI_GRAPH_MIXER_SCALAR, &g_back,
+					      &g_fore));
+		FormatTime(s_t1, MixTestImage(LCUI_GRAPH_MIXER_SSE2, &g_back,
+					      &g_fore));
+		FormatTime(s_t2, MixTestImage(LCUI_GRAPH_MIXER_AVX2, &g_back,
+					      &g_fore));
+		sprintf(s_res, "%dx%d", resx[i], resy);
+		Logger_Info("%-20s%-20s%-20s%-20s\n", s_res, s_t0, s_t1, s_t2);
+		Graph_Free(&g_back);
+		Graph_Free(&g_fore);
+	}
+	return 0;
+}
@@ -0,0 +1,65 @@
+#include <stdio.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/graph.h>
+#include "test.h"
+#include "libtest.h"
+
+void test_graphpool(void)
+{
+	uchar_t *bytes;
+	LCUI_Graph a, b;
+	LCUI_GraphPool pool;
+	LCUI_GraphPoolStatsRec stats, stats2;
+
+	Graph_Init(&a);
+	Graph_Init(&b);
+	a.color_type = LCUI_COLOR_TYPE_ARGB;
+	b.color_type = LCUI_COLOR_TYPE_ARGB;
+	pool = GraphPool_Create(1 << 20);
+	it_b("check GraphPool_Create()", pool != NULL, TRUE);
+	it_i("check GraphPool_Alloc()", GraphPool_Alloc(pool, &a, 40, 30), 0);
+	it_b("check graph size", a.width == 40 && a.height == 30, TRUE);
+	Graph_FillRect(&a, RGB(255, 0, 0), NULL, FALSE);
+	bytes = a.bytes;
+	GraphPool_Release(pool, &a);
+	it_b("check released graph is empty", a.bytes == NULL, TRUE);
+	it_i("check allocating a graph of the same size class",
+	     GraphPool_Alloc(pool, &b, 36, 30), 0);
+	it_b("check buffer is reused", b.bytes == bytes, TRUE);
+	it_i("check reused buffer is cleared", b.argb[0].value, 0);
+	GraphPool_GetStats(pool, &stats);
+	it_i("check pool hits", (int)stats.hits, 1);
+	it_i("check pool misses", (int)stats.misses, 1);
+	it_b("check used bytes", stats.used_bytes >= 36 * 30 * 4, TRUE);
+
+	GraphPool_Trim(pool);
+	GraphPool_Release(pool, &b);
+	GraphPool_GetStats(pool, &stats);
+	it_b("check released buffer is cached", stats.cached_bytes > 0, TRUE);
+	GraphPool_Trim(pool);
+	GraphPool_GetStats(pool, &stats);
+	it_b("check buffer above high water mark is kept",
+	     stats.cached_bytes > 0, TRUE);
+	GraphPool_Trim(pool);
+	GraphPool_GetStats(pool, &stats);
+	it_i("check idle buffer is trimmed", (int)stats.cached_bytes, 0);
+
+	it_i("check allocating a graph larger than cache limit",
+	     GraphPool_Alloc(pool, &a, 1024, 1024), 0);
+	GraphPool_Release(pool, &a);
+	GraphPool_GetStats(pool, &stats);
+	it_i("check large buffer is not cached", (int)stats.cached_bytes, 0);
+
+	/* 4096 bytes is the size of the smallest size class */
+	Graph_Create(&a, 32, 32);
+	GraphPool_GetStats(pool, &stats);
+	GraphPool_Release(pool, &a);
+	GraphPool_GetStats(pool, &stats2);
+	it_b("check buffer created by Graph_Create() is freed",
+	     a.bytes == NULL && stats2.cached_bytes == stats.cached_bytes,
+	     TRUE);
+	it_i("check used bytes are not changed by other buffers",
+	     (int)stats2.used_bytes, (int)stats.used_bytes);
+	GraphPool_Destroy(pool);
+}
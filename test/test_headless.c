@@ -0,0 +1,172 @@
+#include <stdio.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/input.h>
+#include <LCUI/timer.h>
+#include <LCUI/display.h>
+#include <LCUI/gui/widget.h>
+#include <LCUI/headless.h>
+#include "test.h"
+#include "libtest.h"
+
+#define RAW_FILE "test_headless_frame.raw"
+#define PNG_FILE "test_headless_frame.png"
+
+typedef struct TestRecorderRec_ {
+	int clicks;
+	int keys;
+	int last_key;
+	int timeouts;
+} TestRecorderRec, *TestRecorder;
+
+static TestRecorderRec recorder;
+
+static void OnClick(LCUI_Widget w, LCUI_WidgetEvent e, void *arg)
+{
+	recorder.clicks += 1;
+}
+
+static void OnKeyDown(LCUI_SysEvent e, void *arg)
+{
+	recorder.keys += 1;
+	recorder.last_key = e->key.code;
+}
+
+static void OnTimeout(void *arg)
+{
+	recorder.timeouts += 1;
+}
+
+static long GetFileSize(const char *filename)
+{
+	long size;
+	FILE *fp;
+
+	fp = fopen(filename, "rb");
+	if (!fp) {
+		return -1;
+	}
+	fseek(fp, 0, SEEK_END);
+	size = ftell(fp);
+	fclose(fp);
+	remove(filename);
+	return size;
+}
+
+static LCUI_Widget CreateBox(void)
+{
+	LCUI_Widget w;
+
+	w = LCUIWidget_New(NULL);
+	Widget_SetStyle(w, key_background_color, RGB(255, 0, 0), color);
+	Widget_Move(w, 10, 10);
+	Widget_Resize(w, 100, 100);
+	Widget_SetPosition(w, SV_ABSOLUTE);
+	Widget_Append(LCUIWidget_GetRoot(), w);
+	return w;
+}
+
+static void test_headless_render(void)
+{
+	LCUI_Graph frame;
+	LCUI_Color color;
+
+	LCUIHeadless_Enable(TRUE);
+	LCUIHeadless_SetScreenSize(1024, 768);
+	LCUI_Init();
+	it_i("check the app driver", LCUI_GetAppId(), LCUI_APP_HEADLESS);
+	CreateBox();
+	LCUI_RunFrame();
+	it_i("check the display width", LCUIDisplay_GetWidth(), 800);
+	it_b("check the frame is presented", LCUIHeadless_GetFrameCount() > 0,
+	     TRUE);
+
+	Graph_Init(&frame);
+	it_i("check getting the frame", LCUIHeadless_GetFrame(&frame), 0);
+	it_i("check the frame width", frame.width, 800);
+	it_i("check the frame height", frame.height, 600);
+	Graph_GetPixel(&frame, 50, 50, color);
+	it_b("check the widget is rendered",
+	     color.r == 255 && color.g == 0 && color.b == 0, TRUE);
+	Graph_GetPixel(&frame, 300, 300, color);
+	it_b("check the background is rendered",
+	     color.r == 255 && color.g == 255 && color.b == 255, TRUE);
+	Graph_Free(&frame);
+
+	it_i("check writing the raw frame", LCUIHeadless_WriteFrame(RAW_FILE),
+	     0);
+	it_i("check the size of the raw frame", GetFileSize(RAW_FILE),
+	     800 * 600 * 4);
+	it_i("check writing the png frame", LCUIHeadless_WriteFrame(PNG_FILE),
+	     0);
+	it_b("check the png frame is written", GetFileSize(PNG_FILE) > 0,
+	     TRUE);
+	LCUI_Destroy();
+	LCUIHeadless_Enable(FALSE);
+}
+
+static void test_headless_input(void)
+{
+	int handler_id;
+	LCUI_Widget w;
+
+	recorder.clicks = 0;
+	recorder.keys = 0;
+	LCUIHeadless_Enable(TRUE);
+	LCUI_Init();
+	w = CreateBox();
+	Widget_BindEvent(w, "click", OnClick, NULL, NULL);
+	handler_id = LCUI_BindEvent(LCUI_KEYDOWN, OnKeyDown, NULL, NULL);
+	LCUI_RunFrame();
+
+	LCUIHeadless_MouseMove(50, 50);
+	LCUIHeadless_MouseDown(LCUI_KEY_LEFTBUTTON);
+	LCUIHeadless_MouseUp(LCUI_KEY_LEFTBUTTON);
+	LCUI_RunFrame();
+	it_i("check clicking the widget", recorder.clicks, 1);
+	LCUIHeadless_MouseMove(300, 300);
+	LCUIHeadless_MouseDown(LCUI_KEY_LEFTBUTTON);
+	LCUIHeadless_MouseUp(LCUI_KEY_LEFTBUTTON);
+	LCUI_RunFrame();
+	it_i("check clicking outside the widget", recorder.clicks, 1);
+
+	LCUIHeadless_KeyDown(LCUI_KEY_A);
+	LCUIHeadless_KeyUp(LCUI_KEY_A);
+	LCUI_RunFrame();
+	it_i("check the keydown event is triggered", recorder.keys, 1);
+	it_i("check the key code", recorder.last_key, LCUI_KEY_A);
+	LCUI_UnbindEvent(handler_id);
+	LCUI_Destroy();
+	LCUIHeadless_Enable(FALSE);
+}
+
+static void test_headless_virtual_clock(void)
+{
+	recorder.timeouts = 0;
+	LCUIHeadless_Enable(TRUE);
+	LCUIHeadless_EnableVirtualClock(TRUE);
+	LCUI_Init();
+	LCUI_SetTimeout(100, OnTimeout, NULL);
+	LCUI_MSleep(150);
+	LCUI_RunFrame();
+	it_i("check the timer does not follow the system time",
+	     recorder.timeouts, 0);
+	LCUIHeadless_AdvanceTime(99);
+	LCUI_RunFrame();
+	it_i("check the timer is not fired before it expires",
+	     recorder.timeouts, 0);
+	LCUIHeadless_AdvanceTime(1);
+	LCUI_RunFrame();
+	it_i("check the timer is fired after advancing the time",
+	     recorder.timeouts, 1);
+	LCUI_Destroy();
+	LCUIHeadless_EnableVirtualClock(FALSE);
+	LCUIHeadless_Enable(FALSE);
+}
+
+void test_headless(void)
+{
+	describe("check rendering frames", test_headless_render);
+	describe("check injecting input events", test_headless_input);
+	describe("check the virtual clock", test_headless_virtual_clock);
+}
@@ -0,0 +1,214 @@
+#include <stdio.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/display.h>
+#include <LCUI/gui/widget.h>
+#include <LCUI/gui/widget/textview.h>
+#include <LCUI/gui/css_parser.h>
+#include <LCUI/headless.h>
+
+#define SCREEN_WIDTH 1280
+#define SCREEN_HEIGHT 720
+#define FRAMES 30
+#define FRAME_TIME 16
+
+static const char *css = "\
+.card {\
+  width: 100px;\
+  height: 36px;\
+  margin: 4px;\
+  padding: 4px;\
+  display: inline-block;\
+  border: 1px solid #ccc;\
+  border-radius: 6px;\
+  background-color: #fff;\
+}\
+.card-header {\
+  height: 12px;\
+  border-radius: 4px;\
+  background-color: #3c8ce7;\
+}\
+.card-body {\
+  height: 12px;\
+  margin-top: 4px;\
+  opacity: 0.6;\
+  background-color: #00eaff;\
+}\
+.shadow {\
+  box-shadow: 0 2px 6px rgba(0, 0, 0, 0.3);\
+}\
+.text {\
+  width: 300px;\
+  margin: 2px;\
+  display: inline-block;\
+  font-size: 14px;\
+}\
+.row {\
+  height: 32px;\
+  padding: 4px;\
+  border-bottom: 1px solid #eee;\
+  background-color: #fafafa;\
+}";
+
+typedef struct BenchSceneRec_ {
+	const char *name;
+	void (*build)(LCUI_Widget);
+	void (*update)(LCUI_Widget, int);
+
+	int64_t time;
+	size_t frames;
+	unsigned hash;
+} BenchSceneRec, *BenchScene;
+
+static LCUI_Widget CreateCard(const char *classes)
+{
+	LCUI_Widget card, w;
+
+	card = LCUIWidget_New(NULL);
+	Widget_AddClass(card, classes);
+	w = LCUIWidget_New(NULL);
+	Widget_AddClass(w, "card-header");
+	Widget_Append(card, w);
+	w = LCUIWidget_New(NULL);
+	Widget_AddClass(w, "card-body");
+	Widget_Append(card, w);
+	return card;
+}
+
+static void BuildWidgets(LCUI_Widget root)
+{
+	int i;
+
+	for (i = 0; i < 96 * 6; ++i) {
+		Widget_Append(root, CreateCard("card"));
+	}
+}
+
+static void BuildShadows(LCUI_Widget root)
+{
+	int i;
+
+	for (i = 0; i < 96 * 6; ++i) {
+		Widget_Append(root, CreateCard("card shadow"));
+	}
+}
+
+static void BuildText(LCUI_Widget root)
+{
+	int i;
+	LCUI_Widget w;
+
+	for (i = 0; i < 4 * 36; ++i) {
+		w = LCUIWidget_New("textview");
+		Widget_AddClass(w, "text");
+		TextView_SetTextW(w, L"The quick brown fox jumps over the lazy "
+				     L"dog 0123456789");
+		Widget_Append(root, w);
+	}
+}
+
+static void BuildList(LCUI_Widget root)
+{
+	int i;
+	wchar_t text[64];
+	LCUI_Widget list, row;
+
+	list = LCUIWidget_New(NULL);
+	Widget_SetId(list, "list");
+	Widget_SetPosition(list, SV_ABSOLUTE);
+	Widget_Move(list, 0, 0);
+	Widget_Resize(list, SCREEN_WIDTH, 1000 * 41);
+	for (i = 0; i < 1000; ++i) {
+		row = LCUIWidget_New("textview");
+		Widget_AddClass(row, "row");
+		swprintf(text, 64, L"Row %d", i);
+		TextView_SetTextW(row, text);
+		Widget_Append(list, row);
+	}
+	Widget_Append(root, list);
+}
+
+/** 使整个画面失效，让每一帧都完整重绘 */
+static void InvalidateAll(LCUI_Widget root, int frame)
+{
+	Widget_InvalidateArea(root, NULL, SV_GRAPH_BOX);
+}
+
+static void ScrollList(LCUI_Widget root, int frame)
+{
+	LCUI_Widget list = LCUIWidget_GetById("list");
+
+	Widget_Move(list, 0, -(float)(frame * 40));
+}
+
+/** 计算画面的哈希值，用于确认每次运行的结果都一样 */
+static unsigned GetFrameHash(void)
+{
+	unsigned i, n, hash = 2166136261u;
+	LCUI_Graph frame;
+
+	Graph_Init(&frame);
+	if (LCUIHeadless_GetFrame(&frame) != 0) {
+		return 0;
+	}
+	n = frame.width * frame.height;
+	for (i = 0; i < n; ++i) {
+		hash = (hash ^ (unsigned)frame.argb[i].value) * 16777619u;
+	}
+	Graph_Free(&frame);
+	return hash;
+}
+
+static void RunBench(BenchScene scene)
+{
+	int i;
+	int64_t t;
+	LCUI_Widget root;
+
+	LCUIHeadless_Enable(TRUE);
+	LCUIHeadless_EnableVirtualClock(TRUE);
+	LCUI_Init();
+	LCUI_LoadCSSString(css, NULL);
+	LCUIDisplay_SetSize(SCREEN_WIDTH, SCREEN_HEIGHT);
+	root = LCUIWidget_GetRoot();
+	scene->build(root);
+	/* 第一帧用于布局和预热缓存 */
+	LCUI_RunFrame();
+	t = LCUI_GetNanoTime();
+	for (i = 1; i <= FRAMES; ++i) {
+		LCUIHeadless_AdvanceTime(FRAME_TIME);
+		scene->update(root, i);
+		LCUI_RunFrame();
+	}
+	scene->time = LCUI_GetNanoTime() - t;
+	scene->frames = LCUIHeadless_GetFrameCount();
+	scene->hash = GetFrameHash();
+	LCUI_Destroy();
+}
+
+int main(int argc, char **argv)
+{
+	size_t i, n;
+	char s_frame[32];
+	BenchSceneRec scenes[] = {
+		{ "widgets", BuildWidgets, InvalidateAll },
+		{ "text", BuildText, InvalidateAll },
+		{ "shadows", BuildShadows, InvalidateAll },
+		{ "scrolling", BuildList, ScrollList }
+	};
+
+	n = sizeof(scenes) / sizeof(scenes[0]);
+	for (i = 0; i < n; ++i) {
+		RunBench(&scenes[i]);
+	}
+	Logger_Info("%dx%d, %d frames, %dms per frame on the virtual clock\n",
+		    SCREEN_WIDTH, SCREEN_HEIGHT, FRAMES, FRAME_TIME);
+	Logger_Info("%-12s%-14s%-10s%s\n", "scene", "per frame", "frames",
+		    "hash");
+	for (i = 0; i < n; ++i) {
+		sprintf(s_frame, "%.2fms", scenes[i].time / 1000000.0 / FRAMES);
+		Logger_Info("%-12s%-14s%-10lu%08x\n", scenes[i].name, s_frame,
+			    (unsigned long)scenes[i].frames, scenes[i].hash);
+	}
+	return 0;
+}
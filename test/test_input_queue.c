@@ -0,0 +1,252 @@
+#include <stdio.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/thread.h>
+#include <LCUI/input.h>
+#include <LCUI/display.h>
+#include <LCUI/gui/widget.h>
+#include <LCUI/headless.h>
+#include "test.h"
+#include "libtest.h"
+
+/* 以 1000 Hz 采样一秒的鼠标轨迹，每 16 个采样点运行一帧 */
+#define SAMPLES 1000
+#define SAMPLES_PER_FRAME 16
+#define MOUSEDOWN_SAMPLE 500
+#define MOUSEUP_SAMPLE 520
+#define TOUCH_MOVES 10
+
+static struct {
+	LCUI_Pos stream[SAMPLES];
+	size_t next_sample;
+	size_t moves;
+	size_t widget_moves;
+	size_t errors;
+	size_t mousedown_sample;
+	size_t mouseup_sample;
+	int xrel, yrel;
+	size_t touches;
+	size_t touch_samples;
+	int touch_x;
+} self;
+
+/** 生成一段先加速后减速的曲线轨迹 */
+static void CreateStream(void)
+{
+	int i;
+
+	for (i = 0; i < SAMPLES; ++i) {
+		self.stream[i].x = 20 + i * i / 2500 + (i % 50) * (i % 7) / 10;
+		self.stream[i].y = 20 + i * 3 / 8 + (i / 100) * 5;
+	}
+}
+
+static void OnMouseMove(LCUI_SysEvent e, void *arg)
+{
+	size_t i, n;
+	LCUI_SysEvent samples;
+
+	self.moves += 1;
+	self.xrel += e->motion.xrel;
+	self.yrel += e->motion.yrel;
+	n = LCUI_GetCoalescedEvents(&samples);
+	for (i = 0; i < n; ++i) {
+		if (self.next_sample >= SAMPLES ||
+		    samples[i].motion.x != self.stream[self.next_sample].x ||
+		    samples[i].motion.y != self.stream[self.next_sample].y) {
+			self.errors += 1;
+		}
+		self.next_sample += 1;
+	}
+	if (n < 1 || samples[n - 1].motion.x != e->motion.x ||
+	    samples[n - 1].motion.y != e->motion.y) {
+		self.errors += 1;
+	}
+}
+
+static void OnWidgetMouseMove(LCUI_Widget w, LCUI_WidgetEvent e, void *arg)
+{
+	self.widget_moves += 1;
+}
+
+static void OnWidgetMouseDown(LCUI_Widget w, LCUI_WidgetEvent e, void *arg)
+{
+	self.mousedown_sample = self.next_sample;
+}
+
+static void OnWidgetMouseUp(LCUI_Widget w, LCUI_WidgetEvent e, void *arg)
+{
+	self.mouseup_sample = self.next_sample;
+}
+
+static void OnTouch(LCUI_SysEvent e, void *arg)
+{
+	size_t n;
+	LCUI_SysEvent samples;
+
+	n = LCUI_GetCoalescedEvents(&samples);
+	self.touches += 1;
+	self.touch_samples += n;
+	self.touch_x = e->touch.points[0].x;
+}
+
+static void test_input_queue_replay(void)
+{
+	int i;
+	int handler_id;
+	size_t frames = 0;
+	char str[256];
+	LCUI_Widget w;
+	LCUI_SysEventRec ev = { 0 };
+
+	CreateStream();
+	self.moves = 0;
+	self.errors = 0;
+	self.next_sample = 0;
+	self.widget_moves = 0;
+	self.xrel = 0;
+	self.yrel = 0;
+	LCUIHeadless_Enable(TRUE);
+	LCUI_Init();
+	w = LCUIWidget_New(NULL);
+	Widget_Resize(w, 800, 600);
+	Widget_BindEvent(w, "mousemove", OnWidgetMouseMove, NULL, NULL);
+	Widget_BindEvent(w, "mousedown", OnWidgetMouseDown, NULL, NULL);
+	Widget_BindEvent(w, "mouseup", OnWidgetMouseUp, NULL, NULL);
+	Widget_Append(LCUIWidget_GetRoot(), w);
+	handler_id = LCUI_BindEvent(LCUI_MOUSEMOVE, OnMouseMove, NULL, NULL);
+	LCUI_RunFrame();
+
+	for (i = 0; i < SAMPLES; ++i) {
+		ev.type = LCUI_MOUSEMOVE;
+		ev.motion.x = self.stream[i].x;
+		ev.motion.y = self.stream[i].y;
+		ev.motion.xrel = i > 0 ? ev.motion.x - self.stream[i - 1].x : 0;
+		ev.motion.yrel = i > 0 ? ev.motion.y - self.stream[i - 1].y : 0;
+		LCUI_PostEvent(&ev);
+		if (i + 1 == MOUSEDOWN_SAMPLE || i + 1 == MOUSEUP_SAMPLE) {
+			ev.type = i + 1 == MOUSEDOWN_SAMPLE ? LCUI_MOUSEDOWN
+							    : LCUI_MOUSEUP;
+			ev.button.x = self.stream[i].x;
+			ev.button.y = self.stream[i].y;
+			ev.button.button = LCUI_KEY_LEFTBUTTON;
+			LCUI_PostEvent(&ev);
+		}
+		if ((i + 1) % SAMPLES_PER_FRAME == 0) {
+			LCUI_RunFrame();
+			frames += 1;
+		}
+	}
+	LCUI_RunFrame();
+	frames += 1;
+
+	sprintf(str, "check the mousemove events are coalesced (%zu events)",
+		self.moves);
+	it_b(str, self.moves <= frames + 2, TRUE);
+	it_i("check the widget receives the coalesced events",
+	     (int)self.widget_moves, (int)self.moves);
+	it_i("check all samples are available", (int)self.next_sample,
+	     SAMPLES);
+	it_i("check the samples are in order", (int)self.errors, 0);
+	it_i("check the relative motion is accumulated", self.xrel,
+	     self.stream[SAMPLES - 1].x - self.stream[0].x);
+	it_i("check the mousedown keeps its order", (int)self.mousedown_sample,
+	     MOUSEDOWN_SAMPLE);
+	it_i("check the mouseup keeps its order", (int)self.mouseup_sample,
+	     MOUSEUP_SAMPLE);
+	LCUI_UnbindEvent(handler_id);
+	LCUI_Destroy();
+	LCUIHeadless_Enable(FALSE);
+}
+
+static void PostTouchEvent(int x, int state)
+{
+	LCUI_SysEventRec ev;
+	LCUI_TouchPointRec point = { 0 };
+
+	point.x = x;
+	point.y = 100;
+	point.id = 1;
+	point.state = state;
+	point.is_primary = TRUE;
+	LCUI_CreateTouchEvent(&ev, &point, 1);
+	LCUI_PostEvent(&ev);
+	LCUI_DestroyEvent(&ev);
+}
+
+static void test_input_queue_touch(void)
+{
+	int i;
+	int handler_id;
+
+	self.touches = 0;
+	self.touch_samples = 0;
+	LCUIHeadless_Enable(TRUE);
+	LCUI_Init();
+	handler_id = LCUI_BindEvent(LCUI_TOUCH, OnTouch, NULL, NULL);
+	PostTouchEvent(10, LCUI_TOUCHDOWN);
+	for (i = 1; i <= TOUCH_MOVES; ++i) {
+		PostTouchEvent(10 + i * 5, LCUI_TOUCHMOVE);
+	}
+	LCUI_ProcessEvents();
+	it_i("check the touch moves are coalesced", (int)self.touches, 2);
+	it_i("check the touch samples", (int)self.touch_samples,
+	     TOUCH_MOVES + 1);
+	it_i("check the latest touch position", self.touch_x,
+	     10 + TOUCH_MOVES * 5);
+	PostTouchEvent(80, LCUI_TOUCHUP);
+	LCUI_ProcessEvents();
+	it_i("check the touch up is not coalesced", (int)self.touches, 3);
+	LCUI_UnbindEvent(handler_id);
+	LCUI_Destroy();
+	LCUIHeadless_Enable(FALSE);
+}
+
+static void PostMovesThread(void *arg)
+{
+	int i;
+	LCUI_SysEventRec ev = { 0 };
+
+	ev.type = LCUI_MOUSEMOVE;
+	for (i = 0; i < SAMPLES; ++i) {
+		ev.motion.x = self.stream[i].x;
+		ev.motion.y = self.stream[i].y;
+		LCUI_PostEvent(&ev);
+	}
+	LCUIThread_Exit(NULL);
+}
+
+static void test_input_queue_thread(void)
+{
+	int handler_id;
+	LCUI_Thread tid;
+
+	CreateStream();
+	self.moves = 0;
+	self.errors = 0;
+	self.next_sample = 0;
+	LCUIHeadless_Enable(TRUE);
+	LCUI_Init();
+	handler_id = LCUI_BindEvent(LCUI_MOUSEMOVE, OnMouseMove, NULL, NULL);
+	LCUIThread_Create(&tid, PostMovesThread, NULL);
+	LCUIThread_Join(tid, NULL);
+	LCUI_ProcessEvents();
+	it_i("check the events posted by other thread are coalesced",
+	     (int)self.moves, 1);
+	it_i("check the samples posted by other thread",
+	     (int)self.next_sample, SAMPLES);
+	it_i("check the samples posted by other thread are in order",
+	     (int)self.errors, 0);
+	LCUI_UnbindEvent(handler_id);
+	LCUI_Destroy();
+	LCUIHeadless_Enable(FALSE);
+}
+
+void test_input_queue(void)
+{
+	describe("check replaying a 1000 Hz motion stream",
+		 test_input_queue_replay);
+	describe("check coalescing touch events", test_input_queue_touch);
+	describe("check posting events from other thread",
+		 test_input_queue_thread);
+}
@@ -0,0 +1,151 @@
+#include <stdio.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/gui/widget.h>
+#include <LCUI/gui/widget/textview.h>
+#include <LCUI/gui/css_parser.h>
+
+#define FRAMES 100
+#define DEPTH 12
+#define SIBLINGS 4
+#define ITEMS 400
+
+static const char *css = "\
+.row { display: flex; padding: 2px; }\
+.column { display: inline-block; padding: 2px; }\
+.item { display: inline-block; margin: 2px; padding: 2px; font-size: 12px; }\
+.wrap { flex-wrap: wrap; width: 1200px; }\
+.card { width: 120px; height: 40px; padding: 4px; }";
+
+typedef struct BenchSceneRec_ {
+	const char *name;
+	void (*build)(LCUI_Widget);
+	int64_t time;
+	size_t layouts;
+	size_t cache_hits;
+} BenchSceneRec, *BenchScene;
+
+static LCUI_Widget target;
+
+static LCUI_Widget CreateItem(const wchar_t *text)
+{
+	LCUI_Widget w;
+
+	w = LCUIWidget_New("textview");
+	Widget_AddClass(w, "item");
+	TextView_SetTextW(w, text);
+	return w;
+}
+
+/**
+ * 一层嵌套一层的 flex 容器，每层都有若干兄弟部件，容器的尺寸都由内容决定，
+ * 所以底层文本的变化会一直传播到最外层的容器
+ */
+static void BuildDeepTree(LCUI_Widget root)
+{
+	int i, j;
+	LCUI_Widget parent = root, w;
+
+	for (i = 0; i < DEPTH; ++i) {
+		w = LCUIWidget_New(NULL);
+		Widget_AddClass(w, i % 2 ? "column" : "row");
+		for (j = 0; j < SIBLINGS; ++j) {
+			Widget_Append(w, CreateItem(L"a"));
+		}
+		Widget_Append(parent, w);
+		parent = w;
+	}
+	target = CreateItem(L"0");
+	Widget_Append(parent, target);
+}
+
+/** 一个可换行的 flex 容器，包含大量子部件 */
+static void BuildWideTree(LCUI_Widget root)
+{
+	int i;
+	LCUI_Widget w;
+
+	w = LCUIWidget_New(NULL);
+	Widget_AddClass(w, "row wrap");
+	for (i = 0; i < ITEMS; ++i) {
+		Widget_Append(w, CreateItem(L"item"));
+	}
+	target = CreateItem(L"0");
+	Widget_Append(w, target);
+	Widget_Append(root, w);
+}
+
+/** 在固定尺寸的卡片中修改文本，卡片之外的部件都不应该重新布局 */
+static void BuildCards(LCUI_Widget root)
+{
+	int i;
+	LCUI_Widget w, card;
+
+	w = LCUIWidget_New(NULL);
+	Widget_AddClass(w, "row wrap");
+	for (i = 0; i < ITEMS; ++i) {
+		card = LCUIWidget_New(NULL);
+		Widget_AddClass(card, "card");
+		Widget_Append(card, CreateItem(L"card"));
+		Widget_Append(w, card);
+	}
+	card = LCUIWidget_New(NULL);
+	Widget_AddClass(card, "card");
+	target = CreateItem(L"0");
+	Widget_Append(card, target);
+	Widget_Append(w, card);
+	Widget_Append(root, w);
+}
+
+static void RunBench(BenchScene scene)
+{
+	int i;
+	int64_t t;
+	size_t count, hits;
+	wchar_t text[32];
+
+	LCUI_Init();
+	LCUI_LoadCSSString(css, NULL);
+	scene->build(LCUIWidget_GetRoot());
+	LCUIWidget_Update();
+	count = LCUIWidget_GetLayoutCount();
+	hits = LCUIWidget_GetLayoutCacheHits();
+	t = LCUI_GetNanoTime();
+	for (i = 1; i <= FRAMES; ++i) {
+		/* 让文本的长度不断变化，以改变部件的尺寸 */
+		swprintf(text, 32, L"text %d",
+			 i * 7919 % (i % 3 ? 100 : 100000));
+		TextView_SetTextW(target, text);
+		LCUIWidget_Update();
+	}
+	scene->time = LCUI_GetNanoTime() - t;
+	scene->layouts = LCUIWidget_GetLayoutCount() - count;
+	scene->cache_hits = LCUIWidget_GetLayoutCacheHits() - hits;
+	LCUI_Destroy();
+}
+
+int main(int argc, char **argv)
+{
+	size_t i, n;
+	char s_time[32];
+	BenchSceneRec warmup = { "warmup", BuildCards };
+	BenchSceneRec scenes[] = { { "deep", BuildDeepTree },
+				   { "wide", BuildWideTree },
+				   { "cards", BuildCards } };
+
+	n = sizeof(scenes) / sizeof(scenes[0]);
+	RunBench(&warmup);
+	for (i = 0; i < n; ++i) {
+		RunBench(&scenes[i]);
+	}
+	Logger_Info("%d frames, one text change per frame\n", FRAMES);
+	Logger_Info("%-10s%-14s%-10s%s\n", "scene", "per frame", "layouts",
+		    "cache hits");
+	for (i = 0; i < n; ++i) {
+		sprintf(s_time, "%.3fms", scenes[i].time / 1e6 / FRAMES);
+		Logger_Info("%-10s%-14s%-10.1f%.1f\n", scenes[i].name, s_time,
+			    1.0 * scenes[i].layouts / FRAMES,
+			    1.0 * scenes[i].cache_hits / FRAMES);
+	}
+	return 0;
+}
@@ -0,0 +1,158 @@
+#include <stdio.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/gui/widget.h>
+#include <LCUI/gui/widget/textview.h>
+#include <LCUI/gui/css_parser.h>
+#include "test.h"
+#include "libtest.h"
+
+#define DEPTH 6
+
+static const char *css = "\
+.row { display: flex; padding: 2px; }\
+.column { display: inline-block; padding: 2px; }\
+.item { display: inline-block; margin: 2px; padding: 2px; }\
+.card { width: 120px; height: 40px; padding: 4px; }";
+
+static size_t layouts;
+
+static void OnAfterLayout(LCUI_Widget w, LCUI_WidgetEvent e, void *arg)
+{
+	layouts += 1;
+}
+
+static void BindAfterLayout(LCUI_Widget w)
+{
+	LinkedListNode *node;
+
+	Widget_BindEvent(w, "afterlayout", OnAfterLayout, NULL, NULL);
+	for (LinkedList_Each(node, &w->children)) {
+		BindAfterLayout(node->data);
+	}
+}
+
+static LCUI_Widget CreateItem(const wchar_t *text)
+{
+	LCUI_Widget w;
+
+	w = LCUIWidget_New("textview");
+	Widget_AddClass(w, "item");
+	TextView_SetTextW(w, text);
+	return w;
+}
+
+/** 创建嵌套的 flex 布局，返回最底层的文本部件 */
+static LCUI_Widget CreateTree(LCUI_Widget root, const wchar_t *text)
+{
+	int i;
+	LCUI_Widget parent = root, w;
+
+	for (i = 0; i < DEPTH; ++i) {
+		w = LCUIWidget_New(NULL);
+		Widget_AddClass(w, i % 2 ? "column" : "row");
+		Widget_Append(w, CreateItem(L"item"));
+		Widget_Append(w, CreateItem(L"text"));
+		Widget_Append(parent, w);
+		parent = w;
+	}
+	w = CreateItem(text);
+	Widget_Append(parent, w);
+	return w;
+}
+
+/** 比较两棵部件树中每个子部件的布局结果 */
+static size_t CompareTree(LCUI_Widget a, LCUI_Widget b)
+{
+	size_t errors = 0;
+	LinkedListNode *na, *nb;
+
+	na = a->children.head.next;
+	nb = b->children.head.next;
+	while (na && nb) {
+		a = na->data;
+		b = nb->data;
+		if (!LCUIRectF_IsEquals(&a->box.border, &b->box.border)) {
+			errors += 1;
+		}
+		errors += CompareTree(a, b);
+		na = na->next;
+		nb = nb->next;
+	}
+	return errors;
+}
+
+static void test_layout_cache_result(void)
+{
+	size_t i, count;
+	LCUI_Widget a, b, target;
+	const wchar_t *texts[] = { L"long long long text", L"a",
+				   L"medium text", L"a" };
+
+	LCUI_Init();
+	LCUI_LoadCSSString(css, NULL);
+	a = LCUIWidget_New(NULL);
+	b = LCUIWidget_New(NULL);
+	Widget_Append(LCUIWidget_GetRoot(), a);
+	Widget_Append(LCUIWidget_GetRoot(), b);
+	target = CreateTree(a, L"text");
+	LCUIWidget_Update();
+	for (i = 0; i < sizeof(texts) / sizeof(texts[0]); ++i) {
+		TextView_SetTextW(target, texts[i]);
+		Widget_Empty(b);
+		CreateTree(b, texts[i]);
+		LCUIWidget_Update();
+		it_i("check the result is same as a new layout",
+		     (int)CompareTree(a, b), 0);
+	}
+	it_b("check the cache is used", LCUIWidget_GetLayoutCacheHits() > 0,
+	     TRUE);
+
+	BindAfterLayout(LCUIWidget_GetRoot());
+	layouts = 0;
+	count = LCUIWidget_GetLayoutCount() + LCUIWidget_GetLayoutCacheHits();
+	TextView_SetTextW(target, L"long long long text");
+	LCUIWidget_Update();
+	count = LCUIWidget_GetLayoutCount() +
+		LCUIWidget_GetLayoutCacheHits() - count;
+	it_i("check afterlayout is triggered for every layout",
+	     (int)layouts, (int)count);
+	LCUI_Destroy();
+}
+
+static void test_layout_cache_boundary(void)
+{
+	int i;
+	float width;
+	LCUI_Widget row, card, target;
+
+	LCUI_Init();
+	LCUI_LoadCSSString(css, NULL);
+	row = LCUIWidget_New(NULL);
+	Widget_AddClass(row, "row");
+	for (i = 0; i < 10; ++i) {
+		card = LCUIWidget_New(NULL);
+		Widget_AddClass(card, "card");
+		target = CreateItem(L"text");
+		Widget_Append(card, target);
+		Widget_Append(row, card);
+	}
+	Widget_Append(LCUIWidget_GetRoot(), row);
+	LCUIWidget_Update();
+	width = card->width;
+	Widget_BindEvent(row, "afterlayout", OnAfterLayout, NULL, NULL);
+	layouts = 0;
+	TextView_SetTextW(target, L"long long text");
+	LCUIWidget_Update();
+	it_b("check the text is laid out", target->width > 60, TRUE);
+	it_b("check the card size is not changed", card->width == width, TRUE);
+	it_i("check the parent of the fixed size card is not reflowed",
+	     (int)layouts, 0);
+	LCUI_Destroy();
+}
+
+void test_layout_cache(void)
+{
+	describe("check the layout result", test_layout_cache_result);
+	describe("check the relayout boundary", test_layout_cache_boundary);
+}
@@ -0,0 +1,385 @@
+#include <stdio.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/input.h>
+#include <LCUI/display.h>
+#include <LCUI/headless.h>
+#include "test.h"
+#include "libtest.h"
+
+#ifdef LCUI_BUILD_IN_LINUX
+#include <stdlib.h>
+#include <unistd.h>
+#include <linux/input.h>
+#include <LCUI/platform/linux/linux_input.h>
+
+#define MAX_RECORDS 512
+#define MOUSE_MOVES 100
+#define TOUCH_MOVES 10
+#define REPLAY_TIMEOUT 2000
+
+static struct {
+	size_t n_records;
+	struct input_event records[MAX_RECORDS];
+
+	LCUI_BOOL done;
+	size_t moves;
+	size_t move_samples;
+	int mouse_x;
+	int mouse_y;
+	int xrel;
+	int yrel;
+	int mousedown_x;
+	int mousedown_y;
+	int mouseup_x;
+	int mouseup_y;
+	int wheel_delta;
+
+	int keys[8];
+	size_t n_keys;
+	char text[8];
+	size_t text_len;
+
+	size_t touches;
+	size_t touch_samples;
+	LCUI_TouchPointRec first_points[2];
+	int first_n_points;
+	int second_n_points;
+	LCUI_TouchPointRec last_points[2];
+	int last_n_points;
+	LCUI_BOOL primary_up;
+} self;
+
+static void Record(int type, int code, int value)
+{
+	struct input_event *e = &self.records[self.n_records++];
+
+	memset(e, 0, sizeof(struct input_event));
+	e->type = type;
+	e->code = code;
+	e->value = value;
+}
+
+static void RecordSync(void)
+{
+	Record(EV_SYN, SYN_REPORT, 0);
+}
+
+static void OnMouseMove(LCUI_SysEvent e, void *arg)
+{
+	LCUI_SysEvent samples;
+
+	self.moves += 1;
+	self.move_samples += LCUI_GetCoalescedEvents(&samples);
+	self.mouse_x = e->motion.x;
+	self.mouse_y = e->motion.y;
+	self.xrel += e->motion.xrel;
+	self.yrel += e->motion.yrel;
+}
+
+static void OnMouseDown(LCUI_SysEvent e, void *arg)
+{
+	self.mousedown_x = e->button.x;
+	self.mousedown_y = e->button.y;
+}
+
+static void OnMouseUp(LCUI_SysEvent e, void *arg)
+{
+	self.mouseup_x = e->button.x;
+	self.mouseup_y = e->button.y;
+}
+
+static void OnMouseWheel(LCUI_SysEvent e, void *arg)
+{
+	self.wheel_delta = e->wheel.delta;
+	self.done = TRUE;
+}
+
+static void OnKeyDown(LCUI_SysEvent e, void *arg)
+{
+	if (self.n_keys < 8) {
+		self.keys[self.n_keys++] = e->key.code;
+	}
+}
+
+static void OnKeyPress(LCUI_SysEvent e, void *arg)
+{
+	if (self.text_len < 7) {
+		self.text[self.text_len++] = (char)e->key.code;
+	}
+}
+
+static void OnKeyUp(LCUI_SysEvent e, void *arg)
+{
+	if (e->key.code == LCUI_KEY_I) {
+		self.done = TRUE;
+	}
+}
+
+static void OnTouch(LCUI_SysEvent e, void *arg)
+{
+	int i, n = min(e->touch.n_points, 2);
+	LCUI_SysEvent samples;
+
+	self.touches += 1;
+	self.touch_samples += LCUI_GetCoalescedEvents(&samples);
+	if (self.touches == 1) {
+		self.first_n_points = e->touch.n_points;
+		for (i = 0; i < n; ++i) {
+			self.first_points[i] = e->touch.points[i];
+		}
+	} else if (self.touches == 2) {
+		self.second_n_points = e->touch.n_points;
+	}
+	self.last_n_points = e->touch.n_points;
+	for (i = 0; i < n; ++i) {
+		self.last_points[i] = e->touch.points[i];
+		if (e->touch.points[i].is_primary &&
+		    e->touch.points[i].state == LCUI_TOUCHUP) {
+			self.primary_up = TRUE;
+		}
+	}
+	if (e->touch.n_points == 1 &&
+	    e->touch.points[0].state == LCUI_TOUCHUP) {
+		self.done = TRUE;
+	}
+}
+
+/** 通过管道回放录制的事件，等待主循环处理完最后一个事件 */
+static int Replay(void)
+{
+	int fds[2];
+	int64_t t;
+	size_t size = sizeof(struct input_event) * self.n_records;
+
+	self.done = FALSE;
+	if (pipe(fds) != 0) {
+		return -1;
+	}
+	if (LCUI_AddLinuxInputDevice(fds[0]) != 0) {
+		close(fds[1]);
+		return -1;
+	}
+	if (write(fds[1], self.records, size) != (ssize_t)size) {
+		close(fds[1]);
+		return -1;
+	}
+	close(fds[1]);
+	t = LCUI_GetTime();
+	while (!self.done && LCUI_GetTimeDelta(t) < REPLAY_TIMEOUT) {
+		LCUI_ProcessEvents();
+		LCUI_MSleep(5);
+	}
+	return self.done ? 0 : -1;
+}
+
+static void InitReplay(void)
+{
+	memset(&self, 0, sizeof(self));
+	/* 不打开真实的输入设备，只回放录制的事件 */
+	setenv("LCUI_INPUT_DEVICES", "", 1);
+	LCUIHeadless_Enable(TRUE);
+	LCUI_Init();
+	LCUI_RunFrame();
+	LCUI_InitLinuxInput();
+}
+
+static void FreeReplay(void)
+{
+	LCUI_FreeLinuxInput();
+	LCUI_Destroy();
+	LCUIHeadless_Enable(FALSE);
+	unsetenv("LCUI_INPUT_DEVICES");
+}
+
+static void test_linux_input_mouse(void)
+{
+	int i;
+	char str[256];
+
+	InitReplay();
+	LCUI_BindEvent(LCUI_MOUSEMOVE, OnMouseMove, NULL, NULL);
+	LCUI_BindEvent(LCUI_MOUSEDOWN, OnMouseDown, NULL, NULL);
+	LCUI_BindEvent(LCUI_MOUSEUP, OnMouseUp, NULL, NULL);
+	LCUI_BindEvent(LCUI_MOUSEWHEEL, OnMouseWheel, NULL, NULL);
+	for (i = 0; i < MOUSE_MOVES; ++i) {
+		Record(EV_REL, REL_X, 2);
+		Record(EV_REL, REL_Y, 1);
+		RecordSync();
+	}
+	Record(EV_KEY, BTN_LEFT, 1);
+	RecordSync();
+	Record(EV_REL, REL_X, -10);
+	Record(EV_KEY, BTN_LEFT, 0);
+	RecordSync();
+	Record(EV_REL, REL_WHEEL, -1);
+	RecordSync();
+	it_i("check replaying the recorded mouse events", Replay(), 0);
+	sprintf(str, "check each report is a motion sample (%zu events)",
+		self.moves);
+	it_i(str, (int)self.move_samples, MOUSE_MOVES + 1);
+	it_i("check the pointer x", self.mouse_x, 400 + MOUSE_MOVES * 2 - 10);
+	it_i("check the pointer y", self.mouse_y, 300 + MOUSE_MOVES);
+	it_i("check the relative motion", self.yrel, MOUSE_MOVES);
+	it_i("check the mousedown position", self.mousedown_x,
+	     400 + MOUSE_MOVES * 2);
+	it_i("check the mouseup follows the motion in the same report",
+	     self.mouseup_x, 400 + MOUSE_MOVES * 2 - 10);
+	it_i("check the wheel delta", self.wheel_delta, -20);
+	FreeReplay();
+}
+
+static void test_linux_input_keyboard(void)
+{
+	InitReplay();
+	LCUI_BindEvent(LCUI_KEYDOWN, OnKeyDown, NULL, NULL);
+	LCUI_BindEvent(LCUI_KEYPRESS, OnKeyPress, NULL, NULL);
+	LCUI_BindEvent(LCUI_KEYUP, OnKeyUp, NULL, NULL);
+	Record(EV_KEY, KEY_LEFTSHIFT, 1);
+	RecordSync();
+	Record(EV_KEY, KEY_H, 1);
+	RecordSync();
+	Record(EV_KEY, KEY_H, 0);
+	RecordSync();
+	Record(EV_KEY, KEY_LEFTSHIFT, 0);
+	RecordSync();
+	Record(EV_KEY, KEY_I, 1);
+	RecordSync();
+	Record(EV_KEY, KEY_I, 0);
+	RecordSync();
+	it_i("check replaying the recorded key events", Replay(), 0);
+	it_i("check the number of keydown events", (int)self.n_keys, 3);
+	it_i("check the shift key code", self.keys[0], LCUI_KEY_SHIFT);
+	it_i("check the letter key code", self.keys[1], LCUI_KEY_H);
+	it_s("check the typed text", self.text, "Hi");
+	FreeReplay();
+}
+
+static void test_linux_input_touch(void)
+{
+	int i;
+
+	InitReplay();
+	LCUI_BindEvent(LCUI_TOUCH, OnTouch, NULL, NULL);
+	LCUI_BindEvent(LCUI_MOUSEDOWN, OnMouseDown, NULL, NULL);
+	LCUI_BindEvent(LCUI_MOUSEUP, OnMouseUp, NULL, NULL);
+	Record(EV_ABS, ABS_MT_SLOT, 0);
+	Record(EV_ABS, ABS_MT_TRACKING_ID, 10);
+	Record(EV_ABS, ABS_MT_POSITION_X, 100);
+	Record(EV_ABS, ABS_MT_POSITION_Y, 200);
+	Record(EV_KEY, BTN_TOUCH, 1);
+	Record(EV_ABS, ABS_X, 100);
+	Record(EV_ABS, ABS_Y, 200);
+	RecordSync();
+	Record(EV_ABS, ABS_MT_SLOT, 1);
+	Record(EV_ABS, ABS_MT_TRACKING_ID, 11);
+	Record(EV_ABS, ABS_MT_POSITION_X, 300);
+	Record(EV_ABS, ABS_MT_POSITION_Y, 200);
+	RecordSync();
+	for (i = 1; i <= TOUCH_MOVES; ++i) {
+		Record(EV_ABS, ABS_MT_SLOT, 0);
+		Record(EV_ABS, ABS_MT_POSITION_X, 100 + i * 10);
+		Record(EV_ABS, ABS_MT_SLOT, 1);
+		Record(EV_ABS, ABS_MT_POSITION_X, 300 + i * 10);
+		Record(EV_ABS, ABS_X, 100 + i * 10);
+		RecordSync();
+	}
+	Record(EV_ABS, ABS_MT_SLOT, 0);
+	Record(EV_ABS, ABS_MT_TRACKING_ID, -1);
+	RecordSync();
+	Record(EV_ABS, ABS_MT_SLOT, 1);
+	Record(EV_ABS, ABS_MT_TRACKING_ID, -1);
+	Record(EV_KEY, BTN_TOUCH, 0);
+	RecordSync();
+	it_i("check replaying the recorded touch events", Replay(), 0);
+	it_i("check the first touch event has one point",
+	     self.first_n_points, 1);
+	it_i("check the first point is down",
+	     self.first_points[0].state, LCUI_TOUCHDOWN);
+	it_i("check the first point id", self.first_points[0].id, 10);
+	it_b("check the first point is primary",
+	     self.first_points[0].is_primary, TRUE);
+	it_i("check the second touch event has two points",
+	     self.second_n_points, 2);
+	it_i("check the touch samples", (int)self.touch_samples,
+	     TOUCH_MOVES + 4);
+	it_i("check the last point id", self.last_points[0].id, 11);
+	it_i("check the last point position", self.last_points[0].x,
+	     300 + TOUCH_MOVES * 10);
+	it_b("check the last point is not primary",
+	     self.last_points[0].is_primary, FALSE);
+	it_b("check the primary point is released", self.primary_up, TRUE);
+	it_i("check the primary point emulates mousedown", self.mousedown_x,
+	     100);
+	it_i("check the primary point emulates mouseup", self.mouseup_x,
+	     100 + TOUCH_MOVES * 10);
+	FreeReplay();
+}
+
+static void test_linux_input_dropped(void)
+{
+	InitReplay();
+	LCUI_BindEvent(LCUI_MOUSEMOVE, OnMouseMove, NULL, NULL);
+	LCUI_BindEvent(LCUI_MOUSEUP, OnMouseUp, NULL, NULL);
+	LCUI_BindEvent(LCUI_KEYDOWN, OnKeyDown, NULL, NULL);
+	LCUI_BindEvent(LCUI_KEYPRESS, OnKeyPress, NULL, NULL);
+	LCUI_BindEvent(LCUI_KEYUP, OnKeyUp, NULL, NULL);
+	LCUI_BindEvent(LCUI_TOUCH, OnTouch, NULL, NULL);
+	Record(EV_KEY, KEY_LEFTSHIFT, 1);
+	RecordSync();
+	Record(EV_ABS, ABS_MT_SLOT, 0);
+	Record(EV_ABS, ABS_MT_TRACKING_ID, 10);
+	Record(EV_ABS, ABS_MT_POSITION_X, 100);
+	Record(EV_ABS, ABS_MT_POSITION_Y, 200);
+	Record(EV_ABS, ABS_MT_SLOT, 1);
+	Record(EV_ABS, ABS_MT_TRACKING_ID, 11);
+	Record(EV_ABS, ABS_MT_POSITION_X, 300);
+	Record(EV_ABS, ABS_MT_POSITION_Y, 200);
+	RecordSync();
+	/* 溢出前的报告是不完整的，释放按键和抬起触点的事件都已丢失 */
+	Record(EV_REL, REL_X, 5);
+	Record(EV_SYN, SYN_DROPPED, 0);
+	Record(EV_REL, REL_X, 1000);
+	Record(EV_KEY, KEY_LEFTSHIFT, 0);
+	RecordSync();
+	Record(EV_REL, REL_X, 1);
+	RecordSync();
+	Record(EV_KEY, KEY_H, 1);
+	RecordSync();
+	Record(EV_KEY, KEY_H, 0);
+	Record(EV_KEY, KEY_I, 1);
+	RecordSync();
+	Record(EV_KEY, KEY_I, 0);
+	RecordSync();
+	it_i("check replaying the events with a dropped report", Replay(), 0);
+	it_i("check the touch events", (int)self.touches, 2);
+	it_i("check all points are released after the drop",
+	     self.last_n_points, 2);
+	it_i("check the first point is released", self.last_points[0].state,
+	     LCUI_TOUCHUP);
+	it_i("check the second point is released", self.last_points[1].state,
+	     LCUI_TOUCHUP);
+	it_b("check the primary point is released", self.primary_up, TRUE);
+	it_i("check the partial motion is discarded", self.mouse_x,
+	     self.mouseup_x + 1);
+	it_s("check the shift key is released", self.text, "hi");
+	FreeReplay();
+}
+
+void test_linux_input(void)
+{
+	describe("check replaying mouse events", test_linux_input_mouse);
+	describe("check replaying key events", test_linux_input_keyboard);
+	describe("check replaying multitouch events", test_linux_input_touch);
+	describe("check resyncing after dropped events",
+		 test_linux_input_dropped);
+}
+
+#else
+
+void test_linux_input(void)
+{
+}
+
+#endif
@@ -0,0 +1,200 @@
+#include <stdio.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/thread.h>
+#include <LCUI/timer.h>
+#include <LCUI/display.h>
+#include <LCUI/gui/widget.h>
+#include <LCUI/gui/widget/textview.h>
+#include <LCUI/headless.h>
+#include "test.h"
+#include "libtest.h"
+
+#define IDLE_TIME 1000
+#define TIMER_DELAY 300
+#define BUSY_TASKS 64
+
+static struct {
+	size_t wakeups;
+	int64_t start_time;
+	int64_t timer_time;
+	int64_t post_time;
+	int64_t task_time;
+	int intervals;
+	int64_t release_time;
+	size_t image_pixels;
+	LCUI_Widget image;
+} self;
+
+static void OnInterval(void *arg)
+{
+	self.intervals += 1;
+}
+
+static void OnStartCounting(void *arg)
+{
+	self.wakeups = LCUI_GetWakeupCount();
+}
+
+static void OnStopCounting(void *arg)
+{
+	self.wakeups = LCUI_GetWakeupCount() - self.wakeups;
+	LCUI_Quit();
+}
+
+static void OnTimeout(void *arg)
+{
+	self.timer_time = LCUI_GetTime();
+}
+
+static void OnTask(void *arg1, void *arg2)
+{
+	self.task_time = LCUI_GetTime();
+}
+
+/** 在主循环空闲时，从其它线程添加任务 */
+static void PostTaskThread(void *arg)
+{
+	LCUI_TaskRec task = { 0 };
+
+	LCUI_MSleep(TIMER_DELAY / 2);
+	task.func = OnTask;
+	self.post_time = LCUI_GetTime();
+	LCUI_PostTask(&task);
+	LCUIThread_Exit(NULL);
+}
+
+static void OnBusyTask(void *arg1, void *arg2)
+{
+	while (LCUI_GetTime() < self.release_time) {
+		LCUI_MSleep(1);
+	}
+}
+
+/**
+ * 设置背景图，图片会在工作线程中异步加载
+ * 先让所有工作线程忙碌一段时间，确保图片在主循环进入空闲后才加载完
+ */
+static void OnSetBackgroundImage(void *arg)
+{
+	int i;
+	LCUI_TaskRec task = { 0 };
+
+	task.func = OnBusyTask;
+	self.release_time = LCUI_GetTime() + TIMER_DELAY / 2;
+	for (i = 0; i < BUSY_TASKS; ++i) {
+		LCUI_PostAsyncTask(&task);
+	}
+	Widget_SetStyleString(self.image, "background-image",
+			      "url(test_image_reader.png)");
+}
+
+/** 统计部件区域内被背景图覆盖的像素，此时还没有运行本次唤醒的帧 */
+static void OnCheckBackgroundImage(void *arg)
+{
+	int x, y;
+	LCUI_Color color;
+	LCUI_Graph frame;
+
+	Graph_Init(&frame);
+	LCUIHeadless_GetFrame(&frame);
+	self.image_pixels = 0;
+	for (y = 0; y < 60 && y < (int)frame.height; ++y) {
+		for (x = 0; x < 80 && x < (int)frame.width; ++x) {
+			Graph_GetPixel(&frame, x, y, color);
+			if (color.r != 255 || color.g != 255 ||
+			    color.b != 255) {
+				self.image_pixels += 1;
+			}
+		}
+	}
+	Graph_Free(&frame);
+	LCUI_Quit();
+}
+
+static void BuildWidgets(void)
+{
+	LCUI_Widget w;
+
+	w = LCUIWidget_New("textview");
+	TextView_SetTextW(w, L"idle");
+	Widget_Append(LCUIWidget_GetRoot(), w);
+}
+
+static void test_mainloop_idle_wakeups(void)
+{
+	char str[256];
+
+	self.intervals = 0;
+	LCUIHeadless_Enable(TRUE);
+	LCUI_Init();
+	BuildWidgets();
+	/* 跳过前几帧的布局和渲染，只统计空闲时的唤醒次数 */
+	LCUI_SetTimeout(100, OnStartCounting, NULL);
+	LCUI_SetTimeout(100 + IDLE_TIME, OnStopCounting, NULL);
+	LCUI_SetInterval(250, OnInterval, NULL);
+	LCUI_Main();
+	LCUIHeadless_Enable(FALSE);
+	sprintf(str, "check the wakeups per second at idle (actual %zu)",
+		self.wakeups);
+	it_b(str, self.wakeups <= (size_t)self.intervals + 4, TRUE);
+	it_b("check the interval timer still works", self.intervals >= 3,
+	     TRUE);
+}
+
+static void test_mainloop_idle_wake_up(void)
+{
+	char str[256];
+	LCUI_Thread tid;
+
+	self.task_time = 0;
+	self.timer_time = 0;
+	LCUIHeadless_Enable(TRUE);
+	LCUI_Init();
+	BuildWidgets();
+	LCUIThread_Create(&tid, PostTaskThread, NULL);
+	self.start_time = LCUI_GetTime();
+	LCUI_SetTimeout(TIMER_DELAY, OnTimeout, NULL);
+	LCUI_SetTimeout(TIMER_DELAY * 2, OnStopCounting, NULL);
+	self.wakeups = LCUI_GetWakeupCount();
+	LCUI_Main();
+	LCUIThread_Join(tid, NULL);
+	LCUIHeadless_Enable(FALSE);
+	sprintf(str, "check the posted task wakes up the main loop (%dms)",
+		(int)(self.task_time - self.post_time));
+	it_b(str,
+	     self.task_time > 0 && self.task_time - self.post_time < 50,
+	     TRUE);
+	sprintf(str, "check the main loop wakes up at the deadline (%dms)",
+		(int)(self.timer_time - self.start_time));
+	it_b(str,
+	     self.timer_time - self.start_time >= TIMER_DELAY &&
+		 self.timer_time - self.start_time < TIMER_DELAY + 50,
+	     TRUE);
+}
+
+static void test_mainloop_idle_async_image(void)
+{
+	char str[256];
+
+	LCUIHeadless_Enable(TRUE);
+	LCUI_Init();
+	self.image = LCUIWidget_New(NULL);
+	Widget_Resize(self.image, 80, 60);
+	Widget_Append(LCUIWidget_GetRoot(), self.image);
+	LCUI_SetTimeout(TIMER_DELAY, OnSetBackgroundImage, NULL);
+	LCUI_SetTimeout(TIMER_DELAY * 4, OnCheckBackgroundImage, NULL);
+	LCUI_Main();
+	LCUIHeadless_Enable(FALSE);
+	sprintf(str, "check the loaded image is painted at idle (%zu pixels)",
+		self.image_pixels);
+	it_b(str, self.image_pixels > 0, TRUE);
+}
+
+void test_mainloop_idle(void)
+{
+	describe("check the idle main loop", test_mainloop_idle_wakeups);
+	describe("check waking up the main loop", test_mainloop_idle_wake_up);
+	describe("check painting an image loaded at idle",
+		 test_mainloop_idle_async_image);
+}
@@ -0,0 +1,156 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include "test.h"
+#include "libtest.h"
+
+/** 检查区域是否覆盖了矩形 */
+static LCUI_BOOL CheckRegionCoverRect(LCUI_Region region, LCUI_Rect *rect)
+{
+	int i;
+
+	for (i = 0; i < region->length; ++i) {
+		if (LCUIRect_IsIncludeRect(&region->rects[i], rect)) {
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+static void test_region_merge(void)
+{
+	LCUI_RegionRec region;
+	LCUI_RegionStatsRec stats;
+	LCUI_Rect rect;
+
+	LCUIRegion_Init(&region);
+	rect = Rect(0, 0, 0, 10);
+	it_i("check adding an empty rect", LCUIRegion_AddRect(&region, &rect),
+	     -1);
+
+	rect = Rect(0, 0, 100, 10);
+	it_i("check adding the first rect", LCUIRegion_AddRect(&region, &rect),
+	     0);
+	rect = Rect(0, 10, 100, 10);
+	it_i("check adding an adjacent rect",
+	     LCUIRegion_AddRect(&region, &rect), 1);
+	it_i("check adjacent rects are merged", region.length, 1);
+	rect = Rect(0, 0, 100, 20);
+	it_rect("check the merged rect", &region.rects[0], &rect);
+
+	rect = Rect(10, 5, 20, 10);
+	LCUIRegion_AddRect(&region, &rect);
+	it_i("check the included rect is ignored", region.length, 1);
+
+	rect = Rect(400, 400, 100, 100);
+	it_i("check adding a distant rect", LCUIRegion_AddRect(&region, &rect),
+	     0);
+	it_i("check distant rects are not merged", region.length, 2);
+	it_i("check the area", (int)LCUIRegion_GetArea(&region), 12000);
+
+	rect = Rect(0, 0, 600, 600);
+	LCUIRegion_AddRect(&region, &rect);
+	it_i("check the covering rect replaces others", region.length, 1);
+	it_rect("check the covering rect", &region.rects[0], &rect);
+
+	LCUIRegion_GetStats(&region, &stats);
+	it_i("check stats.added_rects", (int)stats.added_rects, 5);
+	it_i("check stats.merged_rects", (int)stats.merged_rects, 3);
+	it_i("check stats.rects", (int)stats.rects, 1);
+	it_i("check stats.area", (int)stats.area, 360000);
+
+	LCUIRegion_Clear(&region);
+	LCUIRegion_GetStats(&region, &stats);
+	it_b("check clearing region",
+	     region.length == 0 && stats.added_rects == 0, TRUE);
+}
+
+static void test_region_cost(void)
+{
+	int i;
+	LCUI_RegionRec region;
+	LCUI_Rect rect;
+
+	/* the text cursor and the character beside it */
+	LCUIRegion_Init(&region);
+	rect = Rect(100, 100, 2, 16);
+	LCUIRegion_AddRect(&region, &rect);
+	rect = Rect(104, 100, 8, 16);
+	LCUIRegion_AddRect(&region, &rect);
+	it_i("check nearby small rects are merged", region.length, 1);
+
+	/* two thin rects of a diagonal line waste too many pixels */
+	LCUIRegion_Clear(&region);
+	rect = Rect(0, 0, 800, 4);
+	LCUIRegion_AddRect(&region, &rect);
+	rect = Rect(0, 200, 4, 400);
+	LCUIRegion_AddRect(&region, &rect);
+	it_i("check rects with large waste are not merged", region.length, 2);
+
+	/* a merge is allowed to absorb other rects */
+	LCUIRegion_Clear(&region);
+	for (i = 0; i < 8; ++i) {
+		rect = Rect(i * 16, 0, 16, 16);
+		LCUIRegion_AddRect(&region, &rect);
+	}
+	it_i("check a row of tiles is merged", region.length, 1);
+	rect = Rect(0, 0, 128, 16);
+	it_rect("check the merged row", &region.rects[0], &rect);
+
+	LCUIRegion_Clear(&region);
+	region.rect_cost = 0;
+	rect = Rect(100, 100, 2, 16);
+	LCUIRegion_AddRect(&region, &rect);
+	rect = Rect(104, 100, 8, 16);
+	LCUIRegion_AddRect(&region, &rect);
+	it_i("check merging without rect cost", region.length, 2);
+}
+
+static void test_region_overflow(void)
+{
+	int i;
+	LCUI_BOOL covered = TRUE;
+	LCUI_RegionRec region;
+	LCUI_Rect rects[LCUI_REGION_MAX_RECTS * 4];
+
+	LCUIRegion_Init(&region);
+	for (i = 0; i < LCUI_REGION_MAX_RECTS * 4; ++i) {
+		rects[i] = Rect(i * 97 % 1920, i * 61 % 1080, 4, 4);
+		LCUIRegion_AddRect(&region, &rects[i]);
+	}
+	it_b("check the number of rects is bounded",
+	     region.length <= LCUI_REGION_MAX_RECTS, TRUE);
+	for (i = 0; i < LCUI_REGION_MAX_RECTS * 4; ++i) {
+		if (!CheckRegionCoverRect(&region, &rects[i])) {
+			covered = FALSE;
+		}
+	}
+	it_b("check all added rects are covered", covered, TRUE);
+}
+
+static void test_region_union(void)
+{
+	LCUI_RegionRec a, b;
+	LCUI_Rect rect;
+
+	LCUIRegion_Init(&a);
+	LCUIRegion_Init(&b);
+	rect = Rect(0, 0, 100, 100);
+	LCUIRegion_AddRect(&a, &rect);
+	rect = Rect(50, 50, 100, 100);
+	LCUIRegion_AddRect(&b, &rect);
+	rect = Rect(500, 500, 100, 100);
+	LCUIRegion_AddRect(&b, &rect);
+	LCUIRegion_Union(&a, &b);
+	it_i("check union", a.length, 3);
+	it_i("check union area", (int)LCUIRegion_GetArea(&a), 30000);
+}
+
+void test_region(void)
+{
+	describe("check merging", test_region_merge);
+	describe("check merge cost", test_region_cost);
+	describe("check overflow", test_region_overflow);
+	describe("check union", test_region_union);
+}
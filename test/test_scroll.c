@@ -0,0 +1,309 @@
+#include <stdio.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/input.h>
+#include <LCUI/display.h>
+#include <LCUI/gui/widget.h>
+#include <LCUI/gui/widget/textview.h>
+#include <LCUI/gui/widget/scrollbar.h>
+#include <LCUI/gui/css_parser.h>
+#include <LCUI/headless.h>
+#include "test.h"
+#include "libtest.h"
+
+#define ROWS 200
+#define ROW_HEIGHT 31
+#define BOX_WIDTH 400
+#define BOX_HEIGHT 300
+
+static const char *css = "\
+.box {\
+  width: 400px;\
+  height: 300px;\
+}\
+.opaque {\
+  background-color: #fff;\
+}\
+.row {\
+  height: 30px;\
+  border-bottom: 1px solid #ccc;\
+}\
+.opaque .row {\
+  background-color: #e0f0ff;\
+}\
+.opaque .row.odd {\
+  background-color: #fff0e0;\
+}\
+.badge {\
+  top: 100px;\
+  left: 200px;\
+  width: 60px;\
+  height: 40px;\
+  position: absolute;\
+  background-color: rgba(255, 0, 0, 0.5);\
+}\
+.faded {\
+  opacity: 0.5;\
+}\
+.backdrop {\
+  top: 50px;\
+  left: 50px;\
+  width: 100px;\
+  height: 100px;\
+  z-index: -1;\
+  position: absolute;\
+  background-color: #0f0;\
+}";
+
+static struct {
+	LCUI_Widget box;
+	LCUI_Widget list;
+	LCUI_Widget scrollbar;
+	LCUI_Widget clicked;
+} self;
+
+static void OnClickRow(LCUI_Widget w, LCUI_WidgetEvent e, void *arg)
+{
+	self.clicked = w;
+}
+
+static void BuildList(LCUI_Widget parent, const char *box_class)
+{
+	int i;
+	wchar_t text[64];
+	LCUI_Widget row;
+
+	self.box = LCUIWidget_New(NULL);
+	self.list = LCUIWidget_New(NULL);
+	self.scrollbar = LCUIWidget_New("scrollbar");
+	Widget_AddClass(self.box, box_class);
+	for (i = 0; i < ROWS; ++i) {
+		row = LCUIWidget_New("textview");
+		Widget_AddClass(row, i % 2 ? "row odd" : "row");
+		swprintf(text, 64, L"Row %d", i);
+		TextView_SetTextW(row, text);
+		Widget_BindEvent(row, "click", OnClickRow, NULL, NULL);
+		Widget_Append(self.list, row);
+	}
+	Widget_Append(self.box, self.list);
+	Widget_Append(self.box, self.scrollbar);
+	Widget_Append(parent, self.box);
+	ScrollBar_BindTarget(self.scrollbar, self.list);
+}
+
+static LCUI_Widget AppendWidget(LCUI_Widget parent, const char *classes)
+{
+	LCUI_Widget w = LCUIWidget_New(NULL);
+
+	Widget_AddClass(w, classes);
+	Widget_Append(parent, w);
+	return w;
+}
+
+static void InitScrollTest(void)
+{
+	LCUIHeadless_Enable(TRUE);
+	LCUIHeadless_EnableVirtualClock(TRUE);
+	LCUI_Init();
+	LCUI_LoadCSSString(css, NULL);
+	self.clicked = NULL;
+}
+
+static void FreeScrollTest(void)
+{
+	LCUI_Destroy();
+	LCUIHeadless_EnableVirtualClock(FALSE);
+	LCUIHeadless_Enable(FALSE);
+}
+
+/** 滚动一帧，返回本帧绘制的面积 */
+static size_t ScrollBy(int distance)
+{
+	LCUI_RegionStatsRec stats;
+
+	ScrollBar_SetPosition(self.scrollbar,
+			      ScrollBar_GetPosition(self.scrollbar) + distance);
+	LCUIHeadless_AdvanceTime(16);
+	LCUI_RunFrame();
+	LCUIDisplay_GetRegionStats(&stats);
+	return stats.area;
+}
+
+/** 将当前画面与完整重绘的画面比较，返回不同的像素数量 */
+static size_t CompareWithRepaint(void)
+{
+	size_t i, n, count = 0;
+	LCUI_Graph frame, expected;
+
+	Graph_Init(&frame);
+	Graph_Init(&expected);
+	LCUIHeadless_GetFrame(&frame);
+	Widget_InvalidateArea(LCUIWidget_GetRoot(), NULL, SV_GRAPH_BOX);
+	LCUI_RunFrame();
+	LCUIHeadless_GetFrame(&expected);
+	n = frame.width * frame.height;
+	for (i = 0; i < n; ++i) {
+		if (frame.argb[i].value != expected.argb[i].value) {
+			++count;
+		}
+	}
+	Graph_Free(&frame);
+	Graph_Free(&expected);
+	return count;
+}
+
+static void test_scroll_blit(void)
+{
+	size_t i, area, errors = 0;
+	int steps[] = { 16, 16, 50, 7, -20, 300, -123, 1, 9999, -9999 };
+
+	InitScrollTest();
+	BuildList(LCUIWidget_GetRoot(), "box opaque");
+	AppendWidget(self.box, "badge");
+	LCUIHeadless_MouseMove(100, 100);
+	LCUI_RunFrame();
+	LCUI_RunFrame();
+
+	area = ScrollBy(16);
+	it_b("check scrolling only paints the exposed strip",
+	     area < BOX_WIDTH * BOX_HEIGHT / 4, TRUE);
+	errors += CompareWithRepaint();
+	for (i = 0; i < sizeof(steps) / sizeof(steps[0]); ++i) {
+		ScrollBy(steps[i]);
+		errors += CompareWithRepaint();
+	}
+	it_i("check the scrolled frames are the same as full repaints",
+	     (int)errors, 0);
+	it_i("check the layout of the target is not changed", (int)self.list->y,
+	     0);
+	FreeScrollTest();
+}
+
+static void test_scroll_fallback(void)
+{
+	size_t i, area, errors = 0;
+
+	InitScrollTest();
+	AppendWidget(LCUIWidget_GetRoot(), "backdrop");
+	BuildList(LCUIWidget_GetRoot(), "box");
+	LCUI_RunFrame();
+	LCUI_RunFrame();
+
+	area = ScrollBy(16);
+	it_b("check the viewport is repainted if the backdrop is not static",
+	     area >= (BOX_WIDTH - 14) * BOX_HEIGHT, TRUE);
+	errors += CompareWithRepaint();
+	for (i = 0; i < 4; ++i) {
+		ScrollBy(40);
+		errors += CompareWithRepaint();
+	}
+	it_i("check the repainted frames are correct", (int)errors, 0);
+	FreeScrollTest();
+
+	/* 不透明的背景会和半透明的祖先部件下面的内容混合 */
+	InitScrollTest();
+	AppendWidget(LCUIWidget_GetRoot(), "backdrop");
+	BuildList(AppendWidget(LCUIWidget_GetRoot(), "faded"), "box opaque");
+	LCUI_RunFrame();
+	LCUI_RunFrame();
+
+	errors = 0;
+	area = ScrollBy(16);
+	it_b("check the viewport is repainted if an ancestor is translucent",
+	     area >= (BOX_WIDTH - 14) * BOX_HEIGHT, TRUE);
+	errors += CompareWithRepaint();
+	for (i = 0; i < 4; ++i) {
+		ScrollBy(40);
+		errors += CompareWithRepaint();
+	}
+	it_i("check the frames under the translucent ancestor are correct",
+	     (int)errors, 0);
+	FreeScrollTest();
+}
+
+static void test_scroll_hit_test(void)
+{
+	float x, y;
+	LCUI_Widget row;
+
+	InitScrollTest();
+	BuildList(LCUIWidget_GetRoot(), "box opaque");
+	LCUI_RunFrame();
+	ScrollBy(ROW_HEIGHT * 3 + 2);
+
+	row = Widget_At(LCUIWidget_GetRoot(), 100, 10);
+	it_b("check the widget at the point is the scrolled row",
+	     row == Widget_GetChild(self.list, 3), TRUE);
+	Widget_GetOffset(Widget_GetChild(self.list, 3), NULL, &x, &y);
+	it_i("check the offset of the scrolled row", (int)y, -2);
+	LCUIHeadless_MouseMove(100, 40);
+	LCUIHeadless_MouseDown(LCUI_KEY_LEFTBUTTON);
+	LCUIHeadless_MouseUp(LCUI_KEY_LEFTBUTTON);
+	LCUI_RunFrame();
+	it_b("check clicking the scrolled row",
+	     self.clicked == Widget_GetChild(self.list, 4), TRUE);
+	FreeScrollTest();
+}
+
+static void PostTouchEvent(int y, int state)
+{
+	LCUI_SysEventRec ev;
+	LCUI_TouchPointRec point = { 0 };
+
+	point.x = 100;
+	point.y = y;
+	point.id = 1;
+	point.state = state;
+	point.is_primary = TRUE;
+	LCUI_CreateTouchEvent(&ev, &point, 1);
+	LCUI_PostEvent(&ev);
+	LCUI_DestroyEvent(&ev);
+}
+
+static void test_scroll_inertial(void)
+{
+	int i, pos, frames = 0;
+
+	InitScrollTest();
+	BuildList(LCUIWidget_GetRoot(), "box opaque");
+	LCUI_RunFrame();
+
+	PostTouchEvent(250, LCUI_TOUCHDOWN);
+	for (i = 1; i <= 10; ++i) {
+		LCUIHeadless_AdvanceTime(16);
+		LCUI_RunFrame();
+		PostTouchEvent(250 - i * 10, LCUI_TOUCHMOVE);
+	}
+	LCUIHeadless_AdvanceTime(16);
+	LCUI_RunFrame();
+	PostTouchEvent(150, LCUI_TOUCHUP);
+	LCUI_RunFrame();
+	pos = ScrollBar_GetPosition(self.scrollbar);
+	it_i("check the list is dragged", pos, 100);
+	for (i = 0; i < 120; ++i) {
+		LCUIHeadless_AdvanceTime(16);
+		LCUI_RunFrame();
+		if (ScrollBar_GetPosition(self.scrollbar) != pos) {
+			pos = ScrollBar_GetPosition(self.scrollbar);
+			frames += 1;
+		}
+	}
+	it_b("check the inertial scrolling moves the list every frame",
+	     frames > 10, TRUE);
+	it_b("check the inertial scrolling stops", frames < 120, TRUE);
+	it_i("check the inertial scrolling is painted correctly",
+	     (int)CompareWithRepaint(), 0);
+	FreeScrollTest();
+}
+
+void test_scroll(void)
+{
+	describe("check scrolling by moving the rendered pixels",
+		 test_scroll_blit);
+	describe("check scrolling with a non-static backdrop",
+		 test_scroll_fallback);
+	describe("check hit testing the scrolled content",
+		 test_scroll_hit_test);
+	describe("check the inertial scrolling", test_scroll_inertial);
+}
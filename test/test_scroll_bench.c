@@ -0,0 +1,177 @@
+#include <stdio.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/display.h>
+#include <LCUI/gui/widget.h>
+#include <LCUI/gui/widget/textview.h>
+#include <LCUI/gui/widget/scrollbar.h>
+#include <LCUI/gui/css_parser.h>
+#include <LCUI/headless.h>
+
+#define SCREEN_WIDTH 800
+#define SCREEN_HEIGHT 600
+#define ROWS 5000
+#define FRAMES 160
+#define FRAME_TIME 16
+#define TOUCH_MOVES 40
+#define TOUCH_STEP 12
+
+static const char *css = "\
+.box {\
+  width: 800px;\
+  height: 600px;\
+  background-color: #fff;\
+}\
+.row {\
+  height: 32px;\
+  padding: 4px;\
+  border-bottom: 1px solid #eee;\
+  background-color: #fafafa;\
+}";
+
+typedef struct BenchSceneRec_ {
+	const char *name;
+	void (*update)(int);
+
+	int64_t time;
+	size_t area;
+	int pos;
+	unsigned hash;
+} BenchSceneRec, *BenchScene;
+
+static LCUI_Widget scrollbar;
+
+static void BuildList(void)
+{
+	int i;
+	wchar_t text[64];
+	LCUI_Widget box, list, row;
+
+	box = LCUIWidget_New(NULL);
+	list = LCUIWidget_New(NULL);
+	scrollbar = LCUIWidget_New("scrollbar");
+	Widget_AddClass(box, "box");
+	for (i = 0; i < ROWS; ++i) {
+		row = LCUIWidget_New("textview");
+		Widget_AddClass(row, "row");
+		swprintf(text, 64, L"Row %d", i);
+		TextView_SetTextW(row, text);
+		Widget_Append(list, row);
+	}
+	Widget_Append(box, list);
+	Widget_Append(box, scrollbar);
+	Widget_Append(LCUIWidget_GetRoot(), box);
+	ScrollBar_BindTarget(scrollbar, list);
+}
+
+/** 每帧滚动一次鼠标滚轮 */
+static void ScrollByWheel(int frame)
+{
+	LCUIHeadless_MouseWheel(-1);
+}
+
+static void PostTouchEvent(int y, int state)
+{
+	LCUI_SysEventRec ev;
+	LCUI_TouchPointRec point = { 0 };
+
+	point.x = SCREEN_WIDTH / 2;
+	point.y = y;
+	point.id = 1;
+	point.state = state;
+	point.is_primary = TRUE;
+	LCUI_CreateTouchEvent(&ev, &point, 1);
+	LCUI_PostEvent(&ev);
+	LCUI_DestroyEvent(&ev);
+}
+
+/** 按住列表向上拖动，松开后让列表继续惯性滚动 */
+static void ScrollByTouch(int frame)
+{
+	int y = SCREEN_HEIGHT - 40;
+
+	if (frame == 1) {
+		PostTouchEvent(y, LCUI_TOUCHDOWN);
+	} else if (frame <= TOUCH_MOVES + 1) {
+		PostTouchEvent(y - (frame - 1) * TOUCH_STEP, LCUI_TOUCHMOVE);
+	} else if (frame == TOUCH_MOVES + 2) {
+		PostTouchEvent(y - TOUCH_MOVES * TOUCH_STEP, LCUI_TOUCHUP);
+	}
+}
+
+/** 计算画面的哈希值，用于确认滚动后的画面与完整重绘的一样 */
+static unsigned GetFrameHash(void)
+{
+	unsigned i, n, hash = 2166136261u;
+	LCUI_Graph frame;
+
+	Graph_Init(&frame);
+	if (LCUIHeadless_GetFrame(&frame) != 0) {
+		return 0;
+	}
+	n = frame.width * frame.height;
+	for (i = 0; i < n; ++i) {
+		hash = (hash ^ (unsigned)frame.argb[i].value) * 16777619u;
+	}
+	Graph_Free(&frame);
+	return hash;
+}
+
+static void RunBench(BenchScene scene)
+{
+	int i;
+	int64_t t;
+	LCUI_RegionStatsRec stats;
+
+	LCUIHeadless_Enable(TRUE);
+	LCUIHeadless_EnableVirtualClock(TRUE);
+	LCUI_Init();
+	LCUI_LoadCSSString(css, NULL);
+	LCUIDisplay_SetSize(SCREEN_WIDTH, SCREEN_HEIGHT);
+	BuildList();
+	LCUIHeadless_MouseMove(SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2);
+	/* 前几帧用于布局和预热缓存 */
+	for (i = 0; i < 3; ++i) {
+		LCUIHeadless_AdvanceTime(FRAME_TIME);
+		LCUI_RunFrame();
+	}
+	scene->area = 0;
+	t = LCUI_GetNanoTime();
+	for (i = 1; i <= FRAMES; ++i) {
+		LCUIHeadless_AdvanceTime(FRAME_TIME);
+		scene->update(i);
+		LCUI_RunFrame();
+		LCUIDisplay_GetRegionStats(&stats);
+		scene->area += stats.area;
+	}
+	scene->time = LCUI_GetNanoTime() - t;
+	scene->pos = ScrollBar_GetPosition(scrollbar);
+	scene->hash = GetFrameHash();
+	LCUI_Destroy();
+}
+
+int main(int argc, char **argv)
+{
+	size_t i, n;
+	char s_frame[32], s_area[32];
+	BenchSceneRec scenes[] = { { "wheel", ScrollByWheel },
+				   { "touch", ScrollByTouch } };
+
+	n = sizeof(scenes) / sizeof(scenes[0]);
+	for (i = 0; i < n; ++i) {
+		RunBench(&scenes[i]);
+	}
+	Logger_Info("%dx%d, %d rows, %d frames, %dms per frame on the virtual "
+		    "clock\n",
+		    SCREEN_WIDTH, SCREEN_HEIGHT, ROWS, FRAMES, FRAME_TIME);
+	Logger_Info("%-8s%-12s%-16s%-10s%s\n", "scene", "per frame",
+		    "painted/frame", "position", "hash");
+	for (i = 0; i < n; ++i) {
+		sprintf(s_frame, "%.3fms", scenes[i].time / 1000000.0 / FRAMES);
+		sprintf(s_area, "%lupx",
+			(unsigned long)(scenes[i].area / FRAMES));
+		Logger_Info("%-8s%-12s%-16s%-10d%08x\n", scenes[i].name,
+			    s_frame, s_area, scenes[i].pos, scenes[i].hash);
+	}
+	return 0;
+}
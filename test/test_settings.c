@@ -3,6 +3,7 @@
 #include <LCUI/settings.h>
 #include <LCUI/main.h>
 #include <LCUI/timer.h>
+#include <LCUI/display.h>
 #include "test.h"
 #include "libtest.h"
 
@@ -13,6 +14,12 @@ static void on_settings_change(LCUI_SysEvent object, void *data)
 	++settings_change_count;
 }
 
+/** 每隔 1 毫秒刷新屏幕，让主循环保持忙碌，空闲的主循环不会运行新的帧 */
+static void refresh_screen(void *arg)
+{
+	LCUIDisplay_InvalidateArea(NULL);
+}
+
 static void check_settings_frame_rate_cap(void *arg)
 {
 	char str[256];
@@ -90,6 +97,7 @@ void test_settings_frame_rate_cap(void)
 
 	settings.frame_rate_cap = 30;
 	LCUI_ApplySettings(&settings);
+	LCUI_SetInterval(1, refresh_screen, NULL);
 	LCUI_SetTimeout(1000, check_settings_frame_rate_cap,
 			&settings.frame_rate_cap);
 	LCUI_Main();
@@ -97,6 +105,7 @@ void test_settings_frame_rate_cap(void)
 	LCUI_Init();
 	settings.frame_rate_cap = 5;
 	LCUI_ApplySettings(&settings);
+	LCUI_SetInterval(1, refresh_screen, NULL);
 	LCUI_SetTimeout(1000, check_settings_frame_rate_cap,
 			&settings.frame_rate_cap);
 	LCUI_Main();
@@ -104,6 +113,7 @@ void test_settings_frame_rate_cap(void)
 	LCUI_Init();
 	settings.frame_rate_cap = 90;
 	LCUI_ApplySettings(&settings);
+	LCUI_SetInterval(1, refresh_screen, NULL);
 	LCUI_SetTimeout(1000, check_settings_frame_rate_cap,
 			&settings.frame_rate_cap);
 	LCUI_Main();
@@ -111,6 +121,7 @@ void test_settings_frame_rate_cap(void)
 	LCUI_Init();
 	settings.frame_rate_cap = 25;
 	LCUI_ApplySettings(&settings);
+	LCUI_SetInterval(1, refresh_screen, NULL);
 	LCUI_SetTimeout(1000, check_settings_frame_rate_cap,
 			&settings.frame_rate_cap);
 	LCUI_Main();
@@ -0,0 +1,77 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/gui/widget.h>
+#include <LCUI/gui/css_library.h>
+#include <LCUI/gui/css_parser.h>
+#include "test.h"
+#include "libtest.h"
+
+static void test_style_cache_invalidation(void)
+{
+	unsigned hash_a, hash_b;
+	LCUI_Widget root, a, b;
+	LCUI_CachedStyleSheet ss_a, ss_b;
+	LCUI_StyleCacheStatsRec stats, prev_stats;
+
+	LCUI_LoadCSSString(".cache-a { width: 10px; }"
+			   ".cache-b { width: 20px; }",
+			   NULL);
+	root = LCUIWidget_New(NULL);
+	a = LCUIWidget_New("textview");
+	b = LCUIWidget_New(NULL);
+	Widget_AddClass(a, "cache-a");
+	Widget_AddClass(b, "cache-b");
+	Widget_Append(root, a);
+	Widget_Append(root, b);
+	Widget_GetSelectorHash(a, &hash_a);
+	Widget_GetSelectorHash(b, &hash_b);
+
+	LCUI_GetStyleCacheStats(&prev_stats);
+	ss_a = Widget_GetCachedStyleSheet(a);
+	ss_b = Widget_GetCachedStyleSheet(b);
+	LCUI_GetStyleCacheStats(&stats);
+	it_i("check cache misses", (int)(stats.misses - prev_stats.misses), 2);
+	Widget_GetCachedStyleSheet(a);
+	LCUI_GetStyleCacheStats(&prev_stats);
+	it_i("check cache hits", (int)(prev_stats.hits - stats.hits), 1);
+
+	LCUI_LoadCSSString(".cache-c { width: 30px; }", NULL);
+	LCUI_GetStyleCacheStats(&stats);
+	it_i("check adding an unrelated rule",
+	     (int)(stats.invalidations - prev_stats.invalidations), 0);
+	it_b("check the cache of unrelated widgets is kept",
+	     LCUI_FindCachedStyleSheet(hash_a) == ss_a &&
+		 LCUI_FindCachedStyleSheet(hash_b) == ss_b,
+	     TRUE);
+
+	LCUI_LoadCSSString("textview.cache-a { height: 10px; }", NULL);
+	LCUI_GetStyleCacheStats(&prev_stats);
+	it_i("check adding a related rule",
+	     (int)(prev_stats.invalidations - stats.invalidations), 1);
+	it_b("check the cache of the related widget is removed",
+	     LCUI_FindCachedStyleSheet(hash_a) == NULL, TRUE);
+	it_b("check the cache of other widgets is kept",
+	     LCUI_FindCachedStyleSheet(hash_b) == ss_b, TRUE);
+	ss_a = Widget_GetCachedStyleSheet(a);
+	it_b("check the new rule is matched",
+	     ss_a->sheet[key_height].is_valid &&
+		 ss_a->sheet[key_width].is_valid,
+	     TRUE);
+
+	LCUI_LoadCSSString("* { min-width: 1px; }", NULL);
+	it_b("check adding a universal rule",
+	     LCUI_FindCachedStyleSheet(hash_a) == NULL &&
+		 LCUI_FindCachedStyleSheet(hash_b) == NULL,
+	     TRUE);
+	Widget_Destroy(root);
+}
+
+void test_style_cache(void)
+{
+	LCUI_Init();
+	describe("check style cache invalidation",
+		 test_style_cache_invalidation);
+	LCUI_Destroy();
+}
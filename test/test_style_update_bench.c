@@ -0,0 +1,153 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/gui/widget.h>
+#include <LCUI/gui/css_library.h>
+#include <LCUI/gui/css_parser.h>
+
+#define LISTS 100
+#define ITEMS 100
+#define FRAMES 10
+
+/*
+ * Count allocations by overriding the allocator of glibc, the functions in
+ * this program take precedence over the ones in the C library.
+ */
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__)
+#define COUNT_ALLOCATIONS
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+
+static size_t allocations = 0;
+
+void *malloc(size_t size)
+{
+	++allocations;
+	return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size)
+{
+	++allocations;
+	return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+	++allocations;
+	return __libc_realloc(ptr, size);
+}
+#else
+static size_t allocations = 0;
+#endif
+
+static const char *css = "\
+.list { padding: 4px; }\
+.list .item { height: 10px; color: #000; }\
+.list .item.active { color: #f00; background-color: #eee; }\
+.list .item:hover { background-color: #ddd; }";
+
+static LCUI_Widget items[LISTS * ITEMS];
+
+static LCUI_Widget BuildTree(void)
+{
+	int i, j;
+	LCUI_Widget root, list, item;
+
+	LCUI_LoadCSSString(css, NULL);
+	root = LCUIWidget_New(NULL);
+	for (i = 0; i < LISTS; ++i) {
+		list = LCUIWidget_New(NULL);
+		Widget_AddClass(list, "list");
+		for (j = 0; j < ITEMS; ++j) {
+			item = LCUIWidget_New("textview");
+			Widget_AddClass(item, "item");
+			Widget_Append(list, item);
+			items[i * ITEMS + j] = item;
+		}
+		Widget_Append(root, list);
+	}
+	Widget_Append(LCUIWidget_GetRoot(), root);
+	LCUIWidget_Update();
+	return root;
+}
+
+static void PrintResult(const char *name, int64_t t, size_t count)
+{
+	char s_time[32], s_count[32];
+
+	sprintf(s_time, "%.2fms", (double)t / FRAMES);
+#ifdef COUNT_ALLOCATIONS
+	sprintf(s_count, "%lu", (unsigned long)(count / FRAMES));
+#else
+	sprintf(s_count, "n/a");
+#endif
+	Logger_Info("%-26s%-12s%s\n", name, s_time, s_count);
+}
+
+static void BenchSelectorLookup(void)
+{
+	int i, j;
+	int64_t t;
+	size_t count;
+	LCUI_Selector s;
+
+	count = allocations;
+	t = LCUI_GetTime();
+	for (j = 0; j < FRAMES; ++j) {
+		for (i = 0; i < LISTS * ITEMS; ++i) {
+			s = Widget_GetSelector(items[i]);
+			LCUI_GetCachedStyleSheet(s);
+			Selector_Delete(s);
+		}
+	}
+	PrintResult("lookup by selector", LCUI_GetTimeDelta(t),
+		    allocations - count);
+
+	count = allocations;
+	t = LCUI_GetTime();
+	for (j = 0; j < FRAMES; ++j) {
+		for (i = 0; i < LISTS * ITEMS; ++i) {
+			Widget_GetCachedStyleSheet(items[i]);
+		}
+	}
+	PrintResult("lookup by selector hash", LCUI_GetTimeDelta(t),
+		    allocations - count);
+}
+
+static void BenchClassToggle(void)
+{
+	int i, j;
+	int64_t t;
+	size_t count;
+
+	count = allocations;
+	t = LCUI_GetTime();
+	for (j = 0; j < FRAMES; ++j) {
+		for (i = 0; i < LISTS * ITEMS; ++i) {
+			if (j % 2 == 0) {
+				Widget_AddClass(items[i], "active");
+			} else {
+				Widget_RemoveClass(items[i], "active");
+			}
+		}
+		LCUIWidget_Update();
+	}
+	PrintResult("toggle class and update", LCUI_GetTimeDelta(t),
+		    allocations - count);
+}
+
+int main(int argc, char **argv)
+{
+	LCUI_Init();
+	BuildTree();
+	Logger_Info("%d widgets, %d frames\n", LISTS * ITEMS, FRAMES);
+	Logger_Info("%-26s%-12s%s\n", "case", "per frame", "allocations");
+	BenchSelectorLookup();
+	BenchClassToggle();
+	LCUI_Destroy();
+	return 0;
+}
@@ -1,24 +1,230 @@
+#include <stdio.h>
 #include <wchar.h>
-#include <string.h>
 #include <LCUI_Build.h>
-#include <LCUI/util/logger.h>
-#include <LCUI/font/textlayer.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/font.h>
 #include "test.h"
+#include "libtest.h"
 
-static int test_textlayer_wordbreak(void)
+static LCUI_BOOL CheckText(LCUI_TextLayer layer, const wchar_t *text)
 {
+	wchar_t buf[256];
+
+	TextLayer_GetTextW(layer, 0, 255, buf);
+	return wcscmp(buf, text) == 0;
+}
+
+static void test_textlayer_edit(void)
+{
+	wchar_t buf[256];
+	LCUI_TextLayer layer;
+
+	layer = TextLayer_New();
+	TextLayer_SetMultiline(layer, TRUE);
+	TextLayer_SetTextW(layer, L"hello\nworld\nfoo", NULL);
+	it_i("check the number of rows", TextLayer_GetRowTotal(layer), 3);
+	it_i("check the length of the second row",
+	     TextLayer_GetRowTextLength(layer, 1), 5);
+	it_b("check the text", CheckText(layer, L"helloworldfoo"), TRUE);
+	TextLayer_GetTextW(layer, 7, 255, buf);
+	it_b("check getting the text from the middle of a row",
+	     wcscmp(buf, L"rldfoo") == 0, TRUE);
+	TextLayer_GetTextW(layer, 5, 4, buf);
+	it_b("check getting the text from the start of a row",
+	     wcscmp(buf, L"worl") == 0, TRUE);
+
+	TextLayer_SetCaretPos(layer, 1, 2);
+	TextLayer_InsertTextW(layer, L"--", NULL);
+	it_b("check inserting text into a row",
+	     CheckText(layer, L"hellowo--rldfoo"), TRUE);
+	TextLayer_SetCaretPos(layer, 1, 0);
+	TextLayer_InsertTextW(layer, L"ab\ncd", NULL);
+	it_i("check inserting a line break", TextLayer_GetRowTotal(layer), 4);
+	it_b("check the caret position after inserting",
+	     layer->insert_y == 2 && layer->insert_x == 2, TRUE);
+	it_i("check the length of the new row",
+	     TextLayer_GetRowTextLength(layer, 2), 9);
+
+	TextLayer_SetCaretPos(layer, 2, 0);
+	TextLayer_TextBackspace(layer, 1);
+	it_i("check removing a line break with backspace",
+	     TextLayer_GetRowTotal(layer), 3);
+	it_b("check the caret position after backspace",
+	     layer->insert_y == 1 && layer->insert_x == 2, TRUE);
+	it_b("check the text after backspace",
+	     CheckText(layer, L"helloabcdwo--rldfoo"), TRUE);
+
+	TextLayer_SetCaretPos(layer, 0, 3);
+	TextLayer_TextDelete(layer, 3);
+	it_i("check deleting text across rows", TextLayer_GetRowTotal(layer),
+	     2);
+	it_b("check the text after deleting",
+	     CheckText(layer, L"helabcdwo--rldfoo"), TRUE);
+	it_i("check the text length", (int)layer->length,
+	     (int)wcslen(L"helabcdwo--rld\nfoo"));
+	TextLayer_Destroy(layer);
+}
+
+static void test_textlayer_rows(void)
+{
+	int i;
+	wchar_t line[32];
+	LCUI_Pos pos;
+	LCUI_BOOL ok;
 	LCUI_TextLayer layer;
 
 	layer = TextLayer_New();
-	TextLayer_SetTextW(layer,
-			   L"hello, world! "
-			   L"long long long texttexttext, test word break",
-			   NULL);
-	TextLayer_SetFixedSize(layer, )
+	TextLayer_SetMultiline(layer, TRUE);
+	for (i = 0; i < 1000; ++i) {
+		swprintf(line, 32, L"line %d\n", i);
+		TextLayer_AppendTextW(layer, line, NULL);
+	}
+	TextLayer_Update(layer, NULL);
+	TextLayer_ClearInvalidRect(layer);
+	it_i("check the number of rows", TextLayer_GetRowTotal(layer), 1001);
+	for (ok = TRUE, i = 0; i < 1000; ++i) {
+		if (TextLayer_GetRowTextLength(layer, i) !=
+		    (int)wcslen(L"line ") + (i < 10 ? 1 : i < 100 ? 2 : 3)) {
+			ok = FALSE;
+			break;
+		}
+	}
+	it_b("check the length of each row", ok, TRUE);
+	TextLayer_GetCharPixelPos(layer, 500, 0, &pos);
+	it_i("check the pixel position of a row", pos.y,
+	     TextLayer_GetRowHeight(layer, 0) * 500);
+
+	TextLayer_SetCaretPos(layer, 500, 0);
+	TextLayer_TextBackspace(layer, 1);
+	TextLayer_SetCaretPos(layer, 998, 0);
+	TextLayer_TextDelete(layer, 100);
+	it_i("check the number of rows after editing",
+	     TextLayer_GetRowTotal(layer), 999);
+	it_i("check the length of a merged row",
+	     TextLayer_GetRowTextLength(layer, 499),
+	     (int)wcslen(L"line 499line 500"));
+	TextLayer_Destroy(layer);
+}
+
+static LCUI_TextLayer CreateWrappedTextLayer(const wchar_t *text)
+{
+	LCUI_TextLayer layer;
+
+	layer = TextLayer_New();
+	TextLayer_SetMultiline(layer, TRUE);
+	TextLayer_SetAutoWrap(layer, TRUE);
+	TextLayer_SetFixedSize(layer, 120, 0);
+	TextLayer_SetTextW(layer, text, NULL);
+	TextLayer_Update(layer, NULL);
+	TextLayer_ClearInvalidRect(layer);
+	return layer;
+}
+
+static LCUI_BOOL CompareTextRows(LCUI_TextLayer a, LCUI_TextLayer b)
+{
+	int i;
+
+	if (TextLayer_GetRowTotal(a) != TextLayer_GetRowTotal(b)) {
+		return FALSE;
+	}
+	for (i = 0; i < TextLayer_GetRowTotal(a); ++i) {
+		if (TextLayer_GetRowTextLength(a, i) !=
+		    TextLayer_GetRowTextLength(b, i)) {
+			return FALSE;
+		}
+	}
+	return TextLayer_GetWidth(a) == TextLayer_GetWidth(b) &&
+	       TextLayer_GetHeight(a) == TextLayer_GetHeight(b);
+}
+
+/** 获取段落的第一行的行号 */
+static int GetParagraphRow(LCUI_TextLayer layer, wchar_t lines[][128],
+			   int paragraph)
+{
+	int i, row, len;
+
+	for (len = 0, i = 0; i < paragraph; ++i) {
+		len += (int)wcslen(lines[i]);
+	}
+	for (row = 0; len > 0; ++row) {
+		len -= TextLayer_GetRowTextLength(layer, row);
+	}
+	return row;
+}
+
+static void JoinLines(wchar_t *text, wchar_t lines[][128], int n)
+{
+	int i;
+
+	for (text[0] = 0, i = 0; i < n; ++i) {
+		wcscat(text, lines[i]);
+		wcscat(text, L"\n");
+	}
+}
+
+static void test_textlayer_typeset(void)
+{
+	int i, row;
+	wchar_t text[4096];
+	wchar_t lines[20][128];
+	LCUI_Pos pos;
+	LCUI_TextLayer layer, expected;
+
+	for (i = 0; i < 20; ++i) {
+		swprintf(lines[i], 128, L"paragraph %d: the quick brown fox", i);
+	}
+	JoinLines(text, lines, 20);
+	layer = CreateWrappedTextLayer(text);
+	expected = CreateWrappedTextLayer(text);
+	it_b("check the rows of the wrapped text",
+	     TextLayer_GetRowTotal(layer) > 21, TRUE);
+
+	row = GetParagraphRow(layer, lines, 10);
+	TextLayer_SetCaretPos(layer, row, 1);
+	TextLayer_InsertTextW(layer, L"jumps over the lazy dog", NULL);
 	TextLayer_Update(layer, NULL);
+	swprintf(lines[10], 128, L"pjumps over the lazy dogaragraph 10: "
+				 L"the quick brown fox");
+	JoinLines(text, lines, 20);
+	TextLayer_Destroy(expected);
+	expected = CreateWrappedTextLayer(text);
+	it_b("check the rows after inserting text",
+	     CompareTextRows(layer, expected), TRUE);
+
+	TextLayer_SetCaretPos(layer, row, 12);
+	TextLayer_TextBackspace(layer, 10);
+	TextLayer_Update(layer, NULL);
+	wmemmove(lines[10] + 2, lines[10] + 12, wcslen(lines[10] + 12) + 1);
+	JoinLines(text, lines, 20);
+	TextLayer_Destroy(expected);
+	expected = CreateWrappedTextLayer(text);
+	it_b("check the rows after deleting text",
+	     CompareTextRows(layer, expected), TRUE);
+
+	TextLayer_SetFixedSize(layer, 200, 0);
+	TextLayer_SetFixedSize(expected, 200, 0);
+	TextLayer_Update(layer, NULL);
+	TextLayer_Update(expected, NULL);
+	it_b("check the rows after resizing",
+	     CompareTextRows(layer, expected), TRUE);
+
+	row = TextLayer_GetRowTotal(layer) - 3;
+	TextLayer_GetCharPixelPos(layer, row, 0, &pos);
+	TextLayer_SetCaretPosByPixelPos(layer, 0, pos.y + 1);
+	it_i("check the caret row at the pixel position", layer->insert_y,
+	     row);
+	TextLayer_SetCaretPosByPixelPos(layer, 0, TextLayer_GetHeight(layer));
+	it_i("check the caret row at the bottom", layer->insert_y,
+	     TextLayer_GetRowTotal(layer) - 1);
+	TextLayer_Destroy(expected);
+	TextLayer_Destroy(layer);
 }
 
-int test_textlayer(void)
+void test_textlayer(void)
 {
-	return test_textlayer_wordbreak();
+	LCUI_InitFontLibrary();
+	describe("check text editing", test_textlayer_edit);
+	describe("check text rows", test_textlayer_rows);
+	describe("check text typesetting", test_textlayer_typeset);
+	LCUI_FreeFontLibrary();
 }
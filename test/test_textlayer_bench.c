@@ -0,0 +1,182 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <wchar.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/font.h>
+
+#define LINES 100000
+#define LINES_PER_APPEND 1000
+#define EDITS 1000
+
+/*
+ * Count allocations by overriding the allocator of glibc, the functions in
+ * this program take precedence over the ones in the C library.
+ */
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__)
+#define COUNT_ALLOCATIONS
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+
+static size_t allocations = 0;
+
+void *malloc(size_t size)
+{
+	++allocations;
+	return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size)
+{
+	++allocations;
+	return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+	++allocations;
+	return __libc_realloc(ptr, size);
+}
+#else
+static size_t allocations = 0;
+#endif
+
+static void PrintResult(const char *name, int64_t t, size_t count)
+{
+	char s_time[32], s_count[32];
+
+	sprintf(s_time, "%ldms", (long)t);
+#ifdef COUNT_ALLOCATIONS
+	sprintf(s_count, "%lu", (unsigned long)count);
+#else
+	sprintf(s_count, "n/a");
+#endif
+	Logger_Info("%-26s%-12s%s\n", name, s_time, s_count);
+}
+
+static void BenchAppend(LCUI_TextLayer layer)
+{
+	int i, j;
+	int64_t t;
+	size_t count;
+	wchar_t *text, *p;
+
+	text = malloc(sizeof(wchar_t) * 64 * LINES_PER_APPEND);
+	count = allocations;
+	t = LCUI_GetTime();
+	for (i = 0; i < LINES; i += LINES_PER_APPEND) {
+		for (p = text, j = 0; j < LINES_PER_APPEND; ++j) {
+			p += swprintf(p, 64, L"%06d: the quick brown fox jumps "
+					     L"over the lazy dog\n", i + j);
+		}
+		TextLayer_AppendTextW(layer, text, NULL);
+		TextLayer_ClearInvalidRect(layer);
+	}
+	PrintResult("append lines", LCUI_GetTimeDelta(t),
+		    allocations - count);
+	free(text);
+}
+
+static void BenchEdit(LCUI_TextLayer layer)
+{
+	int i;
+	int64_t t;
+	size_t count;
+
+	srand(1024);
+	count = allocations;
+	t = LCUI_GetTime();
+	for (i = 0; i < EDITS; ++i) {
+		TextLayer_SetCaretPos(layer, rand() % LINES, rand() % 48);
+		TextLayer_InsertTextW(layer, L"inserted text", NULL);
+		TextLayer_ClearInvalidRect(layer);
+	}
+	PrintResult("insert text", LCUI_GetTimeDelta(t), allocations - count);
+
+	count = allocations;
+	t = LCUI_GetTime();
+	for (i = 0; i < EDITS; ++i) {
+		TextLayer_SetCaretPos(layer, rand() % LINES, rand() % 48);
+		TextLayer_InsertTextW(layer, L"new\nline", NULL);
+		TextLayer_ClearInvalidRect(layer);
+	}
+	PrintResult("insert line break", LCUI_GetTimeDelta(t),
+		    allocations - count);
+
+	count = allocations;
+	t = LCUI_GetTime();
+	for (i = 0; i < EDITS; ++i) {
+		TextLayer_SetCaretPos(layer, 1 + rand() % (LINES - 1), 0);
+		TextLayer_TextBackspace(layer, 4);
+		TextLayer_ClearInvalidRect(layer);
+	}
+	PrintResult("backspace", LCUI_GetTimeDelta(t), allocations - count);
+}
+
+static void BenchWrappedEdit(void)
+{
+	int i, y;
+	int64_t t;
+	size_t count;
+	wchar_t *text, *p;
+	LCUI_TextLayer layer;
+
+	layer = TextLayer_New();
+	TextLayer_SetMultiline(layer, TRUE);
+	TextLayer_SetAutoWrap(layer, TRUE);
+	TextLayer_SetFixedSize(layer, 160, 0);
+	text = malloc(sizeof(wchar_t) * 64 * LINES);
+	for (p = text, i = 0; i < LINES; ++i) {
+		p += swprintf(p, 64, L"%06d: the quick brown fox jumps "
+				     L"over the lazy dog\n", i);
+	}
+	count = allocations;
+	t = LCUI_GetTime();
+	TextLayer_SetTextW(layer, text, NULL);
+	TextLayer_Update(layer, NULL);
+	TextLayer_ClearInvalidRect(layer);
+	PrintResult("typeset wrapped lines", LCUI_GetTimeDelta(t),
+		    allocations - count);
+	free(text);
+
+	srand(2048);
+	count = allocations;
+	t = LCUI_GetTime();
+	for (i = 0; i < EDITS; ++i) {
+		TextLayer_SetCaretPos(layer, rand() % LINES, rand() % 16);
+		TextLayer_InsertTextW(layer, L"inserted text", NULL);
+		TextLayer_Update(layer, NULL);
+		TextLayer_ClearInvalidRect(layer);
+	}
+	PrintResult("wrapped insert + update", LCUI_GetTimeDelta(t),
+		    allocations - count);
+
+	count = allocations;
+	t = LCUI_GetTime();
+	for (i = 0; i < EDITS; ++i) {
+		y = rand() % TextLayer_GetHeight(layer);
+		TextLayer_SetCaretPosByPixelPos(layer, rand() % 160, y);
+	}
+	PrintResult("caret by pixel position", LCUI_GetTimeDelta(t),
+		    allocations - count);
+	TextLayer_Destroy(layer);
+}
+
+int main(int argc, char **argv)
+{
+	LCUI_TextLayer layer;
+
+	LCUI_InitFontLibrary();
+	layer = TextLayer_New();
+	TextLayer_SetMultiline(layer, TRUE);
+	Logger_Info("%d lines, %d edits\n", LINES, EDITS);
+	Logger_Info("%-26s%-12s%s\n", "case", "total", "allocations");
+	BenchAppend(layer);
+	BenchEdit(layer);
+	TextLayer_Destroy(layer);
+	BenchWrappedEdit();
+	LCUI_FreeFontLibrary();
+	return 0;
+}
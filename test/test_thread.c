@@ -62,6 +62,40 @@ static void TestWorker_Destroy(TestWorker worker)
 	LCUICond_Destroy(&worker->cond);
 }
 
+static char exit_funcs_order[8];
+
+static void OnThreadExit(void *arg)
+{
+	strcat(exit_funcs_order, arg);
+}
+
+static void AtExitThread(void *arg)
+{
+	LCUIThread_AtExit(OnThreadExit, "a");
+	LCUIThread_AtExit(OnThreadExit, "b");
+	if (arg) {
+		LCUIThread_Exit(NULL);
+	}
+}
+
+static void test_thread_at_exit(void)
+{
+	LCUI_Thread tid;
+
+	exit_funcs_order[0] = 0;
+	LCUIThread_Create(&tid, AtExitThread, NULL);
+	LCUIThread_Join(tid, NULL);
+	it_s("check exit functions are called in reverse order",
+	     exit_funcs_order, "ba");
+	exit_funcs_order[0] = 0;
+	LCUIThread_Create(&tid, AtExitThread, "exit");
+	LCUIThread_Join(tid, NULL);
+	it_s("check exit functions are called by LCUIThread_Exit()",
+	     exit_funcs_order, "ba");
+	it_i("check registering exit function on the main thread",
+	     LCUIThread_AtExit(OnThreadExit, "c"), -1);
+}
+
 void test_thread(void)
 {
 	TestWorkerRec worker;
@@ -84,4 +118,5 @@ void test_thread(void)
 	TestWorker_Destroy(&worker);
 	it_i("check worker data count", worker.data_count, 7);
 	it_b("check worker is no longer active", worker.active, FALSE);
+	test_thread_at_exit();
 }
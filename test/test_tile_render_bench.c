@@ -0,0 +1,121 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/graph.h>
+#include <LCUI/painter.h>
+#include <LCUI/gui/widget.h>
+#include <LCUI/gui/css_parser.h>
+
+#define SCREEN_WIDTH 1920
+#define SCREEN_HEIGHT 1080
+#define ROWS 24
+#define COLS 16
+#define FRAMES 10
+
+static const char *css = "\
+.card {\
+  width: 100px;\
+  height: 36px;\
+  margin: 4px;\
+  padding: 4px;\
+  display: inline-block;\
+  border: 1px solid #ccc;\
+  border-radius: 6px;\
+  background-color: rgba(255, 255, 255, 0.9);\
+  box-shadow: 0 2px 6px rgba(0, 0, 0, 0.3);\
+}\
+.card-header {\
+  height: 12px;\
+  border-radius: 4px;\
+  background-color: #3c8ce7;\
+}\
+.card-body {\
+  height: 12px;\
+  margin-top: 4px;\
+  opacity: 0.6;\
+  background-color: #00eaff;\
+}";
+
+static size_t RenderTile(LCUI_PaintContext paint, void *arg)
+{
+	Graph_FillRect(&paint->canvas, RGB(255, 255, 255), NULL, TRUE);
+	return Widget_Render(arg, paint);
+}
+
+static LCUI_Widget BuildTree(void)
+{
+	int i;
+	LCUI_Widget root, card, w;
+
+	LCUI_LoadCSSString(css, NULL);
+	root = LCUIWidget_New(NULL);
+	Widget_Resize(root, SCREEN_WIDTH, SCREEN_HEIGHT);
+	Widget_SetStyle(root, key_background_color, RGB(240, 240, 240), color);
+	for (i = 0; i < ROWS * COLS; ++i) {
+		card = LCUIWidget_New(NULL);
+		Widget_AddClass(card, "card");
+		w = LCUIWidget_New(NULL);
+		Widget_AddClass(w, "card-header");
+		Widget_Append(card, w);
+		w = LCUIWidget_New(NULL);
+		Widget_AddClass(w, "card-body");
+		Widget_Append(card, w);
+		Widget_Append(root, card);
+	}
+	Widget_Append(LCUIWidget_GetRoot(), root);
+	LCUIWidget_Update();
+	return root;
+}
+
+int main(int argc, char **argv)
+{
+	int i, j;
+	int threads[] = { 1, 2, 4, 8 };
+	int64_t t, base = 0;
+	size_t count = 0;
+	char s_total[32], s_frame[32];
+	LCUI_Graph canvas;
+	LCUI_RegionRec region;
+	LCUI_Widget root;
+	LCUI_TileRenderer renderer;
+	LCUI_Rect rect = { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT };
+
+	LCUI_Init();
+	root = BuildTree();
+	Graph_Init(&canvas);
+	canvas.color_type = LCUI_COLOR_TYPE_ARGB;
+	Graph_Create(&canvas, SCREEN_WIDTH, SCREEN_HEIGHT);
+	LCUIRegion_Init(&region);
+	LCUIRegion_AddRect(&region, &rect);
+	Logger_Info("render %d widgets at %dx%d, %d frames\n",
+		    ROWS * COLS * 3, SCREEN_WIDTH, SCREEN_HEIGHT, FRAMES);
+	Logger_Info("%-10s%-12s%-12s%s\n", "threads", "total", "per frame",
+		    "speedup");
+	for (i = 0; i < (int)(sizeof(threads) / sizeof(int)); ++i) {
+		renderer = TileRenderer_Create(threads[i]);
+		/* warm up caches */
+		TileRenderer_Render(renderer, &canvas, &region, RenderTile, root,
+				    NULL);
+		t = LCUI_GetTime();
+		for (j = 0; j < FRAMES; ++j) {
+			LCUIWidget_BeginFrame();
+			count = TileRenderer_Render(renderer, &canvas, &region,
+						    RenderTile, root, NULL);
+			LCUIWidget_EndFrame();
+		}
+		t = LCUI_GetTimeDelta(t);
+		if (i == 0) {
+			base = t;
+		}
+		sprintf(s_total, "%ldms", (long)t);
+		sprintf(s_frame, "%.1fms", (double)t / FRAMES);
+		Logger_Info("%-10d%-12s%-12s%.2fx\n", threads[i], s_total,
+			    s_frame, t > 0 ? (double)base / t : 0.0);
+		TileRenderer_Destroy(renderer);
+	}
+	Logger_Info("rendered widgets per frame: %lu\n", (unsigned long)count);
+	Graph_Free(&canvas);
+	LCUI_Destroy();
+	return 0;
+}
@@ -0,0 +1,290 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/graph.h>
+#include <LCUI/thread.h>
+#include <LCUI/painter.h>
+#include <LCUI/gui/widget.h>
+#include "test.h"
+#include "libtest.h"
+
+#define CANVAS_WIDTH 300
+#define CANVAS_HEIGHT 200
+
+static size_t FillTile(LCUI_PaintContext paint, void *arg)
+{
+	Graph_FillRect(&paint->canvas, RGB(255, 0, 0), NULL, TRUE);
+	return 1;
+}
+
+static size_t RenderTile(LCUI_PaintContext paint, void *arg)
+{
+	Graph_FillRect(&paint->canvas, RGB(255, 255, 255), NULL, TRUE);
+	return Widget_Render(arg, paint);
+}
+
+static LCUI_BOOL CheckTiles(LinkedList *tiles)
+{
+	LinkedListNode *node, *other;
+	LCUI_Rect *rect, overlay;
+
+	for (LinkedList_Each(node, tiles)) {
+		rect = node->data;
+		if (rect->x / LCUI_TILE_SIZE !=
+			(rect->x + rect->width - 1) / LCUI_TILE_SIZE ||
+		    rect->y / LCUI_TILE_SIZE !=
+			(rect->y + rect->height - 1) / LCUI_TILE_SIZE) {
+			return FALSE;
+		}
+		for (other = node->next; other; other = other->next) {
+			if (LCUIRect_GetOverlayRect(rect, other->data,
+						    &overlay)) {
+				return FALSE;
+			}
+		}
+	}
+	return TRUE;
+}
+
+static void test_tile_split(void)
+{
+	size_t count;
+	LCUI_Graph canvas;
+	LCUI_Color color;
+	LinkedList tiles;
+	LCUI_RegionRec region;
+	LCUI_Rect rect1 = { 10, 10, 50, 50 };
+	LCUI_Rect rect2 = { 100, 100, 400, 400 };
+	LCUI_TileRenderer renderer;
+
+	Graph_Init(&canvas);
+	canvas.color_type = LCUI_COLOR_TYPE_ARGB;
+	Graph_Create(&canvas, CANVAS_WIDTH, CANVAS_HEIGHT);
+	LinkedList_Init(&tiles);
+	LCUIRegion_Init(&region);
+	LCUIRegion_AddRect(&region, &rect1);
+	LCUIRegion_AddRect(&region, &rect2);
+	renderer = TileRenderer_Create(4);
+	it_i("check threads", TileRenderer_GetThreads(renderer), 4);
+	count = TileRenderer_Render(renderer, &canvas, &region, FillTile, NULL,
+				    &tiles);
+	/* rect1 is in tile (0, 0), rect2 covers tiles (0~2, 0~1) */
+	it_i("check tiles count", (int)tiles.length, 6);
+	it_i("check painted count", (int)count, 6);
+	it_b("check tiles are not overlapping", CheckTiles(&tiles), TRUE);
+	Graph_GetPixel(&canvas, 20, 20, color);
+	it_i("check the pixel in dirty rect", color.value, 0xffff0000);
+	Graph_GetPixel(&canvas, 150, 50, color);
+	it_i("check the pixel out of dirty rects", color.value, 0);
+	Graph_GetPixel(&canvas, 299, 199, color);
+	it_i("check the pixel in clipped dirty rect", color.value, 0xffff0000);
+	RectList_Clear(&tiles);
+	LCUIRegion_Clear(&region);
+	count = TileRenderer_Render(renderer, &canvas, &region, FillTile, NULL,
+				    &tiles);
+	it_i("check rendering without dirty rects", (int)count, 0);
+	TileRenderer_Destroy(renderer);
+	Graph_Free(&canvas);
+}
+
+static void test_tile_render_widget(void)
+{
+	int i;
+	LCUI_Widget root, w;
+	LCUI_Graph canvas, ref;
+	LCUI_RegionRec region;
+	LCUI_Rect rect = { 0, 0, CANVAS_WIDTH, CANVAS_HEIGHT };
+	LCUI_PaintContextRec paint;
+	LCUI_TileRenderer renderer;
+
+	root = LCUIWidget_New(NULL);
+	Widget_Resize(root, CANVAS_WIDTH, CANVAS_HEIGHT);
+	Widget_SetStyle(root, key_background_color, RGB(240, 240, 240), color);
+	for (i = 0; i < 20; ++i) {
+		w = LCUIWidget_New(NULL);
+		Widget_SetStyle(w, key_position, SV_ABSOLUTE, style);
+		Widget_Move(w, (float)(i * 13 % 260), (float)(i * 29 % 170));
+		Widget_Resize(w, 60, 40);
+		Widget_SetBorder(w, 1, SV_SOLID, RGB(0, 0, 0));
+		Widget_SetStyle(w, key_background_color,
+				ARGB(200, i * 10, 255 - i * 10, 128), color);
+		Widget_Append(root, w);
+	}
+	Widget_Append(LCUIWidget_GetRoot(), root);
+	LCUIWidget_Update();
+
+	Graph_Init(&ref);
+	Graph_Create(&ref, CANVAS_WIDTH, CANVAS_HEIGHT);
+	Graph_FillRect(&ref, RGB(255, 255, 255), NULL, FALSE);
+	paint.rect = rect;
+	paint.with_alpha = FALSE;
+	Graph_Quote(&paint.canvas, &ref, NULL);
+	Widget_Render(root, &paint);
+
+	Graph_Init(&canvas);
+	Graph_Create(&canvas, CANVAS_WIDTH, CANVAS_HEIGHT);
+	LCUIRegion_Init(&region);
+	LCUIRegion_AddRect(&region, &rect);
+	renderer = TileRenderer_Create(4);
+	TileRenderer_Render(renderer, &canvas, &region, RenderTile, root, NULL);
+	it_i("check tile rendering is same as direct rendering",
+	     memcmp(canvas.bytes, ref.bytes, canvas.mem_size), 0);
+	TileRenderer_Destroy(renderer);
+	Graph_Free(&canvas);
+	Graph_Free(&ref);
+	Widget_Destroy(root);
+}
+
+static void test_tile_render_indexed(void)
+{
+	int i;
+	size_t count, indexed_count;
+	LCUI_Widget root, group, w;
+	LCUI_Graph canvas, ref;
+	LCUI_RegionRec region;
+	LCUI_Rect rect = { 0, 0, CANVAS_WIDTH, CANVAS_HEIGHT };
+	LCUI_Rect corner = { 0, 0, 100, 80 };
+	LCUI_TileRenderer renderer;
+
+	root = LCUIWidget_New(NULL);
+	Widget_Resize(root, CANVAS_WIDTH, CANVAS_HEIGHT);
+	Widget_SetStyle(root, key_background_color, RGB(240, 240, 240), color);
+	/* a child covering many cells of the grid */
+	w = LCUIWidget_New(NULL);
+	Widget_SetStyle(w, key_position, SV_ABSOLUTE, style);
+	Widget_Move(w, -300, -300);
+	Widget_Resize(w, 900, 800);
+	Widget_SetStyle(w, key_background_color, ARGB(60, 0, 0, 255), color);
+	Widget_Append(root, w);
+	for (i = 0; i < 60; ++i) {
+		w = LCUIWidget_New(NULL);
+		Widget_SetStyle(w, key_position, SV_ABSOLUTE, style);
+		Widget_SetStyle(w, key_z_index, i % 3, int);
+		Widget_Move(w, (float)(i * 37 % 280), (float)(i * 23 % 180));
+		Widget_Resize(w, 30, 20);
+		Widget_SetBorder(w, 1, SV_SOLID, RGB(0, 0, 0));
+		Widget_SetStyle(w, key_background_color,
+				ARGB(200, i * 4, 255 - i * 4, 128), color);
+		Widget_Append(root, w);
+	}
+	/* a group far from the top left corner */
+	group = LCUIWidget_New(NULL);
+	Widget_SetStyle(group, key_position, SV_ABSOLUTE, style);
+	Widget_Move(group, 200, 120);
+	Widget_Resize(group, 80, 64);
+	for (i = 0; i < 40; ++i) {
+		w = LCUIWidget_New(NULL);
+		Widget_SetStyle(w, key_position, SV_ABSOLUTE, style);
+		Widget_Move(w, (float)(i % 8 * 10), (float)(i / 8 * 12));
+		Widget_Resize(w, 8, 10);
+		Widget_SetStyle(w, key_background_color,
+				ARGB(255, 255, i * 6, 0), color);
+		Widget_Append(group, w);
+	}
+	Widget_Append(root, group);
+	Widget_Append(LCUIWidget_GetRoot(), root);
+	LCUIWidget_Update();
+
+	Graph_Init(&ref);
+	Graph_Create(&ref, CANVAS_WIDTH, CANVAS_HEIGHT);
+	Graph_Init(&canvas);
+	Graph_Create(&canvas, CANVAS_WIDTH, CANVAS_HEIGHT);
+	LCUIRegion_Init(&region);
+	LCUIRegion_AddRect(&region, &rect);
+	renderer = TileRenderer_Create(4);
+	count = TileRenderer_Render(renderer, &ref, &region, RenderTile, root,
+				    NULL);
+	LCUIWidget_BeginFrame();
+	indexed_count = TileRenderer_Render(renderer, &canvas, &region,
+					    RenderTile, root, NULL);
+	it_b("check the children are indexed", root->render_index != NULL,
+	     TRUE);
+	it_b("check the children of the group are indexed",
+	     group->render_index != NULL, TRUE);
+	LCUIWidget_EndFrame();
+	it_b("check the index is freed", root->render_index == NULL, TRUE);
+	it_b("check the group index is freed", group->render_index == NULL,
+	     TRUE);
+	it_i("check the same widgets are rendered with the index",
+	     (int)indexed_count, (int)count);
+	it_i("check the tiles rendered with the index are same",
+	     memcmp(canvas.bytes, ref.bytes, canvas.mem_size), 0);
+
+	LCUIRegion_Clear(&region);
+	LCUIRegion_AddRect(&region, &corner);
+	LCUIWidget_BeginFrame();
+	TileRenderer_Render(renderer, &canvas, &region, RenderTile, root,
+			    NULL);
+	it_b("check the container entered by tiles is indexed",
+	     root->render_index != NULL, TRUE);
+	it_b("check the container not entered by tiles is not indexed",
+	     group->render_index == NULL, TRUE);
+	LCUIWidget_EndFrame();
+	TileRenderer_Destroy(renderer);
+	Graph_Free(&canvas);
+	Graph_Free(&ref);
+	Widget_Destroy(root);
+}
+
+static struct {
+	LCUI_Widget root;
+	LCUI_GraphPoolStatsRec stats;
+} render_thread;
+
+/** 在新的线程中渲染部件，并在线程退出前记录画布缓存池的状态 */
+static void RenderThread(void *arg)
+{
+	LCUI_Graph canvas;
+	LCUI_PaintContextRec paint;
+	LCUI_Rect rect = { 0, 0, CANVAS_WIDTH, CANVAS_HEIGHT };
+
+	Graph_Init(&canvas);
+	Graph_Create(&canvas, CANVAS_WIDTH, CANVAS_HEIGHT);
+	paint.rect = rect;
+	paint.with_alpha = FALSE;
+	Graph_Quote(&paint.canvas, &canvas, NULL);
+	Widget_Render(render_thread.root, &paint);
+	LCUIWidget_GetRendererStats(&render_thread.stats);
+	Graph_Free(&canvas);
+}
+
+static void test_tile_render_thread_exit(void)
+{
+	LCUI_Thread tid;
+	LCUI_Widget w;
+	LCUI_GraphPoolStatsRec stats, stats2;
+
+	render_thread.root = LCUIWidget_New(NULL);
+	Widget_Resize(render_thread.root, CANVAS_WIDTH, CANVAS_HEIGHT);
+	w = LCUIWidget_New(NULL);
+	Widget_Resize(w, 60, 40);
+	Widget_SetStyle(w, key_background_color, ARGB(200, 255, 0, 0), color);
+	Widget_SetOpacity(w, 0.5f);
+	Widget_Append(render_thread.root, w);
+	Widget_Append(LCUIWidget_GetRoot(), render_thread.root);
+	LCUIWidget_Update();
+
+	LCUIWidget_GetRendererStats(&stats);
+	LCUIThread_Create(&tid, RenderThread, NULL);
+	LCUIThread_Join(tid, NULL);
+	LCUIWidget_GetRendererStats(&stats2);
+	it_b("check the render thread caches canvases",
+	     render_thread.stats.cached_bytes > stats.cached_bytes, TRUE);
+	it_i("check the canvas pool is freed after the thread exits",
+	     (int)stats2.cached_bytes, (int)stats.cached_bytes);
+	Widget_Destroy(render_thread.root);
+}
+
+void test_tile_renderer(void)
+{
+	LCUI_Init();
+	describe("check tile split", test_tile_split);
+	describe("check tile rendering", test_tile_render_widget);
+	describe("check tile rendering with the children index",
+		 test_tile_render_indexed);
+	describe("check rendering in an exited thread",
+		 test_tile_render_thread_exit);
+	LCUI_Destroy();
+}
@@ -0,0 +1,137 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/timer.h>
+#include "test.h"
+#include "libtest.h"
+
+static struct {
+	int order[8];
+	int count;
+	int interval_id;
+	int interval_count;
+} self;
+
+static void OnTimeout(void *arg)
+{
+	self.order[self.count++] = *(int *)arg;
+}
+
+static void OnInterval(void *arg)
+{
+	self.interval_count += 1;
+	if (self.interval_count >= 3) {
+		LCUITimer_Free(self.interval_id);
+	}
+}
+
+/** 处理定时器，直到经过指定的时间 */
+static void WaitTimers(long int ms)
+{
+	int64_t t = LCUI_GetTime();
+
+	while (LCUI_GetTimeDelta(t) <= ms) {
+		LCUI_ProcessTimers();
+		LCUI_MSleep(1);
+	}
+	LCUI_ProcessTimers();
+}
+
+static void test_timer_order(void)
+{
+	int ids[4];
+	int values[4] = { 1, 2, 3, 4 };
+
+	self.count = 0;
+	/* 300ms 的定时器需要从第二层时间轮转移到第一层 */
+	ids[0] = LCUI_SetTimeout(300, OnTimeout, &values[3]);
+	ids[1] = LCUI_SetTimeout(40, OnTimeout, &values[1]);
+	ids[2] = LCUI_SetTimeout(10, OnTimeout, &values[0]);
+	ids[3] = LCUI_SetTimeout(80, OnTimeout, &values[2]);
+	it_b("check timer ids", ids[0] > 0 && ids[1] > 0 && ids[2] > 0 &&
+	     ids[3] > 0, TRUE);
+	WaitTimers(20);
+	it_i("check the first timer is fired", self.count, 1);
+	WaitTimers(320);
+	it_i("check all timers are fired", self.count, 4);
+	it_b("check the order of timers",
+	     self.order[0] == 1 && self.order[1] == 2 && self.order[2] == 3 &&
+		 self.order[3] == 4,
+	     TRUE);
+	it_i("check freeing a fired timer", LCUITimer_Free(ids[0]), -1);
+}
+
+static void test_timer_control(void)
+{
+	int a, b, c;
+	int values[3] = { 1, 2, 3 };
+
+	self.count = 0;
+	a = LCUI_SetTimeout(20, OnTimeout, &values[0]);
+	b = LCUI_SetTimeout(20, OnTimeout, &values[1]);
+	c = LCUI_SetTimeout(20, OnTimeout, &values[2]);
+	it_i("check freeing a timer", LCUITimer_Free(a), 0);
+	it_i("check pausing a timer", LCUITimer_Pause(b), 0);
+	it_i("check resetting a timer", LCUITimer_Reset(c, 60), 0);
+	WaitTimers(40);
+	it_i("check freed, paused and reset timers are not fired", self.count,
+	     0);
+	it_i("check continuing a timer", LCUITimer_Continue(b), 0);
+	WaitTimers(40);
+	it_b("check continued and reset timers are fired",
+	     self.count == 2 && self.order[0] + self.order[1] == 5, TRUE);
+	it_i("check freeing a timer which does not exist", LCUITimer_Free(a),
+	     -1);
+}
+
+static void test_timer_interval(void)
+{
+	self.interval_count = 0;
+	self.interval_id = LCUI_SetInterval(10, OnInterval, NULL);
+	WaitTimers(100);
+	it_i("check freeing an interval timer in its callback",
+	     self.interval_count, 3);
+}
+
+static void test_timer_next_delay(void)
+{
+	int ids[3];
+	int64_t delay;
+	int value = 0;
+
+	it_i("check the delay without timers", (int)LCUI_GetNextTimerDelay(),
+	     -1);
+	/* 三个定时器分别位于第三层、第二层和第一层时间轮中 */
+	ids[0] = LCUI_SetTimeout(70000, OnTimeout, &value);
+	ids[1] = LCUI_SetTimeout(300, OnTimeout, &value);
+	ids[2] = LCUI_SetTimeout(20, OnTimeout, &value);
+	delay = LCUI_GetNextTimerDelay();
+	it_b("check the delay of the first level", delay >= 19 && delay <= 20,
+	     TRUE);
+	LCUITimer_Free(ids[2]);
+	delay = LCUI_GetNextTimerDelay();
+	it_b("check the delay of the second level",
+	     delay >= 299 && delay <= 300, TRUE);
+	WaitTimers(100);
+	delay = LCUI_GetNextTimerDelay();
+	it_b("check the delay after processing timers",
+	     delay >= 150 && delay <= 200, TRUE);
+	LCUITimer_Free(ids[1]);
+	delay = LCUI_GetNextTimerDelay();
+	it_b("check the delay of the third level",
+	     delay >= 69000 && delay <= 69900, TRUE);
+	LCUITimer_Free(ids[0]);
+	it_i("check the delay after freeing all timers",
+	     (int)LCUI_GetNextTimerDelay(), -1);
+}
+
+void test_timer(void)
+{
+	LCUI_InitTimer();
+	describe("check order", test_timer_order);
+	describe("check control", test_timer_control);
+	describe("check interval", test_timer_interval);
+	describe("check next delay", test_timer_next_delay);
+	LCUI_FreeTimer();
+}
@@ -0,0 +1,73 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/timer.h>
+
+#define TIMERS 100000
+
+static int ids[TIMERS];
+static size_t fired = 0;
+
+static void OnTimeout(void *arg)
+{
+	++fired;
+}
+
+static void PrintResult(const char *name, int64_t t)
+{
+	char s_time[32], s_each[32];
+
+	sprintf(s_time, "%ldms", (long)t);
+	sprintf(s_each, "%.1fns", (double)t * 1000000.0 / TIMERS);
+	Logger_Info("%-26s%-12s%s\n", name, s_time, s_each);
+}
+
+static void BenchSetAndFree(void)
+{
+	int i;
+	int64_t t;
+
+	t = LCUI_GetTime();
+	for (i = 0; i < TIMERS; ++i) {
+		ids[i] = LCUI_SetTimeout(1000 + i % 60000, OnTimeout, NULL);
+	}
+	PrintResult("set", LCUI_GetTimeDelta(t));
+	t = LCUI_GetTime();
+	for (i = 0; i < TIMERS; ++i) {
+		LCUITimer_Reset(ids[i], 2000 + i % 60000);
+	}
+	PrintResult("reset", LCUI_GetTimeDelta(t));
+	t = LCUI_GetTime();
+	for (i = TIMERS - 1; i >= 0; --i) {
+		LCUITimer_Free(ids[i]);
+	}
+	PrintResult("free", LCUI_GetTimeDelta(t));
+}
+
+static void BenchFire(void)
+{
+	int i;
+	int64_t t;
+
+	fired = 0;
+	t = LCUI_GetTime();
+	for (i = 0; i < TIMERS; ++i) {
+		LCUI_SetTimeout(i % 50, OnTimeout, NULL);
+	}
+	while (fired < TIMERS) {
+		LCUI_ProcessTimers();
+	}
+	PrintResult("set and fire", LCUI_GetTimeDelta(t));
+}
+
+int main(int argc, char **argv)
+{
+	LCUI_InitTimer();
+	Logger_Info("%d timers\n", TIMERS);
+	Logger_Info("%-26s%-12s%s\n", "case", "total", "per timer");
+	BenchSetAndFree();
+	BenchFire();
+	LCUI_FreeTimer();
+	return 0;
+}
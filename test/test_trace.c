@@ -0,0 +1,226 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/thread.h>
+#include "test.h"
+#include "libtest.h"
+
+#define TRACE_FILE "test_trace.json"
+
+static void TraceThread(void *arg)
+{
+	LCUITrace_SetThreadName("test thread");
+	LCUITrace_Begin("test thread task");
+	LCUI_MSleep(1);
+	LCUITrace_End();
+	LCUIThread_Exit(NULL);
+}
+
+static char *ReadTraceFile(void)
+{
+	long size;
+	char *data;
+	FILE *fp;
+
+	fp = fopen(TRACE_FILE, "rb");
+	if (!fp) {
+		return NULL;
+	}
+	fseek(fp, 0, SEEK_END);
+	size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	data = malloc(size + 1);
+	if (data) {
+		data[fread(data, 1, size, fp)] = 0;
+	}
+	fclose(fp);
+	remove(TRACE_FILE);
+	return data;
+}
+
+/** 导出记录并读取 */
+static char *WriteTrace(void)
+{
+	if (LCUITrace_WriteFile(TRACE_FILE) != 0) {
+		return NULL;
+	}
+	return ReadTraceFile();
+}
+
+static int CountEvents(const char *json, const char *name)
+{
+	int count = 0;
+	char str[256];
+	const char *p = json;
+
+	sprintf(str, "{\"name\":\"%s\",", name);
+	while ((p = strstr(p, str))) {
+		count += 1;
+		p += strlen(str);
+	}
+	return count;
+}
+
+/** 获取时间段的持续时间，单位为微秒 */
+static double GetEventDuration(const char *json, const char *name)
+{
+	char str[256];
+	const char *p;
+
+	sprintf(str, "{\"name\":\"%s\",", name);
+	p = strstr(json, str);
+	if (!p) {
+		return -1;
+	}
+	p = strstr(p, "\"dur\":");
+	if (!p) {
+		return -1;
+	}
+	return strtod(p + 6, NULL);
+}
+
+static void test_trace_record(void)
+{
+	int64_t t;
+	char *json;
+	LCUI_Thread thread;
+
+	t = LCUI_GetNanoTime();
+	it_b("check the nano time is monotonic", LCUI_GetNanoTime() >= t,
+	     TRUE);
+
+	LCUITrace_Begin("test disabled");
+	LCUITrace_End();
+	LCUITrace_Enable(TRUE);
+	LCUITrace_Clear();
+	it_b("check tracing is enabled", LCUITrace_IsEnabled(), TRUE);
+	LCUITrace_Begin("test outer");
+	LCUITrace_Begin("test inner");
+	LCUI_MSleep(2);
+	LCUITrace_End();
+	LCUITrace_End();
+	LCUIThread_Create(&thread, TraceThread, NULL);
+	LCUIThread_Join(thread, NULL);
+	LCUITrace_Begin("test unfinished");
+	LCUITrace_Enable(FALSE);
+	LCUITrace_End();
+	LCUITrace_Begin("test after disabled");
+	LCUITrace_End();
+
+	json = WriteTrace();
+	it_b("check the trace file is written", json != NULL, TRUE);
+	if (!json) {
+		return;
+	}
+	it_b("check the trace file is a trace event list",
+	     strncmp(json, "{\"traceEvents\":[", 16) == 0, TRUE);
+	it_i("check the outer scope is recorded",
+	     CountEvents(json, "test outer"), 1);
+	it_i("check the inner scope is recorded",
+	     CountEvents(json, "test inner"), 1);
+	it_b("check the duration of the inner scope",
+	     GetEventDuration(json, "test inner") >= 2000, TRUE);
+	it_b("check the outer scope contains the inner scope",
+	     GetEventDuration(json, "test outer") >=
+		 GetEventDuration(json, "test inner"),
+	     TRUE);
+	it_i("check the scope of another thread is recorded",
+	     CountEvents(json, "test thread task"), 1);
+	it_b("check the thread name is recorded",
+	     strstr(json, "\"args\":{\"name\":\"test thread\"}") != NULL, TRUE);
+	it_i("check scopes are not recorded before enabling",
+	     CountEvents(json, "test disabled"), 0);
+	it_i("check scopes are not recorded after disabling",
+	     CountEvents(json, "test unfinished") +
+		 CountEvents(json, "test after disabled"),
+	     0);
+	free(json);
+}
+
+static void test_trace_ring_buffer(void)
+{
+	int i;
+	char *json;
+
+	LCUITrace_Clear();
+	LCUITrace_Enable(TRUE);
+	for (i = 0; i < 20000; ++i) {
+		LCUITrace_Begin(i < 10000 ? "test old" : "test new");
+		LCUITrace_End();
+	}
+	LCUITrace_Enable(FALSE);
+	json = WriteTrace();
+	it_b("check the trace file is written", json != NULL, TRUE);
+	if (!json) {
+		return;
+	}
+	it_i("check the oldest events are overwritten",
+	     CountEvents(json, "test old"), 0);
+	it_b("check the latest events are kept",
+	     CountEvents(json, "test new") > 0, TRUE);
+	free(json);
+}
+
+static void test_trace_frame(void)
+{
+	char *json;
+
+	LCUI_Init();
+	LCUITrace_Clear();
+	LCUITrace_Enable(TRUE);
+	LCUI_RunFrame();
+	LCUITrace_Enable(FALSE);
+	json = WriteTrace();
+	LCUI_Destroy();
+	it_b("check the trace file is written", json != NULL, TRUE);
+	if (!json) {
+		return;
+	}
+	it_i("check the frame is recorded", CountEvents(json, "frame"), 1);
+	it_i("check the timers phase is recorded", CountEvents(json, "timers"),
+	     1);
+	it_i("check the events phase is recorded", CountEvents(json, "events"),
+	     1);
+	it_i("check the widgets phase is recorded",
+	     CountEvents(json, "widgets"), 1);
+	it_i("check the render phase is recorded", CountEvents(json, "render"),
+	     1);
+	it_i("check the present phase is recorded",
+	     CountEvents(json, "present"), 1);
+	it_b("check the main thread name is recorded",
+	     strstr(json, "\"args\":{\"name\":\"main\"}") != NULL, TRUE);
+	free(json);
+
+	json = WriteTrace();
+	it_b("check the trace file is written", json != NULL, TRUE);
+	if (!json) {
+		return;
+	}
+	it_i("check the records are freed by LCUI_Destroy",
+	     CountEvents(json, "frame"), 0);
+	free(json);
+
+	/* the buffers of running threads are recreated after freeing */
+	LCUITrace_Enable(TRUE);
+	LCUITrace_Begin("test after freeing");
+	LCUITrace_End();
+	LCUITrace_Enable(FALSE);
+	json = WriteTrace();
+	it_b("check the trace file is written", json != NULL, TRUE);
+	if (!json) {
+		return;
+	}
+	it_i("check scopes are recorded after freeing",
+	     CountEvents(json, "test after freeing"), 1);
+	free(json);
+	LCUITrace_Free();
+}
+
+void test_trace(void)
+{
+	describe("check recording scopes", test_trace_record);
+	describe("check the ring buffer", test_trace_ring_buffer);
+	describe("check recording frames", test_trace_frame);
+}
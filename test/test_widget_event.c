@@ -1,7 +1,9 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <LCUI_Build.h>
 #include <LCUI/LCUI.h>
 #include <LCUI/input.h>
+#include <LCUI/thread.h>
 #include <LCUI/gui/widget.h>
 #include "test.h"
 #include "libtest.h"
@@ -104,7 +106,109 @@ void test_widget_mouse_event(void)
 	LCUI_Destroy();
 }
 
+#define POSTED_EVENTS 2000
+
+static struct {
+	int count;
+	int errors;
+	int freed;
+	LCUI_Widget target;
+} posted;
+
+static void OnPostedEvent(LCUI_Widget w, LCUI_WidgetEvent e, void *arg)
+{
+	if (*(int *)arg != posted.count) {
+		posted.errors += 1;
+	}
+	posted.count += 1;
+}
+
+static void OnFreeData(void *arg)
+{
+	posted.freed += 1;
+	free(arg);
+}
+
+static void PostEvents(LCUI_Widget w, int start, int count)
+{
+	int i, *data;
+	LCUI_WidgetEventRec e;
+
+	for (i = start; i < start + count; ++i) {
+		LCUI_InitWidgetEvent(&e, "posted");
+		data = malloc(sizeof(int));
+		*data = i;
+		Widget_PostEvent(w, &e, data, OnFreeData);
+	}
+}
+
+static void PostEventsThread(void *arg)
+{
+	PostEvents(posted.target, 0, POSTED_EVENTS);
+	LCUIThread_Exit(NULL);
+}
+
+void test_widget_posted_event(void)
+{
+	LCUI_Thread tid;
+	LCUI_Widget w;
+	LCUI_WidgetEventQueueStatsRec stats;
+
+	LCUI_Init();
+	w = LCUIWidget_New(NULL);
+	Widget_Append(LCUIWidget_GetRoot(), w);
+	Widget_BindEvent(w, "posted", OnPostedEvent, NULL, NULL);
+
+	posted.count = 0;
+	posted.errors = 0;
+	posted.freed = 0;
+	PostEvents(w, 0, POSTED_EVENTS);
+	LCUI_ProcessEvents();
+	LCUIWidget_GetEventQueueStats(&stats);
+	it_i("check the number of processed events", posted.count,
+	     POSTED_EVENTS);
+	it_i("check the events are processed in order", posted.errors, 0);
+	it_i("check the event data are destroyed", posted.freed,
+	     POSTED_EVENTS);
+	it_b("check the overflowed events are allocated from the heap",
+	     stats.allocated > 0 && stats.allocated < POSTED_EVENTS, TRUE);
+
+	posted.count = 0;
+	posted.freed = 0;
+	posted.target = w;
+	LCUIThread_Create(&tid, PostEventsThread, NULL);
+	LCUIThread_Join(tid, NULL);
+	LCUI_ProcessEvents();
+	LCUIWidget_GetEventQueueStats(&stats);
+	it_i("check the events posted by other thread are processed",
+	     posted.count, POSTED_EVENTS);
+	it_i("check the events posted by other thread are in order",
+	     posted.errors, 0);
+	it_i("check the number of events posted by other thread",
+	     (int)stats.remote_posted, POSTED_EVENTS);
+
+	posted.count = 0;
+	posted.freed = 0;
+	PostEvents(w, 0, POSTED_EVENTS);
+	Widget_Destroy(w);
+	LCUIWidget_Update();
+	LCUI_ProcessEvents();
+	it_i("check the events of the destroyed widget are not processed",
+	     posted.count, 0);
+	it_i("check the event data of the destroyed widget are destroyed",
+	     posted.freed, POSTED_EVENTS);
+
+	w = LCUIWidget_New(NULL);
+	Widget_Append(LCUIWidget_GetRoot(), w);
+	posted.freed = 0;
+	PostEvents(w, 0, POSTED_EVENTS);
+	LCUI_Destroy();
+	it_i("check the pending events are destroyed when exiting",
+	     posted.freed, POSTED_EVENTS);
+}
+
 void test_widget_event(void)
 {
 	describe("test widget mouse event", test_widget_mouse_event);
+	describe("test widget posted event", test_widget_posted_event);
 }
@@ -0,0 +1,97 @@
+#include <stdio.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/gui/widget.h>
+
+#define EVENTS 1000000
+#define DEPTH 4
+
+typedef struct BenchResultRec_ {
+	const char *name;
+	int batch;
+	int64_t time;
+	size_t handled;
+	LCUI_WidgetEventQueueStatsRec stats;
+} BenchResultRec, *BenchResult;
+
+static size_t handled;
+
+static void OnEvent(LCUI_Widget w, LCUI_WidgetEvent e, void *arg)
+{
+	handled += 1;
+}
+
+/** 创建几层嵌套的部件，让事件冒泡到每一层父级部件 */
+static LCUI_Widget BuildTree(void)
+{
+	int i;
+	LCUI_Widget w, parent = LCUIWidget_GetRoot();
+
+	for (i = 0; i < DEPTH; ++i) {
+		w = LCUIWidget_New(NULL);
+		Widget_BindEvent(w, "bench", OnEvent, NULL, NULL);
+		Widget_Append(parent, w);
+		parent = w;
+	}
+	return parent;
+}
+
+/** 每投递 batch 个事件就处理一次，模拟一帧内投递的事件数量 */
+static void RunBench(BenchResult result)
+{
+	int i;
+	int64_t t;
+	LCUI_Widget target;
+	LCUI_WidgetEventRec e;
+	LCUI_WidgetEventQueueStatsRec stats;
+
+	LCUI_Init();
+	target = BuildTree();
+	LCUI_InitWidgetEvent(&e, "bench");
+	LCUIWidget_GetEventQueueStats(&stats);
+	handled = 0;
+	t = LCUI_GetNanoTime();
+	for (i = 1; i <= EVENTS; ++i) {
+		e.target = NULL;
+		Widget_PostEvent(target, &e, NULL, NULL);
+		if (i % result->batch == 0) {
+			LCUI_ProcessEvents();
+		}
+	}
+	LCUI_ProcessEvents();
+	result->time = LCUI_GetNanoTime() - t;
+	result->handled = handled;
+	LCUIWidget_GetEventQueueStats(&result->stats);
+	result->stats.posted -= stats.posted;
+	result->stats.allocated -= stats.allocated;
+	LCUI_Destroy();
+}
+
+int main(int argc, char **argv)
+{
+	size_t i, n;
+	char s_time[32], s_rate[32];
+	BenchResultRec warmup = { "warmup", 64 };
+	BenchResultRec results[] = { { "frame", 64 },
+				     { "burst", 10000 },
+				     { "flood", EVENTS } };
+
+	n = sizeof(results) / sizeof(results[0]);
+	RunBench(&warmup);
+	for (i = 0; i < n; ++i) {
+		RunBench(&results[i]);
+	}
+	Logger_Info("%d posted events, %d levels of bubbling\n", EVENTS,
+		    DEPTH);
+	Logger_Info("%-8s%-10s%-12s%-14s%-10s%s\n", "mode", "batch",
+		    "per event", "events/s", "handled", "heap packs");
+	for (i = 0; i < n; ++i) {
+		sprintf(s_time, "%.1fns", 1.0 * results[i].time / EVENTS);
+		sprintf(s_rate, "%.2fM", EVENTS * 1e3 / results[i].time);
+		Logger_Info("%-8s%-10d%-12s%-14s%-10lu%lu\n", results[i].name,
+			    results[i].batch, s_time, s_rate,
+			    (unsigned long)results[i].handled,
+			    (unsigned long)results[i].stats.allocated);
+	}
+	return 0;
+}
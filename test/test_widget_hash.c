@@ -0,0 +1,97 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/gui/widget.h>
+#include <LCUI/gui/css_library.h>
+#include <LCUI/gui/css_parser.h>
+#include "test.h"
+#include "libtest.h"
+
+static LCUI_BOOL CheckSelectorHash(LCUI_Widget w)
+{
+	unsigned hash;
+	LCUI_BOOL ret;
+	LCUI_Selector s;
+
+	if (Widget_GetSelectorHash(w, &hash) != 0) {
+		return FALSE;
+	}
+	s = Widget_GetSelector(w);
+	ret = s->hash == hash;
+	Selector_Delete(s);
+	return ret;
+}
+
+static void test_widget_selector_hash(void)
+{
+	LCUI_Widget root, parent, child, other;
+
+	root = LCUIWidget_New(NULL);
+	parent = LCUIWidget_New("textview");
+	child = LCUIWidget_New(NULL);
+	other = LCUIWidget_New("button");
+	Widget_Append(root, parent);
+	Widget_Append(parent, child);
+	Widget_Append(root, other);
+	Widget_AddClass(child, "item");
+	it_b("check the hash of a widget", CheckSelectorHash(child), TRUE);
+
+	Widget_AddClass(child, "item-title item-active");
+	Widget_AddClass(child, "active");
+	it_b("check the hash of unsorted classes", CheckSelectorHash(child),
+	     TRUE);
+
+	Widget_RemoveClass(child, "item-title");
+	it_b("check the hash after removing a class",
+	     CheckSelectorHash(child), TRUE);
+
+	Widget_AddStatus(child, "hover");
+	Widget_AddStatus(child, "active");
+	it_b("check the hash of status", CheckSelectorHash(child), TRUE);
+
+	Widget_SetId(parent, "list");
+	Widget_AddClass(parent, "list");
+	it_b("check the hash after changing the parent id",
+	     CheckSelectorHash(child), TRUE);
+
+	Widget_Append(other, child);
+	it_b("check the hash after changing the parent",
+	     CheckSelectorHash(child), TRUE);
+
+	Widget_DestroyId(parent);
+	Widget_RemoveStatus(child, "hover");
+	Widget_RemoveStatus(child, "active");
+	it_b("check the hash after removing status and id",
+	     CheckSelectorHash(child) && CheckSelectorHash(parent), TRUE);
+	Widget_Destroy(root);
+}
+
+static void test_widget_cached_style(void)
+{
+	LCUI_Selector s;
+	LCUI_Widget root, w;
+
+	LCUI_LoadCSSString(".hash-test .hash-item { width: 10px; }", NULL);
+	root = LCUIWidget_New(NULL);
+	w = LCUIWidget_New(NULL);
+	Widget_AddClass(root, "hash-test");
+	Widget_AddClass(w, "hash-item");
+	Widget_Append(root, w);
+	s = Widget_GetSelector(w);
+	it_b("check the cached style sheet",
+	     Widget_GetCachedStyleSheet(w) == LCUI_GetCachedStyleSheet(s),
+	     TRUE);
+	Selector_Delete(s);
+	it_b("check the matched style",
+	     Widget_GetCachedStyleSheet(w)->sheet[key_width].is_valid, TRUE);
+	Widget_Destroy(root);
+}
+
+void test_widget_hash(void)
+{
+	LCUI_Init();
+	describe("check selector hash", test_widget_selector_hash);
+	describe("check cached style sheet", test_widget_cached_style);
+	LCUI_Destroy();
+}
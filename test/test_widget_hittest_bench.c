@@ -0,0 +1,156 @@
+#include <stdio.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/input.h>
+#include <LCUI/gui/widget.h>
+
+#define COLS 100
+#define ROWS 100
+#define CELL_WIDTH 24
+#define CELL_HEIGHT 16
+#define SWEEPS 5
+#define STEP 3
+
+typedef struct BenchResultRec_ {
+	const char *name;
+	int64_t build_time;
+	int64_t hit_time;
+	int64_t event_time;
+	int64_t move_time;
+	size_t hits;
+	size_t events;
+	unsigned hash;
+} BenchResultRec, *BenchResult;
+
+static LCUI_Widget BuildGrid(LCUI_BOOL index_children)
+{
+	int x, y;
+	LCUI_Widget grid, cell;
+	LCUI_WidgetRulesRec rules = { 0 };
+
+	grid = LCUIWidget_New(NULL);
+	Widget_SetPosition(grid, SV_ABSOLUTE);
+	Widget_Move(grid, 0, 0);
+	Widget_Resize(grid, COLS * CELL_WIDTH, ROWS * CELL_HEIGHT);
+	if (index_children) {
+		rules.index_children = TRUE;
+		Widget_SetRules(grid, &rules);
+	}
+	for (y = 0; y < ROWS; ++y) {
+		for (x = 0; x < COLS; ++x) {
+			cell = LCUIWidget_New(NULL);
+			Widget_SetPosition(cell, SV_ABSOLUTE);
+			Widget_Move(cell, x * CELL_WIDTH + 1.0f,
+				    y * CELL_HEIGHT + 1.0f);
+			Widget_Resize(cell, CELL_WIDTH - 2, CELL_HEIGHT - 2);
+			Widget_Append(grid, cell);
+		}
+	}
+	Widget_Append(LCUIWidget_GetRoot(), grid);
+	return grid;
+}
+
+/** 模拟指针按行扫过整个网格，记录命中的部件 */
+static void SweepHitTest(BenchResult result)
+{
+	int i, x, y;
+	LCUI_Widget w, root = LCUIWidget_GetRoot();
+
+	for (i = 0; i < SWEEPS; ++i) {
+		for (y = i; y < ROWS * CELL_HEIGHT; y += CELL_HEIGHT) {
+			for (x = 0; x < COLS * CELL_WIDTH; x += STEP) {
+				w = Widget_At(root, x, y);
+				result->hash = result->hash * 31 +
+					       (unsigned)(w ? w->index : 0);
+				result->hits += 1;
+			}
+		}
+	}
+}
+
+/** 通过鼠标移动事件扫过网格，包含事件分发和 hover 状态的更新 */
+static void SweepMouseMove(BenchResult result)
+{
+	int x, y;
+	LCUI_SysEventRec ev = { 0 };
+
+	ev.type = LCUI_MOUSEMOVE;
+	for (y = 0; y < ROWS * CELL_HEIGHT; y += CELL_HEIGHT * 4) {
+		for (x = 0; x < COLS * CELL_WIDTH; x += STEP * 8) {
+			ev.motion.x = x;
+			ev.motion.y = y;
+			LCUI_TriggerEvent(&ev, NULL);
+			result->events += 1;
+		}
+	}
+}
+
+/** 移动整个网格的所有子部件，以测量维护索引的开销 */
+static void MoveCells(LCUI_Widget grid)
+{
+	LinkedListNode *node;
+	LCUI_Widget cell;
+
+	for (LinkedList_Each(node, &grid->children)) {
+		cell = node->data;
+		Widget_Move(cell, cell->box.border.x + CELL_WIDTH,
+			    cell->box.border.y);
+	}
+	LCUIWidget_Update();
+}
+
+static void RunBench(BenchResult result, LCUI_BOOL index_children)
+{
+	int64_t t;
+	LCUI_Widget grid;
+
+	LCUI_Init();
+	t = LCUI_GetNanoTime();
+	grid = BuildGrid(index_children);
+	LCUIWidget_Update();
+	result->build_time = LCUI_GetNanoTime() - t;
+
+	t = LCUI_GetNanoTime();
+	SweepHitTest(result);
+	result->hit_time = LCUI_GetNanoTime() - t;
+
+	t = LCUI_GetNanoTime();
+	SweepMouseMove(result);
+	result->event_time = LCUI_GetNanoTime() - t;
+
+	t = LCUI_GetNanoTime();
+	MoveCells(grid);
+	result->move_time = LCUI_GetNanoTime() - t;
+	LCUI_Destroy();
+}
+
+int main(int argc, char **argv)
+{
+	size_t i, n;
+	char s_build[32], s_hit[32], s_event[32], s_move[32];
+	BenchResultRec warmup = { "warmup" };
+	BenchResultRec results[] = { { "linear" }, { "indexed" } };
+
+	n = sizeof(results) / sizeof(results[0]);
+	/* 预热一次，避免首次运行时加载字体等操作影响结果 */
+	RunBench(&warmup, FALSE);
+	for (i = 0; i < n; ++i) {
+		RunBench(&results[i], i == 1);
+	}
+	Logger_Info("%d widgets, %lu hit tests, %lu mousemove events\n",
+		    COLS * ROWS, (unsigned long)results[0].hits,
+		    (unsigned long)results[0].events);
+	Logger_Info("%-10s%-12s%-14s%-14s%-12s%s\n", "mode", "build",
+		    "hit test", "mousemove", "move all", "hash");
+	for (i = 0; i < n; ++i) {
+		sprintf(s_build, "%.2fms", results[i].build_time / 1e6);
+		sprintf(s_hit, "%.3fus",
+			results[i].hit_time / 1e3 / results[i].hits);
+		sprintf(s_event, "%.3fus",
+			results[i].event_time / 1e3 / results[i].events);
+		sprintf(s_move, "%.2fms", results[i].move_time / 1e6);
+		Logger_Info("%-10s%-12s%-14s%-14s%-12s%08x\n", results[i].name,
+			    s_build, s_hit, s_event, s_move, results[i].hash);
+	}
+	return 0;
+}
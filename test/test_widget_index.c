@@ -0,0 +1,152 @@
+#include <stdio.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/gui/widget.h>
+#include "test.h"
+#include "libtest.h"
+
+#define GRID_COLS 20
+#define GRID_ROWS 20
+#define CELL_SIZE 40
+
+static LCUI_Widget CreateBox(LCUI_Widget parent, float x, float y,
+			     float width, float height)
+{
+	LCUI_Widget w;
+
+	w = LCUIWidget_New(NULL);
+	Widget_SetPosition(w, SV_ABSOLUTE);
+	Widget_Move(w, x, y);
+	Widget_Resize(w, width, height);
+	Widget_Append(parent, w);
+	return w;
+}
+
+static LCUI_Widget CreateContainer(void)
+{
+	int x, y;
+	LCUI_Widget w, box;
+
+	w = LCUIWidget_New(NULL);
+	Widget_SetPosition(w, SV_ABSOLUTE);
+	Widget_Move(w, 10, 10);
+	Widget_Resize(w, GRID_COLS * CELL_SIZE, GRID_ROWS * CELL_SIZE);
+	Widget_Append(LCUIWidget_GetRoot(), w);
+	/* 铺满整个容器的大尺寸部件，位于最底层 */
+	CreateBox(w, 0, 0, GRID_COLS * CELL_SIZE, GRID_ROWS * CELL_SIZE);
+	for (y = 0; y < GRID_ROWS; ++y) {
+		for (x = 0; x < GRID_COLS; ++x) {
+			CreateBox(w, x * CELL_SIZE + 2.5f, y * CELL_SIZE + 2.5f,
+				  CELL_SIZE - 5, CELL_SIZE - 5);
+		}
+	}
+	/* 跨越多个单元格且互相重叠的部件 */
+	box = CreateBox(w, 100, 100, 150, 150);
+	Widget_SetStyle(box, key_z_index, 2, int);
+	Widget_UpdateStyle(box, FALSE);
+	box = CreateBox(w, 200, 200, 150, 150);
+	Widget_SetStyle(box, key_z_index, 1, int);
+	Widget_UpdateStyle(box, FALSE);
+	box = CreateBox(w, 300, 50, 100, 300);
+	Widget_SetVisibility(box, "hidden");
+	LCUIWidget_Update();
+	return w;
+}
+
+/** 以一定的间隔扫描整个容器，记录每个点命中的部件 */
+static size_t SweepPoints(LCUI_Widget *results, size_t max_len)
+{
+	int x, y;
+	size_t i = 0;
+
+	for (y = 0; y < GRID_ROWS * CELL_SIZE + 20; y += 7) {
+		for (x = 0; x < GRID_COLS * CELL_SIZE + 20; x += 7) {
+			if (i < max_len) {
+				results[i++] = Widget_At(LCUIWidget_GetRoot(),
+							 x, y);
+			}
+		}
+	}
+	return i;
+}
+
+static void test_widget_index_hit_testing(void)
+{
+	static LCUI_Widget expected[128 * 128], actual[128 * 128];
+	size_t i, n, errors = 0;
+	LCUI_Widget w;
+	LCUI_WidgetRulesRec rules = { 0 };
+
+	LCUI_Init();
+	w = CreateContainer();
+	n = SweepPoints(expected, 128 * 128);
+	rules.index_children = TRUE;
+	Widget_SetRules(w, &rules);
+	it_b("check the index is created", Widget_HasChildrenIndex(w), TRUE);
+	it_i("check the number of points", (int)SweepPoints(actual, n),
+	     (int)n);
+	for (i = 0; i < n; ++i) {
+		if (expected[i] != actual[i]) {
+			errors++;
+		}
+	}
+	it_i("check the results are same as the linear scan", (int)errors, 0);
+	LCUI_Destroy();
+}
+
+static void test_widget_index_update(void)
+{
+	LCUI_Widget w, box, child;
+	LCUI_WidgetRulesRec rules = { 0 };
+
+	LCUI_Init();
+	w = LCUIWidget_New(NULL);
+	rules.index_children = TRUE;
+	Widget_SetRules(w, &rules);
+	Widget_Resize(w, 800, 600);
+	Widget_Append(LCUIWidget_GetRoot(), w);
+	box = CreateBox(w, 10, 10, 50, 50);
+	child = CreateBox(box, 0, 0, 10, 10);
+	LCUIWidget_Update();
+	it_b("check hitting the child",
+	     Widget_At(LCUIWidget_GetRoot(), 30, 30) == box, TRUE);
+	it_b("check hitting the grandchild",
+	     Widget_At(LCUIWidget_GetRoot(), 15, 15) == child, TRUE);
+
+	Widget_Move(box, 500, 400);
+	LCUIWidget_Update();
+	it_b("check the old position after moving",
+	     Widget_At(LCUIWidget_GetRoot(), 30, 30) == w, TRUE);
+	it_b("check the new position after moving",
+	     Widget_At(LCUIWidget_GetRoot(), 520, 420) == box, TRUE);
+
+	Widget_Resize(box, 200, 150);
+	LCUIWidget_Update();
+	it_b("check the new area after resizing",
+	     Widget_At(LCUIWidget_GetRoot(), 690, 540) == box, TRUE);
+
+	Widget_Destroy(box);
+	LCUIWidget_Update();
+	it_b("check hitting after destroying the child",
+	     Widget_At(LCUIWidget_GetRoot(), 520, 420) == w, TRUE);
+
+	box = CreateBox(w, 10, 10, 50, 50);
+	LCUIWidget_Update();
+	it_b("check hitting the appended child",
+	     Widget_At(LCUIWidget_GetRoot(), 30, 30) == box, TRUE);
+	Widget_Empty(w);
+	LCUIWidget_Update();
+	it_b("check hitting after emptying the children",
+	     Widget_At(LCUIWidget_GetRoot(), 30, 30) == w, TRUE);
+
+	Widget_SetRules(w, NULL);
+	it_b("check the index is destroyed", Widget_HasChildrenIndex(w),
+	     FALSE);
+	LCUI_Destroy();
+}
+
+void test_widget_index(void)
+{
+	describe("check hit testing", test_widget_index_hit_testing);
+	describe("check updating the index", test_widget_index_update);
+}
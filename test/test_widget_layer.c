@@ -0,0 +1,175 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/graph.h>
+#include <LCUI/gui/widget.h>
+#include "test.h"
+#include "libtest.h"
+
+#define CANVAS_WIDTH 200
+#define CANVAS_HEIGHT 200
+
+static struct {
+	LCUI_Widget root;
+	LCUI_Widget box;
+	LCUI_Widget child;
+	size_t paint_count;
+} self;
+
+static void CounterPaint(LCUI_Widget w, LCUI_PaintContext paint,
+			 LCUI_WidgetActualStyle style)
+{
+	self.paint_count += 1;
+}
+
+static void RenderRoot(LCUI_Graph *canvas)
+{
+	LCUI_PaintContextRec paint;
+
+	Graph_Init(canvas);
+	Graph_Create(canvas, CANVAS_WIDTH, CANVAS_HEIGHT);
+	paint.with_alpha = FALSE;
+	paint.rect.x = paint.rect.y = 0;
+	paint.rect.width = CANVAS_WIDTH;
+	paint.rect.height = CANVAS_HEIGHT;
+	Graph_Quote(&paint.canvas, canvas, NULL);
+	Widget_Render(self.root, &paint);
+}
+
+/** 渲染不启用图层缓存时的结果，作为参照 */
+static void RenderReference(LCUI_Graph *canvas)
+{
+	LCUI_WidgetRulesRec rules = { 0 };
+
+	Widget_SetRules(self.box, NULL);
+	RenderRoot(canvas);
+	rules.retain_layer = TRUE;
+	Widget_SetRules(self.box, &rules);
+}
+
+static LCUI_BOOL CompareGraph(LCUI_Graph *a, LCUI_Graph *b, int tolerance)
+{
+	int x, y;
+	LCUI_Color ca, cb;
+
+	for (y = 0; y < a->height; ++y) {
+		for (x = 0; x < a->width; ++x) {
+			Graph_GetPixel(a, x, y, ca);
+			Graph_GetPixel(b, x, y, cb);
+			if (abs(ca.r - cb.r) > tolerance ||
+			    abs(ca.g - cb.g) > tolerance ||
+			    abs(ca.b - cb.b) > tolerance) {
+				return FALSE;
+			}
+		}
+	}
+	return TRUE;
+}
+
+static void build(void)
+{
+	LCUI_WidgetRulesRec rules = { 0 };
+	LCUI_WidgetPrototype proto;
+
+	proto = LCUIWidget_NewPrototype("layer-counter", NULL);
+	proto->paint = CounterPaint;
+	self.root = LCUIWidget_New(NULL);
+	self.box = LCUIWidget_New(NULL);
+	self.child = LCUIWidget_New("layer-counter");
+	Widget_Resize(self.root, CANVAS_WIDTH, CANVAS_HEIGHT);
+	Widget_SetStyle(self.root, key_background_color, RGB(255, 255, 255),
+			color);
+	Widget_SetStyle(self.box, key_position, SV_ABSOLUTE, style);
+	Widget_Move(self.box, 20, 20);
+	Widget_Resize(self.box, 100, 100);
+	Widget_SetPadding(self.box, 10, 10, 10, 10);
+	Widget_SetBorder(self.box, 2, SV_SOLID, RGB(0, 0, 0));
+	Widget_SetStyle(self.box, key_background_color, RGB(255, 0, 0), color);
+	Widget_Resize(self.child, 40, 40);
+	Widget_SetStyle(self.child, key_background_color, RGB(0, 255, 0),
+			color);
+	Widget_Append(self.box, self.child);
+	Widget_Append(self.root, self.box);
+	Widget_Append(LCUIWidget_GetRoot(), self.root);
+	LCUIWidget_Update();
+	rules.retain_layer = TRUE;
+	Widget_SetRules(self.box, &rules);
+}
+
+static void test_widget_layer_cache(void)
+{
+	size_t count;
+	LCUI_Color color;
+	LCUI_Graph canvas, ref;
+
+	RenderReference(&ref);
+	count = self.paint_count;
+	RenderRoot(&canvas);
+	it_b("check the first rendering repaints the layer",
+	     self.paint_count == count + 1, TRUE);
+	it_b("check layer rendering is same as direct rendering",
+	     CompareGraph(&canvas, &ref, 0), TRUE);
+	Graph_Free(&canvas);
+	Graph_Free(&ref);
+
+	count = self.paint_count;
+	RenderRoot(&canvas);
+	it_b("check the layer is reused", self.paint_count == count, TRUE);
+	Graph_Free(&canvas);
+
+	Widget_Move(self.box, 50, 40);
+	LCUIWidget_Update();
+	count = self.paint_count;
+	RenderRoot(&canvas);
+	it_b("check moving does not repaint the layer",
+	     self.paint_count == count, TRUE);
+	RenderReference(&ref);
+	it_b("check the moved layer is same as direct rendering",
+	     CompareGraph(&canvas, &ref, 0), TRUE);
+	Graph_Free(&canvas);
+	Graph_Free(&ref);
+
+	/* build the layer again after the rules are reset */
+	RenderRoot(&canvas);
+	Graph_Free(&canvas);
+	Widget_SetOpacity(self.box, 0.5f);
+	LCUIWidget_Update();
+	count = self.paint_count;
+	RenderRoot(&canvas);
+	it_b("check changing opacity does not repaint the layer",
+	     self.paint_count == count, TRUE);
+	RenderReference(&ref);
+	it_b("check the translucent layer is same as direct rendering",
+	     CompareGraph(&canvas, &ref, 2), TRUE);
+	Graph_Free(&canvas);
+	Graph_Free(&ref);
+
+	RenderRoot(&canvas);
+	Graph_Free(&canvas);
+	Widget_SetOpacity(self.box, 1.0f);
+	Widget_SetStyle(self.child, key_background_color, RGB(0, 0, 255),
+			color);
+	Widget_UpdateStyle(self.child, FALSE);
+	LCUIWidget_Update();
+	count = self.paint_count;
+	RenderRoot(&canvas);
+	it_b("check changing child style repaints the layer",
+	     self.paint_count == count + 1, TRUE);
+	Graph_GetPixel(&canvas, 75, 65, color);
+	it_b("check the child color in the layer",
+	     color.r == 0 && color.g == 0 && color.b > 250, TRUE);
+	RenderReference(&ref);
+	it_b("check the updated layer is same as direct rendering",
+	     CompareGraph(&canvas, &ref, 0), TRUE);
+	Graph_Free(&canvas);
+	Graph_Free(&ref);
+}
+
+void test_widget_layer(void)
+{
+	LCUI_Init();
+	build();
+	describe("check retained layer", test_widget_layer_cache);
+	LCUI_Destroy();
+}
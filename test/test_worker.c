@@ -0,0 +1,345 @@
+#include <stdio.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/thread.h>
+#include <LCUI/worker.h>
+#include "test.h"
+#include "libtest.h"
+
+/** 用于阻塞工作线程的闸门 */
+typedef struct TestGateRec_ {
+	LCUI_BOOL opened;
+	LCUI_Mutex mutex;
+	LCUI_Cond cond;
+} TestGateRec, *TestGate;
+
+typedef struct TestRecorderRec_ {
+	int count;
+	int order[256];
+	LCUI_Thread threads[256];
+	LCUI_Mutex mutex;
+} TestRecorderRec, *TestRecorder;
+
+typedef struct TestCallbackRec_ {
+	int count;
+	LCUI_Thread thread;
+	LCUI_AsyncTaskState state;
+} TestCallbackRec, *TestCallback;
+
+static void TestGate_Init(TestGate gate)
+{
+	gate->opened = FALSE;
+	LCUIMutex_Init(&gate->mutex);
+	LCUICond_Init(&gate->cond);
+}
+
+static void TestGate_Open(TestGate gate)
+{
+	LCUIMutex_Lock(&gate->mutex);
+	gate->opened = TRUE;
+	LCUICond_Broadcast(&gate->cond);
+	LCUIMutex_Unlock(&gate->mutex);
+}
+
+static void TestGate_Destroy(TestGate gate)
+{
+	LCUIMutex_Destroy(&gate->mutex);
+	LCUICond_Destroy(&gate->cond);
+}
+
+static void WaitGate(void *arg1, void *arg2)
+{
+	TestGate gate = arg1;
+
+	LCUIMutex_Lock(&gate->mutex);
+	while (!gate->opened) {
+		LCUICond_Wait(&gate->cond, &gate->mutex);
+	}
+	LCUIMutex_Unlock(&gate->mutex);
+}
+
+static void Record(void *arg1, void *arg2)
+{
+	TestRecorder recorder = arg1;
+
+	LCUIMutex_Lock(&recorder->mutex);
+	if (recorder->count < 256) {
+		recorder->order[recorder->count] = *(int *)arg2;
+		recorder->threads[recorder->count] = LCUIThread_SelfID();
+	}
+	recorder->count += 1;
+	LCUIMutex_Unlock(&recorder->mutex);
+}
+
+static int GetRecordCount(TestRecorder recorder)
+{
+	int count;
+
+	LCUIMutex_Lock(&recorder->mutex);
+	count = recorder->count;
+	LCUIMutex_Unlock(&recorder->mutex);
+	return count;
+}
+
+/** 等待记录的任务数量达到预期值，超时则返回 FALSE */
+static LCUI_BOOL WaitRecords(TestRecorder recorder, int count)
+{
+	int i;
+
+	for (i = 0; i < 500; ++i) {
+		if (GetRecordCount(recorder) >= count) {
+			return TRUE;
+		}
+		LCUI_MSleep(10);
+	}
+	return FALSE;
+}
+
+static void PostRecordTask(LCUI_WorkerPool pool, TestRecorder recorder,
+			   int *value, LCUI_TaskPriority priority)
+{
+	LCUI_TaskRec task = { 0 };
+
+	task.func = Record;
+	task.arg[0] = recorder;
+	task.arg[1] = value;
+	LCUIWorkerPool_PostTask(pool, &task, priority);
+}
+
+static void PostGateTask(LCUI_WorkerPool pool, TestGate gate)
+{
+	LCUI_TaskRec task = { 0 };
+
+	task.func = WaitGate;
+	task.arg[0] = gate;
+	LCUIWorkerPool_PostTaskTo(pool, &task, 0);
+}
+
+static void test_worker_pool_run(void)
+{
+	int i, n;
+	int values[256];
+	LCUI_BOOL ordered;
+	LCUI_BOOL same_thread;
+	LCUI_TaskRec task = { 0 };
+	TestRecorderRec recorder = { 0 };
+	LCUI_WorkerPool pool;
+
+	LCUIMutex_Init(&recorder.mutex);
+	pool = LCUIWorkerPool_New(3);
+	it_i("check the number of workers", LCUIWorkerPool_GetSize(pool), 3);
+	for (i = 0; i < 1000; ++i) {
+		values[i % 256] = i;
+		PostRecordTask(pool, &recorder, &values[i % 256],
+			       LCUI_TASK_PRIORITY_DEFAULT);
+	}
+	it_b("check all tasks are done", WaitRecords(&recorder, 1000), TRUE);
+
+	recorder.count = 0;
+	for (i = 0; i < 256; ++i) {
+		values[i] = i;
+		task.func = Record;
+		task.arg[0] = &recorder;
+		task.arg[1] = &values[i];
+		LCUIWorkerPool_PostTaskTo(pool, &task, 1);
+	}
+	it_b("check all pinned tasks are done", WaitRecords(&recorder, 256),
+	     TRUE);
+	n = GetRecordCount(&recorder);
+	for (i = 0, ordered = TRUE, same_thread = TRUE; i < n; ++i) {
+		if (recorder.order[i] != i) {
+			ordered = FALSE;
+		}
+		if (recorder.threads[i] != recorder.threads[0]) {
+			same_thread = FALSE;
+		}
+	}
+	it_b("check pinned tasks run in order", ordered, TRUE);
+	it_b("check pinned tasks run on the same worker", same_thread, TRUE);
+	LCUIWorkerPool_Destroy(pool);
+	LCUIMutex_Destroy(&recorder.mutex);
+}
+
+static void test_worker_pool_priority(void)
+{
+	int values[3] = { LCUI_TASK_PRIORITY_USER_BLOCKING,
+			  LCUI_TASK_PRIORITY_DEFAULT,
+			  LCUI_TASK_PRIORITY_BACKGROUND };
+	TestGateRec gate;
+	TestRecorderRec recorder = { 0 };
+	LCUI_WorkerPool pool;
+
+	TestGate_Init(&gate);
+	LCUIMutex_Init(&recorder.mutex);
+	pool = LCUIWorkerPool_New(1);
+	PostGateTask(pool, &gate);
+	PostRecordTask(pool, &recorder, &values[2],
+		       LCUI_TASK_PRIORITY_BACKGROUND);
+	PostRecordTask(pool, &recorder, &values[1], LCUI_TASK_PRIORITY_DEFAULT);
+	PostRecordTask(pool, &recorder, &values[0],
+		       LCUI_TASK_PRIORITY_USER_BLOCKING);
+	TestGate_Open(&gate);
+	it_b("check all tasks are done", WaitRecords(&recorder, 3), TRUE);
+	it_i("check the user-blocking task runs first", recorder.order[0],
+	     LCUI_TASK_PRIORITY_USER_BLOCKING);
+	it_i("check the default task runs second", recorder.order[1],
+	     LCUI_TASK_PRIORITY_DEFAULT);
+	it_i("check the background task runs last", recorder.order[2],
+	     LCUI_TASK_PRIORITY_BACKGROUND);
+	LCUIWorkerPool_Destroy(pool);
+	LCUIMutex_Destroy(&recorder.mutex);
+	TestGate_Destroy(&gate);
+}
+
+/** 稍后打开闸门，让工作线程在线程池被销毁时仍在执行任务 */
+static void OpenGateLater(void *arg)
+{
+	LCUI_MSleep(50);
+	TestGate_Open(arg);
+	LCUIThread_Exit(NULL);
+}
+
+static void test_worker_pool_destroy(void)
+{
+	int i, values[8];
+	TestGateRec gate;
+	TestRecorderRec recorder = { 0 };
+	LCUI_Thread thread;
+	LCUI_WorkerPool pool;
+
+	TestGate_Init(&gate);
+	LCUIMutex_Init(&recorder.mutex);
+	pool = LCUIWorkerPool_New(1);
+	PostGateTask(pool, &gate);
+	for (i = 0; i < 8; ++i) {
+		values[i] = i;
+		PostRecordTask(pool, &recorder, &values[i],
+			       LCUI_TASK_PRIORITY_DEFAULT);
+	}
+	LCUIThread_Create(&thread, OpenGateLater, &gate);
+	LCUIWorkerPool_Destroy(pool);
+	LCUIThread_Join(thread, NULL);
+	it_i("check the pending tasks are canceled", recorder.count, 0);
+	LCUIMutex_Destroy(&recorder.mutex);
+	TestGate_Destroy(&gate);
+}
+
+static void OnTaskDone(LCUI_AsyncTask task, void *arg)
+{
+	TestCallback callback = arg;
+
+	callback->count += 1;
+	callback->state = LCUIAsyncTask_GetState(task);
+	callback->thread = LCUIThread_SelfID();
+}
+
+static void OnDestroyValue(void *arg)
+{
+	*(int *)arg = -1;
+}
+
+static void test_worker_pool_cancel(void)
+{
+	int i;
+	int value = 1;
+	TestGateRec gate;
+	TestRecorderRec recorder = { 0 };
+	TestCallbackRec callback = { 0 };
+	LCUI_TaskRec task = { 0 };
+	LCUI_AsyncTask handle;
+	LCUI_WorkerPool pool;
+	LCUI_Worker main_worker;
+
+	TestGate_Init(&gate);
+	LCUIMutex_Init(&recorder.mutex);
+	main_worker = LCUIWorker_New();
+	pool = LCUIWorkerPool_New(1);
+	LCUIWorkerPool_SetCallbackWorker(pool, main_worker);
+	PostGateTask(pool, &gate);
+	task.func = Record;
+	task.arg[0] = &recorder;
+	task.arg[1] = &value;
+	task.destroy_arg[1] = OnDestroyValue;
+	handle = LCUIWorkerPool_PostAsyncTask(
+	    pool, &task, LCUI_TASK_PRIORITY_DEFAULT, OnTaskDone, &callback);
+	it_i("check the task is pending", LCUIAsyncTask_GetState(handle),
+	     LCUI_ASYNC_TASK_PENDING);
+	it_b("check canceling a pending task", LCUIAsyncTask_Cancel(handle),
+	     TRUE);
+	TestGate_Open(&gate);
+	for (i = 0; i < 500 && callback.count < 1; ++i) {
+		LCUIWorker_RunTask(main_worker);
+		LCUI_MSleep(10);
+	}
+	it_i("check the callback is called once", callback.count, 1);
+	it_b("check the callback is called on the callback worker",
+	     callback.thread == LCUIThread_SelfID(), TRUE);
+	it_i("check the callback gets the canceled state", callback.state,
+	     LCUI_ASYNC_TASK_CANCELED);
+	it_i("check the canceled task is not run", GetRecordCount(&recorder),
+	     0);
+	it_i("check the arguments of the canceled task are destroyed", value,
+	     -1);
+	it_b("check canceling a canceled task", LCUIAsyncTask_Cancel(handle),
+	     FALSE);
+	LCUIAsyncTask_Release(handle);
+
+	value = 1;
+	callback.count = 0;
+	task.destroy_arg[1] = NULL;
+	handle = LCUIWorkerPool_PostAsyncTask(
+	    pool, &task, LCUI_TASK_PRIORITY_DEFAULT, OnTaskDone, &callback);
+	for (i = 0; i < 500 && callback.count < 1; ++i) {
+		LCUIWorker_RunTask(main_worker);
+		LCUI_MSleep(10);
+	}
+	it_i("check the done task is run", GetRecordCount(&recorder), 1);
+	it_i("check the callback gets the done state", callback.state,
+	     LCUI_ASYNC_TASK_DONE);
+	it_b("check canceling a done task", LCUIAsyncTask_Cancel(handle),
+	     FALSE);
+	LCUIAsyncTask_Release(handle);
+
+	LCUIWorkerPool_Destroy(pool);
+	LCUIWorker_Destroy(main_worker);
+	LCUIMutex_Destroy(&recorder.mutex);
+	TestGate_Destroy(&gate);
+}
+
+static void test_post_async_task(void)
+{
+	int i;
+	int value = 1;
+	TestRecorderRec recorder = { 0 };
+	TestCallbackRec callback = { 0 };
+	LCUI_TaskRec task = { 0 };
+	LCUI_AsyncTask handle;
+
+	LCUIMutex_Init(&recorder.mutex);
+	LCUI_Init();
+	task.func = Record;
+	task.arg[0] = &recorder;
+	task.arg[1] = &value;
+	handle = LCUI_PostAsyncTaskEx(&task, LCUI_TASK_PRIORITY_USER_BLOCKING,
+				      OnTaskDone, &callback);
+	for (i = 0; i < 500 && callback.count < 1; ++i) {
+		LCUI_ProcessEvents();
+		LCUI_MSleep(10);
+	}
+	it_i("check the task is run", GetRecordCount(&recorder), 1);
+	it_b("check the callback is called on the main loop",
+	     callback.count == 1 && callback.thread == LCUIThread_SelfID(),
+	     TRUE);
+	LCUIAsyncTask_Release(handle);
+	LCUI_Destroy();
+	LCUIMutex_Destroy(&recorder.mutex);
+}
+
+void test_worker(void)
+{
+	describe("check worker pool", test_worker_pool_run);
+	describe("check worker pool priority", test_worker_pool_priority);
+	describe("check canceling async tasks", test_worker_pool_cancel);
+	describe("check destroying worker pool", test_worker_pool_destroy);
+	describe("check posting async tasks", test_post_async_task);
+}
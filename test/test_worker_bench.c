@@ -0,0 +1,208 @@
+#include <stdio.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/thread.h>
+#include <LCUI/worker.h>
+
+#define NUM_WORKERS 4
+#define SMALL_TASKS 200000
+#define HEAVY_TASKS 400
+#define BACKGROUND_TASKS 200
+
+typedef struct BenchContextRec_ {
+	LCUI_BOOL use_pool;
+	LCUI_WorkerPool pool;
+	LCUI_Worker workers[NUM_WORKERS];
+	int next_worker;
+
+	int done;
+	int expected;
+	int64_t urgent_time;
+	LCUI_Mutex mutex;
+	LCUI_Cond cond;
+} BenchContextRec, *BenchContext;
+
+static volatile unsigned long sink;
+
+static void BusyWork(int n)
+{
+	int i;
+	unsigned long v = 0;
+
+	for (i = 0; i < n; ++i) {
+		v = v * 31 + i;
+	}
+	sink = v;
+}
+
+static void OnTaskDone(BenchContext ctx)
+{
+	LCUIMutex_Lock(&ctx->mutex);
+	ctx->done += 1;
+	if (ctx->done >= ctx->expected) {
+		LCUICond_Signal(&ctx->cond);
+	}
+	LCUIMutex_Unlock(&ctx->mutex);
+}
+
+static void SmallTask(void *arg1, void *arg2)
+{
+	OnTaskDone(arg1);
+}
+
+static void HeavyTask(void *arg1, void *arg2)
+{
+	BusyWork((int)(size_t)arg2);
+	OnTaskDone(arg1);
+}
+
+static void UrgentTask(void *arg1, void *arg2)
+{
+	BenchContext ctx = arg1;
+
+	ctx->urgent_time = LCUI_GetTime();
+	OnTaskDone(ctx);
+}
+
+static void BenchContext_Init(BenchContext ctx, LCUI_BOOL use_pool)
+{
+	int i;
+
+	memset(ctx, 0, sizeof(BenchContextRec));
+	ctx->use_pool = use_pool;
+	LCUIMutex_Init(&ctx->mutex);
+	LCUICond_Init(&ctx->cond);
+	if (use_pool) {
+		ctx->pool = LCUIWorkerPool_New(NUM_WORKERS);
+		return;
+	}
+	for (i = 0; i < NUM_WORKERS; ++i) {
+		ctx->workers[i] = LCUIWorker_New();
+		LCUIWorker_RunAsync(ctx->workers[i]);
+	}
+}
+
+static void BenchContext_Destroy(BenchContext ctx)
+{
+	int i;
+
+	if (ctx->use_pool) {
+		LCUIWorkerPool_Destroy(ctx->pool);
+	} else {
+		for (i = 0; i < NUM_WORKERS; ++i) {
+			LCUIWorker_Destroy(ctx->workers[i]);
+		}
+	}
+	LCUIMutex_Destroy(&ctx->mutex);
+	LCUICond_Destroy(&ctx->cond);
+}
+
+/** 按各自的方式添加任务，旧的实现只能轮流分给各个工作线程 */
+static void PostTask(BenchContext ctx, LCUI_TaskFunc func, size_t work,
+		     LCUI_TaskPriority priority)
+{
+	LCUI_TaskRec task = { 0 };
+
+	task.func = func;
+	task.arg[0] = ctx;
+	task.arg[1] = (void *)work;
+	if (ctx->use_pool) {
+		LCUIWorkerPool_PostTask(ctx->pool, &task, priority);
+		return;
+	}
+	LCUIWorker_PostTask(ctx->workers[ctx->next_worker], &task);
+	ctx->next_worker = (ctx->next_worker + 1) % NUM_WORKERS;
+}
+
+static void WaitTasks(BenchContext ctx, int count)
+{
+	LCUIMutex_Lock(&ctx->mutex);
+	ctx->expected = count;
+	while (ctx->done < ctx->expected) {
+		LCUICond_Wait(&ctx->cond, &ctx->mutex);
+	}
+	ctx->done = 0;
+	LCUIMutex_Unlock(&ctx->mutex);
+}
+
+static int64_t BenchSmallTasks(LCUI_BOOL use_pool)
+{
+	int i;
+	int64_t t;
+	BenchContextRec ctx;
+
+	BenchContext_Init(&ctx, use_pool);
+	t = LCUI_GetTime();
+	for (i = 0; i < SMALL_TASKS; ++i) {
+		PostTask(&ctx, SmallTask, 0, LCUI_TASK_PRIORITY_DEFAULT);
+	}
+	WaitTasks(&ctx, SMALL_TASKS);
+	t = LCUI_GetTimeDelta(t);
+	BenchContext_Destroy(&ctx);
+	return t;
+}
+
+/** 每四个任务中有一个是重任务，轮流分配会让它们都落到同一个工作线程上 */
+static int64_t BenchUnevenTasks(LCUI_BOOL use_pool)
+{
+	int i;
+	int64_t t;
+	BenchContextRec ctx;
+
+	BenchContext_Init(&ctx, use_pool);
+	t = LCUI_GetTime();
+	for (i = 0; i < HEAVY_TASKS; ++i) {
+		PostTask(&ctx, HeavyTask, i % NUM_WORKERS == 0 ? 400000 : 1000,
+			 LCUI_TASK_PRIORITY_DEFAULT);
+	}
+	WaitTasks(&ctx, HEAVY_TASKS);
+	t = LCUI_GetTimeDelta(t);
+	BenchContext_Destroy(&ctx);
+	return t;
+}
+
+/** 在工作线程忙于后台任务时添加一个紧急任务，测量它开始执行前的等待时间 */
+static int64_t BenchUrgentLatency(LCUI_BOOL use_pool)
+{
+	int i;
+	int64_t t;
+	BenchContextRec ctx;
+
+	BenchContext_Init(&ctx, use_pool);
+	for (i = 0; i < BACKGROUND_TASKS; ++i) {
+		PostTask(&ctx, HeavyTask, 100000,
+			 LCUI_TASK_PRIORITY_BACKGROUND);
+	}
+	t = LCUI_GetTime();
+	PostTask(&ctx, UrgentTask, 0, LCUI_TASK_PRIORITY_USER_BLOCKING);
+	WaitTasks(&ctx, BACKGROUND_TASKS + 1);
+	t = ctx.urgent_time - t;
+	BenchContext_Destroy(&ctx);
+	return t;
+}
+
+/** 依次测试两种实现，各自先运行一次用于预热 */
+static void RunBench(const char *name, int64_t (*bench)(LCUI_BOOL))
+{
+	int64_t t0, t1;
+	char s_t0[32], s_t1[32];
+
+	bench(FALSE);
+	t0 = bench(FALSE);
+	bench(TRUE);
+	t1 = bench(TRUE);
+	sprintf(s_t0, "%ldms", (long)t0);
+	sprintf(s_t1, "%ldms", (long)t1);
+	Logger_Info("%-28s%-16s%s\n", name, s_t0, s_t1);
+}
+
+int main(int argc, char **argv)
+{
+	Logger_Info("%d workers\n", NUM_WORKERS);
+	Logger_Info("%-28s%-16s%s\n", "case", "round-robin", "work-stealing");
+	RunBench("200000 small tasks", BenchSmallTasks);
+	RunBench("400 uneven tasks", BenchUnevenTasks);
+	RunBench("urgent task latency", BenchUrgentLatency);
+	return 0;
+}
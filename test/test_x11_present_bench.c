@@ -0,0 +1,92 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/display.h>
+#include <LCUI/gui/widget.h>
+
+#define SCREEN_WIDTH 1920
+#define SCREEN_HEIGHT 1080
+#define FRAMES 120
+#define SMALL_RECTS 64
+
+/** 让表面完成创建和尺寸调整 */
+static void WaitSurfaceReady(void)
+{
+	int i;
+
+	for (i = 0; i < 30; ++i) {
+		LCUI_RunFrame();
+		LCUI_MSleep(10);
+	}
+}
+
+static int64_t PresentFrames(LCUI_BOOL full)
+{
+	int i, j;
+	int64_t t, total = 0;
+	LCUI_Rect rect;
+
+	srand(1024);
+	for (i = 0; i < FRAMES; ++i) {
+		if (full) {
+			LCUIDisplay_InvalidateArea(NULL);
+		} else {
+			rect.width = 64;
+			rect.height = 32;
+			for (j = 0; j < SMALL_RECTS; ++j) {
+				rect.x = rand() % (SCREEN_WIDTH - rect.width);
+				rect.y = rand() % (SCREEN_HEIGHT - rect.height);
+				LCUIDisplay_InvalidateArea(&rect);
+			}
+		}
+		LCUI_ProcessEvents();
+		LCUIDisplay_Update();
+		LCUIDisplay_Render();
+		t = LCUI_GetTime();
+		LCUIDisplay_Present();
+		total += LCUI_GetTimeDelta(t);
+	}
+	return total;
+}
+
+static void PrintResult(const char *name, int64_t t, double pixels)
+{
+	char s_total[32], s_frame[32], s_rate[32];
+
+	sprintf(s_total, "%ldms", (long)t);
+	sprintf(s_frame, "%.2fms", (double)t / FRAMES);
+	sprintf(s_rate, "%.1fMpx/s",
+		t > 0 ? pixels * FRAMES / 1000.0 / t : 0.0);
+	Logger_Info("%-20s%-12s%-12s%s\n", name, s_total, s_frame, s_rate);
+}
+
+int main(int argc, char **argv)
+{
+	LCUI_Widget root;
+
+	if (!getenv("DISPLAY")) {
+		Logger_Error("this benchmark needs an X server, "
+			     "try running it with xvfb-run\n");
+		return 0;
+	}
+	if (argc > 1 && strcmp(argv[1], "--no-shm") == 0) {
+		setenv("LCUI_X11_DISABLE_SHM", "1", 1);
+	}
+	LCUI_Init();
+	LCUIDisplay_SetSize(SCREEN_WIDTH, SCREEN_HEIGHT);
+	root = LCUIWidget_GetRoot();
+	Widget_SetStyle(root, key_background_color, RGB(240, 240, 240), color);
+	WaitSurfaceReady();
+	Logger_Info("present %d frames at %dx%d%s\n", FRAMES,
+		    LCUIDisplay_GetWidth(), LCUIDisplay_GetHeight(),
+		    getenv("LCUI_X11_DISABLE_SHM") ? ", MIT-SHM disabled" : "");
+	Logger_Info("%-20s%-12s%-12s%s\n", "case", "total", "per frame",
+		    "throughput");
+	PrintResult("full frame", PresentFrames(TRUE),
+		    (double)LCUIDisplay_GetWidth() * LCUIDisplay_GetHeight());
+	PrintResult("64 small rects", PresentFrames(FALSE),
+		    64.0 * 32.0 * SMALL_RECTS);
+	return LCUI_Destroy();
+}